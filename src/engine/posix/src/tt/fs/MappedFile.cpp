@@ -0,0 +1,92 @@
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <tt/fs/MappedFile.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+
+
+namespace tt {
+namespace fs {
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+MappedFilePtr MappedFile::open(const std::string& p_path)
+{
+	const int fileDescriptor = ::open(p_path.c_str(), O_RDONLY);
+	if (fileDescriptor == -1)
+	{
+		TT_WARN("Opening '%s' for mapping failed with error %d: %s",
+		        p_path.c_str(), errno, std::strerror(errno));
+		return MappedFilePtr();
+	}
+	
+	struct stat fileStats;
+	if (fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size <= 0)
+	{
+		TT_WARN("Cannot map '%s': unable to get its size or it is empty.", p_path.c_str());
+		close(fileDescriptor);
+		return MappedFilePtr();
+	}
+	
+	const size_t size = static_cast<size_t>(fileStats.st_size);
+	void* data = mmap(0, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	
+	// The mapping keeps the file referenced
+	close(fileDescriptor);
+	
+	if (data == MAP_FAILED)
+	{
+		TT_WARN("Mapping '%s' failed with error %d: %s", p_path.c_str(), errno, std::strerror(errno));
+		return MappedFilePtr();
+	}
+	
+	return MappedFilePtr(new MappedFile(static_cast<const u8*>(data), static_cast<size_type>(size)));
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (m_data != 0)
+	{
+		munmap(const_cast<u8*>(m_data), static_cast<size_t>(m_size));
+	}
+}
+
+
+void MappedFile::release(size_type p_offset, size_type p_size) const
+{
+	TT_ASSERT(p_offset >= 0 && p_size >= 0 && p_offset + p_size <= m_size);
+	
+	// Only whole pages can be released
+	const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+	const uintptr_t start    = reinterpret_cast<uintptr_t>(m_data) + p_offset;
+	const uintptr_t end      = start + p_size;
+	const uintptr_t first    = (start + pageSize - 1) & ~(pageSize - 1);
+	const uintptr_t last     = end & ~(pageSize - 1);
+	if (first < last)
+	{
+		madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED);
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+MappedFile::MappedFile(const u8* p_data, size_type p_size)
+:
+m_data(p_data),
+m_size(p_size)
+{
+}
+
+// Namespace end
+}
+}
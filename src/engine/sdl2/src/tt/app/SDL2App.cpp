@@ -33,9 +33,11 @@ typedef tt::fs::PosixFileSystem  SDL2FileSystem;
 #include <tt/platform/tt_error.h>
 #include <tt/platform/tt_error_sdl2.h>
 #include <tt/platform/tt_printf.h>
+#include <tt/profiler/TraceRecorder.h>
 #include <tt/app/fatal_error.h>
 #include <tt/str/str.h>
 #include <tt/system/Time.h>
+#include <tt/thread/ThreadedWorkload.h>
 #include <tt/version/Version.h>
 
 #include <SDL2/SDL.h>
@@ -384,6 +386,11 @@ m_debugKeys(DebugKeys_All)
 	tt::input::SDLJoypadController::initialize();
 
 	http::HttpConnectMgr::createInstance();
+	
+	tt::profiler::TraceRecorder::setThreadName("Main Thread");
+	
+	// Create the threads for the threaded workload pool
+	tt::thread::ThreadedWorkload::createThreads();
 
 	// Have the client application initialize itself (should be last)
 	m_startupState.setStartupStep(StartupStep_ClientInit);
@@ -420,6 +427,9 @@ SDL2App::~SDL2App()
 	
 	http::HttpConnectMgr::destroyInstance();
 	
+	// Destroy the threads of the threaded workload pool
+	tt::thread::ThreadedWorkload::destroyThreads();
+	
 	// Shut down renderer
 	tt::engine::renderer::Renderer::destroyInstance();
 	delete m_contextWrapper;
@@ -706,14 +716,17 @@ s32 SDL2App::run()
 		
 		m_prevFrameTimestamp = now;
 		
-		if (m_settings.useFixedDeltaTime == false) 
+		if (m_settings.useFixedDeltaTime == false && m_settings.headless == false) 
 		{
 			deltaTime = elapsedTimestamp;
 		}
 		
 		update(static_cast<real>(deltaTime) / 1000000.0f);
 		
-		render();
+		if (m_settings.headless == false)
+		{
+			render();
+		}
 	}
 	
 	return 0;
@@ -1041,7 +1054,7 @@ void SDL2App::handleCommonInput()
 
 bool SDL2App::setVideoMode(const bool p_windowed, const math::Point2& p_size, const std::string& title)
 {
-	Uint32 flags = SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN;
+	Uint32 flags = SDL_WINDOW_OPENGL | (m_settings.headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN);
 	if (!p_windowed) {
 		flags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
 	}
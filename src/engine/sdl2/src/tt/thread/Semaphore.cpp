@@ -62,6 +62,19 @@ bool Semaphore::tryWait()
 }
 
 
+bool Semaphore::timedWait(u32 p_milliSeconds)
+{
+	int result = SDL_SemWaitTimeout(m_data->sem, static_cast<Uint32>(p_milliSeconds));
+	if (result == SDL_MUTEX_TIMEDOUT)
+	{
+		return false;
+	}
+	TT_ASSERTMSG(result == 0, "SDL_SemWaitTimeout failed with error: '%s'",
+				 SDL_GetError());
+	return true;
+}
+
+
 void Semaphore::signal()
 {
 	int result = SDL_SemPost(m_data->sem);
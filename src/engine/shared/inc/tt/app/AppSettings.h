@@ -111,6 +111,12 @@ struct AppSettings
 	/*! \brief Flag to indicate if updates should use a fixed delta time.
 	    \note  Uses targetFPS for most platforms.*/
 	bool             useFixedDeltaTime;
+	
+	/*! \brief Run without a visible window and without rendering or frame limiting.
+	           Updates use a fixed delta time of 1 / targetFPS.
+	    \note  A (hidden) window and GL context are still created, because resources need them.
+	           Only supported by the SDL2 app. */
+	bool             headless;
 	bool             useCloudFS;       //!< Use cloud FS if available
 	bool             useMemoryFS;      //!< Use memory FS
 	std::string      windowsDir;    //!< Custom directory for windows build
@@ -133,6 +139,7 @@ struct AppSettings
 	versionString("undef"),
 	targetFPS(0),
 	useFixedDeltaTime(false),
+	headless(false),
 	useCloudFS(false),
 	useMemoryFS(false),
 	windowsDir("/win"),
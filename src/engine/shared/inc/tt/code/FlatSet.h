@@ -0,0 +1,250 @@
+#if !defined(INC_TT_CODE_FLATSET_H)
+#define INC_TT_CODE_FLATSET_H
+
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+
+namespace tt {
+namespace code {
+
+/*! \brief Ordered set stored as a sorted, contiguous vector.
+    Iteration order is the same as std::set with the same Compare, but lookups don't chase
+    pointers and clear() keeps the allocated storage, so a set that is refilled every frame
+    stops allocating once it has reached its working size.
+    Insert and erase are O(n); use it for sets that are queried far more often than changed. */
+template <typename Type, typename Compare = std::less<Type> >
+class FlatSet
+{
+public:
+	typedef std::vector<Type>                       Container;
+	typedef Type                                    key_type;
+	typedef Type                                    value_type;
+	typedef Compare                                 key_compare;
+	typedef typename Container::size_type           size_type;
+	typedef typename Container::const_iterator      iterator;
+	typedef typename Container::const_iterator      const_iterator;
+	typedef typename Container::const_reverse_iterator reverse_iterator;
+	typedef typename Container::const_reverse_iterator const_reverse_iterator;
+
+	inline FlatSet()
+	:
+	m_values(),
+	m_compare()
+	{ }
+
+	template <typename InputIterator>
+	inline FlatSet(InputIterator p_first, InputIterator p_last)
+	:
+	m_values(p_first, p_last),
+	m_compare()
+	{
+		sortAndRemoveDuplicates(m_values.begin());
+	}
+
+	inline const_iterator         begin()  const { return m_values.begin();  }
+	inline const_iterator         end()    const { return m_values.end();    }
+	inline const_reverse_iterator rbegin() const { return m_values.rbegin(); }
+	inline const_reverse_iterator rend()   const { return m_values.rend();   }
+
+	inline bool      empty()    const { return m_values.empty();    }
+	inline size_type size()     const { return m_values.size();     }
+	inline size_type capacity() const { return m_values.capacity(); }
+
+	inline void reserve(size_type p_count) { m_values.reserve(p_count); }
+
+	//! \brief Removes all elements, but keeps the allocated storage.
+	inline void clear() { m_values.clear(); }
+
+	inline void swap(FlatSet& p_other) { m_values.swap(p_other.m_values); }
+
+	inline const_iterator lower_bound(const Type& p_value) const
+	{
+		return std::lower_bound(m_values.begin(), m_values.end(), p_value, m_compare);
+	}
+
+	inline const_iterator find(const Type& p_value) const
+	{
+		const_iterator it = lower_bound(p_value);
+		return (it != m_values.end() && m_compare(p_value, *it) == false) ? it : m_values.end();
+	}
+
+	inline size_type count(const Type& p_value) const { return (find(p_value) != end()) ? 1 : 0; }
+	inline bool      contains(const Type& p_value) const { return find(p_value) != end(); }
+
+	inline std::pair<const_iterator, bool> insert(const Type& p_value)
+	{
+		typename Container::iterator it = std::lower_bound(m_values.begin(), m_values.end(),
+		                                                   p_value, m_compare);
+		if (it != m_values.end() && m_compare(p_value, *it) == false)
+		{
+			return std::make_pair(const_iterator(it), false);
+		}
+		it = m_values.insert(it, p_value);
+		return std::make_pair(const_iterator(it), true);
+	}
+
+	//! \brief Inserts a range of values with a single sort/merge pass.
+	template <typename InputIterator>
+	inline void insert(InputIterator p_first, InputIterator p_last)
+	{
+		const size_type oldSize = m_values.size();
+		m_values.insert(m_values.end(), p_first, p_last);
+		sortAndRemoveDuplicates(m_values.begin() + oldSize);
+	}
+
+	inline size_type erase(const Type& p_value)
+	{
+		const_iterator it = find(p_value);
+		if (it == end())
+		{
+			return 0;
+		}
+		erase(it);
+		return 1;
+	}
+
+	inline const_iterator erase(const_iterator p_position)
+	{
+		// Some older standard libraries don't accept const_iterator in vector::erase.
+		const typename Container::iterator it = m_values.begin() + (p_position - m_values.begin());
+		return m_values.erase(it);
+	}
+
+	inline bool operator==(const FlatSet& p_rhs) const { return m_values == p_rhs.m_values; }
+	inline bool operator!=(const FlatSet& p_rhs) const { return m_values != p_rhs.m_values; }
+
+private:
+	// Sorts the values from p_unsortedBegin onwards, merges them with the (sorted) front part
+	// and removes duplicates. Keeps the first occurrence of equal values.
+	inline void sortAndRemoveDuplicates(typename Container::iterator p_unsortedBegin)
+	{
+		std::stable_sort(p_unsortedBegin, m_values.end(), m_compare);
+		std::inplace_merge(m_values.begin(), p_unsortedBegin, m_values.end(), m_compare);
+		m_values.erase(std::unique(m_values.begin(), m_values.end(), Equal(m_compare)), m_values.end());
+	}
+
+	struct Equal
+	{
+		explicit inline Equal(const Compare& p_compare) : compare(p_compare) { }
+		inline bool operator()(const Type& p_a, const Type& p_b) const
+		{
+			return compare(p_a, p_b) == false && compare(p_b, p_a) == false;
+		}
+		Compare compare;
+	};
+
+	Container m_values;
+	Compare   m_compare;
+};
+
+
+/*! \brief Ordered map stored as a sorted, contiguous vector of key/value pairs.
+    Same trade-offs as FlatSet: cheap lookups and iteration, O(n) insert and erase,
+    and clear() keeps the allocated storage. */
+template <typename Key, typename Value, typename Compare = std::less<Key> >
+class FlatMap
+{
+public:
+	typedef std::pair<Key, Value>                   value_type;
+	typedef std::vector<value_type>                 Container;
+	typedef Key                                     key_type;
+	typedef Value                                   mapped_type;
+	typedef Compare                                 key_compare;
+	typedef typename Container::size_type           size_type;
+	typedef typename Container::iterator            iterator;
+	typedef typename Container::const_iterator      const_iterator;
+
+	inline FlatMap()
+	:
+	m_values(),
+	m_compare()
+	{ }
+
+	inline iterator       begin()       { return m_values.begin(); }
+	inline iterator       end()         { return m_values.end();   }
+	inline const_iterator begin() const { return m_values.begin(); }
+	inline const_iterator end()   const { return m_values.end();   }
+
+	inline bool      empty()    const { return m_values.empty();    }
+	inline size_type size()     const { return m_values.size();     }
+	inline size_type capacity() const { return m_values.capacity(); }
+
+	inline void reserve(size_type p_count) { m_values.reserve(p_count); }
+
+	//! \brief Removes all elements, but keeps the allocated storage.
+	inline void clear() { m_values.clear(); }
+
+	inline void swap(FlatMap& p_other) { m_values.swap(p_other.m_values); }
+
+	inline iterator lower_bound(const Key& p_key)
+	{
+		return std::lower_bound(m_values.begin(), m_values.end(), p_key, KeyCompare(m_compare));
+	}
+	inline const_iterator lower_bound(const Key& p_key) const
+	{
+		return std::lower_bound(m_values.begin(), m_values.end(), p_key, KeyCompare(m_compare));
+	}
+
+	inline iterator find(const Key& p_key)
+	{
+		iterator it = lower_bound(p_key);
+		return (it != m_values.end() && m_compare(p_key, it->first) == false) ? it : m_values.end();
+	}
+	inline const_iterator find(const Key& p_key) const
+	{
+		const_iterator it = lower_bound(p_key);
+		return (it != m_values.end() && m_compare(p_key, it->first) == false) ? it : m_values.end();
+	}
+
+	inline size_type count(const Key& p_key) const { return (find(p_key) != end()) ? 1 : 0; }
+
+	inline std::pair<iterator, bool> insert(const value_type& p_value)
+	{
+		iterator it = lower_bound(p_value.first);
+		if (it != m_values.end() && m_compare(p_value.first, it->first) == false)
+		{
+			return std::make_pair(it, false);
+		}
+		it = m_values.insert(it, p_value);
+		return std::make_pair(it, true);
+	}
+
+	inline Value& operator[](const Key& p_key)
+	{
+		return insert(value_type(p_key, Value())).first->second;
+	}
+
+	inline iterator erase(iterator p_position) { return m_values.erase(p_position); }
+
+	inline size_type erase(const Key& p_key)
+	{
+		iterator it = find(p_key);
+		if (it == end())
+		{
+			return 0;
+		}
+		m_values.erase(it);
+		return 1;
+	}
+
+private:
+	struct KeyCompare
+	{
+		explicit inline KeyCompare(const Compare& p_compare) : compare(p_compare) { }
+		inline bool operator()(const value_type& p_a, const Key& p_b) const { return compare(p_a.first, p_b); }
+		Compare compare;
+	};
+
+	Container m_values;
+	Compare   m_compare;
+};
+
+// Namespace end
+}
+}
+
+
+#endif  // !defined(INC_TT_CODE_FLATSET_H)
@@ -27,6 +27,7 @@ class Animation
 public:
 	static const file::FileType fileType = file::FileType_Animation;
 	static const bool hasResourceHeader = true;
+	static const bool hasThreadSafeLoad = false;
 	
 public:
 	explicit Animation(const EngineID& p_id);
@@ -440,22 +440,44 @@ typename ResourceCache<ResourceType>::ResourcePtr ResourceCache<ResourceType>::l
 		}
 	}
 	
+	// Decoding can take long: resource types that allow it are loaded without holding the cache lock,
+	// so load threads can load different resources at the same time. A type may only set
+	// hasThreadSafeLoad if its create() and load() touch nothing but the new object (and the file).
+	if (ResourceType::hasThreadSafeLoad)
+	{
+		ms_mutex.unlock();
+	}
+	
 	// Create a new object for the resource
 	ResourceType* raw(ResourceType::create(file, p_id, p_flags));
+	const bool loadOk = raw != 0 && raw->load(file);
 	
-	if (raw != 0)
+	if (ResourceType::hasThreadSafeLoad)
 	{
-		if (raw->load(file) == false)
-		{
-			TT_PANIC("[ENGINE] Failed to load: [%s]", p_id.toDebugString().c_str());
-			delete raw;
-			return ResourcePtr();
-		}
+		ms_mutex.lock();
 	}
-	else
+	
+	if (raw == 0)
 	{
 		return ResourcePtr();
 	}
+	else if (loadOk == false)
+	{
+		TT_PANIC("[ENGINE] Failed to load: [%s]", p_id.toDebugString().c_str());
+		delete raw;
+		return ResourcePtr();
+	}
+	
+	if (ResourceType::hasThreadSafeLoad)
+	{
+		// Another thread may have loaded the same resource in the meantime: keep the first one
+		typename ResourceContainer::iterator it = ms_resources.find(p_id);
+		if (it != ms_resources.end())
+		{
+			delete raw;
+			return it->second.lock();
+		}
+	}
 	
 	// Transfer ownership to smart pointer
 	TT_NULL_ASSERT(raw);
@@ -0,0 +1,67 @@
+#if !defined(INC_TT_ENGINE_PARTICLES_PARTICLEBENCHMARK)
+#define INC_TT_ENGINE_PARTICLES_PARTICLEBENCHMARK
+
+#include <vector>
+
+#include <tt/args/CmdLine.h>
+#include <tt/engine/particles/fwd.h>
+#include <tt/engine/particles/Particle.h>
+#include <tt/engine/renderer/QuadBuffer.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace tt {
+namespace engine {
+namespace particles {
+
+/*! \brief Compares the particle update and quad generation of ParticleEmitter with the previous
+    implementation, which stored every particle as a Particle struct and built a matrix per quad.
+    Started with --benchmark_particles [folder] (default 'particles/').
+    Every trigger file in the folder is started and updated --benchmark_warmup frames (default 60).
+    From the particles every emitter has then, both implementations simulate --benchmark_frames
+    frames (default 60) without emitting, --benchmark_iterations times (default 10), with the same
+    random numbers. Reports the time of both and the largest difference between their quads, which
+    should stay within --benchmark_tolerance (default 0.001, relative to the position).
+    Everything is written as JSON to --benchmark_output (default benchmark_particles.json).
+    \note Needs a ParticleMgr instance. */
+class ParticleBenchmark
+{
+public:
+	/*! \return false if no triggers were found, the results differ or the report could not be written. */
+	static bool run(const tt::args::CmdLine& p_cmdLine);
+	
+private:
+	typedef std::vector<Particle> ReferenceParticles;
+	
+	struct QuadDifference
+	{
+		QuadDifference() : position(0.0f), texCoord(0.0f), color(0) { }
+		
+		real position; // Relative to the position
+		real texCoord;
+		s32  color;
+	};
+	
+	/*! \brief The previous ParticleEmitter::update() of the particles, on a Particle per particle. */
+	static s32 updateReference(ParticleEmitter& p_emitter, ReferenceParticles& p_particles,
+	                           real p_deltaTime);
+	
+	/*! \brief The previous ParticleEmitter::createQuadBatch(). */
+	static void createReferenceQuads(const ParticleEmitter& p_emitter, const ReferenceParticles& p_particles,
+	                                 renderer::BatchQuadCollection& p_quads_OUT);
+	
+	static QuadDifference compareQuads(const renderer::BatchQuadCollection& p_reference,
+	                                   const renderer::BatchQuadCollection& p_quads, size_t p_count);
+	
+	ParticleBenchmark();                                          // Static class
+	ParticleBenchmark(const ParticleBenchmark&);                  // Disable copy
+	const ParticleBenchmark& operator=(const ParticleBenchmark&); // Disable assigment.
+};
+
+
+// Namespace end
+}
+}
+}
+
+#endif // !defined(INC_TT_ENGINE_PARTICLES_PARTICLEBENCHMARK)
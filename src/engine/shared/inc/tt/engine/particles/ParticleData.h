@@ -0,0 +1,222 @@
+#if !defined(INC_TT_ENGINE_PARTICLES_PARTICLEDATA)
+#define INC_TT_ENGINE_PARTICLES_PARTICLEDATA
+
+#include <vector>
+
+#include <tt/engine/particles/Particle.h>
+#include <tt/engine/renderer/ColorRGBA.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace tt {
+namespace engine {
+namespace particles {
+
+/*! \brief All particles of an emitter, stored as one array per property (structure of arrays).
+    The emitter update runs every step over a single property for all particles, so the loops only
+    touch the data they need and the compiler can turn them into SIMD code (SSE2/NEON).
+    Particle is still used to build a new particle and to read a single particle back. */
+struct ParticleData
+{
+	// Current properties
+	std::vector<real> position_x;
+	std::vector<real> position_y;
+	std::vector<real> velocity_x;
+	std::vector<real> velocity_y;
+	std::vector<real> velocity_friction;
+	std::vector<real> energy;
+	std::vector<real> scale_x;           // Also the current size
+	std::vector<real> scale_y;
+	std::vector<real> weight;
+	std::vector<real> rotation;
+	std::vector<real> rotation_friction;
+	
+	// Update properties
+	std::vector<real> lifetime;
+	std::vector<real> start_size;
+	std::vector<real> end_size;
+	std::vector<real> start_weight;
+	std::vector<real> end_weight;
+	std::vector<real> start_rotation;
+	std::vector<real> rotation_speed;
+	std::vector<real> rotation_force;
+	
+	// Animation
+	std::vector<u32>  anim_idx;
+	std::vector<s32>  frame;
+	std::vector<real> animation_time;
+	std::vector<real> tex_u;
+	std::vector<real> tex_v;
+	
+	// Color
+	std::vector<renderer::ColorRGBA> start_color;
+	std::vector<renderer::ColorRGBA> end_color;
+	std::vector<real>                fade_in;
+	std::vector<real>                fade_out;
+	
+	
+	inline size_t size() const { return energy.size(); }
+	inline bool  empty() const { return energy.empty(); }
+	
+	inline void reserve(size_t p_count) { forEachArray(Reserve(p_count)); }
+	inline void resize(size_t p_count)  { forEachArray(Resize(p_count));  }
+	inline void clear()                 { forEachArray(Resize(0));        }
+	
+	inline void push_back(const Particle& p_particle)
+	{
+		position_x       .push_back(p_particle.position.x);
+		position_y       .push_back(p_particle.position.y);
+		velocity_x       .push_back(p_particle.velocity.x);
+		velocity_y       .push_back(p_particle.velocity.y);
+		velocity_friction.push_back(p_particle.velocity_friction);
+		energy           .push_back(p_particle.energy);
+		scale_x          .push_back(p_particle.scale.x);
+		scale_y          .push_back(p_particle.scale.y);
+		weight           .push_back(p_particle.weight);
+		rotation         .push_back(p_particle.rotation);
+		rotation_friction.push_back(p_particle.rotation_friction);
+		lifetime         .push_back(p_particle.lifetime);
+		start_size       .push_back(p_particle.start_size);
+		end_size         .push_back(p_particle.end_size);
+		start_weight     .push_back(p_particle.start_weight);
+		end_weight       .push_back(p_particle.end_weight);
+		start_rotation   .push_back(p_particle.start_rotation);
+		rotation_speed   .push_back(p_particle.rotation_speed);
+		rotation_force   .push_back(p_particle.rotation_force);
+		anim_idx         .push_back(static_cast<u32>(p_particle.anim_idx));
+		frame            .push_back(p_particle.frame);
+		animation_time   .push_back(p_particle.animation_time);
+		tex_u            .push_back(p_particle.tex_transform.x);
+		tex_v            .push_back(p_particle.tex_transform.y);
+		start_color      .push_back(p_particle.start_color);
+		end_color        .push_back(p_particle.end_color);
+		fade_in          .push_back(p_particle.fade_in);
+		fade_out         .push_back(p_particle.fade_out);
+	}
+	
+	inline Particle get(size_t p_index) const
+	{
+		Particle particle;
+		particle.position.x        = position_x       [p_index];
+		particle.position.y        = position_y       [p_index];
+		particle.velocity.x        = velocity_x       [p_index];
+		particle.velocity.y        = velocity_y       [p_index];
+		particle.velocity_friction = velocity_friction[p_index];
+		particle.energy            = energy           [p_index];
+		particle.size              = scale_x          [p_index];
+		particle.scale.x           = scale_x          [p_index];
+		particle.scale.y           = scale_y          [p_index];
+		particle.weight            = weight           [p_index];
+		particle.rotation          = rotation         [p_index];
+		particle.rotation_friction = rotation_friction[p_index];
+		particle.lifetime          = lifetime         [p_index];
+		particle.start_size        = start_size       [p_index];
+		particle.end_size          = end_size         [p_index];
+		particle.start_weight      = start_weight     [p_index];
+		particle.end_weight        = end_weight       [p_index];
+		particle.start_rotation    = start_rotation   [p_index];
+		particle.rotation_speed    = rotation_speed   [p_index];
+		particle.rotation_force    = rotation_force   [p_index];
+		particle.anim_idx          = anim_idx         [p_index];
+		particle.frame             = frame            [p_index];
+		particle.animation_time    = animation_time   [p_index];
+		particle.tex_transform.x   = tex_u            [p_index];
+		particle.tex_transform.y   = tex_v            [p_index];
+		particle.start_color       = start_color      [p_index];
+		particle.end_color         = end_color        [p_index];
+		particle.fade_in           = fade_in          [p_index];
+		particle.fade_out          = fade_out         [p_index];
+		return particle;
+	}
+	
+	/*! \brief Overwrites the particle at p_target with the one at p_source. */
+	inline void move(size_t p_target, size_t p_source)
+	{
+		position_x       [p_target] = position_x       [p_source];
+		position_y       [p_target] = position_y       [p_source];
+		velocity_x       [p_target] = velocity_x       [p_source];
+		velocity_y       [p_target] = velocity_y       [p_source];
+		velocity_friction[p_target] = velocity_friction[p_source];
+		energy           [p_target] = energy           [p_source];
+		scale_x          [p_target] = scale_x          [p_source];
+		scale_y          [p_target] = scale_y          [p_source];
+		weight           [p_target] = weight           [p_source];
+		rotation         [p_target] = rotation         [p_source];
+		rotation_friction[p_target] = rotation_friction[p_source];
+		lifetime         [p_target] = lifetime         [p_source];
+		start_size       [p_target] = start_size       [p_source];
+		end_size         [p_target] = end_size         [p_source];
+		start_weight     [p_target] = start_weight     [p_source];
+		end_weight       [p_target] = end_weight       [p_source];
+		start_rotation   [p_target] = start_rotation   [p_source];
+		rotation_speed   [p_target] = rotation_speed   [p_source];
+		rotation_force   [p_target] = rotation_force   [p_source];
+		anim_idx         [p_target] = anim_idx         [p_source];
+		frame            [p_target] = frame            [p_source];
+		animation_time   [p_target] = animation_time   [p_source];
+		tex_u            [p_target] = tex_u            [p_source];
+		tex_v            [p_target] = tex_v            [p_source];
+		start_color      [p_target] = start_color      [p_source];
+		end_color        [p_target] = end_color        [p_source];
+		fade_in          [p_target] = fade_in          [p_source];
+		fade_out         [p_target] = fade_out         [p_source];
+	}
+	
+private:
+	struct Reserve
+	{
+		explicit Reserve(size_t p_count) : count(p_count) { }
+		template <typename T>
+		inline void operator()(std::vector<T>& p_array) const { p_array.reserve(count); }
+		size_t count;
+	};
+	
+	struct Resize
+	{
+		explicit Resize(size_t p_count) : count(p_count) { }
+		template <typename T>
+		inline void operator()(std::vector<T>& p_array) const { p_array.resize(count); }
+		size_t count;
+	};
+	
+	template <typename Function>
+	inline void forEachArray(const Function& p_function)
+	{
+		p_function(position_x);
+		p_function(position_y);
+		p_function(velocity_x);
+		p_function(velocity_y);
+		p_function(velocity_friction);
+		p_function(energy);
+		p_function(scale_x);
+		p_function(scale_y);
+		p_function(weight);
+		p_function(rotation);
+		p_function(rotation_friction);
+		p_function(lifetime);
+		p_function(start_size);
+		p_function(end_size);
+		p_function(start_weight);
+		p_function(end_weight);
+		p_function(start_rotation);
+		p_function(rotation_speed);
+		p_function(rotation_force);
+		p_function(anim_idx);
+		p_function(frame);
+		p_function(animation_time);
+		p_function(tex_u);
+		p_function(tex_v);
+		p_function(start_color);
+		p_function(end_color);
+		p_function(fade_in);
+		p_function(fade_out);
+	}
+};
+
+
+// Namespace end
+}
+}
+}
+
+#endif // !defined(INC_TT_ENGINE_PARTICLES_PARTICLEDATA)
@@ -9,6 +9,7 @@
 
 #include <tt/engine/particles/fwd.h>
 #include <tt/engine/particles/Particle.h>
+#include <tt/engine/particles/ParticleData.h>
 #include <tt/engine/scene2d/Scene2D.h>
 #include <tt/engine/scene/Camera.h>
 #include <tt/engine/renderer/QuadBuffer.h>
@@ -405,6 +406,10 @@ private:
 	
 	void pregenerateParticles();
 	
+	/*! \brief Moves, rotates and animates all particles and removes the dead ones.
+	    \return Number of particles that died. */
+	s32 updateParticles(real p_delta_time);
+	
 	void createQuadBatch();
 	
 	//Enable Copy / disable assignment
@@ -445,11 +450,18 @@ private:
 	// 'Kills' particles outside this rect
 	math::VectorRect m_validRect;
 	
-	// List containing all particles in the system
-	typedef std::vector<Particle> Particles;
-	Particles m_particles;
+	// All particles in the system
+	ParticleData m_particles;
+	
+	// Scratch buffers of updateParticles(), kept to reuse their memory
+	std::vector<u32>  m_updateOrder;    // Order in which the particles are updated
+	std::vector<u32>  m_survivors;      // Slots of the surviving particles, in their new order
+	std::vector<real> m_externalForceX;
+	std::vector<real> m_externalForceY;
 	
 	renderer::BatchQuadCollection m_quadBatch;
+	
+	friend class ParticleBenchmark;
 };
 
 // Enum functions
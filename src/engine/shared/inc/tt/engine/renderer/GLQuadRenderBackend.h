@@ -0,0 +1,51 @@
+#if !defined(INC_TT_ENGINE_RENDERER_GLQUADRENDERBACKEND_H)
+#define INC_TT_ENGINE_RENDERER_GLQUADRENDERBACKEND_H
+
+#include <tt/engine/opengl_headers.h>
+#include <tt/engine/renderer/QuadRenderBackend.h>
+
+
+namespace tt {
+namespace engine {
+namespace renderer {
+
+/*! \brief Draws quads from vertex buffer objects with a shared index buffer.
+           Streamed vertices go to a ring buffer that is orphaned when it wraps, so the driver never
+           has to wait for the GPU to finish with vertices of earlier draws. */
+class GLQuadRenderBackend : public QuadRenderBackend
+{
+public:
+	GLQuadRenderBackend();
+	virtual ~GLQuadRenderBackend();
+	
+	virtual void begin();
+	virtual void end();
+	
+protected:
+	virtual BufferID doCreateRetainedBuffer(const QuadVertex* p_vertices, s32 p_vertexCount);
+	virtual void     doDestroyRetainedBuffer(BufferID p_buffer);
+	virtual s32      doStreamVertices(const QuadVertex* p_vertices, s32 p_vertexCount);
+	virtual void     doSetState(const QuadRenderState& p_state);
+	virtual void     doDrawQuads(BufferID p_buffer, s32 p_firstVertex, s32 p_quadCount);
+	
+private:
+	GLuint m_indexBuffer;
+	GLuint m_streamBuffer;
+	s32    m_streamCapacity; // in vertices
+	s32    m_streamOffset;   // in vertices
+	
+	// Renderer settings at begin(), restored by end()
+	bool        m_inBegin;
+	bool        m_savedFogEnabled;
+	bool        m_savedSeparateAlphaBlendEnabled;
+	BlendFactor m_savedBlendModeAlphaSrc;
+	BlendFactor m_savedBlendModeAlphaDst;
+};
+
+// Namespace end
+}
+}
+}
+
+
+#endif  // !defined(INC_TT_ENGINE_RENDERER_GLQUADRENDERBACKEND_H)
@@ -30,6 +30,7 @@ class Material
 public:
 	static const file::FileType fileType = file::FileType_Material;
 	static const bool hasResourceHeader = true;
+	static const bool hasThreadSafeLoad = false;
 	
 	enum Flag
 	{
@@ -4,6 +4,7 @@
 #include <tt/engine/renderer/ColorRGBA.h>
 #include <tt/engine/renderer/fwd.h>
 #include <tt/engine/renderer/BufferVtx.h>
+#include <tt/engine/renderer/QuadRenderBackend.h>
 #include <tt/math/Vector2.h>
 #include <tt/math/Vector3.h>
 #include <tt/platform/tt_types.h>
@@ -51,6 +52,14 @@ public:
 	/*! \brief Render this quad on the screen */
 	void render() const;
 	
+	/*! \brief Draws the quads with the current state of the backend. */
+	void draw(QuadRenderBackend& p_backend) const;
+	
+	/*! \brief Returns the buffer that keeps the quads on the GPU, creating it if the quads were also
+	           drawn unchanged before. Returns 0 if the quads must be streamed (they changed since the
+	           last draw). */
+	QuadRenderBackend::BufferID acquireRetainedBuffer(QuadRenderBackend& p_backend) const;
+	
 	/*! \brief Set/Get the texture to use for this batch */
 	inline void setTexture(const TexturePtr& p_texture) {m_texture = p_texture;}
 	inline const TexturePtr& getTexture() const { return m_texture; }
@@ -66,8 +75,14 @@ public:
 	void clear();
 	
 	inline s32 getCapacity() const { return m_capacity; }
+	inline s32 getQuadCount() const { return m_quadCount; }
+	inline bool usesVertexColor() const { return m_useVtxColor; }
+	inline const QuadVertex* getVertices() const { return m_vertices; }
 	
 private:
+	friend class QuadRenderBackend;
+	
+
 	// No copying
 	QuadBuffer(const QuadBuffer& p_rhs);
 	QuadBuffer& operator=(const QuadBuffer& p_rhs);
@@ -77,6 +92,10 @@ private:
 		const BatchQuadCollection::const_iterator& p_end,
 		s32 p_startIndex);
 	
+	void markDirty();
+	void releaseRetainedBuffer() const;
+	void onBackendDestroyed() const;
+	
 	// Vertex Data
 	bool m_useVtxColor;
 	
@@ -85,15 +104,13 @@ private:
 	
 	TexturePtr m_texture;
 	
-	// Dynamically allocated arrays of size (m_capacity * VerticesPerQuad)
-	math::Vector3* m_vertexCoordinates;
-	math::Vector2* m_textureCoordinates;
-	ColorRGBA*     m_colors;
+	// Dynamically allocated array of size (m_capacity * VerticesPerQuad)
+	QuadVertex* m_vertices;
 	
-	enum { IndicesPerQuad = 6 };
-	/*! \brief Index buffer for all possible quads. Shared between all QuadBuffers. */
-	static u32  ms_indexBuffer[maxBatchSize * IndicesPerQuad];
-	static bool ms_indexBufferInitialized;
+	// Quads that are drawn unchanged are kept on the GPU instead of being uploaded every draw
+	mutable bool                        m_dirty;
+	mutable QuadRenderBackend*          m_retainedBackend;
+	mutable QuadRenderBackend::BufferID m_retainedBuffer;
 };
 
 // Namespace end
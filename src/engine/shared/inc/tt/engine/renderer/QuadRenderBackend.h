@@ -0,0 +1,155 @@
+#if !defined(INC_TT_ENGINE_RENDERER_QUADRENDERBACKEND_H)
+#define INC_TT_ENGINE_RENDERER_QUADRENDERBACKEND_H
+
+#include <set>
+
+#include <tt/engine/renderer/ColorRGBA.h>
+#include <tt/engine/renderer/enums.h>
+#include <tt/engine/renderer/fwd.h>
+#include <tt/math/Vector2.h>
+#include <tt/math/Vector3.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace tt {
+namespace engine {
+namespace renderer {
+
+/*! \brief Interleaved vertex as stored by QuadBuffer and uploaded to the GPU. */
+struct QuadVertex
+{
+	math::Vector3 position;
+	math::Vector2 texCoord;
+	ColorRGBA     color;
+};
+
+
+/*! \brief Everything that has to match for two sets of quads to be drawn with one draw call. */
+struct QuadRenderState
+{
+	QuadRenderState()
+	:
+	texture(),
+	vertexColor(false),
+	blendMode(BlendMode_Invalid),
+	blendModeAlpha(BlendModeAlpha_NoOverride),
+	fogEnabled(true)
+	{ }
+	
+	QuadRenderState(const TexturePtr& p_texture, bool p_vertexColor)
+	:
+	texture(p_texture),
+	vertexColor(p_vertexColor),
+	blendMode(BlendMode_Invalid),
+	blendModeAlpha(BlendModeAlpha_NoOverride),
+	fogEnabled(true)
+	{ }
+	
+	inline bool operator==(const QuadRenderState& p_rhs) const
+	{
+		return texture        == p_rhs.texture        &&
+		       vertexColor    == p_rhs.vertexColor    &&
+		       blendMode      == p_rhs.blendMode      &&
+		       blendModeAlpha == p_rhs.blendModeAlpha &&
+		       fogEnabled     == p_rhs.fogEnabled;
+	}
+	inline bool operator!=(const QuadRenderState& p_rhs) const { return (*this == p_rhs) == false; }
+	
+	TexturePtr     texture;
+	bool           vertexColor;
+	BlendMode      blendMode;      //!< BlendMode_Invalid keeps the blend and fog settings of the renderer.
+	BlendModeAlpha blendModeAlpha;
+	bool           fogEnabled;     //!< Whether fog may be applied (only if the renderer has fog enabled).
+};
+
+
+/*! \brief Submits quads to the GPU. QuadBuffer and QuadRenderQueue only talk to the GPU through this
+           interface, so their draw calls, state changes and uploads can be counted without a GPU. */
+class QuadRenderBackend
+{
+public:
+	typedef u32 BufferID; //!< Retained vertex buffer; 0 is the stream buffer.
+	
+	struct Stats
+	{
+		Stats()
+		:
+		drawCalls(0),
+		stateChanges(0),
+		quadsDrawn(0),
+		retainedBuffers(0),
+		bytesUploaded(0)
+		{ }
+		
+		s32 drawCalls;
+		s32 stateChanges;
+		s32 quadsDrawn;
+		s32 retainedBuffers; //!< Number of retained buffers created.
+		u64 bytesUploaded;
+	};
+	
+	enum
+	{
+		VerticesPerQuad = 4,
+		IndicesPerQuad  = 6,
+		MaxQuadsPerDraw = 50000
+	};
+	
+	virtual ~QuadRenderBackend();
+	
+	/*! \brief Uploads vertices to a buffer that stays on the GPU until it is destroyed. */
+	BufferID createRetainedBuffer(const QuadVertex* p_vertices, s32 p_vertexCount);
+	void     destroyRetainedBuffer(BufferID p_buffer);
+	
+	/*! \brief Appends vertices to the stream buffer.
+	    \return Index of the first appended vertex in the stream buffer. */
+	s32 streamVertices(const QuadVertex* p_vertices, s32 p_vertexCount);
+	
+	/*! \brief Makes the state current, unless it already is. */
+	void setState(const QuadRenderState& p_state);
+	
+	/*! \brief Forgets the current state, for when other code may have changed the render state. */
+	inline void invalidateState() { m_hasState = false; }
+	
+	void drawQuads(BufferID p_buffer, s32 p_firstVertex, s32 p_quadCount);
+	
+	/*! \brief Called around a series of draws. States set in between (blend mode, fog) are restored by end(). */
+	virtual void begin() { }
+	virtual void end()   { }
+	
+	inline const Stats& getStats() const { return m_stats; }
+	inline void resetStats() { m_stats = Stats(); }
+	
+protected:
+	QuadRenderBackend();
+	
+	virtual BufferID doCreateRetainedBuffer(const QuadVertex* p_vertices, s32 p_vertexCount) = 0;
+	virtual void     doDestroyRetainedBuffer(BufferID p_buffer) = 0;
+	virtual s32      doStreamVertices(const QuadVertex* p_vertices, s32 p_vertexCount) = 0;
+	virtual void     doSetState(const QuadRenderState& p_state) = 0;
+	virtual void     doDrawQuads(BufferID p_buffer, s32 p_firstVertex, s32 p_quadCount) = 0;
+	
+private:
+	// QuadBuffers that hold a retained buffer of this backend are told when it goes away
+	friend class QuadBuffer;
+	void registerRetainer  (QuadBuffer* p_buffer);
+	void unregisterRetainer(QuadBuffer* p_buffer);
+	
+	// No copying
+	QuadRenderBackend(const QuadRenderBackend&);
+	QuadRenderBackend& operator=(const QuadRenderBackend&);
+	
+	
+	Stats                 m_stats;
+	QuadRenderState       m_state;
+	bool                  m_hasState;
+	std::set<QuadBuffer*> m_retainers;
+};
+
+// Namespace end
+}
+}
+}
+
+
+#endif  // !defined(INC_TT_ENGINE_RENDERER_QUADRENDERBACKEND_H)
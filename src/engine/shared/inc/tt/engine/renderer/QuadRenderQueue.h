@@ -0,0 +1,83 @@
+#if !defined(INC_TT_ENGINE_RENDERER_QUADRENDERQUEUE_H)
+#define INC_TT_ENGINE_RENDERER_QUADRENDERQUEUE_H
+
+#include <vector>
+
+#include <tt/engine/renderer/QuadRenderBackend.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace tt {
+namespace engine {
+namespace renderer {
+
+class QuadBuffer;
+
+
+/*! \brief Collects QuadBuffer draws between begin() and flush() and submits them with as few state
+           changes and draw calls as possible.
+    \note  Draws are not sorted freely: blended 2D quads depend on painter's order. Only runs of additive
+           draws (whose result doesn't depend on order) are sorted by state; other draws keep their order
+           and are merged with neighbours that share their state. */
+class QuadRenderQueue
+{
+public:
+	explicit QuadRenderQueue(QuadRenderBackend* p_backend);
+	
+	/*! \brief Starts recording; submitted buffers are drawn by flush(). */
+	void begin();
+	inline bool isRecording() const { return m_recording; }
+	
+	/*! \brief Queues a buffer. The buffer must stay alive and unchanged until flush().
+	    \param p_pass Draws of a lower pass are always drawn before draws of a higher pass. */
+	void submit(const QuadBuffer& p_buffer, BlendMode p_blendMode,
+	            BlendModeAlpha p_blendModeAlpha = BlendModeAlpha_NoOverride,
+	            bool p_fogEnabled = true, u8 p_pass = 0);
+	
+	/*! \brief Draws everything submitted since begin() and stops recording. */
+	void flush();
+	
+	inline s32 getQueuedCount() const { return static_cast<s32>(m_items.size()); }
+	
+private:
+	struct Item
+	{
+		u64               key;
+		const QuadBuffer* buffer;
+	};
+	typedef std::vector<Item> Items;
+	
+	struct SortOnKey
+	{
+		inline bool operator()(const Item& p_lhs, const Item& p_rhs) const { return p_lhs.key < p_rhs.key; }
+	};
+	
+	s32  getStateIndex(const QuadRenderState& p_state);
+	void drawPending();
+	
+	// No copying
+	QuadRenderQueue(const QuadRenderQueue&);
+	QuadRenderQueue& operator=(const QuadRenderQueue&);
+	
+	
+	QuadRenderBackend*           m_backend;
+	bool                         m_recording;
+	Items                        m_items;
+	std::vector<QuadRenderState> m_states;
+	
+	// Sorting groups; only commutative draws share a group
+	u32  m_group;
+	bool m_groupIsCommutative;
+	
+	// Consecutive streamed draws with equal state, drawn as one
+	std::vector<QuadVertex> m_pendingVertices;
+	s32                     m_pendingState;
+};
+
+// Namespace end
+}
+}
+}
+
+
+#endif  // !defined(INC_TT_ENGINE_RENDERER_QUADRENDERQUEUE_H)
@@ -38,6 +38,8 @@ namespace renderer {
 class TextureStageData;
 class OpenGLContextWrapper;
 class GLStateCache;
+class QuadRenderBackend;
+class QuadRenderQueue;
 
 
 class Renderer
@@ -251,6 +253,12 @@ public:
 	void checkFromRenderThread() const;
 
 	inline GLStateCache* stateCache() { return m_stateCache; }
+	
+	/*! \brief Backend through which all QuadBuffers are drawn. */
+	inline QuadRenderBackend* getQuadRenderBackend() { return m_quadRenderBackend; }
+	
+	/*! \brief Queue for batching QuadBuffer draws; see QuadRenderQueue. */
+	inline QuadRenderQueue* getQuadRenderQueue() { return m_quadRenderQueue; }
 private:
 	Renderer(OpenGLContextWrapper* p_openGLContext, bool p_ios2xMode);
 	~Renderer();
@@ -399,6 +407,9 @@ private:
 
 	GLStateCache* m_stateCache;
 	
+	QuadRenderBackend* m_quadRenderBackend;
+	QuadRenderQueue*   m_quadRenderQueue;
+	
 	// ParticleTrigger needs to access getActiveCamera for culling
 	friend class particles::ParticleTrigger;
 	friend class scene2d::PlaneScene;
@@ -36,6 +36,7 @@ class Texture : public TextureBase
 public:
 	static const file::FileType fileType = file::FileType_Texture;
 	static const bool hasResourceHeader = true;
+	static const bool hasThreadSafeLoad = true;
 	
 	
 	Texture(const TextureBaseInfo& p_info);
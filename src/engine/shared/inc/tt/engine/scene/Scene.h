@@ -22,6 +22,7 @@ class Scene
 public:
 	static const file::FileType fileType = file::FileType_Scene;
 	static const bool hasResourceHeader = true;
+	static const bool hasThreadSafeLoad = false;
 
 	Scene(const EngineID& p_id, u32 p_flags = 0);
 	~Scene();
@@ -32,6 +32,7 @@ class SceneObject
 public:
 	static const file::FileType fileType = file::FileType_Object;
 	static const bool hasResourceHeader = true;
+	static const bool hasThreadSafeLoad = false;
 	
 	enum Type
 	{
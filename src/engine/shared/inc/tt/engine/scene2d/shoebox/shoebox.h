@@ -126,6 +126,7 @@ public:
 	inline const ShoeboxDataPtr& getLoadedData() const { return m_loadedData; }
 	
 	renderer::TexturePtr addToTextureCache(const std::string& p_filename);
+	renderer::TexturePtr addToTextureCache(const PlaneData&   p_plane);
 	
 	static inline void setParticlesPath(const std::string& p_path) { ms_particlesPath = p_path; }
 	static inline void setTexturesPath (const std::string& p_path) { ms_texturesPath  = p_path; }
@@ -17,6 +17,7 @@
 #include <tt/engine/scene2d/shoebox/fwd.h>
 #include <tt/engine/scene2d/fwd.h>
 #include <tt/engine/fwd.h>
+#include <tt/engine/EngineID.h>
 #include <tt/fs/types.h>
 #include <tt/math/Rect.h>
 #include <tt/math/Vector3.h>
@@ -190,6 +191,7 @@ struct PlaneData : public RectData
 	:
 	id(),
 	textureFilename(),
+	textureEngineID(0, 0),
 	blendMode(renderer::BlendMode_Blend),
 	minFilter(renderer::FilterMode_Invalid),
 	magFilter(renderer::FilterMode_Invalid),
@@ -232,6 +234,7 @@ struct PlaneData : public RectData
 	
 	std::string                              id;
 	std::string                              textureFilename;
+	EngineID                                 textureEngineID; // Resolved when loaded; reset it when changing textureFilename
 	code::DefaultValue<renderer::BlendMode>  blendMode;
 	code::DefaultValue<renderer::FilterMode> minFilter;
 	code::DefaultValue<renderer::FilterMode> magFilter;
@@ -280,6 +283,9 @@ struct PlaneData : public RectData
 	static PlaneData parse(const xml::XmlNode* p_node,                code::ErrorStatus* p_errStatus);
 	static PlaneData parse(const u8*& p_bufferOUT, size_t& p_sizeOUT, code::ErrorStatus* p_errStatus);
 	
+	/*! \brief Returns the resolved textureEngineID, or resolves textureFilename if that wasn't done yet. */
+	EngineID getTextureEngineID() const;
+	
 	void loadPlane(const xml::XmlNode* p_node, code::ErrorStatus* p_errStatus);
 	void savePlane(      xml::XmlNode* p_node, code::ErrorStatus* p_errStatus) const;
 	
@@ -388,6 +394,13 @@ struct ShoeboxData
 	
 	static ShoeboxDataPtr parse(const std::string& p_filename,             code::ErrorStatus* p_errStatus);
 	static ShoeboxDataPtr parse(const u8*& p_bufferOUT, size_t& p_sizeOUT, code::ErrorStatus* p_errStatus);
+	
+	/*! \brief Parses an include file only the first time it is included; every later include of the
+	           same file (by any shoebox) shares that data. The returned data must not be modified. */
+	static ShoeboxDataPtr parseInclude(const std::string& p_filename, code::ErrorStatus* p_errStatus);
+	
+	/*! \brief Forgets all parsed include files, so changed files are loaded again. */
+	static void clearIncludeCache();
 	void saveAsXML(const std::string& p_filename, bool p_formatted, code::ErrorStatus* p_errStatus) const;
 	
 	void mergeWith(const ShoeboxData& p_other /*, offset, scale, priority */);
@@ -415,6 +428,7 @@ tt::engine::renderer::EngineIDToTextures getTexturesWithID(const tt::engine::ren
 
 EngineID getEngineID(const std::string& p_filename);
 renderer::EngineIDToTextures::value_type createTextureCacheEntry(const std::string& p_filename);
+renderer::EngineIDToTextures::value_type createTextureCacheEntry(const PlaneData& p_plane);
 
 
 // Namespace end
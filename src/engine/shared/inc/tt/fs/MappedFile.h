@@ -0,0 +1,47 @@
+#ifndef INC_TT_FS_MAPPEDFILE_H
+#define INC_TT_FS_MAPPEDFILE_H
+
+#include <string>
+
+#include <tt/fs/types.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace tt {
+namespace fs {
+
+/*! \brief A file mapped read-only into memory. Pages are only read from disk when they are touched.
+    \note Takes native paths; the file is not opened through the registered file systems.
+          Implemented per platform. */
+class MappedFile
+{
+public:
+	/*! \brief Maps a file into memory.
+	    \return The mapping or null if the file could not be opened or mapped. */
+	static MappedFilePtr open(const std::string& p_path);
+	
+	~MappedFile();
+	
+	inline const u8* getData() const { return m_data; }
+	inline size_type getSize() const { return m_size; }
+	
+	/*! \brief Tells the OS that a range won't be read again soon, so its pages can be dropped
+	           from memory (they are read from disk again when they are touched). */
+	void release(size_type p_offset, size_type p_size) const;
+	
+private:
+	MappedFile(const u8* p_data, size_type p_size);
+	
+	// No copying
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+	
+	const u8* m_data;
+	size_type m_size;
+};
+
+// Namespace end
+}
+}
+
+#endif // INC_TT_FS_MAPPEDFILE_H
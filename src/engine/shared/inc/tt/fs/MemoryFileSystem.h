@@ -74,6 +74,16 @@ public:
 	    \return false when the archive could not be removed, true when it does.*/
 	static bool removeMemoryArchive(MemoryArchive* p_archive);
 	
+	/*! \brief Adds a pack archive. Pack archives are searched after the memory archives.
+	    \param p_archive The archive to add.
+	    \return false when the archive could not be added, true when it does.*/
+	static bool addPackArchive(PackArchive* p_archive);
+	
+	/*! \brief Removes a pack archive.
+	    \param p_archive The archive to remove.
+	    \return false when the archive could not be removed, true when it does.*/
+	static bool removePackArchive(PackArchive* p_archive);
+	
 	// FIXME: Get rid of these static variables
 	inline static bool isInstantiated() { return ms_isInstantiated; }
 	inline static s32  getID()          { return ms_id; }
@@ -85,8 +95,10 @@ private:
 	MemoryFileSystem& operator=(const MemoryFileSystem& p_rhs);
 	
 	typedef std::vector<MemoryArchive*> Archives;
+	typedef std::vector<PackArchive*>   PackArchives;
 	
-	static Archives ms_archives;
+	static Archives     ms_archives;
+	static PackArchives ms_packArchives;
 	static bool     ms_isInstantiated;
 	static s32      ms_id;
 };
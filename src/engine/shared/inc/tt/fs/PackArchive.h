@@ -0,0 +1,114 @@
+#ifndef INC_TT_FS_PACKARCHIVE_H
+#define INC_TT_FS_PACKARCHIVE_H
+
+#include <list>
+#include <map>
+#include <string>
+
+#include <tt/code/Buffer.h>
+#include <tt/fs/MemoryArchive.h>
+#include <tt/fs/types.h>
+#include <tt/thread/Mutex.h>
+
+
+namespace tt {
+namespace fs {
+
+/*! \brief Read-only archive that is memory mapped instead of loaded.
+    Unlike a MemoryArchive, every file is compressed on its own and the index is sorted on name hash,
+    so opening an archive only maps it and a lookup is a binary search in the mapped index.
+    Stored (uncompressed) files are returned as views on the mapping. Compressed files are
+    decompressed when they are requested and the most recently used ones are kept in a cache.
+    \note The returned buffers of stored files point into the mapping; they are only valid while
+          the archive exists (just like the buffers of a MemoryArchive). */
+class PackArchive
+{
+public:
+	struct File
+	{
+		File()
+		:
+		writeTime(0),
+		content()
+		{ }
+		
+		fs::time_type   writeTime;
+		code::BufferPtr content;
+	};
+	
+	enum
+	{
+		DefaultCacheSize = 16 * 1024 * 1024 //!< Bytes of decompressed files kept in the cache
+	};
+	
+	~PackArchive();
+	
+	/*! \brief Maps a pack archive.
+	    \param p_path Native path of the archive (it is not opened through the registered file systems).
+	    \param p_cacheSize Bytes of decompressed files to keep around. Larger files are never cached. */
+	static PackArchivePtr load(const std::string& p_path, size_type p_cacheSize = DefaultCacheSize);
+	
+	/*! \brief Writes the files of a memory archive as a pack archive, compressing each file on its own.
+	           Files that don't get smaller are stored uncompressed. */
+	static bool save(const std::string&             p_path,
+	                 const MemoryArchive&           p_source,
+	                 MemoryArchive::CompressionType p_compressionType,
+	                 u32                            p_fileAlignment = 32);
+	
+	bool            hasFile       (const std::string& p_relativeFilePath) const;
+	File            getFile       (const std::string& p_relativeFilePath) const;
+	code::BufferPtr getFileContent(const std::string& p_relativeFilePath) const;
+	
+	inline s32 getFileCount() const { return m_fileCount; }
+	std::string getFilePath(s32 p_index) const;
+	File        getFile    (s32 p_index) const;
+	
+	/*! \brief Bytes of decompressed files in the cache. */
+	size_type getCachedSize() const;
+	
+private:
+	struct Entry
+	{
+		u32           hash;
+		u32           offset;
+		u32           storedSize;
+		u32           size;
+		fs::time_type writeTime;
+		u32           pathOffset;
+		MemoryArchive::CompressionType compressionType;
+	};
+	
+	struct CachedFile
+	{
+		s32             index;
+		code::BufferPtr content;
+	};
+	typedef std::list<CachedFile>                  CachedFiles; // Most recently used first
+	typedef std::map<s32, CachedFiles::iterator>   CacheLookup;
+	
+	PackArchive(const MappedFilePtr& p_file, s32 p_fileCount, u32 p_pathTableOffset, size_type p_cacheSize);
+	PackArchive(const PackArchive&);
+	PackArchive& operator=(const PackArchive&);
+	
+	/*! \return Index of the file with the specified path, or -1 if the archive doesn't contain it. */
+	s32   findEntry(const std::string& p_relativeFilePath) const;
+	Entry getEntry(s32 p_index) const;
+	code::BufferPtr getContent(s32 p_index, const Entry& p_entry) const;
+	code::BufferPtr decompress(const Entry& p_entry) const;
+	
+	MappedFilePtr m_file;
+	s32           m_fileCount;
+	u32           m_pathTableOffset;
+	
+	mutable thread::Mutex m_cacheMutex;
+	mutable CachedFiles   m_cachedFiles;
+	mutable CacheLookup   m_cacheLookup;
+	mutable size_type     m_cachedSize;
+	const size_type       m_maxCacheSize;
+};
+
+// Namespace end
+}
+}
+
+#endif // INC_TT_FS_PACKARCHIVE_H
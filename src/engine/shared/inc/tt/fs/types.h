@@ -13,6 +13,8 @@ class FileSystem;
 class Dir;
 class DirEntry;
 class MemoryArchive;
+class MappedFile;
+class PackArchive;
 
 
 // shared pointers
@@ -20,6 +22,8 @@ typedef tt_ptr<File>::shared FilePtr;
 typedef tt_ptr<FileSystem>::shared FileSystemPtr;
 typedef tt_ptr<Dir>::shared DirPtr;
 typedef tt_ptr<MemoryArchive>::shared MemoryArchivePtr;
+typedef tt_ptr<MappedFile>::shared MappedFilePtr;
+typedef tt_ptr<PackArchive>::shared PackArchivePtr;
 
 
 // Typedefs
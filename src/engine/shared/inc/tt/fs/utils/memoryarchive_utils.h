@@ -23,7 +23,8 @@ struct MemoryArchivePackSettings
 	compressionType(MemoryArchive::CompressionType_None),
 	deleteOriginals(false),
 	emptyOriginals(false),
-	emptySize(0)
+	emptySize(0),
+	packArchive(false)
 	{
 	}
 	
@@ -33,6 +34,7 @@ struct MemoryArchivePackSettings
 	bool                           deleteOriginals;
 	bool                           emptyOriginals;
 	s32                            emptySize;  // size to make originals when emptyOriginals is enabled
+	bool                           packArchive; // write a PackArchive (.pack, files compressed separately)
 };
 
 
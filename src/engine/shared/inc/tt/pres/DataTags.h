@@ -21,10 +21,14 @@ namespace tt {
 namespace pres {
 
 
-/*! \brief Represents the tags of an animation as specified in data. */
+/*! \brief Represents the tags of an animation as specified in data.
+    \note The tags are shared between copies and only copied when a copy is modified,
+          so cloning a presentation object does not copy the tags of all its animations. */
 class DataTags
 {
 public:
+	DataTags();
+	
 	/*! \brief Loads the tags from memory.
 	    \param p_bufferOUT The buffer to load from, will be updated.
 	    \param p_sizeOUT The size of the buffer, will be updated
@@ -38,7 +42,7 @@ public:
 	/*! \brief Whether this DataTags is Tagged with the given tag set.
 	    \param p_startTags The tags this animation is started with.
 	    \return Whether this DataTags is Tagged with the given tag set..*/
-	bool shouldPlay(const Tags& p_startTags, const std::string& p_name);
+	bool shouldPlay(const Tags& p_startTags, const std::string& p_name) const;
 	
 	/*! \brief Adds all the tags from another dataTags object.*/
 	void addDataTags(const DataTags& p_applyTags);
@@ -69,7 +73,7 @@ public:
 	
 	str::StringSet getAllUsedNames()const;
 	
-	inline const std::string& getName() const { return m_name; }
+	inline const std::string& getName() const { return getData().name; }
 #else
 	// FIXME: Make sure these aren't needed in final builds
 	inline bool load(const xml::XmlNode*, const DataTags&, const Tags&, code::ErrorStatus*) { return false; }
@@ -85,18 +89,33 @@ private:
 	typedef std::vector<Tags> TagGroup;
 	typedef std::vector<str::Strings> TagStrGroup;
 	
-	TagGroup m_mustHaves;
-	TagGroup m_mustNotHaves;
-	Tag      m_nameTag;
-	
+	struct Data
+	{
+		Data();
+		
+		TagGroup mustHaves;
+		TagGroup mustNotHaves;
+		Tag      nameTag;
+		
 #if !defined(TT_BUILD_FINAL)
-	std::string    m_name;
-	str::StringSet m_allUsedNames;
-
-	// string versions of tags needed and used only for conversion
-	TagStrGroup m_mustHavesStr;
-	TagStrGroup m_mustNotHavesStr;
+		std::string    name;
+		str::StringSet allUsedNames;
+		
+		// string versions of tags needed and used only for conversion
+		TagStrGroup mustHavesStr;
+		TagStrGroup mustNotHavesStr;
 #endif
+	};
+	typedef tt_ptr<Data>::shared DataPtr;
+	
+	inline const Data& getData() const { return (m_data != 0) ? *m_data : ms_emptyData; }
+	
+	/*! \brief Returns the data to modify; copies it first if it is shared with other DataTags. */
+	Data& modifyData();
+	
+	DataPtr m_data; // Null when empty
+	
+	static const Data ms_emptyData;
 };
 
 
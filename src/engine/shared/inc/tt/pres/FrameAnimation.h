@@ -27,6 +27,9 @@ enum LightMaskType
 };
 
 
+/*! \brief A frame animation of a presentation.
+    The data loaded from file is a definition that is shared between all clones, so cloning a
+    presentation object only copies the (small) state of its playing animations. */
 class FrameAnimation : public anim2d::Animation2D
 {
 public:
@@ -86,10 +89,10 @@ public:
 	using Animation2D::save; // prevent hiding
 	using Animation2D::load; // prevent hiding
 	
-	inline const std::string& getSpriteDirectory() const { return m_spriteDirectory; }
-	inline const std::string& getRenderPass()      const { return m_passName; }
+	inline const std::string& getSpriteDirectory() const { return getDefinition().spriteDirectory; }
+	inline const std::string& getRenderPass()      const { return getDefinition().passName; }
 
-	inline void setRenderPass     (const std::string& p_passName)        { m_passName = p_passName; }
+	inline void setRenderPass     (const std::string& p_passName)        { modifyDefinition().passName = p_passName; }
 	
 	/*! \brief Returns the size of the buffer needed to load or save this stack.
 	    \return The size of the buffer.*/
@@ -103,8 +106,8 @@ public:
 	/*! \brief Clears this stack and makes it a default one.*/
 	void makeDefault();
 	
-	inline void setLightMaskType(LightMaskType p_type) { m_lightMaskType = p_type; }
-	inline LightMaskType getLightMaskType() const { return m_lightMaskType; }
+	inline void setLightMaskType(LightMaskType p_type) { modifyDefinition().lightMaskType = p_type; }
+	inline LightMaskType getLightMaskType() const { return getDefinition().lightMaskType; }
 	
 	static void enableHudScale(bool p_enable) { ms_doHudScale = p_enable; }
 	
@@ -115,13 +118,11 @@ private:
 	void updateTextureAndQuadWithPresentationValues();
 	
 	inline math::Vector2 getFrameSize() const { return m_frameSize; }
-	inline math::Vector2 getQuadSize()  const { return math::Vector2(m_quadSizeX,  m_quadSizeY);  }
-	inline s32 getBeginFrame()          const { return static_cast<s32>(m_beginFrame.get());      }
-	inline s32 getEndFrame()            const { return static_cast<s32>(m_endFrame.get());        }
-	inline s32 getFrameDifference()     const { return m_frameDifference;                         }
+	inline math::Vector2 getQuadSize()  const { return m_quadSize;  }
+	inline s32 getFrameDifference()     const { return m_frameDifference; }
 	
-	inline math::Vector3 getTranslation() const { return math::Vector3(m_translationX, m_translationY, m_translationZ); }
-	inline math::Vector2 getScale()       const { return math::Vector2(m_scaleX, m_scaleY); }
+	inline math::Vector3 getTranslation() const { return m_translation; }
+	inline math::Vector2 getScale()       const { return m_scale; }
 	inline real          getRotation()    const { return math::degToRad(m_rotation); }
 	
 	enum Flip // flip mask
@@ -139,61 +140,84 @@ private:
 	};
 	typedef tt::code::BitMask<Flag, Flag_Count> Flags;
 	
-	PresentationValue m_beginFrame;
-	PresentationValue m_endFrame;
+	// The data loaded from file
+	struct Definition
+	{
+		Definition();
+		
+		PresentationValue beginFrame;
+		PresentationValue endFrame;
+		s32               totalFrames;
+		PresentationValue frameSizeX;
+		PresentationValue frameSizeY;
+		PresentationValue quadSizeX;
+		PresentationValue quadSizeY;
+		PresentationValue fps;
+		bool              holdFirstFrame;
+		bool              holdLastFrame;
+		u32               flip;
+		engine::renderer::FilterMode minFilter;
+		engine::renderer::FilterMode magFilter;
+		engine::renderer::FilterMode mipFilter;
+		engine::renderer::BlendMode  blendMode;
+		Flags                        flags;
+		
+		// FIXME: Use enum instead of string
+		std::string passName;
+		
+		engine::EngineID spritestripID;
+		engine::EngineID lightmaskID;
+		
+		std::string spriteDirectory;
+		bool        usingDirectory;
+		
+		PresentationValue translationX;
+		PresentationValue translationY;
+		PresentationValue translationZ;
+		PresentationValue scaleX;
+		PresentationValue scaleY;
+		bool              isUniformScale;
+		PresentationValue rotation;
+		PresentationValue texAnimU;
+		PresentationValue texAnimV;
+		
+		bool loaded;
+		
+		bool              usingDuration;
+		PresentationValue frameDuration;
+		
+		math::Vector2 cameraSpaceScale;
+		LightMaskType lightMaskType;
+	};
+	typedef tt_ptr<Definition>::shared DefinitionPtr;
+	
+	inline const Definition& getDefinition() const { return *m_definition; }
+	
+	/*! \brief Returns the definition to modify; copies it first if it is shared with other clones. */
+	Definition& modifyDefinition();
+	
+	DefinitionPtr m_definition;
+	
+	// The state of this animation (set when it starts)
 	s32               m_frameDifference;
 	s32               m_frameBegin;
-	s32               m_totalFrames;
 	math::Point2      m_frameCount;
 	math::Vector2     m_frameSize;
-	PresentationValue m_frameSizeX;
-	PresentationValue m_frameSizeY;
-	PresentationValue m_quadSizeX;
-	PresentationValue m_quadSizeY;
-	PresentationValue m_fps;
-	bool              m_holdFirstFrame;
-	bool              m_holdLastFrame;
-	u32               m_flip;
-	engine::renderer::FilterMode m_minFilter;
-	engine::renderer::FilterMode m_magFilter;
-	engine::renderer::FilterMode m_mipFilter;
-	engine::renderer::BlendMode  m_blendMode;
-	Flags                        m_flags;
-	
-	// FIXME: Use enum instead of string
-	std::string m_passName;
-	
-	engine::EngineID m_spritestripID;
-	engine::EngineID m_lightmaskID;
-	
-	std::string                  m_spriteDirectory;
-	bool                         m_usingDirectory;
+	math::Vector2     m_quadSize;
+	math::Vector3     m_translation;
+	math::Vector2     m_scale;
+	real              m_rotation;
+	
 	engine::renderer::TexturePtr m_texture;
 	bool                         m_isTextureForVisualBoy;
 	engine::renderer::TexturePtr m_lightmask;
 	PresentationQuadPtr          m_quad;
 	
-	PresentationValue m_translationX;
-	PresentationValue m_translationY;
-	PresentationValue m_translationZ;
-	PresentationValue m_scaleX;
-	PresentationValue m_scaleY;
-	bool              m_isUniformScale;
-	PresentationValue m_rotation;
-	PresentationValue m_texAnimU;
-	PresentationValue m_texAnimV;
-	
-	bool m_loaded;
-	
-	bool              m_usingDuration;
-	PresentationValue m_frameDuration;
 	real              m_durationTimeLeft;
 
 	math::Vector2     m_animationUV;
 	math::Vector2     m_offsetUV;
 	math::Vector2     m_cameraSpaceScale;
-
-	LightMaskType     m_lightMaskType;
 	
 	static bool       ms_doHudScale;
 	
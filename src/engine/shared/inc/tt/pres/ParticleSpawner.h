@@ -16,6 +16,8 @@ namespace tt {
 namespace pres {
 
 
+/*! \brief Spawns a particle effect when triggered by a presentation.
+    The data loaded from file is a definition that is shared between all clones. */
 class ParticleSpawner : public TriggerBase, public engine::particles::WorldObject
 {
 public:
@@ -92,7 +94,8 @@ private:
 	                const PresentationValue&     p_positionOffsetZ,
 	                const PresentationValue&     p_scale,
 	                const PresentationObjectPtr& p_followObject,
-	                u32 p_particleCategory, s32 p_renderGroup, const std::string& p_renderGroupName);
+	                u32 p_particleCategory, s32 p_renderGroup, const std::string& p_renderGroupName,
+	                bool p_useObjectFlip);
 	ParticleSpawner(const ParticleSpawner& p_rhs);
 	
 	// Disable assignment
@@ -107,30 +110,49 @@ private:
 	friend class ParticlesStack;
 	void setFollowObject(const PresentationObjectPtr& p_followObject);
 	
-	inline math::Vector3 getPositionOffset() const
+	inline math::Vector3 getPositionOffset() const { return m_positionOffset; }
+	
+	// The data loaded from file
+	struct Definition
 	{
-		return math::Vector3(m_positionOffsetX, m_positionOffsetY, m_positionOffsetZ);
-	}
+		Definition(const TriggerInfo&       p_triggerInfo,
+		           const std::string&       p_triggerFile,
+		           PositionType             p_positionType,
+		           const PresentationValue& p_positionOffsetX,
+		           const PresentationValue& p_positionOffsetY,
+		           const PresentationValue& p_positionOffsetZ,
+		           const PresentationValue& p_scale,
+		           u32                      p_particleCategory,
+		           const std::string&       p_renderGroupName,
+		           bool                     p_useObjectFlip);
+		
+		std::string       triggerFile;
+		
+		PresentationValue positionOffsetX;
+		PresentationValue positionOffsetY;
+		PresentationValue positionOffsetZ;
+		PositionType      positionType;
+		PresentationValue scale;
+		
+		u32               particleCategory;
+		std::string       renderGroupName;
+		TriggerInfo       triggerInfo;
+		bool              useObjectFlip; // Should this particle flip if the parent object flips. (Can also been seen as a enable flip flag.)
+	};
+	typedef tt_ptr<const Definition>::shared DefinitionPtr;
 	
 	//FIXME: Uncomment this when particles have implemented weakPtrs instead of RawPtrs
 	//ParticleSpawnerWeakPtr              m_this;
 	
-	std::string                          m_triggerFile;
-	
-	PresentationValue                    m_positionOffsetX;
-	PresentationValue                    m_positionOffsetY;
-	PresentationValue                    m_positionOffsetZ;
-	PositionType                         m_positionType;
-	PresentationValue                    m_scale;
+	DefinitionPtr                        m_definition;
 	
+	// The state of this spawner (the offset and scale are picked when it starts)
+	math::Vector3                        m_positionOffset;
+	real                                 m_scale;
 	engine::particles::ParticleEffectPtr m_particleEffect;
-	u32                                  m_particleCategory;
 	s32                                  m_renderGroup;
-	std::string                          m_renderGroupName;
 	PresentationObjectWeakPtr            m_followObject;
-	TriggerInfo                          m_triggerInfo;
 	u32                                  m_flipMask;
-	bool                                 m_useObjectFlip; // Should this particle flip if the parent object flips. (Can also been seen as a enable flip flag.)
 	
 	static std::string ms_trySubDir; // Try finding particle file in this subdir and load it using that if possbile.
 	                                 // Used for low, medium and high devices performance modes.
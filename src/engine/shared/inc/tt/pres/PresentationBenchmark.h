@@ -0,0 +1,35 @@
+#if !defined(INC_TT_PRES_PRESENTATIONBENCHMARK_H)
+#define INC_TT_PRES_PRESENTATIONBENCHMARK_H
+
+#include <tt/args/CmdLine.h>
+#include <tt/pres/fwd.h>
+
+
+namespace tt {
+namespace pres {
+
+/*! \brief Measures how long it takes to spawn and release many instances of the same presentation.
+    Started with --benchmark_presentation_spawn [folder] (default 'presentation/').
+    Every presentation file in the folder and its subfolders is loaded into the PresentationCache once.
+    It is then spawned --benchmark_instances times (default 1000) and all instances are released again,
+    --benchmark_iterations times (default 10).
+    The times are written as JSON to --benchmark_output (default benchmark_presentation_spawn.json).
+    \note Needs the trigger factory of the game to load presentations that contain triggers. */
+class PresentationBenchmark
+{
+public:
+	/*! \return false if no presentations were found or the report could not be written. */
+	static bool run(const tt::args::CmdLine& p_cmdLine, const TriggerFactoryInterfacePtr& p_triggerFactory);
+	
+private:
+	PresentationBenchmark();                                              // Static class
+	PresentationBenchmark(const PresentationBenchmark&);                  // Disable copy
+	const PresentationBenchmark& operator=(const PresentationBenchmark&); // Disable assigment.
+};
+
+
+// Namespace end
+}
+}
+
+#endif // !defined(INC_TT_PRES_PRESENTATIONBENCHMARK_H)
@@ -37,7 +37,7 @@ public:
 	    \param p_objectTags The tags that are used and need to be checked
 	    \param p_file Name of the file where it went wrong for the assert message
 	    \return converted cues */ 
-	static void checkRequiredTags(const Tags &p_requiredTags, Tags p_objectTags, 
+	static void checkRequiredTags(const Tags &p_requiredTags, const Tags& p_objectTags, 
 	                              const std::string& p_file);
 	
 	static GroupFactoryInterfacePtr getDefaultGroupFactory();
@@ -61,6 +61,10 @@ public:
 	/*! \brief Sets the value from a random value in the range*/
 	void updateValue(const PresentationObject* p_presObj);
 	
+	/*! \brief Returns the value updateValue would set, without changing this PresentationValue.
+	           Lets a value that is shared between presentation objects be updated per object. */
+	real getUpdatedValue(const PresentationObject* p_presObj) const;
+	
 	/*! \brief Gets the current value */
 	real get() const;
 	
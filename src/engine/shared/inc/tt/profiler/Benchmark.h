@@ -0,0 +1,72 @@
+#if !defined(INC_TT_PROFILER_BENCHMARK_H)
+#define INC_TT_PROFILER_BENCHMARK_H
+
+#include <string>
+
+#include <json/json.h>
+
+#include <tt/args/CmdLine.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace tt {
+namespace profiler {
+
+/*! \brief The parts all headless benchmarks (started with a --benchmark_* option) share: reading their
+           command line options, collecting timings and writing the JSON report.
+    Every benchmark writes its report to --benchmark_output, or to a default file named after it. */
+class Benchmark
+{
+public:
+	/*! \brief Total, minimum and maximum of a number of timings, in microseconds. */
+	struct Stats
+	{
+		Stats();
+		
+		void add(u64 p_time);
+		
+		inline double getAverageMs() const { return (count > 0) ? toMilliSeconds(total) / count : 0.0; }
+		
+		/*! \return A node with avgMs, minMs and maxMs. */
+		Json::Value toJson() const;
+		
+		u64 total;
+		u64 min;
+		u64 max;
+		s32 count; // Number of timings added
+	};
+	
+	/*! \return The folder passed to p_option, ending with a '/', or p_default if none was passed. */
+	static std::string getFolder(const args::CmdLine& p_cmdLine, const std::string& p_option,
+	                             const std::string& p_default);
+	
+	/*! \return The count passed to p_option (at least 1), or p_default if the option wasn't passed. */
+	static s32 getCount(const args::CmdLine& p_cmdLine, const std::string& p_option, s32 p_default);
+	
+	/*! \return The path passed to --benchmark_output, or p_default if the option wasn't passed. */
+	static std::string getOutputPath(const args::CmdLine& p_cmdLine, const std::string& p_default);
+	
+	/*! \return The time since startup in microseconds. */
+	static u64 getMicroSeconds();
+	
+	static inline double toMilliSeconds(u64 p_microSeconds)
+	{
+		return static_cast<double>(p_microSeconds) / 1000.0;
+	}
+	
+	/*! \brief Writes p_report as JSON to p_path.
+	    \param p_name Name of the benchmark, used in the log and error messages. */
+	static bool writeReport(const char* p_name, const Json::Value& p_report, const std::string& p_path);
+	
+private:
+	Benchmark();                                  // Static class
+	Benchmark(const Benchmark&);                  // Disable copy
+	const Benchmark& operator=(const Benchmark&); // Disable assigment.
+};
+
+
+// Namespace end
+}
+}
+
+#endif // !defined(INC_TT_PROFILER_BENCHMARK_H)
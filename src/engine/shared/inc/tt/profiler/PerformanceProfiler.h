@@ -4,6 +4,7 @@
 #include <tt/platform/tt_types.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/profiler/PerformanceProfilerConstants.h>
+#include <tt/profiler/TraceRecorder.h>
 #include <tt/system/Time.h>
 #include <tt/str/toStr.h>
 
@@ -27,7 +28,23 @@ struct ProfileInfo
 };
 
 typedef std::vector<ProfileInfo> ProfileCollection;
-typedef std::map<std::string, ProfileCollection> MeasureCollection;
+
+/*! \brief Identifies a profiled scope. The strings are literals, so comparing pointers is enough;
+           the readable key is only built in outputProfileInfo. */
+struct ProfileCallSite
+{
+	const char* message;
+	const char* fileName;
+	int         line;
+	
+	inline bool operator<(const ProfileCallSite& p_rhs) const
+	{
+		if (message  != p_rhs.message)  return message  < p_rhs.message;
+		if (fileName != p_rhs.fileName) return fileName < p_rhs.fileName;
+		return line < p_rhs.line;
+	}
+};
+typedef std::map<ProfileCallSite, ProfileCollection> MeasureCollection;
 
 /*! \brief Simple helper class for timing durations. */
 class PerformanceProfiler
@@ -59,6 +76,8 @@ public:
 		++m_indent;
 		TT_ASSERT(m_indent < (m_maxProfilerDepth - 1));
 		
+		TraceRecorder::begin(m_message);
+		
 		m_startTime = tt::system::Time::getInstance()->getMicroSeconds();
 	}
 
@@ -71,6 +90,8 @@ public:
 		
 		u64 endTime = tt::system::Time::getInstance()->getMicroSeconds();
 		u64 elapsedTime = (endTime - m_startTime);
+		
+		TraceRecorder::end(m_message);
 
 		ProfileInfo info;
 		info.elapsedTime = elapsedTime;
@@ -83,29 +104,8 @@ public:
 		info.indent = m_indent;
 		info.frameIdx = m_frameIdx;
 
-		// make sure the filename isn't too long
-		std::string file(m_fileName);
-		if (file.length() > 50)
-		{
-			file = "..." + file.substr(file.length()-50);
-		}
-		
-		// check if this key exists
-		std::string key(m_message);
-		key += " " + file;
-		key += "(" + tt::str::toStr(m_line) + ")";
-		
-		MeasureCollection::iterator it = m_measures.find(key);
-		if (it == m_measures.end())
-		{
-			ProfileCollection profileCollection;
-			profileCollection.push_back(info);
-			m_measures.insert(std::make_pair<std::string, ProfileCollection>(key, profileCollection));
-		}
-		else
-		{
-			(*it).second.push_back(info);
-		}
+		const ProfileCallSite callSite = { m_message, m_fileName, m_line };
+		m_measures[callSite].push_back(info);
 		
 		/*
 		if (elapsedTime >= m_threshold)
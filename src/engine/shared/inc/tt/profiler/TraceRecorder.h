@@ -0,0 +1,139 @@
+#if !defined(INC_TT_PROFILER_TRACERECORDER_H)
+#define INC_TT_PROFILER_TRACERECORDER_H
+
+#include <atomic>
+#include <string>
+
+#include <tt/fs/types.h>
+#include <tt/platform/tt_types.h>
+
+
+#if !defined(TT_BUILD_FINAL)
+#define TT_USE_TRACE_RECORDER 1
+#else
+#define TT_USE_TRACE_RECORDER 0 // Turn off (0) for final builds.
+#endif
+
+
+namespace tt {
+namespace profiler {
+
+/*! \brief Low-overhead begin/end event recorder for all threads.
+    Every thread records into its own ring buffer (no locks on the recording path), so the
+    recorder always holds the last Constants_EventsPerThread events of each thread.
+    Event names are not copied: pass string literals or names returned by intern().
+    dumpChromeTrace() writes the recorded events in the Chrome trace event format, which can be
+    opened with chrome://tracing or the Perfetto UI. */
+class TraceRecorder
+{
+public:
+	enum
+	{
+		Constants_EventsPerThread = 16384,
+		Constants_MaxThreads      = 32
+	};
+
+	/*! \brief Returns a copy of p_name that stays valid for the lifetime of the application.
+	           Interning the same name twice returns the same pointer. */
+	static const char* intern(const std::string& p_name);
+
+	/*! \brief Names the calling thread in the trace. Threads without a name show up as 'Thread N'. */
+	static void setThreadName(const char* p_name);
+
+	static inline void begin(const char* p_name)
+	{
+#if TT_USE_TRACE_RECORDER != 0
+		if (ms_enabled.load(std::memory_order_relaxed))
+		{
+			record(p_name, true);
+		}
+#else
+		(void)p_name;
+#endif
+	}
+
+	static inline void end(const char* p_name)
+	{
+#if TT_USE_TRACE_RECORDER != 0
+		if (ms_enabled.load(std::memory_order_relaxed))
+		{
+			record(p_name, false);
+		}
+#else
+		(void)p_name;
+#endif
+	}
+
+	/*! \brief Recording is on by default in non-final builds. */
+	static inline void setEnabled(bool p_enabled)
+	{
+#if TT_USE_TRACE_RECORDER != 0
+		ms_enabled = p_enabled;
+#else
+		(void)p_enabled;
+#endif
+	}
+
+	static inline bool isEnabled()
+	{
+#if TT_USE_TRACE_RECORDER != 0
+		return ms_enabled;
+#else
+		return false;
+#endif
+	}
+
+	/*! \brief Writes the events of all threads to p_file as Chrome trace JSON.
+	           Threads keep recording while the dump is written. */
+	static bool dumpChromeTrace(const tt::fs::FilePtr& p_file);
+
+private:
+#if TT_USE_TRACE_RECORDER != 0
+	static void record(const char* p_name, bool p_begin);
+
+	static std::atomic<bool> ms_enabled;
+#endif
+};
+
+
+/*! \brief Records a begin event on construction and the matching end event on destruction. */
+class TraceScope
+{
+public:
+	inline explicit TraceScope(const char* p_name)
+	:
+	m_name(p_name)
+	{
+		TraceRecorder::begin(m_name);
+	}
+
+	inline ~TraceScope()
+	{
+		TraceRecorder::end(m_name);
+	}
+
+private:
+	const char* m_name;
+
+	TraceScope(const TraceScope&);                  // Disable copy
+	const TraceScope& operator=(const TraceScope&); // Disable assigment.
+};
+
+
+#define TT_TRACE_SCOPE_CONCAT_IMPL(a, b) a##b
+#define TT_TRACE_SCOPE_CONCAT(a, b)      TT_TRACE_SCOPE_CONCAT_IMPL(a, b)
+
+#if TT_USE_TRACE_RECORDER != 0
+	#define TT_TRACE_SCOPE(p_name) \
+		tt::profiler::TraceScope TT_TRACE_SCOPE_CONCAT(traceScope, __LINE__)(p_name)
+#else
+	#define TT_TRACE_SCOPE(...)
+#endif
+
+
+// Namespace end
+}
+}
+
+
+#endif // !defined(INC_TT_PROFILER_TRACERECORDER_H)
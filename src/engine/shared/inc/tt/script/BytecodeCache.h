@@ -0,0 +1,69 @@
+#if !defined(INC_TT_SCRIPT_BYTECODECACHE_H)
+#define INC_TT_SCRIPT_BYTECODECACHE_H
+
+#include <string>
+
+#include <squirrel/squirrel.h>
+
+#include <tt/fs/types.h>
+#include <tt/platform/tt_types.h>
+#include <tt/script/fwd.h>
+
+
+namespace tt {
+namespace script {
+
+/*! \brief Cache of compiled scripts, addressed by the hash of their source.
+    An entry is keyed on the script name, its source text and the Squirrel version and type sizes,
+    so an edited script or a different VM simply misses and is compiled again. Entries are
+    validated (key, size and checksum) before they are handed to sq_readclosure.
+    Entries of edited scripts are never loaded again, so the cache is kept within a maximum number
+    of entries and bytes; the oldest entries are removed when the cache is created. */
+class BytecodeCache
+{
+public:
+	/*! \param p_directory Directory for the entries (created if needed), ending in a separator.
+	    \param p_fsID      File system to store the entries on.
+	    \return Null if the file system can't hold the cache. */
+	static BytecodeCachePtr create(const std::string& p_directory, fs::identifier p_fsID = 0);
+	
+	/*! \brief Key of a script, used for load() and store(). */
+	static u64 getKey(const std::string& p_name, const void* p_source, fs::size_type p_sourceSize);
+	
+	/*! \brief Pushes the cached closure for the key onto the stack.
+	    \return false (and nothing is pushed) if there is no valid entry. */
+	bool load(HSQUIRRELVM p_vm, u64 p_key);
+	
+	/*! \brief Saves the closure on top of the stack under the key. */
+	bool store(HSQUIRRELVM p_vm, u64 p_key);
+	
+	inline s32 getHitCount()  const { return m_hitCount;  }
+	inline s32 getMissCount() const { return m_missCount; }
+	
+private:
+	BytecodeCache(const std::string& p_directory, fs::identifier p_fsID);
+	
+	std::string getEntryPath(u64 p_key) const;
+	
+	/*! \brief Removes the oldest entries until the cache is within its entry count and size limits.
+	    \return The number of removed entries. */
+	s32 removeOldestEntries();
+	
+	// No copying
+	BytecodeCache(const BytecodeCache&);
+	BytecodeCache& operator=(const BytecodeCache&);
+	
+	
+	const std::string    m_directory;
+	const fs::identifier m_fsID;
+	bool                 m_writable;
+	s32                  m_hitCount;
+	s32                  m_missCount;
+};
+
+// Namespace end
+}
+}
+
+
+#endif  // !defined(INC_TT_SCRIPT_BYTECODECACHE_H)
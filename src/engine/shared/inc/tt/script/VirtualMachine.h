@@ -36,6 +36,10 @@ public:
 	void setCompileMode(VMCompileMode p_mode) { m_compileMode = p_mode; }
 	VMCompileMode getCompileMode() const { return m_compileMode; }
 	
+	/*! \brief Use a cache of compiled scripts when loading .nut files (not used in VMCompileMode_NutToBnut). */
+	inline void setBytecodeCache(const BytecodeCachePtr& p_cache) { m_bytecodeCache = p_cache; }
+	inline const BytecodeCachePtr& getBytecodeCache() const { return m_bytecodeCache; }
+	
 	/*! \brief Disable caching forcing recompile and run each time. Some older projects need this. */
 	void disableCaching_HACK() { m_disableCaching = true; }
 	
@@ -291,10 +295,38 @@ public:
 	                     const P6Type& p_p6,
 	                     const P7Type& p_p7);
 	
+	//----------------------------------------------------------------------------------------------
+	// Calling Squirrel closures that were looked up before (p_functionName is only used for warnings)
+	// 0 Parameters
+	bool callSqClosure(const char* p_functionName, const HSQOBJECT& p_closure, const HSQOBJECT& p_obj);
+	
+	template <typename RetType>
+	inline bool callSqClosureWithReturn(RetType* p_return_OUT,
+	                                    const char* p_functionName,
+	                                    const HSQOBJECT& p_closure,
+	                                    const HSQOBJECT& p_obj);
+	
+	// 1 Parameters
+	template <typename P1Type>
+	bool callSqClosure(const char* p_functionName,
+	                   const HSQOBJECT& p_closure,
+	                   const HSQOBJECT& p_obj,
+	                   const P1Type& p_p1);
+	
+	template <typename RetType,
+	          typename P1Type>
+	inline bool callSqClosureWithReturn(RetType* p_return_OUT,
+	                                    const char* p_functionName,
+	                                    const HSQOBJECT& p_closure,
+	                                    const HSQOBJECT& p_obj,
+	                                    const P1Type& p_p1);
+	
 	bool callFunction(const std::string& p_functionName, s32 p_nparams);
 	bool callFunctionWithReturn(const std::string& p_functionName, s32 p_nparams);
 	bool prepareFunctionOnStack(const std::string& p_functionName);
 	bool prepareMethodOnStack(const std::string& p_methodName, const HSQOBJECT& p_class, const HSQOBJECT& p_object);
+	bool prepareClosureOnStack(const HSQOBJECT& p_closure, const HSQOBJECT& p_object);
+	bool callClosure(const char* p_functionName, s32 p_nparams, bool p_retval);
 	
 private:
 	class CharBuffer;
@@ -342,6 +374,7 @@ private:
 	
 	bool loadAndRunScriptImpl(const std::string& p_filename, bool p_useRootPath);
 	bool loadOrCompileScript(const std::string& p_filename, bool p_useRootPath);
+	bool loadCachedOrCompileScript(const std::string& p_nutFilename, const std::string& p_name);
 	bool callSQ(const std::string& p_source);
 	
 	static void printFunc(HSQUIRRELVM /*p_vm*/, const SQChar* p_format, ...);
@@ -376,6 +409,7 @@ private:
 	ScriptObjects m_cachedIncludes;
 	VMCompileMode m_compileMode;
 	bool          m_disableCaching; // Disable script caching for older projects were we get script problem if we caching. (A function will not get overriden.)
+	BytecodeCachePtr m_bytecodeCache;
 	
 #if defined(TT_PLATFORM_WIN)
 	HSQREMOTEDBG m_rdbg;
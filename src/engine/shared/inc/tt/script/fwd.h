@@ -6,6 +6,9 @@
 namespace tt {
 namespace script {
 
+class BytecodeCache;
+typedef tt_ptr<BytecodeCache>::shared BytecodeCachePtr;
+
 class ScriptEngine;
 class ScriptObject;
 class ScriptValue;
@@ -14,7 +14,10 @@
 #include <AL/efx.h>
 #endif
 
-#include <list>
+#include <atomic>
+#include <string>
+#include <vector>
+
 #include <tt/math/Vector3.h>
 #include <tt/snd/SoundSystem.h>
 #include <tt/snd/types.h>
@@ -116,10 +119,16 @@ public:
 	virtual const math::Vector3& getListenerPosition() const;
 	virtual bool setPositionalAudioModel(const VoicePtr& p_voice, const audio::xact::RPCCurve* p_curve);
 	
+#if !defined(TT_BUILD_FINAL)
+	virtual std::string getDebugStreamInfo() const;
+#endif
+	
 private:
 	struct VoiceData;
 	struct BufferData;
 	struct StreamData;
+	struct DecodeEntry;
+	struct DecodeCommand;
 #if defined(OPENAL_RESOURCE_LEAK)
 	struct OpenALSource;
 #endif
@@ -230,17 +239,49 @@ private:
 	////////////////////////////////////
 	// Stream update/decoding thread
 	
+	/*! \brief Underruns and decode time of a stream, as gathered by the decode thread. */
+	struct StreamStats
+	{
+		inline StreamStats()
+		:
+		id(0),
+		bufferLengthInMs(0),
+		underrunCount(0),
+		decodeCount(0),
+		decodeTimeInUs(0),
+		maxDecodeTimeInUs(0)
+		{ }
+		
+		u32 id;                // Streams are numbered in the order they were opened
+		u32 bufferLengthInMs;  // Of all buffers of the stream together
+		u32 underrunCount;     // Times OpenAL ran out of queued buffers before the stream was done
+		u32 decodeCount;       // Updates that refilled at least one buffer
+		u64 decodeTimeInUs;    // Total time of those updates
+		u64 maxDecodeTimeInUs;
+	};
+	typedef std::vector<StreamStats> StreamStatsCollection;
+	
+	typedef std::vector<DecodeEntry*> DecodeEntries;
+	
 	static int staticDecodeStreamsThread(void* p_soundSystem);
 	void decodeStreams();
 	
-	typedef std::list<Stream*> StreamList;
-	tt::thread::handle        m_decodeThread;
-	bool                      m_decodeThreadShouldExit;
-	StreamList                m_streamsToAdd;
-	StreamList                m_activeStreams;
-	Stream*                   m_streamToRemove;
-	thread::Mutex             m_decodeMutex;
-	thread::OptionalSemaphore m_decodeSemaphore;
+	/*! \brief Hands a command to the decode thread without locking (can be called from any thread). */
+	void pushDecodeCommand(DecodeCommand* p_command);
+	/*! \brief Applies the commands pushed since the last call. Decode thread only. */
+	void processDecodeCommands(u64 p_now);
+	void publishStreamStats();
+	
+	tt::thread::handle           m_decodeThread;
+	std::atomic<bool>            m_decodeThreadShouldExit;
+	std::atomic<DecodeCommand*>  m_decodeCommands;  // Stack of pending commands, newest first
+	DecodeEntries                m_activeStreams;   // Decode thread only. Sorted on underrun deadline.
+	u32                          m_nextStreamID;
+	thread::OptionalSemaphore    m_decodeSemaphore; // Wakes the decode thread before its next deadline
+	
+	mutable thread::Mutex        m_streamStatsMutex;
+	StreamStatsCollection        m_streamStats;     // Copy of the stats of the active streams
+	StreamStats                  m_closedStreamStats; // Totals of the streams that were closed
 };
 
 // Namespace end
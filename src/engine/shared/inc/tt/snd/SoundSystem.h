@@ -2,6 +2,8 @@
 #define INC_TT_SND_SOUNDSYSTEM_H
 
 
+#include <string>
+
 #include <tt/math/fwd.h>
 #include <tt/snd/types.h>
 
@@ -399,6 +401,11 @@ public:
 	virtual void renderProfileInfo() {};
 	virtual void resetMaxProfile  () {};
 	
+#if !defined(TT_BUILD_FINAL)
+	/*! \brief Returns a description of the open streams (underruns, decode times) for on-screen debugging. */
+	virtual std::string getDebugStreamInfo() const { return std::string(); }
+#endif
+	
 	
 private:
 	SoundSystem(const SoundSystem& p_rhs);
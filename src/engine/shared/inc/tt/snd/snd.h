@@ -2,6 +2,8 @@
 #define INC_TT_SND_SND_H
 
 
+#include <string>
+
 #include <tt/math/fwd.h>
 #include <tt/snd/types.h>
 
@@ -416,6 +418,11 @@ math::Vector3 getListenerPosition(identifier p_identifier = 0);
     \return Whether the operation succeeded.*/
 bool setPositionalAudioModel(const VoicePtr& p_voice, const audio::xact::RPCCurve* p_curve);
 
+#if !defined(TT_BUILD_FINAL)
+/*! \brief Gets the stream underrun counts and decode times of a soundsystem, for on-screen debugging. */
+std::string getDebugStreamInfo(identifier p_identifier = 0);
+#endif
+
 // Namespace end
 }
 }
@@ -0,0 +1,140 @@
+#if !defined(INC_TT_THREAD_JOBSYSTEM_H)
+#define INC_TT_THREAD_JOBSYSTEM_H
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <tt/platform/tt_types.h>
+
+
+namespace tt {
+namespace thread {
+
+/*! \brief Work-stealing job system.
+    Every worker thread owns a job queue; idle workers steal from the other queues.
+    Threads that wait for jobs (including the main thread) execute queued jobs while they wait,
+    so waiting from inside a job (nested parallelFor) doesn't deadlock.
+    When no worker threads were created all jobs simply run on the waiting thread. */
+class JobSystem
+{
+public:
+	typedef std::function<void()>               JobFunction;
+	typedef std::function<void(size_t, size_t)> RangeFunction; //!< Called with [begin, end) index ranges.
+
+	/*! \brief Tracks a number of outstanding jobs. Jobs decrease it when they are done. */
+	class Counter
+	{
+	public:
+		inline Counter() : m_value(0) { }
+		inline bool isDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+
+	private:
+		std::atomic<s32> m_value;
+
+		Counter(const Counter&);                  // Disable copy
+		const Counter& operator=(const Counter&); // Disable assigment.
+
+		friend class JobSystem;
+	};
+
+	/*! \brief A single job. The owner keeps it alive until its counter is done. */
+	struct Job
+	{
+		inline Job()
+		:
+		function(),
+		counter(0),
+		unfinishedDependencies(0),
+		dependents()
+		{ }
+
+		inline Job(const Job& p_rhs)
+		:
+		function(p_rhs.function),
+		counter(p_rhs.counter),
+		unfinishedDependencies(p_rhs.unfinishedDependencies.load()),
+		dependents(p_rhs.dependents)
+		{ }
+
+		JobFunction        function;
+		Counter*           counter;
+		std::atomic<s32>   unfinishedDependencies;
+		std::vector<Job*>  dependents;
+
+	private:
+		const Job& operator=(const Job&); // Disable assigment.
+	};
+
+	/*! \brief Creates the worker threads.
+	    \param p_workerCount Number of workers. Negative means one less than the number of cores,
+	                         because the thread waiting for the jobs also executes them. */
+	static void createThreads(s32 p_workerCount = -1);
+	static void destroyThreads();
+	static s32  getWorkerCount();
+
+	/*! \brief Adds the jobs to their counters and queues the ones without unfinished dependencies.
+	           The others are queued when the last job they depend on has finished. */
+	static void submit(Job* p_jobs, size_t p_count);
+
+	/*! \brief Executes queued jobs on the calling thread until p_counter is done.
+	           When there is nothing left to execute it sleeps until a job finishes or gets queued. */
+	static void waitFor(const Counter& p_counter);
+
+	/*! \brief Splits [0, p_count) in chunks of p_grainSize and processes them on all threads,
+	           including the calling thread. Returns when the whole range is done.
+	           Without worker threads the whole range is processed in a single call. */
+	static void parallelFor(size_t p_count, size_t p_grainSize, const RangeFunction& p_function);
+
+private:
+	static void runJob(Job* p_job);
+	static int  workerProc(void* p_queueIndex);
+
+	friend class JobGraph;
+};
+
+
+/*! \brief A set of jobs with dependencies between them, executed by the JobSystem.
+    Build the graph once (addJob/addDependency) and run() it as often as needed. */
+class JobGraph
+{
+public:
+	typedef s32 JobID;
+
+	JobGraph();
+
+	JobID addJob(const JobSystem::JobFunction& p_function);
+
+	/*! \brief p_job won't start before p_dependsOn has finished. */
+	void addDependency(JobID p_job, JobID p_dependsOn);
+
+	/*! \brief Runs all jobs (the calling thread participates) and returns when all are done. */
+	void run();
+
+	inline s32  getJobCount() const { return static_cast<s32>(m_jobs.size()); }
+	inline void clear()             { m_jobs.clear(); m_dependencies.clear(); }
+
+private:
+	typedef std::vector<JobSystem::Job> Jobs;
+
+	struct Dependency
+	{
+		JobID job;
+		JobID dependsOn;
+	};
+	typedef std::vector<Dependency> Dependencies;
+
+	Jobs         m_jobs;
+	Dependencies m_dependencies;
+
+	JobGraph(const JobGraph&);                  // Disable copy
+	const JobGraph& operator=(const JobGraph&); // Disable assigment.
+};
+
+
+// Namespace end
+}
+}
+
+
+#endif // INC_TT_THREAD_JOBSYSTEM_H
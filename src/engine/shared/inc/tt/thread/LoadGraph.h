@@ -0,0 +1,171 @@
+#if !defined(INC_TT_THREAD_LOADGRAPH_H)
+#define INC_TT_THREAD_LOADGRAPH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <tt/platform/tt_types.h>
+#include <tt/thread/ConditionVariable.h>
+#include <tt/thread/Mutex.h>
+#include <tt/thread/thread.h>
+
+
+namespace tt {
+namespace thread {
+
+/*! \brief Dependency graph of load tasks, run by a few dedicated load threads.
+    A task is a series of steps: its step function is called until it returns true. Between steps the
+    graph can be suspended or cancelled, and a task that became ready with a higher priority gets the
+    next free thread. Tasks that need the render thread (GL uploads) are run by processMainThreadTasks().
+    The graph records when every task ran, so printTimeline() can show where the load time went.
+    \note Load threads are not JobSystem workers: load steps can take seconds and would stall the
+          per-frame parallel work (and the main thread, which runs queued jobs while it waits). */
+class LoadGraph
+{
+public:
+	typedef s32 TaskID;
+	typedef std::vector<TaskID> TaskIDs;
+	
+	/*! \brief Performs one step of a task. \return true when the task is done. */
+	typedef std::function<bool()> StepFunction;
+	
+	/*! \brief Called on every load thread when it starts and before it exits. */
+	typedef std::function<void()> ThreadFunction;
+	
+	enum ThreadType
+	{
+		ThreadType_Load, //!< Runs on any of the load threads
+		ThreadType_Main  //!< Runs from processMainThreadTasks()
+	};
+	
+	struct Timing
+	{
+		inline Timing()
+		:
+		readyTime(0),
+		startTime(0),
+		endTime(0),
+		runTime(0),
+		stepCount(0),
+		thread(-1)
+		{ }
+		
+		u64 readyTime; //!< When all dependencies were done (microseconds since start())
+		u64 startTime; //!< When the first step started
+		u64 endTime;   //!< When the last step finished
+		u64 runTime;   //!< Time spent in steps (a task can wait for a thread between steps)
+		s32 stepCount;
+		s32 thread;    //!< Load thread that ran the last step; -1 for the main thread
+	};
+	
+	LoadGraph();
+	~LoadGraph();
+	
+	/*! \param p_priority Of the ready tasks, the one with the highest priority runs first. */
+	TaskID addTask(const std::string& p_name, const StepFunction& p_step, s32 p_priority = 0,
+	               ThreadType p_threadType = ThreadType_Load);
+	
+	/*! \brief p_task won't start before p_dependsOn is done. */
+	void addDependency(TaskID p_task, TaskID p_dependsOn);
+	
+	/*! \brief Starts the load threads. Tasks can't be added once the graph is started.
+	    \param p_threadCount Number of load threads. Negative picks one based on the number of cores;
+	                         with 0, processMainThreadTasks() runs all tasks. */
+	void start(s32 p_threadCount = -1,
+	           const ThreadFunction& p_onThreadStart = ThreadFunction(),
+	           const ThreadFunction& p_onThreadExit  = ThreadFunction());
+	
+	/*! \brief Lets the running steps finish, doesn't start new ones and waits for the load threads. */
+	void cancel();
+	
+	/*! \brief While suspended no new steps are started (running steps do finish). */
+	void setSuspended(bool p_suspended);
+	
+	/*! \brief Runs steps of ready main thread tasks. Call this from the render thread.
+	    \param p_budgetMs Stops starting new steps after this many milliseconds (at least one step runs). */
+	void processMainThreadTasks(u32 p_budgetMs);
+	
+	bool        isDone() const;
+	s32         getTaskCount() const { return static_cast<s32>(m_tasks.size()); }
+	s32         getDoneTaskCount() const;
+	std::string getRunningTaskName() const; //!< Name of the highest priority running task (empty if none)
+	
+	/*! \brief Timing of a task; only complete once isDone(). */
+	Timing getTiming(TaskID p_task) const;
+	
+	/*! \brief Chain of tasks that determined the total load time: starting at the task that finished
+	           last, every step back is the dependency that finished last. */
+	TaskIDs getCriticalPath() const;
+	
+	/*! \brief Prints every task's timing and the critical path. */
+	void printTimeline(const char* p_title) const;
+	
+private:
+	enum State
+	{
+		State_Waiting, // for dependencies
+		State_Ready,
+		State_Running,
+		State_Done
+	};
+	
+	struct Task
+	{
+		std::string  name;
+		StepFunction step;
+		s32          priority;
+		ThreadType   threadType;
+		State        state;
+		s32          unfinishedDependencies;
+		TaskIDs      dependencies;
+		TaskIDs      dependents;
+		Timing       timing;
+		u64          stepStartTime;
+	};
+	typedef std::vector<Task> Tasks;
+	
+	struct LoadThread
+	{
+		LoadGraph* graph;
+		s32        index;
+		handle     thread;
+	};
+	typedef std::vector<LoadThread> LoadThreads;
+	
+	// All private functions expect m_mutex to be locked
+	TaskID popReadyTask(ThreadType p_threadType);
+	void   makeReady(TaskID p_task);
+	void   finishStep(TaskID p_task, bool p_taskDone, s32 p_thread);
+	void   wakeLoadThreads();
+	u64    getTime() const;
+	
+	static int staticLoadThread(void* p_loadThread);
+	void       loadThread(s32 p_index);
+	
+	// No copying
+	LoadGraph(const LoadGraph&);
+	LoadGraph& operator=(const LoadGraph&);
+	
+	
+	Tasks             m_tasks;
+	TaskIDs           m_ready;
+	s32               m_doneCount;
+	bool              m_started;
+	bool              m_cancelled;
+	bool              m_suspended;
+	u64               m_startTime;
+	s32               m_threadCount;
+	LoadThreads       m_threads;
+	ThreadFunction    m_onThreadStart;
+	ThreadFunction    m_onThreadExit;
+	mutable Mutex     m_mutex;
+	ConditionVariable m_changed;
+};
+
+// Namespace end
+}
+}
+
+
+#endif  // !defined(INC_TT_THREAD_LOADGRAPH_H)
@@ -29,6 +29,10 @@ public:
 	    \returns The previous count if decreasing was allowed. */
 	bool tryWait();
 	
+	/*! \brief Like wait(), but blocks for at most the specified time.
+	    \returns True if the count was decreased, false if the time ran out. */
+	bool timedWait(u32 p_milliSeconds);
+	
 	/*! \brief Increases the count with one.
 	           If any threads are blocked while waiting one of them will be unblocked. */
 	void signal();
@@ -64,6 +68,7 @@ public:
 	
 	inline void wait()    { TT_NULL_ASSERT(m_semaphore);        m_semaphore->wait();    }
 	inline bool tryWait() { TT_NULL_ASSERT(m_semaphore); return m_semaphore->tryWait(); }
+	inline bool timedWait(u32 p_milliSeconds) { TT_NULL_ASSERT(m_semaphore); return m_semaphore->timedWait(p_milliSeconds); }
 	inline void signal()  { TT_NULL_ASSERT(m_semaphore);        m_semaphore->signal();  }
 	
 private:
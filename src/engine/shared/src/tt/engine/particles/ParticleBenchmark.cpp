@@ -0,0 +1,522 @@
+#include <algorithm>
+#include <limits>
+
+#include <json/json.h>
+
+#include <tt/code/helpers.h>
+#include <tt/engine/particles/ParticleBenchmark.h>
+#include <tt/engine/particles/ParticleEmitter.h>
+#include <tt/engine/particles/ParticleMgr.h>
+#include <tt/engine/particles/ParticleTrigger.h>
+#include <tt/engine/renderer/Texture.h>
+#include <tt/fs/utils/utils.h>
+#include <tt/math/math.h>
+#include <tt/math/Matrix44.h>
+#include <tt/math/Random.h>
+#include <tt/math/Rect.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+#include <tt/profiler/Benchmark.h>
+
+
+namespace tt {
+namespace engine {
+namespace particles {
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+bool ParticleBenchmark::run(const tt::args::CmdLine& p_cmdLine)
+{
+	using profiler::Benchmark;
+	
+	const std::string triggersPath(Benchmark::getFolder(p_cmdLine, "benchmark_particles", "particles/"));
+	const std::string outputPath(Benchmark::getOutputPath(p_cmdLine, "benchmark_particles.json"));
+	
+	const s32  warmupFrames = Benchmark::getCount(p_cmdLine, "benchmark_warmup",     60);
+	const s32  frames       = Benchmark::getCount(p_cmdLine, "benchmark_frames",     60);
+	const s32  iterations   = Benchmark::getCount(p_cmdLine, "benchmark_iterations", 10);
+	const real tolerance    = p_cmdLine.exists("benchmark_tolerance") ?
+		p_cmdLine.getReal("benchmark_tolerance") : 0.001f;
+	
+	const str::StringSet triggerNames(fs::utils::getFilesInDir(triggersPath, "*.trigger"));
+	if (triggerNames.empty())
+	{
+		TT_PANIC("No particle triggers found in '%s'.", triggersPath.c_str());
+		return false;
+	}
+	
+	static const real deltaTime = 1.0f / 60.0f;
+	ParticleMgr*  particleMgr = ParticleMgr::getInstance();
+	math::Random& random(math::Random::getEffects());
+	
+	Json::Value rootNode(Json::objectValue);
+	rootNode["folder"    ] = triggersPath;
+	rootNode["warmup"    ] = warmupFrames;
+	rootNode["frames"    ] = frames;
+	rootNode["iterations"] = iterations;
+	rootNode["tolerance" ] = tolerance;
+	Json::Value& emittersNode(rootNode["emitters"]);
+	emittersNode = Json::Value(Json::arrayValue);
+	
+	u64  totalReferenceTime = 0;
+	u64  totalTime          = 0;
+	bool allMatch           = true;
+	renderer::BatchQuadCollection referenceQuads;
+	
+	for (str::StringSet::const_iterator it = triggerNames.begin(); it != triggerNames.end(); ++it)
+	{
+		ParticleTrigger* trigger = particleMgr->addTrigger(triggersPath + *it + ".trigger");
+		if (trigger == 0)
+		{
+			allMatch = false;
+			continue;
+		}
+		
+		trigger->trigger(ParticleTrigger::TriggerType_Start);
+		for (s32 i = 0; i < warmupFrames; ++i)
+		{
+			trigger->update(deltaTime);
+		}
+		
+		for (s32 emitterIndex = 0; emitterIndex < trigger->getEmitterCount(); ++emitterIndex)
+		{
+			ParticleEmitter& emitter(*trigger->getEmitter(emitterIndex));
+			if (emitter.m_particles.empty())
+			{
+				continue;
+			}
+			
+			// Both implementations start from the same particles, animation state and random numbers
+			const ParticleData               startParticles(emitter.m_particles);
+			const ParticleAnimationContainer startAnimations(emitter.m_settings.animations);
+			const u64                        startSeed = random.getContextSeedValue();
+			ReferenceParticles startReferenceParticles;
+			startReferenceParticles.reserve(startParticles.size());
+			for (size_t i = 0; i < startParticles.size(); ++i)
+			{
+				startReferenceParticles.push_back(startParticles.get(i));
+			}
+			
+			ReferenceParticles referenceParticles;
+			u64 referenceTime = 0;
+			for (s32 iteration = 0; iteration < iterations; ++iteration)
+			{
+				referenceParticles = startReferenceParticles;
+				emitter.m_settings.animations = startAnimations;
+				random.setContextSeedValue(startSeed);
+				
+				const u64 startTime = Benchmark::getMicroSeconds();
+				for (s32 frame = 0; frame < frames; ++frame)
+				{
+					updateReference(emitter, referenceParticles, deltaTime);
+					createReferenceQuads(emitter, referenceParticles, referenceQuads);
+				}
+				referenceTime += Benchmark::getMicroSeconds() - startTime;
+			}
+			
+			u64 currentTime = 0;
+			for (s32 iteration = 0; iteration < iterations; ++iteration)
+			{
+				emitter.m_particles = startParticles;
+				emitter.m_settings.animations = startAnimations;
+				random.setContextSeedValue(startSeed);
+				
+				const u64 startTime = Benchmark::getMicroSeconds();
+				for (s32 frame = 0; frame < frames; ++frame)
+				{
+					emitter.updateParticles(deltaTime);
+					emitter.createQuadBatch();
+				}
+				currentTime += Benchmark::getMicroSeconds() - startTime;
+			}
+			
+			const size_t particleCount = emitter.m_particles.size();
+			const bool   sameCount     = particleCount == referenceParticles.size();
+			const QuadDifference difference(sameCount ?
+				compareQuads(referenceQuads, emitter.m_quadBatch, particleCount) : QuadDifference());
+			const bool matches = sameCount && difference.position <= tolerance &&
+			                     difference.texCoord <= tolerance && difference.color <= 1;
+			allMatch = allMatch && matches;
+			
+			// Leave the particles as they were; the particle manager counts on getting them back
+			emitter.m_particles = startParticles;
+			emitter.m_settings.animations = startAnimations;
+			
+			totalReferenceTime += referenceTime;
+			totalTime          += currentTime;
+			
+			Json::Value emitterNode(Json::objectValue);
+			emitterNode["trigger"          ] = *it;
+			emitterNode["emitter"          ] = emitterIndex;
+			emitterNode["particles"        ] = static_cast<Json::UInt>(startParticles.size());
+			emitterNode["particlesAtEnd"   ] = static_cast<Json::UInt>(particleCount);
+			emitterNode["referenceMs"      ] = Benchmark::toMilliSeconds(referenceTime) / iterations;
+			emitterNode["ms"               ] = Benchmark::toMilliSeconds(currentTime)   / iterations;
+			emitterNode["maxPositionError" ] = difference.position;
+			emitterNode["maxTexCoordError" ] = difference.texCoord;
+			emitterNode["maxColorError"    ] = difference.color;
+			emitterNode["matches"          ] = matches;
+			emittersNode.append(emitterNode);
+			
+			TT_Printf("ParticleBenchmark::run: '%s' emitter %d (%u particles): %.3f ms, reference %.3f ms%s\n",
+			          it->c_str(), emitterIndex, static_cast<u32>(startParticles.size()),
+			          Benchmark::toMilliSeconds(currentTime) / iterations, Benchmark::toMilliSeconds(referenceTime) / iterations,
+			          matches ? "" : " RESULTS DIFFER");
+		}
+		
+		particleMgr->removeTrigger(trigger);
+	}
+	rootNode["referenceMs"] = Benchmark::toMilliSeconds(totalReferenceTime) / iterations;
+	rootNode["ms"         ] = Benchmark::toMilliSeconds(totalTime)          / iterations;
+	rootNode["matches"    ] = allMatch;
+	
+	TT_Printf("ParticleBenchmark::run: %.3f ms, reference %.3f ms\n",
+	          Benchmark::toMilliSeconds(totalTime) / iterations, Benchmark::toMilliSeconds(totalReferenceTime) / iterations);
+	TT_ASSERTMSG(allMatch, "Particle update differs from the reference implementation; see '%s'.",
+	             outputPath.c_str());
+	
+	return Benchmark::writeReport("ParticleBenchmark", rootNode, outputPath) && allMatch;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+s32 ParticleBenchmark::updateReference(ParticleEmitter& p_emitter, ReferenceParticles& p_particles,
+                                       real p_deltaTime)
+{
+	EmitterSettings& settings(p_emitter.m_settings);
+	
+	s32 deadParticles(0);
+	
+	// Update particles
+	math::VectorRect validRect(p_emitter.m_validRect);
+	if(p_emitter.m_useValidRect && settings.inWorldSpace)
+	{
+		validRect.translate(p_emitter.m_position);
+	}
+	
+	// NOTE: std::max() returns incorrect results if using std::numeric_limits here
+	math::Vector2 minPosition( 1000000.0f,  1000000.0f);
+	math::Vector2 maxPosition(-1000000.0f, -1000000.0f);
+	
+	for (ReferenceParticles::iterator it = p_particles.begin(); it != p_particles.end(); )
+	{
+		// Compute position in lifetime
+		real life = 1.0f - (it->energy / it->lifetime);
+		
+		// Update particle size
+		it->size = p_emitter.interpolate(it->start_size, it->end_size, life);
+		
+		// Compute new scale
+		it->scale.x = it->size;
+		it->scale.y = it->size * settings.heightScale;
+		
+		// Calculate current weight
+		it->weight = p_emitter.interpolate(it->start_weight, it->end_weight, life);
+		
+		// Compute external force for this particle
+		// (This used to draw both in one constructor call, but the order of that is up to the compiler.)
+		const real externalForceX = p_emitter.getRandom(settings.external_force_x);
+		const real externalForceY = p_emitter.getRandom(settings.external_force_y);
+		math::Vector2 externalForce(externalForceX, externalForceY);
+		
+		const real deltaTimeScale = (60 * p_deltaTime);
+		externalForce *= p_emitter.m_settingsScale * deltaTimeScale;
+		
+		// Calculate new velocity
+		it->velocity.x += externalForce.x * it->weight;
+		it->velocity.y += externalForce.y * it->weight;
+		it->velocity.x -= it->velocity_friction * it->velocity.x * deltaTimeScale;
+		it->velocity.y -= it->velocity_friction * it->velocity.y * deltaTimeScale;
+		
+		// Update the particle offset
+		it->position.x += (it->velocity.x * p_deltaTime);
+		it->position.y += (it->velocity.y * p_deltaTime);
+		
+		// Update bounding box
+		const real scaleFactor = std::max(it->scale.x, it->scale.y) * 0.5f;
+		math::Vector2 curMinPosition(it->position.x - scaleFactor, it->position.y - scaleFactor);
+		math::Vector2 curMaxPosition(it->position.x + scaleFactor, it->position.y + scaleFactor);
+		
+		minPosition.x = std::min(curMinPosition.x, minPosition.x);
+		minPosition.y = std::min(curMinPosition.y, minPosition.y);
+		maxPosition.x = std::max(curMaxPosition.x, maxPosition.x);
+		maxPosition.y = std::max(curMaxPosition.y, maxPosition.y);
+		
+		// Check if still in valid zone
+		if(p_emitter.m_useValidRect && validRect.intersects(math::VectorRect(curMinPosition, curMaxPosition)) == false)
+		{
+			it->energy = 0.0f;
+		}
+		
+		// Update rotation
+		if (settings.orientation == ParticleOrientation_ToRotation)
+		{
+			it->rotation_speed += (it->rotation_force * it->weight) * deltaTimeScale;
+			it->rotation_speed -= it->rotation_friction * it->rotation_speed * deltaTimeScale;
+			it->rotation += it->rotation_speed * p_deltaTime;
+		}
+		else if(settings.orientation == ParticleOrientation_Sway)
+		{
+			// FIXME: Ideally we would use a dedicated random offset to start the rotation at
+			//        This value could be computed once, but we would have to add another member to Particle
+			const Range<real>& rotationRange = settings.particle_creation.start_rotation;
+			real offset = it->start_rotation - rotationRange.low / rotationRange.high - rotationRange.low;
+			
+			it->rotation = math::sin(it->energy * it->rotation_speed + (offset * math::twoPi)) * it->start_rotation;
+		}
+		else
+		{
+			math::Vector2 direction(it->velocity);
+			math::Vector2 origin(settings.origin);
+			if (settings.inWorldSpace)
+			{
+				origin += p_emitter.m_position;
+			}
+			
+			switch(settings.orientation)
+			{
+			case ParticleOrientation_ToDirection:
+				// Already set direction to velocity
+				break;
+			
+			case ParticleOrientation_ToOrigin:
+				direction = origin - it->position;
+				break;
+			
+			case ParticleOrientation_FromOrigin:
+				direction = it->position - origin;
+				break;
+			
+			default:
+				TT_PANIC("Invalid particle orientation");
+			}
+			
+			math::clamp(direction.normalize().y, -1.0f, 1.0f);
+			it->rotation = math::acos(direction.y);
+			if(direction.x > 0) it->rotation = -it->rotation;
+		}
+		
+		// Update animation 
+		if(settings.animation_enabled)
+		{
+			// Update animation time
+			it->animation_time += p_deltaTime;
+			
+			// Update current frame
+			ParticleAnimation& anim(settings.animations[it->anim_idx]);
+			if(anim.type == ParticleAnimation::AnimationType_Stretch)
+			{
+				it->frame = static_cast<s32>(
+					(it->animation_time / it->lifetime) * (anim.end_frame - anim.start_frame + 1));
+			}
+			else
+			{
+				if (anim.spf > 0.0f)
+				{
+					while(it->animation_time > anim.spf)
+					{
+						if(anim.type == ParticleAnimation::AnimationType_PingPong && it->frame == anim.start_frame)
+						{
+							++(it->frame);
+							anim.forward = true;
+						}
+						else if(it->frame == anim.end_frame)
+						{
+							if(anim.type == ParticleAnimation::AnimationType_Loop)
+							{
+								it->frame = anim.start_frame;
+							}
+							else if(anim.type == ParticleAnimation::AnimationType_PingPong)
+							{
+								TT_ASSERT(anim.end_frame != anim.start_frame);
+								--(it->frame);
+								anim.forward = false;
+							}
+						}
+						else
+						{
+							anim.forward ? ++(it->frame) : --(it->frame);
+						}
+						
+						it->animation_time -= anim.spf;
+					}
+				}
+			}
+			
+			// Update texture transform
+			const FrameInfo& frame(settings.frame_info); 
+			it->tex_transform.x = (it->frame % frame.cells_x) * frame.tex_size.x;
+			it->tex_transform.y = (it->frame / frame.cells_x) * frame.tex_size.y;
+		}
+		
+		// Decrease energy
+		it->energy -= p_deltaTime;
+		
+		// Check for dead particles
+		if (it->energy <= 0.0f)
+		{
+			// Remove particle
+			it = code::helpers::unorderedErase(p_particles, it);
+			++deadParticles;
+		}
+		else
+		{
+			// Go to next particle
+			++it;
+		}
+	}
+	
+	return deadParticles;
+}
+
+
+void ParticleBenchmark::createReferenceQuads(const ParticleEmitter& p_emitter,
+                                             const ReferenceParticles& p_particles,
+                                             renderer::BatchQuadCollection& p_quads_OUT)
+{
+	const EmitterSettings& settings(p_emitter.m_settings);
+	
+	if(p_quads_OUT.size() < p_particles.size())
+	{
+		p_quads_OUT.resize(p_particles.size());
+	}
+	
+	renderer::BatchQuadCollection::iterator quadIt = p_quads_OUT.begin();
+	
+	for (ReferenceParticles::const_reverse_iterator it = p_particles.rbegin(); it != p_particles.rend(); ++it)
+	{
+		// Generate batch quad (could be optimized by creating a quad with default settings)
+		renderer::BatchQuad& quad = *quadIt;
+		
+		math::Matrix44 transform = math::Matrix44::getTranslation(math::Vector3(it->position.x, it->position.y, p_emitter.m_zDepth));
+		if(settings.inWorldSpace == false)
+		{
+			transform.translate(p_emitter.m_position);
+		}
+		
+		if(math::realEqual(it->rotation, 0.0f) == false)
+		{
+			transform.rotateZ(it->rotation);
+		}
+		transform.scale(it->scale.x, it->scale.y);
+		
+		static const math::Vector3 topLeft    (-0.5f,  0.5f, 0.0f);
+		static const math::Vector3 topRight   ( 0.5f,  0.5f, 0.0f);
+		static const math::Vector3 bottomLeft (-0.5f, -0.5f, 0.0f);
+		static const math::Vector3 bottomRight( 0.5f, -0.5f, 0.0f);
+		
+		quad.topLeft.setPosition    (topLeft     * transform);
+		quad.topRight.setPosition   (topRight    * transform);
+		quad.bottomLeft.setPosition (bottomLeft  * transform);
+		quad.bottomRight.setPosition(bottomRight * transform);
+		
+		// Compute texture coordinates
+		real leftU   = 0;
+		real rightU  = 1;
+		real topV    = 0;
+		real bottomV = 1;
+		
+		if(settings.animation_enabled)
+		{
+			leftU   = (it->tex_transform.x);
+			rightU  = (it->tex_transform.x) + settings.frame_info.tex_size.x;
+			topV    = (it->tex_transform.y);
+			bottomV = (it->tex_transform.y) + settings.frame_info.tex_size.y;
+		}
+		
+		if((settings.flipTexture & FlipAxis_X) == FlipAxis_X)
+		{
+			std::swap(leftU, rightU);
+		}
+		if((settings.flipTexture & FlipAxis_Y) == FlipAxis_Y)
+		{
+			std::swap(topV, bottomV);
+		}
+		
+		quad.topLeft.setTexCoord    (leftU,  topV);
+		quad.topRight.setTexCoord   (rightU, topV);
+		quad.bottomLeft.setTexCoord (leftU,  bottomV);
+		quad.bottomRight.setTexCoord(rightU, bottomV);
+		
+		if(settings.vertex_color_enabled)
+		{
+			renderer::ColorRGBA vertexColor(it->start_color);
+			
+			const real life = 1.0f - (it->energy / it->lifetime);
+			if(settings.vertex_color_interpolation)
+			{
+				vertexColor = p_emitter.interpolate(it->start_color, it->end_color, life);
+			}
+			
+			// Handle fade in/out
+			if(life < it->fade_in)
+			{
+				vertexColor.a = static_cast<u8>((life / it->fade_in) * vertexColor.a);
+			}
+			else if(life > (1 - it->fade_out))
+			{
+				real fade((1.0f - life) / it->fade_out);
+				vertexColor.a = static_cast<u8>(fade * vertexColor.a);
+			}
+			
+			if(p_emitter.m_texture != 0 && p_emitter.m_texture->isPremultiplied() && settings.blend_mode != renderer::BlendMode_Modulate)
+			{
+				vertexColor.premultiply();
+			}
+			quad.topLeft.    setColor(vertexColor);
+			quad.topRight.   setColor(vertexColor);
+			quad.bottomLeft. setColor(vertexColor);
+			quad.bottomRight.setColor(vertexColor);
+		}
+		
+		++quadIt;
+	}
+}
+
+
+ParticleBenchmark::QuadDifference ParticleBenchmark::compareQuads(
+		const renderer::BatchQuadCollection& p_reference,
+		const renderer::BatchQuadCollection& p_quads,
+		size_t p_count)
+{
+	TT_ASSERT(p_reference.size() >= p_count && p_quads.size() >= p_count);
+	
+	QuadDifference difference;
+	for (size_t i = 0; i < p_count; ++i)
+	{
+		const renderer::BufferVtx* reference[] = { &p_reference[i].bottomLeft,  &p_reference[i].topLeft,
+		                                           &p_reference[i].bottomRight, &p_reference[i].topRight };
+		const renderer::BufferVtx* vertex[]    = { &p_quads[i].bottomLeft,  &p_quads[i].topLeft,
+		                                           &p_quads[i].bottomRight, &p_quads[i].topRight };
+		for (s32 corner = 0; corner < 4; ++corner)
+		{
+			const math::Vector3& referencePosition(reference[corner]->getPosition());
+			const math::Vector3& position         (vertex[corner]->getPosition());
+			const real scale = std::max(std::max(math::fabs(referencePosition.x), math::fabs(referencePosition.y)), 1.0f);
+			difference.position = std::max(difference.position,
+				std::max(math::fabs(position.x - referencePosition.x),
+				         math::fabs(position.y - referencePosition.y)) / scale);
+			
+			const math::Vector2& referenceTexCoord(reference[corner]->getTexCoord());
+			const math::Vector2& texCoord         (vertex[corner]->getTexCoord());
+			difference.texCoord = std::max(difference.texCoord,
+				std::max(math::fabs(texCoord.x - referenceTexCoord.x),
+				         math::fabs(texCoord.y - referenceTexCoord.y)));
+			
+			const renderer::ColorRGBA& referenceColor(reference[corner]->getColor());
+			const renderer::ColorRGBA& color         (vertex[corner]->getColor());
+			difference.color = std::max(difference.color,
+				std::max(std::max(std::abs(color.r - referenceColor.r), std::abs(color.g - referenceColor.g)),
+				         std::max(std::abs(color.b - referenceColor.b), std::abs(color.a - referenceColor.a))));
+		}
+	}
+	return difference;
+}
+
+// Namespace end
+}
+}
+}
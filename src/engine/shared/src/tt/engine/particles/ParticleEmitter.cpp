@@ -5,6 +5,9 @@
 #include <tt/engine/particles/ParticleMgr.h>
 #include <tt/engine/renderer/MatrixStack.h>
 #include <tt/engine/renderer/QuadBuffer.h>
+#if defined(TT_PLATFORM_SDL)
+#include <tt/engine/renderer/QuadRenderQueue.h>
+#endif
 #include <tt/engine/renderer/Renderer.h>
 #include <tt/engine/renderer/Texture.h>
 #include <tt/engine/renderer/VertexBuffer.h>
@@ -23,6 +26,22 @@ namespace particles {
 bool ParticleEmitter::ms_useFileTextureCache = false;
 
 
+//--------------------------------------------------------------------------------------------------
+// Helper functions
+
+// Applies the (already scaled) external force and the friction to one axis of a particle and moves it
+static inline void integrateParticle(real& p_position, real& p_velocity, real p_force, real p_weight,
+                                     real p_friction, real p_deltaTime, real p_deltaTimeScale)
+{
+	p_velocity += p_force * p_weight;
+	p_velocity -= p_friction * p_velocity * p_deltaTimeScale;
+	p_position += (p_velocity * p_deltaTime);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
 ParticleEmitter::ParticleEmitter(TriggerID p_triggerID)
 :
 m_active(false),
@@ -44,7 +63,11 @@ m_externalImpulse(math::Vector2::zero),
 m_isCulled(false),
 m_boundingBox(),
 m_validRect(),
-m_particles()
+m_particles(),
+m_updateOrder(),
+m_survivors(),
+m_externalForceX(),
+m_externalForceY()
 {
 }
 
@@ -252,200 +275,12 @@ void ParticleEmitter::update(real p_delta_time)
 		}
 	}
 	
-	s32 deadParticles(0);
-	
-	// Update particles
-	math::VectorRect validRect(m_validRect);
-	if(m_useValidRect && m_settings.inWorldSpace)
-	{
-		validRect.translate(m_position);
-	}
-	
-	// NOTE: std::max() returns incorrect results if using std::numeric_limits here
-	math::Vector2 minPosition( 1000000.0f,  1000000.0f);
-	math::Vector2 maxPosition(-1000000.0f, -1000000.0f);
-	
-	for (Particles::iterator it = m_particles.begin(); it != m_particles.end(); )
-	{
-		// Compute position in lifetime
-		real life = 1.0f - (it->energy / it->lifetime);
-		
-		// Update particle size
-		it->size = interpolate(it->start_size, it->end_size, life);
-		
-		// Compute new scale
-		it->scale.x = it->size;
-		it->scale.y = it->size * m_settings.heightScale;
-		
-		// Calculate current weight
-		it->weight = interpolate(it->start_weight, it->end_weight, life);
-		
-		// Compute external force for this particle
-		math::Vector2 externalForce(
-			getRandom(m_settings.external_force_x), getRandom(m_settings.external_force_y));
-		
-		const real deltaTimeScale = (60 * p_delta_time);
-		externalForce *= m_settingsScale * deltaTimeScale;
-		
-		// Calculate new velocity
-		it->velocity.x += externalForce.x * it->weight;
-		it->velocity.y += externalForce.y * it->weight;
-		it->velocity.x -= it->velocity_friction * it->velocity.x * deltaTimeScale;
-		it->velocity.y -= it->velocity_friction * it->velocity.y * deltaTimeScale;
-		
-		// Update the particle offset
-		it->position.x += (it->velocity.x * p_delta_time);
-		it->position.y += (it->velocity.y * p_delta_time);
-		
-		// Update bounding box
-		const real scaleFactor = std::max(it->scale.x, it->scale.y) * 0.5f;
-		math::Vector2 curMinPosition(it->position.x - scaleFactor, it->position.y - scaleFactor);
-		math::Vector2 curMaxPosition(it->position.x + scaleFactor, it->position.y + scaleFactor);
-		
-		minPosition.x = std::min(curMinPosition.x, minPosition.x);
-		minPosition.y = std::min(curMinPosition.y, minPosition.y);
-		maxPosition.x = std::max(curMaxPosition.x, maxPosition.x);
-		maxPosition.y = std::max(curMaxPosition.y, maxPosition.y);
-		
-		// Check if still in valid zone
-		if(m_useValidRect && validRect.intersects(math::VectorRect(curMinPosition, curMaxPosition)) == false)
-		{
-			it->energy = 0.0f;
-		}
-		
-		// Update rotation
-		if (m_settings.orientation == ParticleOrientation_ToRotation)
-		{
-			it->rotation_speed += (it->rotation_force * it->weight) * deltaTimeScale;
-			it->rotation_speed -= it->rotation_friction * it->rotation_speed * deltaTimeScale;
-			it->rotation += it->rotation_speed * p_delta_time;
-		}
-		else if(m_settings.orientation == ParticleOrientation_Sway)
-		{
-			// FIXME: Ideally we would use a dedicated random offset to start the rotation at
-			//        This value could be computed once, but we would have to add another member to Particle
-			const Range<real>& rotationRange = m_settings.particle_creation.start_rotation;
-			real offset = it->start_rotation - rotationRange.low / rotationRange.high - rotationRange.low;
-			
-			it->rotation = math::sin(it->energy * it->rotation_speed + (offset * math::twoPi)) * it->start_rotation;
-		}
-		else
-		{
-			math::Vector2 direction(it->velocity);
-			math::Vector2 origin(m_settings.origin);
-			if (m_settings.inWorldSpace)
-			{
-				origin += m_position;
-			}
-			
-			switch(m_settings.orientation)
-			{
-			case ParticleOrientation_ToDirection:
-				// Already set direction to velocity
-				break;
-			
-			case ParticleOrientation_ToOrigin:
-				direction = origin - it->position;
-				break;
-			
-			case ParticleOrientation_FromOrigin:
-				direction = it->position - origin;
-				break;
-			
-			default:
-				TT_PANIC("Invalid particle orientation");
-			}
-			
-			math::clamp(direction.normalize().y, -1.0f, 1.0f);
-			it->rotation = math::acos(direction.y);
-			if(direction.x > 0) it->rotation = -it->rotation;
-		}
-		
-		// Update animation 
-		if(m_settings.animation_enabled)
-		{
-			// Update animation time
-			it->animation_time += p_delta_time;
-			
-			// Update current frame
-			ParticleAnimation& anim(m_settings.animations[it->anim_idx]);
-			if(anim.type == ParticleAnimation::AnimationType_Stretch)
-			{
-				it->frame = static_cast<s32>(
-					(it->animation_time / it->lifetime) * (anim.end_frame - anim.start_frame + 1));
-			}
-			else
-			{
-				if (anim.spf > 0.0f)
-				{
-					while(it->animation_time > anim.spf)
-					{
-						if(anim.type == ParticleAnimation::AnimationType_PingPong && it->frame == anim.start_frame)
-						{
-							++(it->frame);
-							anim.forward = true;
-						}
-						else if(it->frame == anim.end_frame)
-						{
-							if(anim.type == ParticleAnimation::AnimationType_Loop)
-							{
-								it->frame = anim.start_frame;
-							}
-							else if(anim.type == ParticleAnimation::AnimationType_PingPong)
-							{
-								TT_ASSERT(anim.end_frame != anim.start_frame);
-								--(it->frame);
-								anim.forward = false;
-							}
-						}
-						else
-						{
-							anim.forward ? ++(it->frame) : --(it->frame);
-						}
-						
-						it->animation_time -= anim.spf;
-					}
-				}
-			}
-			
-			// Update texture transform
-			const FrameInfo& frame(m_settings.frame_info); 
-			it->tex_transform.x = (it->frame % frame.cells_x) * frame.tex_size.x;
-			it->tex_transform.y = (it->frame / frame.cells_x) * frame.tex_size.y;
-		}
-		
-		// Decrease energy
-		it->energy -= p_delta_time;
-		
-		// Check for dead particles
-		if (it->energy <= 0.0f)
-		{
-			// Remove particle
-			it = code::helpers::unorderedErase(m_particles, it);
-			++deadParticles;
-		}
-		else
-		{
-			// Go to next particle
-			++it;
-		}
-	}
-	
+	const s32 deadParticles = updateParticles(p_delta_time);
 	if(deadParticles > 0)
 	{
 		ParticleMgr::getInstance()->releaseParticles(m_triggerID, deadParticles);
 	}
 	
-	// Set bounding box
-	if (m_particles.empty() == false)
-	{
-		m_boundingBox = math::VectorRect(minPosition, maxPosition);
-		if (m_settings.inWorldSpace)
-		{
-			m_boundingBox.translate(-m_position);
-		}
-	}
-	
 	if (m_pregenerating == false)
 	{
 		createQuadBatch();
@@ -471,6 +306,16 @@ void ParticleEmitter::render()
 		m_quads->fillBuffer(m_quadBatch.begin(), quadIt);
 	}
 	
+#if defined(TT_PLATFORM_SDL)
+	// Batched with the other emitters by ParticleMgr
+	renderer::QuadRenderQueue* queue = renderer->getQuadRenderQueue();
+	if (queue->isRecording())
+	{
+		queue->submit(*m_quads, m_settings.blend_mode, m_settings.blend_mode_alpha, m_settings.ignore_fog == false);
+		return;
+	}
+#endif
+	
 	renderer->setBlendMode(m_settings.blend_mode);
 	
 	// Remember blend mode alpha so we can restore it.
@@ -943,102 +788,424 @@ void ParticleEmitter::pregenerateParticles()
 }
 
 
-void ParticleEmitter::createQuadBatch()
+s32 ParticleEmitter::updateParticles(real p_delta_time)
 {
-	if(m_quadBatch.size() < m_particles.size())
+	ParticleData& particles(m_particles);
+	const size_t count = particles.size();
+	if (count == 0)
 	{
-		m_quadBatch.resize(m_particles.size());
+		return 0;
 	}
 	
-	renderer::BatchQuadCollection::iterator quadIt = m_quadBatch.begin();
-	
-	for (Particles::reverse_iterator it = m_particles.rbegin(); it != m_particles.rend(); ++it)
+	const real deltaTimeScale = (60 * p_delta_time);
+	
+	// Every step below is a loop over a few property arrays, so the compiler can vectorize it.
+	real* const positionX        = &particles.position_x       [0];
+	real* const positionY        = &particles.position_y       [0];
+	real* const velocityX        = &particles.velocity_x       [0];
+	real* const velocityY        = &particles.velocity_y       [0];
+	real* const velocityFriction = &particles.velocity_friction[0];
+	real* const energy           = &particles.energy           [0];
+	real* const scaleX           = &particles.scale_x          [0];
+	real* const scaleY           = &particles.scale_y          [0];
+	real* const weight           = &particles.weight           [0];
+	real* const rotation         = &particles.rotation         [0];
+	real* const rotationSpeed    = &particles.rotation_speed   [0];
+	
+	// Compute size and weight from the position in lifetime
 	{
-		// Generate batch quad (could be optimized by creating a quad with default settings)
-		renderer::BatchQuad& quad = *quadIt;
+		const real* const lifetime    = &particles.lifetime    [0];
+		const real* const startSize   = &particles.start_size  [0];
+		const real* const endSize     = &particles.end_size    [0];
+		const real* const startWeight = &particles.start_weight[0];
+		const real* const endWeight   = &particles.end_weight  [0];
+		const real        heightScale = m_settings.heightScale;
 		
-		math::Matrix44 transform = math::Matrix44::getTranslation(math::Vector3(it->position.x, it->position.y, m_zDepth));
-		if(m_settings.inWorldSpace == false)
+		for (size_t i = 0; i < count; ++i)
 		{
-			transform.translate(m_position);
+			const real life = 1.0f - (energy[i] / lifetime[i]);
+			const real size = interpolate(startSize[i], endSize[i], life);
+			scaleX[i] = size;
+			scaleY[i] = size * heightScale;
+			weight[i] = interpolate(startWeight[i], endWeight[i], life);
 		}
+	}
+	
+	// Dead particles used to be swapped with the last particle, which was updated next. Replay that
+	// order, so every particle draws the same random external force as before and the survivors end
+	// up in the same slots. Particles outside the valid rect are moved here, because whether they
+	// die depends on their new position.
+	math::VectorRect validRect(m_validRect);
+	if(m_useValidRect && m_settings.inWorldSpace)
+	{
+		validRect.translate(m_position);
+	}
+	
+	m_updateOrder   .resize(count);
+	m_survivors     .resize(count);
+	m_externalForceX.resize(count);
+	m_externalForceY.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		m_survivors[i] = static_cast<u32>(i);
+	}
+	
+	const real forceScale = m_settingsScale * deltaTimeScale;
+	size_t aliveCount   = count;
+	size_t updatedCount = 0;
+	for (size_t slot = 0; slot < aliveCount; )
+	{
+		const u32 i = m_survivors[slot];
+		m_updateOrder[updatedCount] = i;
+		++updatedCount;
 		
-		if(math::realEqual(it->rotation, 0.0f) == false)
+		// Compute external force for this particle
+		m_externalForceX[i] = getRandom(m_settings.external_force_x) * forceScale;
+		m_externalForceY[i] = getRandom(m_settings.external_force_y) * forceScale;
+		
+		bool isDead = (energy[i] - p_delta_time) <= 0.0f;
+		if (m_useValidRect)
 		{
-			transform.rotateZ(it->rotation);
+			integrateParticle(positionX[i], velocityX[i], m_externalForceX[i], weight[i], velocityFriction[i],
+			                  p_delta_time, deltaTimeScale);
+			integrateParticle(positionY[i], velocityY[i], m_externalForceY[i], weight[i], velocityFriction[i],
+			                  p_delta_time, deltaTimeScale);
+			
+			// Check if still in valid zone
+			const real scaleFactor = std::max(scaleX[i], scaleY[i]) * 0.5f;
+			const math::Vector2 minPosition(positionX[i] - scaleFactor, positionY[i] - scaleFactor);
+			const math::Vector2 maxPosition(positionX[i] + scaleFactor, positionY[i] + scaleFactor);
+			if (validRect.intersects(math::VectorRect(minPosition, maxPosition)) == false)
+			{
+				isDead = true;
+			}
 		}
-		transform.scale(it->scale.x, it->scale.y);
 		
-		static const math::Vector3 topLeft    (-0.5f,  0.5f, 0.0f);
-		static const math::Vector3 topRight   ( 0.5f,  0.5f, 0.0f);
-		static const math::Vector3 bottomLeft (-0.5f, -0.5f, 0.0f);
-		static const math::Vector3 bottomRight( 0.5f, -0.5f, 0.0f);
-		
-		quad.topLeft.setPosition    (topLeft     * transform);
-		quad.topRight.setPosition   (topRight    * transform);
-		quad.bottomLeft.setPosition (bottomLeft  * transform);
-		quad.bottomRight.setPosition(bottomRight * transform);
-		
-		// Compute texture coordinates
-		real leftU   = 0;
-		real rightU  = 1;
-		real topV    = 0;
-		real bottomV = 1;
-		
-		if(m_settings.animation_enabled)
+		if (isDead)
+		{
+			--aliveCount;
+			m_survivors[slot] = m_survivors[aliveCount];
+		}
+		else
+		{
+			++slot;
+		}
+	}
+	TT_ASSERT(updatedCount == count);
+	
+	// Calculate new velocity and update the particle offset
+	if (m_useValidRect == false)
+	{
+		const real* const forceX = &m_externalForceX[0];
+		const real* const forceY = &m_externalForceY[0];
+		for (size_t i = 0; i < count; ++i)
 		{
-			leftU   = (it->tex_transform.x);
-			rightU  = (it->tex_transform.x) + m_settings.frame_info.tex_size.x;
-			topV    = (it->tex_transform.y);
-			bottomV = (it->tex_transform.y) + m_settings.frame_info.tex_size.y;
+			integrateParticle(positionX[i], velocityX[i], forceX[i], weight[i], velocityFriction[i],
+			                  p_delta_time, deltaTimeScale);
+		}
+		for (size_t i = 0; i < count; ++i)
+		{
+			integrateParticle(positionY[i], velocityY[i], forceY[i], weight[i], velocityFriction[i],
+			                  p_delta_time, deltaTimeScale);
+		}
+	}
+	
+	// Update bounding box (this includes the particles that die this update)
+	// NOTE: std::max() returns incorrect results if using std::numeric_limits here
+	math::Vector2 minPosition( 1000000.0f,  1000000.0f);
+	math::Vector2 maxPosition(-1000000.0f, -1000000.0f);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const real scaleFactor = std::max(scaleX[i], scaleY[i]) * 0.5f;
+		minPosition.x = std::min(positionX[i] - scaleFactor, minPosition.x);
+		minPosition.y = std::min(positionY[i] - scaleFactor, minPosition.y);
+		maxPosition.x = std::max(positionX[i] + scaleFactor, maxPosition.x);
+		maxPosition.y = std::max(positionY[i] + scaleFactor, maxPosition.y);
+	}
+	
+	// Update rotation
+	if (m_settings.orientation == ParticleOrientation_ToRotation)
+	{
+		const real* const rotationForce    = &particles.rotation_force   [0];
+		const real* const rotationFriction = &particles.rotation_friction[0];
+		for (size_t i = 0; i < count; ++i)
+		{
+			rotationSpeed[i] += (rotationForce[i] * weight[i]) * deltaTimeScale;
+			rotationSpeed[i] -= rotationFriction[i] * rotationSpeed[i] * deltaTimeScale;
+			rotation[i]      += rotationSpeed[i] * p_delta_time;
+		}
+	}
+	else if(m_settings.orientation == ParticleOrientation_Sway)
+	{
+		// FIXME: Ideally we would use a dedicated random offset to start the rotation at
+		//        This value could be computed once, but we would have to add another member to Particle
+		const Range<real>& rotationRange = m_settings.particle_creation.start_rotation;
+		const real* const startRotation = &particles.start_rotation[0];
+		for (size_t i = 0; i < count; ++i)
+		{
+			real offset = startRotation[i] - rotationRange.low / rotationRange.high - rotationRange.low;
+			
+			rotation[i] = math::sin(energy[i] * rotationSpeed[i] + (offset * math::twoPi)) * startRotation[i];
+		}
+	}
+	else
+	{
+		math::Vector2 origin(m_settings.origin);
+		if (m_settings.inWorldSpace)
+		{
+			origin += m_position;
 		}
 		
-		if((m_settings.flipTexture & FlipAxis_X) == FlipAxis_X)
+		for (size_t i = 0; i < count; ++i)
 		{
-			std::swap(leftU, rightU);
+			math::Vector2 direction(velocityX[i], velocityY[i]);
+			switch(m_settings.orientation)
+			{
+			case ParticleOrientation_ToDirection:
+				// Already set direction to velocity
+				break;
+			
+			case ParticleOrientation_ToOrigin:
+				direction = origin - math::Vector2(positionX[i], positionY[i]);
+				break;
+			
+			case ParticleOrientation_FromOrigin:
+				direction = math::Vector2(positionX[i], positionY[i]) - origin;
+				break;
+			
+			default:
+				TT_PANIC("Invalid particle orientation");
+			}
+			
+			math::clamp(direction.normalize().y, -1.0f, 1.0f);
+			rotation[i] = math::acos(direction.y);
+			if(direction.x > 0) rotation[i] = -rotation[i];
 		}
-		if((m_settings.flipTexture & FlipAxis_Y) == FlipAxis_Y)
+	}
+	
+	// Update animation
+	if(m_settings.animation_enabled)
+	{
+		// The ping-pong direction is shared by all particles with the same animation,
+		// so this has to follow the update order.
+		const FrameInfo& frameInfo(m_settings.frame_info);
+		for (size_t order = 0; order < count; ++order)
 		{
-			std::swap(topV, bottomV);
+			const u32 i = m_updateOrder[order];
+			s32&  frame         = particles.frame[i];
+			real& animationTime = particles.animation_time[i];
+			
+			// Update animation time
+			animationTime += p_delta_time;
+			
+			// Update current frame
+			ParticleAnimation& anim(m_settings.animations[particles.anim_idx[i]]);
+			if(anim.type == ParticleAnimation::AnimationType_Stretch)
+			{
+				frame = static_cast<s32>(
+					(animationTime / particles.lifetime[i]) * (anim.end_frame - anim.start_frame + 1));
+			}
+			else
+			{
+				if (anim.spf > 0.0f)
+				{
+					while(animationTime > anim.spf)
+					{
+						if(anim.type == ParticleAnimation::AnimationType_PingPong && frame == anim.start_frame)
+						{
+							++frame;
+							anim.forward = true;
+						}
+						else if(frame == anim.end_frame)
+						{
+							if(anim.type == ParticleAnimation::AnimationType_Loop)
+							{
+								frame = anim.start_frame;
+							}
+							else if(anim.type == ParticleAnimation::AnimationType_PingPong)
+							{
+								TT_ASSERT(anim.end_frame != anim.start_frame);
+								--frame;
+								anim.forward = false;
+							}
+						}
+						else
+						{
+							anim.forward ? ++frame : --frame;
+						}
+						
+						animationTime -= anim.spf;
+					}
+				}
+			}
+			
+			// Update texture transform
+			particles.tex_u[i] = (frame % frameInfo.cells_x) * frameInfo.tex_size.x;
+			particles.tex_v[i] = (frame / frameInfo.cells_x) * frameInfo.tex_size.y;
+		}
+	}
+	
+	// Decrease energy
+	for (size_t i = 0; i < count; ++i)
+	{
+		energy[i] -= p_delta_time;
+	}
+	
+	// Remove dead particles. A survivor always comes from its own slot or a later one,
+	// so moving them into place front to back never overwrites one that still has to move.
+	for (size_t slot = 0; slot < aliveCount; ++slot)
+	{
+		if (m_survivors[slot] != slot)
+		{
+			particles.move(slot, m_survivors[slot]);
+		}
+	}
+	particles.resize(aliveCount);
+	
+	// Set bounding box
+	if (particles.empty() == false)
+	{
+		m_boundingBox = math::VectorRect(minPosition, maxPosition);
+		if (m_settings.inWorldSpace)
+		{
+			m_boundingBox.translate(-m_position);
+		}
+	}
+	
+	return static_cast<s32>(count - aliveCount);
+}
+
+
+void ParticleEmitter::createQuadBatch()
+{
+	const ParticleData& particles(m_particles);
+	const size_t count = particles.size();
+	if(m_quadBatch.size() < count)
+	{
+		m_quadBatch.resize(count);
+	}
+	if (count == 0)
+	{
+		return;
+	}
+	
+	// Particles are batched in reverse order
+	renderer::BatchQuad* const lastQuad = &m_quadBatch[count - 1];
+	
+	// Compute the corners of a unit quad that is scaled, rotated and moved to the particle position.
+	// (This is the product of the translation, rotation and scale matrices written out.)
+	{
+		const real* const positionX = &particles.position_x[0];
+		const real* const positionY = &particles.position_y[0];
+		const real* const scaleX    = &particles.scale_x   [0];
+		const real* const scaleY    = &particles.scale_y   [0];
+		const real* const rotation  = &particles.rotation  [0];
+		const real        offsetX   = m_settings.inWorldSpace ? 0.0f : m_position.x;
+		const real        offsetY   = m_settings.inWorldSpace ? 0.0f : m_position.y;
+		const real        z         = m_zDepth;
+		
+		for (size_t i = 0; i < count; ++i)
+		{
+			real sinRotation = 0.0f;
+			real cosRotation = 1.0f;
+			if(math::realEqual(rotation[i], 0.0f) == false)
+			{
+				sinRotation = math::sin(rotation[i]);
+				cosRotation = math::cos(rotation[i]);
+			}
+			
+			// Half of the rotated x and y axes
+			const real axisXx = 0.5f * (scaleX[i] * cosRotation);
+			const real axisXy = 0.5f * (scaleX[i] * sinRotation);
+			const real axisYx = 0.5f * (scaleY[i] * sinRotation);
+			const real axisYy = 0.5f * (scaleY[i] * cosRotation);
+			
+			const real x = positionX[i] + offsetX;
+			const real y = positionY[i] + offsetY;
+			
+			renderer::BatchQuad& quad = *(lastQuad - i);
+			quad.topLeft.setPosition    ((-axisXx - axisYx) + x, (-axisXy + axisYy) + y, z);
+			quad.topRight.setPosition   (( axisXx - axisYx) + x, ( axisXy + axisYy) + y, z);
+			quad.bottomLeft.setPosition ((-axisXx + axisYx) + x, (-axisXy - axisYy) + y, z);
+			quad.bottomRight.setPosition(( axisXx + axisYx) + x, ( axisXy - axisYy) + y, z);
 		}
+	}
+	
+	// Compute texture coordinates
+	{
+		const bool flipX = (m_settings.flipTexture & FlipAxis_X) == FlipAxis_X;
+		const bool flipY = (m_settings.flipTexture & FlipAxis_Y) == FlipAxis_Y;
+		const math::Vector2& texSize(m_settings.frame_info.tex_size);
 		
-		quad.topLeft.setTexCoord    (leftU,  topV);
-		quad.topRight.setTexCoord   (rightU, topV);
-		quad.bottomLeft.setTexCoord (leftU,  bottomV);
-		quad.bottomRight.setTexCoord(rightU, bottomV);
+		for (size_t i = 0; i < count; ++i)
+		{
+			real leftU   = 0;
+			real rightU  = 1;
+			real topV    = 0;
+			real bottomV = 1;
+			
+			if(m_settings.animation_enabled)
+			{
+				leftU   = particles.tex_u[i];
+				rightU  = particles.tex_u[i] + texSize.x;
+				topV    = particles.tex_v[i];
+				bottomV = particles.tex_v[i] + texSize.y;
+			}
+			
+			if(flipX)
+			{
+				std::swap(leftU, rightU);
+			}
+			if(flipY)
+			{
+				std::swap(topV, bottomV);
+			}
+			
+			renderer::BatchQuad& quad = *(lastQuad - i);
+			quad.topLeft.setTexCoord    (leftU,  topV);
+			quad.topRight.setTexCoord   (rightU, topV);
+			quad.bottomLeft.setTexCoord (leftU,  bottomV);
+			quad.bottomRight.setTexCoord(rightU, bottomV);
+		}
+	}
+	
+	if(m_settings.vertex_color_enabled)
+	{
+		const bool premultiply = m_texture != 0 && m_texture->isPremultiplied() &&
+		                         m_settings.blend_mode != renderer::BlendMode_Modulate;
 		
-		if(m_settings.vertex_color_enabled)
+		for (size_t i = 0; i < count; ++i)
 		{
-			renderer::ColorRGBA vertexColor(it->start_color);
+			renderer::ColorRGBA vertexColor(particles.start_color[i]);
 			
-			const real life = 1.0f - (it->energy / it->lifetime);
+			const real life = 1.0f - (particles.energy[i] / particles.lifetime[i]);
 			if(m_settings.vertex_color_interpolation)
 			{
-				vertexColor = interpolate(it->start_color, it->end_color, life);
+				vertexColor = interpolate(particles.start_color[i], particles.end_color[i], life);
 			}
 			
 			// Handle fade in/out
-			if(life < it->fade_in)
+			if(life < particles.fade_in[i])
 			{
-				vertexColor.a = static_cast<u8>((life / it->fade_in) * vertexColor.a);
+				vertexColor.a = static_cast<u8>((life / particles.fade_in[i]) * vertexColor.a);
 			}
-			else if(life > (1 - it->fade_out))
+			else if(life > (1 - particles.fade_out[i]))
 			{
-				real fade((1.0f - life) / it->fade_out);
+				real fade((1.0f - life) / particles.fade_out[i]);
 				vertexColor.a = static_cast<u8>(fade * vertexColor.a);
 			}
 			
-			if(m_texture != 0 && m_texture->isPremultiplied() && m_settings.blend_mode != renderer::BlendMode_Modulate)
+			if(premultiply)
 			{
 				vertexColor.premultiply();
 			}
+			
+			renderer::BatchQuad& quad = *(lastQuad - i);
 			quad.topLeft.    setColor(vertexColor);
 			quad.topRight.   setColor(vertexColor);
 			quad.bottomLeft. setColor(vertexColor);
 			quad.bottomRight.setColor(vertexColor);
 		}
-		
-		++quadIt;
 	}
 }
 
@@ -1063,18 +1230,20 @@ m_externalImpulse(p_emitter.m_externalImpulse),
 m_isCulled(p_emitter.m_isCulled),
 m_boundingBox(p_emitter.m_boundingBox),
 m_validRect(p_emitter.m_validRect),
-m_particles() // Gets filled below with the number of particles that are allowed.
+m_particles(), // Gets filled below with the number of particles that are allowed.
+m_updateOrder(),
+m_survivors(),
+m_externalForceX(),
+m_externalForceY()
 {
 	const s32 allowedCount = ParticleMgr::getInstance()->requestParticles(
 			m_triggerID,
 			static_cast<s32>(p_emitter.m_particles.size()));
 	
-	if (allowedCount > 0)
+	m_particles.reserve(m_settings.max_particles);
+	for (s32 i = 0; i < allowedCount; ++i)
 	{
-		Particles::const_iterator beginIt = p_emitter.m_particles.begin();
-		Particles::const_iterator endIt = beginIt;
-		std::advance(endIt, allowedCount);
-		m_particles.assign(beginIt, endIt);
+		m_particles.push_back(p_emitter.m_particles.get(static_cast<size_t>(i)));
 	}
 	
 	// Create buffer to hold quads
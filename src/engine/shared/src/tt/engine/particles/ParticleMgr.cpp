@@ -8,6 +8,9 @@
 #include <tt/engine/debug/DebugRenderer.h>
 #include <tt/engine/renderer/Renderer.h>
 #include <tt/engine/renderer/MatrixStack.h>
+#if defined(TT_PLATFORM_SDL)
+#include <tt/engine/renderer/QuadRenderQueue.h>
+#endif
 #include <tt/fs/utils/utils.h>
 #include <tt/str/str.h>
 #include <tt/thread/ThreadedWorkload.h>
@@ -214,6 +217,12 @@ void ParticleMgr::renderAllGroups() const
 {
 	renderer::Renderer::getInstance()->getDebug()->startRenderGroup("Particles");
 	
+#if defined(TT_PLATFORM_SDL)
+	// Emitters submit their quads to the queue, so emitters that share a state are drawn together
+	renderer::QuadRenderQueue* queue = renderer::Renderer::getInstance()->getQuadRenderQueue();
+	queue->begin();
+#endif
+	
 	// Render all active particles
 	{
 		TriggerCollection::const_iterator end = m_triggers.end();
@@ -227,6 +236,10 @@ void ParticleMgr::renderAllGroups() const
 		}
 	}
 	
+#if defined(TT_PLATFORM_SDL)
+	queue->flush();
+#endif
+	
 	// Restore texture transform to play nice with other elements that are not
 	// using it...
 	renderer::MatrixStack::getInstance()->resetTextureMatrix();
@@ -239,6 +252,12 @@ void ParticleMgr::renderGroup(s32 p_group) const
 {
 	renderer::Renderer::getInstance()->getDebug()->startRenderGroup("Particles");
 	
+#if defined(TT_PLATFORM_SDL)
+	// Emitters submit their quads to the queue, so emitters that share a state are drawn together
+	renderer::QuadRenderQueue* queue = renderer::Renderer::getInstance()->getQuadRenderQueue();
+	queue->begin();
+#endif
+	
 	// Render all active particles
 	{
 		TriggerCollection::const_iterator end = m_triggers.end();
@@ -253,6 +272,10 @@ void ParticleMgr::renderGroup(s32 p_group) const
 		}
 	}
 	
+#if defined(TT_PLATFORM_SDL)
+	queue->flush();
+#endif
+	
 	// Restore texture transform to play nice with other elements that are not
 	// using it...
 	renderer::MatrixStack::getInstance()->resetTextureMatrix();
@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <tt/engine/debug/DebugStats.h>
+#include <tt/engine/renderer/GLQuadRenderBackend.h>
+#include <tt/engine/renderer/GLStateCache.h>
+#include <tt/engine/renderer/MatrixStack.h>
+#include <tt/engine/renderer/Renderer.h>
+#include <tt/engine/renderer/Texture.h>
+#include <tt/engine/renderer/VertexBuffer.h>
+#include <tt/platform/tt_error.h>
+
+
+namespace tt {
+namespace engine {
+namespace renderer {
+
+#define BUFFER_OFFSET(bytes) ((GLubyte*)0 + (bytes))
+
+// Initial size of the stream buffer; 1.5 MB
+static const s32 g_initialStreamCapacity = 65536;
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+GLQuadRenderBackend::GLQuadRenderBackend()
+:
+QuadRenderBackend(),
+m_indexBuffer(0),
+m_streamBuffer(0),
+m_streamCapacity(g_initialStreamCapacity),
+m_streamOffset(0),
+m_inBegin(false),
+m_savedFogEnabled(false),
+m_savedSeparateAlphaBlendEnabled(false),
+m_savedBlendModeAlphaSrc(BlendFactor_Zero),
+m_savedBlendModeAlphaDst(BlendFactor_Zero)
+{
+	// Index buffer for the maximum number of quads per draw, shared by all vertex buffers
+	{
+		std::vector<u32> indices(MaxQuadsPerDraw * IndicesPerQuad);
+		u32 quadVertexIndex = 0;
+		for (std::vector<u32>::iterator it = indices.begin(); it != indices.end(); it += IndicesPerQuad)
+		{
+			// Quads are made out of 2 triangles like this:
+			//   0 -- 1
+			//   |  / |
+			//   | /  |
+			//   2 -- 3
+			
+			// FIXME: The triangles are created in opposite order. (One is CW and one is CCW.)
+			// First triangle (0 - 1 - 2)
+			it[0] = quadVertexIndex + 0;
+			it[1] = quadVertexIndex + 1;
+			it[2] = quadVertexIndex + 2;
+			
+			// Second triangle (1 - 2 - 3)
+			it[3] = quadVertexIndex + 1;
+			it[4] = quadVertexIndex + 2;
+			it[5] = quadVertexIndex + 3;
+			
+			quadVertexIndex += VerticesPerQuad;
+		}
+		
+		glGenBuffers(1, &m_indexBuffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(u32), &indices[0], GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+	
+	glGenBuffers(1, &m_streamBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_streamBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_streamCapacity * sizeof(QuadVertex), 0, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	
+	TT_CHECK_OPENGL_ERROR();
+}
+
+
+GLQuadRenderBackend::~GLQuadRenderBackend()
+{
+	glDeleteBuffers(1, &m_streamBuffer);
+	glDeleteBuffers(1, &m_indexBuffer);
+}
+
+
+void GLQuadRenderBackend::begin()
+{
+	TT_ASSERTMSG(m_inBegin == false, "GLQuadRenderBackend::begin called twice without end.");
+	Renderer* renderer = Renderer::getInstance();
+	
+	m_inBegin                        = true;
+	m_savedFogEnabled                = renderer->isFogEnabled();
+	m_savedSeparateAlphaBlendEnabled = renderer->hasSeparateAlphaBlendEnabled();
+	m_savedBlendModeAlphaSrc         = renderer->getCustomBlendModeAlphaSrc();
+	m_savedBlendModeAlphaDst         = renderer->getCustomBlendModeAlphaDst();
+	
+	invalidateState();
+}
+
+
+void GLQuadRenderBackend::end()
+{
+	TT_ASSERTMSG(m_inBegin, "GLQuadRenderBackend::end called without begin.");
+	Renderer* renderer = Renderer::getInstance();
+	
+	renderer->setFogEnabled(m_savedFogEnabled);
+	if (m_savedSeparateAlphaBlendEnabled)
+	{
+		renderer->setCustomBlendModeAlpha(m_savedBlendModeAlphaSrc, m_savedBlendModeAlphaDst);
+	}
+	else
+	{
+		renderer->resetCustomBlendModeAlpha();
+	}
+	
+	m_inBegin = false;
+	invalidateState();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Protected member functions
+
+QuadRenderBackend::BufferID GLQuadRenderBackend::doCreateRetainedBuffer(const QuadVertex* p_vertices,
+                                                                        s32               p_vertexCount)
+{
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ARRAY_BUFFER, p_vertexCount * sizeof(QuadVertex), p_vertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	
+	TT_CHECK_OPENGL_ERROR();
+	return static_cast<BufferID>(buffer);
+}
+
+
+void GLQuadRenderBackend::doDestroyRetainedBuffer(BufferID p_buffer)
+{
+	GLuint buffer = static_cast<GLuint>(p_buffer);
+	glDeleteBuffers(1, &buffer);
+}
+
+
+s32 GLQuadRenderBackend::doStreamVertices(const QuadVertex* p_vertices, s32 p_vertexCount)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, m_streamBuffer);
+	
+	if (p_vertexCount > m_streamCapacity)
+	{
+		m_streamCapacity = std::max(p_vertexCount, m_streamCapacity * 2);
+		glBufferData(GL_ARRAY_BUFFER, m_streamCapacity * sizeof(QuadVertex), 0, GL_STREAM_DRAW);
+		m_streamOffset = 0;
+	}
+	else if (m_streamOffset + p_vertexCount > m_streamCapacity)
+	{
+		// Orphan the storage still in use by the GPU and start at the front of fresh storage
+		glBufferData(GL_ARRAY_BUFFER, m_streamCapacity * sizeof(QuadVertex), 0, GL_STREAM_DRAW);
+		m_streamOffset = 0;
+	}
+	
+	glBufferSubData(GL_ARRAY_BUFFER, m_streamOffset * sizeof(QuadVertex),
+	                p_vertexCount * sizeof(QuadVertex), p_vertices);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	
+	const s32 firstVertex = m_streamOffset;
+	m_streamOffset += p_vertexCount;
+	return firstVertex;
+}
+
+
+void GLQuadRenderBackend::doSetState(const QuadRenderState& p_state)
+{
+	Renderer* renderer = Renderer::getInstance();
+	
+	renderer->setTexture(p_state.texture);
+	
+	u32 vertexType = 0;
+	if (p_state.vertexColor)  vertexType |= VertexBuffer::Property_Diffuse;
+	if (p_state.texture != 0) vertexType |= VertexBuffer::Property_Texture0;
+	renderer->setVertexType(vertexType);
+	
+	if (isValidBlendMode(p_state.blendMode) == false)
+	{
+		// Keep the blend and fog settings of the renderer
+		return;
+	}
+	TT_ASSERTMSG(m_inBegin, "Quads with a blend mode must be drawn between begin() and end().");
+	
+	renderer->setBlendMode(p_state.blendMode);
+	
+	// Start from the alpha blend mode at begin(), so overrides don't carry over to other states
+	if (m_savedSeparateAlphaBlendEnabled)
+	{
+		renderer->setCustomBlendModeAlpha(m_savedBlendModeAlphaSrc, m_savedBlendModeAlphaDst);
+	}
+	else
+	{
+		renderer->resetCustomBlendModeAlpha();
+	}
+	if (isValidBlendModeAlpha(p_state.blendModeAlpha))
+	{
+		renderer->setBlendModeAlpha(p_state.blendModeAlpha);
+	}
+	
+	// Enable/disable fog, only if fog is enabled in the renderer
+	if (m_savedFogEnabled)
+	{
+		renderer->setFogEnabled(p_state.fogEnabled);
+	}
+}
+
+
+void GLQuadRenderBackend::doDrawQuads(BufferID p_buffer, s32 p_firstVertex, s32 p_quadCount)
+{
+	// Apply current transform
+	MatrixStack::getInstance()->updateWorldMatrix();
+	
+	glBindBuffer(GL_ARRAY_BUFFER, p_buffer != 0 ? static_cast<GLuint>(p_buffer) : m_streamBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	
+	const GLsizei stride = sizeof(QuadVertex);
+	const size_t  base   = p_firstVertex * sizeof(QuadVertex);
+	glVertexPointer  (3, GL_FLOAT,         stride, BUFFER_OFFSET(base + offsetof(QuadVertex, position)));
+	glTexCoordPointer(2, GL_FLOAT,         stride, BUFFER_OFFSET(base + offsetof(QuadVertex, texCoord)));
+	glColorPointer   (4, GL_UNSIGNED_BYTE, stride, BUFFER_OFFSET(base + offsetof(QuadVertex, color)));
+	
+	Renderer::getInstance()->stateCache()->apply();
+	
+	glDrawElements(GL_TRIANGLES, p_quadCount * IndicesPerQuad, GL_UNSIGNED_INT, BUFFER_OFFSET(0));
+	
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	
+	TT_CHECK_OPENGL_ERROR();
+	
+	debug::DebugStats::addToQuadsRendered(p_quadCount);
+}
+
+// Namespace end
+}
+}
+}
@@ -1,12 +1,7 @@
 #include <tt/code/helpers.h>
-#include <tt/engine/debug/DebugStats.h>
-#include <tt/engine/opengl_headers.h>
-#include <tt/engine/renderer/MatrixStack.h>
 #include <tt/engine/renderer/QuadBuffer.h>
 #include <tt/engine/renderer/Renderer.h>
-#include <tt/engine/renderer/GLStateCache.h>
 #include <tt/engine/renderer/Texture.h>
-#include <tt/engine/renderer/VertexBuffer.h>
 #include <tt/mem/util.h>
 
 
@@ -16,18 +11,12 @@ namespace renderer {
 
 enum
 {
-	VerticesPerQuad  = 4
+	VerticesPerQuad = QuadRenderBackend::VerticesPerQuad
 };
 
 #ifdef __GNUC__
 const s32 QuadBuffer::maxBatchSize;
 #endif
-u32  QuadBuffer::ms_indexBuffer[QuadBuffer::maxBatchSize * IndicesPerQuad] = { 0 };
-bool QuadBuffer::ms_indexBufferInitialized = false;
-	
-// Possible Optimizations:
-// 1) Use VBOs
-// 2) Use GL_QUADS primitives (less indices needed)
 
 
 //--------------------------------------------------------------------------------------------------
@@ -39,41 +28,11 @@ m_useVtxColor((p_flag & BatchFlagQuad_UseVertexColor) == BatchFlagQuad_UseVertex
 m_capacity(std::min(p_size, maxBatchSize)),
 m_quadCount(0),
 m_texture(p_texture),
-m_vertexCoordinates(0),
-m_textureCoordinates(0),
-m_colors(0)
+m_vertices(0),
+m_dirty(true),
+m_retainedBackend(0),
+m_retainedBuffer(0)
 {
-	// Initialize the index buffer, if this was not done yet
-	if (ms_indexBufferInitialized == false)
-	{
-		u32* indexBuffer     = ms_indexBuffer;
-		u32  quadVertexIndex = 0;
-		for (s32 i = 0; i < maxBatchSize; ++i)
-		{
-			// Quads are made out of 2 triangles like this:
-			//   0 -- 1
-			//   |  / |
-			//   | /  |
-			//   2 -- 3
-			
-			// FIXME: The triangles are created in opposite order. (One is CW and one is CCW.)
-			// First triangle (0 - 1 - 2)
-			indexBuffer[0] = static_cast<u32>(quadVertexIndex + 0);
-			indexBuffer[1] = static_cast<u32>(quadVertexIndex + 1);
-			indexBuffer[2] = static_cast<u32>(quadVertexIndex + 2);
-			
-			// Second triangle (1 - 2 - 3)
-			indexBuffer[3] = static_cast<u32>(quadVertexIndex + 1);
-			indexBuffer[4] = static_cast<u32>(quadVertexIndex + 2);
-			indexBuffer[5] = static_cast<u32>(quadVertexIndex + 3);
-			
-			indexBuffer     += IndicesPerQuad;
-			quadVertexIndex += VerticesPerQuad;
-		}
-		
-		ms_indexBufferInitialized = true;
-	}
-	
 	// Sanity check the requested size
 	if (m_capacity <= 0)
 	{
@@ -84,25 +43,15 @@ m_colors(0)
 	             "Requested size (%d) exceeds maximum capacity (%d)!", p_size, maxBatchSize);
 	
 	// Allocate memory for the quad buffer
-	m_vertexCoordinates  = new math::Vector3[m_capacity * VerticesPerQuad];
-	m_textureCoordinates = new math::Vector2[m_capacity * VerticesPerQuad];
-	
-	mem::zero8(m_vertexCoordinates,  static_cast<mem::size_type>(m_capacity * VerticesPerQuad * sizeof(math::Vector3)));
-	mem::zero8(m_textureCoordinates, static_cast<mem::size_type>(m_capacity * VerticesPerQuad * sizeof(math::Vector2)));
-	
-	if (m_useVtxColor)
-	{
-		m_colors = new ColorRGBA[m_capacity * VerticesPerQuad];
-		mem::zero8(m_colors, static_cast<mem::size_type>(m_capacity * VerticesPerQuad * sizeof(ColorRGBA)));
-	}
+	m_vertices = new QuadVertex[m_capacity * VerticesPerQuad];
+	mem::zero8(m_vertices, static_cast<mem::size_type>(m_capacity * VerticesPerQuad * sizeof(QuadVertex)));
 }
 
 
 QuadBuffer::~QuadBuffer()
 {
-	code::helpers::safeDeleteArray(m_vertexCoordinates);
-	code::helpers::safeDeleteArray(m_textureCoordinates);
-	code::helpers::safeDeleteArray(m_colors);
+	releaseRetainedBuffer();
+	code::helpers::safeDeleteArray(m_vertices);
 }
 
 
@@ -117,38 +66,49 @@ void QuadBuffer::render() const
 	// Check if there is anything to do
 	if (m_quadCount <= 0) return;
 	
-	// Apply current transform
-	MatrixStack::getInstance()->updateWorldMatrix();
-	
-	Renderer* renderer = Renderer::getInstance();
-	
-	// Activate the batch texture
-	renderer->setTexture(m_texture);
+	QuadRenderBackend* backend = Renderer::getInstance()->getQuadRenderBackend();
 	
-	u32 vertexType = 0;
-	if (m_useVtxColor)  vertexType |= VertexBuffer::Property_Diffuse;
-	if (m_texture != 0) vertexType |= VertexBuffer::Property_Texture0;
-	renderer->setVertexType(vertexType);
+	// Other rendering may have changed the texture or vertex type since the previous draw
+	backend->invalidateState();
+	backend->setState(QuadRenderState(m_texture, m_useVtxColor));
+	draw(*backend);
+}
+
+
+void QuadBuffer::draw(QuadRenderBackend& p_backend) const
+{
+	if (m_quadCount <= 0) return;
 	
-	// Set up the correct format
-	if (m_useVtxColor)
+	const QuadRenderBackend::BufferID retained = acquireRetainedBuffer(p_backend);
+	if (retained != 0)
 	{
-		glColorPointer(4, GL_UNSIGNED_BYTE, 0, m_colors);
+		p_backend.drawQuads(retained, 0, m_quadCount);
 	}
-	
-	if (m_texture != 0)
+	else
 	{
-		glTexCoordPointer(2, GL_FLOAT, 0, m_textureCoordinates);
+		const s32 firstVertex = p_backend.streamVertices(m_vertices, m_quadCount * VerticesPerQuad);
+		p_backend.drawQuads(0, firstVertex, m_quadCount);
 	}
-	glVertexPointer(3, GL_FLOAT, 0, m_vertexCoordinates);
+}
 
-	renderer->stateCache()->apply();
 
-	glDrawElements(GL_TRIANGLES, m_quadCount * IndicesPerQuad, GL_UNSIGNED_INT, ms_indexBuffer);
-	
-	TT_CHECK_OPENGL_ERROR();
+QuadRenderBackend::BufferID QuadBuffer::acquireRetainedBuffer(QuadRenderBackend& p_backend) const
+{
+	if (m_dirty)
+	{
+		// Changed since the last draw; stream it this time
+		m_dirty = false;
+		return 0;
+	}
 	
-	debug::DebugStats::addToQuadsRendered(m_quadCount);
+	if (m_retainedBackend != &p_backend)
+	{
+		releaseRetainedBuffer();
+		m_retainedBuffer  = p_backend.createRetainedBuffer(m_vertices, m_quadCount * VerticesPerQuad);
+		m_retainedBackend = &p_backend;
+		p_backend.registerRetainer(const_cast<QuadBuffer*>(this));
+	}
+	return m_retainedBuffer;
 }
 
 
@@ -167,13 +127,9 @@ void QuadBuffer::fillBuffer(const BatchQuadCollection::iterator& p_begin, const
 void QuadBuffer::clear()
 { 
 	m_quadCount = 0;
-
-	mem::zero8(m_vertexCoordinates, static_cast<mem::size_type>(m_capacity * sizeof(math::Vector3)));
-	mem::zero8(m_textureCoordinates, static_cast<mem::size_type>(m_capacity * sizeof(math::Vector2)));
-	if (m_useVtxColor)
-	{
-		mem::zero8(m_colors, static_cast<mem::size_type>(m_capacity * sizeof(ColorRGBA)));
-	}
+	
+	mem::zero8(m_vertices, static_cast<mem::size_type>(m_capacity * VerticesPerQuad * sizeof(QuadVertex)));
+	markDirty();
 }
 
 	
@@ -192,49 +148,54 @@ void QuadBuffer::copyToInternalBuffers(const BatchQuadCollection::const_iterator
 	}
 	
 	m_quadCount = neededSpace;
+	markDirty();
 	
-	// Iterate the quads from the collection and add the required information to the arrays
-	s32 vertexIndex = p_startIndex * VerticesPerQuad;
+	// Iterate the quads from the collection and add the required information to the array
+	QuadVertex* vertex = m_vertices + p_startIndex * VerticesPerQuad;
 	
 	for (BatchQuadCollection::const_iterator it = p_begin; it != p_end; ++it)
 	{
-		// Top-left
-		m_vertexCoordinates [vertexIndex] = (*it).topLeft.getPosition();
-		m_textureCoordinates[vertexIndex] = (*it).topLeft.getTexCoord();
-		if (m_useVtxColor)
-		{
-			m_colors[vertexIndex] = (*it).topLeft.getColor();
-		}
-		++vertexIndex;
+		const BufferVtx* corners[VerticesPerQuad] =
+			{ &(*it).topLeft, &(*it).topRight, &(*it).bottomLeft, &(*it).bottomRight };
 		
-		// Top-right
-		m_vertexCoordinates [vertexIndex] = (*it).topRight.getPosition();
-		m_textureCoordinates[vertexIndex] = (*it).topRight.getTexCoord();
-		if (m_useVtxColor)
+		for (s32 i = 0; i < VerticesPerQuad; ++i, ++vertex)
 		{
-			m_colors[vertexIndex] = (*it).topRight.getColor();
+			vertex->position = corners[i]->getPosition();
+			vertex->texCoord = corners[i]->getTexCoord();
+			if (m_useVtxColor)
+			{
+				vertex->color = corners[i]->getColor();
+			}
 		}
-		++vertexIndex;
-		
-		// Bottom-left
-		m_vertexCoordinates [vertexIndex] = (*it).bottomLeft.getPosition();
-		m_textureCoordinates[vertexIndex] = (*it).bottomLeft.getTexCoord();
-		if (m_useVtxColor)
-		{
-			m_colors[vertexIndex] = (*it).bottomLeft.getColor();
-		}
-		++vertexIndex;
-		
-		// Bottom-right
-		m_vertexCoordinates [vertexIndex] = (*it).bottomRight.getPosition();
-		m_textureCoordinates[vertexIndex] = (*it).bottomRight.getTexCoord();
-		if (m_useVtxColor)
-		{
-			m_colors[vertexIndex] = (*it).bottomRight.getColor();
-		}
-		++vertexIndex;
 	}
 }
+
+
+void QuadBuffer::markDirty()
+{
+	m_dirty = true;
+	releaseRetainedBuffer();
+}
+
+
+void QuadBuffer::releaseRetainedBuffer() const
+{
+	if (m_retainedBackend != 0)
+	{
+		m_retainedBackend->destroyRetainedBuffer(m_retainedBuffer);
+		m_retainedBackend->unregisterRetainer(const_cast<QuadBuffer*>(this));
+		m_retainedBackend = 0;
+		m_retainedBuffer  = 0;
+	}
+}
+
+
+void QuadBuffer::onBackendDestroyed() const
+{
+	// The buffer went away with the backend
+	m_retainedBackend = 0;
+	m_retainedBuffer  = 0;
+}
 	
 	
 // Namespace end
@@ -0,0 +1,110 @@
+#include <tt/engine/renderer/QuadBuffer.h>
+#include <tt/engine/renderer/QuadRenderBackend.h>
+#include <tt/platform/tt_error.h>
+
+
+namespace tt {
+namespace engine {
+namespace renderer {
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+QuadRenderBackend::~QuadRenderBackend()
+{
+	// Copy; QuadBuffers unregister themselves
+	const std::set<QuadBuffer*> retainers(m_retainers);
+	for (std::set<QuadBuffer*>::const_iterator it = retainers.begin(); it != retainers.end(); ++it)
+	{
+		(*it)->onBackendDestroyed();
+	}
+}
+
+
+QuadRenderBackend::BufferID QuadRenderBackend::createRetainedBuffer(const QuadVertex* p_vertices,
+                                                                    s32               p_vertexCount)
+{
+	TT_NULL_ASSERT(p_vertices);
+	TT_ASSERT(p_vertexCount > 0);
+	
+	++m_stats.retainedBuffers;
+	m_stats.bytesUploaded += static_cast<u64>(p_vertexCount) * sizeof(QuadVertex);
+	return doCreateRetainedBuffer(p_vertices, p_vertexCount);
+}
+
+
+void QuadRenderBackend::destroyRetainedBuffer(BufferID p_buffer)
+{
+	if (p_buffer != 0)
+	{
+		doDestroyRetainedBuffer(p_buffer);
+	}
+}
+
+
+s32 QuadRenderBackend::streamVertices(const QuadVertex* p_vertices, s32 p_vertexCount)
+{
+	TT_NULL_ASSERT(p_vertices);
+	TT_ASSERT(p_vertexCount > 0);
+	
+	m_stats.bytesUploaded += static_cast<u64>(p_vertexCount) * sizeof(QuadVertex);
+	return doStreamVertices(p_vertices, p_vertexCount);
+}
+
+
+void QuadRenderBackend::setState(const QuadRenderState& p_state)
+{
+	if (m_hasState && m_state == p_state)
+	{
+		return;
+	}
+	
+	++m_stats.stateChanges;
+	m_state    = p_state;
+	m_hasState = true;
+	doSetState(p_state);
+}
+
+
+void QuadRenderBackend::drawQuads(BufferID p_buffer, s32 p_firstVertex, s32 p_quadCount)
+{
+	TT_ASSERTMSG(m_hasState, "QuadRenderBackend::drawQuads called without setting a state first.");
+	TT_ASSERT(p_quadCount > 0 && p_quadCount <= MaxQuadsPerDraw);
+	
+	++m_stats.drawCalls;
+	m_stats.quadsDrawn += p_quadCount;
+	doDrawQuads(p_buffer, p_firstVertex, p_quadCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Protected member functions
+
+QuadRenderBackend::QuadRenderBackend()
+:
+m_stats(),
+m_state(),
+m_hasState(false),
+m_retainers()
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+void QuadRenderBackend::registerRetainer(QuadBuffer* p_buffer)
+{
+	m_retainers.insert(p_buffer);
+}
+
+
+void QuadRenderBackend::unregisterRetainer(QuadBuffer* p_buffer)
+{
+	m_retainers.erase(p_buffer);
+}
+
+// Namespace end
+}
+}
+}
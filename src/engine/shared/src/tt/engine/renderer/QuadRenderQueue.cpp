@@ -0,0 +1,161 @@
+#include <algorithm>
+
+#include <tt/engine/renderer/QuadBuffer.h>
+#include <tt/engine/renderer/QuadRenderQueue.h>
+#include <tt/platform/tt_error.h>
+
+
+namespace tt {
+namespace engine {
+namespace renderer {
+
+// Sort key layout: | pass (8 bits) | group (32 bits) | state (24 bits) |
+static const u32 g_maxStates = 1 << 24;
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+QuadRenderQueue::QuadRenderQueue(QuadRenderBackend* p_backend)
+:
+m_backend(p_backend),
+m_recording(false),
+m_items(),
+m_states(),
+m_group(0),
+m_groupIsCommutative(false),
+m_pendingVertices(),
+m_pendingState(-1)
+{
+	TT_NULL_ASSERT(m_backend);
+}
+
+
+void QuadRenderQueue::begin()
+{
+	TT_ASSERTMSG(m_recording == false, "QuadRenderQueue::begin called while already recording.");
+	m_recording          = true;
+	m_group              = 0;
+	m_groupIsCommutative = false;
+}
+
+
+void QuadRenderQueue::submit(const QuadBuffer& p_buffer, BlendMode p_blendMode, BlendModeAlpha p_blendModeAlpha,
+                             bool p_fogEnabled, u8 p_pass)
+{
+	TT_ASSERTMSG(m_recording, "QuadRenderQueue::submit called outside begin/flush.");
+	TT_ASSERT(isValidBlendMode(p_blendMode));
+	if (p_buffer.getQuadCount() <= 0)
+	{
+		return;
+	}
+	
+	QuadRenderState state(p_buffer.getTexture(), p_buffer.usesVertexColor());
+	state.blendMode      = p_blendMode;
+	state.blendModeAlpha = p_blendModeAlpha;
+	state.fogEnabled     = p_fogEnabled;
+	
+	// Additive color blending gives the same result in any order; with an alpha override it doesn't
+	const bool commutative = p_blendMode == BlendMode_Add && p_blendModeAlpha == BlendModeAlpha_NoOverride;
+	if (commutative == false || m_groupIsCommutative == false)
+	{
+		++m_group;
+	}
+	m_groupIsCommutative = commutative;
+	
+	// Non-commutative draws each get their own group, so their state index doesn't affect the order
+	const u32 stateIndex = static_cast<u32>(getStateIndex(state));
+	
+	Item item;
+	item.key    = (static_cast<u64>(p_pass) << 56) | (static_cast<u64>(m_group) << 24) | stateIndex;
+	item.buffer = &p_buffer;
+	m_items.push_back(item);
+}
+
+
+void QuadRenderQueue::flush()
+{
+	TT_ASSERTMSG(m_recording, "QuadRenderQueue::flush called without begin.");
+	m_recording = false;
+	
+	if (m_items.empty())
+	{
+		m_states.clear();
+		return;
+	}
+	
+	std::stable_sort(m_items.begin(), m_items.end(), SortOnKey());
+	
+	m_backend->begin();
+	
+	for (Items::const_iterator it = m_items.begin(); it != m_items.end(); ++it)
+	{
+		const s32         stateIndex = static_cast<s32>(it->key & (g_maxStates - 1));
+		const QuadBuffer& buffer     = *it->buffer;
+		const s32         quadCount  = buffer.getQuadCount();
+		const s32         vtxCount   = quadCount * QuadRenderBackend::VerticesPerQuad;
+		
+		const QuadRenderBackend::BufferID retained = buffer.acquireRetainedBuffer(*m_backend);
+		if (retained != 0)
+		{
+			drawPending();
+			m_backend->setState(m_states[stateIndex]);
+			m_backend->drawQuads(retained, 0, quadCount);
+			continue;
+		}
+		
+		if (stateIndex != m_pendingState ||
+		    static_cast<s32>(m_pendingVertices.size()) + vtxCount >
+		    QuadRenderBackend::MaxQuadsPerDraw * QuadRenderBackend::VerticesPerQuad)
+		{
+			drawPending();
+			m_pendingState = stateIndex;
+		}
+		m_pendingVertices.insert(m_pendingVertices.end(), buffer.getVertices(), buffer.getVertices() + vtxCount);
+	}
+	drawPending();
+	
+	m_backend->end();
+	
+	m_items.clear();
+	m_states.clear();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+s32 QuadRenderQueue::getStateIndex(const QuadRenderState& p_state)
+{
+	// Few distinct states per frame; search from the back as neighbours usually match
+	for (s32 i = static_cast<s32>(m_states.size()) - 1; i >= 0; --i)
+	{
+		if (m_states[i] == p_state)
+		{
+			return i;
+		}
+	}
+	
+	TT_ASSERT(m_states.size() < g_maxStates);
+	m_states.push_back(p_state);
+	return static_cast<s32>(m_states.size()) - 1;
+}
+
+
+void QuadRenderQueue::drawPending()
+{
+	if (m_pendingVertices.empty() == false)
+	{
+		const s32 vtxCount    = static_cast<s32>(m_pendingVertices.size());
+		const s32 firstVertex = m_backend->streamVertices(&m_pendingVertices[0], vtxCount);
+		m_backend->setState(m_states[m_pendingState]);
+		m_backend->drawQuads(0, firstVertex, vtxCount / QuadRenderBackend::VerticesPerQuad);
+		m_pendingVertices.clear();
+	}
+	m_pendingState = -1;
+}
+
+// Namespace end
+}
+}
+}
@@ -4,10 +4,12 @@
 #include <tt/engine/file/FileUtils.h>
 #include <tt/engine/renderer/FixedFunction.h>
 #include <tt/engine/renderer/FullscreenTriangle.h>
+#include <tt/engine/renderer/GLQuadRenderBackend.h>
 #include <tt/engine/renderer/Material.h>
 #include <tt/engine/renderer/MatrixStack.h>
 #include <tt/engine/renderer/MultiTexture.h>
 #include <tt/engine/renderer/OpenGLContextWrapper.h>
+#include <tt/engine/renderer/QuadRenderQueue.h>
 #include "tt/engine/renderer/GLStateCache.h"
 #include <tt/engine/renderer/RenderTarget.h>
 #include <tt/engine/renderer/Renderer.h>
@@ -1281,7 +1283,9 @@ m_threadID(SDL_ThreadID()),
 #else
 m_threadID(pthread_self()),
 #endif
-m_stateCache(new GLStateCache)
+m_stateCache(new GLStateCache),
+m_quadRenderBackend(0),
+m_quadRenderQueue(0)
 {
 	// this is needed so it is assigned early as code below indirectly calls into FixedFunctionHardware which wants an instance of the renderer to access the state cache.
 	ms_instance = this;
@@ -1312,6 +1316,9 @@ m_stateCache(new GLStateCache)
 	// Set states
 	setDefaultStates(false);
 	FullscreenTriangle::create();
+	
+	m_quadRenderBackend = new GLQuadRenderBackend;
+	m_quadRenderQueue   = new QuadRenderQueue(m_quadRenderBackend);
 }
 
 
@@ -1326,6 +1333,9 @@ Renderer::~Renderer()
 	MatrixStack::destroyInstance();
 	
 	FullscreenTriangle::destroy();
+	
+	delete m_quadRenderQueue;
+	delete m_quadRenderBackend;
 
 	// Destroy GLStateCache
 	delete m_stateCache;
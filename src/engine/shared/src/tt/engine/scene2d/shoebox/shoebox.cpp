@@ -224,7 +224,7 @@ void Shoebox::copyNeededTextures(const renderer::EngineIDToTextures& p_textures)
 		for (ShoeboxData::Planes::iterator planeIt = m_loadedData->planes.begin();
 		     planeIt != m_loadedData->planes.end(); ++planeIt)
 		{
-			EngineID engineID(getEngineID(planeIt->textureFilename));
+			EngineID engineID(planeIt->getTextureEngineID());
 			
 			// If not yet in needed list.
 			if (neededTextures.find(engineID.getValue()) == neededTextures.end())
@@ -457,6 +457,17 @@ renderer::TexturePtr Shoebox::addToTextureCache(const std::string& p_filename)
 }
 
 
+renderer::TexturePtr Shoebox::addToTextureCache(const PlaneData& p_plane)
+{
+	renderer::EngineIDToTextures::value_type pair = createTextureCacheEntry(p_plane);
+	if (pair.second != 0)
+	{
+		m_textures.insert(pair);
+	}
+	return pair.second;
+}
+
+
 void Shoebox::setBlurQuality(BlurQuality p_quality)
 {
 	if (p_quality != m_frontBlurQuality || p_quality != m_backBlurQuality)
@@ -536,7 +547,7 @@ void Shoebox::loadAndCreateIncludes(const ShoeboxData& p_data, const CreationCon
 		if (isAllowedToLoadForDeviceType(filename))
 		{
 			TT_ERR_CREATE("Load shoebox include '" << filename << "'.");
-			ShoeboxDataPtr includedData = ShoeboxData::parse(filename, &errStatus);
+			ShoeboxDataPtr includedData = ShoeboxData::parseInclude(filename, &errStatus);
 			TT_ERR_ASSERT_ON_ERROR();
 			if (errStatus.hasError())
 			{
@@ -595,7 +606,7 @@ void Shoebox::createFromData(const ShoeboxData& p_data, const CreationContext& p
 
 void Shoebox::createPlane(const PlaneData& p_plane, const CreationContext& p_context)
 {
-	renderer::TexturePtr texturePtr(addToTextureCache(p_plane.textureFilename));
+	renderer::TexturePtr texturePtr(addToTextureCache(p_plane));
 	if (texturePtr == 0)
 	{
 		TT_PANIC("Can't add plane because texture '%s' could not be loaded.",
@@ -963,12 +974,12 @@ void Shoebox::getAllUsedTextures(const ShoeboxDataPtr& p_data, renderer::EngineI
 	// Get textures from this shoebox
 	for (ShoeboxData::Planes::const_iterator it = p_data->planes.begin(); it != p_data->planes.end(); ++it)
 	{
-		EngineID engineID(getEngineID(it->textureFilename));
+		EngineID engineID(it->getTextureEngineID());
 		
 		// If not yet in needed list.
 		if (p_usedTextures.find(engineID.getValue()) == p_usedTextures.end())
 		{
-			p_usedTextures.insert(createTextureCacheEntry(it->textureFilename));
+			p_usedTextures.insert(createTextureCacheEntry(*it));
 		}
 	}
 	
@@ -984,7 +995,7 @@ void Shoebox::getAllUsedTextures(const ShoeboxDataPtr& p_data, renderer::EngineI
 			if (isAllowedToLoadForDeviceType(filename))
 			{
 				TT_ERR_CREATE("Load shoebox include '" << filename << "'.");
-				ShoeboxDataPtr includedData = ShoeboxData::parse(filename, &errStatus);
+				ShoeboxDataPtr includedData = ShoeboxData::parseInclude(filename, &errStatus);
 				TT_ERR_ASSERT_ON_ERROR();
 				if (errStatus.hasError())
 				{
@@ -1,3 +1,5 @@
+#include <map>
+
 #include <tt/code/bufferutils.h>
 #include <tt/code/ErrorStatus.h>
 #include <tt/code/helpers.h>
@@ -12,6 +14,8 @@
 #include <tt/fs/File.h>
 #include <tt/fs/fs.h>
 #include <tt/str/str.h>
+#include <tt/thread/CriticalSection.h>
+#include <tt/thread/Mutex.h>
 #include <tt/xml/util/check.h>
 #include <tt/xml/util/parse.h>
 #include <tt/xml/util/store.h>
@@ -30,6 +34,11 @@ namespace shoebox {
 
 static const u16 g_shoeboxDataVersion = MAKE_VERSION(1, 15);
 
+// Parsed include files, shared by all shoeboxes that include them
+typedef std::map<std::string, ShoeboxDataPtr> ParsedIncludes;
+static ParsedIncludes g_parsedIncludes;
+static thread::Mutex  g_parsedIncludesMutex;
+
 
 //--------------------------------------------------------------------------------------------------
 // Helper functions (TODO: Move this to engine/ xml parse)
@@ -548,6 +557,12 @@ PlaneData PlaneData::parse(const u8*& p_bufferOUT, size_t& p_sizeOUT, code::Erro
 }
 
 
+EngineID PlaneData::getTextureEngineID() const
+{
+	return textureEngineID.valid() ? textureEngineID : getEngineID(textureFilename);
+}
+
+
 void PlaneData::loadPlane(const xml::XmlNode* p_node, code::ErrorStatus* p_errStatus)
 {
 	TT_ERR_CHAIN_VOID("Parsing Plane Data");
@@ -565,6 +580,7 @@ void PlaneData::loadPlane(const xml::XmlNode* p_node, code::ErrorStatus* p_errSt
 	}
 	
 	textureFilename = xml::util::parseStr(p_node, "texture", &errStatus);
+	textureEngineID = getEngineID(textureFilename);
 	
 	if (p_node->getFirstChild("animations") != 0)
 	{
@@ -775,6 +791,7 @@ void PlaneData::loadPlane(const u8*& p_bufferOUT, size_t& p_sizeOUT, code::Error
 	id              = bu::be_get<std::string>(p_bufferOUT, p_sizeOUT);
 	TT_ERR_ASSERTMSG(p_sizeOUT >= 2, "Buffer too small");
 	textureFilename = bu::be_get<std::string>(p_bufferOUT, p_sizeOUT);
+	textureEngineID = getEngineID(textureFilename);
 	
 	TT_ERR_ASSERTMSG(p_sizeOUT >= s_size, "Buffer too small");
 	
@@ -1158,6 +1175,34 @@ ShoeboxDataPtr ShoeboxData::parse(const u8*& p_buffer, size_t& p_size, code::Err
 }
 
 
+ShoeboxDataPtr ShoeboxData::parseInclude(const std::string& p_filename, code::ErrorStatus* p_errStatus)
+{
+	{
+		thread::CriticalSection criticalSection(&g_parsedIncludesMutex);
+		ParsedIncludes::const_iterator it = g_parsedIncludes.find(p_filename);
+		if (it != g_parsedIncludes.end())
+		{
+			return (*it).second;
+		}
+	}
+	
+	ShoeboxDataPtr data(parse(p_filename, p_errStatus));
+	if (data != 0)
+	{
+		thread::CriticalSection criticalSection(&g_parsedIncludesMutex);
+		g_parsedIncludes[p_filename] = data;
+	}
+	return data;
+}
+
+
+void ShoeboxData::clearIncludeCache()
+{
+	thread::CriticalSection criticalSection(&g_parsedIncludesMutex);
+	g_parsedIncludes.clear();
+}
+
+
 void ShoeboxData::saveAsXML(const std::string& p_filename, bool p_formatted, code::ErrorStatus* p_errStatus) const
 {
 	TT_ERR_CHAIN_VOID("Save shoebox as XML file '" << p_filename << "'");
@@ -1591,12 +1636,12 @@ void getAllUsedTextures(const ShoeboxDataPtr& p_data, renderer::EngineIDToTextur
 	// Get textures from this shoebox
 	for (ShoeboxData::Planes::const_iterator it = p_data->planes.begin(); it != p_data->planes.end(); ++it)
 	{
-		EngineID engineID(getEngineID(it->textureFilename));
+		EngineID engineID(it->getTextureEngineID());
 		
 		// If not yet in needed list.
 		if (p_usedTextures.find(engineID.getValue()) == p_usedTextures.end())
 		{
-			p_usedTextures.insert(createTextureCacheEntry(it->textureFilename));
+			p_usedTextures.insert(createTextureCacheEntry(*it));
 		}
 	}
 	
@@ -1612,7 +1657,7 @@ void getAllUsedTextures(const ShoeboxDataPtr& p_data, renderer::EngineIDToTextur
 			//if (isAllowedToLoadForDeviceType(filename)) // FIXME: what to do with this Shoebox functions?
 			{
 				TT_ERR_CREATE("Load shoebox include '" << filename << "'.");
-				ShoeboxDataPtr includedData = ShoeboxData::parse(filename, &errStatus);
+				ShoeboxDataPtr includedData = ShoeboxData::parseInclude(filename, &errStatus);
 				TT_ERR_ASSERT_ON_ERROR();
 				if (errStatus.hasError())
 				{
@@ -1637,7 +1682,7 @@ void getAllUsedEngineIDs(const ShoeboxDataPtr& p_data, EngineIDValues& p_engineI
 	// Get textures from this shoebox
 	for (ShoeboxData::Planes::const_iterator it = p_data->planes.begin(); it != p_data->planes.end(); ++it)
 	{
-		EngineID engineID(getEngineID(it->textureFilename));
+		EngineID engineID(it->getTextureEngineID());
 		u64 idValue = engineID.getValue();
 		// If not yet in needed list.
 		if (p_engineIDs.find(idValue) == p_engineIDs.end())
@@ -1657,7 +1702,7 @@ void getAllUsedEngineIDs(const ShoeboxDataPtr& p_data, EngineIDValues& p_engineI
 			//if (isAllowedToLoadForDeviceType(filename)) // FIXME: what to do with this Shoebox functions?
 			{
 				TT_ERR_CREATE("Load shoebox include '" << filename << "'.");
-				ShoeboxDataPtr includedData = ShoeboxData::parse(filename, &errStatus);
+				ShoeboxDataPtr includedData = ShoeboxData::parseInclude(filename, &errStatus);
 				TT_ERR_ASSERT_ON_ERROR();
 				if (errStatus.hasError())
 				{
@@ -1742,10 +1787,10 @@ EngineID getEngineID(const std::string& p_filename)
 }
 
 
-renderer::EngineIDToTextures::value_type createTextureCacheEntry(const std::string& p_filename)
+static renderer::EngineIDToTextures::value_type createTextureCacheEntry(const EngineID&    p_engineID,
+                                                                        const std::string& p_filename)
 {
-	EngineID engineID(getEngineID(p_filename));
-	u64 idValue = engineID.getValue();
+	u64 idValue = p_engineID.getValue();
 	
 	if (idValue == 0)
 	{
@@ -1754,7 +1799,7 @@ renderer::EngineIDToTextures::value_type createTextureCacheEntry(const std::stri
 	
 	// Load the texture
 	// FIXME: Add namespaces to shoebox data
-	renderer::TexturePtr texture = renderer::TextureCache::get(engineID, false);
+	renderer::TexturePtr texture = renderer::TextureCache::get(p_engineID, false);
 	
 	if (texture == 0)
 	{
@@ -1766,6 +1811,18 @@ renderer::EngineIDToTextures::value_type createTextureCacheEntry(const std::stri
 }
 
 
+renderer::EngineIDToTextures::value_type createTextureCacheEntry(const std::string& p_filename)
+{
+	return createTextureCacheEntry(getEngineID(p_filename), p_filename);
+}
+
+
+renderer::EngineIDToTextures::value_type createTextureCacheEntry(const PlaneData& p_plane)
+{
+	return createTextureCacheEntry(p_plane.getTextureEngineID(), p_plane.textureFilename);
+}
+
+
 
 // Namespace end
 }
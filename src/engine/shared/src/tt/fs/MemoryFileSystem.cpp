@@ -4,6 +4,7 @@
 #include <tt/fs/File.h>
 #include <tt/fs/MemoryArchive.h>
 #include <tt/fs/MemoryFileSystem.h>
+#include <tt/fs/PackArchive.h>
 #include <tt/mem/util.h>
 #include <tt/platform/tt_printf.h>
 
@@ -11,7 +12,8 @@
 namespace tt {
 namespace fs {
 
-MemoryFileSystem::Archives MemoryFileSystem::ms_archives;
+MemoryFileSystem::Archives     MemoryFileSystem::ms_archives;
+MemoryFileSystem::PackArchives MemoryFileSystem::ms_packArchives;
 bool                       MemoryFileSystem::ms_isInstantiated = false;
 s32                        MemoryFileSystem::ms_id = -1;
 
@@ -117,6 +119,14 @@ bool MemoryFileSystem::open(const FilePtr& p_file, const std::string& p_path, Op
 				break;
 			}
 		}
+		
+		for (PackArchives::iterator it = ms_packArchives.begin();
+		     archiveFile.content == 0 && it != ms_packArchives.end(); ++it)
+		{
+			const PackArchive::File packFile((*it)->getFile(p_path));
+			archiveFile.content   = packFile.content;
+			archiveFile.writeTime = packFile.writeTime;
+		}
 	}
 	
 	MemInternal* intern = new MemInternal;
@@ -579,6 +589,14 @@ bool MemoryFileSystem::fileExists(const std::string& p_path)
 		}
 	}
 	
+	for (PackArchives::iterator it = ms_packArchives.begin(); it != ms_packArchives.end(); ++it)
+	{
+		if ((*it)->hasFile(p_path))
+		{
+			return true;
+		}
+	}
+	
 	// Not found in this FS; passthrough
 	return fs::fileExists(p_path, getSourceID());
 }
@@ -610,6 +628,30 @@ bool MemoryFileSystem::removeMemoryArchive(MemoryArchive* p_archive)
 }
 
 
+bool MemoryFileSystem::addPackArchive(PackArchive* p_archive)
+{
+	ms_packArchives.push_back(p_archive);
+	return true;
+}
+
+
+bool MemoryFileSystem::removePackArchive(PackArchive* p_archive)
+{
+	PackArchives::iterator it = std::find(ms_packArchives.begin(),
+	                                      ms_packArchives.end(),
+	                                      p_archive);
+	
+	if (it == ms_packArchives.end())
+	{
+		TT_PANIC("Attempt to unregister unregistered archive.");
+		return false;
+	}
+	
+	ms_packArchives.erase(it);
+	return true;
+}
+
+
 // Private functions
 
 MemoryFileSystem::MemoryFileSystem(identifier p_id, identifier p_source)
@@ -0,0 +1,564 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <tt/code/bufferutils.h>
+#include <tt/compression/fastlz.h>
+#include <tt/compression/lzma.h>
+#include <tt/compression/lz4/lz4.h>
+#include <tt/compression/lz4/lz4hc.h>
+#include <tt/fs/File.h>
+#include <tt/fs/fs.h>
+#include <tt/fs/MappedFile.h>
+#include <tt/fs/PackArchive.h>
+#include <tt/math/hash/Hash.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+#include <tt/thread/CriticalSection.h>
+
+
+namespace tt {
+namespace fs {
+
+// NOTE: Same signature scheme as the memory archive (see MemoryArchive.cpp), with different signature bytes.
+const size_t g_packSignatureLength = 9;
+const u8     g_packSignature[g_packSignatureLength] =
+{
+	0x89,
+	'P', 'A', 'C', 'K',
+	0x0D, 0x0A,
+	0x1A,
+	0x0A
+};
+const u32    g_packVersion = 1;
+
+// Signature, version, file count and path table offset
+const u32    g_packHeaderSize = static_cast<u32>(g_packSignatureLength) + 3 * sizeof(u32);
+
+// Hash, offset, stored size, size, write time, path offset, compression type and padding
+const u32    g_packEntrySize  = 32;
+
+typedef tt::math::hash::Hash<32> NameHash;
+
+
+struct PackFileToWrite
+{
+	PackFileToWrite()
+	:
+	hash(0),
+	path(),
+	writeTime(0),
+	size(0),
+	compressionType(MemoryArchive::CompressionType_None),
+	content(),
+	offset(0),
+	pathOffset(0)
+	{ }
+	
+	u32                            hash;
+	std::string                    path;
+	fs::time_type                  writeTime;
+	u32                            size;
+	MemoryArchive::CompressionType compressionType;
+	code::BufferPtr                content;   // As it is stored in the archive
+	u32                            offset;
+	u32                            pathOffset;
+};
+typedef std::vector<PackFileToWrite> PackFilesToWrite;
+
+
+struct PackFileHashLess
+{
+	inline bool operator()(const PackFileToWrite& p_lhs, const PackFileToWrite& p_rhs) const
+	{
+		return p_lhs.hash < p_rhs.hash;
+	}
+};
+
+
+static u32 alignPackOffset(u32 p_value, u32 p_alignment)
+{
+	if ((p_value % p_alignment) != 0)
+	{
+		p_value += p_alignment - (p_value % p_alignment);
+	}
+	
+	return p_value;
+}
+
+
+static bool writePadding(const fs::FilePtr& p_file, u32 p_from, u32 p_to)
+{
+	TT_ASSERT(p_from <= p_to);
+	for (u32 i = p_from; i < p_to; ++i)
+	{
+		if (fs::writeInteger<u8>(p_file, 0) == false)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/*! \return The compressed content or null if compressing failed or didn't make the file any smaller. */
+static code::BufferPtr compressPackFile(const code::BufferPtr&        p_content,
+                                        MemoryArchive::CompressionType p_compressionType)
+{
+	const u32 size = static_cast<u32>(p_content->getSize());
+	if (p_compressionType == MemoryArchive::CompressionType_None || size == 0)
+	{
+		return code::BufferPtr();
+	}
+	
+	// Room for the worst case of all compressors (data that doesn't compress)
+	const u32 capacity = size + size / 16 + 64;
+	code::BufferPtrForCreator result(new code::Buffer(static_cast<code::Buffer::size_type>(capacity)));
+	
+	const void* input  = p_content->getData();
+	void*       output = result->getData();
+	u32 compressedSize = 0;
+	switch (p_compressionType)
+	{
+	case MemoryArchive::CompressionType_FastLZ:
+		compressedSize = static_cast<u32>(fastlz_compress_level(2, input, static_cast<int>(size), output));
+		break;
+		
+	case MemoryArchive::CompressionType_LZMA:
+		compressedSize = lzma_compress(input, size, output, 9, 1024 * 1024);
+		break;
+		
+	case MemoryArchive::CompressionType_LZ4:
+		compressedSize = static_cast<u32>(LZ4_compress_default(static_cast<const char*>(input),
+			static_cast<char*>(output), static_cast<int>(size), static_cast<int>(capacity)));
+		break;
+		
+	case MemoryArchive::CompressionType_LZ4HC:
+		compressedSize = static_cast<u32>(LZ4_compress_HC(static_cast<const char*>(input),
+			static_cast<char*>(output), static_cast<int>(size), static_cast<int>(capacity),
+			LZ4HC_CLEVEL_DEFAULT));
+		break;
+		
+	default:
+		TT_PANIC("Unsupported compression type '%d'", p_compressionType);
+		return code::BufferPtr();
+	}
+	
+	if (compressedSize == 0 || compressedSize >= size)
+	{
+		return code::BufferPtr();
+	}
+	
+	result->setSize(static_cast<code::Buffer::size_type>(compressedSize));
+	return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+PackArchive::~PackArchive()
+{
+}
+
+
+PackArchivePtr PackArchive::load(const std::string& p_path, size_type p_cacheSize)
+{
+	MappedFilePtr file = MappedFile::open(p_path);
+	if (file == 0)
+	{
+		TT_WARN("Couldn't load pack archive '%s'. File couldn't be mapped.", p_path.c_str());
+		return PackArchivePtr();
+	}
+	
+	if (file->getSize() < static_cast<size_type>(g_packHeaderSize))
+	{
+		TT_PANIC("Pack archive file '%s' is too small to be a pack archive.", p_path.c_str());
+		return PackArchivePtr();
+	}
+	
+	namespace bu = code::bufferutils;
+	const u8* cursor    = file->getData();
+	size_t    remaining = static_cast<size_t>(file->getSize());
+	
+	// Verify signature
+	if (std::memcmp(cursor, g_packSignature, g_packSignatureLength) != 0)
+	{
+		TT_PANIC("Pack archive file '%s' doesn't have valid signature.", p_path.c_str());
+		return PackArchivePtr();
+	}
+	cursor    += g_packSignatureLength;
+	remaining -= g_packSignatureLength;
+	
+	// Verify version
+	const u32 dataVersion = bu::get<u32>(cursor, remaining);
+	if (dataVersion != g_packVersion)
+	{
+		TT_PANIC("Pack archive file '%s' file format is not the expected version. "
+		         "Loaded version %u, expected version %u.", p_path.c_str(),
+		         dataVersion, g_packVersion);
+		return PackArchivePtr();
+	}
+	
+	const u32 fileCount       = bu::get<u32>(cursor, remaining);
+	const u32 pathTableOffset = bu::get<u32>(cursor, remaining);
+	
+	// The index isn't read; lookups search it in the mapping
+	if (pathTableOffset != g_packHeaderSize + fileCount * g_packEntrySize ||
+	    pathTableOffset > static_cast<u32>(file->getSize()))
+	{
+		TT_PANIC("Pack archive file '%s' is corrupt: its index doesn't fit.", p_path.c_str());
+		return PackArchivePtr();
+	}
+	
+	return PackArchivePtr(new PackArchive(file, static_cast<s32>(fileCount), pathTableOffset, p_cacheSize));
+}
+
+
+bool PackArchive::save(const std::string&             p_path,
+                       const MemoryArchive&           p_source,
+                       MemoryArchive::CompressionType p_compressionType,
+                       u32                            p_fileAlignment)
+{
+	TT_ASSERT(p_fileAlignment > 0);
+	
+	// Open output file before actual processing
+	fs::FilePtr file = fs::open(p_path, fs::OpenMode_Write);
+	if (file == 0)
+	{
+		TT_PANIC("Unable to open '%s' for writing.\n", p_path.c_str());
+		return false;
+	}
+	
+	// Compress the files and lay out the archive
+	const MemoryArchive::Files& sourceFiles(p_source.getFiles());
+	PackFilesToWrite files;
+	files.reserve(sourceFiles.size());
+	for (MemoryArchive::Files::const_iterator it = sourceFiles.begin(); it != sourceFiles.end(); ++it)
+	{
+		TT_NULL_ASSERT((*it).second.content);
+		
+		PackFileToWrite packFile;
+		packFile.hash      = (*it).first.getValue();
+		packFile.path      = (*it).second.path;
+		packFile.writeTime = (*it).second.writeTime;
+		packFile.size      = static_cast<u32>((*it).second.content->getSize());
+		packFile.content   = compressPackFile((*it).second.content, p_compressionType);
+		if (packFile.content != 0)
+		{
+			packFile.compressionType = p_compressionType;
+		}
+		else
+		{
+			packFile.content = (*it).second.content;
+		}
+		files.push_back(packFile);
+	}
+	std::sort(files.begin(), files.end(), PackFileHashLess());
+	
+	const u32 fileCount       = static_cast<u32>(files.size());
+	const u32 pathTableOffset = g_packHeaderSize + fileCount * g_packEntrySize;
+	u32 pathTableSize = 0;
+	for (PackFilesToWrite::iterator it = files.begin(); it != files.end(); ++it)
+	{
+		(*it).pathOffset = pathTableSize;
+		pathTableSize += static_cast<u32>((*it).path.size()) + 1;
+	}
+	
+	const u32 dataOffset = alignPackOffset(pathTableOffset + pathTableSize, p_fileAlignment);
+	u32 offset = dataOffset;
+	for (PackFilesToWrite::iterator it = files.begin(); it != files.end(); ++it)
+	{
+		(*it).offset = offset;
+		offset = alignPackOffset(offset + static_cast<u32>((*it).content->getSize()), p_fileAlignment);
+	}
+	
+	// Header
+	bool saveOk = true;
+	const fs::size_type fslen = static_cast<fs::size_type>(g_packSignatureLength);
+	saveOk = saveOk && (file->write(g_packSignature, fslen) == fslen);
+	saveOk = saveOk && fs::writeInteger(file, g_packVersion);
+	saveOk = saveOk && fs::writeInteger(file, fileCount);
+	saveOk = saveOk && fs::writeInteger(file, pathTableOffset);
+	
+	// Index
+	for (PackFilesToWrite::const_iterator it = files.begin(); saveOk && it != files.end(); ++it)
+	{
+		saveOk = saveOk && fs::writeInteger(file, (*it).hash);
+		saveOk = saveOk && fs::writeInteger(file, (*it).offset);
+		saveOk = saveOk && fs::writeInteger(file, static_cast<u32>((*it).content->getSize()));
+		saveOk = saveOk && fs::writeInteger(file, (*it).size);
+		saveOk = saveOk && fs::writeInteger(file, (*it).writeTime);
+		saveOk = saveOk && fs::writeInteger(file, (*it).pathOffset);
+		saveOk = saveOk && fs::writeEnum<u8, MemoryArchive::CompressionType>(file, (*it).compressionType);
+		saveOk = saveOk && writePadding(file, 0, 3);
+	}
+	
+	// Path table
+	for (PackFilesToWrite::const_iterator it = files.begin(); saveOk && it != files.end(); ++it)
+	{
+		const fs::size_type pathLength = static_cast<fs::size_type>((*it).path.size() + 1);
+		saveOk = saveOk && (file->write((*it).path.c_str(), pathLength) == pathLength);
+	}
+	saveOk = saveOk && writePadding(file, pathTableOffset + pathTableSize, dataOffset);
+	
+	// Files
+	for (PackFilesToWrite::const_iterator it = files.begin(); saveOk && it != files.end(); ++it)
+	{
+		const fs::size_type size = static_cast<fs::size_type>((*it).content->getSize());
+		saveOk = saveOk && (size == 0 || file->write((*it).content->getData(), size) == size);
+		saveOk = saveOk && writePadding(file, (*it).offset + static_cast<u32>(size),
+		                                alignPackOffset((*it).offset + static_cast<u32>(size), p_fileAlignment));
+	}
+	
+	if (saveOk == false)
+	{
+		TT_PANIC("Failed to write to output file '%s'", p_path.c_str());
+		return false;
+	}
+	
+	return true;
+}
+
+
+bool PackArchive::hasFile(const std::string& p_relativeFilePath) const
+{
+	return findEntry(p_relativeFilePath) >= 0;
+}
+
+
+PackArchive::File PackArchive::getFile(const std::string& p_relativeFilePath) const
+{
+	const s32 index = findEntry(p_relativeFilePath);
+	return (index >= 0) ? getFile(index) : File();
+}
+
+
+code::BufferPtr PackArchive::getFileContent(const std::string& p_relativeFilePath) const
+{
+	const s32 index = findEntry(p_relativeFilePath);
+	return (index >= 0) ? getContent(index, getEntry(index)) : code::BufferPtr();
+}
+
+
+std::string PackArchive::getFilePath(s32 p_index) const
+{
+	const Entry entry(getEntry(p_index));
+	
+	const char* start = reinterpret_cast<const char*>(m_file->getData() + m_pathTableOffset + entry.pathOffset);
+	const char* end   = reinterpret_cast<const char*>(m_file->getData() + m_file->getSize());
+	if (start >= end)
+	{
+		TT_PANIC("Path of file %d is outside of the archive.", p_index);
+		return std::string();
+	}
+	return std::string(start, std::find(start, end, '\0'));
+}
+
+
+PackArchive::File PackArchive::getFile(s32 p_index) const
+{
+	const Entry entry(getEntry(p_index));
+	
+	File file;
+	file.writeTime = entry.writeTime;
+	file.content   = getContent(p_index, entry);
+	return file;
+}
+
+
+size_type PackArchive::getCachedSize() const
+{
+	thread::CriticalSection criticalSection(&m_cacheMutex);
+	return m_cachedSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+PackArchive::PackArchive(const MappedFilePtr& p_file, s32 p_fileCount, u32 p_pathTableOffset,
+                         size_type p_cacheSize)
+:
+m_file(p_file),
+m_fileCount(p_fileCount),
+m_pathTableOffset(p_pathTableOffset),
+m_cacheMutex(),
+m_cachedFiles(),
+m_cacheLookup(),
+m_cachedSize(0),
+m_maxCacheSize(p_cacheSize)
+{
+}
+
+
+s32 PackArchive::findEntry(const std::string& p_relativeFilePath) const
+{
+	const u32 hash = NameHash(p_relativeFilePath).getValue();
+	
+	// Binary search in the index; entries are sorted on hash
+	s32 first = 0;
+	s32 count = m_fileCount;
+	while (count > 0)
+	{
+		const s32 half = count / 2;
+		const u8* entry = m_file->getData() + g_packHeaderSize + (first + half) * g_packEntrySize;
+		size_t remaining = sizeof(u32);
+		if (code::bufferutils::get<u32>(entry, remaining) < hash)
+		{
+			first += half + 1;
+			count -= half + 1;
+		}
+		else
+		{
+			count = half;
+		}
+	}
+	
+	if (first >= m_fileCount)
+	{
+		return -1;
+	}
+	
+	return (getEntry(first).hash == hash) ? first : -1;
+}
+
+
+PackArchive::Entry PackArchive::getEntry(s32 p_index) const
+{
+	TT_ASSERT(p_index >= 0 && p_index < m_fileCount);
+	
+	namespace bu = code::bufferutils;
+	const u8* cursor    = m_file->getData() + g_packHeaderSize + p_index * g_packEntrySize;
+	size_t    remaining = g_packEntrySize;
+	
+	Entry entry;
+	entry.hash            = bu::get<u32          >(cursor, remaining);
+	entry.offset          = bu::get<u32          >(cursor, remaining);
+	entry.storedSize      = bu::get<u32          >(cursor, remaining);
+	entry.size            = bu::get<u32          >(cursor, remaining);
+	entry.writeTime       = bu::get<fs::time_type>(cursor, remaining);
+	entry.pathOffset      = bu::get<u32          >(cursor, remaining);
+	entry.compressionType = static_cast<MemoryArchive::CompressionType>(bu::get<u8>(cursor, remaining));
+	return entry;
+}
+
+
+code::BufferPtr PackArchive::getContent(s32 p_index, const Entry& p_entry) const
+{
+	if (static_cast<u64>(p_entry.offset) + p_entry.storedSize > static_cast<u64>(m_file->getSize()))
+	{
+		TT_PANIC("File %d (offset %u, size %u) is outside of the archive.",
+		         p_index, p_entry.offset, p_entry.storedSize);
+		return code::BufferPtr();
+	}
+	
+	if (p_entry.compressionType == MemoryArchive::CompressionType_None)
+	{
+		// View on the mapping
+		return code::BufferPtr(new code::Buffer(const_cast<u8*>(m_file->getData()) + p_entry.offset,
+		                                        static_cast<code::Buffer::size_type>(p_entry.size)));
+	}
+	
+	{
+		thread::CriticalSection criticalSection(&m_cacheMutex);
+		CacheLookup::iterator it = m_cacheLookup.find(p_index);
+		if (it != m_cacheLookup.end())
+		{
+			// Move to the front of the cache
+			m_cachedFiles.splice(m_cachedFiles.begin(), m_cachedFiles, (*it).second);
+			return (*(*it).second).content;
+		}
+	}
+	
+	// Decompress outside the lock, so other threads can get other files in the meantime
+	code::BufferPtr content = decompress(p_entry);
+	if (content == 0)
+	{
+		TT_PANIC("Failed to decompress file %d ('%s').", p_index, getFilePath(p_index).c_str());
+		return code::BufferPtr();
+	}
+	
+	// The compressed data isn't needed anymore once it's in the cache
+	m_file->release(static_cast<size_type>(p_entry.offset), static_cast<size_type>(p_entry.storedSize));
+	
+	if (static_cast<size_type>(p_entry.size) > m_maxCacheSize)
+	{
+		return content;
+	}
+	
+	thread::CriticalSection criticalSection(&m_cacheMutex);
+	
+	// Another thread could have decompressed the same file
+	CacheLookup::iterator it = m_cacheLookup.find(p_index);
+	if (it != m_cacheLookup.end())
+	{
+		m_cachedFiles.splice(m_cachedFiles.begin(), m_cachedFiles, (*it).second);
+		return (*(*it).second).content;
+	}
+	
+	CachedFile cachedFile;
+	cachedFile.index   = p_index;
+	cachedFile.content = content;
+	m_cachedFiles.push_front(cachedFile);
+	m_cacheLookup[p_index] = m_cachedFiles.begin();
+	m_cachedSize += static_cast<size_type>(p_entry.size);
+	
+	// Evict the least recently used files (the files stay valid for whoever still holds them)
+	while (m_cachedSize > m_maxCacheSize)
+	{
+		const CachedFile& last(m_cachedFiles.back());
+		m_cachedSize -= static_cast<size_type>(last.content->getSize());
+		m_cacheLookup.erase(last.index);
+		m_cachedFiles.pop_back();
+	}
+	
+	return content;
+}
+
+
+code::BufferPtr PackArchive::decompress(const Entry& p_entry) const
+{
+	code::BufferPtrForCreator result(new code::Buffer(static_cast<code::Buffer::size_type>(p_entry.size)));
+	
+	const u8* input = m_file->getData() + p_entry.offset;
+	u32 decompressedSize = 0;
+	switch (p_entry.compressionType)
+	{
+	case MemoryArchive::CompressionType_FastLZ:
+		decompressedSize = static_cast<u32>(fastlz_decompress(input, static_cast<int>(p_entry.storedSize),
+			result->getData(), static_cast<int>(p_entry.size)));
+		break;
+		
+	case MemoryArchive::CompressionType_LZMA:
+		decompressedSize = lzma_decompress(input, p_entry.storedSize, result->getData(), p_entry.size);
+		break;
+		
+	case MemoryArchive::CompressionType_LZ4:
+	case MemoryArchive::CompressionType_LZ4HC:
+		{
+			const int size = LZ4_decompress_safe(reinterpret_cast<const char*>(input),
+				static_cast<char*>(result->getData()), static_cast<int>(p_entry.storedSize),
+				static_cast<int>(p_entry.size));
+			decompressedSize = (size > 0) ? static_cast<u32>(size) : 0;
+		}
+		break;
+		
+	default:
+		TT_PANIC("Unsupported compression type '%d'", p_entry.compressionType);
+		return code::BufferPtr();
+	}
+	
+	if (decompressedSize != p_entry.size)
+	{
+		TT_PANIC("Decompression size '%u' mismatches the stored size '%u'", decompressedSize, p_entry.size);
+		return code::BufferPtr();
+	}
+	
+	return result;
+}
+
+
+// Namespace end
+}
+}
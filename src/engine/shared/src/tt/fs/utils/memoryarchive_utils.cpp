@@ -10,6 +10,7 @@
 #include <tt/fs/DirEntry.h>
 #include <tt/fs/File.h>
 #include <tt/fs/fs.h>
+#include <tt/fs/PackArchive.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/str/str.h>
 #include <tt/xml/XmlDocument.h>
@@ -210,10 +211,12 @@ bool MemoryArchivePack(const std::string& p_configFile,
 	
 	// Construct archive path
 	const std::string archiveName = fs::utils::getFileTitle(configFile);
-	const std::string archivePath = outputPath + archiveName + ".ma";
+	const std::string archivePath = outputPath + archiveName + (p_settings.packArchive ? ".pack" : ".ma");
 	
 	// Save archive
-	bool result = archive->save(archivePath, p_settings.compressionType, p_settings.alignment);
+	bool result = p_settings.packArchive ?
+		fs::PackArchive::save(archivePath, *archive, p_settings.compressionType, p_settings.alignment) :
+		archive->save(archivePath, p_settings.compressionType, p_settings.alignment);
 	
 	// Delete originals
 	if (p_settings.deleteOriginals)
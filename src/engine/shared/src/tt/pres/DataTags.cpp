@@ -12,15 +12,26 @@ namespace pres {
 
 static const u16 s_version = 0;
 
+const DataTags::Data DataTags::ms_emptyData;
+
+
 //--------------------------------------------------------------------------------------------------
 // Public member functions
 
+DataTags::DataTags()
+:
+m_data()
+{
+}
+
 
 bool DataTags::load(const u8*& p_bufferOUT, size_t& p_sizeOUT, const DataTags& p_applyTags, 
                     const Tags& p_acceptedTags, code::ErrorStatus* p_errStatus)
 {
 	TT_ERR_CHAIN(bool, false, "Loading Tags");
 	
+	Data& data(modifyData());
+	
 	using namespace code::bufferutils;
 	
 	const u16 version = be_get<u16>(p_bufferOUT, p_sizeOUT);
@@ -29,14 +40,14 @@ bool DataTags::load(const u8*& p_bufferOUT, size_t& p_sizeOUT, const DataTags& p
 	                 "data " << version << " -- please update your converter.");
 	
 	const std::string name = be_get<std::string>(p_bufferOUT, p_sizeOUT);
-	m_nameTag = Tag(name);
+	data.nameTag = Tag(name);
 	if (name.empty())
 	{
-		m_nameTag.invalidate();
+		data.nameTag.invalidate();
 	}
 
 #if !defined(TT_BUILD_FINAL)
-	m_name = name;
+	data.name = name;
 #endif
 	
 	const u16 mustHaveTagGroupCount = be_get<u16>(p_bufferOUT, p_sizeOUT);
@@ -57,7 +68,7 @@ bool DataTags::load(const u8*& p_bufferOUT, size_t& p_sizeOUT, const DataTags& p
 			mustHaveGroup.insert(tag);
 		}
 		
-		m_mustHaves.push_back(mustHaveGroup);
+		data.mustHaves.push_back(mustHaveGroup);
 	}
 	
 	TT_ERR_ASSERTMSG(p_sizeOUT >= sizeof(u16), "Buffer too small.");
@@ -81,7 +92,7 @@ bool DataTags::load(const u8*& p_bufferOUT, size_t& p_sizeOUT, const DataTags& p
 			mustNotHaveGroup.insert(tag);
 		}
 		
-		m_mustNotHaves.push_back(mustNotHaveGroup);
+		data.mustNotHaves.push_back(mustNotHaveGroup);
 	}
 	
 	addDataTags(p_applyTags);
@@ -90,14 +101,16 @@ bool DataTags::load(const u8*& p_bufferOUT, size_t& p_sizeOUT, const DataTags& p
 }
 
 
-bool DataTags::shouldPlay(const Tags& p_startTags, const std::string& p_name)
+bool DataTags::shouldPlay(const Tags& p_startTags, const std::string& p_name) const
 {
+	const Data& data(getData());
+	
 	// if the name from data is empty, check the tags. If the names don't match don't play.
 	// when the start name is empty only play the empty named animations.
-	if (m_nameTag.isValid() && m_nameTag != Tag(p_name)) return false;
+	if (data.nameTag.isValid() && data.nameTag != Tag(p_name)) return false;
 	
 	// First check the must not have groups
-	for(TagGroup::const_iterator tagGroup(m_mustNotHaves.begin()); tagGroup != m_mustNotHaves.end(); ++tagGroup)
+	for(TagGroup::const_iterator tagGroup(data.mustNotHaves.begin()); tagGroup != data.mustNotHaves.end(); ++tagGroup)
 	{
 		bool foundAllMustNotHaveTags = true;
 		for(Tags::const_iterator it(tagGroup->begin()) ; it != tagGroup->end() ; ++it)
@@ -117,7 +130,7 @@ bool DataTags::shouldPlay(const Tags& p_startTags, const std::string& p_name)
 	}
 	
 	// Check the must have groups
-	for(TagGroup::const_iterator tagGroup(m_mustHaves.begin()); tagGroup != m_mustHaves.end(); ++tagGroup)
+	for(TagGroup::const_iterator tagGroup(data.mustHaves.begin()); tagGroup != data.mustHaves.end(); ++tagGroup)
 	{
 		bool foundAllMustHaveTags = true;
 		for(Tags::const_iterator it(tagGroup->begin()) ; it != tagGroup->end() ; ++it)
@@ -138,40 +151,44 @@ bool DataTags::shouldPlay(const Tags& p_startTags, const std::string& p_name)
 	
 	// If we reach this part. Either there are musthaves and they did not match, which means
 	// we should not play. Or there are no musthaves which means we can play.
-	return m_mustHaves.empty();
+	return data.mustHaves.empty();
 }
 
 
 void DataTags::addDataTags(const DataTags& p_applyTags)
 {
+	Data& data(modifyData());
+	const Data& applyData(p_applyTags.getData());
 	
 #if !defined(TT_BUILD_FINAL)
-	if (m_name.empty() == false) m_allUsedNames.insert(m_name);
-	if (p_applyTags.m_name.empty() == false) m_allUsedNames.insert(p_applyTags.m_name);
-	m_allUsedNames.insert(p_applyTags.m_allUsedNames.begin(), p_applyTags.m_allUsedNames.end());
+	if (data.name.empty() == false) data.allUsedNames.insert(data.name);
+	if (applyData.name.empty() == false) data.allUsedNames.insert(applyData.name);
+	data.allUsedNames.insert(applyData.allUsedNames.begin(), applyData.allUsedNames.end());
 
-	m_mustHavesStr   .insert(m_mustHavesStr   .end(), p_applyTags.m_mustHavesStr   .begin(), p_applyTags.m_mustHavesStr   .end());
-	m_mustNotHavesStr.insert(m_mustNotHavesStr.end(), p_applyTags.m_mustNotHavesStr.begin(), p_applyTags.m_mustNotHavesStr.end());
+	data.mustHavesStr   .insert(data.mustHavesStr   .end(), applyData.mustHavesStr   .begin(), applyData.mustHavesStr   .end());
+	data.mustNotHavesStr.insert(data.mustNotHavesStr.end(), applyData.mustNotHavesStr.begin(), applyData.mustNotHavesStr.end());
 	
-	if (m_name.empty()) m_name = p_applyTags.m_name;
+	if (data.name.empty()) data.name = applyData.name;
 #endif
 	
-	if(m_nameTag.isValid() == false) m_nameTag = p_applyTags.m_nameTag;
-	m_mustHaves   .insert(m_mustHaves   .end(), p_applyTags.m_mustHaves   .begin(), p_applyTags.m_mustHaves   .end());
-	m_mustNotHaves.insert(m_mustNotHaves.end(), p_applyTags.m_mustNotHaves.begin(), p_applyTags.m_mustNotHaves.end());
+	if(data.nameTag.isValid() == false) data.nameTag = applyData.nameTag;
+	data.mustHaves   .insert(data.mustHaves   .end(), applyData.mustHaves   .begin(), applyData.mustHaves   .end());
+	data.mustNotHaves.insert(data.mustNotHaves.end(), applyData.mustNotHaves.begin(), applyData.mustNotHaves.end());
 }
 
 
 Tags DataTags::getAllUsedTags() const
 {
+	const Data& data(getData());
+	
 	Tags allTags;
 	
-	for(TagGroup::const_iterator tagGroup(m_mustNotHaves.begin()); tagGroup != m_mustNotHaves.end(); ++tagGroup)
+	for(TagGroup::const_iterator tagGroup(data.mustNotHaves.begin()); tagGroup != data.mustNotHaves.end(); ++tagGroup)
 	{
 		allTags.insert(tagGroup->begin(), tagGroup->end());
 	}
 	
-	for(TagGroup::const_iterator tagGroup(m_mustHaves.begin()); tagGroup != m_mustHaves.end(); ++tagGroup)
+	for(TagGroup::const_iterator tagGroup(data.mustHaves.begin()); tagGroup != data.mustHaves.end(); ++tagGroup)
 	{
 		allTags.insert(tagGroup->begin(), tagGroup->end());
 	}
@@ -186,7 +203,9 @@ bool DataTags::load(const xml::XmlNode* p_node, const DataTags& p_applyTags, con
 {
 	TT_ERR_CHAIN(bool, false, "Loading DataTags from node '" << p_node->getName() << "'");
 	
-	m_name = p_node->getAttribute("name");
+	Data& data(modifyData());
+	
+	data.name = p_node->getAttribute("name");
 	
 	for (const xml::XmlNode* child = p_node->getChild(); child != 0; child = child->getSibling())
 	{
@@ -199,8 +218,8 @@ bool DataTags::load(const xml::XmlNode* p_node, const DataTags& p_applyTags, con
 			TT_ERR_RETURN_ON_ERROR();
 			TT_ERR_ASSERT(mustHaveGroup.size() == mustHaveStrGroup.size());
 			
-			m_mustHaves.push_back(mustHaveGroup);
-			m_mustHavesStr.push_back(mustHaveStrGroup);
+			data.mustHaves.push_back(mustHaveGroup);
+			data.mustHavesStr.push_back(mustHaveStrGroup);
 		}
 		else if(child->getName() == "mustnothave")
 		{
@@ -211,8 +230,8 @@ bool DataTags::load(const xml::XmlNode* p_node, const DataTags& p_applyTags, con
 			TT_ERR_RETURN_ON_ERROR();
 			TT_ERR_ASSERT(mustnotHaveGroup.size() == mustnotHaveStrGroup.size());
 			
-			m_mustNotHaves.push_back(mustnotHaveGroup);
-			m_mustNotHavesStr.push_back(mustnotHaveStrGroup);
+			data.mustNotHaves.push_back(mustnotHaveGroup);
+			data.mustNotHavesStr.push_back(mustnotHaveStrGroup);
 		}
 		else
 		{
@@ -224,8 +243,8 @@ bool DataTags::load(const xml::XmlNode* p_node, const DataTags& p_applyTags, con
 	
 	addDataTags(p_applyTags);
 	
-	TT_ERR_ASSERT(m_mustHaves.size() == m_mustHavesStr.size() && 
-	              m_mustNotHaves.size() == m_mustNotHavesStr.size());
+	TT_ERR_ASSERT(data.mustHaves.size() == data.mustHavesStr.size() && 
+	              data.mustNotHaves.size() == data.mustNotHavesStr.size());
 	return true;
 }
 
@@ -233,18 +252,20 @@ bool DataTags::load(const xml::XmlNode* p_node, const DataTags& p_applyTags, con
 bool DataTags::save(u8*& p_bufferOUT, size_t& p_sizeOUT, code::ErrorStatus* p_errStatus) const
 {
 	TT_ERR_CHAIN(bool, false, "Saving DataTags");
-	TT_ERR_ASSERT(m_mustHaves.size() == m_mustHavesStr.size() && m_mustNotHaves.size() == m_mustNotHavesStr.size());
+	
+	const Data& data(getData());
+	TT_ERR_ASSERT(data.mustHaves.size() == data.mustHavesStr.size() && data.mustNotHaves.size() == data.mustNotHavesStr.size());
 	
 	using namespace code::bufferutils;
 	
 	be_put(s_version, p_bufferOUT, p_sizeOUT);
 	
-	be_put(m_name, p_bufferOUT, p_sizeOUT);
+	be_put(data.name, p_bufferOUT, p_sizeOUT);
 	
 	// must have
-	be_put(static_cast<u16>(m_mustHavesStr.size()), p_bufferOUT, p_sizeOUT); // count of taggroups
+	be_put(static_cast<u16>(data.mustHavesStr.size()), p_bufferOUT, p_sizeOUT); // count of taggroups
 	
-	for(TagStrGroup::const_iterator tagGroup(m_mustHavesStr.begin()) ; tagGroup != m_mustHavesStr.end() ; ++tagGroup)
+	for(TagStrGroup::const_iterator tagGroup(data.mustHavesStr.begin()) ; tagGroup != data.mustHavesStr.end() ; ++tagGroup)
 	{
 		be_put(static_cast<u16>(tagGroup->size()), p_bufferOUT, p_sizeOUT); // count of tags
 		
@@ -255,9 +276,9 @@ bool DataTags::save(u8*& p_bufferOUT, size_t& p_sizeOUT, code::ErrorStatus* p_er
 	}
 	
 	// must not have
-	be_put(static_cast<u16>(m_mustNotHavesStr.size()), p_bufferOUT, p_sizeOUT); // count of taggroups
+	be_put(static_cast<u16>(data.mustNotHavesStr.size()), p_bufferOUT, p_sizeOUT); // count of taggroups
 	
-	for(TagStrGroup::const_iterator tagGroup(m_mustNotHavesStr.begin()) ; tagGroup != m_mustNotHavesStr.end() ; ++tagGroup)
+	for(TagStrGroup::const_iterator tagGroup(data.mustNotHavesStr.begin()) ; tagGroup != data.mustNotHavesStr.end() ; ++tagGroup)
 	{
 		be_put(static_cast<u16>(tagGroup->size()), p_bufferOUT, p_sizeOUT); // count of tags
 		
@@ -273,9 +294,11 @@ bool DataTags::save(u8*& p_bufferOUT, size_t& p_sizeOUT, code::ErrorStatus* p_er
 
 size_t DataTags::getBufferSize() const
 {
+	const Data& data(getData());
+	
 	// version + name size + name + musthaves count + 
-	size_t size = 2 + 2 + m_name.size() + 2;
-	for(TagStrGroup::const_iterator tagGroup(m_mustHavesStr.begin()) ; tagGroup != m_mustHavesStr.end() ; ++tagGroup)
+	size_t size = 2 + 2 + data.name.size() + 2;
+	for(TagStrGroup::const_iterator tagGroup(data.mustHavesStr.begin()) ; tagGroup != data.mustHavesStr.end() ; ++tagGroup)
 	{
 		size += 2; // group count
 		for(str::Strings::const_iterator tag(tagGroup->begin()) ; tag != tagGroup->end() ; ++tag)
@@ -286,7 +309,7 @@ size_t DataTags::getBufferSize() const
 	}
 	// mustNothaves count + 
 	size += 2;
-	for(TagStrGroup::const_iterator tagGroup(m_mustNotHavesStr.begin()) ; tagGroup != m_mustNotHavesStr.end() ; ++tagGroup)
+	for(TagStrGroup::const_iterator tagGroup(data.mustNotHavesStr.begin()) ; tagGroup != data.mustNotHavesStr.end() ; ++tagGroup)
 	{
 		size += 2; // group count
 		for(str::Strings::const_iterator tag(tagGroup->begin()) ; tag != tagGroup->end() ; ++tag)
@@ -302,17 +325,19 @@ size_t DataTags::getBufferSize() const
 
 std::string DataTags::getDebugString() const
 {
+	const Data& data(getData());
+	
 	std::stringstream out;
-	if (m_name.empty())
+	if (data.name.empty())
 	{
 		out << "no name \n";
 	}
 	else
 	{
-		out << "name: '" << m_name << "'\n";
+		out << "name: '" << data.name << "'\n";
 	}
-	out << m_mustHaves.size() << " Must have Tag Groups: \n";
-	for(TagGroup::const_iterator tagGroup(m_mustHaves.begin()); tagGroup != m_mustHaves.end(); ++tagGroup)
+	out << data.mustHaves.size() << " Must have Tag Groups: \n";
+	for(TagGroup::const_iterator tagGroup(data.mustHaves.begin()); tagGroup != data.mustHaves.end(); ++tagGroup)
 	{
 		out << " - " << tagGroup->size() << " tags: ";
 		for(Tags::const_iterator it(tagGroup->begin()) ; it != tagGroup->end() ; ++it)
@@ -322,8 +347,8 @@ std::string DataTags::getDebugString() const
 		out << " \n ";
 	}
 	
-	out << m_mustNotHaves.size() << " Must Not Have Tag Groups: \n";
-	for(TagGroup::const_iterator tagGroup(m_mustNotHaves.begin()); tagGroup != m_mustNotHaves.end(); ++tagGroup)
+	out << data.mustNotHaves.size() << " Must Not Have Tag Groups: \n";
+	for(TagGroup::const_iterator tagGroup(data.mustNotHaves.begin()); tagGroup != data.mustNotHaves.end(); ++tagGroup)
 	{
 		out << " - " << tagGroup->size() << " tags: ";
 		for(Tags::const_iterator it(tagGroup->begin()) ; it != tagGroup->end() ; ++it)
@@ -339,7 +364,7 @@ std::string DataTags::getDebugString() const
 
 str::StringSet DataTags::getAllUsedNames()const
 {
-	return m_allUsedNames;
+	return getData().allUsedNames;
 }
 
 #endif // !defined TT_BUILD_FINAL
@@ -348,6 +373,35 @@ str::StringSet DataTags::getAllUsedNames()const
 //--------------------------------------------------------------------------------------------------
 // Private member functions
 
+DataTags::Data::Data()
+:
+mustHaves(),
+mustNotHaves(),
+nameTag()
+#if !defined(TT_BUILD_FINAL)
+,
+name(),
+allUsedNames(),
+mustHavesStr(),
+mustNotHavesStr()
+#endif
+{
+}
+
+
+DataTags::Data& DataTags::modifyData()
+{
+	if (m_data == 0)
+	{
+		m_data.reset(new Data);
+	}
+	else if (m_data.use_count() > 1)
+	{
+		m_data.reset(new Data(*m_data));
+	}
+	return *m_data;
+}
+
 
 bool DataTags::loadTags(const xml::XmlNode* p_node, const Tags& p_acceptedTags, Tags* p_tagsOut,
                         str::Strings* p_strTagsOut, code::ErrorStatus* p_errStatus)
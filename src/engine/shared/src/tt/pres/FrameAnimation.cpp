@@ -67,59 +67,32 @@ engine::renderer::FilterMode readFilterMode(
 
 FrameAnimation::FrameAnimation()
 :
-m_beginFrame(0),
-m_endFrame(-1),
+m_definition(new Definition),
 m_frameDifference(0),
 m_frameBegin(0),
-m_totalFrames(0),
 m_frameCount(0,0),
 m_frameSize(0,0),
-m_frameSizeX(0),
-m_frameSizeY(0),
-m_quadSizeX(0),
-m_quadSizeY(0),
-m_fps(1),
-m_holdFirstFrame(true),
-m_holdLastFrame(true),
-m_flip(Flip_None),
-m_minFilter(engine::renderer::FilterMode_Invalid),
-m_magFilter(engine::renderer::FilterMode_Invalid),
-m_mipFilter(engine::renderer::FilterMode_Invalid),
-m_blendMode(engine::renderer::BlendMode_Invalid),
-m_flags(),
-m_passName(),
-m_spritestripID(0,0),
-m_lightmaskID(0,0),
-m_spriteDirectory(),
-m_usingDirectory(false),
+m_quadSize(0,0),
+m_translation(0,0,0),
+m_scale(1,1),
+m_rotation(0.0f),
 m_texture(),
 m_isTextureForVisualBoy(false),
 m_lightmask(),
 m_quad(),
-m_translationX(0.0),
-m_translationY(0.0),
-m_translationZ(0.0),
-m_scaleX(1.0f),
-m_scaleY(1.0f),
-m_isUniformScale(false),
-m_rotation(0.0f),
-m_texAnimU(0),
-m_texAnimV(0),
-m_loaded(false),
-m_usingDuration(false),
-m_frameDuration(),
 m_durationTimeLeft(0),
 m_animationUV(0,0),
 m_offsetUV(0,0),
-m_cameraSpaceScale(0,0),
-m_lightMaskType(LightMaskType_None)
+m_cameraSpaceScale(0,0)
 {
 }
 
 
 void FrameAnimation::createQuad()
 {
-	TT_ASSERTMSG(m_loaded, "load the Frameanimation before creating a quad");
+	const Definition& def(getDefinition());
+	
+	TT_ASSERTMSG(def.loaded, "load the Frameanimation before creating a quad");
 	
 	if(m_quad == 0)
 	{
@@ -127,7 +100,7 @@ void FrameAnimation::createQuad()
 
 		{
 			// VisualBoy hack
-			if (m_spritestripID.getValue() == VisualBoy::getVisualBoyTextureCRC())
+			if (def.spritestripID.getValue() == VisualBoy::getVisualBoyTextureCRC())
 			{
 				TT_NULL_ASSERT(VisualBoy::getOutputTexture());
 				m_texture =  VisualBoy::getOutputTexture();
@@ -135,29 +108,29 @@ void FrameAnimation::createQuad()
 			}
 			else
 			{
-				m_texture = TextureCache::get(m_spritestripID, true);
+				m_texture = TextureCache::get(def.spritestripID, true);
 				m_isTextureForVisualBoy = false;
 			}
 		}
 		TT_NULL_ASSERT(m_texture);
 
-		if(m_lightMaskType == LightMaskType_UseLightmaskTexture)
+		if(def.lightMaskType == LightMaskType_UseLightmaskTexture)
 		{
-			m_lightmask = TextureCache::get(m_lightmaskID, false);
+			m_lightmask = TextureCache::get(def.lightmaskID, false);
 			TT_NULL_ASSERT(m_lightmask);
 		}
 		
-		if(engine::renderer::isValidFilterMode(m_minFilter))
+		if(engine::renderer::isValidFilterMode(def.minFilter))
 		{
-			m_texture->setMinificationFilter(m_minFilter);
+			m_texture->setMinificationFilter(def.minFilter);
 		}
-		if(engine::renderer::isValidFilterMode(m_magFilter))
+		if(engine::renderer::isValidFilterMode(def.magFilter))
 		{
-			m_texture->setMagnificationFilter(m_magFilter);
+			m_texture->setMagnificationFilter(def.magFilter);
 		}
-		if(engine::renderer::isValidFilterMode(m_mipFilter))
+		if(engine::renderer::isValidFilterMode(def.mipFilter))
 		{
-			m_texture->setMipmapFilter(m_mipFilter);
+			m_texture->setMipmapFilter(def.mipFilter);
 		}
 		
 		m_quad.reset(new PresentationQuad(m_texture, engine::renderer::ColorRGBA()));
@@ -189,7 +162,7 @@ void FrameAnimation::update(real p_delta)
 		createQuad();
 	}
 
-	if (m_usingDuration)
+	if (getDefinition().usingDuration)
 	{
 		m_durationTimeLeft -= p_delta;
 		if (m_durationTimeLeft < 0)
@@ -206,6 +179,8 @@ void FrameAnimation::update(real p_delta)
 
 void FrameAnimation::render(const math::Matrix44& p_transform) const
 {
+	const Definition& def(getDefinition());
+	
 	if (m_quad != 0)
 	{
 		engine::renderer::MatrixStack* stack = engine::renderer::MatrixStack::getInstance();
@@ -275,7 +250,7 @@ void FrameAnimation::render(const math::Matrix44& p_transform) const
 			}
 			
 			const bool fogWasEnabled = renderer->isFogEnabled();
-			if (m_flags.checkFlag(Flag_IgnoreFog))
+			if (def.flags.checkFlag(Flag_IgnoreFog))
 			{
 				renderer->setFogEnabled(false);
 			}
@@ -287,18 +262,18 @@ void FrameAnimation::render(const math::Matrix44& p_transform) const
 			m_quad->render();
 
 			// Lightmask rendering
-			if(m_lightMaskType != LightMaskType_None)
+			if(def.lightMaskType != LightMaskType_None)
 			{
 				using namespace tt::engine::renderer;
 				renderer->setColorMask(ColorMask_Alpha);
 				renderer->setCustomBlendMode(BlendFactor_One, BlendFactor_One);
 				renderer->resetCustomBlendModeAlpha();
 
-				if(m_lightMaskType == LightMaskType_UseAlphaChannel)
+				if(def.lightMaskType == LightMaskType_UseAlphaChannel)
 				{
 					m_quad->render();
 				}
-				else if(m_lightMaskType == LightMaskType_UseLightmaskTexture)
+				else if(def.lightMaskType == LightMaskType_UseLightmaskTexture)
 				{
 					TT_NULL_ASSERT(m_lightmask);
 					m_quad->renderWithTexture(m_lightmask);
@@ -309,7 +284,7 @@ void FrameAnimation::render(const math::Matrix44& p_transform) const
 				renderer->setCustomBlendModeAlpha(BlendFactor_Zero, BlendFactor_InvSrcAlpha);
 			}
 			
-			if (m_flags.checkFlag(Flag_IgnoreFog))
+			if (def.flags.checkFlag(Flag_IgnoreFog))
 			{
 				renderer->setFogEnabled(fogWasEnabled);
 			}
@@ -325,18 +300,22 @@ void FrameAnimation::render(const math::Matrix44& p_transform) const
 
 void FrameAnimation::getAndLoadAllUsedTextures(engine::renderer::TextureContainer& p_textures) const
 {
-	p_textures.push_back(engine::renderer::TextureCache::get(m_spritestripID, true));
+	const Definition& def(getDefinition());
 
-	if(m_lightMaskType == LightMaskType_UseLightmaskTexture)
+	p_textures.push_back(engine::renderer::TextureCache::get(def.spritestripID, true));
+	
+	if(def.lightMaskType == LightMaskType_UseLightmaskTexture)
 	{
-		p_textures.push_back(engine::renderer::TextureCache::get(m_lightmaskID, true));
+		p_textures.push_back(engine::renderer::TextureCache::get(def.lightmaskID, true));
 	}
 }
 
 
 math::Matrix44 FrameAnimation::getTextureMatrix() const
 {
-	TT_ASSERTMSG(m_loaded, "load the Frameanimation before getting the texture matrix");
+	const Definition& def(getDefinition());
+	
+	TT_ASSERTMSG(def.loaded, "load the Frameanimation before getting the texture matrix");
 	TT_NULL_ASSERT(m_texture);
 	
 	// calc current frame
@@ -347,7 +326,7 @@ math::Matrix44 FrameAnimation::getTextureMatrix() const
 	if(frame != 0)
 	{
 		// use this to calc the texture translation
-		if(m_spriteDirectory.empty())
+		if(def.spriteDirectory.empty())
 		{
 			TT_ASSERT(m_frameCount.x > 0);
 			textureTranslation.setValues(
@@ -370,6 +349,8 @@ math::Matrix44 FrameAnimation::getTextureMatrix() const
 
 bool FrameAnimation::isVisible() const
 {
+	const Definition& def(getDefinition());
+	
 	if (isActive())
 	{
 		// at the begin of the animation and active. Means that we are in delay time
@@ -379,11 +360,11 @@ bool FrameAnimation::isVisible() const
 			{
 			case DirectionType_Forward:
 			case DirectionType_PingPong:
-				return m_holdFirstFrame; 
+				return def.holdFirstFrame; 
 				
 			case DirectionType_Backward:
 			case DirectionType_ReversePingPong:
-				return m_holdLastFrame; 
+				return def.holdLastFrame; 
 				
 			default:
 				TT_PANIC("Unhandled direction type %d\n", getDirection());
@@ -400,7 +381,7 @@ bool FrameAnimation::isVisible() const
 	case DirectionType_ReversePingPong:
 		if (getTime() >= 1.0f) 
 		{
-			return m_holdLastFrame; 
+			return def.holdLastFrame; 
 		}
 		break;
 		
@@ -408,7 +389,7 @@ bool FrameAnimation::isVisible() const
 	case DirectionType_PingPong:
 		if (getTime() <= 0.0f) 
 		{
-			return m_holdFirstFrame; 
+			return def.holdFirstFrame; 
 		}
 		break;
 		
@@ -423,7 +404,7 @@ bool FrameAnimation::isVisible() const
 
 bool FrameAnimation::isActive() const
 {
-	if (m_usingDuration)
+	if (getDefinition().usingDuration)
 	{
 		return m_durationTimeLeft > 0.0f;
 	}
@@ -435,7 +416,7 @@ bool FrameAnimation::isLooping() const
 {
 	// when using the duration, the animation can be looping but it will end when the duration is over.
 	// so it's not looping
-	if (m_usingDuration)
+	if (getDefinition().usingDuration)
 	{
 		return false;
 	}
@@ -446,6 +427,7 @@ bool FrameAnimation::isLooping() const
 bool FrameAnimation::loadXml( const xml::XmlNode* p_node, const DataTags& p_applyTags, 
                            const Tags& p_acceptedTags, code::ErrorStatus* p_errStatus )
 {
+	Definition& def(modifyDefinition());
 	TT_ERR_CHAIN(bool, false, "Loading Frame animation");
 	TT_ERR_ASSERT(p_node->getName() == "frameanim");
 	
@@ -457,28 +439,28 @@ bool FrameAnimation::loadXml( const xml::XmlNode* p_node, const DataTags& p_appl
 	{
 		if(child->getName() == "translation")
 		{
-			m_translationX =  parseOptionalPresentationValue(child, "x", 0.0f, &errStatus);
-			m_translationY =  parseOptionalPresentationValue(child, "y", 0.0f, &errStatus);
-			m_translationZ =  parseOptionalPresentationValue(child, "z", 0.0f, &errStatus);
+			def.translationX =  parseOptionalPresentationValue(child, "x", 0.0f, &errStatus);
+			def.translationY =  parseOptionalPresentationValue(child, "y", 0.0f, &errStatus);
+			def.translationZ =  parseOptionalPresentationValue(child, "z", 0.0f, &errStatus);
 		}
 		else if(child->getName() == "scale")
 		{
 			if (child->hasAttribute("scale"))
 			{
-				m_isUniformScale = true;
-				m_scaleX = parsePresentationValue(child, "scale", 1.0f, &errStatus);
-				// m_scaleY will be same as m_scaleX
+				def.isUniformScale = true;
+				def.scaleX = parsePresentationValue(child, "scale", 1.0f, &errStatus);
+				// def.scaleY will be same as def.scaleX
 			}
 			else
 			{
-				m_isUniformScale = false;
-				m_scaleX =  parseOptionalPresentationValue(child, "x", 1.0f, &errStatus);
-				m_scaleY =  parseOptionalPresentationValue(child, "y", 1.0f, &errStatus);
+				def.isUniformScale = false;
+				def.scaleX =  parseOptionalPresentationValue(child, "x", 1.0f, &errStatus);
+				def.scaleY =  parseOptionalPresentationValue(child, "y", 1.0f, &errStatus);
 			}
 		}
 		else if(child->getName() == "rotation")
 		{
-			m_rotation = parseOptionalPresentationValue(child, "value", 0.0f, &errStatus);
+			def.rotation = parseOptionalPresentationValue(child, "value", 0.0f, &errStatus);
 		}
 		else if(child->getName() == "begin" || child->getName() == "end")
 		{
@@ -490,13 +472,13 @@ bool FrameAnimation::loadXml( const xml::XmlNode* p_node, const DataTags& p_appl
 			
 			if(child->getName() == "begin")
 			{
-				m_beginFrame = frame;
-				if(hold.isValid()) m_holdFirstFrame = hold.get();
+				def.beginFrame = frame;
+				if(hold.isValid()) def.holdFirstFrame = hold.get();
 			}
 			else if(child->getName() == "end")
 			{
-				m_endFrame = frame;
-				if(hold.isValid()) m_holdLastFrame = hold.get();
+				def.endFrame = frame;
+				if(hold.isValid()) def.holdLastFrame = hold.get();
 			}
 		}
 		else
@@ -505,10 +487,10 @@ bool FrameAnimation::loadXml( const xml::XmlNode* p_node, const DataTags& p_appl
 		}
 	}
 	
-	TT_ERR_ASSERTMSG(m_endFrame.getMax() >= 0, "No end frame specified or end frame is -1");
-	if (m_beginFrame.isValid() && m_endFrame.isValid() && m_beginFrame.get() > m_endFrame.get())
+	TT_ERR_ASSERTMSG(def.endFrame.getMax() >= 0, "No end frame specified or end frame is -1");
+	if (def.beginFrame.isValid() && def.endFrame.isValid() && def.beginFrame.get() > def.endFrame.get())
 	{
-		TT_ERR_AND_RETURN("Beginframe '" << m_beginFrame << "' should be less or equal than endframe '" << m_endFrame << "'");
+		TT_ERR_AND_RETURN("Beginframe '" << def.beginFrame << "' should be less or equal than endframe '" << def.endFrame << "'");
 	}
 	
 	// image: path to the image strip (when using this the framewidth and height have to be specified)
@@ -536,28 +518,28 @@ bool FrameAnimation::loadXml( const xml::XmlNode* p_node, const DataTags& p_appl
 		TT_ERR_ASSERTMSG(frameWidth.isValid(), "When using image, frame_width must be set.");
 		
 		// Get asset id
-		m_spritestripID = engine::EngineID(image.get(), imageNamespace.get());
-		m_lightmaskID   = engine::EngineID("lightmask_" + image.get(), imageNamespace.get());
+		def.spritestripID = engine::EngineID(image.get(), imageNamespace.get());
+		def.lightmaskID   = engine::EngineID("lightmask_" + image.get(), imageNamespace.get());
 		
-		m_frameSizeX = frameWidth.get();
-		m_frameSizeY = frameHeight.get();
+		def.frameSizeX = frameWidth.get();
+		def.frameSizeY = frameHeight.get();
 
 		// Optional UV animations
-		m_texAnimU = parseOptionalPresentationValue(p_node, "texture_anim_u", 0.0f, &errStatus);
-		m_texAnimV = parseOptionalPresentationValue(p_node, "texture_anim_v", 0.0f, &errStatus);
+		def.texAnimU = parseOptionalPresentationValue(p_node, "texture_anim_u", 0.0f, &errStatus);
+		def.texAnimV = parseOptionalPresentationValue(p_node, "texture_anim_v", 0.0f, &errStatus);
 
-		if(m_texAnimU.isValid()) m_animationUV.x = m_texAnimU.get();
-		if(m_texAnimV.isValid()) m_animationUV.y = m_texAnimV.get();
+		if(def.texAnimU.isValid()) m_animationUV.x = def.texAnimU.get();
+		if(def.texAnimV.isValid()) m_animationUV.y = def.texAnimV.get();
 
 		code::OptionalValue<real> cameraUScale =
 			xml::util::parseOptionalReal(p_node, "camera_space_u_scale", &errStatus);
 		code::OptionalValue<real> cameraVScale =
 			xml::util::parseOptionalReal(p_node, "camera_space_v_scale", &errStatus);
 
-		if(cameraUScale.isValid()) m_cameraSpaceScale.x = cameraUScale.get();
-		if(cameraVScale.isValid()) m_cameraSpaceScale.y = cameraVScale.get();
+		if(cameraUScale.isValid()) def.cameraSpaceScale.x = cameraUScale.get();
+		if(cameraVScale.isValid()) def.cameraSpaceScale.y = cameraVScale.get();
 		
-		m_usingDirectory = false;
+		def.usingDirectory = false;
 	}
 	else
 	{
@@ -576,16 +558,16 @@ bool FrameAnimation::loadXml( const xml::XmlNode* p_node, const DataTags& p_appl
 	// quad_width: height of the quad 
 	PresentationValue quadWidth = parsePresentationValue(p_node, "quad_width", &errStatus);
 	
-	m_quadSizeX = quadWidth;
-	m_quadSizeY = quadHeight;
+	def.quadSizeX = quadWidth;
+	def.quadSizeY = quadHeight;
 	
-	m_flip = Flip_None;
+	def.flip = Flip_None;
 	// flip_vertical
 	code::DefaultValue<bool> flipVertical(false);
 	flipVertical = xml::util::parseOptionalBool(p_node, "flip_vertical", &errStatus);
 	if(flipVertical.get())
 	{
-		m_flip |= Flip_Vertical;
+		def.flip |= Flip_Vertical;
 	}
 	
 	// flip_horizontal
@@ -593,34 +575,34 @@ bool FrameAnimation::loadXml( const xml::XmlNode* p_node, const DataTags& p_appl
 	flipHorizontal = xml::util::parseOptionalBool(p_node, "flip_horizontal", &errStatus);
 	if(flipHorizontal.get())
 	{
-		m_flip |= Flip_Horizontal;
+		def.flip |= Flip_Horizontal;
 	}
 	
 	// Texture Filtering
-	m_minFilter = readFilterMode(p_node, "filter_minify",  &errStatus);
-	m_magFilter = readFilterMode(p_node, "filter_magnify", &errStatus);
-	m_mipFilter = readFilterMode(p_node, "filter_mipmap",  &errStatus);
+	def.minFilter = readFilterMode(p_node, "filter_minify",  &errStatus);
+	def.magFilter = readFilterMode(p_node, "filter_magnify", &errStatus);
+	def.mipFilter = readFilterMode(p_node, "filter_mipmap",  &errStatus);
 	
 	// blendmode (one of the engine::renderer::BlendMode values)
-	m_blendMode = engine::renderer::BlendMode_Invalid;
+	def.blendMode = engine::renderer::BlendMode_Invalid;
 	if (p_node->getAttribute("blendmode").empty() == false)
 	{
 		const std::string& blendModeStr(p_node->getAttribute("blendmode"));
-		m_blendMode = engine::renderer::getBlendModeFromName(blendModeStr);
+		def.blendMode = engine::renderer::getBlendModeFromName(blendModeStr);
 		
-		TT_ERR_ASSERTMSG(engine::renderer::isValidBlendMode(m_blendMode),
+		TT_ERR_ASSERTMSG(engine::renderer::isValidBlendMode(def.blendMode),
 		                 "Found unknown value '" << blendModeStr
 		                  << "' in attribute 'blendmode' in node '"
 		                  << p_node->getName() << "'.");
 	}
 	
 	// Flags
-	m_flags.resetAllFlags(); // Start with clean flags.
+	def.flags.resetAllFlags(); // Start with clean flags.
 	
 	code::OptionalValue<bool> ignore_fog(xml::util::parseOptionalBool(p_node, "ignore_fog", &errStatus));
 	if (ignore_fog.isValid())
 	{
-		m_flags.setFlag(Flag_IgnoreFog);
+		def.flags.setFlag(Flag_IgnoreFog);
 	}
 	
 	// looping: Boolean
@@ -665,25 +647,26 @@ bool FrameAnimation::loadXml( const xml::XmlNode* p_node, const DataTags& p_appl
 	}
 	setId(p_node->getAttribute("id"));
 	
-	m_passName = p_node->getAttribute("render_pass");
+	def.passName = p_node->getAttribute("render_pass");
 	
 	// fps: the frame rate of the images (instead of duration)
 	// get fps as range
-	m_fps = parsePresentationValue(p_node, "fps", 1.0f, &errStatus);
+	def.fps = parsePresentationValue(p_node, "fps", 1.0f, &errStatus);
 	TT_ERR_RETURN_ON_ERROR();
-	TT_ERR_ASSERTMSG(m_fps.getMin() > 0, "fps can not be 0");
+	TT_ERR_ASSERTMSG(def.fps.getMin() > 0, "fps can not be 0");
 	
 	if (p_node->hasAttribute("duration"))
 	{
-		m_usingDuration = true;
-		m_frameDuration = parsePresentationValue(p_node, "duration", &errStatus);
+		def.usingDuration = true;
+		def.frameDuration = parsePresentationValue(p_node, "duration", &errStatus);
 	}
 	else
 	{
-		m_usingDuration = false;
+		def.usingDuration = false;
 	}
 	
-	m_loaded = true;
+	def.loaded = true;
+	m_cameraSpaceScale = def.cameraSpaceScale;
 	
 	return true;
 }
@@ -691,46 +674,47 @@ bool FrameAnimation::loadXml( const xml::XmlNode* p_node, const DataTags& p_appl
 
 bool FrameAnimation::parseSpriteStripDirectory(const std::string& p_directory, code::ErrorStatus* p_errStatus)
 {
+	Definition& def(modifyDefinition());
 	TT_ERR_CHAIN(bool, false, "Parsing SpriteStrip Directory");
 	
-	m_spriteDirectory = p_directory;
+	def.spriteDirectory = p_directory;
 
 	// HACK: Special case to use the DRC live framebuffer as a texture in presentation
-	if(m_spriteDirectory == "use_drc_framebuffer")
+	if(def.spriteDirectory == "use_drc_framebuffer")
 	{
-		m_usingDirectory = false;
-		m_spritestripID = engine::EngineID("drc_framebuffer","drc");
-		m_spriteDirectory.clear();
-		m_frameSizeX.setValue(1.0f);
-		m_frameSizeY.setValue(1.0f);
+		def.usingDirectory = false;
+		def.spritestripID = engine::EngineID("drc_framebuffer","drc");
+		def.spriteDirectory.clear();
+		def.frameSizeX.setValue(1.0f);
+		def.frameSizeY.setValue(1.0f);
 		return true;
 	}
 	
 	SpriteStrip::SpriteStripData spriteData;
-	if(SpriteStrip::load(m_spriteDirectory, spriteData, &errStatus) == false)
+	if(SpriteStrip::load(def.spriteDirectory, spriteData, &errStatus) == false)
 	{
 		TT_ERR_RETURN_ON_ERROR();
 	}
 	else
 	{
-		m_frameSizeX.setValue(spriteData.frameSize.x);
-		m_frameSizeY.setValue(spriteData.frameSize.y);
-
-		m_frameSize.setValues(m_frameSizeX, m_frameSizeY);
-
-		m_totalFrames = spriteData.totalFrameCount;
-		TT_ERR_ASSERTMSG(m_beginFrame.getMax() < m_totalFrames, 
-			"Begin frame "<< m_beginFrame.toStr() << "(" << m_beginFrame.get() << ")" <<
-			" exceeds total number of frames available: " << m_totalFrames);
-		TT_ERR_ASSERTMSG(m_endFrame.getMax() < m_totalFrames, 
-			"End frame " << m_endFrame.toStr() << "(" << m_endFrame.get() << ")" <<
-			" exceeds total number of frames available: " << m_totalFrames);
+		def.frameSizeX.setValue(spriteData.frameSize.x);
+		def.frameSizeY.setValue(spriteData.frameSize.y);
+
+		m_frameSize.setValues(def.frameSizeX, def.frameSizeY);
+
+		def.totalFrames = spriteData.totalFrameCount;
+		TT_ERR_ASSERTMSG(def.beginFrame.getMax() < def.totalFrames, 
+			"Begin frame "<< def.beginFrame.toStr() << "(" << def.beginFrame.get() << ")" <<
+			" exceeds total number of frames available: " << def.totalFrames);
+		TT_ERR_ASSERTMSG(def.endFrame.getMax() < def.totalFrames, 
+			"End frame " << def.endFrame.toStr() << "(" << def.endFrame.get() << ")" <<
+			" exceeds total number of frames available: " << def.totalFrames);
 	}
 	
-	m_spritestripID = engine::EngineID(spriteData.spriteStripName, spriteData.spriteStripNamespace);
-	m_lightmaskID   = engine::EngineID("lightmask_" + spriteData.spriteStripName, spriteData.spriteStripNamespace);
+	def.spritestripID = engine::EngineID(spriteData.spriteStripName, spriteData.spriteStripNamespace);
+	def.lightmaskID   = engine::EngineID("lightmask_" + spriteData.spriteStripName, spriteData.spriteStripNamespace);
 	
-	m_usingDirectory = true;
+	def.usingDirectory = true;
 	
 	return true;
 }
@@ -738,6 +722,7 @@ bool FrameAnimation::parseSpriteStripDirectory(const std::string& p_directory, c
 
 bool FrameAnimation::save( u8*& p_bufferOUT, size_t& p_sizeOUT, code::ErrorStatus* p_errStatus )
 {
+	const Definition& def(getDefinition());
 	TT_ERR_CHAIN(bool, false, "Saving Frame animation");
 	
 	TT_ERR_ASSERTMSG(getBufferSize() <= p_sizeOUT, "Not enough space in buffer need " <<
@@ -747,62 +732,62 @@ bool FrameAnimation::save( u8*& p_bufferOUT, size_t& p_sizeOUT, code::ErrorStatu
 	
 	be_put(s_version, p_bufferOUT, p_sizeOUT);
 	
-	m_beginFrame.save(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_endFrame.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.beginFrame.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.endFrame.save(p_bufferOUT, p_sizeOUT, &errStatus);
 	
-	m_quadSizeX.save(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_quadSizeY.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.quadSizeX.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.quadSizeY.save(p_bufferOUT, p_sizeOUT, &errStatus);
 	
-	be_put(m_holdFirstFrame, p_bufferOUT, p_sizeOUT);
-	be_put(m_holdLastFrame,  p_bufferOUT, p_sizeOUT);
+	be_put(def.holdFirstFrame, p_bufferOUT, p_sizeOUT);
+	be_put(def.holdLastFrame,  p_bufferOUT, p_sizeOUT);
 	
-	be_put(m_usingDirectory, p_bufferOUT, p_sizeOUT);
+	be_put(def.usingDirectory, p_bufferOUT, p_sizeOUT);
 	
-	be_put(m_flip, p_bufferOUT, p_sizeOUT);
+	be_put(def.flip, p_bufferOUT, p_sizeOUT);
 	
-	be_put(static_cast<u8>(m_minFilter), p_bufferOUT, p_sizeOUT);
-	be_put(static_cast<u8>(m_magFilter), p_bufferOUT, p_sizeOUT);
-	be_put(static_cast<u8>(m_mipFilter), p_bufferOUT, p_sizeOUT);
-	be_put(static_cast<u8>(m_blendMode), p_bufferOUT, p_sizeOUT);
+	be_put(static_cast<u8>(def.minFilter), p_bufferOUT, p_sizeOUT);
+	be_put(static_cast<u8>(def.magFilter), p_bufferOUT, p_sizeOUT);
+	be_put(static_cast<u8>(def.mipFilter), p_bufferOUT, p_sizeOUT);
+	be_put(static_cast<u8>(def.blendMode), p_bufferOUT, p_sizeOUT);
 	// NOTE: Added specific template type so we know when type changes in bitmask (Format changed.)
-	be_put<u32>(m_flags.getFlags()     , p_bufferOUT, p_sizeOUT);
-	be_put(m_passName, p_bufferOUT, p_sizeOUT);
-	
-	m_fps.save(p_bufferOUT, p_sizeOUT, &errStatus);
-	
-	m_translationX.save(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_translationY.save(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_translationZ.save(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_scaleX      .save(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_scaleY      .save(p_bufferOUT, p_sizeOUT, &errStatus);
-	be_put(m_isUniformScale, p_bufferOUT, p_sizeOUT);
-	m_rotation    .save(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_texAnimU    .save(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_texAnimV    .save(p_bufferOUT, p_sizeOUT, &errStatus);
-	
-	if(m_usingDirectory)
+	be_put<u32>(def.flags.getFlags()     , p_bufferOUT, p_sizeOUT);
+	be_put(def.passName, p_bufferOUT, p_sizeOUT);
+	
+	def.fps.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	
+	def.translationX.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.translationY.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.translationZ.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.scaleX      .save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.scaleY      .save(p_bufferOUT, p_sizeOUT, &errStatus);
+	be_put(def.isUniformScale, p_bufferOUT, p_sizeOUT);
+	def.rotation    .save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.texAnimU    .save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.texAnimV    .save(p_bufferOUT, p_sizeOUT, &errStatus);
+	
+	if(def.usingDirectory)
 	{
-		be_put(m_spriteDirectory, p_bufferOUT, p_sizeOUT);
+		be_put(def.spriteDirectory, p_bufferOUT, p_sizeOUT);
 	}
 	else
 	{
-		m_frameSizeX.save(p_bufferOUT, p_sizeOUT, &errStatus);
-		m_frameSizeY.save(p_bufferOUT, p_sizeOUT, &errStatus);
+		def.frameSizeX.save(p_bufferOUT, p_sizeOUT, &errStatus);
+		def.frameSizeY.save(p_bufferOUT, p_sizeOUT, &errStatus);
 
-		be_put(m_spritestripID.crc1, p_bufferOUT, p_sizeOUT);
-		be_put(m_spritestripID.crc2, p_bufferOUT, p_sizeOUT);
-		be_put(m_lightmaskID.crc1,   p_bufferOUT, p_sizeOUT);
-		be_put(m_lightmaskID.crc2,   p_bufferOUT, p_sizeOUT);
+		be_put(def.spritestripID.crc1, p_bufferOUT, p_sizeOUT);
+		be_put(def.spritestripID.crc2, p_bufferOUT, p_sizeOUT);
+		be_put(def.lightmaskID.crc1,   p_bufferOUT, p_sizeOUT);
+		be_put(def.lightmaskID.crc2,   p_bufferOUT, p_sizeOUT);
 	}
 	
-	be_put(m_usingDuration, p_bufferOUT, p_sizeOUT);
-	if (m_usingDuration)
+	be_put(def.usingDuration, p_bufferOUT, p_sizeOUT);
+	if (def.usingDuration)
 	{
-		m_frameDuration.save(p_bufferOUT, p_sizeOUT, &errStatus);
+		def.frameDuration.save(p_bufferOUT, p_sizeOUT, &errStatus);
 	}
 	
-	be_put(m_cameraSpaceScale, p_bufferOUT, p_sizeOUT);
-	be_put(static_cast<u8>(m_lightMaskType), p_bufferOUT, p_sizeOUT);
+	be_put(def.cameraSpaceScale, p_bufferOUT, p_sizeOUT);
+	be_put(static_cast<u8>(def.lightMaskType), p_bufferOUT, p_sizeOUT);
 	
 	TT_ERR_RETURN_ON_ERROR();
 	
@@ -813,6 +798,7 @@ bool FrameAnimation::save( u8*& p_bufferOUT, size_t& p_sizeOUT, code::ErrorStatu
 bool FrameAnimation::load(const u8*& p_bufferOUT, size_t& p_sizeOUT, const DataTags& p_applyTags,
                           const Tags& p_acceptedTags, code::ErrorStatus* p_errStatus )
 {
+	Definition& def(modifyDefinition());
 	TT_ERR_CHAIN(bool, false, "loading frameAnimation");
 	
 	using namespace code::bufferutils;
@@ -823,132 +809,134 @@ bool FrameAnimation::load(const u8*& p_bufferOUT, size_t& p_sizeOUT, const DataT
 			<< GET_MAJOR_VERSION(version)   << "." <<GET_MINOR_VERSION(version)  <<
 			", Please update your presentation converter");
 	
-	m_beginFrame.load(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_endFrame.setValue(0.0f);
-	m_endFrame  .load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.beginFrame.load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.endFrame.setValue(0.0f);
+	def.endFrame  .load(p_bufferOUT, p_sizeOUT, &errStatus);
 	
-	m_quadSizeX.load(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_quadSizeY.load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.quadSizeX.load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.quadSizeY.load(p_bufferOUT, p_sizeOUT, &errStatus);
 	
-	m_holdFirstFrame = be_get<bool>(p_bufferOUT, p_sizeOUT);
-	m_holdLastFrame  = be_get<bool>(p_bufferOUT, p_sizeOUT);
+	def.holdFirstFrame = be_get<bool>(p_bufferOUT, p_sizeOUT);
+	def.holdLastFrame  = be_get<bool>(p_bufferOUT, p_sizeOUT);
 	
-	m_usingDirectory = be_get<bool>(p_bufferOUT, p_sizeOUT);
+	def.usingDirectory = be_get<bool>(p_bufferOUT, p_sizeOUT);
 	
-	m_flip = be_get<u32>(p_bufferOUT, p_sizeOUT);
+	def.flip = be_get<u32>(p_bufferOUT, p_sizeOUT);
 	
-	m_minFilter  = static_cast<engine::renderer::FilterMode>(be_get<u8>(p_bufferOUT, p_sizeOUT));
-	m_magFilter  = static_cast<engine::renderer::FilterMode>(be_get<u8>(p_bufferOUT, p_sizeOUT));
-	m_mipFilter  = static_cast<engine::renderer::FilterMode>(be_get<u8>(p_bufferOUT, p_sizeOUT));
-	m_blendMode  = static_cast<engine::renderer::BlendMode> (be_get<u8>(p_bufferOUT, p_sizeOUT));
-	m_flags      = Flags(                                    be_get<u32>(p_bufferOUT, p_sizeOUT));
+	def.minFilter  = static_cast<engine::renderer::FilterMode>(be_get<u8>(p_bufferOUT, p_sizeOUT));
+	def.magFilter  = static_cast<engine::renderer::FilterMode>(be_get<u8>(p_bufferOUT, p_sizeOUT));
+	def.mipFilter  = static_cast<engine::renderer::FilterMode>(be_get<u8>(p_bufferOUT, p_sizeOUT));
+	def.blendMode  = static_cast<engine::renderer::BlendMode> (be_get<u8>(p_bufferOUT, p_sizeOUT));
+	def.flags      = Flags(                                    be_get<u32>(p_bufferOUT, p_sizeOUT));
 	
-	m_passName  = be_get<std::string>(p_bufferOUT, p_sizeOUT);
+	def.passName  = be_get<std::string>(p_bufferOUT, p_sizeOUT);
 	
-	m_fps.load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.fps.load(p_bufferOUT, p_sizeOUT, &errStatus);
 	
-	m_translationX.load(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_translationY.load(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_translationZ.load(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_scaleX      .load(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_scaleY      .load(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_isUniformScale = be_get<bool>(p_bufferOUT, p_sizeOUT);
-	m_rotation    .load(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_texAnimU    .load(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_texAnimV    .load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.translationX.load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.translationY.load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.translationZ.load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.scaleX      .load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.scaleY      .load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.isUniformScale = be_get<bool>(p_bufferOUT, p_sizeOUT);
+	def.rotation    .load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.texAnimU    .load(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.texAnimV    .load(p_bufferOUT, p_sizeOUT, &errStatus);
 	
-	if(m_usingDirectory)
+	if(def.usingDirectory)
 	{
-		m_spriteDirectory = be_get<std::string>(p_bufferOUT, p_sizeOUT);
+		def.spriteDirectory = be_get<std::string>(p_bufferOUT, p_sizeOUT);
 		
 		// loading sprite strip and meta data
 		SpriteStrip::SpriteStripData spriteData;
-		if(SpriteStrip::load(m_spriteDirectory, spriteData, &errStatus) == false)
+		if(SpriteStrip::load(def.spriteDirectory, spriteData, &errStatus) == false)
 		{
 			TT_ERR_RETURN_ON_ERROR();
 		}
-		m_frameSizeX.setValue(spriteData.frameSize.x);
-		m_frameSizeY.setValue(spriteData.frameSize.y);
-		m_totalFrames = spriteData.totalFrameCount;
+		def.frameSizeX.setValue(spriteData.frameSize.x);
+		def.frameSizeY.setValue(spriteData.frameSize.y);
+		def.totalFrames = spriteData.totalFrameCount;
 		
-		TT_ERR_ASSERTMSG(m_beginFrame.getMin() >= 0 && m_beginFrame.getMax() < m_totalFrames, 
+		TT_ERR_ASSERTMSG(def.beginFrame.getMin() >= 0 && def.beginFrame.getMax() < def.totalFrames, 
 			"Sprite strip: " << spriteData.spriteStripName <<
-			"\nBegin frame: '"<< m_beginFrame << "'" <<
-			" has to be in the range [0.." << (m_totalFrames-1) << "]");
-		TT_ERR_ASSERTMSG(m_endFrame.getMin() >= 0 && m_endFrame.getMax() < m_totalFrames, 
+			"\nBegin frame: '"<< def.beginFrame << "'" <<
+			" has to be in the range [0.." << (def.totalFrames-1) << "]");
+		TT_ERR_ASSERTMSG(def.endFrame.getMin() >= 0 && def.endFrame.getMax() < def.totalFrames, 
 			"Sprite strip: " << spriteData.spriteStripName <<
-			"\nEnd frame: '" << m_endFrame << "'" <<
-			" has to be in the range [0.." << (m_totalFrames-1) << "]");
+			"\nEnd frame: '" << def.endFrame << "'" <<
+			" has to be in the range [0.." << (def.totalFrames-1) << "]");
 		
-		m_spritestripID = engine::EngineID(spriteData.spriteStripName, spriteData.spriteStripNamespace);
-		m_lightmaskID   = engine::EngineID("lightmask_" + spriteData.spriteStripName, spriteData.spriteStripNamespace);
+		def.spritestripID = engine::EngineID(spriteData.spriteStripName, spriteData.spriteStripNamespace);
+		def.lightmaskID   = engine::EngineID("lightmask_" + spriteData.spriteStripName, spriteData.spriteStripNamespace);
 	}
 	else
 	{
-		m_frameSizeX.load(p_bufferOUT, p_sizeOUT, &errStatus);
-		m_frameSizeY.load(p_bufferOUT, p_sizeOUT, &errStatus);
+		def.frameSizeX.load(p_bufferOUT, p_sizeOUT, &errStatus);
+		def.frameSizeY.load(p_bufferOUT, p_sizeOUT, &errStatus);
 		
-		m_spritestripID.crc1      = be_get<u32>(p_bufferOUT, p_sizeOUT);
-		m_spritestripID.crc2      = be_get<u32>(p_bufferOUT, p_sizeOUT);
-		m_lightmaskID.crc1        = be_get<u32>(p_bufferOUT, p_sizeOUT);
-		m_lightmaskID.crc2        = be_get<u32>(p_bufferOUT, p_sizeOUT);
+		def.spritestripID.crc1      = be_get<u32>(p_bufferOUT, p_sizeOUT);
+		def.spritestripID.crc2      = be_get<u32>(p_bufferOUT, p_sizeOUT);
+		def.lightmaskID.crc1        = be_get<u32>(p_bufferOUT, p_sizeOUT);
+		def.lightmaskID.crc2        = be_get<u32>(p_bufferOUT, p_sizeOUT);
 	}
 	
-	m_usingDuration = be_get<bool>(p_bufferOUT, p_sizeOUT);
-	if (m_usingDuration)
+	def.usingDuration = be_get<bool>(p_bufferOUT, p_sizeOUT);
+	if (def.usingDuration)
 	{
-		m_frameDuration.load(p_bufferOUT, p_sizeOUT, &errStatus);
+		def.frameDuration.load(p_bufferOUT, p_sizeOUT, &errStatus);
 	}
 
-	m_cameraSpaceScale = be_get<math::Vector2>(p_bufferOUT, p_sizeOUT);
+	def.cameraSpaceScale = be_get<math::Vector2>(p_bufferOUT, p_sizeOUT);
 
-	m_lightMaskType = static_cast<LightMaskType>(be_get<u8>(p_bufferOUT, p_sizeOUT));
+	def.lightMaskType = static_cast<LightMaskType>(be_get<u8>(p_bufferOUT, p_sizeOUT));
 	
 	TT_ERR_RETURN_ON_ERROR();
 	
 	Animation2D::load(p_bufferOUT, p_sizeOUT, p_applyTags, p_acceptedTags, &errStatus);
 	TT_ERR_RETURN_ON_ERROR();
 	
-	m_loaded = true;
+	def.loaded = true;
+	m_cameraSpaceScale = def.cameraSpaceScale;
 	return true;
 }
 
 
 size_t FrameAnimation::getBufferSize() const
 {
+	const Definition& def(getDefinition());
 	// beginFrame + endFrame + 
-	size_t size(m_beginFrame.getBufferSize() + m_endFrame.getBufferSize() +
+	size_t size(def.beginFrame.getBufferSize() + def.endFrame.getBufferSize() +
 		// quadsize + hold last frame + hold first frame + 
-		m_quadSizeX.getBufferSize() + m_quadSizeY.getBufferSize() + 1 + 1);
+		def.quadSizeX.getBufferSize() + def.quadSizeY.getBufferSize() + 1 + 1);
 	
 	//animation2d + version + useDirectory + flip bitmask + filtermode/blendmode bytes + fps +
-	size += Animation2D::getBufferSize() + 2 + 1 + 4 + 4 + m_fps.getBufferSize() +
+	size += Animation2D::getBufferSize() + 2 + 1 + 4 + 4 + def.fps.getBufferSize() +
 		// Flag bitmask
 		4 +
 		// passname + size
-		2 + m_passName.size() +
+		2 + def.passName.size() +
 		// position offset x, y & z
-		m_translationX.getBufferSize() + m_translationY.getBufferSize() + m_translationZ.getBufferSize() +
-		m_scaleX.getBufferSize() + m_scaleY.getBufferSize() + sizeof(m_isUniformScale) + 
-		m_rotation.getBufferSize() + m_texAnimU.getBufferSize() + m_texAnimV.getBufferSize();
+		def.translationX.getBufferSize() + def.translationY.getBufferSize() + def.translationZ.getBufferSize() +
+		def.scaleX.getBufferSize() + def.scaleY.getBufferSize() + sizeof(def.isUniformScale) + 
+		def.rotation.getBufferSize() + def.texAnimU.getBufferSize() + def.texAnimV.getBufferSize();
 	
-	if(m_usingDirectory)
+	if(def.usingDirectory)
 	{
 		// spritedirectoryStringsize + spriteDirectory
-		size += 2 + m_spriteDirectory.size();
+		size += 2 + def.spriteDirectory.size();
 	}
 	else
 	{
 		// frameSize + 
-		size += m_frameSizeX.getBufferSize() + m_frameSizeY.getBufferSize() +
+		size += def.frameSizeX.getBufferSize() + def.frameSizeY.getBufferSize() +
 			// EngineID CRCs for lightmask & spritestrip
 			4 * sizeof(u32);
 	}
 	// usingDuration
 	size += 1;
-	if (m_usingDuration) size += m_frameDuration.getBufferSize();
+	if (def.usingDuration) size += def.frameDuration.getBufferSize();
 
-	size += sizeof(m_cameraSpaceScale) + 1; // 1 byte for m_lightMaskType
+	size += sizeof(def.cameraSpaceScale) + 1; // 1 byte for lightMaskType
 	
 	return size;
 }
@@ -956,45 +944,51 @@ size_t FrameAnimation::getBufferSize() const
 
 void FrameAnimation::makeDefault()
 {
-	m_totalFrames = 1;
-	m_holdLastFrame = true;
-	m_holdFirstFrame = true;
-	m_beginFrame.setValue(0);
-	m_endFrame.setValue(0);
+	Definition& def(modifyDefinition());
+	
+	def.totalFrames = 1;
+	def.holdLastFrame = true;
+	def.holdFirstFrame = true;
+	def.beginFrame.setValue(0);
+	def.endFrame.setValue(0);
 	m_frameDifference = 0;
 	m_frameBegin      = 0;
 	m_frameCount.setValues(1,1);
 	m_texture = engine::renderer::TextureCache::getDefault();
-	m_frameSizeX.setValue(1);
-	m_frameSizeY.setValue(1);
+	def.frameSizeX.setValue(1);
+	def.frameSizeY.setValue(1);
 	m_frameSize.setValues(1,1);
 	
 	m_quad.reset(new PresentationQuad(m_texture, engine::renderer::ColorRGBA()));
 	updateTextureAndQuadWithPresentationValues();
 	
-	m_quadSizeX.setValue(0.0f);
-	m_quadSizeY.setValue(0.0f);
-	
-	m_fps.setValue(0.0f);
-	
-	m_translationX.setValue(0.0f);
-	m_translationY.setValue(0.0f);
-	m_translationZ.setValue(0.0f);
-	m_scaleX      .setValue(1.0f);
-	m_scaleY      .setValue(1.0f);
-	m_isUniformScale = false;
-	m_rotation    .setValue(0.0f);
-	m_texAnimU    .setValue(0.0f);
-	m_texAnimV    .setValue(0.0f);
+	def.quadSizeX.setValue(0.0f);
+	def.quadSizeY.setValue(0.0f);
+	m_quadSize.setValues(0.0f, 0.0f);
+	
+	def.fps.setValue(0.0f);
+	
+	def.translationX.setValue(0.0f);
+	def.translationY.setValue(0.0f);
+	def.translationZ.setValue(0.0f);
+	def.scaleX      .setValue(1.0f);
+	def.scaleY      .setValue(1.0f);
+	def.isUniformScale = false;
+	def.rotation    .setValue(0.0f);
+	def.texAnimU    .setValue(0.0f);
+	def.texAnimV    .setValue(0.0f);
+	m_translation .setValues(0.0f, 0.0f, 0.0f);
+	m_scale       .setValues(1.0f, 1.0f);
+	m_rotation = 0.0f;
 
 	m_animationUV .setValues(0.0f, 0.0f);
 	m_offsetUV    .setValues(0.0f, 0.0f);
 	
-	m_usingDirectory = false;
+	def.usingDirectory = false;
 	
-	m_loaded = true;
+	def.loaded = true;
 	
-	m_usingDuration = false;
+	def.usingDuration = false;
 }
 
 
@@ -1016,52 +1010,43 @@ std::string FrameAnimation::parseOptionalString( const xml::XmlNode* p_node,
 
 void FrameAnimation::setRanges(PresentationObject* p_presObj)
 {
-	m_frameSizeX.updateValue(p_presObj);
-	m_frameSizeY.updateValue(p_presObj);
-	m_frameSize.setValues(m_frameSizeX, m_frameSizeY);
-	m_quadSizeX.updateValue(p_presObj);
-	m_quadSizeY.updateValue(p_presObj);
-	
-	m_fps.updateValue(p_presObj);
-	
-	m_beginFrame.updateValue(p_presObj);
-	m_endFrame.updateValue(p_presObj);
-	m_frameDifference = static_cast<s32>(m_endFrame.get() - m_beginFrame.get());
-	m_frameBegin      = static_cast<s32>(m_beginFrame.get());
-	
-	m_translationX.updateValue(p_presObj);
-	m_translationY.updateValue(p_presObj);
-	m_translationZ.updateValue(p_presObj);
-	m_scaleX      .updateValue(p_presObj);
-	if (m_isUniformScale)
-	{
-		m_scaleY.setValue(m_scaleX.get());
-	}
-	else
-	{
-		m_scaleY.updateValue(p_presObj);
-	}
+	// The definition is shared, so the values picked for this start are kept in this animation
+	const Definition& def(getDefinition());
+	
+	m_frameSize.setValues(def.frameSizeX.getUpdatedValue(p_presObj),
+	                      def.frameSizeY.getUpdatedValue(p_presObj));
+	m_quadSize.setValues(def.quadSizeX.getUpdatedValue(p_presObj),
+	                     def.quadSizeY.getUpdatedValue(p_presObj));
+	
+	const real fps = def.fps.getUpdatedValue(p_presObj);
+	
+	const real beginFrame = def.beginFrame.getUpdatedValue(p_presObj);
+	const real endFrame   = def.endFrame  .getUpdatedValue(p_presObj);
+	m_frameDifference = static_cast<s32>(endFrame - beginFrame);
+	m_frameBegin      = static_cast<s32>(beginFrame);
+	
+	m_translation.x = def.translationX.getUpdatedValue(p_presObj);
+	m_translation.y = def.translationY.getUpdatedValue(p_presObj);
+	m_translation.z = def.translationZ.getUpdatedValue(p_presObj);
+	m_scale.x       = def.scaleX      .getUpdatedValue(p_presObj);
+	m_scale.y       = (def.isUniformScale) ? m_scale.x : def.scaleY.getUpdatedValue(p_presObj);
 	
-	m_rotation    .updateValue(p_presObj);
-	m_texAnimU    .updateValue(p_presObj);
-	m_texAnimV    .updateValue(p_presObj);
+	m_rotation                  = def.rotation.getUpdatedValue(p_presObj);
+	const math::Vector2 texAnim(def.texAnimU.getUpdatedValue(p_presObj),
+	                            def.texAnimV.getUpdatedValue(p_presObj));
 	
 	updateTextureAndQuadWithPresentationValues();
 	
-	if (m_usingDuration)
+	if (def.usingDuration)
 	{
-		m_frameDuration.updateValue(p_presObj);
-		m_durationTimeLeft = m_frameDuration.get();
+		m_durationTimeLeft = def.frameDuration.getUpdatedValue(p_presObj);
 	}
 	
 	// calc duration from fps
-	real fps = m_fps;
-	
-	fps = (getFrameDifference() + 1) / fps;
+	real duration = (getFrameDifference() + 1) / fps;
 
 	// Get UV animation speed
-	m_animationUV.x = m_texAnimU;
-	m_animationUV.y = m_texAnimV;
+	m_animationUV = texAnim;
 
 	m_offsetUV.setValues(0,0);
 
@@ -1069,10 +1054,10 @@ void FrameAnimation::setRanges(PresentationObject* p_presObj)
 	if (getDirection() == Animation2D::DirectionType_PingPong || 
 	    getDirection() == Animation2D::DirectionType_ReversePingPong)
 	{
-		fps *= 2;
+		duration *= 2;
 	}
 	
-	setDuration(fps);
+	setDuration(duration);
 	
 	Animation2D::setRanges(p_presObj);
 }
@@ -1080,12 +1065,14 @@ void FrameAnimation::setRanges(PresentationObject* p_presObj)
 
 void FrameAnimation::updateTextureAndQuadWithPresentationValues()
 {
+	const Definition& def(getDefinition());
+	
 	if (m_texture != 0)
 	{
 		using namespace tt::engine::renderer;
 		
-		m_frameCount.x = static_cast<s32>(1.0f / m_frameSizeX);
-		m_frameCount.y = static_cast<s32>(1.0f / m_frameSizeY);
+		m_frameCount.x = static_cast<s32>(1.0f / m_frameSize.x);
+		m_frameCount.y = static_cast<s32>(1.0f / m_frameSize.y);
 		
 		// If the frame is animating or larger than the texture, allow repeating
 		AddressMode addressModeU(AddressMode_Clamp);
@@ -1115,14 +1102,14 @@ void FrameAnimation::updateTextureAndQuadWithPresentationValues()
 	
 	if (m_quad != 0)
 	{
-		if(m_quadSizeX != 0 && m_quadSizeY != 0)
+		if(m_quadSize.x != 0 && m_quadSize.y != 0)
 		{
-			m_quad->setWidth(m_quadSizeX);
-			m_quad->setHeight(m_quadSizeY);
+			m_quad->setWidth(m_quadSize.x);
+			m_quad->setHeight(m_quadSize.y);
 
 			// This will probably be problematic if createQuad is called multiple times...
-			m_cameraSpaceScale.x *= 1.0f / m_quadSizeX;
-			m_cameraSpaceScale.y *= 1.0f / m_quadSizeY;
+			m_cameraSpaceScale.x *= 1.0f / m_quadSize.x;
+			m_cameraSpaceScale.y *= 1.0f / m_quadSize.y;
 		}
 		else
 		{
@@ -1130,20 +1117,20 @@ void FrameAnimation::updateTextureAndQuadWithPresentationValues()
 			m_quad->setHeight(m_frameSize.y * m_texture->getHeight());
 		}
 		
-		if(engine::renderer::isValidBlendMode(m_blendMode))
+		if(engine::renderer::isValidBlendMode(def.blendMode))
 		{
-			m_quad->setBlendMode(m_blendMode);
+			m_quad->setBlendMode(def.blendMode);
 		}
 		
 		math::Vector2 topLeft(0,0);
-		math::Vector2 bottomRight(math::Vector2(m_frameSizeX, m_frameSizeY));
+		math::Vector2 bottomRight(m_frameSize);
 		
-		if((m_flip & Flip_Horizontal) != 0)
+		if((def.flip & Flip_Horizontal) != 0)
 		{
 			// Swap x coordinates
 			std::swap(topLeft.x, bottomRight.x);
 		}
-		if((m_flip & Flip_Vertical) != 0)
+		if((def.flip & Flip_Vertical) != 0)
 		{
 			// Swap y coordinates
 			std::swap(topLeft.y, bottomRight.y);
@@ -1160,53 +1147,80 @@ void FrameAnimation::updateTextureAndQuadWithPresentationValues()
 FrameAnimation::FrameAnimation(const FrameAnimation& p_rhs)
 :
 anim2d::Animation2D(p_rhs),
-m_beginFrame(p_rhs.m_beginFrame),
-m_endFrame(p_rhs.m_endFrame),
+m_definition(p_rhs.m_definition),
 m_frameDifference(p_rhs.m_frameDifference),
 m_frameBegin(p_rhs.m_frameBegin),
-m_totalFrames(p_rhs.m_totalFrames),
 m_frameCount(p_rhs.m_frameCount),
 m_frameSize(p_rhs.m_frameSize),
-m_frameSizeX(p_rhs.m_frameSizeX),
-m_frameSizeY(p_rhs.m_frameSizeY),
-m_quadSizeX(p_rhs.m_quadSizeX),
-m_quadSizeY(p_rhs.m_quadSizeY),
-m_fps(p_rhs.m_fps),
-m_holdFirstFrame(p_rhs.m_holdFirstFrame),
-m_holdLastFrame(p_rhs.m_holdLastFrame),
-m_flip(p_rhs.m_flip),
-m_minFilter(p_rhs.m_minFilter),
-m_magFilter(p_rhs.m_magFilter),
-m_mipFilter(p_rhs.m_mipFilter),
-m_blendMode(p_rhs.m_blendMode),
-m_flags(p_rhs.m_flags),
-m_passName(p_rhs.m_passName),
-m_spritestripID(p_rhs.m_spritestripID),
-m_lightmaskID(p_rhs.m_lightmaskID),
-m_spriteDirectory(p_rhs.m_spriteDirectory),
-m_usingDirectory(p_rhs.m_usingDirectory),
+m_quadSize(p_rhs.m_quadSize),
+m_translation(p_rhs.m_translation),
+m_scale(p_rhs.m_scale),
+m_rotation(p_rhs.m_rotation),
 m_texture(p_rhs.m_texture),
+m_isTextureForVisualBoy(false),
 m_lightmask(p_rhs.m_lightmask),
 m_quad(p_rhs.m_quad == 0 ? PresentationQuadPtr() : p_rhs.m_quad->clone()),
-m_translationX(p_rhs.m_translationX),
-m_translationY(p_rhs.m_translationY),
-m_translationZ(p_rhs.m_translationZ),
-m_scaleX(p_rhs.m_scaleX),
-m_scaleY(p_rhs.m_scaleY),
-m_isUniformScale(p_rhs.m_isUniformScale),
-m_rotation(p_rhs.m_rotation),
-m_texAnimU(p_rhs.m_texAnimU),
-m_texAnimV(p_rhs.m_texAnimV),
-m_loaded(p_rhs.m_loaded),
-m_usingDuration(p_rhs.m_usingDuration),
-m_frameDuration(p_rhs.m_frameDuration),
 m_durationTimeLeft(p_rhs.m_durationTimeLeft),
+m_animationUV(p_rhs.m_animationUV),
 m_offsetUV(p_rhs.m_offsetUV),
-m_cameraSpaceScale(p_rhs.m_cameraSpaceScale),
-m_lightMaskType(p_rhs.m_lightMaskType)
+m_cameraSpaceScale(p_rhs.m_cameraSpaceScale)
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+FrameAnimation::Definition::Definition()
+:
+beginFrame(0),
+endFrame(-1),
+totalFrames(0),
+frameSizeX(0),
+frameSizeY(0),
+quadSizeX(0),
+quadSizeY(0),
+fps(1),
+holdFirstFrame(true),
+holdLastFrame(true),
+flip(Flip_None),
+minFilter(engine::renderer::FilterMode_Invalid),
+magFilter(engine::renderer::FilterMode_Invalid),
+mipFilter(engine::renderer::FilterMode_Invalid),
+blendMode(engine::renderer::BlendMode_Invalid),
+flags(),
+passName(),
+spritestripID(0,0),
+lightmaskID(0,0),
+spriteDirectory(),
+usingDirectory(false),
+translationX(0.0),
+translationY(0.0),
+translationZ(0.0),
+scaleX(1.0f),
+scaleY(1.0f),
+isUniformScale(false),
+rotation(0.0f),
+texAnimU(0),
+texAnimV(0),
+loaded(false),
+usingDuration(false),
+frameDuration(),
+cameraSpaceScale(0,0),
+lightMaskType(LightMaskType_None)
 {
 }
 
+
+FrameAnimation::Definition& FrameAnimation::modifyDefinition()
+{
+	if (m_definition.use_count() > 1)
+	{
+		m_definition.reset(new Definition(*m_definition));
+	}
+	return *m_definition;
+}
+
 //namespace end
 }
 }
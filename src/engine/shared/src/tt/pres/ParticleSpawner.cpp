@@ -75,14 +75,10 @@ ParticleSpawnerPtr ParticleSpawner::loadBin(const u8*& p_bufferOUT, size_t& p_si
 	
 	TT_ERR_RETURN_ON_ERROR();
 	
-	ParticleSpawnerPtr spawner(new ParticleSpawner(info, triggerFile, posType, positionOffsetX,
-	                                               positionOffsetY, positionOffsetZ, scale,
-	                                               p_followObject, p_particleCategory,
-	                                               renderGroup, layerName ));
-	
-	spawner->m_useObjectFlip = useObjectFlip;
-	
-	return spawner;
+	return ParticleSpawnerPtr(new ParticleSpawner(info, triggerFile, posType, positionOffsetX,
+	                                              positionOffsetY, positionOffsetZ, scale,
+	                                              p_followObject, p_particleCategory,
+	                                              renderGroup, layerName, useObjectFlip));
 }
 
 
@@ -146,20 +142,16 @@ ParticleSpawnerPtr ParticleSpawner::loadXml(const xml::XmlNode* p_node, const Da
 	
 	TT_ERR_RETURN_ON_ERROR();
 	
-	ParticleSpawnerPtr spawner(new ParticleSpawner(info, file, positionType, positionOffsetX,
-	                                               positionOffsetY, positionOffsetZ, scale,
-	                                               p_object, p_particleCategory,
-	                                               renderGroup, particleLayer));
-	
-	spawner->m_useObjectFlip = useObjectFlip;
-	
-	return spawner;
+	return ParticleSpawnerPtr(new ParticleSpawner(info, file, positionType, positionOffsetX,
+	                                              positionOffsetY, positionOffsetZ, scale,
+	                                              p_object, p_particleCategory,
+	                                              renderGroup, particleLayer, useObjectFlip.get()));
 }
 
 
 math::Vector3 ParticleSpawner::getPosition() const
 {
-	switch (m_positionType)
+	switch (m_definition->positionType)
 	{
 	case PositionType_FollowOffset:
 		return getWorldPositionWithFollowObject();
@@ -188,7 +180,7 @@ real ParticleSpawner::getScale() const
 
 bool ParticleSpawner::isCulled() const
 {
-	switch (m_positionType)
+	switch (m_definition->positionType)
 	{
 	case PositionType_FollowOffset:
 		{
@@ -220,6 +212,7 @@ void ParticleSpawner::trigger()
 {
 	if (m_particleEffect == 0)
 	{
+		const Definition& def(*m_definition);
 		real scale = m_scale;
 		
 		PresentationObjectPtr followPtr(m_followObject.lock());
@@ -230,7 +223,7 @@ void ParticleSpawner::trigger()
 			scale *= followPtr->getCombinedMatrix().getScaleVectorX();
 		}
 		
-		switch (m_positionType)
+		switch (def.positionType)
 		{
 		case PositionType_FollowOffset:
 			// create a particle trigger that follows the object
@@ -238,30 +231,30 @@ void ParticleSpawner::trigger()
 			//m_particleEffect = particles::ParticleMgr::getInstance()->spawnContinuous(
 			//	m_triggerFile, m_this, true);
 			m_particleEffect = engine::particles::ParticleMgr::getInstance()->createEffect(
-					m_triggerFile, this, m_particleCategory, scale, m_renderGroup);
+					def.triggerFile, this, def.particleCategory, scale, m_renderGroup);
 			break;
 			
 		case PositionType_RelativeOffset:
 			// create a particle trigger at the current position with an offset
 			m_particleEffect = engine::particles::ParticleMgr::getInstance()->createEffect(
-					m_triggerFile, getWorldPositionWithFollowObject(),
-					m_particleCategory, scale, m_renderGroup);
+					def.triggerFile, getWorldPositionWithFollowObject(),
+					def.particleCategory, scale, m_renderGroup);
 			break;
 			
 		case PositionType_WorldPosition:
 			// create a particle trigger in the world
 			m_particleEffect = engine::particles::ParticleMgr::getInstance()->createEffect(
-					m_triggerFile, getPositionOffset(), m_particleCategory, scale, m_renderGroup);
+					def.triggerFile, getPositionOffset(), def.particleCategory, scale, m_renderGroup);
 			break;
 			
 		default:
-			TT_PANIC("Unsupported particle spawning PositionType: %d", m_positionType);
+			TT_PANIC("Unsupported particle spawning PositionType: %d", def.positionType);
 			break;
 		}
 		
 		if (m_particleEffect != 0)
 		{
-			if (m_useObjectFlip)
+			if (def.useObjectFlip)
 			{
 				m_particleEffect->flip(m_flipMask);
 			}
@@ -272,7 +265,7 @@ void ParticleSpawner::trigger()
 		{
 			TT_PANIC("Spawning presentation-triggered particle effect '%s' failed. "
 			         "Particle effect may not exist.",
-			         m_triggerFile.c_str());
+			         def.triggerFile.c_str());
 		}
 	}
 }
@@ -325,20 +318,22 @@ bool ParticleSpawner::save( u8*& p_bufferOUT, size_t& p_sizeOUT, code::ErrorStat
 	
 	using namespace code::bufferutils;
 	
+	const Definition& def(*m_definition);
+	
 	be_put(s_version, p_bufferOUT, p_sizeOUT);
 	
-	be_put(m_triggerFile,     p_bufferOUT, p_sizeOUT);
-	be_put(m_renderGroupName, p_bufferOUT, p_sizeOUT);
+	be_put(def.triggerFile,     p_bufferOUT, p_sizeOUT);
+	be_put(def.renderGroupName, p_bufferOUT, p_sizeOUT);
 	
-	m_positionOffsetX.save(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_positionOffsetY.save(p_bufferOUT, p_sizeOUT, &errStatus);
-	m_positionOffsetZ.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.positionOffsetX.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.positionOffsetY.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	def.positionOffsetZ.save(p_bufferOUT, p_sizeOUT, &errStatus);
 	
-	be_put(static_cast<u8>(m_positionType), p_bufferOUT, p_sizeOUT);
-	m_scale.save(p_bufferOUT, p_sizeOUT, &errStatus);
-	be_put(m_useObjectFlip, p_bufferOUT, p_sizeOUT);
+	be_put(static_cast<u8>(def.positionType), p_bufferOUT, p_sizeOUT);
+	def.scale.save(p_bufferOUT, p_sizeOUT, &errStatus);
+	be_put(def.useObjectFlip, p_bufferOUT, p_sizeOUT);
 	
-	return m_triggerInfo.saveBin(p_bufferOUT, p_sizeOUT, &errStatus);
+	return def.triggerInfo.saveBin(p_bufferOUT, p_sizeOUT, &errStatus);
 }
 
 
@@ -354,28 +349,30 @@ void ParticleSpawner::stopParticles(bool p_kill)
 
 size_t ParticleSpawner::getBufferSize() const
 {
+	const Definition& def(*m_definition);
+	
 	// triggerfileSize + fileString + layerNameSize + layerString + 
-	return 2 + m_triggerFile.size() + 2 + m_renderGroupName.size() + 
+	return 2 + def.triggerFile.size() + 2 + def.renderGroupName.size() + 
 		// positionOffset x, y & z + 
-		m_positionOffsetX.getBufferSize() + m_positionOffsetY.getBufferSize() + m_positionOffsetZ.getBufferSize() + 
-		m_scale.getBufferSize() + 
+		def.positionOffsetX.getBufferSize() + def.positionOffsetY.getBufferSize() + def.positionOffsetZ.getBufferSize() + 
+		def.scale.getBufferSize() + 
 		// positionType + triggerinfo + version
-		1 + m_triggerInfo.getBufferSize() + 2 +
-		1; // m_useObjectFlip(bool) 
+		1 + def.triggerInfo.getBufferSize() + 2 +
+		1; // useObjectFlip(bool) 
 }
 
 
 engine::renderer::TextureContainer ParticleSpawner::getAndLoadAllUsedTextures() const
 {
 	engine::particles::ParticleTrigger triggerInstance(static_cast<WorldObject*>(0), 0);
-	triggerInstance.load(m_triggerFile);
+	triggerInstance.load(m_definition->triggerFile);
 	return triggerInstance.getAndLoadAllUsedTextures();
 }
 
 
 void ParticleSpawner::setFlipMask(u32 p_flipMask)
 {
-	if (m_useObjectFlip)
+	if (m_definition->useObjectFlip)
 	{
 		m_flipMask = p_flipMask;
 	}
@@ -395,33 +392,20 @@ ParticleSpawner::ParticleSpawner(const TriggerInfo&           p_triggerInfo,
                                  const PresentationObjectPtr& p_followObject,
                                  u32                          p_particleCategory,
                                  s32                          p_renderGroup,
-                                 const std::string&           p_renderGroupName)
+                                 const std::string&           p_renderGroupName,
+                                 bool                         p_useObjectFlip)
 :
 TriggerBase(p_triggerInfo),
-m_triggerFile(p_triggerFile),
-m_positionOffsetX(p_positionOffsetX),
-m_positionOffsetY(p_positionOffsetY),
-m_positionOffsetZ(p_positionOffsetZ),
-m_positionType(p_positionType),
-m_scale(p_scale),
+m_definition(new Definition(p_triggerInfo, p_triggerFile, p_positionType,
+                            p_positionOffsetX, p_positionOffsetY, p_positionOffsetZ, p_scale,
+                            p_particleCategory, p_renderGroupName, p_useObjectFlip)),
+m_positionOffset(0.0f, 0.0f, 0.0f),
+m_scale(1.0f),
 m_particleEffect(),
-m_particleCategory(p_particleCategory),
 m_renderGroup(p_renderGroup),
-m_renderGroupName(p_renderGroupName),
 m_followObject(p_followObject),
-m_triggerInfo(p_triggerInfo),
-m_flipMask(0),
-m_useObjectFlip(true)
+m_flipMask(0)
 {
-	if (ms_trySubDir.empty() == false)
-	{
-		const std::string newPath(fs::utils::addSubdirToPath(m_triggerFile, ms_trySubDir));
-		
-		if (fs::fileExists(newPath))
-		{
-			m_triggerFile = newPath;
-		}
-	}
 }
 
 
@@ -429,33 +413,62 @@ ParticleSpawner::ParticleSpawner(const ParticleSpawner& p_rhs)
 :
 TriggerBase(p_rhs),
 engine::particles::WorldObject(),
-m_triggerFile(p_rhs.m_triggerFile),
-m_positionOffsetX(p_rhs.m_positionOffsetX),
-m_positionOffsetY(p_rhs.m_positionOffsetY),
-m_positionOffsetZ(p_rhs.m_positionOffsetZ),
-m_positionType(p_rhs.m_positionType),
+m_definition(p_rhs.m_definition),
+m_positionOffset(p_rhs.m_positionOffset),
 m_scale(p_rhs.m_scale),
 m_particleEffect(p_rhs.m_particleEffect == 0 ? engine::particles::ParticleEffectPtr() :
                                                p_rhs.m_particleEffect->clone()),
-m_particleCategory(p_rhs.m_particleCategory),
 m_renderGroup(p_rhs.m_renderGroup),
-m_renderGroupName(p_rhs.m_renderGroupName),
 m_followObject(p_rhs.m_followObject),
-m_triggerInfo(p_rhs.m_triggerInfo),
-m_flipMask(p_rhs.m_flipMask),
-m_useObjectFlip(p_rhs.m_useObjectFlip)
+m_flipMask(p_rhs.m_flipMask)
 {
 }
 
 
+ParticleSpawner::Definition::Definition(const TriggerInfo&       p_triggerInfo,
+                                        const std::string&       p_triggerFile,
+                                        PositionType             p_positionType,
+                                        const PresentationValue& p_positionOffsetX,
+                                        const PresentationValue& p_positionOffsetY,
+                                        const PresentationValue& p_positionOffsetZ,
+                                        const PresentationValue& p_scale,
+                                        u32                      p_particleCategory,
+                                        const std::string&       p_renderGroupName,
+                                        bool                     p_useObjectFlip)
+:
+triggerFile(p_triggerFile),
+positionOffsetX(p_positionOffsetX),
+positionOffsetY(p_positionOffsetY),
+positionOffsetZ(p_positionOffsetZ),
+positionType(p_positionType),
+scale(p_scale),
+particleCategory(p_particleCategory),
+renderGroupName(p_renderGroupName),
+triggerInfo(p_triggerInfo),
+useObjectFlip(p_useObjectFlip)
+{
+	if (ms_trySubDir.empty() == false)
+	{
+		const std::string newPath(fs::utils::addSubdirToPath(triggerFile, ms_trySubDir));
+		
+		if (fs::fileExists(newPath))
+		{
+			triggerFile = newPath;
+		}
+	}
+}
+
+
 void ParticleSpawner::setRanges(PresentationObject* p_presObj)
 {
 	TriggerBase::setRanges(p_presObj);
 	
-	m_positionOffsetX.updateValue(p_presObj);
-	m_positionOffsetY.updateValue(p_presObj);
-	m_positionOffsetZ.updateValue(p_presObj);
-	m_scale.updateValue(p_presObj);
+	// The definition is shared, so the values picked for this start are kept in this spawner
+	const Definition& def(*m_definition);
+	m_positionOffset.setValues(def.positionOffsetX.getUpdatedValue(p_presObj),
+	                           def.positionOffsetY.getUpdatedValue(p_presObj),
+	                           def.positionOffsetZ.getUpdatedValue(p_presObj));
+	m_scale = def.scale.getUpdatedValue(p_presObj);
 }
 
 
@@ -482,9 +495,9 @@ void ParticleSpawner::setFollowObject(const PresentationObjectPtr& p_followObjec
 	// This is mainly used for Swap This! since in that game sets all particle effect layers were set in the presentations
 	// In other games, the layer is usually set in the effects themselves
 	// although this can still be overrun by setting it in the presentation using the "layer" attribute.
-	if (p_followObject != 0 && m_renderGroupName.empty() == false && p_followObject->getManager() != 0)
+	if (p_followObject != 0 && m_definition->renderGroupName.empty() == false && p_followObject->getManager() != 0)
 	{
-		const s32 newGroup = p_followObject->getManager()->particleRenderGroupFromName(m_renderGroupName);
+		const s32 newGroup = p_followObject->getManager()->particleRenderGroupFromName(m_definition->renderGroupName);
 		if (newGroup != -1)
 		{
 			m_renderGroup = newGroup;
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <vector>
+
+#include <json/json.h>
+
+#include <tt/fs/utils/utils.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+#include <tt/pres/PresentationBenchmark.h>
+#include <tt/pres/PresentationMgr.h>
+#include <tt/pres/PresentationObject.h>
+#include <tt/profiler/Benchmark.h>
+
+
+namespace tt {
+namespace pres {
+
+//--------------------------------------------------------------------------------------------------
+// Helper functions
+
+static inline double toMicroSecondsPerInstance(u64 p_microSeconds, s32 p_iterations, s32 p_instances)
+{
+	return static_cast<double>(p_microSeconds) / (static_cast<double>(p_iterations) * p_instances);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+bool PresentationBenchmark::run(const tt::args::CmdLine& p_cmdLine,
+                                const TriggerFactoryInterfacePtr& p_triggerFactory)
+{
+	using profiler::Benchmark;
+	
+	const std::string presentationPath(Benchmark::getFolder(p_cmdLine, "benchmark_presentation_spawn",
+	                                                        "presentation/"));
+	const std::string outputPath(Benchmark::getOutputPath(p_cmdLine, "benchmark_presentation_spawn.json"));
+	
+	const s32 instanceCount = Benchmark::getCount(p_cmdLine, "benchmark_instances",  1000);
+	const s32 iterations    = Benchmark::getCount(p_cmdLine, "benchmark_iterations", 10);
+	
+	const str::Strings filenames(fs::utils::getRecursiveFileList(presentationPath, "*.pres"));
+	if (filenames.empty())
+	{
+		TT_PANIC("No presentation files found in '%s'.", presentationPath.c_str());
+		return false;
+	}
+	
+	PresentationMgrPtr presentationMgr(PresentationMgr::create(Tags(), p_triggerFactory));
+	
+	Json::Value rootNode(Json::objectValue);
+	rootNode["folder"    ] = presentationPath;
+	rootNode["instances" ] = instanceCount;
+	rootNode["iterations"] = iterations;
+	Json::Value& presentationsNode(rootNode["presentations"]);
+	presentationsNode = Json::Value(Json::arrayValue);
+	
+	typedef std::vector<PresentationObjectPtr> Instances;
+	Instances instances;
+	instances.reserve(static_cast<Instances::size_type>(instanceCount));
+	
+	u64 totalSpawnTime   = 0;
+	u64 totalReleaseTime = 0;
+	
+	for (str::Strings::const_iterator it = filenames.begin(); it != filenames.end(); ++it)
+	{
+		const std::string filename(presentationPath + *it);
+		
+		// Keep one instance alive, so the file is only loaded once and every spawn comes from the cache
+		PresentationObjectPtr cached(presentationMgr->createPresentationObject(filename));
+		if (cached == 0)
+		{
+			continue;
+		}
+		
+		u64 spawnTime   = 0;
+		u64 releaseTime = 0;
+		for (s32 iteration = 0; iteration < iterations; ++iteration)
+		{
+			const u64 spawnStart = Benchmark::getMicroSeconds();
+			for (s32 i = 0; i < instanceCount; ++i)
+			{
+				instances.push_back(presentationMgr->createPresentationObject(filename));
+			}
+			const u64 releaseStart = Benchmark::getMicroSeconds();
+			instances.clear();
+			const u64 releaseEnd = Benchmark::getMicroSeconds();
+			
+			spawnTime   += releaseStart - spawnStart;
+			releaseTime += releaseEnd   - releaseStart;
+		}
+		cached.reset();
+		
+		totalSpawnTime   += spawnTime;
+		totalReleaseTime += releaseTime;
+		
+		Json::Value presentationNode(Json::objectValue);
+		presentationNode["file"     ] = *it;
+		presentationNode["spawnUs"  ] = toMicroSecondsPerInstance(spawnTime,   iterations, instanceCount);
+		presentationNode["releaseUs"] = toMicroSecondsPerInstance(releaseTime, iterations, instanceCount);
+		presentationsNode.append(presentationNode);
+		
+		TT_Printf("PresentationBenchmark::run: '%s': spawn %.2f us, release %.2f us per instance\n",
+		          it->c_str(), toMicroSecondsPerInstance(spawnTime,   iterations, instanceCount),
+		          toMicroSecondsPerInstance(releaseTime, iterations, instanceCount));
+	}
+	
+	const s32 presentationCount = std::max(static_cast<s32>(presentationsNode.size()), s32(1));
+	const double spawnUs   = toMicroSecondsPerInstance(totalSpawnTime,   iterations, instanceCount) / presentationCount;
+	const double releaseUs = toMicroSecondsPerInstance(totalReleaseTime, iterations, instanceCount) / presentationCount;
+	rootNode["spawnUs"  ] = spawnUs;
+	rootNode["releaseUs"] = releaseUs;
+	
+	TT_Printf("PresentationBenchmark::run: %u presentations, spawn %.2f us, release %.2f us per instance.\n",
+	          presentationsNode.size(), spawnUs, releaseUs);
+	
+	return Benchmark::writeReport("PresentationBenchmark", rootNode, outputPath);
+}
+
+// Namespace end
+}
+}
@@ -31,6 +31,7 @@ public:
 	m_ref(0),
 	m_object(p_object),
 	m_requiredTags(p_requiredTags),
+	m_usedTags(p_object->getTags().getAllUsedTags()),
 	m_textures(p_textures)
 	{
 	}
@@ -43,6 +44,10 @@ public:
 	inline const std::string& getFilename() const { return m_filename; }
 	inline const Tags& getRequiredTags() const { return m_requiredTags; }
 	
+	/*! \brief Returns all tags used by the object, so they don't need to be collected from every clone. */
+	inline const Tags& getUsedTags() const { return m_usedTags; }
+	inline void updateUsedTags() { m_usedTags = m_object->getTags().getAllUsedTags(); }
+	
 private:
 	CacheEntry(const CacheEntry& p_rhs);                  // Not implemented.
 	const CacheEntry& operator=(const CacheEntry& p_rhs); // Not implemented
@@ -51,6 +56,7 @@ private:
 	u32                                m_ref;
 	PresentationObjectPtr              m_object;
 	Tags                               m_requiredTags;
+	Tags                               m_usedTags;
 	engine::renderer::TextureContainer m_textures;
 };
 
@@ -122,7 +128,7 @@ PresentationObjectPtr PresentationCache::get(const std::string& p_filename,
 	
 	if(p_requiredTags.empty() == false)
 	{
-		PresentationMgr::checkRequiredTags(p_requiredTags, object->getTags().getAllUsedTags(), p_filename);
+		PresentationMgr::checkRequiredTags(p_requiredTags, entry->getUsedTags(), p_filename);
 	}
 	
 #if !defined(TT_BUILD_FINAL) && defined(TT_PRESENTATION_CACHE_TIMER_ON)
@@ -220,6 +226,7 @@ s32 PresentationCache::reload(const PresentationMgrPtr& p_mgr)
 		{
 			TT_WARNING("Missing presentation file '%s'\n", filename.c_str());
 		}
+		entry->updateUsedTags();
 	}
 	
 #if !defined(TT_BUILD_FINAL)
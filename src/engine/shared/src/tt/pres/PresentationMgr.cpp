@@ -43,7 +43,7 @@ Cues PresentationMgr::stringsToCues( const str::Strings& p_strings )
 }
 
 
-void PresentationMgr::checkRequiredTags( const Tags &p_requiredTags, Tags p_objectTags, 
+void PresentationMgr::checkRequiredTags( const Tags &p_requiredTags, const Tags& p_objectTags, 
                                          const std::string& p_file )
 {
 	if(p_requiredTags != p_objectTags)
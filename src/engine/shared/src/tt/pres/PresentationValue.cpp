@@ -205,32 +205,39 @@ void  PresentationValue::setCustomValue(const std::string& p_customValue)
 
 
 void PresentationValue::updateValue(const PresentationObject* p_presObj)
+{
+	m_value = getUpdatedValue(p_presObj);
+	m_valid = true;
+}
+
+
+real PresentationValue::getUpdatedValue(const PresentationObject* p_presObj) const
 {
 	switch (m_valueType)
 	{
 	case ValueType_Real:
-		m_valid = true;
-		break;
+		return m_value;
+		
 	case ValueType_Range:
-		m_value = m_valueRange.getRandom(tt::math::Random::getEffects());
-		m_valid = true;
-		break;
+		return m_valueRange.getRandom(tt::math::Random::getEffects());
+		
 	case ValueType_CustomString:
 		{
-			m_valid = true;
-			
 			// No values available. Use whatever's currently in m_value
-			if (p_presObj == 0) break;
+			if (p_presObj == 0) return m_value;
 			
-			if (p_presObj->getCustomValue(m_customValue, &m_value) == false)
+			real value = m_value;
+			if (p_presObj->getCustomValue(m_customValue, &value) == false)
 			{
 				TT_PANIC("Custom Presentation Value '%s' not specified. Using %f", 
 				         m_customValue.c_str(), realToFloat(m_value));
 			}
+			return value;
 		}
-		break;
 	
-	default: TT_PANIC("Invalid Value Type for Presentation Value");
+	default:
+		TT_PANIC("Invalid Value Type for Presentation Value");
+		return m_value;
 	}
 }
 
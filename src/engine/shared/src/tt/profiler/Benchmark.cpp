@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <limits>
+
+#include <tt/fs/File.h>
+#include <tt/fs/fs.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+#include <tt/profiler/Benchmark.h>
+#include <tt/system/Time.h>
+
+
+namespace tt {
+namespace profiler {
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+Benchmark::Stats::Stats()
+:
+total(0),
+min(std::numeric_limits<u64>::max()),
+max(0),
+count(0)
+{
+}
+
+
+void Benchmark::Stats::add(u64 p_time)
+{
+	min    = std::min(min, p_time);
+	max    = std::max(max, p_time);
+	total += p_time;
+	++count;
+}
+
+
+Json::Value Benchmark::Stats::toJson() const
+{
+	Json::Value node(Json::objectValue);
+	node["avgMs"] = getAverageMs();
+	node["minMs"] = (count > 0) ? toMilliSeconds(min) : 0.0;
+	node["maxMs"] = toMilliSeconds(max);
+	return node;
+}
+
+
+std::string Benchmark::getFolder(const args::CmdLine& p_cmdLine, const std::string& p_option,
+                                 const std::string& p_default)
+{
+	std::string folder(p_cmdLine.getString(p_option));
+	if (folder.empty())
+	{
+		return p_default;
+	}
+	
+	if (*folder.rbegin() != '/')
+	{
+		folder += '/';
+	}
+	return folder;
+}
+
+
+s32 Benchmark::getCount(const args::CmdLine& p_cmdLine, const std::string& p_option, s32 p_default)
+{
+	return p_cmdLine.exists(p_option) ? std::max(p_cmdLine.getInteger(p_option), 1) : p_default;
+}
+
+
+std::string Benchmark::getOutputPath(const args::CmdLine& p_cmdLine, const std::string& p_default)
+{
+	return p_cmdLine.exists("benchmark_output") ? p_cmdLine.getString("benchmark_output") : p_default;
+}
+
+
+u64 Benchmark::getMicroSeconds()
+{
+	return system::Time::getInstance()->getMicroSeconds();
+}
+
+
+bool Benchmark::writeReport(const char* p_name, const Json::Value& p_report, const std::string& p_path)
+{
+	TT_Printf("%s: Writing '%s'\n", p_name, p_path.c_str());
+	
+	fs::FilePtr file(fs::open(p_path, fs::OpenMode_Write));
+	if (file == 0)
+	{
+		TT_PANIC("%s: Could not open benchmark output file '%s'.", p_name, p_path.c_str());
+		return false;
+	}
+	
+	const std::string jsonText = Json::StyledWriter().write(p_report);
+	const fs::size_type bytesToWrite = static_cast<fs::size_type>(jsonText.length());
+	return file->write(jsonText.c_str(), bytesToWrite) == bytesToWrite;
+}
+
+// Namespace end
+}
+}
@@ -83,9 +83,21 @@ void PerformanceProfiler::outputProfileInfo()
 		}
 		*/
 		
+		// make sure the filename isn't too long
+		const ProfileCallSite& callSite((*measure).first);
+		std::string file(callSite.fileName);
+		if (file.length() > 50)
+		{
+			file = "..." + file.substr(file.length()-50);
+		}
+		
+		std::string key(callSite.message);
+		key += " " + file;
+		key += "(" + tt::str::toStr(callSite.line) + ")";
+		
 		TT_PROFILER_PRINTF("%8d\t%8d\t%8llu\t%8llu\t%8d\t%8d\t%8llu\t%8llu\t%s\n", 
 			totalFrames, totalCalls, elapsedFrameAvg, elapsedFramePeak, 
-			callsFrameAvg, callsFramePeak, elapsedCallAvg, elapsedCallPeak, (*measure).first.c_str());
+			callsFrameAvg, callsFramePeak, elapsedCallAvg, elapsedCallPeak, key.c_str());
 	}
 	TT_PROFILER_PRINTF("\n");
 }
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <tt/fs/File.h>
+#include <tt/platform/tt_error.h>
+#include <tt/profiler/TraceRecorder.h>
+#include <tt/system/Time.h>
+
+
+namespace tt {
+namespace profiler {
+
+#if TT_USE_TRACE_RECORDER != 0
+
+namespace
+{
+
+struct TraceEvent
+{
+	u64         timestamp; // microseconds
+	const char* name;
+	bool        begin;
+};
+
+
+struct ThreadBuffer
+{
+	explicit ThreadBuffer(s32 p_id)
+	:
+	writeCount(0),
+	id(p_id),
+	name(),
+	inUse(true)
+	{ }
+
+	TraceEvent       events[TraceRecorder::Constants_EventsPerThread];
+	std::atomic<u32> writeCount; // Total number of events written; only the owning thread writes it.
+	s32              id;
+	std::string      name;       // Guarded by g_registryMutex
+	bool             inUse;      // Guarded by g_registryMutex
+};
+
+
+std::mutex                 g_registryMutex;
+std::vector<ThreadBuffer*> g_threadBuffers;
+std::set<std::string>      g_internedNames; // set nodes don't move, so their c_str() stays valid
+
+
+// Returns the buffer of a thread to the registry when the thread exits, so the events can
+// still be dumped and a later thread (e.g. the next load thread) can reuse the buffer.
+struct ThreadBufferOwner
+{
+	inline ThreadBufferOwner() : buffer(0), acquired(false) { }
+	inline ~ThreadBufferOwner()
+	{
+		if (buffer != 0)
+		{
+			std::lock_guard<std::mutex> lock(g_registryMutex);
+			buffer->inUse = false;
+		}
+	}
+
+	ThreadBuffer* buffer;
+	bool          acquired; // Also set when no buffer was available, so we don't try again every event.
+};
+
+thread_local ThreadBufferOwner ts_bufferOwner;
+
+
+ThreadBuffer* acquireBuffer(const char* p_name)
+{
+	const std::string name(p_name != 0 ? p_name : "");
+	std::lock_guard<std::mutex> lock(g_registryMutex);
+
+	// Prefer the buffer of a finished thread with the same name, so its events stay together
+	ThreadBuffer* reuse = 0;
+	for (auto& buffer : g_threadBuffers)
+	{
+		if (buffer->inUse == false)
+		{
+			if (name.empty() == false && buffer->name == name)
+			{
+				buffer->inUse = true;
+				return buffer;
+			}
+			if (reuse == 0)
+			{
+				reuse = buffer;
+			}
+		}
+	}
+
+	if (g_threadBuffers.size() < TraceRecorder::Constants_MaxThreads)
+	{
+		g_threadBuffers.push_back(new ThreadBuffer(static_cast<s32>(g_threadBuffers.size()) + 1));
+		g_threadBuffers.back()->name = name;
+		return g_threadBuffers.back();
+	}
+
+	if (reuse != 0)
+	{
+		reuse->writeCount = 0;
+		reuse->name       = name;
+		reuse->inUse      = true;
+	}
+	return reuse;
+}
+
+
+void appendEscaped(std::string& p_output, const char* p_text)
+{
+	for (const char* c = p_text; *c != 0; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			p_output += '\\';
+			p_output += *c;
+		}
+		else if (static_cast<unsigned char>(*c) < 0x20)
+		{
+			p_output += ' ';
+		}
+		else
+		{
+			p_output += *c;
+		}
+	}
+}
+
+
+bool flush(const tt::fs::FilePtr& p_file, std::string& p_output)
+{
+	const tt::fs::size_type length = static_cast<tt::fs::size_type>(p_output.length());
+	const bool success = p_file->write(p_output.c_str(), length) == length;
+	p_output.clear();
+	return success;
+}
+
+// Anonymous namespace end
+}
+
+
+std::atomic<bool> TraceRecorder::ms_enabled(true);
+
+#endif // TT_USE_TRACE_RECORDER != 0
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+const char* TraceRecorder::intern(const std::string& p_name)
+{
+#if TT_USE_TRACE_RECORDER != 0
+	std::lock_guard<std::mutex> lock(g_registryMutex);
+	return g_internedNames.insert(p_name).first->c_str();
+#else
+	(void)p_name;
+	return "";
+#endif
+}
+
+
+void TraceRecorder::setThreadName(const char* p_name)
+{
+#if TT_USE_TRACE_RECORDER != 0
+	TT_NULL_ASSERT(p_name);
+	if (ts_bufferOwner.acquired == false)
+	{
+		ts_bufferOwner.buffer   = acquireBuffer(p_name);
+		ts_bufferOwner.acquired = true;
+	}
+	else if (ts_bufferOwner.buffer != 0)
+	{
+		std::lock_guard<std::mutex> lock(g_registryMutex);
+		ts_bufferOwner.buffer->name = p_name;
+	}
+#else
+	(void)p_name;
+#endif
+}
+
+
+bool TraceRecorder::dumpChromeTrace(const tt::fs::FilePtr& p_file)
+{
+#if TT_USE_TRACE_RECORDER != 0
+	if (p_file == 0)
+	{
+		return false;
+	}
+
+	struct ThreadEvents
+	{
+		s32                     id;
+		std::string             name;
+		std::vector<TraceEvent> events;
+	};
+	std::vector<ThreadEvents> threads;
+
+	// Copy the events first and format them after releasing the lock
+	{
+		std::lock_guard<std::mutex> lock(g_registryMutex);
+		threads.resize(g_threadBuffers.size());
+		for (size_t i = 0; i < g_threadBuffers.size(); ++i)
+		{
+			const ThreadBuffer& buffer(*g_threadBuffers[i]);
+			ThreadEvents&       thread(threads[i]);
+			thread.id   = buffer.id;
+			thread.name = buffer.name;
+
+			const u32 end   = buffer.writeCount.load(std::memory_order_acquire);
+			const u32 count = std::min(end, static_cast<u32>(Constants_EventsPerThread));
+			thread.events.reserve(count);
+			for (u32 index = end - count; index != end; ++index)
+			{
+				thread.events.push_back(buffer.events[index % Constants_EventsPerThread]);
+			}
+
+			// The thread kept recording while we copied; drop the oldest events it may have overwritten.
+			const u32 overwritten = std::min(buffer.writeCount.load(std::memory_order_acquire) - end, count);
+			thread.events.erase(thread.events.begin(), thread.events.begin() + overwritten);
+		}
+	}
+
+	std::string output("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first   = true;
+	bool success = true;
+	char line[128];
+
+	for (auto& thread : threads)
+	{
+		// Thread name metadata
+		sprintf(line, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%d,", first ? "" : ",\n", thread.id);
+		output += line;
+		output += "\"name\":\"thread_name\",\"args\":{\"name\":\"";
+		if (thread.name.empty())
+		{
+			sprintf(line, "Thread %d", thread.id);
+			output += line;
+		}
+		else
+		{
+			appendEscaped(output, thread.name.c_str());
+		}
+		output += "\"}}";
+		first = false;
+
+		s32 depth = 0;
+		for (auto& event : thread.events)
+		{
+			if (event.begin)
+			{
+				++depth;
+			}
+			else if (depth > 0)
+			{
+				--depth;
+			}
+			else
+			{
+				continue; // Its begin event was already overwritten.
+			}
+
+			sprintf(line, ",\n{\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%llu,\"name\":\"",
+			        event.begin ? 'B' : 'E', thread.id, static_cast<unsigned long long>(event.timestamp));
+			output += line;
+			appendEscaped(output, event.name);
+			output += "\"}";
+
+			if (output.length() >= 64 * 1024)
+			{
+				success = flush(p_file, output) && success;
+			}
+		}
+	}
+
+	output += "\n]}\n";
+	return flush(p_file, output) && success;
+#else
+	(void)p_file;
+	return false;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+#if TT_USE_TRACE_RECORDER != 0
+
+void TraceRecorder::record(const char* p_name, bool p_begin)
+{
+	if (ts_bufferOwner.acquired == false)
+	{
+		ts_bufferOwner.buffer   = acquireBuffer(0);
+		ts_bufferOwner.acquired = true;
+	}
+	ThreadBuffer* buffer = ts_bufferOwner.buffer;
+	if (buffer == 0)
+	{
+		return; // All buffers are in use.
+	}
+
+	const u32   index = buffer->writeCount.load(std::memory_order_relaxed);
+	TraceEvent& event(buffer->events[index % Constants_EventsPerThread]);
+	event.timestamp = tt::system::Time::getInstance()->getMicroSeconds();
+	event.name      = p_name;
+	event.begin     = p_begin;
+	buffer->writeCount.store(index + 1, std::memory_order_release);
+}
+
+#endif // TT_USE_TRACE_RECORDER != 0
+
+
+// Namespace end
+}
+}
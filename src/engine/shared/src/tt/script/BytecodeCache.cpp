@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <tt/compression/lz4/xxhash.h>
+#include <tt/fs/utils/utils.h>
+#include <tt/fs/Dir.h>
+#include <tt/fs/DirEntry.h>
+#include <tt/fs/File.h>
+#include <tt/fs/fs.h>
+#include <tt/platform/tt_error.h>
+#include <tt/script/BytecodeCache.h>
+
+
+namespace tt {
+namespace script {
+
+// Bump when the layout of an entry changes
+static const u32 g_entrySignature = 0x63627474; // 'ttbc'
+static const u32 g_entryVersion   = 1;
+
+static const char* const g_entryExtension = ".bnut";
+
+// Limits of the cache (the game has a few hundred scripts); older entries are removed at creation
+static const s32           g_maxEntryCount = 1024;
+static const fs::size_type g_maxTotalSize  = 32 * 1024 * 1024;
+
+
+struct EntryHeader
+{
+	u32 signature;
+	u32 version;
+	u64 key;
+	u32 size;     // of the serialized closure that follows the header
+	u32 checksum; // XXH32 of the serialized closure
+};
+
+
+struct CacheEntry
+{
+	std::string   name;
+	fs::size_type size;
+	fs::time_type writeTime;
+};
+
+
+static bool isNewerEntry(const CacheEntry& p_a, const CacheEntry& p_b)
+{
+	return p_a.writeTime > p_b.writeTime;
+}
+
+
+struct ClosureReader
+{
+	const u8*     data;
+	fs::size_type remaining;
+};
+
+
+static SQInteger readClosureData(SQUserPointer p_reader, SQUserPointer p_data, SQInteger p_size)
+{
+	ClosureReader* reader = static_cast<ClosureReader*>(p_reader);
+	if (p_size < 0 || static_cast<fs::size_type>(p_size) > reader->remaining)
+	{
+		return 0;
+	}
+	std::memcpy(p_data, reader->data, static_cast<size_t>(p_size));
+	reader->data      += p_size;
+	reader->remaining -= static_cast<fs::size_type>(p_size);
+	return p_size;
+}
+
+
+static SQInteger writeClosureData(SQUserPointer p_buffer, SQUserPointer p_data, SQInteger p_size)
+{
+	std::vector<u8>* buffer = static_cast<std::vector<u8>*>(p_buffer);
+	const u8*        data   = static_cast<const u8*>(p_data);
+	buffer->insert(buffer->end(), data, data + p_size);
+	return p_size;
+}
+
+
+static u64 getVersionSeed()
+{
+	// Compiled closures are only valid for the same Squirrel version and type sizes
+	const u32 version[] =
+	{
+		g_entryVersion,
+		SQUIRREL_VERSION_NUMBER,
+		static_cast<u32>(sizeof(SQInteger)),
+		static_cast<u32>(sizeof(SQFloat)),
+		static_cast<u32>(sizeof(SQChar)),
+		static_cast<u32>(sizeof(void*))
+	};
+	return XXH64(version, sizeof(version), 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+BytecodeCachePtr BytecodeCache::create(const std::string& p_directory, fs::identifier p_fsID)
+{
+	TT_ASSERTMSG(p_directory.empty() == false, "BytecodeCache needs a directory.");
+	if (fs::supportsSaving(p_fsID) == false || fs::supportsDirectories(p_fsID) == false)
+	{
+		// E.g. a read-only memory file system with packed data; nothing to cache
+		return BytecodeCachePtr();
+	}
+	
+	if (fs::dirExists(p_directory, p_fsID) == false &&
+	    fs::utils::createDirRecursive(p_directory, p_fsID) == false)
+	{
+		TT_WARN("Creating script bytecode cache directory '%s' failed; not caching scripts.",
+		        p_directory.c_str());
+		return BytecodeCachePtr();
+	}
+	
+	BytecodeCachePtr cache(new BytecodeCache(p_directory, p_fsID));
+	const s32 removed = cache->removeOldestEntries();
+	if (removed > 0)
+	{
+		TT_Printf("BytecodeCache::create: removed %d old entries from '%s'.\n", removed, p_directory.c_str());
+	}
+	return cache;
+}
+
+
+u64 BytecodeCache::getKey(const std::string& p_name, const void* p_source, fs::size_type p_sourceSize)
+{
+	// The name is part of the key as it is stored in the closure (for error reporting)
+	static const u64 versionSeed = getVersionSeed();
+	const u64 nameHash = XXH64(p_name.c_str(), p_name.length(), versionSeed);
+	return XXH64(p_source, static_cast<size_t>(p_sourceSize), nameHash);
+}
+
+
+bool BytecodeCache::load(HSQUIRRELVM p_vm, u64 p_key)
+{
+	const std::string path(getEntryPath(p_key));
+	if (fs::fileExists(path, m_fsID) == false)
+	{
+		++m_missCount;
+		return false;
+	}
+	
+	const code::BufferPtr content(fs::getFileContent(path, m_fsID));
+	bool valid = content != 0 && content->getSize() >= static_cast<code::Buffer::size_type>(sizeof(EntryHeader));
+	
+	EntryHeader header;
+	const u8* closure = 0;
+	if (valid)
+	{
+		std::memcpy(&header, content->getData(), sizeof(header));
+		closure = static_cast<const u8*>(content->getData()) + sizeof(header);
+		
+		valid = header.signature == g_entrySignature &&
+		        header.version   == g_entryVersion   &&
+		        header.key       == p_key            &&
+		        static_cast<code::Buffer::size_type>(header.size + sizeof(header)) == content->getSize() &&
+		        XXH32(closure, header.size, 0) == header.checksum;
+	}
+	
+	if (valid)
+	{
+		ClosureReader reader = { closure, static_cast<fs::size_type>(header.size) };
+		valid = SQ_SUCCEEDED(sq_readclosure(p_vm, readClosureData, &reader));
+	}
+	
+	if (valid == false)
+	{
+		TT_WARN("Script bytecode cache entry '%s' is invalid; compiling the script instead.", path.c_str());
+		if (m_writable)
+		{
+			fs::destroyFile(path, m_fsID);
+		}
+		++m_missCount;
+		return false;
+	}
+	
+	++m_hitCount;
+	return true;
+}
+
+
+bool BytecodeCache::store(HSQUIRRELVM p_vm, u64 p_key)
+{
+	if (m_writable == false)
+	{
+		return false;
+	}
+	
+	std::vector<u8> closure;
+	closure.reserve(4096);
+	if (SQ_FAILED(sq_writeclosure(p_vm, writeClosureData, &closure)) || closure.empty())
+	{
+		TT_PANIC("Serializing compiled script for the bytecode cache failed.");
+		return false;
+	}
+	
+	EntryHeader header;
+	header.signature = g_entrySignature;
+	header.version   = g_entryVersion;
+	header.key       = p_key;
+	header.size      = static_cast<u32>(closure.size());
+	header.checksum  = XXH32(&closure[0], closure.size(), 0);
+	
+	const std::string path(getEntryPath(p_key));
+	fs::FilePtr file(fs::open(path, fs::OpenMode_Write, m_fsID));
+	if (file == 0)
+	{
+		TT_WARN("Cannot write to script bytecode cache '%s'; no longer storing compiled scripts.",
+		        m_directory.c_str());
+		m_writable = false;
+		return false;
+	}
+	
+	const fs::size_type closureSize = static_cast<fs::size_type>(closure.size());
+	const bool saveOk = file->write(&header, sizeof(header)) == static_cast<fs::size_type>(sizeof(header)) &&
+	                    file->write(&closure[0], closureSize) == closureSize;
+	if (saveOk == false)
+	{
+		// A partial entry would fail validation anyway, but don't leave it around
+		file.reset();
+		fs::destroyFile(path, m_fsID);
+	}
+	return saveOk;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+BytecodeCache::BytecodeCache(const std::string& p_directory, fs::identifier p_fsID)
+:
+m_directory(p_directory),
+m_fsID(p_fsID),
+m_writable(true),
+m_hitCount(0),
+m_missCount(0)
+{
+}
+
+
+std::string BytecodeCache::getEntryPath(u64 p_key) const
+{
+	static const char hexDigits[] = "0123456789abcdef";
+	char name[17] = { 0 };
+	for (s32 i = 15; i >= 0; --i)
+	{
+		name[i] = hexDigits[p_key & 0xF];
+		p_key >>= 4;
+	}
+	return m_directory + name + g_entryExtension;
+}
+
+
+s32 BytecodeCache::removeOldestEntries()
+{
+	fs::DirPtr dir(fs::openDir(m_directory, std::string("*") + g_entryExtension, m_fsID));
+	if (dir == 0)
+	{
+		return 0;
+	}
+	
+	std::vector<CacheEntry> entries;
+	fs::size_type totalSize = 0;
+	fs::DirEntry entry;
+	while (dir->read(entry))
+	{
+		if (entry.isDirectory() == false)
+		{
+			const CacheEntry cacheEntry = { entry.getName(), entry.getSize(), entry.getWriteTime() };
+			entries.push_back(cacheEntry);
+			totalSize += cacheEntry.size;
+		}
+	}
+	dir.reset();
+	
+	if (static_cast<s32>(entries.size()) <= g_maxEntryCount && totalSize <= g_maxTotalSize)
+	{
+		return 0;
+	}
+	
+	// An edited script gets a new entry, so the oldest entries are the ones that are no longer used
+	std::sort(entries.begin(), entries.end(), isNewerEntry);
+	
+	s32 removed = 0;
+	while (static_cast<s32>(entries.size()) > g_maxEntryCount || totalSize > g_maxTotalSize)
+	{
+		const CacheEntry& oldest(entries.back());
+		if (fs::destroyFile(m_directory + oldest.name, m_fsID))
+		{
+			++removed;
+		}
+		totalSize -= oldest.size;
+		entries.pop_back();
+	}
+	return removed;
+}
+
+// Namespace end
+}
+}
@@ -10,6 +10,7 @@
 #include <squirrel/sqstdstring.h>
 
 #include <tt/code/AutoGrowBuffer.h>
+#include <tt/code/Buffer.h>
 #include <tt/code/bufferutils.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/str/common.h>
@@ -19,6 +20,7 @@
 #include <tt/fs/fs.h>
 #include <tt/fs/File.h>
 
+#include <tt/script/BytecodeCache.h>
 #include <tt/script/VirtualMachine.h>
 #include <tt/script/ScriptEngine.h>
 #include <tt/script/ScriptObject.h>
@@ -263,6 +265,11 @@ bool VirtualMachine::loadOrCompileScript(const std::string& p_filename, bool p_u
 		return loadClosure(binFilename);
 	}
 	
+	if (m_bytecodeCache != 0 && m_compileMode != VMCompileMode_NutToBnut)
+	{
+		return loadCachedOrCompileScript(nutFilename, binFilename);
+	}
+	
 	// Try to load the nut.
 	if (compile_file(m_vm, nutFilename, binFilename) == false)
 	{
@@ -287,6 +294,33 @@ bool VirtualMachine::loadOrCompileScript(const std::string& p_filename, bool p_u
 }
 
 
+bool VirtualMachine::loadCachedOrCompileScript(const std::string& p_nutFilename, const std::string& p_name)
+{
+	const code::BufferPtr source(tt::fs::getFileContent(p_nutFilename));
+	if (source == 0)
+	{
+		TT_PANIC("Loading script '%s' failed.", p_nutFilename.c_str());
+		return false;
+	}
+	
+	const u64 key = BytecodeCache::getKey(p_name, source->getData(), source->getSize());
+	if (m_bytecodeCache->load(m_vm, key))
+	{
+		return true;
+	}
+	
+	if (SQ_FAILED(sq_compilebuffer(m_vm, static_cast<const SQChar*>(source->getData()),
+	                               static_cast<SQInteger>(source->getSize()), p_name.c_str(),
+	                               TT_SCRIPT_RAISE_ERROR)))
+	{
+		return false;
+	}
+	
+	m_bytecodeCache->store(m_vm, key);
+	return true;
+}
+
+
 bool VirtualMachine::runScriptBuf(const std::string& p_bufferedScript)
 {
 	tt::script::SqTopRestorerHelper helper(m_vm);
@@ -759,7 +793,8 @@ m_vm(0),
 m_rootPath(p_rootPath),
 m_cachedIncludes(),
 m_compileMode(p_mode),
-m_disableCaching(false)
+m_disableCaching(false),
+m_bytecodeCache()
 #if defined(TT_PLATFORM_WIN)
 ,m_rdbg(0)
 #endif
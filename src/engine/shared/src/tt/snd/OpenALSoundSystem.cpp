@@ -14,6 +14,7 @@
 #include <tt/mem/util.h>
 #include <tt/platform/tt_error.h>
 #include <tt/platform/tt_printf.h>
+#include <tt/profiler/TraceRecorder.h>
 #include <tt/snd/Buffer.h>
 #include <tt/snd/OpenALSoundSystem.h>
 #include <tt/snd/snd.h>
@@ -746,7 +747,11 @@ public:
 	m_playing(false),
 	m_paused(false),
 	m_playbackDone(false),
-	m_bufferLengthInMs(static_cast<u32>((p_streamSource->getBufferSize() * 1000) / p_streamSource->getFramerate()))
+	m_bufferLengthInMs(static_cast<u32>((p_streamSource->getBufferSize() * 1000) / p_streamSource->getFramerate())),
+	m_framerate(p_streamSource->getFramerate()),
+	m_filledCount(0),
+	m_underrunCount(0),
+	m_decodeEntry(0)
 	{
 		TT_ASSERT(m_buffer == 0);
 		m_buffer = ::operator new(m_bufferSize);
@@ -1053,6 +1058,21 @@ public:
 				alSourceQueueBuffers(m_source, 1, &alBuffer);
 				
 				if(checkALError()) return false;
+				++m_filledCount;
+			}
+		}
+		
+		if (m_playbackDone == false && m_paused == false)
+		{
+			// If OpenAL played all queued buffers before they were refilled, the source has stopped.
+			// Restart it now that it has buffers again.
+			ALenum state;
+			alGetSourcei(m_source, AL_SOURCE_STATE, &state);
+			if (checkALError() == false &&
+			    state == AL_STOPPED)
+			{
+				++m_underrunCount;
+				playOpenALSource(m_source);
 			}
 		}
 		
@@ -1100,12 +1120,52 @@ public:
 	}
 	
 	
+	/*! \brief Time until OpenAL is done with the buffer it's playing (so it can be refilled)
+	           and until it runs out of queued buffers. */
+	void getRefillTimes(u32* p_refillInMs_OUT, u32* p_underrunInMs_OUT) const
+	{
+		TT_NULL_ASSERT(p_refillInMs_OUT);
+		TT_NULL_ASSERT(p_underrunInMs_OUT);
+		
+		const u32 bufferInMs = std::max(m_bufferLengthInMs / BufferCount, u32(1));
+		*p_refillInMs_OUT   = bufferInMs;
+		*p_underrunInMs_OUT = 0xFFFFFFFF;
+		if (m_playing == false || m_paused || m_playbackDone)
+		{
+			// Nothing to refill; check again after a buffer's worth of time.
+			return;
+		}
+		
+		ALint queued = 0;
+		ALint offset = 0;
+		alGetSourcei(m_source, AL_BUFFERS_QUEUED, &queued);
+		alGetSourcei(m_source, AL_SAMPLE_OFFSET,  &offset); // In frames, from the start of the queue
+		if (checkALError() || queued <= 0 || m_frames <= 0)
+		{
+			*p_refillInMs_OUT   = 1;
+			*p_underrunInMs_OUT = 0;
+			return;
+		}
+		
+		const size_type framesLeft = m_frames - (offset % m_frames);
+		const u32 refillInMs = static_cast<u32>((framesLeft * 1000) / m_framerate);
+		
+		// Wake up just after the buffer is done, so it can be refilled right away.
+		*p_refillInMs_OUT   = refillInMs + 1;
+		*p_underrunInMs_OUT = refillInMs + (queued - 1) * bufferInMs;
+	}
+	
 	inline bool   isPlaying()           const { return m_playing;          }
 	inline bool   isPaused()            const { return m_paused;           }
 	inline real   getVolumeRatio()      const { return m_volumeRatio;      }
 	inline real   getVolumeDB()         const { return m_volumedB;         }
 	inline ALuint getALSource()         const { return m_source;           }
 	inline u32    getBufferLengthInMs() const { return m_bufferLengthInMs; }
+	inline u32    getFilledCount()      const { return m_filledCount;      }
+	inline u32    getUnderrunCount()    const { return m_underrunCount;    }
+	
+	inline DecodeEntry* getDecodeEntry() const              { return m_decodeEntry;  }
+	inline void         setDecodeEntry(DecodeEntry* p_entry) { m_decodeEntry = p_entry; }
 	
 private:
 	typedef std::vector<ALuint> Buffers;
@@ -1185,7 +1245,73 @@ private:
 	bool m_paused;
 	bool m_playbackDone;
 	
-	u32 m_bufferLengthInMs;  // used by the stream decoding thread to estimate whether it can idle
+	u32       m_bufferLengthInMs;  // used by the stream decoding thread to estimate whether it can idle
+	size_type m_framerate;
+	u32       m_filledCount;       //!< Number of buffers refilled by update()
+	u32       m_underrunCount;     //!< Number of times OpenAL ran out of buffers during playback
+	
+	DecodeEntry* m_decodeEntry;    //!< Owned by the decode thread; only set if streams are updated in a thread
+};
+
+
+/*! \brief The decode thread's bookkeeping of an open stream. */
+struct OpenALSoundSystem::DecodeEntry
+{
+	inline DecodeEntry(Stream* p_stream, u32 p_id)
+	:
+	stream(p_stream),
+	mutex(),
+	closed(false),
+	refillRequested(true),
+	refillTime(0),
+	underrunTime(0),
+	stats()
+	{
+		stats.id = p_id;
+	}
+	
+	Stream*           stream;
+	thread::Mutex     mutex;           // Held by the decode thread while it updates the stream
+	bool              closed;          // Set (under mutex) by closeStream; stream must not be touched anymore
+	std::atomic<bool> refillRequested; // Set by the game thread to have the stream updated right away
+	u64               refillTime;      // When the next buffer can be refilled (decode thread only)
+	u64               underrunTime;    // When OpenAL runs out of queued buffers (decode thread only)
+	StreamStats       stats;           // Decode thread only
+	
+private:
+	DecodeEntry(const DecodeEntry&);                  // Disable copy
+	const DecodeEntry& operator=(const DecodeEntry&); // Disable assigment.
+};
+
+
+struct OpenALSoundSystem::DecodeCommand
+{
+	enum Type
+	{
+		Type_Add,
+		Type_Remove
+	};
+	
+	inline DecodeCommand(Type p_type, DecodeEntry* p_entry)
+	:
+	type(p_type),
+	entry(p_entry),
+	next(0)
+	{ }
+	
+	Type           type;
+	DecodeEntry*   entry;
+	DecodeCommand* next;
+};
+
+
+struct DecodeEntryUnderrunLess
+{
+	template<typename T>
+	inline bool operator()(const T* p_lhs, const T* p_rhs) const
+	{
+		return p_lhs->underrunTime < p_rhs->underrunTime;
+	}
 };
 
 
@@ -1217,14 +1343,20 @@ OpenALSoundSystem::~OpenALSoundSystem()
 		if (m_decodeThread != 0)
 		{
 			// Tell decode thread to exit and wait for the thread to die
-			{
-				thread::CriticalSection criticalSection(&m_decodeMutex);
-				m_decodeThreadShouldExit = true;
-			}
+			m_decodeThreadShouldExit = true;
+			m_decodeSemaphore.signal();
 			thread::wait(m_decodeThread); // join
 			m_decodeThread.reset();
 		}
 		
+		// Clean up the commands the thread didn't get to and the entries of streams that weren't closed
+		processDecodeCommands(0);
+		for (DecodeEntries::iterator it = m_activeStreams.begin(); it != m_activeStreams.end(); ++it)
+		{
+			delete (*it);
+		}
+		m_activeStreams.clear();
+		
 		m_decodeSemaphore.destroy();
 	}
 	
@@ -2060,8 +2192,10 @@ bool OpenALSoundSystem::openStream(const StreamPtr& p_stream)
 	
 	if (m_updateStreamsInThread)
 	{
-		thread::CriticalSection criticalSection(&m_decodeMutex);
-		m_streamsToAdd.push_back(p_stream.get());
+		DecodeEntry* entry = new DecodeEntry(p_stream.get(), m_nextStreamID++);
+		entry->stats.bufferLengthInMs = data->getBufferLengthInMs();
+		data->setDecodeEntry(entry);
+		pushDecodeCommand(new DecodeCommand(DecodeCommand::Type_Add, entry));
 	}
 	
 	return true;
@@ -2077,19 +2211,24 @@ bool OpenALSoundSystem::closeStream(Stream* p_stream)
 		return true;
 	}
 	
-	if (m_updateStreamsInThread)
+	StreamData* data = static_cast<StreamData*>(p_stream->getData());
+	
+	if (m_updateStreamsInThread && data->getDecodeEntry() != 0)
 	{
+		DecodeEntry* entry = data->getDecodeEntry();
+		
+		// Only blocks if the decode thread is updating this stream right now
+		// (so that it doesn't reference a possibly invalid StreamSource afterwards)
 		{
-			thread::CriticalSection criticalSection(&m_decodeMutex);
-			m_streamToRemove = p_stream;
+			thread::CriticalSection criticalSection(&entry->mutex);
+			entry->closed = true;
 		}
+		data->setDecodeEntry(0);
 		
-		// Block until stream is closed (so that we don't try to reference a possibly invalid StreamSource)
-		m_decodeSemaphore.wait();
+		// The decode thread deletes the entry
+		pushDecodeCommand(new DecodeCommand(DecodeCommand::Type_Remove, entry));
 	}
 	
-	StreamData* data = static_cast<StreamData*>(p_stream->getData());
-	
 	const ALuint alSource = data->getALSource();
 	
 	data->free();
@@ -2106,7 +2245,18 @@ bool OpenALSoundSystem::closeStream(Stream* p_stream)
 bool OpenALSoundSystem::playStream(const StreamPtr& p_stream)
 {
 	StreamData* data = getStreamData(p_stream);
-	return (data != 0) ? data->play() : false;
+	if (data == 0 || data->play() == false)
+	{
+		return false;
+	}
+	
+	if (data->getDecodeEntry() != 0)
+	{
+		// Wake up the decode thread; it doesn't keep track of streams that aren't playing
+		data->getDecodeEntry()->refillRequested = true;
+		m_decodeSemaphore.signal();
+	}
+	return true;
 }
 
 
@@ -2127,7 +2277,17 @@ bool OpenALSoundSystem::pauseStream(const StreamPtr& p_stream)
 bool OpenALSoundSystem::resumeStream(const StreamPtr& p_stream)
 {
 	StreamData* data = getStreamData(p_stream);
-	return (data != 0) ? data->resume() : false;
+	if (data == 0 || data->resume() == false)
+	{
+		return false;
+	}
+	
+	if (data->getDecodeEntry() != 0)
+	{
+		data->getDecodeEntry()->refillRequested = true;
+		m_decodeSemaphore.signal();
+	}
+	return true;
 }
 
 
@@ -2479,11 +2639,13 @@ m_effect(AL_EFFECT_NULL),
 m_updateStreamsInThread(p_updateStreamsInThread),
 m_decodeThread(),
 m_decodeThreadShouldExit(false),
-m_streamsToAdd(),
+m_decodeCommands(0),
 m_activeStreams(),
-m_streamToRemove(0),
-m_decodeMutex(),
-m_decodeSemaphore()
+m_nextStreamID(0),
+m_decodeSemaphore(),
+m_streamStatsMutex(),
+m_streamStats(),
+m_closedStreamStats()
 {
 #if !defined(TT_PLATFORM_LNX) && !defined(TT_FORCE_OPENAL_SOFT)
 	TT_ASSERTMSG(checkALError() == false, "Found pre-existing error state!");
@@ -2904,6 +3066,7 @@ OpenALSoundSystem::StreamData* OpenALSoundSystem::getStreamData(const StreamPtr&
 int OpenALSoundSystem::staticDecodeStreamsThread(void* p_soundSystem)
 {
 	TT_NULL_ASSERT(p_soundSystem);
+	profiler::TraceRecorder::setThreadName("Audio Decoder Thread");
 	static_cast<OpenALSoundSystem*>(p_soundSystem)->decodeStreams();
 	return 0;
 }
@@ -2918,100 +3081,227 @@ void OpenALSoundSystem::decodeStreams()
 		return;
 	}
 	
-#if !defined(TT_BUILD_FINAL)
-#define SHOW_STREAM_TIMINGS 0  // set to 1 to enable timing of stream updates
-#else
-#define SHOW_STREAM_TIMINGS 0
-#endif
+	// Longest the thread sleeps, even if no stream needs a refill before that
+	static const u32 maxIdleTimeInMs      = 100;
+	// Retry time for a stream the game thread is closing
+	static const u32 lockedRetryTimeInMs  = 1;
+	static const u64 statsIntervalInMs    = 250;
 	
 	system::Time* tm = system::Time::getInstance();
+	u64 nextStatsTime = 0;
 	
 	for ( ;; )
 	{
-		// Block if audio system was suspended
-		//OSWaitEvent(&m_audioSuspendEvent);  // FIXME: Does OpenAL need something like this too?
+		if (m_decodeThreadShouldExit)
+		{
+			TT_Printf("OpenALSoundSystem::decodeStreams: Someone wants me to leave... bye bye!\n");
+			break;
+		}
 		
-		// Check for new streams
+		// Add and remove streams
+		processDecodeCommands(tm->getMilliSeconds());
+		
+		// Refill the streams that are due
+		profiler::TraceRecorder::begin("Decode streams");
+		for (DecodeEntries::iterator it = m_activeStreams.begin(); it != m_activeStreams.end(); ++it)
 		{
-			thread::CriticalSection criticalSection(&m_decodeMutex);
+			DecodeEntry* entry = (*it);
+			const u64 now = tm->getMilliSeconds();
+			if (entry->refillTime > now && entry->refillRequested.exchange(false) == false)
+			{
+				continue;
+			}
 			
-			if (m_decodeThreadShouldExit)
+			if (entry->mutex.tryLock() == false)
 			{
-				TT_Printf("OpenALSoundSystem::decodeStreams: Someone wants me to leave... bye bye!\n");
-				break;
+				// closeStream is holding the entry; a remove command is on its way
+				entry->refillTime   = now + lockedRetryTimeInMs;
+				entry->underrunTime = entry->refillTime;
+				continue;
 			}
 			
-			if (m_streamsToAdd.empty() == false)
+			if (entry->closed)
 			{
-				m_activeStreams.insert(
-					m_activeStreams.end(), m_streamsToAdd.begin(), m_streamsToAdd.end());
-				m_streamsToAdd.clear();
+				entry->refillTime   = now + maxIdleTimeInMs;
+				entry->underrunTime = 0xFFFFFFFFFFFFFFFFULL;
+				entry->mutex.unlock();
+				continue;
 			}
-		}
-		
-		// Update active streams
-		const u64 updateStart = tm->getMilliSeconds();
-		u32 shortestBufferInMs = 60000;
-		for (StreamList::iterator it = m_activeStreams.begin(); it != m_activeStreams.end(); ++it)
-		{
-			Stream* stream = (*it);
-			TT_NULL_ASSERT(stream);
 			
-			StreamData* data = reinterpret_cast<StreamData*>(stream->getData());
+			StreamData* data = reinterpret_cast<StreamData*>(entry->stream->getData());
 			TT_NULL_ASSERT(data);
 			
 			if (data->isPlaying())
 			{
-				if (data->update(stream->getSource()) == false)
+				const u32 filledCount = data->getFilledCount();
+				const u64 updateStart = tm->getMicroSeconds();
+				if (data->update(entry->stream->getSource()) == false)
 				{
 					// NOTE: update() call will have already panicked with more detailed information
 					//TT_PANIC("stream update failed");
 				}
+				
+				if (data->getFilledCount() != filledCount)
+				{
+					const u64 decodeTime = tm->getMicroSeconds() - updateStart;
+					++entry->stats.decodeCount;
+					entry->stats.decodeTimeInUs   += decodeTime;
+					entry->stats.maxDecodeTimeInUs = std::max(entry->stats.maxDecodeTimeInUs, decodeTime);
+				}
+				entry->stats.underrunCount = data->getUnderrunCount();
 			}
 			
-			if (data->getBufferLengthInMs() > 0 &&
-			    data->getBufferLengthInMs() < shortestBufferInMs)
-			{
-				shortestBufferInMs = data->getBufferLengthInMs();
-			}
+			u32 refillInMs   = 0;
+			u32 underrunInMs = 0;
+			data->getRefillTimes(&refillInMs, &underrunInMs);
+			entry->mutex.unlock();
+			
+			const u64 updateEnd = tm->getMilliSeconds();
+			entry->refillTime   = updateEnd + refillInMs;
+			entry->underrunTime = (underrunInMs == 0xFFFFFFFF) ? 0xFFFFFFFFFFFFFFFFULL : updateEnd + underrunInMs;
+		}
+		profiler::TraceRecorder::end("Decode streams");
+		
+		// Streams closest to running dry go first in the next pass
+		std::sort(m_activeStreams.begin(), m_activeStreams.end(), DecodeEntryUnderrunLess());
+		
+		const u64 now = tm->getMilliSeconds();
+		if (now >= nextStatsTime)
+		{
+			publishStreamStats();
+			nextStatsTime = now + statsIntervalInMs;
 		}
 		
-		const u32 updateMs = static_cast<u32>(tm->getMilliSeconds() - updateStart);
-#if SHOW_STREAM_TIMINGS
-		if (updateMs > 25 && m_activeStreams.empty() == false)
+		// Sleep until the first refill is due or until a command or a play request wakes us up
+		u64 wakeTime = now + maxIdleTimeInMs;
+		for (DecodeEntries::const_iterator it = m_activeStreams.begin(); it != m_activeStreams.end(); ++it)
 		{
-			TT_Printf("OpenALSoundSystem::decodeStreams: Updating %u streams took %u ms.\n",
-			          m_activeStreams.size(), updateMs);
+			wakeTime = std::min(wakeTime, (*it)->refillTime);
 		}
-#endif
+		if (wakeTime > now)
+		{
+			m_decodeSemaphore.timedWait(static_cast<u32>(wakeTime - now));
+		}
+	}
+}
+
+
+void OpenALSoundSystem::pushDecodeCommand(DecodeCommand* p_command)
+{
+	TT_NULL_ASSERT(p_command);
+	
+	DecodeCommand* head = m_decodeCommands.load(std::memory_order_relaxed);
+	do
+	{
+		p_command->next = head;
+	}
+	while (m_decodeCommands.compare_exchange_weak(head, p_command,
+	                                              std::memory_order_release,
+	                                              std::memory_order_relaxed) == false);
+	
+	m_decodeSemaphore.signal();
+}
+
+
+void OpenALSoundSystem::processDecodeCommands(u64 p_now)
+{
+	DecodeCommand* command = m_decodeCommands.exchange(0, std::memory_order_acquire);
+	
+	// The commands are stacked newest first; handle them in the order they were pushed
+	DecodeCommand* ordered = 0;
+	while (command != 0)
+	{
+		DecodeCommand* next = command->next;
+		command->next = ordered;
+		ordered = command;
+		command = next;
+	}
+	
+	while (ordered != 0)
+	{
+		DecodeCommand* next = ordered->next;
+		DecodeEntry*   entry = ordered->entry;
+		TT_NULL_ASSERT(entry);
 		
-		// Check for stream to remove
+		switch (ordered->type)
 		{
-			thread::CriticalSection criticalSection(&m_decodeMutex);
+		case DecodeCommand::Type_Add:
+			entry->refillTime   = p_now;
+			entry->underrunTime = p_now;
+			m_activeStreams.push_back(entry);
+			break;
 			
-			if (m_streamToRemove != 0)
+		case DecodeCommand::Type_Remove:
 			{
-#if defined(TT_BUILD_DEV)
-				// Make sure this stream is found!
-				StreamList::const_iterator it = std::find(m_activeStreams.begin(), m_activeStreams.end(), m_streamToRemove);
+				DecodeEntries::iterator it = std::find(m_activeStreams.begin(), m_activeStreams.end(), entry);
 				TT_ASSERT(it != m_activeStreams.end());
-#endif
-				m_activeStreams.remove(m_streamToRemove);
-				m_streamToRemove = 0;
+				if (it != m_activeStreams.end())
+				{
+					m_activeStreams.erase(it);
+				}
 				
-				m_decodeSemaphore.signal();
+				{
+					thread::CriticalSection criticalSection(&m_streamStatsMutex);
+					m_closedStreamStats.underrunCount  += entry->stats.underrunCount;
+					m_closedStreamStats.decodeCount    += entry->stats.decodeCount;
+					m_closedStreamStats.decodeTimeInUs += entry->stats.decodeTimeInUs;
+					m_closedStreamStats.maxDecodeTimeInUs =
+						std::max(m_closedStreamStats.maxDecodeTimeInUs, entry->stats.maxDecodeTimeInUs);
+				}
+				delete entry;
 			}
+			break;
+			
+		default:
+			TT_PANIC("Unknown decode command type: %d", ordered->type);
+			break;
 		}
 		
-		// If we don't run the risk of missing buffer refills, sleep for a bit to give the CPU a rest
-		static const u32 idleTimeInMs = 20;
-		if ((updateMs + idleTimeInMs) < shortestBufferInMs)
-		{
-			thread::sleep(static_cast<int>(idleTimeInMs));
-		}
+		delete ordered;
+		ordered = next;
+	}
+}
+
+
+void OpenALSoundSystem::publishStreamStats()
+{
+	thread::CriticalSection criticalSection(&m_streamStatsMutex);
+	m_streamStats.clear();
+	for (DecodeEntries::const_iterator it = m_activeStreams.begin(); it != m_activeStreams.end(); ++it)
+	{
+		m_streamStats.push_back((*it)->stats);
 	}
 }
 
+
+#if !defined(TT_BUILD_FINAL)
+std::string OpenALSoundSystem::getDebugStreamInfo() const
+{
+	thread::CriticalSection criticalSection(&m_streamStatsMutex);
+	
+	u32 underrunCount = m_closedStreamStats.underrunCount;
+	for (StreamStatsCollection::const_iterator it = m_streamStats.begin(); it != m_streamStats.end(); ++it)
+	{
+		underrunCount += (*it).underrunCount;
+	}
+	
+	char line[128] = { 0 };
+	std::string result;
+	sprintf(line, "Streams: %d (%u underruns)\n", static_cast<s32>(m_streamStats.size()), underrunCount);
+	result += line;
+	
+	for (StreamStatsCollection::const_iterator it = m_streamStats.begin(); it != m_streamStats.end(); ++it)
+	{
+		const u64 averageInUs = ((*it).decodeCount > 0) ? (*it).decodeTimeInUs / (*it).decodeCount : 0;
+		sprintf(line, "#%u %u ms: decode %u/%u us, %u underruns\n", (*it).id, (*it).bufferLengthInMs,
+		        static_cast<u32>(averageInUs), static_cast<u32>((*it).maxDecodeTimeInUs), (*it).underrunCount);
+		result += line;
+	}
+	return result;
+}
+#endif
+
+
 // Namespace end
 }
 }
@@ -933,6 +933,20 @@ bool setPositionalAudioModel(const VoicePtr& p_voice, const audio::xact::RPCCurv
 }
 
 
+#if !defined(TT_BUILD_FINAL)
+std::string getDebugStreamInfo(identifier p_identifier)
+{
+	SoundSystem* sys = getSoundSystem(p_identifier);
+	if (sys == 0)
+	{
+		return std::string();
+	}
+	
+	return sys->getDebugStreamInfo();
+}
+#endif
+
+
 // Namespace end
 }
 }
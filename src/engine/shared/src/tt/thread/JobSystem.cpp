@@ -0,0 +1,428 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+
+#include <tt/platform/tt_error.h>
+#include <tt/profiler/TraceRecorder.h>
+#include <tt/thread/JobSystem.h>
+#include <tt/thread/thread.h>
+
+
+namespace tt {
+namespace thread {
+
+//--------------------------------------------------------------------------------------------------
+// Inner worker pool
+
+namespace
+{
+
+struct JobQueue
+{
+	std::mutex                mutex;
+	std::deque<JobSystem::Job*> jobs;
+};
+
+
+struct WorkerPool
+{
+	typedef std::vector<tt::thread::handle> ThreadHandles;
+
+	// Queue 0 is shared by all threads that are not workers (main thread, load threads),
+	// queue i + 1 is owned by worker i.
+	static std::vector<JobQueue*>  ms_queues;
+	static ThreadHandles           ms_threads;
+	static std::atomic<s32>        ms_queuedJobCount;
+	static std::atomic<bool>       ms_exitWorkers;
+	static std::mutex              ms_sleepMutex;
+	static std::condition_variable ms_sleepCondition;
+	static std::condition_variable ms_waitCondition;  // Threads in waitFor whose jobs run elsewhere
+	static s32                     ms_waitingCount;   // Guarded by ms_sleepMutex
+
+	static JobSystem::Job* popOrSteal(size_t p_ownQueue);
+	static void            push(size_t p_queue, JobSystem::Job* p_job);
+	static void            wakeWaitingThreads();
+};
+
+std::vector<JobQueue*>     WorkerPool::ms_queues;
+WorkerPool::ThreadHandles  WorkerPool::ms_threads;
+std::atomic<s32>           WorkerPool::ms_queuedJobCount(0);
+std::atomic<bool>          WorkerPool::ms_exitWorkers(false);
+std::mutex                 WorkerPool::ms_sleepMutex;
+std::condition_variable    WorkerPool::ms_sleepCondition;
+std::condition_variable    WorkerPool::ms_waitCondition;
+s32                        WorkerPool::ms_waitingCount = 0;
+
+// Queue owned by the current thread (0 for non worker threads)
+static thread_local size_t ts_queueIndex = 0;
+
+
+JobSystem::Job* WorkerPool::popOrSteal(size_t p_ownQueue)
+{
+	if (ms_queuedJobCount.load(std::memory_order_acquire) <= 0 || ms_queues.empty())
+	{
+		return 0;
+	}
+
+	// Own queue first, newest job first (LIFO keeps the data it touches in cache)
+	{
+		JobQueue& queue = *ms_queues[p_ownQueue];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty() == false)
+		{
+			JobSystem::Job* job = queue.jobs.back();
+			queue.jobs.pop_back();
+			--ms_queuedJobCount;
+			return job;
+		}
+	}
+
+	// Steal the oldest job from the other queues
+	const size_t queueCount = ms_queues.size();
+	for (size_t i = 1; i < queueCount; ++i)
+	{
+		JobQueue& queue = *ms_queues[(p_ownQueue + i) % queueCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty() == false)
+		{
+			JobSystem::Job* job = queue.jobs.front();
+			queue.jobs.pop_front();
+			--ms_queuedJobCount;
+			return job;
+		}
+	}
+	return 0;
+}
+
+
+void WorkerPool::push(size_t p_queue, JobSystem::Job* p_job)
+{
+	{
+		JobQueue& queue = *ms_queues[p_queue];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(p_job);
+		++ms_queuedJobCount;
+	}
+
+	if (ms_threads.empty() == false)
+	{
+		std::lock_guard<std::mutex> lock(ms_sleepMutex);
+		ms_sleepCondition.notify_one();
+
+		// Waiting threads run queued jobs too; when every worker is busy (or waiting inside a job)
+		// nobody else would pick this one up.
+		if (ms_waitingCount > 0)
+		{
+			ms_waitCondition.notify_all();
+		}
+	}
+}
+
+
+void WorkerPool::wakeWaitingThreads()
+{
+	std::lock_guard<std::mutex> lock(ms_sleepMutex);
+	if (ms_waitingCount > 0)
+	{
+		ms_waitCondition.notify_all();
+	}
+}
+
+
+// Anonymous namespace end
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// JobSystem
+
+void JobSystem::createThreads(s32 p_workerCount)
+{
+	TT_ASSERTMSG(WorkerPool::ms_threads.empty(), "JobSystem worker threads were already created.");
+
+	s32 workerCount = p_workerCount;
+	if (workerCount < 0)
+	{
+		workerCount = std::max(tt::thread::getProcessorCount() - 1, 1);
+	}
+
+	WorkerPool::ms_exitWorkers = false;
+	WorkerPool::ms_queues.push_back(new JobQueue);
+	for (s32 i = 0; i < workerCount; ++i)
+	{
+		WorkerPool::ms_queues.push_back(new JobQueue);
+	}
+
+	for (s32 i = 0; i < workerCount; ++i)
+	{
+		char threadName[64];
+		sprintf(threadName, "ThreadPool %d", static_cast<int>(i));
+		void* queueIndex(reinterpret_cast<void*>(static_cast<size_t>(i + 1)));
+		WorkerPool::ms_threads.push_back(tt::thread::create(&JobSystem::workerProc, queueIndex, false, 0,
+		                                                    tt::thread::priority_highest,
+		                                                    tt::thread::Affinity_None, threadName));
+	}
+}
+
+
+void JobSystem::destroyThreads()
+{
+	{
+		std::lock_guard<std::mutex> lock(WorkerPool::ms_sleepMutex);
+		WorkerPool::ms_exitWorkers = true;
+		WorkerPool::ms_sleepCondition.notify_all();
+	}
+
+	for (auto& it : WorkerPool::ms_threads)
+	{
+		tt::thread::wait(it);
+		if (tt::thread::hasEnded(it) == false)
+		{
+			TT_PANIC("Failed to exit job system thread '%p'. Forcing exit", it.get());
+			tt::thread::terminate(it, 0);
+		}
+	}
+	WorkerPool::ms_threads.clear();
+
+	TT_ASSERTMSG(WorkerPool::ms_queuedJobCount == 0, "Destroying job system with %d jobs still queued.",
+	             WorkerPool::ms_queuedJobCount.load());
+	for (auto& it : WorkerPool::ms_queues)
+	{
+		delete it;
+	}
+	WorkerPool::ms_queues.clear();
+}
+
+
+s32 JobSystem::getWorkerCount()
+{
+	return static_cast<s32>(WorkerPool::ms_threads.size());
+}
+
+
+void JobSystem::submit(Job* p_jobs, size_t p_count)
+{
+	// Submitting holds a reference on every job, so jobs that finish while we're still submitting
+	// can't queue a dependent that we haven't reached yet (which would queue it twice).
+	for (size_t i = 0; i < p_count; ++i)
+	{
+		TT_NULL_ASSERT(p_jobs[i].counter);
+		p_jobs[i].counter->m_value.fetch_add(1, std::memory_order_relaxed);
+		p_jobs[i].unfinishedDependencies.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	for (size_t i = 0; i < p_count; ++i)
+	{
+		if (p_jobs[i].unfinishedDependencies.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		{
+			continue; // Will be queued by the last job it depends on.
+		}
+
+		if (WorkerPool::ms_queues.empty())
+		{
+			// No worker threads; run it right away.
+			runJob(&p_jobs[i]);
+		}
+		else
+		{
+			WorkerPool::push(ts_queueIndex, &p_jobs[i]);
+		}
+	}
+}
+
+
+void JobSystem::waitFor(const Counter& p_counter)
+{
+	while (p_counter.isDone() == false)
+	{
+		Job* job = WorkerPool::popOrSteal(ts_queueIndex);
+		if (job != 0)
+		{
+			runJob(job);
+		}
+		else
+		{
+			// The remaining jobs are running on other threads. Sleep until one of them completes a
+			// counter or queues more work (the checks are done under the lock the notifiers take,
+			// so no wake up is missed).
+			std::unique_lock<std::mutex> lock(WorkerPool::ms_sleepMutex);
+			++WorkerPool::ms_waitingCount;
+			WorkerPool::ms_waitCondition.wait(lock, [&p_counter]
+				{
+					return p_counter.isDone() || WorkerPool::ms_queuedJobCount.load(std::memory_order_acquire) > 0;
+				});
+			--WorkerPool::ms_waitingCount;
+		}
+	}
+}
+
+
+void JobSystem::parallelFor(size_t p_count, size_t p_grainSize, const RangeFunction& p_function)
+{
+	if (p_count == 0)
+	{
+		return;
+	}
+
+	const size_t grainSize  = std::max(p_grainSize, size_t(1));
+	const size_t chunkCount = (p_count + grainSize - 1) / grainSize;
+
+	if (chunkCount == 1 || WorkerPool::ms_threads.empty())
+	{
+		p_function(0, p_count);
+		return;
+	}
+
+	// Every job keeps grabbing chunks until the range is exhausted,
+	// so there are never more jobs than threads that can run them.
+	std::atomic<size_t> nextChunk(0);
+	const JobFunction processChunks([&]()
+		{
+			for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+			{
+				const size_t begin = chunk * grainSize;
+				p_function(begin, std::min(begin + grainSize, p_count));
+			}
+		});
+
+	const size_t jobCount = std::min(chunkCount, WorkerPool::ms_threads.size() + 1);
+	Counter counter;
+	std::vector<Job> jobs(jobCount);
+	for (auto& job : jobs)
+	{
+		job.function = processChunks;
+		job.counter  = &counter;
+	}
+
+	submit(&jobs[0], jobs.size());
+	waitFor(counter);
+}
+
+
+void JobSystem::runJob(Job* p_job)
+{
+	TT_NULL_ASSERT(p_job);
+	{
+		TT_TRACE_SCOPE("Job");
+		p_job->function();
+	}
+
+	// Queue the jobs that were waiting for this one (before signalling completion, so the
+	// counter can't reach zero while dependents still have to run).
+	for (auto& dependent : p_job->dependents)
+	{
+		if (dependent->unfinishedDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			if (WorkerPool::ms_queues.empty())
+			{
+				runJob(dependent);
+			}
+			else
+			{
+				WorkerPool::push(ts_queueIndex, dependent);
+			}
+		}
+	}
+
+	if (p_job->counter->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		// The waiting thread may destroy the counter and job from here on.
+		WorkerPool::wakeWaitingThreads();
+	}
+}
+
+
+int JobSystem::workerProc(void* p_queueIndex)
+{
+	ts_queueIndex = reinterpret_cast<size_t>(p_queueIndex);
+	
+	char threadName[64];
+	sprintf(threadName, "ThreadPool %d", static_cast<int>(ts_queueIndex - 1));
+	tt::profiler::TraceRecorder::setThreadName(threadName);
+
+	while (WorkerPool::ms_exitWorkers == false)
+	{
+		JobSystem::Job* job = WorkerPool::popOrSteal(ts_queueIndex);
+		if (job != 0)
+		{
+			runJob(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(WorkerPool::ms_sleepMutex);
+		WorkerPool::ms_sleepCondition.wait(lock, []
+			{
+				return WorkerPool::ms_exitWorkers || WorkerPool::ms_queuedJobCount.load(std::memory_order_acquire) > 0;
+			});
+	}
+
+	return 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// JobGraph
+
+JobGraph::JobGraph()
+:
+m_jobs(),
+m_dependencies()
+{
+}
+
+
+JobGraph::JobID JobGraph::addJob(const JobSystem::JobFunction& p_function)
+{
+	m_jobs.push_back(JobSystem::Job());
+	m_jobs.back().function = p_function;
+	return static_cast<JobID>(m_jobs.size() - 1);
+}
+
+
+void JobGraph::addDependency(JobID p_job, JobID p_dependsOn)
+{
+	TT_ASSERT(p_job       >= 0 && p_job       < getJobCount());
+	TT_ASSERT(p_dependsOn >= 0 && p_dependsOn < getJobCount());
+	TT_ASSERTMSG(p_job != p_dependsOn, "Job %d can't depend on itself.", p_job);
+
+	Dependency dependency = { p_job, p_dependsOn };
+	m_dependencies.push_back(dependency);
+}
+
+
+void JobGraph::run()
+{
+	if (m_jobs.empty())
+	{
+		return;
+	}
+
+	// Jobs point at each other, so only link them now that the job storage won't move anymore.
+	JobSystem::Counter counter;
+	for (auto& job : m_jobs)
+	{
+		job.counter = &counter;
+		job.unfinishedDependencies = 0;
+		job.dependents.clear();
+	}
+	for (auto& dependency : m_dependencies)
+	{
+		++m_jobs[dependency.job].unfinishedDependencies;
+		m_jobs[dependency.dependsOn].dependents.push_back(&m_jobs[dependency.job]);
+	}
+
+	JobSystem::submit(&m_jobs[0], m_jobs.size());
+	JobSystem::waitFor(counter);
+
+	for (auto& job : m_jobs)
+	{
+		job.counter = 0;
+	}
+}
+
+
+// Namespace end
+}
+}
@@ -0,0 +1,511 @@
+#include <algorithm>
+#include <cstdio>
+
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+#include <tt/profiler/TraceRecorder.h>
+#include <tt/system/Time.h>
+#include <tt/thread/CriticalSection.h>
+#include <tt/thread/LoadGraph.h>
+
+
+namespace tt {
+namespace thread {
+
+// More threads than this only compete for the same disk
+static const s32 g_maxDefaultThreadCount = 4;
+
+
+struct SortOnStartTime
+{
+	explicit SortOnStartTime(const LoadGraph& p_graph) : graph(p_graph) { }
+	
+	inline bool operator()(LoadGraph::TaskID p_lhs, LoadGraph::TaskID p_rhs) const
+	{
+		return graph.getTiming(p_lhs).startTime < graph.getTiming(p_rhs).startTime;
+	}
+	
+	const LoadGraph& graph;
+};
+
+
+static u32 toMs(u64 p_microSeconds)
+{
+	return static_cast<u32>(p_microSeconds / 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+LoadGraph::LoadGraph()
+:
+m_tasks(),
+m_ready(),
+m_doneCount(0),
+m_started(false),
+m_cancelled(false),
+m_suspended(false),
+m_startTime(0),
+m_threadCount(0),
+m_threads(),
+m_onThreadStart(),
+m_onThreadExit(),
+m_mutex(),
+m_changed()
+{
+}
+
+
+LoadGraph::~LoadGraph()
+{
+	cancel();
+}
+
+
+LoadGraph::TaskID LoadGraph::addTask(const std::string& p_name, const StepFunction& p_step, s32 p_priority,
+                                     ThreadType p_threadType)
+{
+	TT_ASSERTMSG(m_started == false, "Can't add load task '%s' to a started LoadGraph.", p_name.c_str());
+	TT_ASSERT(p_step != 0);
+	
+	Task task;
+	task.name                   = p_name;
+	task.step                   = p_step;
+	task.priority               = p_priority;
+	task.threadType             = p_threadType;
+	task.state                  = State_Waiting;
+	task.unfinishedDependencies = 0;
+	task.stepStartTime          = 0;
+	m_tasks.push_back(task);
+	return static_cast<TaskID>(m_tasks.size() - 1);
+}
+
+
+void LoadGraph::addDependency(TaskID p_task, TaskID p_dependsOn)
+{
+	TT_ASSERT(m_started == false);
+	TT_ASSERT(p_task >= 0 && p_task < getTaskCount());
+	// Only depending on earlier tasks keeps the graph free of cycles
+	TT_ASSERTMSG(p_dependsOn >= 0 && p_dependsOn < p_task,
+	             "Load task '%s' can only depend on a task that was added before it.",
+	             m_tasks[p_task].name.c_str());
+	
+	Task& task(m_tasks[p_task]);
+	if (std::find(task.dependencies.begin(), task.dependencies.end(), p_dependsOn) != task.dependencies.end())
+	{
+		return;
+	}
+	task.dependencies.push_back(p_dependsOn);
+	++task.unfinishedDependencies;
+	m_tasks[p_dependsOn].dependents.push_back(p_task);
+}
+
+
+void LoadGraph::start(s32 p_threadCount, const ThreadFunction& p_onThreadStart,
+                      const ThreadFunction& p_onThreadExit)
+{
+	CriticalSection critSec(&m_mutex);
+	TT_ASSERTMSG(m_started == false, "LoadGraph was already started.");
+	
+	m_started       = true;
+	m_startTime     = system::Time::getInstance()->getMicroSeconds();
+	m_onThreadStart = p_onThreadStart;
+	m_onThreadExit  = p_onThreadExit;
+	
+	for (TaskID i = 0; i < getTaskCount(); ++i)
+	{
+		if (m_tasks[i].unfinishedDependencies == 0)
+		{
+			makeReady(i);
+		}
+	}
+	
+	s32 threadCount = p_threadCount;
+	if (threadCount < 0)
+	{
+		threadCount = std::min(std::max(getProcessorCount() - 1, 1), g_maxDefaultThreadCount);
+	}
+	
+	// The threads get a pointer to their entry: don't let the vector reallocate
+	m_threadCount = threadCount;
+	m_threads.resize(static_cast<LoadThreads::size_type>(threadCount));
+	for (s32 i = 0; i < threadCount; ++i)
+	{
+		char threadName[64];
+		sprintf(threadName, "Load Thread %d", static_cast<int>(i));
+		
+		LoadThread& entry(m_threads[i]);
+		entry.graph  = this;
+		entry.index  = i;
+		entry.thread = create(staticLoadThread, &entry, false, 0, priority_below_normal,
+		                      Affinity_None, threadName);
+	}
+}
+
+
+void LoadGraph::cancel()
+{
+	{
+		CriticalSection critSec(&m_mutex);
+		m_cancelled = true;
+		wakeLoadThreads();
+	}
+	
+	for (LoadThreads::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+	{
+		wait(it->thread);
+	}
+	m_threads.clear();
+}
+
+
+void LoadGraph::setSuspended(bool p_suspended)
+{
+	CriticalSection critSec(&m_mutex);
+	m_suspended = p_suspended;
+	if (m_suspended == false)
+	{
+		wakeLoadThreads();
+	}
+}
+
+
+void LoadGraph::processMainThreadTasks(u32 p_budgetMs)
+{
+	const u64 endTime = system::Time::getInstance()->getMilliSeconds() + p_budgetMs;
+	
+	m_mutex.lock();
+	do
+	{
+		TaskID taskID = -1;
+		if (m_started && m_cancelled == false && m_suspended == false)
+		{
+			taskID = popReadyTask(ThreadType_Main);
+			if (taskID < 0 && m_threadCount == 0)
+			{
+				// Without load threads the caller runs everything
+				taskID = popReadyTask(ThreadType_Load);
+			}
+		}
+		if (taskID < 0)
+		{
+			break;
+		}
+		
+		// Tasks aren't added after start, so the reference stays valid while unlocked
+		const Task& task(m_tasks[taskID]);
+		m_mutex.unlock();
+		
+		bool taskDone = false;
+		{
+			TT_TRACE_SCOPE(profiler::TraceRecorder::intern(task.name));
+			taskDone = task.step();
+		}
+		
+		m_mutex.lock();
+		finishStep(taskID, taskDone, -1);
+	}
+	while (system::Time::getInstance()->getMilliSeconds() < endTime);
+	m_mutex.unlock();
+}
+
+
+bool LoadGraph::isDone() const
+{
+	CriticalSection critSec(&m_mutex);
+	return m_doneCount == getTaskCount();
+}
+
+
+s32 LoadGraph::getDoneTaskCount() const
+{
+	CriticalSection critSec(&m_mutex);
+	return m_doneCount;
+}
+
+
+std::string LoadGraph::getRunningTaskName() const
+{
+	CriticalSection critSec(&m_mutex);
+	
+	const Task* running = 0;
+	for (Tasks::const_iterator it = m_tasks.begin(); it != m_tasks.end(); ++it)
+	{
+		if (it->state == State_Running && (running == 0 || it->priority > running->priority))
+		{
+			running = &(*it);
+		}
+	}
+	return (running != 0) ? running->name : std::string();
+}
+
+
+LoadGraph::Timing LoadGraph::getTiming(TaskID p_task) const
+{
+	TT_ASSERT(p_task >= 0 && p_task < getTaskCount());
+	CriticalSection critSec(&m_mutex);
+	return m_tasks[p_task].timing;
+}
+
+
+LoadGraph::TaskIDs LoadGraph::getCriticalPath() const
+{
+	CriticalSection critSec(&m_mutex);
+	TT_ASSERTMSG(m_doneCount == getTaskCount(), "Critical path is only known once all load tasks are done.");
+	
+	TaskIDs path;
+	if (m_tasks.empty())
+	{
+		return path;
+	}
+	
+	TaskID current = 0;
+	for (TaskID i = 1; i < getTaskCount(); ++i)
+	{
+		if (m_tasks[i].timing.endTime > m_tasks[current].timing.endTime)
+		{
+			current = i;
+		}
+	}
+	
+	for ( ;; )
+	{
+		path.push_back(current);
+		
+		const TaskIDs& dependencies(m_tasks[current].dependencies);
+		if (dependencies.empty())
+		{
+			break;
+		}
+		
+		TaskID latest = dependencies.front();
+		for (TaskIDs::const_iterator it = dependencies.begin(); it != dependencies.end(); ++it)
+		{
+			if (m_tasks[*it].timing.endTime > m_tasks[latest].timing.endTime)
+			{
+				latest = *it;
+			}
+		}
+		current = latest;
+	}
+	
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+
+void LoadGraph::printTimeline(const char* p_title) const
+{
+#if !defined(TT_BUILD_FINAL)
+	if (isDone() == false)
+	{
+		TT_Printf("%s: load tasks are still running.\n", p_title);
+		return;
+	}
+	
+	TaskIDs order;
+	u64     totalTime = 0;
+	u64     busyTime  = 0;
+	for (TaskID i = 0; i < getTaskCount(); ++i)
+	{
+		order.push_back(i);
+		totalTime = std::max(totalTime, m_tasks[i].timing.endTime);
+		busyTime += m_tasks[i].timing.runTime;
+	}
+	std::stable_sort(order.begin(), order.end(), SortOnStartTime(*this));
+	
+	TT_Printf("%s: %d load tasks took %u ms on %d load threads (%u ms of work).\n",
+	          p_title, getTaskCount(), toMs(totalTime), m_threadCount, toMs(busyTime));
+	TT_Printf("    start -    end   running  waited  steps  thread  task\n");
+	for (TaskIDs::const_iterator it = order.begin(); it != order.end(); ++it)
+	{
+		const Task& task(m_tasks[*it]);
+		char threadName[16];
+		if (task.timing.thread < 0)
+		{
+			sprintf(threadName, "main");
+		}
+		else
+		{
+			sprintf(threadName, "%d", static_cast<int>(task.timing.thread));
+		}
+		TT_Printf("   %6u - %6u  %8u  %6u  %5d  %6s  %s\n",
+		          toMs(task.timing.startTime), toMs(task.timing.endTime),
+		          toMs(task.timing.runTime),
+		          toMs(task.timing.startTime - task.timing.readyTime),
+		          task.timing.stepCount, threadName, task.name.c_str());
+	}
+	
+	// Time a critical task spent ready but without a free thread is time more threads would win back
+	const TaskIDs path(getCriticalPath());
+	u64 pathWaitTime = 0;
+	TT_Printf("Critical path:");
+	for (TaskIDs::const_iterator it = path.begin(); it != path.end(); ++it)
+	{
+		const Timing& timing(m_tasks[*it].timing);
+		pathWaitTime += (timing.endTime - timing.readyTime) - timing.runTime;
+		TT_Printf("%s %s (%u ms)", (it == path.begin()) ? "" : " >",
+		          m_tasks[*it].name.c_str(), toMs(timing.runTime));
+	}
+	TT_Printf("\nCritical path tasks waited %u ms for a free thread.\n", toMs(pathWaitTime));
+#else
+	(void)p_title;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+LoadGraph::TaskID LoadGraph::popReadyTask(ThreadType p_threadType)
+{
+	// Highest priority first; tasks with equal priority in the order they were added
+	TaskIDs::iterator best = m_ready.end();
+	for (TaskIDs::iterator it = m_ready.begin(); it != m_ready.end(); ++it)
+	{
+		const Task& task(m_tasks[*it]);
+		if (task.threadType == p_threadType &&
+		    (best == m_ready.end() || task.priority > m_tasks[*best].priority ||
+		     (task.priority == m_tasks[*best].priority && *it < *best)))
+		{
+			best = it;
+		}
+	}
+	
+	if (best == m_ready.end())
+	{
+		return -1;
+	}
+	
+	const TaskID taskID = *best;
+	m_ready.erase(best);
+	
+	Task& task(m_tasks[taskID]);
+	task.stepStartTime = getTime();
+	if (task.timing.stepCount == 0)
+	{
+		task.timing.startTime = task.stepStartTime;
+	}
+	task.state = State_Running;
+	return taskID;
+}
+
+
+void LoadGraph::makeReady(TaskID p_task)
+{
+	Task& task(m_tasks[p_task]);
+	TT_ASSERT(task.state == State_Waiting && task.unfinishedDependencies == 0);
+	task.state            = State_Ready;
+	task.timing.readyTime = getTime();
+	m_ready.push_back(p_task);
+}
+
+
+void LoadGraph::finishStep(TaskID p_task, bool p_taskDone, s32 p_thread)
+{
+	Task& task(m_tasks[p_task]);
+	TT_ASSERT(task.state == State_Running);
+	++task.timing.stepCount;
+	task.timing.runTime += getTime() - task.stepStartTime;
+	task.timing.thread   = p_thread;
+	
+	if (p_taskDone == false)
+	{
+		// Back in line, so a task that became ready with a higher priority can go first
+		task.state = State_Ready;
+		m_ready.push_back(p_task);
+		return;
+	}
+	
+	task.state          = State_Done;
+	task.timing.endTime = getTime();
+	task.step           = StepFunction(); // release whatever the task holds on to
+	++m_doneCount;
+	
+	for (TaskIDs::const_iterator it = task.dependents.begin(); it != task.dependents.end(); ++it)
+	{
+		Task& dependent(m_tasks[*it]);
+		TT_ASSERT(dependent.unfinishedDependencies > 0);
+		--dependent.unfinishedDependencies;
+		if (dependent.unfinishedDependencies == 0)
+		{
+			makeReady(*it);
+		}
+	}
+	
+	// New tasks may be ready, or everything is done and the load threads can exit
+	wakeLoadThreads();
+}
+
+
+void LoadGraph::wakeLoadThreads()
+{
+	// ConditionVariable::wake only wakes a single sleeper
+	for (LoadThreads::size_type i = 0; i < m_threads.size(); ++i)
+	{
+		m_changed.wake();
+	}
+}
+
+
+u64 LoadGraph::getTime() const
+{
+	return system::Time::getInstance()->getMicroSeconds() - m_startTime;
+}
+
+
+int LoadGraph::staticLoadThread(void* p_loadThread)
+{
+	LoadThread* loadThread = static_cast<LoadThread*>(p_loadThread);
+	TT_NULL_ASSERT(loadThread);
+	
+	char threadName[64];
+	sprintf(threadName, "Load Thread %d", static_cast<int>(loadThread->index));
+	profiler::TraceRecorder::setThreadName(threadName);
+	
+	loadThread->graph->loadThread(loadThread->index);
+	return 0;
+}
+
+
+void LoadGraph::loadThread(s32 p_index)
+{
+	if (m_onThreadStart != 0)
+	{
+		m_onThreadStart();
+	}
+	
+	m_mutex.lock();
+	while (m_cancelled == false && m_doneCount < getTaskCount())
+	{
+		const TaskID taskID = m_suspended ? -1 : popReadyTask(ThreadType_Load);
+		if (taskID < 0)
+		{
+			m_changed.sleep(&m_mutex);
+			continue;
+		}
+		
+		const Task& task(m_tasks[taskID]);
+		m_mutex.unlock();
+		
+		bool taskDone = false;
+		{
+			TT_TRACE_SCOPE(profiler::TraceRecorder::intern(task.name));
+			taskDone = task.step();
+		}
+		
+		m_mutex.lock();
+		finishStep(taskID, taskDone, p_index);
+	}
+	m_mutex.unlock();
+	
+	if (m_onThreadExit != 0)
+	{
+		m_onThreadExit();
+	}
+}
+
+// Namespace end
+}
+}
@@ -0,0 +1,83 @@
+#include <set>
+#include <vector>
+
+#include <unittestpp/unittestpp.h>
+
+#include <tt/code/FlatSet.h>
+#include <tt/math/Point2.h>
+
+
+SUITE(tt_code)
+{
+
+typedef tt::code::FlatSet<tt::math::Point2, tt::math::Point2Less> FlatPoint2Set;
+typedef std::set<tt::math::Point2, tt::math::Point2Less>          StdPoint2Set;
+
+
+TEST( FlatSet_sameOrderAsStdSet )
+{
+	FlatPoint2Set flat;
+	StdPoint2Set  reference;
+
+	// Insert in a scrambled order, with duplicates.
+	for (s32 i = 0; i < 500; ++i)
+	{
+		const tt::math::Point2 pos((i * 37) % 23, (i * 11) % 19);
+		CHECK_EQUAL(reference.insert(pos).second, flat.insert(pos).second);
+	}
+	CHECK_EQUAL(reference.size(), flat.size());
+
+	// Range insert must merge and skip duplicates.
+	std::vector<tt::math::Point2> extra;
+	for (s32 i = 0; i < 50; ++i)
+	{
+		extra.push_back(tt::math::Point2(i % 30, 20 + (i % 3)));
+	}
+	reference.insert(extra.begin(), extra.end());
+	flat.insert(extra.begin(), extra.end());
+	CHECK_EQUAL(reference.size(), flat.size());
+
+	// Erase a few
+	for (s32 i = 0; i < 100; i += 3)
+	{
+		const tt::math::Point2 pos(i % 23, i % 19);
+		CHECK_EQUAL(reference.erase(pos), flat.erase(pos));
+	}
+
+	CHECK_EQUAL(reference.size(), flat.size());
+	StdPoint2Set::const_iterator refIt = reference.begin();
+	for (FlatPoint2Set::const_iterator it = flat.begin(); it != flat.end(); ++it, ++refIt)
+	{
+		CHECK(*it == *refIt);
+		CHECK(flat.find(*it) == it);
+	}
+	CHECK(flat.find(tt::math::Point2(-1, -1)) == flat.end());
+}
+
+
+TEST( FlatMap_findInsertErase )
+{
+	typedef tt::code::FlatMap<tt::math::Point2, s32, tt::math::Point2Less> FlatPoint2Map;
+	FlatPoint2Map map;
+
+	CHECK(map.insert(std::make_pair(tt::math::Point2(3, 1), 31)).second);
+	CHECK(map.insert(std::make_pair(tt::math::Point2(1, 2), 12)).second);
+	CHECK(map.insert(std::make_pair(tt::math::Point2(3, 1), 99)).second == false);
+	map[tt::math::Point2(2, 0)] = 20;
+
+	CHECK_EQUAL(3u, map.size());
+	CHECK_EQUAL(31, map.find(tt::math::Point2(3, 1))->second);
+	CHECK_EQUAL(12, map.begin()->second);
+	CHECK_EQUAL(1u, map.erase(tt::math::Point2(1, 2)));
+	CHECK_EQUAL(0u, map.erase(tt::math::Point2(1, 2)));
+	CHECK(map.find(tt::math::Point2(1, 2)) == map.end());
+
+	const FlatPoint2Map::size_type capacity = map.capacity();
+	map.clear();
+	CHECK(map.empty());
+	CHECK_EQUAL(capacity, map.capacity());
+}
+
+
+// End SUITE
+}
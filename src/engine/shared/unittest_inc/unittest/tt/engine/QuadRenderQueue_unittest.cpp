@@ -0,0 +1,206 @@
+#include <vector>
+
+#include <unittestpp/unittestpp.h>
+
+#include <tt/engine/renderer/QuadBuffer.h>
+#include <tt/engine/renderer/QuadRenderQueue.h>
+
+
+SUITE(tt_engine_quadRenderQueue)
+{
+
+using tt::engine::renderer::BatchQuadCollection;
+using tt::engine::renderer::QuadBuffer;
+using tt::engine::renderer::QuadRenderBackend;
+using tt::engine::renderer::QuadRenderQueue;
+using tt::engine::renderer::QuadRenderState;
+using tt::engine::renderer::QuadVertex;
+
+
+/*! \brief Backend that only records what it is asked to draw. */
+class RecordingQuadRenderBackend : public QuadRenderBackend
+{
+public:
+	struct Draw
+	{
+		BufferID        buffer;
+		s32             firstVertex;
+		s32             quadCount;
+		QuadRenderState state;
+	};
+	typedef std::vector<Draw> Draws;
+	
+	RecordingQuadRenderBackend()
+	:
+	draws(),
+	m_nextBuffer(1),
+	m_streamed(0),
+	m_state()
+	{ }
+	
+	Draws draws;
+	
+protected:
+	virtual BufferID doCreateRetainedBuffer(const QuadVertex*, s32) { return m_nextBuffer++; }
+	virtual void     doDestroyRetainedBuffer(BufferID)               { }
+	virtual s32      doStreamVertices(const QuadVertex*, s32 p_vertexCount)
+	{
+		const s32 first = m_streamed;
+		m_streamed += p_vertexCount;
+		return first;
+	}
+	virtual void doSetState(const QuadRenderState& p_state) { m_state = p_state; }
+	virtual void doDrawQuads(BufferID p_buffer, s32 p_firstVertex, s32 p_quadCount)
+	{
+		Draw draw = { p_buffer, p_firstVertex, p_quadCount, m_state };
+		draws.push_back(draw);
+	}
+	
+private:
+	BufferID        m_nextBuffer;
+	s32             m_streamed;
+	QuadRenderState m_state;
+};
+
+
+static void fill(QuadBuffer& p_buffer, s32 p_quadCount)
+{
+	BatchQuadCollection quads(static_cast<BatchQuadCollection::size_type>(p_quadCount));
+	p_buffer.setCollection(quads);
+}
+
+
+TEST(MergesConsecutiveEqualStates)
+{
+	using namespace tt::engine::renderer;
+	RecordingQuadRenderBackend backend;
+	QuadRenderQueue            queue(&backend);
+	
+	QuadBuffer a(8);
+	QuadBuffer b(8);
+	QuadBuffer c(8);
+	fill(a, 2);
+	fill(b, 3);
+	fill(c, 4);
+	
+	queue.begin();
+	queue.submit(a, BlendMode_Blend);
+	queue.submit(b, BlendMode_Blend);
+	queue.submit(c, BlendMode_Premultiplied);
+	queue.flush();
+	
+	CHECK_EQUAL(false, queue.isRecording());
+	CHECK_EQUAL(2, backend.getStats().drawCalls);
+	CHECK_EQUAL(2, backend.getStats().stateChanges);
+	CHECK_EQUAL(9, backend.getStats().quadsDrawn);
+	CHECK_EQUAL(5, backend.draws[0].quadCount);
+	CHECK_EQUAL(BlendMode_Blend, backend.draws[0].state.blendMode);
+	CHECK_EQUAL(4, backend.draws[1].quadCount);
+	CHECK_EQUAL(BlendMode_Premultiplied, backend.draws[1].state.blendMode);
+}
+
+
+TEST(KeepsOrderOfBlendedDraws)
+{
+	using namespace tt::engine::renderer;
+	RecordingQuadRenderBackend backend;
+	QuadRenderQueue            queue(&backend);
+	
+	QuadBuffer a(4);
+	QuadBuffer b(4);
+	QuadBuffer c(4);
+	fill(a, 1);
+	fill(b, 1);
+	fill(c, 1);
+	
+	// a and c share a state, but b is drawn in between and must stay there
+	queue.begin();
+	queue.submit(a, BlendMode_Blend, BlendModeAlpha_NoOverride, true);
+	queue.submit(b, BlendMode_Blend, BlendModeAlpha_NoOverride, false);
+	queue.submit(c, BlendMode_Blend, BlendModeAlpha_NoOverride, true);
+	queue.flush();
+	
+	CHECK_EQUAL(3, backend.getStats().drawCalls);
+	CHECK_EQUAL(true,  backend.draws[0].state.fogEnabled);
+	CHECK_EQUAL(false, backend.draws[1].state.fogEnabled);
+	CHECK_EQUAL(true,  backend.draws[2].state.fogEnabled);
+}
+
+
+TEST(SortsAdditiveDraws)
+{
+	using namespace tt::engine::renderer;
+	RecordingQuadRenderBackend backend;
+	QuadRenderQueue            queue(&backend);
+	
+	QuadBuffer a(4);
+	QuadBuffer b(4, TexturePtr(), BatchFlagQuad_UseVertexColor);
+	QuadBuffer c(4);
+	QuadBuffer d(4);
+	fill(a, 1);
+	fill(b, 1);
+	fill(c, 1);
+	fill(d, 1);
+	
+	// Additive draws don't depend on order, so a and c are merged; d ends the additive run
+	queue.begin();
+	queue.submit(a, BlendMode_Add);
+	queue.submit(b, BlendMode_Add);
+	queue.submit(c, BlendMode_Add);
+	queue.submit(d, BlendMode_Blend);
+	queue.flush();
+	
+	CHECK_EQUAL(3, backend.getStats().drawCalls);
+	CHECK_EQUAL(2, backend.draws[0].quadCount);
+	CHECK_EQUAL(false, backend.draws[0].state.vertexColor);
+	CHECK_EQUAL(1, backend.draws[1].quadCount);
+	CHECK_EQUAL(true, backend.draws[1].state.vertexColor);
+	CHECK_EQUAL(BlendMode_Blend, backend.draws[2].state.blendMode);
+	
+	// Passes are drawn in order, regardless of submit order
+	backend.draws.clear();
+	queue.begin();
+	queue.submit(a, BlendMode_Blend, BlendModeAlpha_NoOverride, true, 1);
+	queue.submit(b, BlendMode_Blend, BlendModeAlpha_NoOverride, true, 0);
+	queue.flush();
+	
+	CHECK_EQUAL(2, static_cast<s32>(backend.draws.size()));
+	CHECK_EQUAL(true,  backend.draws[0].state.vertexColor);
+	CHECK_EQUAL(false, backend.draws[1].state.vertexColor);
+}
+
+
+TEST(RetainsUnchangedBuffers)
+{
+	using namespace tt::engine::renderer;
+	RecordingQuadRenderBackend backend;
+	QuadRenderQueue            queue(&backend);
+	
+	QuadBuffer staticQuads(16);
+	fill(staticQuads, 10);
+	const u64 size = 10 * QuadRenderBackend::VerticesPerQuad * sizeof(QuadVertex);
+	
+	// First draw streams, second uploads once to a retained buffer, after that nothing is uploaded
+	for (s32 i = 0; i < 4; ++i)
+	{
+		queue.begin();
+		queue.submit(staticQuads, BlendMode_Blend);
+		queue.flush();
+	}
+	CHECK_EQUAL(4, backend.getStats().drawCalls);
+	CHECK_EQUAL(1, backend.getStats().retainedBuffers);
+	CHECK_EQUAL(size * 2, backend.getStats().bytesUploaded);
+	CHECK_EQUAL(0u, backend.draws[0].buffer);
+	CHECK(backend.draws[3].buffer != 0);
+	
+	// Changing the quads drops the retained buffer
+	fill(staticQuads, 10);
+	queue.begin();
+	queue.submit(staticQuads, BlendMode_Blend);
+	queue.flush();
+	CHECK_EQUAL(0u, backend.draws[4].buffer);
+	CHECK_EQUAL(size * 3, backend.getStats().bytesUploaded);
+}
+
+// Namespace end
+}
@@ -0,0 +1,116 @@
+#include <atomic>
+#include <vector>
+
+#include <unittestpp/unittestpp.h>
+
+#include <tt/thread/JobSystem.h>
+
+
+SUITE(tt_thread)
+{
+
+static void checkParallelFor(size_t p_count, size_t p_grainSize)
+{
+	std::vector<std::atomic<s32> > visits(p_count);
+	for (auto& it : visits)
+	{
+		it = 0;
+	}
+
+	tt::thread::JobSystem::parallelFor(p_count, p_grainSize, [&](size_t p_begin, size_t p_end)
+		{
+			CHECK(p_begin < p_end);
+			// Without workers the whole range is processed in one call.
+			CHECK(p_end - p_begin <= p_grainSize || tt::thread::JobSystem::getWorkerCount() == 0);
+			for (size_t i = p_begin; i < p_end; ++i)
+			{
+				++visits[i];
+			}
+		});
+
+	for (auto& it : visits)
+	{
+		CHECK_EQUAL(1, it.load());
+	}
+}
+
+
+static void checkGraphOrder()
+{
+	// Diamond: 0 -> (1, 2) -> 3, plus a chain of 16 jobs after 3.
+	std::atomic<s32> step(0);
+	std::vector<s32> finishedAt(20, -1);
+
+	tt::thread::JobGraph graph;
+	for (s32 i = 0; i < 20; ++i)
+	{
+		graph.addJob([&step, &finishedAt, i]() { finishedAt[i] = step++; });
+	}
+	graph.addDependency(1, 0);
+	graph.addDependency(2, 0);
+	graph.addDependency(3, 1);
+	graph.addDependency(3, 2);
+	for (s32 i = 4; i < 20; ++i)
+	{
+		graph.addDependency(i, i - 1);
+	}
+
+	// A graph can be run more than once.
+	for (s32 run = 0; run < 2; ++run)
+	{
+		step = 0;
+		graph.run();
+		CHECK_EQUAL(20, step.load());
+		CHECK(finishedAt[0] < finishedAt[1]);
+		CHECK(finishedAt[0] < finishedAt[2]);
+		CHECK(finishedAt[1] < finishedAt[3]);
+		CHECK(finishedAt[2] < finishedAt[3]);
+		for (s32 i = 4; i < 20; ++i)
+		{
+			CHECK(finishedAt[i - 1] < finishedAt[i]);
+		}
+	}
+}
+
+
+TEST( JobSystem_withoutThreadsRunsInline )
+{
+	CHECK_EQUAL(0, tt::thread::JobSystem::getWorkerCount());
+	checkParallelFor(1000, 7);
+	checkGraphOrder();
+}
+
+
+TEST( JobSystem_parallelForAndGraph )
+{
+	tt::thread::JobSystem::createThreads(3);
+	CHECK_EQUAL(3, tt::thread::JobSystem::getWorkerCount());
+
+	checkParallelFor(0, 1);
+	checkParallelFor(1, 1);
+	checkParallelFor(10000, 1);
+	checkParallelFor(10000, 64);
+	checkGraphOrder();
+
+	// Nested parallelFor inside graph jobs must not deadlock.
+	std::atomic<s32> total(0);
+	tt::thread::JobGraph graph;
+	for (s32 i = 0; i < 8; ++i)
+	{
+		graph.addJob([&total]()
+			{
+				tt::thread::JobSystem::parallelFor(100, 10, [&total](size_t p_begin, size_t p_end)
+					{
+						total += static_cast<s32>(p_end - p_begin);
+					});
+			});
+	}
+	graph.run();
+	CHECK_EQUAL(800, total.load());
+
+	tt::thread::JobSystem::destroyThreads();
+	CHECK_EQUAL(0, tt::thread::JobSystem::getWorkerCount());
+}
+
+// End SUITE
+}
@@ -0,0 +1,150 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <unittestpp/unittestpp.h>
+
+#include <tt/thread/LoadGraph.h>
+#include <tt/thread/thread.h>
+
+
+SUITE(tt_thread_loadGraph)
+{
+
+using tt::thread::LoadGraph;
+
+
+static void waitUntilDone(LoadGraph& p_graph)
+{
+	while (p_graph.isDone() == false)
+	{
+		p_graph.processMainThreadTasks(10);
+		tt::thread::sleep(1);
+	}
+}
+
+
+TEST(RunsDependenciesFirst)
+{
+	// Diamond 0 -> (1, 2) -> 3, where 2 takes three steps
+	std::atomic<s32> order(0);
+	std::vector<s32> finishedAt(4, -1);
+	s32 stepsOf2 = 0;
+	
+	LoadGraph graph;
+	graph.addTask("0", [&]() { finishedAt[0] = order++; return true; });
+	graph.addTask("1", [&]() { finishedAt[1] = order++; return true; });
+	graph.addTask("2", [&]() { ++stepsOf2; if (stepsOf2 < 3) return false; finishedAt[2] = order++; return true; });
+	graph.addTask("3", [&]() { finishedAt[3] = order++; return true; });
+	graph.addDependency(1, 0);
+	graph.addDependency(2, 0);
+	graph.addDependency(3, 1);
+	graph.addDependency(3, 2);
+	
+	graph.start(3);
+	waitUntilDone(graph);
+	graph.cancel();
+	
+	CHECK_EQUAL(0, finishedAt[0]);
+	CHECK(finishedAt[1] > finishedAt[0]);
+	CHECK(finishedAt[2] > finishedAt[0]);
+	CHECK_EQUAL(3, finishedAt[3]);
+	CHECK_EQUAL(3, stepsOf2);
+	CHECK_EQUAL(3, graph.getTiming(2).stepCount);
+	CHECK_EQUAL(4, graph.getDoneTaskCount());
+	
+	// 0, whichever of 1 and 2 finished last, then 3
+	LoadGraph::TaskIDs path(graph.getCriticalPath());
+	CHECK_EQUAL(3, static_cast<s32>(path.size()));
+	CHECK_EQUAL(3, path.back());
+}
+
+
+TEST(RunsHighestPriorityFirst)
+{
+	// A single thread makes the order deterministic
+	std::vector<s32> order;
+	
+	LoadGraph graph;
+	graph.addTask("low",    [&]() { order.push_back(0); return true; }, 0);
+	graph.addTask("high",   [&]() { order.push_back(1); return true; }, 10);
+	graph.addTask("medium", [&]() { order.push_back(2); return true; }, 5);
+	graph.addTask("low2",   [&]() { order.push_back(3); return true; }, 0);
+	
+	graph.start(1);
+	waitUntilDone(graph);
+	
+	CHECK_EQUAL(4, static_cast<s32>(order.size()));
+	CHECK_EQUAL(1, order[0]);
+	CHECK_EQUAL(2, order[1]);
+	CHECK_EQUAL(0, order[2]);
+	CHECK_EQUAL(3, order[3]);
+}
+
+
+TEST(RunsMainThreadTasksOnCaller)
+{
+	const std::thread::id self(std::this_thread::get_id());
+	bool loadedOnLoadThread = false;
+	bool uploadedOnMain     = false;
+	bool afterUpload        = false;
+	
+	LoadGraph graph;
+	const LoadGraph::TaskID load = graph.addTask("load",
+		[&]() { loadedOnLoadThread = std::this_thread::get_id() != self; return true; });
+	const LoadGraph::TaskID upload = graph.addTask("upload",
+		[&]() { uploadedOnMain = std::this_thread::get_id() == self; return true; },
+		0, LoadGraph::ThreadType_Main);
+	const LoadGraph::TaskID after = graph.addTask("after", [&]() { afterUpload = uploadedOnMain; return true; });
+	graph.addDependency(upload, load);
+	graph.addDependency(after, upload);
+	
+	graph.start(2);
+	waitUntilDone(graph);
+	
+	CHECK(loadedOnLoadThread);
+	CHECK(uploadedOnMain);
+	CHECK(afterUpload);
+	CHECK_EQUAL(-1, graph.getTiming(upload).thread);
+}
+
+
+TEST(RunsEverythingOnCallerWithoutLoadThreads)
+{
+	const std::thread::id self(std::this_thread::get_id());
+	s32 stepsOnCaller = 0;
+	
+	LoadGraph graph;
+	graph.addTask("load", [&]() { if (std::this_thread::get_id() == self) ++stepsOnCaller; return stepsOnCaller >= 2; });
+	graph.addTask("upload", [&]() { if (std::this_thread::get_id() == self) ++stepsOnCaller; return true; },
+		0, LoadGraph::ThreadType_Main);
+	graph.addDependency(1, 0);
+	
+	graph.start(0);
+	waitUntilDone(graph);
+	
+	CHECK_EQUAL(3, stepsOnCaller);
+}
+
+
+TEST(CancelStopsBetweenSteps)
+{
+	std::atomic<s32> steps(0);
+	
+	LoadGraph graph;
+	graph.addTask("endless", [&]() { ++steps; tt::thread::sleep(1); return false; });
+	graph.start(1);
+	while (steps.load() < 2)
+	{
+		tt::thread::sleep(1);
+	}
+	graph.cancel();
+	
+	const s32 stepsAtCancel = steps.load();
+	tt::thread::sleep(5);
+	CHECK_EQUAL(stepsAtCancel, steps.load());
+	CHECK_EQUAL(false, graph.isDone());
+}
+
+// Namespace end
+}
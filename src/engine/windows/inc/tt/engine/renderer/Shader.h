@@ -27,6 +27,7 @@ class Shader : public D3DResource
 public:
 	static const file::FileType fileType = file::FileType_Shader;
 	static const bool hasResourceHeader = true;
+	static const bool hasThreadSafeLoad = false;
 	static const ShaderHandle invalidHandle;
 
 	~Shader();
@@ -32,6 +32,7 @@ class Texture : public TextureBase, public D3DResource
 public:
 	static const file::FileType fileType = file::FileType_Texture;
 	static const bool hasResourceHeader = true;
+	static const bool hasThreadSafeLoad = false; // Registers with D3DResourceRegistry and creates the D3D texture
 	
 	Texture(const TextureBaseInfo& p_info);
 	
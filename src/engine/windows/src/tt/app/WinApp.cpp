@@ -54,6 +54,7 @@
 #include <tt/input/Xbox360Controller.h>
 #include <tt/platform/tt_error.h>
 #include <tt/platform/tt_error_win.h>
+#include <tt/profiler/TraceRecorder.h>
 #include <tt/str/str.h>
 #include <tt/system/CPUInfo.h>
 #include <tt/system/Time.h>
@@ -609,6 +610,8 @@ m_debugKeys(DebugKeys_All)
 	
 	http::HttpConnectMgr::createInstance();
 	
+	tt::profiler::TraceRecorder::setThreadName("Main Thread");
+	
 	// Create the threads for the threaded workload pool
 	tt::thread::ThreadedWorkload::createThreads();
 
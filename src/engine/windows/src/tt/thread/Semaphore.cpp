@@ -69,6 +69,19 @@ bool Semaphore::tryWait()
 }
 
 
+bool Semaphore::timedWait(u32 p_milliSeconds)
+{
+	DWORD result = WaitForSingleObject(m_data->handle, static_cast<DWORD>(p_milliSeconds));
+	TT_ASSERTMSG(result != WAIT_FAILED, "WaitForSingleObject failed. Reason: '%s'", getLastErrorMessage().c_str());
+	if (result == WAIT_TIMEOUT)
+	{
+		return false;
+	}
+	
+	return true;
+}
+
+
 void Semaphore::signal()
 {
 	BOOL result = ReleaseSemaphore(m_data->handle, 1, 0);
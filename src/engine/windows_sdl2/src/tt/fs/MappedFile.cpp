@@ -0,0 +1,87 @@
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+#include <tt/fs/MappedFile.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+
+
+namespace tt {
+namespace fs {
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+MappedFilePtr MappedFile::open(const std::string& p_path)
+{
+	HANDLE file = CreateFileA(p_path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+	                          FILE_ATTRIBUTE_NORMAL, 0);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		TT_WARN("Opening '%s' for mapping failed with error %u.", p_path.c_str(), GetLastError());
+		return MappedFilePtr();
+	}
+	
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(file, &size) == FALSE || size.QuadPart <= 0)
+	{
+		TT_WARN("Cannot map '%s': unable to get its size or it is empty.", p_path.c_str());
+		CloseHandle(file);
+		return MappedFilePtr();
+	}
+	
+	HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+	
+	// The mapping keeps the file referenced and the view keeps the mapping referenced
+	CloseHandle(file);
+	if (mapping == 0)
+	{
+		TT_WARN("Creating a mapping of '%s' failed with error %u.", p_path.c_str(), GetLastError());
+		return MappedFilePtr();
+	}
+	
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (data == 0)
+	{
+		TT_WARN("Mapping '%s' failed with error %u.", p_path.c_str(), GetLastError());
+		return MappedFilePtr();
+	}
+	
+	return MappedFilePtr(new MappedFile(static_cast<const u8*>(data), static_cast<size_type>(size.QuadPart)));
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (m_data != 0)
+	{
+		UnmapViewOfFile(m_data);
+	}
+}
+
+
+void MappedFile::release(size_type p_offset, size_type p_size) const
+{
+	TT_ASSERT(p_offset >= 0 && p_size >= 0 && p_offset + p_size <= m_size);
+	
+	// Unlocking pages that aren't locked removes them from the working set
+	VirtualUnlock(const_cast<u8*>(m_data) + p_offset, static_cast<SIZE_T>(p_size));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+MappedFile::MappedFile(const u8* p_data, size_type p_size)
+:
+m_data(p_data),
+m_size(p_size)
+{
+}
+
+// Namespace end
+}
+}
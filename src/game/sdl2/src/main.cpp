@@ -123,6 +123,11 @@ int main(int p_argc, char** p_argv)
 	settings.useFixedDeltaTime = false;
 	//settings.useFixedDeltaTime = true;
 	
+#if !defined(TT_BUILD_FINAL)
+	// Benchmarks only simulate; don't show or render to a window.
+	settings.headless = toki::AppGlobal::getBenchmarkMode() != toki::AppGlobal::BenchmarkMode_None;
+#endif
+	
 #if defined(TT_BUILD_FINAL)
 	settings.graphicsSettings.startWindowed = false;
 #endif
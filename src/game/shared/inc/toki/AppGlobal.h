@@ -6,6 +6,7 @@
 #include <tt/engine/scene2d/shoebox/fwd.h>
 #include <tt/input/ControllerIndex.h>
 #include <tt/pres/fwd.h>
+#include <tt/thread/Mutex.h>
 
 #include <toki/game/entity/EntityLibrary.h>
 #include <toki/game/movement/fwd.h>
@@ -88,6 +89,7 @@ public:
 	static void addTexturesToPrecache(const tt::engine::renderer::TextureContainer& p_textures);
 	static void addPresentationToPrecache(const std::string& p_filename);
 	static void addMovementSetToPrecache(const game::movement::MovementSetPtr& p_movementSet);
+	static tt::engine::renderer::TextureContainer getPrecachedTextures();
 	
 	static void updateShoeboxTextures(         const tt::engine::scene2d::shoebox::ShoeboxDataPtr& p_data,
 	                                           const tt::engine::scene2d::shoebox::ShoeboxDataPtr& p_skinData,
@@ -123,6 +125,23 @@ public:
 	static bool shouldDoGpuCheck();
 #if !defined(TT_BUILD_FINAL)
 	static bool shouldCompileSquirrel();
+	static bool shouldPrecompileSquirrel();
+	
+	enum BenchmarkMode
+	{
+		BenchmarkMode_None,
+		BenchmarkMode_Replay,            // --benchmark, see input::ReplayBenchmark
+		BenchmarkMode_LevelLoad,         // --benchmark_levels, see level::LevelLoadBenchmark
+		BenchmarkMode_Particles,         // --benchmark_particles, see tt::engine::particles::ParticleBenchmark
+		BenchmarkMode_EntityCulling,     // --benchmark_entity_culling, see game::entity::EntityCullingBenchmark
+		BenchmarkMode_SkinUpdate,        // --benchmark_skin_update, see level::SkinUpdateBenchmark
+		BenchmarkMode_PresentationSpawn, // --benchmark_presentation_spawn, see tt::pres::PresentationBenchmark
+		BenchmarkMode_Fluids,            // --benchmark_fluids, see game::fluid::FluidBenchmark
+		
+		BenchmarkMode_Count
+	};
+	/*! \brief Returns the headless benchmark that was started from the command line, if any. */
+	static BenchmarkMode getBenchmarkMode();
 #endif
 	
 	static void loadScriptLists();
@@ -237,6 +256,8 @@ private:
 	static level::MetaDataGenerator      ms_metaDataGenerator;
 	static level::TileRegistrationMgrPtr ms_tileRegistrationMgr;
 	
+	// Precache load states run in parallel on the load threads
+	static tt::thread::Mutex            ms_precacheMutex;
 	static TextureSet                   ms_texturePrecache;
 	static tt::pres::PresentationMgrPtr ms_presentationMgr;
 	static PresentationSet              ms_presentationPrecache;
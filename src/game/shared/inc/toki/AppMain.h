@@ -7,6 +7,9 @@
 #include <tt/engine/renderer/fwd.h>
 #include <tt/fs/types.h>
 
+#include <toki/game/fluid/fwd.h>
+#include <toki/input/fwd.h>
+
 #if !defined(TT_BUILD_FINAL)
 #define ENABLE_DEBUG_INFO 1
 #else
@@ -59,6 +62,7 @@ private:
 	main::AppStateMachine* m_stateMachine;
 	
 	tt::fs::MemoryArchivePtr m_archive;
+	tt::fs::PackArchivePtr   m_packArchive;
 	CachedShaders m_cachedShaders;
 	
 	real m_badPerfTime;
@@ -75,6 +79,8 @@ private:
 	
 #if !defined(TT_BUILD_FINAL)
 	bool m_enableMemoryBudgetWarning;
+	input::ReplayBenchmarkPtr m_replayBenchmark;
+	game::fluid::FluidBenchmarkPtr m_fluidBenchmark;
 #endif
 };
 
@@ -22,8 +22,9 @@ public:
 	static CheckPointMgrPtr create(ProgressType p_progressType); //!< Use ProgressType to decide size limit.
 	static CheckPointMgrPtr create(u32 p_sizeLimitCheckpoints);
 	
-	void setCheckPoint(const serialization::SerializationMgrPtr& p_checkPointData,
-	                   const std::string&                        p_id);
+	/*! \return The compressed checkpoint that was stored, or null if it wasn't stored. */
+	tt::code::BufferPtr setCheckPoint(const serialization::SerializationMgrPtr& p_checkPointData,
+	                                  const std::string&                        p_id);
 	serialization::SerializationMgrPtr getCheckPoint(const std::string& p_id) const;
 	
 	tt::str::Strings getAllCheckPointIDs() const;
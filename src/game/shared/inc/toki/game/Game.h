@@ -9,6 +9,7 @@
 #include <tt/engine/scene2d/shoebox/shoebox.h>
 #include <tt/input/Button.h>
 #include <tt/pres/fwd.h>
+#include <tt/thread/JobSystem.h>
 #include <tt/thread/thread.h>
 #include <tt/thread/Semaphore.h>
 #include <tt/thread/Mutex.h>
@@ -32,6 +33,7 @@
 #include <toki/level/fwd.h>
 #include <toki/level/types.h>
 #include <toki/pres/fwd.h>
+#include <toki/serialization/RewindBuffer.h>
 #include <toki/serialization/SerializationMgr.h>
 #include <toki/utils/SectionProfiler.h>
 #include <toki/utils/AssetMonitor.h>
@@ -154,6 +156,8 @@ public:
 	inline pres::PresentationObjectMgr& getPresentationObjectMgr() { TT_NULL_ASSERT(m_presentationObjectMgr); return *m_presentationObjectMgr; }
 	inline pathfinding::PathMgr&        getPathMgr()               { return m_pathMgr; }
 	
+	inline const utils::FrameUpdateSectionProfiler& getUpdateSectionProfiler() const { return m_updateSectionProfiler; }
+	
 #if defined(TT_STEAM_BUILD)
 	void createWorkshopLevelPicker();
 	void openWorkshopLevelPicker();
@@ -234,6 +238,11 @@ public:
 	
 	void unserializeGameState(const std::string& p_id, bool p_removeCheckpointAfterRestore = false, ProgressType p_progressType = ProgressType_Invalid);
 	
+	/*! \brief Causes the game to restore a recent checkpoint at the start of the next frame.
+	    \param p_checkPointsBack 0 restores the most recently stored checkpoint. */
+	void rewindGameState(s32 p_checkPointsBack);
+	inline s32 getRewindCheckPointCount() const { return m_rewindBuffer.getCount(); }
+	
 	void serializeAll  (      toki::serialization::SerializationMgr& p_serializationMgr) const;
 	void unserializeAll(const toki::serialization::SerializationMgr& p_serializationMgr,
 	                    const std::string& p_serializationID);
@@ -317,6 +326,8 @@ private:
 	tt::engine::scene2d::shoebox::ShoeboxDataPtr generateLevelSkinData() const;
 	tt::engine::renderer::EngineIDToTextures createEmptyShoeboxesWithPreviousSettings();
 	void createShoeboxesFromDataInclSkin();
+	void updateShoeboxesFromDataInclSkin();
+	void createShoeboxesFromData();
 	void buildPathFindingData();
 	void loadPathFindingData();
 	
@@ -419,6 +430,8 @@ private:
 	light::DarknessMgrPtr          m_darknessMgr;
 	bool                           m_stopLightRenderingOnSplit;
 	pathfinding::PathMgr           m_pathMgr;
+	tt::thread::JobGraph           m_lightPathGraph;     // Light and path update (see update())
+	real                           m_lightPathDeltaTime; // Delta time for m_lightPathGraph
 	
 	entity::effect::ColorGradingEffectMgrPtr m_colorGradingEffectMgr;
 	entity::effect::FogEffectMgrPtr          m_fogEffectMgr;
@@ -453,14 +466,17 @@ private:
 	{
 		SerializationAction_None,        // Do nothing
 		SerializationAction_Serialize,   // Serializes the game at the end of the current frame
-		SerializationAction_Unserialize  // Unserializes the game at the start of the next frame
+		SerializationAction_Unserialize, // Unserializes the game at the start of the next frame
+		SerializationAction_Rewind       // Unserializes a checkpoint from the rewind buffer at the start of the next frame
 	};
 	SerializationAction m_serializationAction;
 	std::string         m_serializationID;
 	ProgressType        m_serializationProgressType;
 	bool                m_serializationRemoveAfterUnserialize;
+	s32                 m_rewindCheckPointsBack;
+	serialization::RewindBuffer m_rewindBuffer; // Recently stored checkpoints of the current level
 	
-	utils::SectionProfiler<utils::FrameUpdateSection, utils::FrameUpdateSection_Count> m_updateSectionProfiler;
+	utils::FrameUpdateSectionProfiler m_updateSectionProfiler;
 	utils::SectionProfiler<utils::FrameUpdateForRenderSection, utils::FrameUpdateForRenderSection_Count> m_updateForRenderSectionProfiler;
 #if ENABLE_RENDER_SECTIONS
 	mutable utils::SectionProfiler<utils::FrameRenderSection, utils::FrameRenderSection_Count> m_renderSectionProfiler;
@@ -429,9 +429,10 @@ public:
 	{ return m_sensors; }
 	
 	// Culling
-	inline void setPositionCullingEnabled(bool p_enabled) { m_positionCullingEnabled = p_enabled; }
+	inline void setPositionCullingEnabled(bool p_enabled) { m_positionCullingEnabled = p_enabled; updateCullingData(); }
 	inline bool hasPositionCullingParent() const          { return m_positionCullingParent.isEmpty() == false; }
-	inline void setPositionCullingParent(const EntityHandle& p_parent) { m_positionCullingParent = p_parent; }
+	inline void setPositionCullingParent(const EntityHandle& p_parent) { m_positionCullingParent = p_parent; updateCullingData(); }
+	inline const EntityHandle& getPositionCullingParent() const { return m_positionCullingParent; }
 	
 	/*! \brief Indicates whether this entity has position culling when going outside culling rectangle. */
 	inline bool isPositionCullingEnabled() const { return m_positionCullingEnabled; }
@@ -545,6 +546,8 @@ private:
 #endif
 	
 	void setPositionCulled(bool p_isCulled); // Used by EntityMgr
+	void setCullingData(EntityCullingData* p_cullingData); // Used by EntityMgr
+	void updateCullingData() const;
 	
 	// Order of members is 64-bit aligned
 	
@@ -625,6 +628,7 @@ private:
 	tt::math::Vector2    m_touchShapeOffset;
 	
 	EntityHandle         m_positionCullingParent;
+	EntityCullingData*   m_cullingData; // not serialized: owned by EntityMgr, which sets it
 	
 	EntityTilesPtr      m_collisionTiles;
 	tt::math::PointRect m_collisionTilesRegdRect;  // registered tile rect for the entity's own collision tiles
@@ -0,0 +1,41 @@
+#if !defined(INC_TOKI_GAME_ENTITY_ENTITYCULLINGBENCHMARK_H)
+#define INC_TOKI_GAME_ENTITY_ENTITYCULLINGBENCHMARK_H
+
+#include <tt/args/CmdLine.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace toki {
+namespace game {
+namespace entity {
+
+/*! \brief Compares the per-frame culling and on-screen passes of EntityMgr on EntityCullingData with the
+           previous passes, which visited every Entity in the entity array.
+    Started with --benchmark_entity_culling. Creates --benchmark_entities synthetic entities (default 10000),
+    a tenth of them with a culling parent, spread over a level that a camera pans across for
+    --benchmark_frames frames (default 600), --benchmark_iterations times (default 5). Every frame a tenth
+    of the entities moves. The previous passes read the entity fields with the stride of Entity, like they
+    did in the entity array. Before every frame a large buffer is written, like the rest of a game frame
+    pushes the entities out of the caches; --benchmark_warm skips that. Reports the time of both and
+    checks that both cull the same entities. Moving the entities, which updates their culling data, is
+    reported separately.
+    Everything is written as JSON to --benchmark_output (default benchmark_entity_culling.json). */
+class EntityCullingBenchmark
+{
+public:
+	/*! \return false if the results differ or the report could not be written. */
+	static bool run(const tt::args::CmdLine& p_cmdLine);
+	
+private:
+	EntityCullingBenchmark();                                               // Static class
+	EntityCullingBenchmark(const EntityCullingBenchmark&);                  // Disable copy
+	const EntityCullingBenchmark& operator=(const EntityCullingBenchmark&); // Disable assigment.
+};
+
+
+// Namespace end
+}
+}
+}
+
+#endif // !defined(INC_TOKI_GAME_ENTITY_ENTITYCULLINGBENCHMARK_H)
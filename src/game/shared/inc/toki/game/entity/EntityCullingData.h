@@ -0,0 +1,92 @@
+#if !defined(INC_TOKI_GAME_ENTITY_ENTITYCULLINGDATA_H)
+#define INC_TOKI_GAME_ENTITY_ENTITYCULLINGDATA_H
+
+
+#include <vector>
+
+#include <tt/math/Rect.h>
+#include <tt/platform/tt_types.h>
+
+#include <toki/game/entity/fwd.h>
+
+
+namespace toki {
+namespace game {
+namespace entity {
+
+/*! \brief Copy of the entity fields that the per-frame culling and on-screen passes of EntityMgr read,
+           as parallel arrays indexed like the entity array of EntityMgr.
+    An Entity is a big object: finding the few entities whose culling state changes by striding through
+    all of them costs a cache miss or more per entity. With these arrays that search is a tight loop and
+    only the entities it finds are touched. Entity keeps its entry up to date (Entity::updateCullingData);
+    its culling parent is stored as an index in the entity array. */
+class EntityCullingData
+{
+public:
+	enum Flag
+	{
+		Flag_Initialized        = 1 << 0,
+		Flag_InScreenspace      = 1 << 1,
+		Flag_CullingEnabled     = 1 << 2,
+		Flag_CullingInitialized = 1 << 3,
+		Flag_HasCullingParent   = 1 << 4,
+		Flag_Culled             = 1 << 5,
+		Flag_OnScreen           = 1 << 6
+	};
+	
+	/*! \param p_first Start of the entity array; the index of an entity is relative to it. */
+	EntityCullingData(const Entity* p_first, s32 p_capacity);
+	
+	/*! \brief Copies the culling fields of p_entity to its entry. */
+	void update(const Entity& p_entity);
+	
+	/*! \param p_parent Index of the culling parent, -1 if there is none or it doesn't exist (anymore). */
+	void set(s32 p_index, const tt::math::VectorRect& p_worldRect, u8 p_flags, s32 p_parent);
+	
+	/*! \brief Copies entry p_from to p_to, like HandleArrayMgr moves the last object into the slot of
+	           a destroyed one.
+	    \note The parent indices of the children of the moved entity are then out of date; they need an
+	          update() as well. */
+	void move(s32 p_from, s32 p_to);
+	
+	/*! \brief Finds which of the first p_count entities without a culling parent need
+	           Entity::updatePositionCulling().
+	    \param p_updates_OUT Receives 1 per entity that needs an update, 0 otherwise. */
+	void findCullingUpdates(s32 p_count, const tt::math::VectorRect& p_cullingRect,
+	                        const tt::math::VectorRect& p_uncullingRect, u8* p_updates_OUT) const;
+	
+	/*! \brief Finds which of the first p_count entities with a culling parent need
+	           Entity::updatePositionCulling(). Call this once the parents are updated.
+	    \param p_updates_OUT Receives 1 per entity that needs an update, 0 otherwise. */
+	void findChildCullingUpdates(s32 p_count, u8* p_updates_OUT) const;
+	
+	/*! \brief Finds which of the first p_count entities need Entity::updateIsOnScreen().
+	    \param p_changed_OUT Receives 1 per initialized entity that entered or left p_screenRect, 0 otherwise. */
+	void findOnScreenChanges(s32 p_count, const tt::math::VectorRect& p_screenRect, u8* p_changed_OUT) const;
+	
+	inline s32 getCapacity() const { return static_cast<s32>(m_flags.size()); }
+	inline bool hasCullingParent(s32 p_index) const { return (m_flags[p_index] & Flag_HasCullingParent) != 0; }
+	
+private:
+	enum Rect
+	{
+		Rect_InCulling   = 1 << 1,
+		Rect_InUnculling = 1 << 2
+	};
+	
+	const Entity*     m_first;
+	std::vector<real> m_left;
+	std::vector<real> m_top;
+	std::vector<real> m_right;
+	std::vector<real> m_bottom;
+	std::vector<u8>   m_flags;
+	std::vector<s32>  m_parent;
+};
+
+// Namespace end
+}
+}
+}
+
+
+#endif  // !defined(INC_TOKI_GAME_ENTITY_ENTITYCULLINGDATA_H)
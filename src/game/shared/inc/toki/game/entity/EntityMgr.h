@@ -18,6 +18,7 @@
 #include <toki/game/entity/sensor/SensorMgr.h>
 #include <toki/game/entity/sensor/TileSensorMgr.h>
 #include <toki/game/entity/Entity.h>
+#include <toki/game/entity/EntityCullingData.h>
 #include <toki/game/entity/fwd.h>
 #include <toki/game/Camera.h>
 #include <toki/level/entity/fwd.h>
@@ -133,6 +134,9 @@ private:
 	
 	void destroyEntity(EntityHandle p_handle);
 	
+	/*! \brief Destroys the entity and moves the culling data of the last entity along with it. */
+	void destroyAndUpdateCullingData(const EntityHandle& p_handle);
+	
 	void updateCullingForAllEntities(const Camera& p_camera);
 	void updateIsOnScreenAllEntities(const Camera& p_camera);
 	
@@ -156,6 +160,10 @@ private:
 	
 	bool          m_entityCullingEnabled;
 	
+	EntityCullingData m_cullingData;
+	std::vector<u8>   m_cullingUpdates;        // Scratch buffer for the culling passes, one entry per entity
+	bool              m_cullingParentsChanged; // An entity moved or was destroyed: update the parent indices
+	
 #if !defined(TT_BUILD_FINAL)
 	enum { maxTimingFrames = 60 };
 	using Timings = std::map<std::string, u64[maxTimingFrames]>;
@@ -164,6 +172,8 @@ private:
 #endif
 	
 	utils::SectionProfiler<utils::EntityMgrSection, utils::EntityMgrSection_Count> m_sectionProfiler;
+	const s32 m_sensorCandidatesCounter;
+	const s32 m_sensorTestsCounter;
 };
 
 
@@ -24,6 +24,8 @@ typedef std::set<EntityHandle> EntityHandleSet;
 class EntityMgr;
 typedef tt_ptr<EntityMgr>::shared EntityMgrPtr;
 
+class EntityCullingData;
+
 class EntityTiles;
 typedef tt_ptr<EntityTiles>::shared EntityTilesPtr;
 typedef tt_ptr<EntityTiles>::weak   EntityTilesWeakPtr;
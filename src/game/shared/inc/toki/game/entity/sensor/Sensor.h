@@ -46,7 +46,9 @@ public:
 	Sensor(const CreationParams& p_creationParams, const SensorHandle& p_ownHandle);
 	~Sensor();
 	
-	void update();
+	/*! \brief Gathers the entities in range, from p_broadphase if it is passed (p_stats_OUT then
+	           gets the candidate and test counts added) or else from the TileRegistrationMgr. */
+	void update(const SensorBroadphase* p_broadphase = 0, SensorBroadphaseStats* p_stats_OUT = 0);
 	void updateCallbacks(real64 p_gameTime);
 	
 	void renderDebug() const;
@@ -178,7 +180,8 @@ private:
 	typedef std::vector<DelayedEntity> DelayedEntities;
 	
 	void distanceSort(EntityHandles& p_handles) const;
-	void getSensedEntities(Entity* p_source, EntityHandles* p_result_OUT);
+	void getSensedEntities(Entity* p_source, const SensorBroadphase* p_broadphase,
+	                       SensorBroadphaseStats* p_stats_OUT, EntityHandles* p_result_OUT);
 	void filterSensedEntities(Entity* p_source, EntityHandles* p_result_OUT);
 	bool isTargetInRange(Entity* p_source, Entity* p_target) const;
 	bool isActive(const Entity* p_source) const;
@@ -0,0 +1,111 @@
+#if !defined(INC_TOKI_GAME_ENTITY_SENSOR_SENSORBROADPHASE_H)
+#define INC_TOKI_GAME_ENTITY_SENSOR_SENSORBROADPHASE_H
+
+#include <vector>
+
+#include <tt/math/Point2.h>
+#include <tt/math/Vector2.h>
+#include <tt/platform/tt_types.h>
+
+#include <toki/game/entity/sensor/fwd.h>
+#include <toki/game/entity/fwd.h>
+
+
+namespace toki {
+namespace game {
+namespace entity {
+namespace sensor {
+
+/*! \brief Candidate and narrow phase test counts of the broadphase queries of sensors. */
+struct SensorBroadphaseStats
+{
+	inline SensorBroadphaseStats() : candidateCount(0), testCount(0) { }
+	
+	inline void add(const SensorBroadphaseStats& p_stats)
+	{
+		candidateCount += p_stats.candidateCount;
+		testCount      += p_stats.testCount;
+	}
+	
+	s32 candidateCount; // Entities found in the cells of a query (each entity once per query)
+	s32 testCount;      // Entities tested against the shape of a sensor
+};
+
+
+/*! \brief Grid with the entities all sensors query during SensorMgr::update(), built once per frame.
+    The cells are the cells of the TileRegistrationMgr and an entity is in the cells its registered
+    tile rect covers, so a query finds the same entities in the same order as the TileRegistrationMgr.
+    What the sensors test of an entity (position, detection and light flags) is gathered once here
+    instead of per sensor per cell. Only valid until entities move, are created or are destroyed. */
+class SensorBroadphase
+{
+public:
+	enum Flag
+	{
+		Flag_DetectableBySight = 1 << 0,
+		Flag_DetectableByTouch = 1 << 1,
+		Flag_Lit               = 1 << 2  // Not detectable by light or in light
+	};
+	
+	struct Candidate
+	{
+		EntityHandle      handle;
+		const Entity*     entity;
+		tt::math::Vector2 centerPosition;
+		tt::math::Point2  minCell;        // Inclusive
+		tt::math::Point2  maxCell;        // Inclusive
+		u32               flags;
+	};
+	
+	SensorBroadphase();
+	
+	/*! \brief Fills the grid with all unsuspended and unculled entities registered with the TileRegistrationMgr. */
+	void build(const EntityMgr& p_entityMgr, const tt::math::Point2& p_levelBounds);
+	
+	inline s32 getCandidateCount() const { return static_cast<s32>(m_candidates.size()); }
+	inline const Candidate& getCandidate(s32 p_index) const { return m_candidates[p_index]; }
+	
+	inline bool containsCell(s32 p_cellX, s32 p_cellY) const
+	{
+		return p_cellX >= 0 && p_cellY >= 0 && p_cellX < m_cellBounds.x && p_cellY < m_cellBounds.y;
+	}
+	
+	/*! \brief The candidate indices in a cell, sorted on entity handle.
+	    \note Caller is responsible for range checking the cell (see containsCell). */
+	inline const s32* getCellBegin(s32 p_cellX, s32 p_cellY) const
+	{
+		return m_cellEntries.empty() ? 0 : &m_cellEntries[0] + m_cellStarts[getCellIndex(p_cellX, p_cellY)];
+	}
+	inline const s32* getCellEnd(s32 p_cellX, s32 p_cellY) const
+	{
+		return m_cellEntries.empty() ? 0 : &m_cellEntries[0] + m_cellStarts[getCellIndex(p_cellX, p_cellY) + 1];
+	}
+	
+private:
+	typedef std::vector<Candidate> Candidates;
+	typedef std::vector<s32>       Indices;
+	
+	inline s32 getCellIndex(s32 p_cellX, s32 p_cellY) const
+	{
+		TT_ASSERT(containsCell(p_cellX, p_cellY));
+		return p_cellX + p_cellY * m_cellBounds.x;
+	}
+	
+	SensorBroadphase(const SensorBroadphase&);                  // Disable copy
+	const SensorBroadphase& operator=(const SensorBroadphase&); // Disable assigment.
+	
+	tt::math::Point2 m_cellBounds;
+	Candidates       m_candidates;
+	Indices          m_cellStarts;  // Per cell the first index in m_cellEntries, plus the end of the last cell
+	Indices          m_cellEntries; // Candidate indices
+	Indices          m_cellFill;    // Only used in build. It's a member so we don't create and destroy it so much.
+};
+
+// Namespace end
+}
+}
+}
+}
+
+
+#endif  // !defined(INC_TOKI_GAME_ENTITY_SENSOR_SENSORBROADPHASE_H)
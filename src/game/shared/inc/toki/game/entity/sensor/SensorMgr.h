@@ -6,6 +6,7 @@
 
 #include <toki/game/entity/sensor/fwd.h>
 #include <toki/game/entity/sensor/Sensor.h>
+#include <toki/game/entity/sensor/SensorBroadphase.h>
 #include <toki/game/entity/fwd.h>
 #include <toki/serialization/fwd.h>
 
@@ -36,6 +37,9 @@ public:
 	
 	inline s32 getActiveSensorCount() const { return m_sensors.getActiveCount(); }
 	
+	/*! \brief The broadphase candidate and test counts of all sensors in the last update. */
+	inline const SensorBroadphaseStats& getBroadphaseStats() const { return m_broadphaseStats; }
+	
 	// FIXME: (Un)serialization should probably indicate whether this was successful
 	void serialize  (      toki::serialization::SerializationMgr& p_serializationMgr) const;
 	void unserialize(const toki::serialization::SerializationMgr& p_serializationMgr);
@@ -43,10 +47,15 @@ public:
 private:
 	void updateSensor(size_t p_index);
 
-	typedef tt::code::HandleArrayMgr<Sensor> Sensors;
+	typedef tt::code::HandleArrayMgr<Sensor>    Sensors;
+	typedef std::vector<SensorBroadphaseStats> SensorStats;
 	
 	Sensors m_sensors;
 	s32 m_updateIndex;
+	
+	SensorBroadphase      m_broadphase;       // Shared by all sensors in update()
+	SensorStats           m_sensorStats;      // Per sensor, so the threads don't share counters
+	SensorBroadphaseStats m_broadphaseStats;
 };
 
 // Namespace end
@@ -8,6 +8,7 @@
 #include <tt/math/Rect.h>
 
 #include <toki/game/entity/sensor/fwd.h>
+#include <toki/game/entity/sensor/SensorBroadphase.h>
 #include <toki/game/entity/fwd.h>
 #include <toki/level/helpers.h>
 #include <toki/level/fwd.h>
@@ -47,8 +48,14 @@ public:
 	
 	virtual void updateTransform(const Entity& p_parent, const tt::math::Vector2& p_position, const Sensor* p_sensor = 0);
 	
-	void getEntitiesWithCenterInRange   (const Sensor& p_sensor, EntityHandles& p_entities) const;
-	void getEntitiesWithWorldRectInRange(const Sensor& p_sensor, EntityHandles& p_entities) const;
+	/*! \brief Gathers the entities in range from the TileRegistrationMgr, or from p_broadphase if it is passed
+	           (p_stats_OUT then gets the candidate and test counts added). */
+	void getEntitiesWithCenterInRange   (const Sensor& p_sensor, EntityHandles& p_entities,
+	                                     const SensorBroadphase* p_broadphase = 0,
+	                                     SensorBroadphaseStats*  p_stats_OUT  = 0) const;
+	void getEntitiesWithWorldRectInRange(const Sensor& p_sensor, EntityHandles& p_entities,
+	                                     const SensorBroadphase* p_broadphase = 0,
+	                                     SensorBroadphaseStats*  p_stats_OUT  = 0) const;
 	
 	bool isShapeInRange (const ShapePtr& p_shape) const;
 	
@@ -85,10 +92,13 @@ protected:
 	virtual void serializeImpl  (tt::code::BufferWriteContext* p_context) const = 0;
 	virtual void unserializeImpl(tt::code::BufferReadContext*  p_context)       = 0;
 	
-	virtual void getEntitiesInRange(const Sensor& p_sensor, bool p_center, EntityHandles& p_entities) const = 0;
+	virtual void getEntitiesInRange(const Sensor& p_sensor, bool p_center,
+	                                const SensorBroadphase* p_broadphase, SensorBroadphaseStats* p_stats_OUT,
+	                                EntityHandles& p_entities) const = 0;
 	virtual tt::math::VectorRect getRect(const Entity& p_parent) const = 0;
 	
 	bool isInRange(const Entity& p_target, bool p_center) const;
+	bool isInRange(const Sensor& p_sensor, const SensorBroadphase::Candidate& p_target, bool p_center) const;
 	
 	void getEntitiesInRangeOnTilePosition(const Sensor&            p_sensor,
 	                                      bool                     p_center,
@@ -96,6 +106,23 @@ protected:
 	                                      const level::TileRegistrationMgr& p_tileMgr,
 	                                      EntityHandles&           p_entities) const;
 	
+	/*! \brief Same as getEntitiesInRangeOnTilePosition() for all cells from p_minCell to p_maxCell (inclusive). */
+	void getEntitiesInRangeInCells(const Sensor&            p_sensor,
+	                               bool                     p_center,
+	                               const tt::math::Point2&  p_minCell,
+	                               const tt::math::Point2&  p_maxCell,
+	                               const SensorBroadphase&  p_broadphase,
+	                               SensorBroadphaseStats&   p_stats_OUT,
+	                               EntityHandles&           p_entities) const;
+	
+	/*! \brief Same as getEntitiesInRangeOnTilePosition() for a single cell. */
+	void getEntitiesInRangeInCell(const Sensor&            p_sensor,
+	                              bool                     p_center,
+	                              const tt::math::Point2&  p_cell,
+	                              const SensorBroadphase&  p_broadphase,
+	                              SensorBroadphaseStats&   p_stats_OUT,
+	                              EntityHandles&           p_entities) const;
+	
 	tt::math::Vector2    m_position;
 	tt::math::VectorRect m_boundingRect;
 };
@@ -104,7 +131,9 @@ protected:
 class BoundingRectShape : public Shape
 {
 public:
-	virtual void getEntitiesInRange(const Sensor& p_sensor, bool p_center, EntityHandles& p_entities) const;
+	virtual void getEntitiesInRange(const Sensor& p_sensor, bool p_center,
+	                                const SensorBroadphase* p_broadphase, SensorBroadphaseStats* p_stats_OUT,
+	                                EntityHandles& p_entities) const;
 };
 
 
@@ -241,7 +270,9 @@ public:
 	virtual void updateTransform(const Entity& p_parent, const tt::math::Vector2& p_position,
 	                             const Sensor* p_sensor = 0);
 	
-	virtual void getEntitiesInRange(const Sensor& p_sensor, bool p_center, EntityHandles& p_entities) const;
+	virtual void getEntitiesInRange(const Sensor& p_sensor, bool p_center,
+	                                const SensorBroadphase* p_broadphase, SensorBroadphaseStats* p_stats_OUT,
+	                                EntityHandles& p_entities) const;
 	
 	virtual void visualize(const tt::engine::renderer::ColorRGBA& p_color) const;
 	
@@ -33,6 +33,8 @@ class RayTracer;
 class Sensor;
 typedef tt::code::Handle<Sensor> SensorHandle;
 
+class SensorBroadphase;
+struct SensorBroadphaseStats;
 class SensorMgr;
 class Shape;
 typedef tt_ptr<Shape>::shared ShapePtr;
@@ -0,0 +1,54 @@
+#if !defined(INC_TOKI_GAME_FLUID_FLUIDBENCHMARK_H)
+#define INC_TOKI_GAME_FLUID_FLUIDBENCHMARK_H
+
+#include <string>
+
+#include <tt/args/CmdLine.h>
+#include <tt/platform/tt_types.h>
+
+#include <toki/game/fluid/fwd.h>
+#include <toki/game/fwd.h>
+
+
+namespace toki {
+namespace game {
+namespace fluid {
+
+/*! \brief Measures the fluid simulation of a level, started with --benchmark_fluids.
+    Waits until the game has loaded its start level (pass it with --level) and updated once. Then,
+    --benchmark_iterations times (default 5), it restarts the fluids from their sources and grows them
+    with FluidMgr::update for --benchmark_frames frames (default 600), followed by the pregeneration
+    that runs when a level starts. Reports the time of both and a hash of the fluid layer after every
+    iteration; all iterations must end with the same fluids.
+    It also floods a 1024 x 512 test layer frontier by frontier, as many times, once with std::set and
+    once with FlatSet (fluid::Point2Set) work lists, and reports both timings.
+    Everything is written as JSON to --benchmark_output (default benchmark_fluids.json). */
+class FluidBenchmark
+{
+public:
+	static FluidBenchmarkPtr create(const tt::args::CmdLine& p_cmdLine);
+	
+	/*! \brief Call after every game tick.
+	    \return false when the benchmark ran and the report was written (or the benchmark failed). */
+	bool update();
+	
+private:
+	FluidBenchmark(const std::string& p_outputPath, s32 p_iterations, s32 p_frames);
+	
+	bool run(Game& p_game) const;
+	
+	const std::string m_outputPath;
+	const s32         m_iterations;
+	const s32         m_frames;
+	
+	FluidBenchmark(const FluidBenchmark&);                  // Disable copy
+	const FluidBenchmark& operator=(const FluidBenchmark&); // Disable assigment.
+};
+
+
+// Namespace end
+}
+}
+}
+
+#endif // !defined(INC_TOKI_GAME_FLUID_FLUIDBENCHMARK_H)
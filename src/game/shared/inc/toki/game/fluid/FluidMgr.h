@@ -7,6 +7,7 @@
 
 #include <tt/audio/player/SoundCue.h>
 #include <tt/cfg/Handle.h>
+#include <tt/code/FlatSet.h>
 #include <tt/math/Point2.h>
 #include <tt/math/Rect.h>
 #include <tt/platform/tt_types.h>
@@ -109,7 +110,7 @@ public:
 	
 private:
 	typedef std::vector<tt::math::Point2> Point2s;
-	typedef std::map<tt::math::Point2, tt::audio::player::SoundCuePtr, tt::math::Point2Less> SoundCues;
+	typedef tt::code::FlatMap<tt::math::Point2, tt::audio::player::SoundCuePtr, tt::math::Point2Less> SoundCues;
 	typedef std::map<entity::EntityHandle, tt::audio::player::SoundCuePtr> EntitySoundCues;
 	
 	struct FluidFlowTypeData
@@ -235,6 +236,11 @@ private:
 	SoundCues m_soundCues;
 	SoundCues m_soundCuesForFalls;
 	
+	// Scratch storage for updateAudio, kept as members so the per frame update doesn't allocate.
+	SoundCues m_prevSoundCuesForFallsScratch;
+	Point2s   m_fallAudioPointsScratch;
+	Point2s   m_fallAudioPointsSortedScratch;
+	
 	typedef std::vector<tt::engine::particles::ParticleEffectPtr> ParticleEffects;
 	typedef std::vector<tt::math::PointRect>                      PointRects;
 	
@@ -310,8 +316,8 @@ private:
 	
 	WarpPairs m_warpPairs;
 	
-	// notified entities
-	entity::EntityHandleSet m_notifiedEntities;
+	// notified entities (unsorted, may contain duplicates until they are notified)
+	entity::EntityHandles m_notifiedEntities;
 	
 	FluidGraphicsMgr  m_graphicsMgr;
 	FluidParticlesMgr m_particlesMgr;
@@ -320,6 +326,12 @@ private:
 	
 	utils::SectionProfiler<utils::FluidMgrSection, utils::FluidMgrSection_Count> m_sectionProfiler;
 	
+	// Number of tiles processed since the last update, reported through the section profiler.
+	s32 m_changedTilesHandledCount;
+	s32 m_fluidTilesUpdatedCount;
+	s32 m_changedTilesHandledCounter;
+	s32 m_fluidTilesUpdatedCounter;
+	
 	// No copying
 	FluidMgr(const FluidMgr&);
 	FluidMgr& operator=(const FluidMgr&);
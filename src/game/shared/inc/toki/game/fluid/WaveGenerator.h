@@ -16,7 +16,8 @@ namespace toki {
 namespace game {
 namespace fluid {
 
-/*! \brief Manages the generation of waves on the fluid surfaces. */
+/*! \brief Manages the generation of waves on the fluid surfaces.
+    \note Surfaces that settled sleep until a wave or a change of the surface wakes them. */
 class WaveGenerator
 {
 public:
@@ -64,23 +65,57 @@ private:
 	};
 	
 	typedef std::vector<real> Reals;
+	
+	/*! \brief The part of a surface that decides how it is simulated. */
+	struct SimulationLayout
+	{
+		SimulationLayout()
+		:
+		size(0),
+		rightEdge(EdgeOption_Default),
+		leftEdge(EdgeOption_Default),
+		leftToStillIndex(0),
+		stillToRightIndex(0),
+		fluidType(FluidType_Invalid)
+		{ }
+		
+		inline bool operator==(const SimulationLayout& p_rhs) const
+		{
+			return size              == p_rhs.size              &&
+			       rightEdge         == p_rhs.rightEdge         &&
+			       leftEdge          == p_rhs.leftEdge          &&
+			       leftToStillIndex  == p_rhs.leftToStillIndex  &&
+			       stillToRightIndex == p_rhs.stillToRightIndex &&
+			       fluidType         == p_rhs.fluidType;
+		}
+		
+		Reals::size_type size;
+		EdgeOption       rightEdge;
+		EdgeOption       leftEdge;
+		Reals::size_type leftToStillIndex;
+		Reals::size_type stillToRightIndex;
+		FluidType        fluidType;
+	};
+	
 	struct SimulationData
 	{
 		SimulationData()
 		:
-		prevDensity(),
-		currDensity(),
+		offset(0),
+		size(0),
 		rightEdge(EdgeOption_Default),
 		leftEdge(EdgeOption_Default),
 		leftToStillIndex(0),
 		stillToRightIndex(0),
 		isDead(true),
+		isSleeping(false),
 		simulationSize(0),
-		fluidType(FluidType_Invalid)
+		fluidType(FluidType_Invalid),
+		simulatedLayout()
 		{ }
 		
-		Reals prevDensity;
-		Reals currDensity;
+		Reals::size_type offset; // Start of the heights of this surface in the height arenas
+		Reals::size_type size;   // Amount of heights of this surface in the height arenas
 		EdgeOption rightEdge;
 		EdgeOption leftEdge;
 		
@@ -88,9 +123,12 @@ private:
 		Reals::size_type stillToRightIndex;
 		
 		bool             isDead;
+		bool             isSleeping; // Settled; not simulated until a wave or a layout change wakes it
 		Reals::size_type simulationSize;
 		
 		FluidType fluidType;
+		
+		SimulationLayout simulatedLayout; // The layout the fade factors were set up for
 	};
 	
 	struct Point2LessYPriority
@@ -118,12 +156,24 @@ private:
 		:
 		moveSpeed(p_moveSpeed),
 		waveWidth(p_waveWidth),
-		waveHeight(p_waveHeight)
+		waveHeight(p_waveHeight),
+		heightSin(),
+		heightCos(),
+		offsetSin(0.0f),
+		offsetCos(1.0f)
 		{}
 		
 		real moveSpeed;
 		real waveWidth;
 		real waveHeight;
+		
+		// The wave is waveHeight * sin(phase + phaseOffset), with phase = pi * index * waveWidth and
+		// phaseOffset = angle * moveSpeed. It is added as heightSin * offsetCos + heightCos * offsetSin,
+		// so no sine has to be calculated per simulation point.
+		Reals heightSin; // waveHeight * sin(phase) per simulation index
+		Reals heightCos; // waveHeight * cos(phase) per simulation index
+		real  offsetSin; // sin(phaseOffset) of the current simulation step
+		real  offsetCos; // cos(phaseOffset) of the current simulation step
 	};
 	typedef std::vector<PersistentWaveSettings> PersistentWaves;
 	
@@ -154,10 +204,29 @@ private:
 	                       const tt::math::Point2& p_startPosition) const;
 	u32 convertQuadIndexToSimulationIndex(u32 p_waveQuadIndex) const;
 	
+	void updateWaveOffsets();
+	void updateWaveTables(Reals::size_type p_size);
+	void updateLayout(SimulationData& p_data);
+	void simulate(SimulationData& p_data);
+	
+	Reals::size_type allocateHeights(Reals::size_type p_count);
+	void copyHeights(Reals::size_type p_from, Reals::size_type p_to, Reals::size_type p_count);
+	void resizeHeights(SimulationData& p_data, Reals::size_type p_size);
+	void appendHeights(SimulationData& p_data, SimulationData& p_appendData);
+	void releaseHeights(SimulationData& p_data);
+	void compactHeights();
+	
 	
 	static const tt::math::Point2 ms_invalidPos;
 	
 	SurfaceHeights   m_surfaceHeights;
+	
+	// The heights of all surfaces. Every surface owns the span [offset, offset + size) of each arena.
+	Reals            m_prevHeights;
+	Reals            m_currHeights;
+	Reals            m_fadeFactors;   // Combined left and right fade of every height
+	Reals::size_type m_unusedHeights; // Heights in the arenas that no longer belong to a surface
+	
 	tt::math::Point2 m_startPos;
 	tt::math::Point2 m_prevPos;
 	real             m_accumulator;
@@ -9,6 +9,9 @@ namespace toki {
 namespace game {
 namespace fluid {
 
+class FluidBenchmark;
+typedef tt_ptr<FluidBenchmark>::shared FluidBenchmarkPtr;
+
 class FluidGraphicsMgr;
 
 struct FluidSettings;
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include <tt/code/BitMask.h>
+#include <tt/code/FlatSet.h>
 #include <tt/math/Rect.h>
 #include <tt/math/hash/Hash.h>
 #include <tt/platform/tt_error.h>
@@ -19,7 +20,9 @@ namespace toki  /*! */ {
 namespace game  /*! */ {
 namespace fluid /*! */ {
 
-typedef std::set<tt::math::Point2, tt::math::Point2Less> Point2Set;
+// Flat (sorted vector) set: iterates in the same order as std::set<Point2, Point2Less> would,
+// which the serialization and still fluid blob code depend on.
+typedef tt::code::FlatSet<tt::math::Point2, tt::math::Point2Less> Point2Set;
 
 enum FluidType
 {
@@ -128,6 +128,7 @@ private:
 	void onGameLayerCheckboxChanged  (Gwen::Controls::Base* p_sender);
 	
 	void hotKeyCycleSectionProfiler();
+	void hotKeyDumpTrace();
 	void hotKeyToggleCameraFollowEntity();
 	void hotKeyToggleFluidGraphics();
 	void hotKeyToggleFluidGraphicsDebug();
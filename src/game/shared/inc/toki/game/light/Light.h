@@ -42,7 +42,8 @@ public:
 	Light(const CreationParams& p_creationParams, const LightHandle& p_ownHandle);
 	
 	void update(real p_deltaTime);
-	void updateLightShape(const Polygons& p_occluders);
+	/*! \return true if the light shape was traced, false if it was inactive or could be kept as is. */
+	bool updateLightShape(const Polygons& p_occluders);
 	void render(real p_currentTime = 0.0f) const;
 	void renderGlow() const;
 	void debugRender();
@@ -104,8 +105,9 @@ public:
 		m_spread.startNewInterpolation(p_spread, p_duration);
 	}
 	
-	void getAffectedEntities(entity::EntityHandleSet&        p_entities,
-	                         const level::AttributeLayerPtr& p_attribs);
+	/*! \brief Updates whether the light is blocked at its source and adds the rays from this light to the
+	           light detection points of the entities it could light to p_batch. */
+	void addAffectedEntityRays(LightRayBatch& p_batch);
 	
 	bool isInLight(const tt::math::Vector2& p_worldPosition) const;
 	bool isInLight(const entity::Entity& p_targetEntity) const;
@@ -124,6 +126,7 @@ public:
 	void invalidateTempCopy() {}
 	
 	inline const tt::math::Vector2& getWorldPosition() const { return m_worldPos; }
+	inline tt::math::VectorRect getLightShapeRect() const { return m_lightShape.getBoundingRect(); }
 	
 private:
 	inline void setRadiusImpl(real p_radius)
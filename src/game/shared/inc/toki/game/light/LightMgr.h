@@ -13,7 +13,9 @@
 #include <toki/game/entity/fwd.h>
 #include <toki/game/light/fwd.h>
 #include <toki/game/light/Light.h>
+#include <toki/game/light/LightRayBatch.h>
 #include <toki/game/light/LightRayTracer.h>
+#include <toki/game/light/OccluderGrid.h>
 #include <toki/level/fwd.h>
 #include <toki/level/TileChangedObserver.h>
 #include <toki/serialization/fwd.h>
@@ -119,11 +121,21 @@ private:
 	typedef std::vector<tt::math::VectorRect>        Rects;
 	typedef std::vector<Light*>                      LightPtrs;
 	
+	// Buffers to collect the occluders of a single light; one per visible light, so they can be
+	// filled in parallel.
+	struct LightOccluders
+	{
+		Polygons        occluders;
+		OccluderIndices indices;
+	};
+	typedef std::vector<LightOccluders> LightOccludersList;
+	
 	void updateStaticOccluders();
 	bool updateDynamicOccluders();
 	void mergeStaticWithDynamicOccluders();
 	
-	void updateLightShape(size_t p_index, const Polygons& p_occluders);
+	const Polygons& getOccluders(const Light& p_light, LightOccluders& p_buffers) const;
+	bool updateLightShape(size_t p_index);
 	
 	void updateDarkness(); // Get (fresh) darkness rects from DarknessMgr.
 	void updateSensors();
@@ -150,10 +162,13 @@ private:
 	tt::math::Matrix44              m_fullScreenMtx;
 	s32                             m_lightAmbient; // The current alpha set in m_wholeLevelAmbientAlpha.
 	
-	Polygons       m_staticOccluders;
-	EntityPolygons m_dynamicOccluders;
-	Polygons       m_allOccluders;
-	Rects          m_darknessRects;
+	Polygons           m_staticOccluders;
+	OccluderGrid       m_staticOccluderGrid;
+	EntityPolygons     m_dynamicOccluders;
+	Polygons           m_dynamicOccludersList; // m_dynamicOccluders in map order
+	LightOccludersList m_visibleLightOccluders;
+	Rects              m_darknessRects;
+	LightRayBatch      m_lightRayBatch;
 	
 	level::AttributeLayerPtr m_levelLayer;
 	
@@ -198,6 +213,9 @@ private:
 #endif
 	
 	utils::SectionProfiler<utils::LightMgrSection, utils::LightMgrSection_Count> m_sectionProfiler;
+	const s32 m_rebuiltLightShapesCounter;
+	const s32 m_reusedLightShapesCounter;
+	const s32 m_lightRaysCounter;
 };
 
 
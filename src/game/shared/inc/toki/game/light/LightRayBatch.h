@@ -0,0 +1,68 @@
+#if !defined(INC_TOKI_GAME_LIGHT_LIGHTRAYBATCH_H)
+#define INC_TOKI_GAME_LIGHT_LIGHTRAYBATCH_H
+
+#include <map>
+#include <vector>
+
+#include <tt/math/Vector2.h>
+#include <tt/platform/tt_types.h>
+
+#include <toki/game/entity/fwd.h>
+#include <toki/game/light/fwd.h>
+#include <toki/level/TileBitmap.h>
+
+
+namespace toki {
+namespace game {
+namespace light {
+
+/*! \brief The rays from all lights to the light detection points of the entities they could light.
+           LightMgr collects them for all lights first and then traces them in one pass over the
+           light-blocking tiles. The rays of one entity share a group, so an entity that is lit by one
+           ray is not traced any further, not even for the other lights. */
+class LightRayBatch
+{
+public:
+	LightRayBatch();
+	
+	void clear();
+	
+	/*! \brief Returns the ray group of p_entity to add the rays of p_light to.
+	    \return -1 if p_light already added rays for p_entity. */
+	s32 startEntity(const entity::EntityHandle& p_entity, const Light* p_light);
+	
+	inline void addRay(const tt::math::Vector2& p_start, const tt::math::Vector2& p_end, s32 p_group)
+	{
+		m_rays.push_back(level::TileBitmap::Ray(p_start, p_end, p_group));
+	}
+	
+	void trace(const level::TileBitmap& p_lightBlockingTiles);
+	
+	/*! \brief Adds the entities that at least one ray reached to p_entities_OUT. Only valid after trace. */
+	void getLitEntities(entity::EntityHandleSet& p_entities_OUT) const;
+	
+	inline s32 getRayCount() const { return static_cast<s32>(m_rays.size()); }
+	
+private:
+	typedef std::map<entity::EntityHandle, s32> Groups;
+	typedef std::vector<const Light*>           GroupLights;
+	
+	// No copying
+	LightRayBatch(const LightRayBatch&);
+	LightRayBatch& operator=(const LightRayBatch&);
+	
+	
+	level::TileBitmap::Rays         m_rays;
+	Groups                          m_groups;
+	entity::EntityHandles           m_groupEntities; // The entity of each group
+	GroupLights                     m_groupLights;   // The last light that added rays to each group
+	level::TileBitmap::GroupResults m_groupResults;
+};
+
+// Namespace end
+}
+}
+}
+
+
+#endif  // !defined(INC_TOKI_GAME_LIGHT_LIGHTRAYBATCH_H)
@@ -21,16 +21,9 @@ namespace light {
 
 inline bool lightHitTest(const tt::math::Point2& p_location)
 {
-	Game* game = AppGlobal::getGame();
-	const level::AttributeLayerPtr& layer = game->getAttributeLayer();
-	
-	if (layer->contains(p_location) == false)
-	{
-		// Don't block light when outside of level.
-		return false;
-	}
-	const level::TileRegistrationMgr& tileRegMgr = game->getTileRegistrationMgr();
-	return tileRegMgr.isLightBlocking(p_location);
+	// Tiles outside of the level are not set in the bitmap; they don't block light.
+	const level::TileRegistrationMgr& tileRegMgr = AppGlobal::getGame()->getTileRegistrationMgr();
+	return tileRegMgr.getLightBlockingTiles().isSet(p_location);
 }
 
 
@@ -57,7 +57,17 @@ public:
 	void setTexture(const std::string& p_textureName);
 	const std::string& getTextureName() const { return m_textureOverride; }
 	
-	void update(real p_elapsedTime, const Polygons& p_occluders, u8 p_centerAlpha);
+	/*! \brief Traces the shape against p_occluders, unless nothing that affects the shape changed since
+	           the previous trace (same position, radius, spread, color and occluder revisions).
+	    \return true if the shape was traced, false if the previous shape was kept. */
+	bool update(real p_elapsedTime, const Polygons& p_occluders, u8 p_centerAlpha);
+	inline void invalidateShape() { m_tracedShapeValid = false; }
+	
+	inline tt::math::VectorRect getBoundingRect() const
+	{
+		const tt::math::Vector2 extent(m_radius, m_radius);
+		return tt::math::VectorRect(m_centerPos - extent, m_centerPos + extent);
+	}
 	
 	inline void renderDebug()
 	{
@@ -73,6 +83,9 @@ public:
 	void unserialize(tt::code::BufferReadContext*  p_context);
 	
 private:
+	typedef std::vector<u32> Revisions;
+	
+	bool updateTracedInputs(const Polygons& p_occluders, u8 p_centerAlpha);
 	void calculateCircle(const Shadows& p_shadows, u8 p_centerAlpha);
 	Shadows::iterator insertRightAngleSorted(Shadows& p_list, const Shadow& p_shadow);
 	Shadows::iterator insertDistanceSorted(Shadows& p_list, const Shadow& p_shadow);
@@ -97,6 +110,16 @@ private:
 	Shadows m_shadowsScratch;
 	BoolVector m_backFacingScratch;
 	
+	// Inputs of the last trace; should not be serialized
+	bool                           m_tracedShapeValid;
+	tt::math::Vector2              m_tracedCenterPos;
+	real                           m_tracedRadius;
+	real                           m_tracedDirection;
+	real                           m_tracedHalfSpread;
+	tt::engine::renderer::ColorRGB m_tracedColor;
+	u8                             m_tracedCenterAlpha;
+	Revisions                      m_tracedOccluders;
+	
 #ifdef USE_DEBUG_SHAPE
 	Circle m_debug;
 #endif
@@ -0,0 +1,75 @@
+#if !defined(INC_TOKI_GAME_LIGHT_OCCLUDERGRID_H)
+#define INC_TOKI_GAME_LIGHT_OCCLUDERGRID_H
+
+#include <vector>
+
+#include <tt/math/Rect.h>
+#include <tt/platform/tt_types.h>
+
+#include <toki/game/light/fwd.h>
+
+
+namespace toki {
+namespace game {
+namespace light {
+
+typedef std::vector<s32> OccluderIndices;
+
+
+/*! \brief Buckets occluder polygons into cells of a fixed number of tiles, laid over the attribute layer,
+           so a light only needs to look at the occluders near it. */
+class OccluderGrid
+{
+public:
+	explicit OccluderGrid(s32 p_cellSize = 8);
+	
+	/*! \brief Replaces the occluders in the grid. p_levelWidth and p_levelHeight are in tiles.
+	           Occluders outside the level end up in the border cells. */
+	void rebuild(const Polygons& p_occluders, s32 p_levelWidth, s32 p_levelHeight);
+	
+	/*! \brief Appends the occluders whose bounds overlap p_rect to p_occluders_OUT, in the order in which
+	           they were passed to rebuild. p_scratch is used for intermediate results and can be reused
+	           between calls (one per thread). */
+	void getOccluders(const tt::math::VectorRect& p_rect, Polygons& p_occluders_OUT,
+	                  OccluderIndices& p_scratch) const;
+	
+	inline s32 getOccluderCount() const { return static_cast<s32>(m_occluders.size()); }
+	
+	static bool overlaps(const tt::math::VectorRect& p_a, const tt::math::VectorRect& p_b);
+	
+private:
+	struct CellRange
+	{
+		s32 minX;
+		s32 minY;
+		s32 maxX;
+		s32 maxY;
+	};
+	typedef std::vector<tt::math::VectorRect> Bounds;
+	typedef std::vector<CellRange>            CellRanges;
+	
+	CellRange getCellRange(const tt::math::VectorRect& p_rect) const;
+	s32 getCell(real p_position, s32 p_cellCount) const;
+	
+	const s32        m_cellSize; // in tiles
+	s32              m_width;    // in cells
+	s32              m_height;   // in cells
+	
+	Polygons         m_occluders;
+	Bounds           m_bounds;
+	CellRanges       m_cellRanges;
+	OccluderIndices  m_cellStart;     // Cell i holds m_cellOccluders[m_cellStart[i]] up to m_cellStart[i + 1]
+	OccluderIndices  m_cellOccluders;
+	
+	OccluderGrid(const OccluderGrid&);                  // Disable copy
+	const OccluderGrid& operator=(const OccluderGrid&); // Disable assigment.
+};
+
+
+// Namespace end
+}
+}
+}
+
+
+#endif  // !defined(INC_TOKI_GAME_LIGHT_OCCLUDERGRID_H)
@@ -1,8 +1,11 @@
 #if !defined(INC_TESTS_SHADOW_POLYGON_H)
 #define INC_TESTS_SHADOW_POLYGON_H
 
+#include <atomic>
+
 #include <tt/engine/renderer/ColorRGBA.h>
 #include <tt/engine/renderer/fwd.h>
+#include <tt/math/Rect.h>
 #include <tt/math/Vector2.h>
 
 #include <toki/game/light/fwd.h>
@@ -35,6 +38,11 @@ public:
 	
 	inline tt::math::Vector2 getBoundingSphereMidPoint() const { return m_boundingSphereMidPoint + m_pos; }
 	inline real getBoundingSphereRadius() const                { return m_boundingSphereRadius; }
+	inline tt::math::VectorRect getWorldRect() const { return tt::math::VectorRect(m_min + m_pos, m_max + m_pos); }
+	
+	/*! \brief Changes whenever the world space vertices change. Unique for all polygons, so two equal
+	           revisions mean the same polygon with the same shape. */
+	inline u32 getRevision() const { return m_revision; }
 	
 	inline void setPosition(const tt::math::Vector2 p_pos)
 	{
@@ -70,6 +78,12 @@ private:
 	
 	tt::math::Vector2 m_boundingSphereMidPoint;
 	real              m_boundingSphereRadius;
+	tt::math::Vector2 m_min; // Model space bounds
+	tt::math::Vector2 m_max;
+	u32               m_revision;
+	
+	// Atomic so revisions stay unique when polygons are built outside the main thread
+	static std::atomic<u32> ms_lastRevision;
 	
 #ifndef TT_BUILD_FINAL
 	Circle m_debug;
@@ -31,6 +31,8 @@ typedef tt::code::Handle<Light> LightHandle;
 class LightMgr;
 typedef tt_ptr<LightMgr>::shared LightMgrPtr;
 
+class LightRayBatch;
+
 class Darkness;
 typedef tt::code::Handle<Darkness> DarknessHandle;
 
@@ -7,6 +7,7 @@
 #include <tt/script/VirtualMachine.h>
 
 #include <toki/game/script/EntityBase.h> // Make sure SqBind<EntityBase> is resolved correctly.
+#include <toki/game/script/EntityCallback.h>
 #include <toki/game/script/fwd.h>
 #include <toki/script/serialization/fwd.h>
 
@@ -18,6 +19,9 @@ class Callback
 {
 public:
 	Callback(HSQUIRRELVM p_vm, const HSQOBJECT& p_state, const std::string& p_name);
+	
+	/*! \brief Callback of which the closure was already looked up in the state. (See EntityState::getCallback.) */
+	Callback(HSQUIRRELVM p_vm, const HSQOBJECT& p_state, EntityCallback p_callback, const HSQOBJECT& p_closure);
 	~Callback();
 	
 	template <typename Type>
@@ -44,6 +48,11 @@ public:
 	
 	bool execute(const HSQOBJECT& p_instance) const;
 	
+	/*! \return The EntityCallback or EntityCallback_Invalid if this callback was created with a name. */
+	inline EntityCallback getCallback() const { return m_callback; }
+	/*! \return The name this callback was created with. Empty if it was created with an EntityCallback. */
+	inline const std::string& getName() const { return m_name; }
+	
 	void addObjectToSQSerializer(toki::script::serialization::SQSerializer& p_serializer) const;
 	
 	void serialize(const toki::script::serialization::SQSerializer& p_serializer,
@@ -53,9 +62,16 @@ public:
 	                               tt::code::BufferReadContext*                       p_context);
 	
 private:
+	inline const char* getFunctionName() const
+	{
+		return isValidEntityCallback(m_callback) ? getEntityCallbackName(m_callback) : m_name.c_str();
+	}
+	
 	HSQUIRRELVM m_vm;
 	HSQOBJECT m_state;
-	std::string m_name;
+	std::string m_name;     // Only set if m_callback is invalid
+	EntityCallback m_callback;
+	HSQOBJECT m_closure;    // Not referenced; kept alive by m_state.
 	
 	typedef std::vector<HSQOBJECT> Parameters;
 	Parameters m_parameters;
@@ -59,7 +59,7 @@ public:
 	           NOTE: onInit is non-deferred, i.e., it will be called immediately after entity is initialized */
 	inline void onInit()
 	{
-		callSqFun("onInit"); 
+		callSqFun(EntityCallback_OnInit);
 	}
 	
 	/*! \brief Called when this entity dies.
@@ -69,7 +69,7 @@ public:
 	/*! \brief Called when the entity is spawned. */
 	inline void onSpawn()
 	{
-		queueSqFun("onSpawn");
+		queueSqFun(EntityCallback_OnSpawn);
 		
 		// Update so the callbacks deferred in onInit, onSpawn and possible enterState are flushed.
 		updateCallbacks();
@@ -82,10 +82,10 @@ public:
 	void onVibration(const toki::game::event::Event& p_event) const;
 	
 	/*! \brief Called when the entity enters light. */
-	inline void onLightEnter() const { queueSqFun("onLightEnter"); }
+	inline void onLightEnter() const { queueSqFun(EntityCallback_OnLightEnter); }
 	
 	/*! \brief Called when the entity exits light. */
-	inline void onLightExit() const { queueSqFun("onLightExit"); }
+	inline void onLightExit() const { queueSqFun(EntityCallback_OnLightExit); }
 	
 	/*! \brief Called on Event source when event is spawned through spawnEventEx.
 	    \param p_event the even that was spawned.
@@ -96,134 +96,134 @@ public:
 	
 	
 	/*! \brief Called when tile sensor is touching solid tiles. */
-	inline void onTileSensorSolidTouchEnter(const entity::sensor::TileSensorHandle& p_tileSensor) const    { queueSqFun("onTileSensorSolidTouchEnter", wrappers::TileSensorWrapper(p_tileSensor)); }
+	inline void onTileSensorSolidTouchEnter(const entity::sensor::TileSensorHandle& p_tileSensor) const    { queueSqFun(EntityCallback_OnTileSensorSolidTouchEnter, wrappers::TileSensorWrapper(p_tileSensor)); }
 	
 	/*! \brief Called when tile sensor is no longer touching solid tiles. */
-	inline void onTileSensorSolidTouchExit(const entity::sensor::TileSensorHandle& p_tileSensor)  const    { queueSqFun("onTileSensorSolidTouchExit", wrappers::TileSensorWrapper(p_tileSensor)); }
+	inline void onTileSensorSolidTouchExit(const entity::sensor::TileSensorHandle& p_tileSensor)  const    { queueSqFun(EntityCallback_OnTileSensorSolidTouchExit, wrappers::TileSensorWrapper(p_tileSensor)); }
 	
 	/*! \brief Called when tile sensor is touching water tiles. */
-	inline void onTileSensorWaterTouchEnter(const entity::sensor::TileSensorHandle& p_tileSensor) const      { queueSqFun("onTileSensorWaterTouchEnter", wrappers::TileSensorWrapper(p_tileSensor)); }
+	inline void onTileSensorWaterTouchEnter(const entity::sensor::TileSensorHandle& p_tileSensor) const      { queueSqFun(EntityCallback_OnTileSensorWaterTouchEnter, wrappers::TileSensorWrapper(p_tileSensor)); }
 	
 	/*! \brief Called when tile sensor is no longer touching water tiles. */
-	inline void onTileSensorWaterTouchExit(const entity::sensor::TileSensorHandle& p_tileSensor) const       { queueSqFun("onTileSensorWaterTouchExit", wrappers::TileSensorWrapper(p_tileSensor)); }
+	inline void onTileSensorWaterTouchExit(const entity::sensor::TileSensorHandle& p_tileSensor) const       { queueSqFun(EntityCallback_OnTileSensorWaterTouchExit, wrappers::TileSensorWrapper(p_tileSensor)); }
 	
 	/*! \brief Called when tile sensor is touching waterfall water tiles. */
-	inline void onTileSensorWaterfallTouchEnter(const entity::sensor::TileSensorHandle& p_tileSensor) const  { queueSqFun("onTileSensorWaterfallTouchEnter", wrappers::TileSensorWrapper(p_tileSensor)); }
+	inline void onTileSensorWaterfallTouchEnter(const entity::sensor::TileSensorHandle& p_tileSensor) const  { queueSqFun(EntityCallback_OnTileSensorWaterfallTouchEnter, wrappers::TileSensorWrapper(p_tileSensor)); }
 	
 	/*! \brief Called when tile sensor is no longer touching waterfall water tiles. */
-	inline void onTileSensorWaterfallTouchExit(const entity::sensor::TileSensorHandle& p_tileSensor) const   { queueSqFun("onTileSensorWaterfallTouchExit", wrappers::TileSensorWrapper(p_tileSensor)); }
+	inline void onTileSensorWaterfallTouchExit(const entity::sensor::TileSensorHandle& p_tileSensor) const   { queueSqFun(EntityCallback_OnTileSensorWaterfallTouchExit, wrappers::TileSensorWrapper(p_tileSensor)); }
 	
 	/*! \brief Called when tile sensor is touching lava tiles. */
-	inline void onTileSensorLavaTouchEnter(const entity::sensor::TileSensorHandle& p_tileSensor) const { queueSqFun("onTileSensorLavaTouchEnter", wrappers::TileSensorWrapper(p_tileSensor)); }
+	inline void onTileSensorLavaTouchEnter(const entity::sensor::TileSensorHandle& p_tileSensor) const { queueSqFun(EntityCallback_OnTileSensorLavaTouchEnter, wrappers::TileSensorWrapper(p_tileSensor)); }
 	
 	/*! \brief Called when tile sensor is no longer touching lava tiles. */
-	inline void onTileSensorLavaTouchExit(const entity::sensor::TileSensorHandle& p_tileSensor) const { queueSqFun("onTileSensorLavaTouchExit", wrappers::TileSensorWrapper(p_tileSensor)); }
+	inline void onTileSensorLavaTouchExit(const entity::sensor::TileSensorHandle& p_tileSensor) const { queueSqFun(EntityCallback_OnTileSensorLavaTouchExit, wrappers::TileSensorWrapper(p_tileSensor)); }
 	
 	/*! \brief Called when tile sensor is touching waterfall lava tiles. */
-	inline void onTileSensorLavafallTouchEnter(const entity::sensor::TileSensorHandle& p_tileSensor) const { queueSqFun("onTileSensorLavafallTouchEnter", wrappers::TileSensorWrapper(p_tileSensor)); }
+	inline void onTileSensorLavafallTouchEnter(const entity::sensor::TileSensorHandle& p_tileSensor) const { queueSqFun(EntityCallback_OnTileSensorLavafallTouchEnter, wrappers::TileSensorWrapper(p_tileSensor)); }
 	
 	/*! \brief Called when tile sensor is no longer touching waterfall lava tiles. */
-	inline void onTileSensorLavafallTouchExit(const entity::sensor::TileSensorHandle& p_tileSensor) const { queueSqFun("onTileSensorLavafallTouchExit", wrappers::TileSensorWrapper(p_tileSensor)); }
+	inline void onTileSensorLavafallTouchExit(const entity::sensor::TileSensorHandle& p_tileSensor) const { queueSqFun(EntityCallback_OnTileSensorLavafallTouchExit, wrappers::TileSensorWrapper(p_tileSensor)); }
 	
 	/*! \brief Called when touching water tiles. */
-	inline void onWaterTouchEnter() const      { queueSqFun("onWaterTouchEnter");        }
+	inline void onWaterTouchEnter() const      { queueSqFun(EntityCallback_OnWaterTouchEnter); }
 	
 	/*! \brief Called when no longer touching water tiles. */
-	inline void onWaterTouchExit() const       { queueSqFun("onWaterTouchExit");         }
+	inline void onWaterTouchExit() const       { queueSqFun(EntityCallback_OnWaterTouchExit); }
 	
 	/*! \brief Called when completely inside water tiles. */
-	inline void onWaterEnclosedEnter() const   { queueSqFun("onWaterEnclosedEnter");     }
+	inline void onWaterEnclosedEnter() const   { queueSqFun(EntityCallback_OnWaterEnclosedEnter); }
 	
 	/*! \brief Called when no longer completely inside water tiles. */
-	inline void onWaterEnclosedExit() const    { queueSqFun("onWaterEnclosedExit");      }
+	inline void onWaterEnclosedExit() const    { queueSqFun(EntityCallback_OnWaterEnclosedExit); }
 	
 	/*! \brief Called when touching waterfall water tiles. */
-	inline void onWaterfallTouchEnter() const  { queueSqFun("onWaterfallTouchEnter");    }
+	inline void onWaterfallTouchEnter() const  { queueSqFun(EntityCallback_OnWaterfallTouchEnter); }
 	
 	/*! \brief Called when no longer touching waterfall water tiles. */
-	inline void onWaterfallTouchExit() const   { queueSqFun("onWaterfallTouchExit");     }
+	inline void onWaterfallTouchExit() const   { queueSqFun(EntityCallback_OnWaterfallTouchExit); }
 	
 	/*! \brief Called when completely inside waterfall water tiles. */
-	inline void onWaterfallEnclosedEnter() const { queueSqFun("onWaterfallEnclosedEnter"); }
+	inline void onWaterfallEnclosedEnter() const { queueSqFun(EntityCallback_OnWaterfallEnclosedEnter); }
 	
 	/*! \brief Called when no longer completely inside waterfall water tiles. */
-	inline void onWaterfallEnclosedExit() const { queueSqFun("onWaterfallEnclosedExit");  }
+	inline void onWaterfallEnclosedExit() const { queueSqFun(EntityCallback_OnWaterfallEnclosedExit); }
 	
 	/*! \brief Called when touching lava tiles. */
-	inline void onLavaTouchEnter() const { queueSqFun("onLavaTouchEnter");         }
+	inline void onLavaTouchEnter() const { queueSqFun(EntityCallback_OnLavaTouchEnter); }
 	
 	/*! \brief Called when no longer touching lava tiles. */
-	inline void onLavaTouchExit() const { queueSqFun("onLavaTouchExit");          }
+	inline void onLavaTouchExit() const { queueSqFun(EntityCallback_OnLavaTouchExit); }
 	
 	/*! \brief Called when completely inside lava tiles. */
-	inline void onLavaEnclosedEnter() const { queueSqFun("onLavaEnclosedEnter");      }
+	inline void onLavaEnclosedEnter() const { queueSqFun(EntityCallback_OnLavaEnclosedEnter); }
 	
 	/*! \brief Called when no longer completely inside lava tiles. */
-	inline void onLavaEnclosedExit() const { queueSqFun("onLavaEnclosedExit");       }
+	inline void onLavaEnclosedExit() const { queueSqFun(EntityCallback_OnLavaEnclosedExit); }
 	
 	/*! \brief Called when touching waterfall lava tiles. */
-	inline void onLavafallTouchEnter() const { queueSqFun("onLavafallTouchEnter");     }
+	inline void onLavafallTouchEnter() const { queueSqFun(EntityCallback_OnLavafallTouchEnter); }
 	
 	/*! \brief Called when no longer touching waterfall lava tiles. */
-	inline void onLavafallTouchExit() const { queueSqFun("onLavafallTouchExit");      }
+	inline void onLavafallTouchExit() const { queueSqFun(EntityCallback_OnLavafallTouchExit); }
 	
 	/*! \brief Called when completely inside waterfall lava tiles. */
-	inline void onLavafallEnclosedEnter() const { queueSqFun("onLavafallEnclosedEnter");  }
+	inline void onLavafallEnclosedEnter() const { queueSqFun(EntityCallback_OnLavafallEnclosedEnter); }
 	
 	/*! \brief Called when no longer completely inside waterfall lava tiles. */
-	inline void onLavafallEnclosedExit() const { queueSqFun("onLavafallEnclosedExit");   }
+	inline void onLavafallEnclosedExit() const { queueSqFun(EntityCallback_OnLavafallEnclosedExit); }
 	
 	/*! \brief Called when a timer with the specified name is triggered.
 	    \param p_name Name of the timer that was triggered (was specified in startTimer). */
-	inline void onTimer(const std::string& p_name) const { callSqFun("onTimer", p_name);   }
+	inline void onTimer(const std::string& p_name) const { callSqFun(EntityCallback_OnTimer, p_name); }
 	
 	/*! \brief Called when this entity's movement has completed.
 	    \param p_direction The direction in which the entity was moving. */
-	inline void onMovementEnded( movement::Direction p_direction) { queueSqFun("onMovementEnded",  p_direction); }
+	inline void onMovementEnded( movement::Direction p_direction) { queueSqFun(EntityCallback_OnMovementEnded,  p_direction); }
 	
 	/*! \brief Called when this entity's movement could not be completed.
 	    \param p_direction The direction in which the entity was moving.
 	    \param p_moveName The name of the move that failed.*/
-	inline void onMovementFailed(movement::Direction p_direction, const std::string& p_moveName) { queueSqFun("onMovementFailed", p_direction, p_moveName); }
+	inline void onMovementFailed(movement::Direction p_direction, const std::string& p_moveName) { queueSqFun(EntityCallback_OnMovementFailed, p_direction, p_moveName); }
 	
 	/*! \brief Called when this entity's path movement couldn't find a path.
 	    \param p_closestPoint is the closest point to which which it could move with a path. */
-	inline void onPathMovementFailed(const tt::math::Vector2& p_closestPoint) { queueSqFun("onPathMovementFailed", p_closestPoint); }
+	inline void onPathMovementFailed(const tt::math::Vector2& p_closestPoint) { queueSqFun(EntityCallback_OnPathMovementFailed, p_closestPoint); }
 	
 	/*! \brief Called when this entity hits solid collision (e.g., a wall)
 	    \param p_collisionNormal is the normal of the collision.
 	    \param p_speed is the impact speed. */
 	inline void onSolidCollision(const tt::math::Vector2& p_collisionNormal, const tt::math::Vector2& p_speed)
 	{
-		queueSqFun("onSolidCollision", p_collisionNormal, p_speed);
+		queueSqFun(EntityCallback_OnSolidCollision, p_collisionNormal, p_speed);
 	}
 	
 	/*! \brief Called when this entity's physics movement controller turned it. */
-	inline void onPhysicsTurn() { queueSqFun("onPhysicsTurn"); }
+	inline void onPhysicsTurn() { queueSqFun(EntityCallback_OnPhysicsTurn); }
 	
 	/*! \brief Called when entering the current state. */
-	inline void onEnterState() { queueSqFun("onEnterState"); }
+	inline void onEnterState() { queueSqFun(EntityCallback_OnEnterState); }
 	
 	/*! \brief Called when exiting the current state. */
-	inline void onExitState() { queueSqFun("onExitState"); }
+	inline void onExitState() { queueSqFun(EntityCallback_OnExitState); }
 	
 	/*! \brief Called when a pointer input device presses on this entity. */
 	inline void onPointerPressed(const wrappers::PointerEventWrapper& p_event) const
 	{
-		queueSqFun("onPointerPressed", p_event);
+		queueSqFun(EntityCallback_OnPointerPressed, p_event);
 	}
 	
 	/*! \brief Called when a pointer input device press is released on this entity. */
 	inline void onPointerReleased(const wrappers::PointerEventWrapper& p_event) const
 	{
-		queueSqFun("onPointerReleased", p_event);
+		queueSqFun(EntityCallback_OnPointerReleased, p_event);
 	}
 	
 	/*! \brief Called when input direction is changed.
 	    \note This is the input direction unrelated to the movement direction in the movement controller.*/
 	inline void onDirectionChanged(movement::Direction p_direction)
 	{
-		queueSqFun("onDirectionChanged", p_direction);
+		queueSqFun(EntityCallback_OnDirectionChanged, p_direction);
 	}
 	
 	/*! \brief Called when the down button is pressed on an input device. */
@@ -543,7 +543,7 @@ public:
 	inline void onPresentationObjectEnded(const wrappers::PresentationObjectWrapper& p_pres,
 	                                      const std::string& p_name) const
 	{
-		queueSqFun("onPresentationObjectEnded", p_pres, p_name);
+		queueSqFun(EntityCallback_OnPresentationObjectEnded, p_pres, p_name);
 	}
 	
 	/*! \brief Called when a presentation object was canceled.
@@ -554,7 +554,7 @@ public:
 	inline void onPresentationObjectCanceled(const wrappers::PresentationObjectWrapper& p_pres,
 	                                         const std::string& p_name) const
 	{
-		queueSqFun("onPresentationObjectCanceled", p_pres, p_name);
+		queueSqFun(EntityCallback_OnPresentationObjectCanceled, p_pres, p_name);
 	}
 	
 	/*! \brief Called when a presentation object triggers a callback
@@ -563,7 +563,7 @@ public:
 	inline void onPresentationObjectCallback(const wrappers::PresentationObjectWrapper& p_pres,
 	                                         const std::string& p_data) const
 	{
-		queueSqFun("onPresentationObjectCallback", p_pres, p_data);
+		queueSqFun(EntityCallback_OnPresentationObjectCallback, p_pres, p_data);
 	}
 	
 	/*! \brief Called when this entity is being carried (via carry movement) by another entity.
@@ -649,45 +649,109 @@ public:
 	
 	inline void callSqFun(const std::string& p_function) const
 	{
+		ScopedCallbackTiming timing(*ms_mgr, p_function);
 		ms_mgr->getVM()->callSqMemberFun(p_function, getSqState(), m_instance);
 	}
 	
 	template <typename P1Type>
 	inline void callSqFun(const std::string& p_function, const P1Type& p_arg) const
 	{
+		ScopedCallbackTiming timing(*ms_mgr, p_function);
 		ms_mgr->getVM()->callSqMemberFun(p_function, getSqState(), m_instance, p_arg);
 	}
 	
 	template <typename P1Type, typename P2Type>
 	inline void callSqFun(const std::string& p_function, const P1Type* p_arg, const P2Type& p_arg2) const
 	{
+		ScopedCallbackTiming timing(*ms_mgr, p_function);
 		ms_mgr->getVM()->callSqMemberFun(p_function, getSqState(), m_instance, p_arg, p_arg2);
 	}
 	
 	template <typename P1Type, typename P2Type>
 	inline void callSqFun(const std::string& p_function, const P1Type& p_arg, const P2Type& p_arg2) const
 	{
+		ScopedCallbackTiming timing(*ms_mgr, p_function);
 		ms_mgr->getVM()->callSqMemberFun(p_function, getSqState(), m_instance, p_arg, p_arg2);
 	}
 	
 	template <typename RetType>
 	inline void callSqFunWithReturn(RetType* p_returnValue_OUT, const std::string& p_function) const
 	{
+		ScopedCallbackTiming timing(*ms_mgr, p_function);
 		ms_mgr->getVM()->callSqMemberFunWithReturn(p_returnValue_OUT, p_function, getSqState(), m_instance);
 	}
 	
 	template <typename RetType, typename P1Type>
 	inline void callSqFunWithReturn(RetType* p_returnValue_OUT, const std::string& p_function, const P1Type* p_arg) const
 	{
+		ScopedCallbackTiming timing(*ms_mgr, p_function);
 		ms_mgr->getVM()->callSqMemberFunWithReturn(p_returnValue_OUT, p_function, getSqState(), m_instance, p_arg);
 	}
 	
 	template <typename RetType, typename P1Type>
 	inline void callSqFunWithReturn(RetType* p_returnValue_OUT, const std::string& p_function, const P1Type& p_arg) const
 	{
+		ScopedCallbackTiming timing(*ms_mgr, p_function);
 		ms_mgr->getVM()->callSqMemberFunWithReturn(p_returnValue_OUT, p_function, getSqState(), m_instance, p_arg);
 	}
 	
+	// Callbacks of which the closure was already looked up in the current state (see EntityState::getCallback)
+	inline void queueSqFun(EntityCallback p_callback) const
+	{
+		CallbackPtr ptr(createCallback(p_callback));
+		if (ptr != 0)
+		{
+			m_callbacks.push_back(ptr);
+			ms_mgr->registerForCallbacksUpdate(m_this.lock());
+		}
+	}
+	
+	template <typename P1Type>
+	inline void queueSqFun(EntityCallback p_callback, const P1Type& p_arg) const
+	{
+		CallbackPtr ptr(createCallback(p_callback));
+		if (ptr != 0)
+		{
+			ptr->addParameter(p_arg);
+			m_callbacks.push_back(ptr);
+			ms_mgr->registerForCallbacksUpdate(m_this.lock());
+		}
+	}
+	
+	template <typename P1Type, typename P2Type>
+	inline void queueSqFun(EntityCallback p_callback, const P1Type& p_arg1, const P2Type& p_arg2) const
+	{
+		CallbackPtr ptr(createCallback(p_callback));
+		if (ptr != 0)
+		{
+			ptr->addParameter(p_arg1);
+			ptr->addParameter(p_arg2);
+			m_callbacks.push_back(ptr);
+			ms_mgr->registerForCallbacksUpdate(m_this.lock());
+		}
+	}
+	
+	inline void callSqFun(EntityCallback p_callback) const
+	{
+		const HSQOBJECT& closure(m_currentState.getCallback(p_callback));
+		if (sq_isnull(closure) == false)
+		{
+			ScopedCallbackTiming timing(*ms_mgr, p_callback);
+			ms_mgr->getVM()->callSqClosure(getEntityCallbackName(p_callback), closure, m_instance);
+		}
+	}
+	
+	template <typename P1Type>
+	inline void callSqFun(EntityCallback p_callback, const P1Type& p_arg) const
+	{
+		const HSQOBJECT& closure(m_currentState.getCallback(p_callback));
+		if (sq_isnull(closure) == false)
+		{
+			ScopedCallbackTiming timing(*ms_mgr, p_callback);
+			ms_mgr->getVM()->callSqClosure(getEntityCallbackName(p_callback), closure, m_instance, p_arg);
+		}
+	}
+	
 	void removeCallbacks();
 	
 	void addObjectToSQSerializer(toki::script::serialization::SQSerializer& p_serializer) const;
@@ -754,6 +818,31 @@ private:
 		ms_mgr->registerForCallbacksUpdate(m_this.lock());
 	}
 	
+	template <typename P1Type, typename P2Type, typename P3Type>
+	inline void queueSqFun(EntityCallback p_callback, const P1Type& p_arg1, const P2Type& p_arg2, const P3Type& p_arg3) const
+	{
+		CallbackPtr ptr(createCallback(p_callback));
+		if (ptr != 0)
+		{
+			ptr->addParameter(p_arg1);
+			ptr->addParameter(p_arg2);
+			ptr->addParameter(p_arg3);
+			m_callbacks.push_back(ptr);
+			ms_mgr->registerForCallbacksUpdate(m_this.lock());
+		}
+	}
+	
+	/*! \return The callback in the current state, or null if the current state doesn't have it. */
+	inline CallbackPtr createCallback(EntityCallback p_callback) const
+	{
+		const HSQOBJECT& closure(m_currentState.getCallback(p_callback));
+		if (sq_isnull(closure))
+		{
+			return CallbackPtr();
+		}
+		return std::make_shared<Callback>(ms_mgr->getVM()->getVM(), m_currentState.getSqState(), p_callback, closure);
+	}
+	
 	const EntityBase& operator=(const EntityBase&); // no assignment allowed
 	
 	
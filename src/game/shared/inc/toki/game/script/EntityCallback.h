@@ -0,0 +1,164 @@
+#if !defined(INC_TOKI_GAME_SCRIPT_ENTITYCALLBACK_H)
+#define INC_TOKI_GAME_SCRIPT_ENTITYCALLBACK_H
+
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace toki {
+namespace game {
+namespace script {
+
+/*! \brief The callbacks the code calls on every entity with a fixed name.
+    EntityScriptClass looks these up in every state when the class is created, so EntityBase can
+    call them without looking up the name. Callbacks with names from script (sensor callbacks,
+    callback timers, move callbacks, etc.) are still looked up by name. */
+enum EntityCallback
+{
+	EntityCallback_OnCreate,
+	EntityCallback_OnInit,
+	EntityCallback_OnSpawn,
+	EntityCallback_OnDie,
+	EntityCallback_Update,
+	EntityCallback_OnEnterState,
+	EntityCallback_OnExitState,
+	EntityCallback_OnTimer,
+	EntityCallback_OnSound,
+	EntityCallback_OnVibration,
+	EntityCallback_OnEventSpawned,
+	EntityCallback_OnLightEnter,
+	EntityCallback_OnLightExit,
+	EntityCallback_OnScreenEnter,
+	EntityCallback_OnScreenExit,
+	EntityCallback_OnCulled,
+	EntityCallback_OnUnculled,
+	EntityCallback_OnTileSensorSolidTouchEnter,
+	EntityCallback_OnTileSensorSolidTouchExit,
+	EntityCallback_OnTileSensorWaterTouchEnter,
+	EntityCallback_OnTileSensorWaterTouchExit,
+	EntityCallback_OnTileSensorWaterfallTouchEnter,
+	EntityCallback_OnTileSensorWaterfallTouchExit,
+	EntityCallback_OnTileSensorLavaTouchEnter,
+	EntityCallback_OnTileSensorLavaTouchExit,
+	EntityCallback_OnTileSensorLavafallTouchEnter,
+	EntityCallback_OnTileSensorLavafallTouchExit,
+	EntityCallback_OnWaterTouchEnter,
+	EntityCallback_OnWaterTouchExit,
+	EntityCallback_OnWaterEnclosedEnter,
+	EntityCallback_OnWaterEnclosedExit,
+	EntityCallback_OnWaterfallTouchEnter,
+	EntityCallback_OnWaterfallTouchExit,
+	EntityCallback_OnWaterfallEnclosedEnter,
+	EntityCallback_OnWaterfallEnclosedExit,
+	EntityCallback_OnLavaTouchEnter,
+	EntityCallback_OnLavaTouchExit,
+	EntityCallback_OnLavaEnclosedEnter,
+	EntityCallback_OnLavaEnclosedExit,
+	EntityCallback_OnLavafallTouchEnter,
+	EntityCallback_OnLavafallTouchExit,
+	EntityCallback_OnLavafallEnclosedEnter,
+	EntityCallback_OnLavafallEnclosedExit,
+	EntityCallback_OnMovementEnded,
+	EntityCallback_OnMovementFailed,
+	EntityCallback_OnPathMovementFailed,
+	EntityCallback_OnSolidCollision,
+	EntityCallback_OnPhysicsTurn,
+	EntityCallback_OnTurnStarted,
+	EntityCallback_OnTurnEnded,
+	EntityCallback_OnDirectionChanged,
+	EntityCallback_OnPointerPressed,
+	EntityCallback_OnPointerReleased,
+	EntityCallback_OnCarryBegin,
+	EntityCallback_OnCarryEnd,
+	EntityCallback_OnPresentationObjectEnded,
+	EntityCallback_OnPresentationObjectCanceled,
+	EntityCallback_OnPresentationObjectCallback,
+	
+	EntityCallback_Count,
+	EntityCallback_Invalid
+};
+
+
+inline bool isValidEntityCallback(EntityCallback p_callback)
+{
+	return p_callback >= 0 && p_callback < EntityCallback_Count;
+}
+
+
+/*! \brief Retrieves the name of the callback function in script. */
+inline const char* getEntityCallbackName(EntityCallback p_callback)
+{
+	switch (p_callback)
+	{
+	case EntityCallback_OnCreate:                        return "onCreate";
+	case EntityCallback_OnInit:                          return "onInit";
+	case EntityCallback_OnSpawn:                         return "onSpawn";
+	case EntityCallback_OnDie:                           return "onDie";
+	case EntityCallback_Update:                          return "update";
+	case EntityCallback_OnEnterState:                    return "onEnterState";
+	case EntityCallback_OnExitState:                     return "onExitState";
+	case EntityCallback_OnTimer:                         return "onTimer";
+	case EntityCallback_OnSound:                         return "onSound";
+	case EntityCallback_OnVibration:                     return "onVibration";
+	case EntityCallback_OnEventSpawned:                  return "onEventSpawned";
+	case EntityCallback_OnLightEnter:                    return "onLightEnter";
+	case EntityCallback_OnLightExit:                     return "onLightExit";
+	case EntityCallback_OnScreenEnter:                   return "onScreenEnter";
+	case EntityCallback_OnScreenExit:                    return "onScreenExit";
+	case EntityCallback_OnCulled:                        return "onCulled";
+	case EntityCallback_OnUnculled:                      return "onUnculled";
+	case EntityCallback_OnTileSensorSolidTouchEnter:     return "onTileSensorSolidTouchEnter";
+	case EntityCallback_OnTileSensorSolidTouchExit:      return "onTileSensorSolidTouchExit";
+	case EntityCallback_OnTileSensorWaterTouchEnter:     return "onTileSensorWaterTouchEnter";
+	case EntityCallback_OnTileSensorWaterTouchExit:      return "onTileSensorWaterTouchExit";
+	case EntityCallback_OnTileSensorWaterfallTouchEnter: return "onTileSensorWaterfallTouchEnter";
+	case EntityCallback_OnTileSensorWaterfallTouchExit:  return "onTileSensorWaterfallTouchExit";
+	case EntityCallback_OnTileSensorLavaTouchEnter:      return "onTileSensorLavaTouchEnter";
+	case EntityCallback_OnTileSensorLavaTouchExit:       return "onTileSensorLavaTouchExit";
+	case EntityCallback_OnTileSensorLavafallTouchEnter:  return "onTileSensorLavafallTouchEnter";
+	case EntityCallback_OnTileSensorLavafallTouchExit:   return "onTileSensorLavafallTouchExit";
+	case EntityCallback_OnWaterTouchEnter:               return "onWaterTouchEnter";
+	case EntityCallback_OnWaterTouchExit:                return "onWaterTouchExit";
+	case EntityCallback_OnWaterEnclosedEnter:            return "onWaterEnclosedEnter";
+	case EntityCallback_OnWaterEnclosedExit:             return "onWaterEnclosedExit";
+	case EntityCallback_OnWaterfallTouchEnter:           return "onWaterfallTouchEnter";
+	case EntityCallback_OnWaterfallTouchExit:            return "onWaterfallTouchExit";
+	case EntityCallback_OnWaterfallEnclosedEnter:        return "onWaterfallEnclosedEnter";
+	case EntityCallback_OnWaterfallEnclosedExit:         return "onWaterfallEnclosedExit";
+	case EntityCallback_OnLavaTouchEnter:                return "onLavaTouchEnter";
+	case EntityCallback_OnLavaTouchExit:                 return "onLavaTouchExit";
+	case EntityCallback_OnLavaEnclosedEnter:             return "onLavaEnclosedEnter";
+	case EntityCallback_OnLavaEnclosedExit:              return "onLavaEnclosedExit";
+	case EntityCallback_OnLavafallTouchEnter:            return "onLavafallTouchEnter";
+	case EntityCallback_OnLavafallTouchExit:             return "onLavafallTouchExit";
+	case EntityCallback_OnLavafallEnclosedEnter:         return "onLavafallEnclosedEnter";
+	case EntityCallback_OnLavafallEnclosedExit:          return "onLavafallEnclosedExit";
+	case EntityCallback_OnMovementEnded:                 return "onMovementEnded";
+	case EntityCallback_OnMovementFailed:                return "onMovementFailed";
+	case EntityCallback_OnPathMovementFailed:            return "onPathMovementFailed";
+	case EntityCallback_OnSolidCollision:                return "onSolidCollision";
+	case EntityCallback_OnPhysicsTurn:                   return "onPhysicsTurn";
+	case EntityCallback_OnTurnStarted:                   return "onTurnStarted";
+	case EntityCallback_OnTurnEnded:                     return "onTurnEnded";
+	case EntityCallback_OnDirectionChanged:              return "onDirectionChanged";
+	case EntityCallback_OnPointerPressed:                return "onPointerPressed";
+	case EntityCallback_OnPointerReleased:               return "onPointerReleased";
+	case EntityCallback_OnCarryBegin:                    return "onCarryBegin";
+	case EntityCallback_OnCarryEnd:                      return "onCarryEnd";
+	case EntityCallback_OnPresentationObjectEnded:       return "onPresentationObjectEnded";
+	case EntityCallback_OnPresentationObjectCanceled:    return "onPresentationObjectCanceled";
+	case EntityCallback_OnPresentationObjectCallback:    return "onPresentationObjectCallback";
+	default:
+		TT_PANIC("Invalid entity callback: %d", p_callback);
+		return "";
+	}
+}
+
+
+// Namespace end
+}
+}
+}
+
+
+#endif  // !defined(INC_TOKI_GAME_SCRIPT_ENTITYCALLBACK_H)
@@ -1,10 +1,15 @@
 #if !defined(INC_TOKI_GAME_SCRIPT_ENTITYSCRIPTMGR_H)
 #define INC_TOKI_GAME_SCRIPT_ENTITYSCRIPTMGR_H
 
+#include <map>
+#include <string>
+
 #include <tt/code/fwd.h>
 #include <tt/script/VirtualMachine.h>
+#include <tt/system/Time.h>
 
 #include <toki/game/entity/fwd.h>
+#include <toki/game/script/EntityCallback.h>
 #include <toki/game/script/fwd.h>
 #include <toki/game/script/TimerMgr.h>
 #include <toki/game/movement/fwd.h>
@@ -53,7 +58,16 @@ public:
 	
 	void serialize  (tt::code::BufferWriteContext* p_context) const;
 	void unserialize(tt::code::BufferReadContext*  p_context);
+
+#if !defined(TT_BUILD_FINAL)
+	/*! \brief Adds a call of an entity callback to the timings of the current update. */
+	void addCallbackTiming(EntityCallback p_callback, u64 p_duration);
+	void addCallbackTiming(const std::string& p_name, u64 p_duration);
 	
+	/*! \return Calls and time per callback name, averaged over the last updates. */
+	std::string getDebugCallbackTimings() const;
+#endif
+
 private:
 	typedef std::map<std::string, entity::EntityHandles> TaggedEntities;
 	typedef std::map<entity::EntityHandle, EntityBaseWeakPtr> EntityBaseWeakPtrs;
@@ -73,6 +87,79 @@ private:
 	
 	tt::script::VirtualMachinePtr m_vm;
 	ScriptClasses m_scriptClasses;
+
+#if !defined(TT_BUILD_FINAL)
+	enum { maxTimingFrames = 60 };
+	struct CallbackTiming
+	{
+		u32 calls[maxTimingFrames];
+		u64 time[maxTimingFrames];
+	};
+	using CallbackTimings = std::map<std::string, CallbackTiming>;
+	using ReverseTimings  = std::multimap<u64, std::string>;
+	
+	static void addCallbackTiming(CallbackTiming& p_timing, s32 p_frame, u64 p_duration);
+	static void addDebugCallbackTiming(const CallbackTiming& p_timing, const std::string& p_name,
+	                                   ReverseTimings& p_timings_OUT, u64& p_totalTime_OUT,
+	                                   u64& p_totalCalls_OUT);
+	static void resetCallbackTiming(CallbackTiming& p_timing);
+	
+	CallbackTiming  m_callbackTimings[EntityCallback_Count]; // Callbacks called with their EntityCallback
+	CallbackTimings m_namedCallbackTimings;                  // Callbacks called with a name
+	s32             m_currentTimingFrame{0};
+#endif
+};
+
+
+/*! \brief Adds the time between construction and destruction to the callback timings of the EntityScriptMgr.
+    Does nothing in final builds. */
+class ScopedCallbackTiming
+{
+public:
+#if !defined(TT_BUILD_FINAL)
+	inline ScopedCallbackTiming(EntityScriptMgr& p_mgr, EntityCallback p_callback)
+	:
+	m_mgr(p_mgr),
+	m_callback(p_callback),
+	m_name(0),
+	m_startTime(tt::system::Time::getInstance()->getMicroSeconds())
+	{ }
+	
+	inline ScopedCallbackTiming(EntityScriptMgr& p_mgr, const std::string& p_name)
+	:
+	m_mgr(p_mgr),
+	m_callback(EntityCallback_Invalid),
+	m_name(&p_name),
+	m_startTime(tt::system::Time::getInstance()->getMicroSeconds())
+	{ }
+	
+	inline ~ScopedCallbackTiming()
+	{
+		const u64 duration = tt::system::Time::getInstance()->getMicroSeconds() - m_startTime;
+		if (m_name != 0)
+		{
+			m_mgr.addCallbackTiming(*m_name, duration);
+		}
+		else
+		{
+			m_mgr.addCallbackTiming(m_callback, duration);
+		}
+	}
+#else
+	inline ScopedCallbackTiming(EntityScriptMgr&, EntityCallback) { }
+	inline ScopedCallbackTiming(EntityScriptMgr&, const std::string&) { }
+#endif
+
+private:
+	ScopedCallbackTiming(const ScopedCallbackTiming&);                  // Disable copy
+	const ScopedCallbackTiming& operator=(const ScopedCallbackTiming&); // Disable assigment.
+
+#if !defined(TT_BUILD_FINAL)
+	EntityScriptMgr&   m_mgr;
+	EntityCallback     m_callback;
+	const std::string* m_name;      // Callbacks called with a name
+	u64                m_startTime;
+#endif
 };
 
 // Namespace end
@@ -2,11 +2,13 @@
 #define INC_TOKI_GAME_SCRIPT_ENTITYSTATE_H
 
 #include <string>
+#include <vector>
 
 #include <squirrel/squirrel.h>
 
 #include <tt/code/BitMask.h>
 
+#include <toki/game/script/EntityCallback.h>
 #include <toki/game/script/fwd.h>
 
 
@@ -25,11 +27,33 @@ public:
 	inline const std::string& getName()    const { return m_name;    }
 	
 	inline bool isValid() const { return sq_isnull(m_sqState) == false; }
-	inline void reset() { m_name.clear(); sq_resetobject(&m_sqState); }
+	void reset();
+	
+	/*! \brief Looks up the closures of all EntityCallbacks in this state (with inheritance applied).
+	    Called by EntityScriptClass when the class is created. */
+	void resolveCallbacks(HSQUIRRELVM p_vm);
+	
+	/*! \return The closure of the callback in this state, or a null object if this state doesn't have it.
+	    \note The closure is kept alive by the (class of the) state. */
+	inline const HSQOBJECT& getCallback(EntityCallback p_callback) const
+	{
+		TT_ASSERT(isValidEntityCallback(p_callback));
+		return (*m_callbacks)[p_callback];
+	}
+	inline bool hasCallback(EntityCallback p_callback) const
+	{
+		return sq_isnull(getCallback(p_callback)) == false;
+	}
 	
 private:
+	typedef std::vector<HSQOBJECT>         Closures;
+	typedef tt_ptr<const Closures>::shared        ClosuresPtr;
+	
+	static const ClosuresPtr& getEmptyCallbacks();
+	
 	std::string m_name;
 	HSQOBJECT   m_sqState;
+	ClosuresPtr m_callbacks; // Shared by all copies of this state. Indexed on EntityCallback.
 };
 
 
@@ -19,6 +19,7 @@ public:
 	bool isAlive() const;
 	inline void setTimeout(real p_timeout) { m_timeout = p_timeout; }
 	inline real getTimeout() const { return m_timeout; }
+	inline void subtractTime(real p_elapsedTime) { m_timeout -= p_elapsedTime; } // updateTime without the checks
 	inline const entity::EntityHandle& getTarget() const { return m_target; }
 	inline const std::string& getName() const { return m_name; }
 	inline const TimerHash getHash() const { return m_hash; }
@@ -2,9 +2,11 @@
 #define INC_TOKI_GAME_SCRIPT_TIMERMGR_H
 
 
-#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <toki/game/script/fwd.h>
+#include <toki/game/script/Timer.h>
 #include <toki/serialization/fwd.h>
 
 
@@ -12,6 +14,12 @@ namespace toki {
 namespace game {
 namespace script {
 
+/*! \brief Runs the script timers of all entities.
+    Timers are pooled nodes in a hierarchical timing wheel, so update() only handles the timers that
+    (might) expire and starting or stopping a timer doesn't depend on the number of timers.
+    A timer is still counted down one update at a time: the elapsed times of the updates a timer sits
+    in the wheel are kept and subtracted when the timer is checked, so it expires in the same update
+    and with the same timeout as when every timer is counted down in every update. */
 class TimerMgr
 {
 public:
@@ -27,28 +35,109 @@ public:
 	static void suspendAllTimers(const entity::EntityHandle& p_target);
 	static void resumeTimer(const std::string& p_name, const entity::EntityHandle& p_target);
 	static void resumeAllTimers(const entity::EntityHandle& p_target);
-	static const TimerPtr& getTimer(const std::string& p_name, const entity::EntityHandle& p_target);
+	
+	/*! \return The timer or 0 if the target has no timer with that name.
+	    \note Only valid until the next TimerMgr call. */
+	static const Timer* getTimer(const std::string& p_name, const entity::EntityHandle& p_target);
 	
 	// FIXME: (Un)serialization should probably indicate whether this was successful
 	static void serialize  (      toki::serialization::SerializationMgr& p_serializationMgr);
 	static void unserialize(const toki::serialization::SerializationMgr& p_serializationMgr);
-
+	
 	static void logTimers();
 	
 private:
-	typedef std::map<TimerHash, TimerPtr> EntityTimers;
-	typedef std::map<entity::EntityHandle, EntityTimers> Timers;
+	enum NodeState
+	{
+		NodeState_Free,
+		NodeState_Idle,      // Suspended (or its target is); not counted down
+		NodeState_Active,    // Counted down and checked every update
+		NodeState_Scheduled  // In the wheel; can't expire before its wake tick
+	};
+	
+	enum
+	{
+		WheelRootBits   = 8,
+		WheelLevelBits  = 6,
+		WheelLevelCount = 3,
+		WheelRootSize   = 1 << WheelRootBits,
+		WheelLevelSize  = 1 << WheelLevelBits,
+		WheelSlotCount  = WheelRootSize + WheelLevelCount * WheelLevelSize,
+		
+		// History is trimmed (syncing all scheduled timers) once it holds this many elapsed times.
+		MaxHistorySize  = 4096
+	};
+	
+	struct TimerNode
+	{
+		explicit TimerNode(const Timer& p_timer);
+		
+		Timer     timer;
+		u32       id;         // Tells a restarted timer apart from the one it replaced.
+		NodeState state;
+		u32       syncTick;   // First update whose elapsed time isn't subtracted from the timeout yet
+		u32       wakeTick;   // Update in which a scheduled timer is checked
+		s32       slot;       // Wheel slot of a scheduled timer
+		s32       prev;       // Active list, wheel slot or free list
+		s32       next;
+		s32       entityPrev; // Timers of the same target
+		s32       entityNext;
+	};
+	
+	struct ExpiredTimer
+	{
+		s32 index;
+		u32 id;
+	};
+	
+	typedef std::vector<TimerNode>       TimerNodes;
+	typedef std::unordered_map<u32, s32> EntityTimers; // Handle value -> first timer of the entity
+	typedef std::vector<real>            ElapsedTimes;
+	typedef std::vector<ExpiredTimer>    ExpiredTimers;
+	typedef std::vector<s32>             TimerIndices;
 	
 	TimerMgr();  // Static class. Not implemented
 	~TimerMgr(); // Static class. Not implemented
 	
 	static void init();
-	static inline void reset() { ms_timers.clear(); }
+	static void reset();
 	static void deinit();
 	static void update(real p_elapsedTime);
 	
-	static bool   ms_initialized;
-	static Timers ms_timers;
+	static void startTimer(const std::string& p_name, real p_timeout, const entity::EntityHandle& p_target,
+	                       bool p_isSeparateCallback);
+	
+	static s32  findTimer(const TimerHash& p_hash, const entity::EntityHandle& p_target);
+	static s32  createTimer(const Timer& p_timer);
+	static void destroyTimer(s32 p_index);
+	
+	static void linkTimer(s32& p_head, s32 p_index);
+	static void unlinkTimer(s32 p_index);
+	static void insertIntoWheel(s32 p_index);
+	static void cascadeWheel(s32 p_slot);
+	
+	static void syncTimer(s32 p_index);
+	static void syncAllTimers();
+	static void scheduleTimer(s32 p_index);
+	static void getSortedTimers(TimerIndices& p_indices_OUT);
+	
+	/*! \brief Order of the timers before they were pooled: on target, then on hash. */
+	static bool isTimerLess(s32 p_lhs, s32 p_rhs);
+	static bool isExpiredTimerLess(const ExpiredTimer& p_lhs, const ExpiredTimer& p_rhs);
+	
+	static bool          ms_initialized;
+	static TimerNodes    ms_nodes;
+	static s32           ms_freeNodes;
+	static u32           ms_nextID;
+	static EntityTimers  ms_entityTimers;
+	
+	static s32           ms_activeTimers;
+	static s32           ms_wheel[WheelSlotCount];
+	static u32           ms_currentTick;     // The next update
+	static u32           ms_historyStartTick;
+	static ElapsedTimes  ms_elapsedHistory;  // Elapsed times of the updates from ms_historyStartTick
+	static real          ms_maxElapsedTime;  // Timers are scheduled assuming no update takes longer
+	static ExpiredTimers ms_expiredTimers;   // Only used in update. It's a member so we don't create and destroy it so much.
 	
 	friend class EntityScriptMgr; // EntityScriptMgr does the update, init and deinit.
 };
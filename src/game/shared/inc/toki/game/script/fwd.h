@@ -29,7 +29,6 @@ class EntityState;
 class Registry;
 
 class Timer;
-typedef tt_ptr<Timer>::shared TimerPtr;
 
 typedef tt::math::hash::Hash<32> TimerHash;
 
@@ -39,6 +39,13 @@ public:
 	    \param p_progressType the specific progress type to check. */
 	static void restoreAndClearEx(const std::string& p_id, ProgressType p_progressType);
 	
+	/*! \brief Restore one of the recently stored checkpoints of the current level
+	    \param p_checkPointsBack 0 restores the most recently stored checkpoint, 1 the one before that, etc. */
+	static void rewind(s32 p_checkPointsBack);
+	
+	/*! \brief Returns the number of recently stored checkpoints that can be restored with rewind. */
+	static s32 getRewindCount();
+	
 	/*! \brief Retrieve a list of all current checkpoint IDs */
 	static tt::str::Strings getAllIDs();
 	
@@ -64,7 +64,11 @@ public:
 	inline const std::string& getId() const { return m_data.id; }
 	
 	/*! \brief Sets textureFilename. */
-	inline void setTextureFilename(const std::string& p_textureFilename) { m_data.textureFilename = p_textureFilename; }
+	inline void setTextureFilename(const std::string& p_textureFilename)
+	{
+		m_data.textureFilename = p_textureFilename;
+		m_data.textureEngineID = tt::engine::EngineID(0, 0); // Resolve the new filename when used
+	}
 	
 	/*! \brief Gets textureFilename. */
 	inline const std::string& getTextureFilename() const { return m_data.textureFilename; }
@@ -0,0 +1,81 @@
+#if !defined(INC_TOKI_INPUT_REPLAYBENCHMARK_H)
+#define INC_TOKI_INPUT_REPLAYBENCHMARK_H
+
+#include <string>
+#include <vector>
+
+#include <tt/args/CmdLine.h>
+#include <tt/platform/tt_types.h>
+#include <tt/profiler/Benchmark.h>
+
+#include <toki/game/fwd.h>
+#include <toki/input/fwd.h>
+#include <toki/utils/SectionProfiler.h>
+
+
+namespace toki {
+namespace input {
+
+/*! \brief Measures the playback of an input recording, started with --benchmark <file.ttrec>.
+    The app runs headless with a fixed timestep, so two runs of the same recording simulate
+    exactly the same frames. Collects the Game::update section timings of every played frame and
+    a hash of the game state every --benchmark_hash_interval frames (default 60). When playback
+    is done everything is written as JSON to --benchmark_output (default benchmark.json).
+    Comparing the state hashes of two runs shows the first frame at which they diverged.
+    \note Section timings are only available in non-final builds. */
+class ReplayBenchmark
+{
+public:
+	static ReplayBenchmarkPtr create(const tt::args::CmdLine& p_cmdLine);
+	
+	/*! \brief Call after every game tick.
+	    \return false when playback is done and the report was written (or the benchmark failed). */
+	bool update();
+
+private:
+	enum State
+	{
+		State_WaitingForPlayback,
+		State_Playing,
+		State_Done,
+		State_Failed
+	};
+	
+	struct StateHash
+	{
+		u32 frame;
+		u32 hash;
+	};
+	typedef std::vector<StateHash> StateHashes;
+	
+	ReplayBenchmark(const std::string& p_recordingPath, const std::string& p_outputPath,
+	                s32 p_hashInterval);
+	
+	void addFrame(game::Game& p_game);
+	static u32 getGameStateHash(game::Game& p_game);
+	bool writeReport() const;
+	
+	const std::string m_recordingPath;
+	const std::string m_outputPath;
+	const s32         m_hashInterval;
+	
+	State             m_state;
+	u64               m_startTime;     // microseconds
+	u64               m_playTime;      // microseconds; wall clock time of the whole playback
+	u32               m_frameCount;
+	const game::Game* m_lastGame;
+	u32               m_lastGameFrame; // Profiler frame count of m_lastGame when it was last sampled
+	tt::profiler::Benchmark::Stats m_sections[utils::FrameUpdateSection_Count];
+	tt::profiler::Benchmark::Stats m_frameTotal;
+	StateHashes       m_stateHashes;
+	
+	ReplayBenchmark(const ReplayBenchmark&);                  // Disable copy
+	const ReplayBenchmark& operator=(const ReplayBenchmark&); // Disable assigment.
+};
+
+
+// Namespace end
+}
+}
+
+#endif // INC_TOKI_INPUT_REPLAYBENCHMARK_H
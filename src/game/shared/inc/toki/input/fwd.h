@@ -19,6 +19,9 @@ typedef tt_ptr<Recording>::shared RecordingPtr;
 class RecorderGui;
 typedef tt_ptr<RecorderGui>::shared RecorderGuiPtr;
 
+class ReplayBenchmark;
+typedef tt_ptr<ReplayBenchmark>::shared ReplayBenchmarkPtr;
+
 
 #if defined(TT_BUILD_FINAL)
 #	define ENABLE_RECORDER 0
@@ -42,6 +42,12 @@ public:
 	/*! \brief Returns whether this object has the same content as another one */
 	bool equals(const AttributeLayerPtr& p_other) const;
 	
+	/*! \brief Finds the tiles that differ from another layer.
+	    \param p_changedRect_OUT Receives the smallest rectangle holding all the tiles that differ,
+	                             or the whole layer if the other layer has a different size.
+	    \return False if the layers have the same content. */
+	bool getChangedRect(const AttributeLayerPtr& p_other, tt::math::PointRect* p_changedRect_OUT) const;
+	
 	AttributeLayerPtr clone() const;
 	
 	inline s32 getLength() const { return m_width * m_height; }
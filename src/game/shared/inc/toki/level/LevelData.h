@@ -8,6 +8,7 @@
 
 #include <tt/code/AutoGrowBuffer.h>
 #include <tt/code/Buffer.h>
+#include <tt/code/BufferReadContext.h>
 #include <tt/engine/renderer/ColorRGBA.h>
 #include <tt/fs/types.h>
 #include <tt/math/Point2.h>
@@ -120,10 +121,18 @@ public:
 	// Pathfinding data
 	inline void setAgentRadii(const game::pathfinding::PathMgr::AgentRadii& p_agentRadii) { m_agentRadii = p_agentRadii; }
 	inline const game::pathfinding::PathMgr::AgentRadii& getAgentRadii() const { return m_agentRadii; }
-	inline bool hasPathfindingData() const { return m_pathfindingData != 0; }
+	inline bool hasPathfindingData() const { return m_pathfindingData != 0 || m_loadedPathfindingData != 0; }
 	tt::code::AutoGrowBufferPtr createPathfindingData();
-	inline void invalidatePathfindingData() { m_pathfindingData.reset(); }
-	inline tt::code::AutoGrowBufferPtr getPathfindingData() const { return m_pathfindingData; }
+	void invalidatePathfindingData();
+	
+	/*! \brief Returns a context to read the pathfinding data from. Data loaded from file is read
+	           from the copy of the pathfinding chunk this level keeps. */
+	tt::code::BufferReadContext getPathfindingReadContext() const;
+	
+	/*! \brief Returns the size of the pathfinding chunk this level keeps from its file. This is the
+	           only part of the file content that is kept after loading. */
+	inline size_t getLoadedPathfindingSize() const
+	{ return (m_loadedPathfindingData != 0) ? static_cast<size_t>(m_loadedPathfindingData->getSize()) : 0; }
 	
 	// Steam details:
 	
@@ -194,7 +203,8 @@ private:
 	entity::EntityInstances                m_entities;
 	Notes                                  m_notes;
 	game::pathfinding::PathMgr::AgentRadii m_agentRadii;
-	tt::code::AutoGrowBufferPtr            m_pathfindingData;
+	tt::code::AutoGrowBufferPtr            m_pathfindingData;       //!< Pathfinding data created for this level (see createPathfindingData)
+	tt::code::BufferPtr                    m_loadedPathfindingData; //!< Pathfinding chunk as loaded from file (if not replaced by m_pathfindingData)
 	u64                                    m_steamPublishedFileId; // Steam Workshop ID of this level, if it was published to Steam Workshop
 	u64                                    m_steamOwnerId;         // Steam user ID of the user that created this level
 	
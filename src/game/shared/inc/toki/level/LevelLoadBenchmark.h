@@ -0,0 +1,34 @@
+#if !defined(INC_TOKI_LEVEL_LEVELLOADBENCHMARK_H)
+#define INC_TOKI_LEVEL_LEVELLOADBENCHMARK_H
+
+#include <tt/args/CmdLine.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace toki {
+namespace level {
+
+/*! \brief Measures loading all levels in a folder, started with --benchmark_levels [folder] (default 'levels/').
+    Every level is loaded --benchmark_iterations times (default 5). Per level it reports the time
+    to load the level file (including the entities and their properties) and to load the pathfinding
+    tile caches, which together make up the level part of the time to the first frame. It also
+    reports the file size, the bytes of the file the level keeps after loading and the bytes of all
+    entity property strings. Everything is written as JSON to --benchmark_output (default benchmark_levels.json). */
+class LevelLoadBenchmark
+{
+public:
+	/*! \return false if no levels were found or the report could not be written. */
+	static bool run(const tt::args::CmdLine& p_cmdLine);
+
+private:
+	LevelLoadBenchmark();                                           // Static class
+	LevelLoadBenchmark(const LevelLoadBenchmark&);                  // Disable copy
+	const LevelLoadBenchmark& operator=(const LevelLoadBenchmark&); // Disable assigment.
+};
+
+
+// Namespace end
+}
+}
+
+#endif // INC_TOKI_LEVEL_LEVELLOADBENCHMARK_H
@@ -0,0 +1,33 @@
+#if !defined(INC_TOKI_LEVEL_SKINUPDATEBENCHMARK_H)
+#define INC_TOKI_LEVEL_SKINUPDATEBENCHMARK_H
+
+#include <tt/args/CmdLine.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace toki {
+namespace level {
+
+/*! \brief Measures updating the level skin after small edits, started with --benchmark_skin_update.
+    Generates the skin of a few synthetic cave levels and then paints --benchmark_iterations (default 50)
+    random brush strokes in each. After every stroke the skin is updated with skin::updateSkinShoebox and,
+    for comparison, generated again from scratch; both results must hold the same planes in the same order.
+    Everything is written as JSON to --benchmark_output (default benchmark_skin_update.json). */
+class SkinUpdateBenchmark
+{
+public:
+	/*! \return false if an updated skin differs from the regenerated one or the report could not be written. */
+	static bool run(const tt::args::CmdLine& p_cmdLine);
+
+private:
+	SkinUpdateBenchmark();                                            // Static class
+	SkinUpdateBenchmark(const SkinUpdateBenchmark&);                  // Disable copy
+	const SkinUpdateBenchmark& operator=(const SkinUpdateBenchmark&); // Disable assigment.
+};
+
+
+// Namespace end
+}
+}
+
+#endif // INC_TOKI_LEVEL_SKINUPDATEBENCHMARK_H
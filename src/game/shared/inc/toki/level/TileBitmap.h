@@ -0,0 +1,118 @@
+#if !defined(INC_TOKI_LEVEL_TILEBITMAP_H)
+#define INC_TOKI_LEVEL_TILEBITMAP_H
+
+#include <vector>
+
+#include <tt/math/Point2.h>
+#include <tt/math/Vector2.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_types.h>
+
+
+namespace toki {
+namespace level {
+
+/*! \brief One bit per tile of the level, packed in 32-bit words per row.
+           Used for the yes/no tile queries that run for every step of a tile ray trace. */
+class TileBitmap
+{
+public:
+	/*! \brief A ray to trace through the bitmap. All rays with the same group test one target:
+	           the group is clear as soon as one of its rays is. */
+	struct Ray
+	{
+		inline Ray(const tt::math::Vector2& p_start, const tt::math::Vector2& p_end, s32 p_group)
+		:
+		start(p_start),
+		end(p_end),
+		group(p_group)
+		{ }
+		
+		tt::math::Vector2 start;
+		tt::math::Vector2 end;
+		s32               group;
+	};
+	typedef std::vector<Ray> Rays;
+	typedef std::vector<u8>  GroupResults; // Non-zero if a ray of the group reached its end
+	
+	
+	TileBitmap();
+	
+	/*! \brief Resizes the bitmap to p_width by p_height tiles and resets all bits. */
+	void resize(s32 p_width, s32 p_height);
+	
+	inline s32 getWidth()  const { return m_width;  }
+	inline s32 getHeight() const { return m_height; }
+	
+	inline void set(const tt::math::Point2& p_tile, bool p_value)
+	{
+		TT_ASSERT(contains(p_tile));
+		u32& word(m_words[getWordIndex(p_tile)]);
+		const u32 mask = getBitMask(p_tile);
+		word = p_value ? (word | mask) : (word & ~mask);
+	}
+	
+	/*! \return Whether the bit of p_tile is set; false for tiles outside the bitmap. */
+	inline bool isSet(const tt::math::Point2& p_tile) const
+	{
+		return contains(p_tile) && (m_words[getWordIndex(p_tile)] & getBitMask(p_tile)) != 0;
+	}
+	
+	inline bool contains(const tt::math::Point2& p_tile) const
+	{
+		// Negative positions wrap around to large unsigned values.
+		return static_cast<u32>(p_tile.x) < static_cast<u32>(m_width) &&
+		       static_cast<u32>(p_tile.y) < static_cast<u32>(m_height);
+	}
+	
+	/*! \brief Traces a ray with the same tile stepping as tt::code::tileRayTrace.
+	    \return true if the ray reaches p_end without passing a tile with its bit set. */
+	bool traceRay(const tt::math::Vector2& p_start, const tt::math::Vector2& p_end) const;
+	
+	/*! \brief Traces all rays in one pass. Rays of a group that is already clear are skipped.
+	    \param p_groupResults_IN_OUT One entry per group. Groups that are non-zero on entry are not traced. */
+	void traceRays(const Rays& p_rays, GroupResults& p_groupResults_IN_OUT) const;
+	
+	/*! \brief Functor to pass a bitmap as hit tester to tt::code::tileRayTrace. */
+	class HitTester
+	{
+	public:
+		explicit inline HitTester(const TileBitmap& p_bitmap) : m_bitmap(p_bitmap) { }
+		
+		inline bool operator()(const tt::math::Point2& p_location) const
+		{
+			return m_bitmap.isSet(p_location);
+		}
+		
+	private:
+		// No assignment
+		HitTester& operator=(const HitTester&);
+		
+		const TileBitmap& m_bitmap;
+	};
+	
+private:
+	typedef std::vector<u32> Words;
+	
+	inline s32 getWordIndex(const tt::math::Point2& p_tile) const
+	{
+		return p_tile.y * m_wordsPerRow + (p_tile.x >> 5);
+	}
+	
+	static inline u32 getBitMask(const tt::math::Point2& p_tile)
+	{
+		return u32(1) << (p_tile.x & 31);
+	}
+	
+	s32   m_width;       // in tiles
+	s32   m_height;      // in tiles
+	s32   m_wordsPerRow;
+	Words m_words;
+};
+
+// Namespace end
+}
+}
+
+
+#endif  // !defined(INC_TOKI_LEVEL_TILEBITMAP_H)
@@ -10,6 +10,7 @@
 #include <tt/platform/tt_types.h>
 
 #include <toki/game/entity/fwd.h>
+#include <toki/level/TileBitmap.h>
 #include <toki/level/TileChangedObserver.h>
 #include <toki/level/types.h>
 
@@ -47,14 +48,42 @@ public:
 	                              const tt::math::PointRect&        p_newTiles,
 	                              const game::entity::EntityHandle& p_entityHandle);
 	
+	/*! \brief The (sorted) handles registered in one cell.
+	    \note Only valid until the next entity handle (un)registration. */
+	class EntityHandleRange
+	{
+	public:
+		typedef const game::entity::EntityHandle* const_iterator;
+		
+		inline EntityHandleRange(const_iterator p_begin, const_iterator p_end)
+		:
+		m_begin(p_begin),
+		m_end(p_end)
+		{ }
+		
+		inline const_iterator begin() const { return m_begin; }
+		inline const_iterator end()   const { return m_end;   }
+		inline s32            size()  const { return static_cast<s32>(m_end - m_begin); }
+		inline bool           empty() const { return m_begin == m_end; }
+		
+	private:
+		const_iterator m_begin;
+		const_iterator m_end;
+	};
+	
 	// NOTE: Caller is responsible for range checking the arguments
-	inline bool hasEntityAtPosition(u32 p_x, u32 p_y) const { return m_hasEntities[getCellIndex(p_x, p_y)]; }
+	inline bool hasEntityAtPosition(u32 p_x, u32 p_y) const { return m_entityCells[getCellIndex(p_x, p_y)].count > 0; }
 
 	bool isEntityAtPosition(const tt::math::Point2& p_position, const game::entity::EntityHandle& p_entityHandle) const;
 	void findRegisteredEntityHandles(const tt::math::Point2&    p_position, game::entity::EntityHandleSet& p_result) const;
 	void findRegisteredEntityHandles(const tt::math::PointRect& p_tiles,    game::entity::EntityHandleSet& p_result) const;
 	
-	const game::entity::EntityHandleSet& getRegisteredEntityHandles(const tt::math::Point2& p_position) const;
+	/*! \brief Same as the EntityHandleSet versions, but add the handles to a (scratch) vector.
+	           p_result is kept sorted and without duplicates, so it iterates like an EntityHandleSet. */
+	void findRegisteredEntityHandles(const tt::math::Point2&    p_position, game::entity::EntityHandles& p_result) const;
+	void findRegisteredEntityHandles(const tt::math::PointRect& p_tiles,    game::entity::EntityHandles& p_result) const;
+	
+	EntityHandleRange getRegisteredEntityHandles(const tt::math::Point2& p_position) const;
 	
 	// EntityTiles on tile positions:
 	
@@ -103,6 +132,10 @@ public:
 	
 	CollisionType getCollisionType(const tt::math::Point2& p_tilePos) const;
 	
+	/*! \brief The tiles for which isLightBlocking returns true, kept up to date with the cached collision types.
+	           Unlike isLightBlocking, the bitmap reports tiles outside the level as not set. */
+	inline const TileBitmap& getLightBlockingTiles() const { return m_lightBlockingTiles; }
+	
 	
 	virtual void onTileChange(const tt::math::Point2& p_position);
 	
@@ -129,6 +162,21 @@ public:
 	
 private:
 	typedef game::entity::EntityHandleSet EntityHandleSet;
+	
+	// Handles of a cell are stored inline; only crowded cells use a list from the overflow pool.
+	struct EntityCell
+	{
+		enum { InlineCapacity = 6 };
+		
+		inline EntityCell() : count(0), overflowIndex(-1) { }
+		
+		s32                        count;
+		s32                        overflowIndex; // Index in m_overflowHandles or -1 if the handles are inline
+		game::entity::EntityHandle handles[InlineCapacity];
+	};
+	typedef std::vector<EntityCell>                  EntityCells;
+	typedef std::vector<game::entity::EntityHandles> OverflowHandles;
+	
 	inline s32 getCellIndex(s32 p_x, s32 p_y) const
 	{
 		const s32 cx = (p_x / cellSize);
@@ -140,8 +188,11 @@ private:
 		return cx + cy * m_cellBounds.x;
 	}
 	
+	void                                     addEntityToCell(s32 p_cellIndex, const game::entity::EntityHandle& p_entityHandle);
+	bool                                     removeEntityFromCell(s32 p_cellIndex, const game::entity::EntityHandle& p_entityHandle);
+	EntityHandleRange                        getCellEntities(s32 p_cellIndex) const;
 	void                                     addChangedTiles(const tt::math::PointRect& p_tileRect);
-	const EntityHandleSet*                   getEntitiesAtPosition(const tt::math::Point2& p_position) const;
+	EntityHandleRange                        getEntitiesAtPosition(const tt::math::Point2& p_position) const;
 	const game::entity::EntityTilesWeakPtrs* getTilesAtPosition   (const tt::math::Point2& p_position) const;
 	void                                     getCollisionTypesFromLevel();
 	bool                                     updateCollisionType(const tt::math::Point2& p_position);
@@ -150,17 +201,18 @@ private:
 	const TileRegistrationMgr& operator=(const TileRegistrationMgr&); // Disabled
 	
 #if defined(USE_STD_VECTOR)
-	std::vector<EntityHandleSet>                   m_registeredEntityHandles;
 	std::vector<game::entity::EntityTilesWeakPtrs> m_registeredEntityTiles;
 	std::vector<CollisionType>                     m_collisionTypes;
-	std::vector<bool>                              m_hasEntities;
 #else
-	EntityHandleSet*                   m_registeredEntityHandles;
 	game::entity::EntityTilesWeakPtrs* m_registeredEntityTiles;
 	CollisionType*                     m_collisionTypes;
-	bool*                              m_hasEntities;
 #endif
 	
+	EntityCells                        m_entityCells;
+	OverflowHandles                    m_overflowHandles;     // Lists keep their capacity when released
+	std::vector<s32>                   m_freeOverflowIndices;
+	
+	TileBitmap                         m_lightBlockingTiles;
 	TilePositions                      m_changedTiles;
 	TilePositions                      m_entityTilesForFluids;
 	
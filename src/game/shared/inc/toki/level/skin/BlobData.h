@@ -2,7 +2,6 @@
 #define INC_TOKI_LEVEL_SKIN_BLOBDATA_H
 
 #include <vector>
-#include <list>
 
 #include <tt/platform/tt_types.h>
 #include <tt/platform/tt_printf.h>
@@ -60,203 +59,74 @@ struct SubQuad
 typedef std::vector<SubQuad> SubQuads;
 
 
-//--------------------------------------------------------------------------------------------------
-// TileBlob
-
-class TileBlob
-{
-public:
-	inline TileBlob(const tt::math::Point2& p_pos)
-	:
-	m_minPoint(p_pos),
-	m_maxPoint(p_pos),
-	m_subQuads()
-	{
-	}
-	
-	inline TileBlob()
-	:
-	m_minPoint(),
-	m_maxPoint(),
-	m_subQuads()
-	{
-	}
-	
-	inline void add(const TileBlob& p_other)
-	{
-		m_minPoint.x = std::min(m_minPoint.x, p_other.m_minPoint.x);
-		m_minPoint.y = std::min(m_minPoint.y, p_other.m_minPoint.y);
-		
-		m_maxPoint.x = std::max(m_maxPoint.x, p_other.m_maxPoint.x);
-		m_maxPoint.y = std::max(m_maxPoint.y, p_other.m_maxPoint.y);
-		
-		const SubQuads& otherQuads = p_other.m_subQuads;
-		m_subQuads.insert(m_subQuads.end(), otherQuads.begin(), otherQuads.end());
-	}
-	
-	inline void add(const tt::math::Point2& p_pos)
-	{
-		TT_ASSERT(m_minPoint.x <= p_pos.x);
-		TT_ASSERT(m_minPoint.y <= p_pos.y);
-		
-		m_maxPoint.x = std::max(m_maxPoint.x, p_pos.x);
-		m_maxPoint.y = std::max(m_maxPoint.y, p_pos.y);
-	}
-	
-	inline const tt::math::Point2& getMin()           const { return m_minPoint;      }
-	inline const tt::math::Point2& getMax()           const { return m_maxPoint;      }
-	
-	inline void addSubQuad(const SubQuad& p_quad)
-	{
-		m_subQuads.push_back(p_quad);
-	}
-	
-	inline const SubQuads& getSubQuads() const { return m_subQuads; }
-	
-	inline void print() const
-	{
-		TT_Printf("blob min: (%d, %d). max: (%d, %d).",
-		          m_minPoint.x, m_minPoint.y,
-		          m_maxPoint.x, m_maxPoint.y);
-	}
-	
-private:
-	tt::math::Point2 m_minPoint;
-	tt::math::Point2 m_maxPoint;
-	SubQuads         m_subQuads;
-};
-
-
 //--------------------------------------------------------------------------------------------------
 // BlobData
 
+/*! \brief Finds the quads that cover the center of the solid tiles, one row at a time.
+    The quads are not grouped per blob of connected tiles; only the quads themselves end up in the skin. */
 struct BlobData
 {
-	typedef std::list<TileBlob> Blobs;
-	
-	Blobs allBlobs; // All the tile blobs that are found are stored here.
+	SubQuads finishedQuads; // Quads that can't grow anymore; the generator turns these into planes.
 	
 	// The following prev* vectors holds the tile info previously found, 
 	// these tiles might get extended with new tiles.
 	// 
-	// While iterating over a row prev*[i] points to:
-	// * The found blobs to the left of the current row (y) if (i < x).
-	// * The found blobs in the row below (y - 1)           if (i >= x).
-	std::vector<s32>            prevBlobIndex;   // Points to index of allBlobs
+	// While iterating over a row prev*[i] holds:
+	// * The tiles to the left of the current row (y) if (i < x).
+	// * The tiles in the row below (y - 1)           if (i >= x).
 	std::vector<s32>            prevColumnDepth; // Deepest point in this column which could form a quad.
 	std::vector<QuadType>       prevQuadType;
 	
-	SubQuad activeMergeQuad;               // Once a column can no longer be filled heigh we'll try merge to with right.
-	s32     activeMergeQuadBlobIndex; // If >= 0 the merge quad is active.
+	SubQuad activeMergeQuad; // Once a column can no longer be filled heigh we'll try merge to with right.
+	                         // If it has a valid type the merge quad is active.
 	
 	
 	inline BlobData()
 	:
-	allBlobs(),
-	prevBlobIndex(),
+	finishedQuads(),
 	prevColumnDepth(),
 	prevQuadType(),
-	activeMergeQuad(),
-	activeMergeQuadBlobIndex(-1)
+	activeMergeQuad()
 	{ }
 	
 	inline void reset(s32 width)
 	{
-		allBlobs.clear();
+		finishedQuads.clear();
 		
-		prevBlobIndex.clear();
-		prevBlobIndex.resize(  width, -1);
 		prevColumnDepth.clear();
 		prevColumnDepth.resize(width, -1);
 		prevQuadType.clear();
 		prevQuadType.resize(   width, QuadType_Invalid);
 		
-		activeMergeQuad.type     = QuadType_Invalid;
-		activeMergeQuadBlobIndex = -1;
+		activeMergeQuad.type = QuadType_Invalid;
 	}
 	
-	inline bool hasActiveMergeQuad() const { return activeMergeQuadBlobIndex >= 0; }
-	
-	inline TileBlob& getBlob(s32 p_index)
-	{
-		TT_ASSERT(p_index >= 0 && static_cast<size_t>(p_index) < allBlobs.size());
-		Blobs::iterator blobIt = allBlobs.begin();
-		std::advance(blobIt, p_index);
-		TT_ASSERT(blobIt != allBlobs.end());
-		return (*blobIt);
-	}
+	inline bool hasActiveMergeQuad() const { return isValidQuadType(activeMergeQuad.type); }
 	
-	inline void mergeBlobs(s32 p_indexOne, s32 p_indexTwo)
+	/*! \brief Whether continuing from this data finds the same quads as continuing from p_other. */
+	inline bool hasSameState(const BlobData& p_other) const
 	{
-		const s32 oldPointIdx = p_indexOne;
-		s32 newPointIdx       = p_indexTwo;
-		
-		TT_ASSERT(oldPointIdx >= 0 && oldPointIdx < static_cast<s32>(allBlobs.size()));
-		TT_ASSERT(newPointIdx >= 0 && newPointIdx < static_cast<s32>(allBlobs.size()));
-		
-		// Merge blobs
-		{
-			Blobs::iterator oldIt = allBlobs.begin();
-			std::advance(oldIt, oldPointIdx);
-			
-			// Add points from old blob to the new blob.
-			getBlob(newPointIdx).add((*oldIt));
-			allBlobs.erase(oldIt);
-			
-			if (oldPointIdx < newPointIdx)
-			{
-				--newPointIdx;
-			}
-		}
-		
-		if (activeMergeQuadBlobIndex >= 0) // If set
+		if (hasActiveMergeQuad() != p_other.hasActiveMergeQuad() ||
+		    prevColumnDepth      != p_other.prevColumnDepth       ||
+		    prevQuadType         != p_other.prevQuadType)
 		{
-			TT_ASSERT(isValidQuadType(activeMergeQuad.type)); // Need valid quad if index is valid.
-			
-			// Make sure it keeps point to the correct blob index.
-			if (activeMergeQuadBlobIndex >= oldPointIdx)
-			{
-				if (activeMergeQuadBlobIndex == oldPointIdx)
-				{
-					activeMergeQuadBlobIndex = newPointIdx;
-				}
-				else
-				{
-					--activeMergeQuadBlobIndex;
-				}
-				TT_ASSERT(activeMergeQuadBlobIndex >= 0); // Make sure the index is still valid.
-			}
-		}
-		
-		// Update all prevBlobIndex's because oldIt is gone.
-		const std::vector<s32>::size_type width = prevBlobIndex.size();
-		for (std::vector<s32>::size_type i = 0; i < width; ++i)
-		{
-			if (prevBlobIndex[i] >= oldPointIdx) // The prevBlobIndex[i] >= have to be corrected
-			{
-				if (prevBlobIndex[i] == oldPointIdx) // old should get the new idx
-				{
-					prevBlobIndex[i] = newPointIdx;
-				}
-				else // prevBlobIndex[i] > oldPointIdx needs to be moved 1 prevBlobIndex[i] back because oldIt is gone
-				{
-					--prevBlobIndex[i];
-				}
-			}
+			return false;
 		}
+		return hasActiveMergeQuad() == false ||
+		       (activeMergeQuad.type == p_other.activeMergeQuad.type &&
+		        activeMergeQuad.min  == p_other.activeMergeQuad.min  &&
+		        activeMergeQuad.max  == p_other.activeMergeQuad.max);
 	}
 	
 	inline void invalidateMergeQuad()
 	{
-		activeMergeQuadBlobIndex = -1;
-		activeMergeQuad.type     = QuadType_Invalid;
+		activeMergeQuad.type = QuadType_Invalid;
 	}
 	
 	inline void saveAndResetMergeQuad()
 	{
 		// Done with quad merge.
-		TileBlob& blob = getBlob(activeMergeQuadBlobIndex);
-		blob.addSubQuad(activeMergeQuad);
+		finishedQuads.push_back(activeMergeQuad);
 		
 		// Invalid quad
 		invalidateMergeQuad();
@@ -266,8 +136,6 @@ struct BlobData
 	{
 		if (hasActiveMergeQuad()) // We have a quad to merge to.
 		{
-			TT_ASSERT(isValidQuadType(activeMergeQuad.type)); // Need valid quad if index is valid.
-			
 			// Check if the current column can be merged to quad.
 			
 			if (p_index               > 0 && // We're on the same Row as the merge quad. (We have a tile to the left)
@@ -293,12 +161,9 @@ struct BlobData
 	
 	inline void createMergeQuad(s32 p_columnIndex, s32 p_maxY)
 	{
-		TT_ASSERT(hasActiveMergeQuad() == false); // Make sure the index is invalid.
-		TT_ASSERT(isValidQuadType(activeMergeQuad.type) == false); // Expect invalid quad if index is invalid.
+		TT_ASSERT(hasActiveMergeQuad() == false);
 		
-		activeMergeQuadBlobIndex = prevBlobIndex[p_columnIndex];
 		activeMergeQuad.type     = prevQuadType[p_columnIndex];
-		TT_ASSERT(activeMergeQuadBlobIndex >= 0);
 		TT_ASSERT(isValidQuadType(activeMergeQuad.type));
 		
 		activeMergeQuad.min.x = p_columnIndex;
@@ -310,31 +175,28 @@ struct BlobData
 	inline void assertIsValidIndex(s32 p_index) const
 	{
 		TT_ASSERT(                    p_index >= 0);
-		TT_ASSERT(static_cast<size_t>(p_index) < prevBlobIndex.size());
 		TT_ASSERT(static_cast<size_t>(p_index) < prevColumnDepth.size());
 		TT_ASSERT(static_cast<size_t>(p_index) < prevQuadType.size());
 	}
 	
-	inline void setPrevValues(s32 p_index, s32 p_blobIndex, QuadType p_quadType, s32 p_columnDepth)
+	inline void setPrevValues(s32 p_index, QuadType p_quadType, s32 p_columnDepth)
 	{
 		assertIsValidIndex(p_index);
 		
 		// Reset index
-		prevBlobIndex[  p_index] = p_blobIndex;
 		prevColumnDepth[p_index] = p_columnDepth;
 		prevQuadType[   p_index] = p_quadType;
 	}
 	
 	inline void resetAllPrev(s32 p_index)
 	{
-		setPrevValues(p_index, -1, QuadType_Invalid, -1);
+		setPrevValues(p_index, QuadType_Invalid, -1);
 	}
 	
 	inline void assertAllPrevAreReset(s32 p_index) const
 	{
 		assertIsValidIndex(p_index);
 		
-		TT_ASSERT(prevBlobIndex[  p_index] == -1);
 		TT_ASSERT(prevColumnDepth[p_index] == -1);
 		TT_ASSERT(prevQuadType[   p_index] == QuadType_Invalid);
 	}
@@ -344,7 +206,6 @@ struct BlobData
 inline void doGrowBlobData(BlobData& p_blobData, const tt::math::Point2& p_pos, QuadType p_quadType)
 {
 	const s32 index     = p_pos.x;     // Index to the prev* arrays
-	const s32 leftIndex = index - 1;
 	
 	p_blobData.checkForQuadMerge(index, p_pos.x, p_pos.y);
 	
@@ -371,9 +232,6 @@ inline void doGrowBlobData(BlobData& p_blobData, const tt::math::Point2& p_pos,
 		return;
 	}
 	
-	// ---------------------------------------------------------------------
-	// Set array[index] with own values, and maybe merge with the tile below
-	//
 	// Check if the tile below doesn't match
 	if (p_blobData.prevQuadType[index] != p_quadType)
 	{
@@ -384,50 +242,14 @@ inline void doGrowBlobData(BlobData& p_blobData, const tt::math::Point2& p_pos,
 			p_blobData.createMergeQuad(index, p_pos.y - 1);
 		}
 		
-		// No match, set own values
-		p_blobData.allBlobs.push_back(TileBlob(p_pos)); // Create new blob for this point.
-		p_blobData.setPrevValues(index, static_cast<s32>(p_blobData.allBlobs.size() - 1), p_quadType, p_pos.y);
+		// No match, start a new column here.
+		p_blobData.setPrevValues(index, p_quadType, p_pos.y);
 	}
 	else
 	{
-#if defined(TT_BUILD_DEV)
-		// The exiting values can be reused, and the points are shared.
-		TT_ASSERT(p_blobData.prevQuadType[index] == p_quadType);
-#endif
-		TileBlob& blob = p_blobData.getBlob(p_blobData.prevBlobIndex[index]);
-		blob.add(p_pos);
-		
+		// The column below continues.
 		// Sanity check - Make sure the active column depth is below the curreent pos.
 		TT_ASSERT(p_blobData.prevColumnDepth[index] <= p_pos.y);
-		
-		// Different quad type, need to split. up here.
-		if (p_blobData.prevQuadType[index] != p_quadType)
-		{
-			if (p_blobData.prevColumnDepth[index] != -1 &&  // We have an column below which is now ended.
-			    p_blobData.hasActiveMergeQuad()   == false) // No merge already active.
-			{
-				// The current pos is no longer valid for the quad below. So -1.
-				p_blobData.createMergeQuad(index, p_pos.y - 1);
-				p_blobData.prevColumnDepth[index] = p_pos.y; // Make sure these types continue.
-			}
-		}
-	}
-	
-	// ------------------------------------------------------
-	// Check for merge with left tiles.
-	// (More work because we could have gotten all the tiles from below.)
-	if (leftIndex < 0) // No tile to the left.
-	{
-		return;
-	}
-	
-	// Check if current tile matches the one on the left side.
-	if (//p_blobData.prevColumnDepth[leftIndex] >= 0 &&
-	    p_blobData.prevQuadType[ leftIndex] == p_quadType && // Match
-	    p_blobData.prevBlobIndex[leftIndex] != p_blobData.prevBlobIndex[index]) // But not the same blobs
-	{
-		// Need to merge the blobs because they touch.
-		p_blobData.mergeBlobs(p_blobData.prevBlobIndex[index], p_blobData.prevBlobIndex[leftIndex]);
 	}
 }
 
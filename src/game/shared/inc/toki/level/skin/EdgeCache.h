@@ -3,6 +3,7 @@
 
 
 #include <tt/math/Point2.h>
+#include <tt/math/Rect.h>
 
 #include <toki/level/skin/fwd.h>
 #include <toki/level/skin/types.h>
@@ -59,6 +60,9 @@ public:
 	
 	
 	void update(const MaterialCache& p_layer);
+	
+	/*! \brief Only updates the edges next to the tiles in p_changedTiles. */
+	void update(const MaterialCache& p_layer, const tt::math::PointRect& p_changedTiles);
 	void handleLevelResized(s32 p_newLevelWidth, s32 p_newLevelHeight);
 	
 private:
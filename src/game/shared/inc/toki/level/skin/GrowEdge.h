@@ -70,6 +70,25 @@ public:
 	void startAtLevelBorder(Shape p_shape, const TileMaterial& p_material, const tt::math::Point2& p_pos,
 	                        const tt::math::Point2& p_step);
 	
+	/*! \brief Whether growing on from this edge adds the same planes as growing on from p_other.
+	           The fields of an invalid edge don't matter; the next start overwrites them. */
+	inline bool hasSameState(const GrowEdge& p_other) const
+	{
+		if (isValid() == false || p_other.isValid() == false)
+		{
+			return isValid() == p_other.isValid();
+		}
+		return shape     == p_other.shape     &&
+		       startTile == p_other.startTile &&
+		       distance  == p_other.distance  &&
+		       startHalf == p_other.startHalf &&
+		       endHalf   == p_other.endHalf   &&
+#if !TT_SINGLE_SIDE_EDGES
+		       previousTileShape == p_other.previousTileShape &&
+#endif
+		       material  == p_other.material;
+	}
+	
 #if !TT_SINGLE_SIDE_EDGES
 	void stopAndContinue(Shape p_shape, const TileMaterial& p_material, const tt::math::Point2& p_pos,
 	                     const tt::math::Point2& p_step, Shape p_previousTileShapeValid,
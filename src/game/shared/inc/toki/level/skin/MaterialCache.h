@@ -2,11 +2,13 @@
 #define INC_TOKI_LEVEL_SKIN_MATERIALCACHE_H
 
 #include <tt/math/Point2.h>
+#include <tt/math/Rect.h>
 
 #include <toki/level/skin/fwd.h>
 #include <toki/level/skin/types.h>
 #include <toki/level/skin/TileMaterial.h>
 #include <toki/level/fwd.h>
+#include <toki/level/types.h>
 
 namespace toki {
 namespace level {
@@ -20,6 +22,18 @@ public:
 	~MaterialCache();
 	
 	void update(const AttributeLayerPtr& p_layer, ThemeType p_defaultLevelTheme);
+	
+	/*! \brief Only updates the tiles in p_rect. */
+	void update(const AttributeLayerPtr& p_layer, ThemeType p_defaultLevelTheme, const tt::math::PointRect& p_rect);
+	
+	/*! \brief Applies the overridden themes to the tiles in p_rect. Call this after update().
+	    \note An override takes its default theme from the theme of the tile it overrides, and otherwise keeps the
+	          one of the override before it. So all overrides are visited, also for a small rect. */
+	void applyOverriddenThemeTiles(const AttributeLayerPtr&   p_layer,
+	                               ThemeType                  p_defaultLevelTheme,
+	                               const ThemeTiles&          p_overriddenThemeTiles,
+	                               const tt::math::PointRect& p_rect);
+	
 	void handleLevelResized(s32 p_newLevelWidth, s32 p_newLevelHeight);
 	
 	inline const TileMaterial& getTileMaterial(const tt::math::Point2& p_position) const
@@ -45,6 +59,7 @@ public:
 	}
 	
 	inline const tt::math::Point2& getSize() const { return m_levelSize; }
+	inline tt::math::PointRect getRect() const { return tt::math::PointRect(tt::math::Point2(0, 0), m_levelSize.x, m_levelSize.y); }
 	
 	inline const TileMaterial* getRawTiles() const { return m_materialTiles; }
 	inline const TileMaterial* getRawTiles(const tt::math::Point2& p_position) const
@@ -0,0 +1,91 @@
+#if !defined(INC_TOKI_LEVEL_SKIN_SCANSTATE_H)
+#define INC_TOKI_LEVEL_SKIN_SCANSTATE_H
+
+#include <vector>
+
+#include <tt/engine/scene2d/shoebox/fwd.h>
+#include <tt/math/Point2.h>
+
+#include <toki/level/skin/BlobData.h>
+#include <toki/level/skin/fwd.h>
+#include <toki/level/skin/GrowEdge.h>
+#include <toki/level/skin/TileMaterial.h>
+
+
+namespace toki {
+namespace level {
+namespace skin {
+namespace impl {
+
+
+/*! \brief Grows the quads that extend the solid tiles along one side of the level outwards. */
+struct OutsideLevel
+{
+public:
+	enum Side
+	{
+		Side_Up,
+		Side_Down,
+		Side_Left,
+		Side_Right
+	};
+	
+	inline OutsideLevel(Side p_side)
+	:
+	side(p_side),
+	startPoint(-1),
+	material()
+	{}
+	
+	void grow(const tt::math::Point2& p_pos, const TileMaterial& p_material,
+	          const SkinConfig& p_config, tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT);
+	
+	inline bool hasSameState(const OutsideLevel& p_other) const
+	{
+		return side       == p_other.side       &&
+		       startPoint == p_other.startPoint &&
+		       material   == p_other.material;
+	}
+	
+private:
+	Side         side;
+	s32          startPoint;
+	TileMaterial material;
+};
+
+
+/*! \brief Everything generateShoebox carries over from one row of tiles to the next.
+    The planes of a row only depend on this state and on the tiles around that row, so a row can be
+    generated again from a copy of the state at its start. */
+struct ScanState
+{
+	typedef std::vector<GrowEdge> GrowEdges;
+	
+	GrowEdges    verticalEdges; // One per column.
+	BlobData     blobData;
+	OutsideLevel left;
+	OutsideLevel right;
+	
+	
+	inline ScanState()
+	:
+	verticalEdges(),
+	blobData(),
+	left( OutsideLevel::Side_Left),
+	right(OutsideLevel::Side_Right)
+	{ }
+	
+	void reset(s32 p_levelWidth);
+	
+	/*! \brief Whether generating on from this state adds the same planes as generating on from p_other. */
+	bool hasSameState(const ScanState& p_other) const;
+};
+
+// Namespace end
+}
+}
+}
+}
+
+
+#endif  // !defined(INC_TOKI_LEVEL_SKIN_SCANSTATE_H)
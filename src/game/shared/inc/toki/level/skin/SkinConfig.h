@@ -8,7 +8,7 @@
 
 #include <tt/code/ErrorStatus.h>
 #include <tt/engine/scene2d/shoebox/shoebox_types.h>
-#include <tt/math/Random.h>
+#include <tt/math/Point2.h>
 #include <tt/xml/fwd.h>
 
 #include <toki/level/skin/types.h>
@@ -88,8 +88,6 @@ public:
 	bool load(const std::string& p_filename);
 	void clear();
 	
-	void resetRandomSeed();
-	
 	/*! \brief Modifies the vertex colors of all planes in this config so that the per-theme
 	           vertex colors specified in the level data are taken into account. */
 	void setPlaneColorsFromLevelData(const LevelDataPtr& p_levelData, SkinConfigType p_type);
@@ -97,9 +95,13 @@ public:
 	/*! \brief Returns all the texture pointers that are used by the planes. */
 	tt::engine::renderer::TextureContainer getAllUsedTextures() const;
 	
-	const PlaneSet& getPlanes      (const TileMaterial& p_material, Shape p_shape) const;
-	const PlaneSet& getEdgePlanes  (const TileMaterial& p_material, Shape p_shape) const;
-	const PlaneSet& getCenterPlanes(const TileMaterial& p_material) const;
+	/*! \brief The plane set variant is picked from p_tile, so a tile gets the same variant no matter
+	           which other tiles were generated before it. */
+	const PlaneSet& getPlanes      (const TileMaterial& p_material, Shape p_shape,
+	                                const tt::math::Point2& p_tile) const;
+	const PlaneSet& getEdgePlanes  (const TileMaterial& p_material, Shape p_shape,
+	                                const tt::math::Point2& p_tile) const;
+	const PlaneSet& getCenterPlanes(const TileMaterial& p_material, const tt::math::Point2& p_tile) const;
 	
 private:
 	// NOTE: All of these nesting levels are their own structs so that they
@@ -127,7 +129,7 @@ private:
 	static bool parseTexCoordMode(const tt::xml::XmlNode* p_node,
 	                              const std::string&      p_attributeName,
 	                              Plane::TexCoordMode*    p_texCoordMode_OUT);
-	const PlaneSet& getRandomPlaneSet(const PlaneSets& p_planeSets) const;
+	static const PlaneSet& getRandomPlaneSet(const PlaneSets& p_planeSets, const tt::math::Point2& p_tile);
 	
 	void loadTextures(const PlaneSets&                        p_planeSets,
 	                  tt::engine::renderer::TextureContainer* p_textures_OUT) const;
@@ -136,8 +138,6 @@ private:
 	
 	
 	MaterialConfig m_materialConfig[MaterialType_Count][MaterialTheme_Count];
-	
-	mutable tt::math::Random m_skinRandom;
 };
 
 // Namespace end
@@ -2,12 +2,18 @@
 #define INC_TOKI_LEVEL_SKIN_SKINCONTEXT_H
 
 
-#include <toki/level/skin/BlobData.h>
+#include <vector>
+
+#include <tt/engine/renderer/ColorRGBA.h>
+
 #include <toki/level/skin/EdgeCache.h>
 #include <toki/level/skin/functions.h>
 #include <toki/level/skin/fwd.h>
 #include <toki/level/skin/MaterialCache.h>
+#include <toki/level/skin/ScanState.h>
 #include <toki/level/skin/types.h>
+#include <toki/level/AttributeLayer.h>
+#include <toki/level/types.h>
 
 
 namespace toki {
@@ -23,11 +29,28 @@ public:
 	void handleLevelResized(s32 p_newLevelWidth, s32 p_newLevelHeight);
 	
 	
+	/*! \brief Forgets what the last generation recorded, so the next update regenerates everything. */
+	void clearRecordedGeneration();
+	
+	inline bool hasRecordedGeneration() const { return segmentStarts.empty() == false; }
+	
+	
+	typedef std::vector<impl::ScanState>                 ScanStates;
+	typedef std::vector<s32>                             PlaneIndices;
+	typedef std::vector<tt::engine::renderer::ColorRGBA> Colors;
+	
 	MaterialCache     tileMaterial;
 	EdgeCache         edgeCache;
-	impl::GrowEdge*   scratchGrowEdge;
-	s32               scratchGrowEdgeSize;
-	BlobData          blobData;
+	impl::ScanState   scanState;
+	
+	// Recorded by the last generation, so updateSkinShoebox can regenerate only part of the skin.
+	// The rows are split into bands of Constants_SkinBandHeight rows.
+	ScanStates        rowStates;     //!< The scan state at the start of each band, plus one after the last row.
+	PlaneIndices      segmentStarts; //!< Index of the first plane of: the border, each band, the flush and the end.
+	AttributeLayerPtr generatedLayer; //!< Copy of the attribute layer the skin was generated from.
+	ThemeTiles        overriddenThemeTiles;
+	ThemeType         levelTheme;    //!< The default level theme the skin was generated with.
+	Colors            themeColors;   //!< The solid theme colors (per ThemeType) the skin was generated with.
 	
 private:
 	SkinContext(s32 p_levelWidth, s32 p_levelHeight);
@@ -21,18 +21,46 @@ void generateSkinShoebox(const SkinContextPtr&                      p_context,
                          const ThemeTiles&                          p_overriddenThemeTiles,
                          tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT);
 
+/*! \brief Regenerates only the planes that depend on the tiles that changed since the last generation with
+           p_context, in the shoebox that generation filled. The other planes stay as they are.
+    \note p_shoebox_OUT must hold only the skin planes. When the previous generation can't be reused
+          (other level size, level theme, theme colors or overridden theme tiles) everything is generated again. */
+void updateSkinShoebox(const SkinContextPtr&                      p_context,
+                       const LevelDataPtr&                        p_level,
+                       ThemeType                                  p_defaultLevelTheme,
+                       const ThemeTiles&                          p_overriddenThemeTiles,
+                       tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT);
+
 namespace impl {
 
 
+/*! \brief Generates all planes and records the scan state per band of rows in p_context. */
 void generateShoebox(const SkinConfig&                          p_config,
-                     const MaterialCache&                       p_tiles,
-                     const EdgeCache&                           p_edges,
-                     impl::GrowEdge*                            p_edgeScratch,
-                     s32                                        p_edgeScratchSize,
-                     BlobData&                                  p_blobData,
+                     SkinContext&                               p_context,
                      tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT);
 
-void addShoeboxPlanesFromBlobData(const BlobData&                            p_blobData,
+/*! \brief Adds the planes outside the level corners and below the level. Starts the left and right side. */
+void generateBorder(const SkinConfig&                          p_config,
+                    const MaterialCache&                       p_tiles,
+                    ScanState&                                 p_state,
+                    tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT);
+
+/*! \brief Adds the planes of one row of tiles. */
+void generateRow(const SkinConfig&                          p_config,
+                 const MaterialCache&                       p_tiles,
+                 const EdgeCache&                           p_edges,
+                 s32                                        p_row,
+                 ScanState&                                 p_state,
+                 tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT);
+
+/*! \brief Adds the planes above the level and the planes of everything still growing after the last row. */
+void generateFlush(const SkinConfig&                          p_config,
+                   const MaterialCache&                       p_tiles,
+                   ScanState&                                 p_state,
+                   tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT);
+
+/*! \brief Adds the center planes of the finished quads and clears them. */
+void addShoeboxPlanesFromBlobData(BlobData&                                  p_blobData,
                                   const SkinConfig&                          p_config,
                                   tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT);
 
@@ -21,6 +21,8 @@ namespace impl
 {
 	struct EdgeShape;
 	struct GrowEdge;
+	struct OutsideLevel;
+	struct ScanState;
 }
 
 typedef tt_ptr<SkinConfig >::shared SkinConfigPtr;
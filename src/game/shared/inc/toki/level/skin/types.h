@@ -20,7 +20,8 @@ namespace skin {
 
 enum Constants
 {
-	Constants_LevelExtensionSize = 1000 // How many tiles we extent edges and planes at the level border
+	Constants_LevelExtensionSize = 1000, // How many tiles we extent edges and planes at the level border
+	Constants_SkinBandHeight     = 16    // How many rows of tiles share a recorded scan state (see SkinContext)
 };
 
 
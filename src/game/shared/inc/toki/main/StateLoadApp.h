@@ -1,16 +1,12 @@
 #if !defined(INC_TOKI_MAIN_STATELOADAPP_H)
 #define INC_TOKI_MAIN_STATELOADAPP_H
 
-#include <atomic>
-#include <list>
-
 #include <tt/audio/player/fwd.h>
 #include <tt/code/State.h>
 #include <tt/engine/renderer/fwd.h>
 #include <tt/math/Vector2.h>
 #include <tt/pres/fwd.h>
-#include <tt/thread/Mutex.h>
-#include <tt/thread/thread.h>
+#include <tt/thread/LoadGraph.h>
 
 #include <toki/main/loadstate/LoadState.h>
 #include <toki/constants.h>
@@ -41,7 +37,6 @@ public:
 	
 private:
 	typedef std::vector<tt::pres::PresentationObjectPtr> Presentations;
-	typedef std::list<loadstate::LoadStatePtr> LoadStates;
 	enum GraphicState
 	{
 		GraphicState_Loading,
@@ -50,7 +45,7 @@ private:
 	};
 	
 	void setupLoadStates();
-	void calculateLoadSteps();
+	tt::thread::LoadGraph::TaskID addLoadState(const loadstate::LoadStatePtr& p_state, s32 p_priority);
 	void createLoadingGraphics();
 	void destroyLoadingGraphics();
 	void positionLoadingGraphics();
@@ -58,15 +53,8 @@ private:
 	void onLoadComplete();
 	void alignLoadingGraphics();
 	
-#if USE_THREADED_LOADING
-	static int staticLoadThread(void* p_arg);
-	int loadThread();
-#endif
-	
 	
-	LoadStates m_loadStates;
-	s32        m_currentStep;
-	s32        m_totalLoadSteps;
+	tt::thread::LoadGraph* m_loadGraph;
 	
 	u64 m_loadStartTimestamp;
 	
@@ -77,13 +65,6 @@ private:
 	Presentations                   m_presentations;
 	bool                            m_isFadingIn;  // whether fading the load screen in from system startup
 	GraphicState                    m_graphicState;
-	
-#if USE_THREADED_LOADING
-	std::atomic<bool>  m_loadSuspended;
-	std::atomic<bool>  m_stopLoading;
-	tt::thread::handle m_loadThread;
-	tt::thread::Mutex* m_mutex;
-#endif
 };
 
 // Namespace end
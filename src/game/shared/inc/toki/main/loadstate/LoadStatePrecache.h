@@ -21,7 +21,23 @@ namespace loadstate {
 class LoadStatePrecache : public LoadState
 {
 public:
-	static inline LoadStatePtr create() { return LoadStatePtr(new LoadStatePrecache); }
+	enum Content
+	{
+		Content_Particles     = 1 << 0,
+		Content_Presentations = 1 << 1,
+		Content_MovementSets  = 1 << 2,
+		Content_SkinConfigs   = 1 << 3,
+		Content_Textures      = 1 << 4, // miscellaneous and namespace textures
+		
+		Content_All = Content_Particles    | Content_Presentations | Content_MovementSets |
+		              Content_SkinConfigs  | Content_Textures
+	};
+	
+	/*! \param p_content Content flags of what to precache; a state per part lets the parts load in parallel. */
+	static inline LoadStatePtr create(u32 p_content = Content_All)
+	{
+		return LoadStatePtr(new LoadStatePrecache(p_content));
+	}
 	virtual ~LoadStatePrecache() { }
 	
 	virtual std::string getName()               const;
@@ -31,7 +47,7 @@ public:
 	virtual bool isDone() const;
 	
 private:
-	LoadStatePrecache();
+	explicit LoadStatePrecache(u32 p_content);
 	
 	static void gatherFilenames(const std::string& p_path,
 	                            const std::string& p_fileExtension,
@@ -0,0 +1,83 @@
+#if !defined(INC_TOKI_SERIALIZATION_REWINDBUFFER_H)
+#define INC_TOKI_SERIALIZATION_REWINDBUFFER_H
+
+
+#include <deque>
+#include <string>
+
+#include <tt/code/Buffer.h>
+
+#include <toki/serialization/fwd.h>
+
+
+namespace toki {
+namespace serialization {
+
+/*! \brief Bounded in-memory history of recent checkpoints, for instant restarts and rewinding.
+    Every few checkpoints one is stored self-contained (a key frame); the ones in between only store
+    the blocks that changed since the previous checkpoint. When the size limit is exceeded, the oldest
+    key frame is dropped together with the deltas that depend on it. */
+class RewindBuffer
+{
+public:
+	enum
+	{
+		DefaultSizeLimit        = 8 * 1024 * 1024, //!< Bytes of compressed checkpoints to keep
+		DefaultKeyFrameInterval = 8
+	};
+	
+	explicit RewindBuffer(u32 p_sizeLimit        = DefaultSizeLimit,
+	                      s32 p_keyFrameInterval = DefaultKeyFrameInterval);
+	
+	/*! \brief Adds a checkpoint as the most recent one.
+	    The checkpoint is kept (not copied) as the reference for the next delta, so don't change it.
+	    \param p_compressed The checkpoint as returned by SerializationMgr::compress(), if the caller
+	                        already has it. Used as is when the checkpoint is stored as a key frame.
+	    \return The previous reference checkpoint, which is no longer used (can be null). Its buffers
+	            can be reused to serialize the next checkpoint. */
+	SerializationMgrPtr push(const SerializationMgrPtr& p_checkPoint, const tt::code::BufferPtr& p_compressed,
+	                         const std::string& p_id);
+	
+	/*! \brief Recreates a stored checkpoint and removes all checkpoints that are more recent,
+	           so the history continues from the restored checkpoint.
+	    \param p_stepsBack 0 is the most recently pushed checkpoint.
+	    \param p_id_OUT Receives the ID the checkpoint was pushed with.
+	    \return The restored checkpoint, or null if there is no such checkpoint. */
+	SerializationMgrPtr rewind(s32 p_stepsBack, std::string* p_id_OUT);
+	
+	void clear();
+	
+	inline s32 getCount()     const { return static_cast<s32>(m_entries.size()); }
+	inline u32 getTotalSize() const { return m_totalSize;                         }
+	
+private:
+	struct Entry
+	{
+		tt::code::BufferPtr data;
+		std::string         id;
+		bool                isKeyFrame;
+	};
+	typedef std::deque<Entry> Entries;
+	
+	/*! \brief Removes the oldest key frame and its deltas, if a more recent key frame exists. */
+	bool removeOldestKeyFrame();
+	
+	// Disable copy
+	RewindBuffer(const RewindBuffer&);
+	RewindBuffer& operator=(const RewindBuffer&);
+	
+	
+	Entries             m_entries;
+	SerializationMgrPtr m_lastCheckPoint; //!< Reference for the next delta.
+	u32                 m_totalSize;
+	s32                 m_deltasSinceKeyFrame;
+	const u32           m_sizeLimit;
+	const s32           m_keyFrameInterval;
+};
+
+// Namespace end
+}
+}
+
+
+#endif  // !defined(INC_TOKI_SERIALIZATION_REWINDBUFFER_H)
@@ -49,6 +49,11 @@ public:
 	static SerializationMgrPtr createEmpty();
 	static SerializationMgrPtr createFromFile(const tt::fs::FilePtr& p_file);
 	static SerializationMgrPtr createFromCompressedBuffer(const tt::code::BufferPtr& p_buffer);
+	
+	/*! \brief Recreates serialization data from a buffer created by compressDelta.
+	    \param p_reference The same data that was passed to compressDelta. */
+	static SerializationMgrPtr createFromDeltaBuffer(const tt::code::BufferPtr& p_buffer,
+	                                                 const SerializationMgr&    p_reference);
 	SerializationMgr();
 	
 	void clearAll();
@@ -65,14 +70,36 @@ public:
 	
 	SerializationMgrPtr clone() const;
 	
+	/*! \brief Returns all sections LZ4 compressed in a self-contained buffer. */
 	tt::code::BufferPtr compress() const;
 	
+	/*! \brief Returns only the blocks of each section that differ from the reference data, LZ4 compressed.
+	    \note The buffer can only be loaded with createFromDeltaBuffer and the same reference data. */
+	tt::code::BufferPtr compressDelta(const SerializationMgr& p_reference) const;
+	
+	/*! \return Whether the buffer was created by compressDelta. */
+	static bool isDeltaBuffer(const tt::code::BufferPtr& p_buffer);
+	
 private:
 	SerializationMgr(const SerializationMgr& p_rhs);
 	
 	bool loadFromCompressedBuffer(const tt::code::BufferPtr& p_buffer);
+	bool loadFromDeltaBuffer(const tt::code::BufferPtr& p_buffer, const SerializationMgr& p_reference);
+	
+	/*! \brief Writes the sections in the uncompressed layout to the compression input buffer.
+	    \return Number of bytes written, or 0 if the data doesn't fit. */
+	u32 writeSections() const;
+	bool readSections(const u8* p_data, u32 p_size);
+	
+	/*! \brief LZ4 compresses the first p_size bytes of the compression input buffer. */
+	static tt::code::BufferPtr compressInput(u32 p_signature, u32 p_size);
+	
+	/*! \brief Decompresses a buffer created by compressInput into the compression input buffer.
+	    \return Number of decompressed bytes, or 0 if decompression failed. */
+	static u32 decompressToInput(const tt::code::BufferPtr& p_buffer);
 	
 	static const u32 ms_compressionBufferSize = 5 * 1024 * 1024;
+	static const u32 ms_deltaBlockSize        = 256;
 	static u8 ms_compressionInputBuffer [ms_compressionBufferSize];
 	static u8 ms_compressionOutputBuffer[ms_compressionBufferSize];
 	
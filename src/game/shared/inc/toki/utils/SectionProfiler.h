@@ -6,6 +6,7 @@
 #include <tt/engine/debug/DebugRenderer.h>
 #include <tt/engine/renderer/Renderer.h>
 #include <tt/platform/tt_types.h>
+#include <tt/profiler/TraceRecorder.h>
 #include <tt/str/toStr.h>
 #include <tt/system/Time.h>
 
@@ -306,7 +307,11 @@ public:
 	m_sectionStartTime(0),
 	m_outsideTime(0),
 	m_totalInside(0),
-	m_name(p_name)
+	m_frameCount(0),
+	m_counterCount(0),
+	m_name(p_name),
+	m_traceName(tt::profiler::TraceRecorder::intern(p_name)),
+	m_traceFrameOpen(false)
 	{
 		for (s32 i = 0; i < typeCount; ++i)
 		{
@@ -315,6 +320,14 @@ public:
 				m_sectionTimings[i][j] = 0;
 			}
 		}
+		for (s32 i = 0; i < Constants_MaxCounters; ++i)
+		{
+			m_counterNames[i] = "";
+			for (s32 j = 0; j < Constants_SampleCount; ++j)
+			{
+				m_counterValues[i][j] = 0;
+			}
+		}
 	}
 #else
 	{(void) p_name;}
@@ -323,10 +336,23 @@ public:
 	inline void startFrameUpdate()
 	{
 #if TT_USE_SECTION_PROFILER != 0
+		if (m_traceFrameOpen)
+		{
+			// Previous frame wasn't stopped; close its trace events.
+			if (isValid(m_currentSection))
+			{
+				tt::profiler::TraceRecorder::end(getName(m_currentSection));
+			}
+			tt::profiler::TraceRecorder::end(m_traceName);
+		}
+		tt::profiler::TraceRecorder::begin(m_traceName);
+		m_traceFrameOpen   = true;
+		
 		m_currentSection   = static_cast<Type>(-1);
 		u64 now            = tt::system::Time::getInstance()->getMicroSeconds();
 		m_outsideTime      = now - m_sectionStartTime;
 		m_sectionStartTime = now;
+		++m_frameCount;
 		++m_sampleIndex;
 		if (m_sampleIndex >= Constants_SampleCount)
 		{
@@ -337,6 +363,42 @@ public:
 		{
 			m_sectionTimings[i][m_sampleIndex] = 0;
 		}
+		for (s32 i = 0; i < m_counterCount; ++i)
+		{
+			m_counterValues[i][m_sampleIndex] = 0;
+		}
+#endif
+	}
+	
+	/*! \brief Registers a named per-frame counter, rendered below the section timings.
+	    \return The counter index to pass to setCounter, or -1 if no more counters are available. */
+	inline s32 registerCounter(const char* p_name)
+	{
+#if TT_USE_SECTION_PROFILER == 0
+		(void)p_name;
+		return -1;
+#else
+		if (m_counterCount >= Constants_MaxCounters)
+		{
+			TT_PANIC("SectionProfiler '%s' can't register more than %d counters.",
+			         m_name.c_str(), Constants_MaxCounters);
+			return -1;
+		}
+		m_counterNames[m_counterCount] = p_name;
+		return m_counterCount++;
+#endif
+	}
+	
+	inline void setCounter(s32 p_counter, s32 p_value)
+	{
+#if TT_USE_SECTION_PROFILER == 0
+		(void)p_counter;
+		(void)p_value;
+#else
+		if (p_counter >= 0 && p_counter < m_counterCount)
+		{
+			m_counterValues[p_counter][m_sampleIndex] = p_value;
+		}
 #endif
 	}
 	
@@ -351,6 +413,11 @@ public:
 			if (isValid(m_currentSection))
 			{
 				m_sectionTimings[m_currentSection][m_sampleIndex] += now - m_sectionStartTime;
+				tt::profiler::TraceRecorder::end(getName(m_currentSection));
+			}
+			if (isValid(p_section))
+			{
+				tt::profiler::TraceRecorder::begin(getName(p_section));
 			}
 			m_currentSection   = p_section;
 			m_sectionStartTime = now;
@@ -362,6 +429,11 @@ public:
 	{
 #if TT_USE_SECTION_PROFILER != 0
 		startFrameUpdateSection(static_cast<Type>(-1));
+		if (m_traceFrameOpen)
+		{
+			tt::profiler::TraceRecorder::end(m_traceName);
+			m_traceFrameOpen = false;
+		}
 		m_totalInside = 0;
 		for (s32 i = 0; i < typeCount; ++i)
 		{
@@ -370,6 +442,37 @@ public:
 #endif
 	}
 	
+	/*! \brief Number of frames started so far. (Always 0 when the profiler is compiled out.) */
+	inline u32 getFrameCount() const
+	{
+#if TT_USE_SECTION_PROFILER == 0
+		return 0;
+#else
+		return m_frameCount;
+#endif
+	}
+	
+	/*! \brief Time spent in p_section during the last frame, in microseconds. */
+	inline u64 getSectionTime(Type p_section) const
+	{
+#if TT_USE_SECTION_PROFILER == 0
+		(void)p_section;
+		return 0;
+#else
+		return isValid(p_section) ? m_sectionTimings[p_section][m_sampleIndex] : 0;
+#endif
+	}
+	
+	/*! \brief Time spent in all sections during the last frame, in microseconds. */
+	inline u64 getTotalTime() const
+	{
+#if TT_USE_SECTION_PROFILER == 0
+		return 0;
+#else
+		return m_totalInside;
+#endif
+	}
+	
 	s32 render(s32 p_x, s32 p_y, bool p_renderOutsideTime) const
 	{
 		s32 yPos = p_y;
@@ -384,7 +487,7 @@ public:
 		
 		// Render quad behind text for easier reading.
 		{
-			const s32 height = (typeCount * 20) + ((p_renderOutsideTime) ? 80 : 40);
+			const s32 height = ((typeCount + m_counterCount) * 20) + ((p_renderOutsideTime) ? 80 : 40);
 			const s32 width  = SectionProfiler_renderWidth;
 			const s32 extra  = SectionProfiler_renderBorderSize;
 			
@@ -428,6 +531,22 @@ public:
 			yPos += 20;
 		}
 		
+		// Counters
+		for (s32 i = 0; i < m_counterCount; ++i)
+		{
+			s32 max = 0;
+			for (s32 j = 0; j < Constants_SampleCount; ++j)
+			{
+				max = std::max(max, m_counterValues[i][j]);
+			}
+			
+			debug->renderText(std::string(m_counterNames[i]) + ": " +
+			                  tt::str::toStr(m_counterValues[i][m_sampleIndex]) +
+			                  " (max: " + tt::str::toStr(max) + ")",
+			                  p_x, yPos, tt::engine::renderer::ColorRGB::green);
+			yPos += 20;
+		}
+		
 		debug->renderText("Total inside time: "+ tt::str::toStr(m_totalInside) + 
 		                  " (" + getPercentStr(m_totalInside, maxFrameTime) + "%)",
 		                  p_x, yPos, tt::engine::renderer::ColorRGB::green);
@@ -478,7 +597,8 @@ private:
 #if TT_USE_SECTION_PROFILER != 0
 	enum Constants
 	{
-		Constants_SampleCount = 60
+		Constants_SampleCount = 60,
+		Constants_MaxCounters = 4
 	};
 	s32  m_sampleIndex;
 	u64  m_sectionTimings[typeCount][Constants_SampleCount];
@@ -486,11 +606,18 @@ private:
 	u64  m_sectionStartTime;
 	u64  m_outsideTime;
 	u64  m_totalInside;
+	u32  m_frameCount;
+	const char* m_counterNames[Constants_MaxCounters];
+	s32         m_counterValues[Constants_MaxCounters][Constants_SampleCount];
+	s32         m_counterCount;
 	const std::string m_name;
+	const char*       m_traceName;      // Interned copy of m_name for the TraceRecorder
+	bool              m_traceFrameOpen;
 #endif
 };
 
 
+typedef SectionProfiler<utils::FrameUpdateSection, utils::FrameUpdateSection_Count> FrameUpdateSectionProfiler;
 typedef SectionProfiler<utils::FluidMgrSection, utils::FluidMgrSection_Count> FluidMgrSectionProfiler;
 
 
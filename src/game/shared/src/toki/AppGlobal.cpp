@@ -11,6 +11,7 @@
 #include <tt/pres/PresentationCache.h>
 #include <tt/pres/PresentationMgr.h>
 #include <tt/pres/PresentationObject.h>
+#include <tt/thread/CriticalSection.h>
 
 #include <toki/game/CheckPointMgr.h>
 #include <toki/game/script/EntityScriptMgr.h>
@@ -48,6 +49,14 @@ enum CmdLineFlag
 	
 #if !defined(TT_BUILD_FINAL)
 	CmdLineFlag_CompileSquirrel,
+	CmdLineFlag_PrecompileSquirrel, // fill the script bytecode cache and exit
+	CmdLineFlag_Benchmark,        // headless benchmarks, see AppGlobal::BenchmarkMode
+	CmdLineFlag_BenchmarkLevels,
+	CmdLineFlag_BenchmarkParticles,
+	CmdLineFlag_BenchmarkEntityCulling,
+	CmdLineFlag_BenchmarkSkinUpdate,
+	CmdLineFlag_BenchmarkPresentationSpawn,
+	CmdLineFlag_BenchmarkFluids,
 #endif
 	
 	CmdLineFlag_Count,
@@ -73,6 +82,14 @@ inline const char* const getCmdLineFlagName(CmdLineFlag p_flag)
 	case CmdLineFlag_SkipGPUCheck:            return "no_gpu_check";
 #if !defined(TT_BUILD_FINAL)
 	case CmdLineFlag_CompileSquirrel:         return "compile_squirrel";
+	case CmdLineFlag_PrecompileSquirrel:      return "precompile_squirrel";
+	case CmdLineFlag_Benchmark:               return "benchmark";
+	case CmdLineFlag_BenchmarkLevels:         return "benchmark_levels";
+	case CmdLineFlag_BenchmarkParticles:      return "benchmark_particles";
+	case CmdLineFlag_BenchmarkEntityCulling:  return "benchmark_entity_culling";
+	case CmdLineFlag_BenchmarkSkinUpdate:     return "benchmark_skin_update";
+	case CmdLineFlag_BenchmarkPresentationSpawn: return "benchmark_presentation_spawn";
+	case CmdLineFlag_BenchmarkFluids:         return "benchmark_fluids";
 #endif
 		
 	default:
@@ -82,6 +99,27 @@ inline const char* const getCmdLineFlagName(CmdLineFlag p_flag)
 }
 
 
+#if !defined(TT_BUILD_FINAL)
+inline CmdLineFlag getBenchmarkFlag(AppGlobal::BenchmarkMode p_mode)
+{
+	switch (p_mode)
+	{
+	case AppGlobal::BenchmarkMode_Replay:            return CmdLineFlag_Benchmark;
+	case AppGlobal::BenchmarkMode_LevelLoad:         return CmdLineFlag_BenchmarkLevels;
+	case AppGlobal::BenchmarkMode_Particles:         return CmdLineFlag_BenchmarkParticles;
+	case AppGlobal::BenchmarkMode_EntityCulling:     return CmdLineFlag_BenchmarkEntityCulling;
+	case AppGlobal::BenchmarkMode_SkinUpdate:        return CmdLineFlag_BenchmarkSkinUpdate;
+	case AppGlobal::BenchmarkMode_PresentationSpawn: return CmdLineFlag_BenchmarkPresentationSpawn;
+	case AppGlobal::BenchmarkMode_Fluids:            return CmdLineFlag_BenchmarkFluids;
+		
+	default:
+		TT_PANIC("Invalid BenchmarkMode: %d", p_mode);
+		return CmdLineFlag_Invalid;
+	}
+}
+#endif
+
+
 inline bool isAvailableInFinalBuilds(CmdLineFlag p_flag)
 {
 	return p_flag == CmdLineFlag_LevelEditorMode ||
@@ -106,6 +144,7 @@ game::script::EntityScriptMgr  AppGlobal::ms_entityScriptMgr;
 game::entity::EntityLibrary    AppGlobal::ms_entityLibrary;
 level::MetaDataGenerator       AppGlobal::ms_metaDataGenerator;
 level::TileRegistrationMgrPtr  AppGlobal::ms_tileRegistrationMgr;
+tt::thread::Mutex              AppGlobal::ms_precacheMutex;
 AppGlobal::TextureSet          AppGlobal::ms_texturePrecache;
 tt::pres::PresentationMgrPtr   AppGlobal::ms_presentationMgr;
 AppGlobal::PresentationSet     AppGlobal::ms_presentationPrecache;
@@ -222,6 +261,8 @@ game::DemoMgr& AppGlobal::getDemoMgr()
 
 void AppGlobal::clearPrecache()
 {
+	tt::thread::CriticalSection critSec(&ms_precacheMutex);
+	
 	// FIXME: ms_texturePrecache isn't required anymore since TextureCache also keeps the textures
 	tt::code::helpers::freeContainer(ms_texturePrecache);
 	tt::code::helpers::freeContainer(ms_presentationPrecache);
@@ -295,7 +336,8 @@ void AppGlobal::parseCommandLineFlags()
 	}
 	
 #if !defined(TT_BUILD_FINAL)
-	if (g_cmdLineFlags.checkFlag(CmdLineFlag_CompileSquirrel))
+	if (g_cmdLineFlags.checkFlag(CmdLineFlag_CompileSquirrel) ||
+	    g_cmdLineFlags.checkFlag(CmdLineFlag_PrecompileSquirrel))
 	{
 		tt::platform::error::turnHeadlessModeOn();
 		
@@ -304,6 +346,16 @@ void AppGlobal::parseCommandLineFlags()
 		g_cmdLineFlags.setFlag(CmdLineFlag_DisableShutdownRestore);
 	}
 	
+	if (getBenchmarkMode() != BenchmarkMode_None)
+	{
+		// Nobody is watching; log asserts instead of waiting for input and don't create a sound device.
+		tt::platform::error::turnHeadlessModeOn();
+		
+		g_cmdLineFlags.setFlag(CmdLineFlag_AudioSilentMode);
+		g_cmdLineFlags.setFlag(CmdLineFlag_DisableShutdownRestore);
+		g_cmdLineFlags.setFlag(CmdLineFlag_SkipGPUCheck);
+	}
+	
 	
 	//if (unfilteredCmdLine.exists("mission") || unfilteredCmdLine.exists("level"))
 	//{
@@ -406,11 +458,33 @@ bool AppGlobal::shouldCompileSquirrel()
 {
 	return g_cmdLineFlags.checkFlag(CmdLineFlag_CompileSquirrel);
 }
+
+
+bool AppGlobal::shouldPrecompileSquirrel()
+{
+	return g_cmdLineFlags.checkFlag(CmdLineFlag_PrecompileSquirrel);
+}
+
+
+AppGlobal::BenchmarkMode AppGlobal::getBenchmarkMode()
+{
+	for (s32 i = BenchmarkMode_None + 1; i < BenchmarkMode_Count; ++i)
+	{
+		const BenchmarkMode mode = static_cast<BenchmarkMode>(i);
+		if (g_cmdLineFlags.checkFlag(getBenchmarkFlag(mode)))
+		{
+			return mode;
+		}
+	}
+	return BenchmarkMode_None;
+}
 #endif
 
 
 void AppGlobal::addTexturesToPrecache(const tt::engine::renderer::TextureContainer& p_textures)
 {
+	tt::thread::CriticalSection critSec(&ms_precacheMutex);
+	
 #if !defined(TT_BUILD_FINAL)
 	// Add the textures individually so we know if it is a new texture. (if so add mem size to total.)
 	for (tt::engine::renderer::TextureContainer::const_iterator it = p_textures.begin();
@@ -463,11 +537,15 @@ void AppGlobal::addPresentationToPrecache(const std::string& p_filename)
 	{
 		return;
 	}
-	ms_presentationPrecache.insert(presentation);
 	
 #if !defined(TT_BUILD_FINAL)
 	tt::engine::renderer::TextureContainer textures = presentation->getAndLoadAllUsedTextures();
+#endif
+	
+	tt::thread::CriticalSection critSec(&ms_precacheMutex);
+	ms_presentationPrecache.insert(presentation);
 	
+#if !defined(TT_BUILD_FINAL)
 	for (tt::engine::renderer::TextureContainer::const_iterator it = textures.begin();
 	     it != textures.end(); ++it)
 	{
@@ -501,10 +579,18 @@ void AppGlobal::addPresentationToPrecache(const std::string& p_filename)
 
 void AppGlobal::addMovementSetToPrecache(const game::movement::MovementSetPtr& p_movementSet)
 {
+	tt::thread::CriticalSection critSec(&ms_precacheMutex);
 	ms_movementSetPrecache.insert(p_movementSet);
 }
 
 
+tt::engine::renderer::TextureContainer AppGlobal::getPrecachedTextures()
+{
+	tt::thread::CriticalSection critSec(&ms_precacheMutex);
+	return tt::engine::renderer::TextureContainer(ms_texturePrecache.begin(), ms_texturePrecache.end());
+}
+
+
 void AppGlobal::updateShoeboxTextures(const tt::engine::scene2d::shoebox::ShoeboxDataPtr& p_data,
                                       const tt::engine::scene2d::shoebox::ShoeboxDataPtr& p_skinData,
                                       const tt::engine::scene2d::shoebox::ShoeboxDataPtr& p_scriptDataOne,
@@ -9,6 +9,7 @@
 #include <tt/engine/debug/DebugStats.h>
 #include <tt/engine/debug/DebugRenderer.h>
 #include <tt/engine/glyph/GlyphSet.h>
+#include <tt/engine/particles/ParticleBenchmark.h>
 #include <tt/engine/particles/ParticleMgr.h>
 #include <tt/engine/renderer/gpu_capabilities.h>
 #include <tt/engine/renderer/FixedFunction.h>
@@ -23,11 +24,14 @@
 #include <tt/engine/scene2d/shoebox/shoebox.h>
 #include <tt/fs/MemoryArchive.h>
 #include <tt/fs/MemoryFileSystem.h>
+#include <tt/fs/PackArchive.h>
 #include <tt/mem/Heap.h>
 #include <tt/mem/mem.h>
 #include <tt/platform/tt_error.h>
 #include <tt/platform/tt_printf.h>
+#include <tt/pres/PresentationBenchmark.h>
 #include <tt/pres/PresentationCache.h>
+#include <tt/snd/snd.h>
 #include <tt/stats/stats.h>
 #if defined(TT_STEAM_BUILD)
 #include <tt/steam/Leaderboards.h>
@@ -37,16 +41,23 @@
 
 #include <toki/audio/AudioPlayer.h>
 #include <toki/game/editor/helpers.h>
+#include <toki/game/entity/EntityCullingBenchmark.h>
 #include <toki/game/entity/EntityMgr.h>
 #include <toki/game/event/EventMgr.h>
+#include <toki/game/fluid/FluidBenchmark.h>
 #include <toki/game/light/LightMgr.h>
+#include <toki/game/script/EntityScriptMgr.h>
 #include <toki/game/CheckPointMgr.h>
 #include <toki/game/Game.h>
 #include <toki/input/Recorder.h>
+#include <toki/input/ReplayBenchmark.h>
 #include <toki/level/LevelData.h>
+#include <toki/level/LevelLoadBenchmark.h>
+#include <toki/level/SkinUpdateBenchmark.h>
 #include <toki/loc/Loc.h>
 #include <toki/main/AppStateMachine.h>
 #include <toki/pres/PresentationObjectMgr.h>
+#include <toki/pres/TriggerFactory.h>
 #include <toki/savedata/utils.h>
 #include <toki/script/ScriptMgr.h>
 #include <toki/statelist/statelist.h>
@@ -144,6 +155,27 @@ inline void debugTextWithShadow(const tt::engine::debug::DebugRendererPtr& p_deb
 	debugTextWithShadow(p_debug, p_text, p_x, p_y, g_debugColor);
 }
 
+
+/*! \brief Runs one of the benchmarks that don't need a running game. */
+static bool runBenchmark(AppGlobal::BenchmarkMode p_mode)
+{
+	const tt::args::CmdLine& cmdLine(tt::app::getCmdLine());
+	switch (p_mode)
+	{
+	case AppGlobal::BenchmarkMode_LevelLoad:     return level::LevelLoadBenchmark::run(cmdLine);
+	case AppGlobal::BenchmarkMode_Particles:     return tt::engine::particles::ParticleBenchmark::run(cmdLine);
+	case AppGlobal::BenchmarkMode_EntityCulling: return game::entity::EntityCullingBenchmark::run(cmdLine);
+	case AppGlobal::BenchmarkMode_SkinUpdate:    return level::SkinUpdateBenchmark::run(cmdLine);
+	case AppGlobal::BenchmarkMode_PresentationSpawn:
+		return tt::pres::PresentationBenchmark::run(cmdLine,
+			tt::pres::TriggerFactoryInterfacePtr(new toki::pres::TriggerFactory));
+		
+	default:
+		TT_PANIC("Benchmark mode %d needs a running game.", p_mode);
+		return false;
+	}
+}
+
 #endif  // !defined(TT_BUILD_FINAL)
 
 
@@ -221,6 +253,7 @@ AppMain::AppMain()
 :
 m_stateMachine(0),
 m_archive(),
+m_packArchive(),
 m_cachedShaders(),
 m_badPerfTime(0.0f),
 m_badPerfUpdateCount(0)
@@ -235,7 +268,9 @@ m_showFps(false)
 #endif
 #if !defined(TT_BUILD_FINAL)
 ,
-m_enableMemoryBudgetWarning(false)
+m_enableMemoryBudgetWarning(false),
+m_replayBenchmark(),
+m_fluidBenchmark()
 #endif
 {
 	// NOTE: Do not use lib functions here, they are not initialized when this is constructed.
@@ -318,6 +353,10 @@ AppMain::~AppMain()
 	{
 		tt::fs::MemoryFileSystem::removeMemoryArchive(m_archive.get());
 	}
+	if (m_packArchive != 0)
+	{
+		tt::fs::MemoryFileSystem::removePackArchive(m_packArchive.get());
+	}
 	
 	AppOptions::destroyInstance();
 }
@@ -353,9 +392,28 @@ bool AppMain::init()
 		}
 	}
 	
-	// Load memory archive
+	// Load memory archive. A pack archive is only mapped (files are read when they are opened),
+	// so it is preferred over loading a whole memory archive.
+	const std::string packArchivePath("archive.pack");
 	const std::string archivePath("archive.ma");
-	if (tt::fs::fileExists(archivePath))
+	if (tt::fs::fileExists(packArchivePath))
+	{
+#if !defined(TT_BUILD_FINAL)
+		const u64 loadStart = tt::system::Time::getInstance()->getMilliSeconds();
+#endif
+		m_packArchive = tt::fs::PackArchive::load(packArchivePath);
+		if (m_packArchive != 0)
+		{
+			tt::fs::MemoryFileSystem::addPackArchive(m_packArchive.get());
+		}
+#if !defined(TT_BUILD_FINAL)
+		const u64 loadEnd   = tt::system::Time::getInstance()->getMilliSeconds();
+		const u32 totalTime = u32(loadEnd - loadStart);
+		TT_Printf("AppMain::init: Pack archive '%s' (%d files) mapped in %u ms\n",
+		          packArchivePath.c_str(), (m_packArchive != 0) ? m_packArchive->getFileCount() : 0, totalTime);
+#endif
+	}
+	else if (tt::fs::fileExists(archivePath))
 	{
 #if !defined(TT_BUILD_FINAL)
 		const u64 loadStart = tt::system::Time::getInstance()->getMilliSeconds();
@@ -430,6 +488,34 @@ bool AppMain::init()
 	
 	AppGlobal::createInputRecorder();
 	
+#if !defined(TT_BUILD_FINAL)
+	switch (AppGlobal::getBenchmarkMode())
+	{
+	case AppGlobal::BenchmarkMode_None:
+		break;
+		
+	case AppGlobal::BenchmarkMode_Replay:
+		// Runs alongside the game; see update()
+		m_replayBenchmark = input::ReplayBenchmark::create(tt::app::getCmdLine());
+		if (m_replayBenchmark == 0)
+		{
+			return false;
+		}
+		break;
+		
+	case AppGlobal::BenchmarkMode_Fluids:
+		// Runs once the game has loaded its level; see update()
+		m_fluidBenchmark = game::fluid::FluidBenchmark::create(tt::app::getCmdLine());
+		break;
+		
+	default:
+		// The other benchmarks only measure one part of the game; quit before the game starts.
+		runBenchmark(AppGlobal::getBenchmarkMode());
+		tt::app::getApplication()->terminate(true);
+		break;
+	}
+#endif
+	
 	initializePostProcessing();
 	
 	AppOptions::getInstance().setBlurQualityInGame();
@@ -551,6 +637,20 @@ void AppMain::update(real p_elapsedTime)
 			TT_NULL_ASSERT(m_stateMachine);
 			m_stateMachine->update(p_elapsedTime);
 			
+#if !defined(TT_BUILD_FINAL)
+			if (m_replayBenchmark != 0 && m_replayBenchmark->update() == false)
+			{
+				// Playback is done (or failed to start); nothing left to measure.
+				m_replayBenchmark.reset();
+				tt::app::getApplication()->terminate(true);
+			}
+			if (m_fluidBenchmark != 0 && m_fluidBenchmark->update() == false)
+			{
+				m_fluidBenchmark.reset();
+				tt::app::getApplication()->terminate(true);
+			}
+#endif
+			
 			AppGlobal::getController(tt::input::ControllerIndex_One).clearPlatformState();
 			
 #if ENABLE_DEBUG_INFO
@@ -1107,12 +1207,17 @@ void AppMain::renderDebugInfo(s32, u64 p_renderTime)
 			const tt::str::Strings audioCues(audio::AudioPlayer::hasInstance() ?
 						tt::str::explode(audio::AudioPlayer::getInstance()->getDebugPositionalSoundNames(), "\n") :
 						tt::str::Strings());
+			const tt::str::Strings streamInfo(tt::snd::hasSoundSystem(0) ?
+						tt::str::explode(tt::snd::getDebugStreamInfo(0), "\n") :
+						tt::str::Strings());
 			const tt::str::Strings culledInfo(tt::str::explode(entityMgr.getDebugCulledInfo(), "\n"));
 			const tt::str::Strings unculledInfo(tt::str::explode(entityMgr.getDebugUnculledInfo(), "\n"));
 			const tt::str::Strings particleEffects(tt::engine::particles::ParticleMgr::hasInstance() ?
 						tt::str::explode(tt::engine::particles::ParticleMgr::getInstance()->getDebugParticleNames(), "\n") :
 						tt::str::Strings());
 			const tt::str::Strings scriptTimings(tt::str::explode(entityMgr.getDebugTimings(), "\n"));
+			const tt::str::Strings callbackTimings(
+						tt::str::explode(AppGlobal::getEntityScriptMgr().getDebugCallbackTimings(), "\n"));
 			
 			const s32 startY = y;
 			for (tt::str::Strings::const_iterator it = unculledInfo.begin(); it != unculledInfo.end(); ++it)
@@ -1132,6 +1237,11 @@ void AppMain::renderDebugInfo(s32, u64 p_renderTime)
 				debugTextWithShadow(debug, *it, x + 400, y);
 				y += lineHeight;
 			}
+			for (tt::str::Strings::const_iterator it = streamInfo.begin(); it != streamInfo.end(); ++it)
+			{
+				debugTextWithShadow(debug, *it, x + 400, y);
+				y += lineHeight;
+			}
 			y = startY;
 			for (tt::str::Strings::const_iterator it = particleEffects.begin(); it != particleEffects.end(); ++it)
 			{
@@ -1144,6 +1254,12 @@ void AppMain::renderDebugInfo(s32, u64 p_renderTime)
 				debugTextWithShadow(debug, *it, x + 800, y);
 				y += lineHeight;
 			}
+			y = startY;
+			for (tt::str::Strings::const_iterator it = callbackTimings.begin(); it != callbackTimings.end(); ++it)
+			{
+				debugTextWithShadow(debug, *it, x + 1100, y);
+				y += lineHeight;
+			}
 		}
 	}
 	
@@ -34,8 +34,8 @@ CheckPointMgrPtr CheckPointMgr::create(u32 p_sizeLimitCheckpoints)
 }
 
 
-void CheckPointMgr::setCheckPoint(const serialization::SerializationMgrPtr& p_checkPointData,
-                                  const std::string&                        p_id)
+tt::code::BufferPtr CheckPointMgr::setCheckPoint(const serialization::SerializationMgrPtr& p_checkPointData,
+                                                 const std::string&                        p_id)
 {
 	// Check if checkpoint with this ID already exists
 	CheckPoints::iterator existingCheckpointIt = m_checkPoints.find(p_id);
@@ -45,13 +45,14 @@ void CheckPointMgr::setCheckPoint(const serialization::SerializationMgrPtr& p_ch
 		TT_PANIC("setCheckPointData called for checkpoint '%s' while CheckPointMgr is at its size limit."
 		         "Total size %d, size limit %d. Please remove checkpoint(s).", 
 		         p_id.c_str(), m_totalSize, m_sizeLimitCheckpoints);
-		return;
+		return tt::code::BufferPtr();
 	}
 	
+	tt::code::BufferPtr compressedPtr;
 	TT_NULL_ASSERT(p_checkPointData);
 	if (p_checkPointData != 0)
 	{
-		tt::code::BufferPtr compressedPtr = p_checkPointData->compress();
+		compressedPtr = p_checkPointData->compress();
 		TT_NULL_ASSERT(compressedPtr);
 		if (compressedPtr != 0)
 		{
@@ -82,6 +83,8 @@ void CheckPointMgr::setCheckPoint(const serialization::SerializationMgrPtr& p_ch
 				m_checkPoints.size(), static_cast<s32>(m_sizeLimitCheckpoints - m_totalSize) / 1024);
 		}
 	}
+	
+	return compressedPtr;
 }
 
 
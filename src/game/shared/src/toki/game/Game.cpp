@@ -165,6 +165,8 @@ m_lightMgr(),
 m_darknessMgr(),
 m_stopLightRenderingOnSplit(true),
 m_pathMgr(),
+m_lightPathGraph(),
+m_lightPathDeltaTime(0.0f),
 m_colorGradingEffectMgr(new entity::effect::ColorGradingEffectMgr),
 m_fogEffectMgr(new entity::effect::FogEffectMgr),
 m_presentationObjectMgr(),
@@ -186,6 +188,8 @@ m_serializationAction(SerializationAction_None),
 m_serializationID(),
 m_serializationProgressType(ProgressType_Invalid),
 m_serializationRemoveAfterUnserialize(false),
+m_rewindCheckPointsBack(0),
+m_rewindBuffer(),
 m_updateSectionProfiler("Game - update"),
 m_updateForRenderSectionProfiler("Game - update for render"),
 #if ENABLE_RENDER_SECTIONS
@@ -215,6 +219,16 @@ m_debugFOVDelta(0.0f)
 	// Passing dummy level size. Will get resized on level change.
 	m_levelSkinContext = level::skin::SkinContext::create(1, 1);
 	
+	// Independent parts of Game::update, run by the JobSystem
+	m_lightPathGraph.addJob([this]()
+		{
+			if (m_lightMgr != 0)
+			{
+				m_lightMgr->update(m_lightPathDeltaTime);
+			}
+		});
+	m_lightPathGraph.addJob([this]() { m_pathMgr.update(m_lightPathDeltaTime); });
+	
 #ifdef USE_SHOEBOX_THREADING
 	// Start shoebox thread
 	m_shoeboxThread = tt::thread::create(
@@ -248,6 +262,9 @@ Game::~Game()
 	g_scriptButtons.clear();
 	
 	m_colorGrading.reset();
+	
+	// Don't keep the includes of this level alive while nothing uses them.
+	tt::engine::scene2d::shoebox::ShoeboxData::clearIncludeCache();
 }
 
 
@@ -269,6 +286,7 @@ void Game::init(const StartInfo& p_startInfo, ProgressType p_progressTypeOverrid
 	
 	m_progressTypeOverride = p_progressTypeOverride;
 	m_serializationAction = SerializationAction_None;
+	m_rewindBuffer.clear();
 	
 	// Level has changed, notify recorder
 	input::RecorderPtr recorder(AppGlobal::getInputRecorder());
@@ -526,6 +544,23 @@ void Game::update(real p_deltaTime)
 			m_serializationRemoveAfterUnserialize = false;
 		}
 	}
+	else if (m_serializationAction == SerializationAction_Rewind &&
+	         isEditorOpen() == false)
+	{
+		std::string id;
+		serialization::SerializationMgrPtr checkPoint(m_rewindBuffer.rewind(m_rewindCheckPointsBack, &id));
+		if (checkPoint == 0)
+		{
+			TT_PANIC("Trying to rewind Game %d checkpoints back, but only %d are available.",
+			         m_rewindCheckPointsBack, m_rewindBuffer.getCount());
+		}
+		else
+		{
+			m_serializationID = id;
+			unserializeAll(*checkPoint, m_serializationID);
+		}
+		m_serializationAction = SerializationAction_None;
+	}
 	
 	m_updateSectionProfiler.startFrameUpdateSection(FrameUpdateSection_Misc);
 	
@@ -904,14 +939,12 @@ void Game::update(real p_deltaTime)
 			m_fluidMgr->update(p_deltaTime);
 		}
 		
+		// The light and path updates don't share any data, so they run next to each other.
+		// (The fluid update above stays on this thread: it calls into the entity scripts and
+		//  spawns effects and sounds.) The LightMgr section times both of them.
 		m_updateSectionProfiler.startFrameUpdateSection(FrameUpdateSection_LightMgr);
-		if (m_lightMgr != 0)
-		{
-			m_lightMgr->update(p_deltaTime);
-		}
-		
-		m_updateSectionProfiler.startFrameUpdateSection(FrameUpdateSection_PathMgr);
-		m_pathMgr.update(p_deltaTime);
+		m_lightPathDeltaTime = p_deltaTime;
+		m_lightPathGraph.run();
 		
 		m_updateSectionProfiler.startFrameUpdateSection(FrameUpdateSection_Misc);
 		
@@ -1022,11 +1055,11 @@ void Game::update(real p_deltaTime)
 #if !defined(TT_BUILD_FINAL)
 			if (AppGlobal::allowLevelCreatorDebugFeaturesInGame())
 			{
-				static const entity::EntityHandleSet empty;
-				const entity::EntityHandleSet& foundEntities = (getTileRegistrationMgr().contains(tilePos)) ?
-						getTileRegistrationMgr().getRegisteredEntityHandles(tilePos) : empty;
+				// Copy the handles; killing an entity changes the registration
+				entity::EntityHandles foundEntities;
+				getTileRegistrationMgr().findRegisteredEntityHandles(tilePos, foundEntities);
 				
-				for (entity::EntityHandleSet::const_iterator it = foundEntities.begin(); it != foundEntities.end(); ++it)
+				for (entity::EntityHandles::const_iterator it = foundEntities.begin(); it != foundEntities.end(); ++it)
 				{
 					entity::Entity* entity = m_entityMgr->getEntity(*it);
 					if (entity != 0)
@@ -1325,7 +1358,10 @@ void Game::update(real p_deltaTime)
 			newCheckPoint = serialization::SerializationMgr::createEmpty();
 		}
 		serializeAll(*newCheckPoint);
-		getCheckPointMgr().setCheckPoint(newCheckPoint, m_serializationID);
+		const tt::code::BufferPtr compressed(getCheckPointMgr().setCheckPoint(newCheckPoint, m_serializationID));
+		
+		// The rewind buffer keeps this checkpoint and hands back the one it stopped using, if any
+		newCheckPoint = m_rewindBuffer.push(newCheckPoint, compressed, m_serializationID);
 		m_serializationAction = SerializationAction_None;
 	}
 	
@@ -1925,7 +1961,7 @@ void Game::handleLevelBackgroundPicked()
 	}
 	
 	loadUserLevelShoeboxData();
-	createShoeboxesFromDataInclSkin();
+	updateShoeboxesFromDataInclSkin(); // Tiles didn't change; the skin planes are reused as is
 	
 	m_levelBackgroundOnEditorOpen = m_levelData->getLevelBackground();
 }
@@ -1982,8 +2018,8 @@ void Game::onEditorClosed(bool p_restartLevel)
 	}
 	
 	// We need to regenerate level skin because tiles might have changed.
-	// but we can't only reset that part of the shoebox.
-	// So we'll have to recreate the whole shoebox.
+	// Only the skin planes around the changed tiles are regenerated, but we can't only reset that part
+	// of the shoebox. So we'll have to recreate the whole shoebox from the data.
 	// We can restore blur layers, but not any tags stared/stopped/hidden/etc.
 	callOnProgressRestoredOnAllEntities("editor");
 	
@@ -1999,7 +2035,7 @@ void Game::onEditorClosed(bool p_restartLevel)
 	TT_NULL_ASSERT(m_levelAttributeLayerOnEditorOpen);
 	if (m_levelData->getAttributeLayer()->equals(m_levelAttributeLayerOnEditorOpen) == false)
 	{
-		createShoeboxesFromDataInclSkin();
+		updateShoeboxesFromDataInclSkin();
 		buildPathFindingData();
 	}
 	
@@ -2530,6 +2566,16 @@ void Game::unserializeGameState(const std::string& p_id, bool p_removeCheckpoint
 }
 
 
+void Game::rewindGameState(s32 p_checkPointsBack)
+{
+	TT_WARNING(m_serializationAction == SerializationAction_None,
+			"Serialization action '%d' already pending. Overwriting.", m_serializationAction);
+	
+	m_serializationAction   = SerializationAction_Rewind;
+	m_rewindCheckPointsBack = p_checkPointsBack;
+}
+
+
 void Game::queueShoeboxTagEvent(const std::string& p_tag, const std::string& p_event, const std::string& p_param)
 {
 	ShoeboxTagEvent tagEvent;
@@ -2832,6 +2878,9 @@ void Game::loadLevelData(const std::string& p_filename)
 		tt::str::replace(filename, ".ttlvl", ".tokilevel");
 	}
 	
+	// Parsed includes are only shared within one level; this also picks up changed include files.
+	tt::engine::scene2d::shoebox::ShoeboxData::clearIncludeCache();
+	
 	m_levelData = level::LevelData::loadLevel(filename);
 	TT_Printf("Game::loadLevelData: Level data %s (level filename: '%s').\n",
 	          (m_levelData != 0) ? "loaded successfully" : "load FAILED", filename.c_str());
@@ -3041,6 +3090,35 @@ void Game::createShoeboxesFromDataInclSkin()
 	m_shoeboxDataLevelSkin = generateLevelSkinData();
 	TT_NULL_ASSERT(m_shoeboxDataLevelSkin);
 	
+	createShoeboxesFromData();
+}
+
+
+void Game::updateShoeboxesFromDataInclSkin()
+{
+	if (m_shoeboxDataLevelSkin == 0)
+	{
+		createShoeboxesFromDataInclSkin();
+		return;
+	}
+	
+	TT_NULL_ASSERT(m_levelSkinContext);
+	TT_NULL_ASSERT(m_levelData);
+	
+	// Only regenerate the skin planes around the changed tiles
+	level::skin::updateSkinShoebox(
+			m_levelSkinContext,
+			m_levelData,
+			m_levelData->getLevelTheme(),
+			m_levelOverriddenThemeTiles,
+			m_shoeboxDataLevelSkin.get());
+	
+	createShoeboxesFromData();
+}
+
+
+void Game::createShoeboxesFromData()
+{
 	using tt::engine::renderer::EngineIDToTextures;
 	const EngineIDToTextures previousTextures(createEmptyShoeboxesWithPreviousSettings());
 	
@@ -3062,7 +3140,7 @@ void Game::createShoeboxesFromDataInclSkin()
 		
 #if !defined(TT_BUILD_FINAL)
 		const u64 duration = tt::system::Time::getInstance()->getMilliSeconds() - startTime;
-		TT_Printf("Game::createShoeboxesFromDataInclSkin shoebox creation duration: %u ms\n", static_cast<u32>(duration));
+		TT_Printf("Game::createShoeboxesFromData shoebox creation duration: %u ms\n", static_cast<u32>(duration));
 		
 		EngineIDToTextures texUsedNow(m_shoeboxSkinAndEnvironment->getAllUsedTextures(true));
 		
@@ -3727,8 +3805,9 @@ void Game::reloadGame(bool p_entitiesOnly, bool p_restoreFollowEntityPosition)
 	// Recreate the entities
 	createLevelEntities(followEntityID, followEntityPos, true);
 	
-	// generate new level skin data and recreate shoebox.
-	createShoeboxesFromDataInclSkin();
+	// Update the level skin data and recreate shoebox. After a full reload the skin context was reset
+	// above (the skin config was reloaded too), so that generates the whole skin again.
+	updateShoeboxesFromDataInclSkin();
 	
 	if (p_entitiesOnly == false)
 	{
@@ -4157,7 +4236,9 @@ void Game::unserializeAll(const toki::serialization::SerializationMgr& p_seriali
 		callOnProgressRestoredOnAllEntities(p_serializationID);
 	}
 	
-	createShoeboxesFromDataInclSkin();
+	// Restoring a checkpoint (also when rewinding) mostly leaves the tiles as they were,
+	// so only the skin planes around changed tiles need to be regenerated.
+	updateShoeboxesFromDataInclSkin();
 	
 	if (shouldResetAudioPlayerLoadingFlag)
 	{
@@ -7,6 +7,7 @@
 #include <tt/engine/renderer/Texture.h>
 #include <tt/engine/renderer/ViewPort.h>
 #include <tt/platform/tt_printf.h>
+#include <tt/profiler/TraceRecorder.h>
 #include <tt/thread/CriticalSection.h>
 #include <tt/thread/thread.h>
 
@@ -314,6 +315,7 @@ tt::code::StateID StateLoadGame::getPathToState(tt::code::StateID p_targetState)
 
 int StateLoadGame::staticGameLoadThread(void* p_arg)
 {
+	tt::profiler::TraceRecorder::setThreadName("Game Load Thread");
 	StateLoadGame* state = reinterpret_cast<StateLoadGame*>(p_arg);
 	state->gameLoadThread();
 	return 0;
@@ -367,7 +369,10 @@ void StateLoadGame::gameLoadThread()
 	}
 	
 	AppGlobal::setNextLevelOverrideProgressType(ProgressType_Invalid);
-	g->init(startInfo, overrideProgressType);
+	{
+		TT_TRACE_SCOPE("Game::init");
+		g->init(startInfo, overrideProgressType);
+	}
 	
 	{
 #if STATELOADGAME_THREADED_LOADING
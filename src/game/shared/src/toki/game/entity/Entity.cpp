@@ -18,6 +18,7 @@
 #include <toki/game/entity/sensor/SensorMgr.h>
 #include <toki/game/entity/sensor/Shape.h>
 #include <toki/game/entity/Entity.h>
+#include <toki/game/entity/EntityCullingData.h>
 #include <toki/game/entity/EntityMgr.h>
 #include <toki/game/entity/EntityTiles.h>
 #include <toki/game/event/Event.h>
@@ -1567,6 +1568,7 @@ void Entity::makeScreenSpaceEntity()
 	
 	m_inScreenspace = true;
 	m_updateSurvey  = false;
+	updateCullingData();
 	
 	// Disable as many 'world' things as we can (e.g. Don't register tiles.)
 	disableTileRegistration();
@@ -1821,6 +1823,7 @@ void Entity::updateRects(const tt::math::PointRect* p_moveToTileRect)
 	m_registeredTileRect = calcRegisteredTileRect();
 	
 	m_worldRect = calcWorldRect();
+	updateCullingData();
 	
 	if (prevTileRect != m_registeredTileRect || p_moveToTileRect != 0)
 	{
@@ -2992,10 +2995,10 @@ void Entity::makeSurroundingEntitiesScheduleReevaluateCollisionParent()
 	const tt::math::PointRect tilesToCheck(ownTilesRect.getMin()       - tt::math::Point2(1, 1),
 	                                       ownTilesRect.getMaxInside() + tt::math::Point2(1, 1));
 	
-	EntityHandleSet entities;
+	EntityHandles entities;
 	AppGlobal::getGame()->getTileRegistrationMgr().findRegisteredEntityHandles(tilesToCheck, entities);
 	
-	for (EntityHandleSet::iterator it = entities.begin(); it != entities.end(); ++it)
+	for (EntityHandles::iterator it = entities.begin(); it != entities.end(); ++it)
 	{
 		if (*it == getHandle())
 		{
@@ -3053,10 +3056,10 @@ void Entity::onPotentialCollisionParentStartsMove(const EntityHandle& p_caller)
 			const tt::math::PointRect tilesToCheck(ownTilesRect.getMin()       - tt::math::Point2(1, 1),
 			                                       ownTilesRect.getMaxInside() + tt::math::Point2(1, 1));
 			
-			EntityHandleSet entities;
+			EntityHandles entities;
 			AppGlobal::getGame()->getTileRegistrationMgr().findRegisteredEntityHandles(tilesToCheck, entities);
 			
-			for (EntityHandleSet::iterator it = entities.begin(); it != entities.end(); ++it)
+			for (EntityHandles::iterator it = entities.begin(); it != entities.end(); ++it)
 			{
 				if (*it == getHandle() || *it == p_caller)
 				{
@@ -3269,6 +3272,7 @@ m_lightDetectionPoints(),
 m_touchShape(),
 m_touchShapeOffset(tt::math::Vector2::zero),
 m_positionCullingParent(EntityHandle()),
+m_cullingData(0),
 m_collisionTiles(),
 m_collisionTilesRegdRect(),
 m_collisionTileOffset(tt::math::Point2::zero),
@@ -3343,6 +3347,7 @@ void Entity::initPositionCulling(const tt::math::VectorRect& p_cullingRect)
 	setPositionCulled(m_isPositionCulled);
 	
 	m_positionCullingInitialized = true;
+	updateCullingData();
 }
 
 
@@ -3405,16 +3410,14 @@ void Entity::updatePositionCulling(const tt::math::VectorRect& p_cullingRect,
 	}
 }
 
-static const std::string g_onScreenEnter("onScreenEnter");
-static const std::string g_onScreenExit("onScreenExit");
-
 void Entity::updateIsOnScreen(const tt::math::VectorRect& p_screenRect)
 {
 	const bool isOnScreen = m_worldRect.intersects(p_screenRect);
 	if (m_isOnScreen != isOnScreen)
 	{
-		m_entityScript->queueSqFun(isOnScreen ? g_onScreenEnter : g_onScreenExit);
+		m_entityScript->queueSqFun(isOnScreen ? script::EntityCallback_OnScreenEnter : script::EntityCallback_OnScreenExit);
 		m_isOnScreen = isOnScreen;
+		updateCullingData();
 	}
 }
 
@@ -3541,6 +3544,8 @@ void Entity::deinit()
 	
 	level::TileRegistrationMgr& tileMgr(AppGlobal::getGame()->getTileRegistrationMgr());
 	tileMgr.unregisterEntityHandle(m_registeredTileRect, m_handle);
+	
+	updateCullingData();
 }
 
 
@@ -4169,7 +4174,7 @@ void Entity::setPositionCulled(bool p_isCulled)
 	
 	if (p_isCulled)
 	{
-		m_entityScript->queueSqFun("onCulled");
+		m_entityScript->queueSqFun(script::EntityCallback_OnCulled);
 		
 		// Cull timers
 		script::TimerMgr::suspendAllTimers(m_handle);
@@ -4189,7 +4194,7 @@ void Entity::setPositionCulled(bool p_isCulled)
 	}
 	else
 	{
-		m_entityScript->queueSqFun("onUnculled");
+		m_entityScript->queueSqFun(script::EntityCallback_OnUnculled);
 		
 		// Uncull timers
 		script::TimerMgr::resumeAllTimers(m_handle);
@@ -4207,6 +4212,23 @@ void Entity::setPositionCulled(bool p_isCulled)
 	}
 	
 	m_isPositionCulled = p_isCulled;
+	updateCullingData();
+}
+
+
+void Entity::setCullingData(EntityCullingData* p_cullingData)
+{
+	m_cullingData = p_cullingData;
+	updateCullingData();
+}
+
+
+void Entity::updateCullingData() const
+{
+	if (m_cullingData != 0)
+	{
+		m_cullingData->update(*this);
+	}
 }
 
 // Namespace end
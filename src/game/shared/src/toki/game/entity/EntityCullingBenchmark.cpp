@@ -0,0 +1,484 @@
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include <json/json.h>
+
+#include <tt/math/Random.h>
+#include <tt/math/Rect.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+#include <tt/profiler/Benchmark.h>
+
+#include <toki/game/entity/Entity.h>
+#include <toki/game/entity/EntityCullingBenchmark.h>
+#include <toki/game/entity/EntityCullingData.h>
+
+
+namespace toki {
+namespace game {
+namespace entity {
+
+//--------------------------------------------------------------------------------------------------
+// Helper functions
+
+static const real g_levelWidth        = 2000.0f;
+static const real g_levelHeight       =  200.0f;
+static const real g_cullingWidth      =   80.0f;
+static const real g_cullingHeight     =   45.0f;
+static const real g_uncullingWidth    =   64.0f;
+static const real g_uncullingHeight   =   36.0f;
+static const real g_moveDistance      =    0.5f;
+static const s32  g_movingEntityRatio =   10; // Every frame one in this many entities moves
+
+static const size_t g_evictionBufferSize = 32 * 1024 * 1024;
+
+
+/*! \brief The fields of Entity that the culling passes use, mirroring its culling logic. */
+struct BenchmarkEntity
+{
+	BenchmarkEntity()
+	:
+	worldRect(),
+	cullingParent(-1),
+	initialized(true),
+	inScreenspace(false),
+	cullingEnabled(true),
+	cullingInitialized(false),
+	culled(false),
+	onScreen(false)
+	{ }
+	
+	tt::math::VectorRect worldRect;
+	s32                  cullingParent; // Index of the culling parent, -1 for none
+	bool                 initialized;
+	bool                 inScreenspace;
+	bool                 cullingEnabled;
+	bool                 cullingInitialized;
+	bool                 culled;
+	bool                 onScreen;
+};
+typedef std::vector<BenchmarkEntity> BenchmarkEntities;
+
+
+/*! \brief Entities laid out with the stride of Entity, like in the entity array of EntityMgr. */
+class StridedEntities
+{
+public:
+	explicit StridedEntities(const BenchmarkEntities& p_entities)
+	:
+	m_storage(p_entities.size() * sizeof(Entity)),
+	m_count(static_cast<s32>(p_entities.size()))
+	{
+		assign(p_entities);
+	}
+	
+	void assign(const BenchmarkEntities& p_entities)
+	{
+		TT_ASSERT(static_cast<s32>(p_entities.size()) == m_count);
+		for (s32 i = 0; i < m_count; ++i)
+		{
+			new (getStoragePtr(i)) BenchmarkEntity(p_entities[i]);
+		}
+	}
+	
+	inline BenchmarkEntity& operator[](s32 p_index)
+	{ return *reinterpret_cast<BenchmarkEntity*>(getStoragePtr(p_index)); }
+	
+	inline s32 getCount() const { return m_count; }
+	
+private:
+	inline u8* getStoragePtr(s32 p_index)
+	{
+		TT_ASSERT(p_index >= 0 && p_index < m_count);
+		return &m_storage[static_cast<size_t>(p_index) * sizeof(Entity)];
+	}
+	
+	std::vector<u8> m_storage;
+	s32             m_count;
+};
+
+
+struct RunStats
+{
+	RunStats() : times(), moves(0), changes(0) { }
+	
+	tt::profiler::Benchmark::Stats times; // One iteration of all frames
+	u64 moves;   // microseconds, moving the entities (not part of the times)
+	s32 changes; // culled and on screen changes (script callbacks) in the last run
+};
+
+
+static Json::Value getStatsNode(const RunStats& p_stats, s32 p_iterations, s32 p_frames)
+{
+	using tt::profiler::Benchmark;
+	Json::Value node(p_stats.times.toJson());
+	node["avgFrameMs"] = Benchmark::toMilliSeconds(p_stats.times.total) / (p_iterations * p_frames);
+	node["avgMoveMs" ] = Benchmark::toMilliSeconds(p_stats.moves)       / (p_iterations * p_frames);
+	node["changes"   ] = p_stats.changes;
+	return node;
+}
+
+
+static BenchmarkEntities createEntities(s32 p_count)
+{
+	tt::math::Random random(1);
+	
+	BenchmarkEntities entities(static_cast<BenchmarkEntities::size_type>(p_count));
+	for (s32 i = 0; i < p_count; ++i)
+	{
+		BenchmarkEntity& entity(entities[i]);
+		const tt::math::Vector2 pos(random.getNextReal(0.0f, g_levelWidth), random.getNextReal(0.0f, g_levelHeight));
+		entity.worldRect      = tt::math::VectorRect(pos, random.getNextReal(1.0f, 4.0f), random.getNextReal(1.0f, 4.0f));
+		entity.initialized    = (i % 50)  != 0;
+		entity.inScreenspace  = (i % 100) == 1;
+		entity.cullingEnabled = (i % 20)  != 0;
+		
+		// One in ten has a culling parent, which itself has none
+		if (i % 10 == 5)
+		{
+			entity.cullingParent = i - 5;
+		}
+	}
+	return entities;
+}
+
+
+/*! \brief Writes a buffer larger than the caches, like the rest of a game frame pushes the entities
+           out of the caches. */
+static void evict(std::vector<u8>& p_buffer)
+{
+	for (size_t i = 0; i < p_buffer.size(); i += 64)
+	{
+		++p_buffer[i];
+	}
+}
+
+
+static tt::math::VectorRect getCameraRect(s32 p_frame, s32 p_frameCount, real p_width, real p_height)
+{
+	const real x = g_levelWidth * static_cast<real>(p_frame) / static_cast<real>(p_frameCount);
+	const real y = g_levelHeight * 0.5f;
+	return tt::math::VectorRect(tt::math::Vector2(x - p_width * 0.5f, y - p_height * 0.5f), p_width, p_height);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Entity logic (see Entity::initPositionCulling, updatePositionCulling and updateIsOnScreen)
+
+static void setCulled(BenchmarkEntity& p_entity, bool p_culled, s32& p_changes)
+{
+	if (p_entity.culled == p_culled && p_entity.cullingInitialized)
+	{
+		return;
+	}
+	p_entity.culled = p_culled;
+	++p_changes;
+}
+
+
+static void initCulling(BenchmarkEntity& p_entity, const BenchmarkEntity* p_parent,
+                        const tt::math::VectorRect& p_cullingRect, s32& p_changes)
+{
+	bool culled = false;
+	p_entity.cullingInitialized = false;
+	
+	if (p_entity.inScreenspace == false)
+	{
+		if (p_parent != 0)
+		{
+			if (p_parent->cullingEnabled)
+			{
+				culled = p_parent->culled;
+			}
+		}
+		else if (p_entity.cullingEnabled && p_entity.worldRect.intersects(p_cullingRect) == false)
+		{
+			culled = true;
+		}
+	}
+	
+	setCulled(p_entity, culled, p_changes);
+	p_entity.cullingInitialized = true;
+}
+
+
+static void updateCulling(BenchmarkEntity& p_entity, const BenchmarkEntity* p_parent,
+                          const tt::math::VectorRect& p_cullingRect, const tt::math::VectorRect& p_uncullingRect,
+                          s32& p_changes)
+{
+	if (p_entity.cullingInitialized == false)
+	{
+		initCulling(p_entity, p_parent, p_cullingRect, p_changes);
+		return;
+	}
+	
+	if (p_entity.inScreenspace)
+	{
+		return;
+	}
+	
+	if (p_parent != 0)
+	{
+		if (p_parent->cullingEnabled && p_parent->culled != p_entity.culled)
+		{
+			setCulled(p_entity, p_parent->culled, p_changes);
+		}
+		return;
+	}
+	
+	if (p_entity.cullingEnabled == false)
+	{
+		return;
+	}
+	
+	if (p_entity.culled)
+	{
+		if (p_entity.worldRect.intersects(p_uncullingRect))
+		{
+			setCulled(p_entity, false, p_changes);
+		}
+	}
+	else if (p_entity.worldRect.intersects(p_cullingRect) == false)
+	{
+		setCulled(p_entity, true, p_changes);
+	}
+}
+
+
+static void updateOnScreen(BenchmarkEntity& p_entity, const tt::math::VectorRect& p_screenRect, s32& p_changes)
+{
+	const bool onScreen = p_entity.worldRect.intersects(p_screenRect);
+	if (p_entity.onScreen != onScreen)
+	{
+		p_entity.onScreen = onScreen;
+		++p_changes;
+	}
+}
+
+
+/*! \brief Same as EntityCullingData::update. */
+static void updateCullingData(EntityCullingData& p_data, s32 p_index, const BenchmarkEntity& p_entity)
+{
+	const bool culled = p_entity.cullingInitialized && p_entity.culled;
+	const u8   flags  = static_cast<u8>(
+		(p_entity.initialized        ? EntityCullingData::Flag_Initialized        : 0) |
+		(p_entity.inScreenspace      ? EntityCullingData::Flag_InScreenspace      : 0) |
+		(p_entity.cullingEnabled     ? EntityCullingData::Flag_CullingEnabled     : 0) |
+		(p_entity.cullingInitialized ? EntityCullingData::Flag_CullingInitialized : 0) |
+		(p_entity.cullingParent >= 0 ? EntityCullingData::Flag_HasCullingParent   : 0) |
+		(culled                      ? EntityCullingData::Flag_Culled             : 0) |
+		(p_entity.onScreen           ? EntityCullingData::Flag_OnScreen           : 0));
+		
+	p_data.set(p_index, p_entity.worldRect, flags, p_entity.cullingParent);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Frame updates
+
+/*! \brief Moves some of the entities, like the movement update does before the culling passes.
+    \param p_data If not null, the culling data of the moved entities is updated (Entity::updateRects). */
+static void moveEntities(StridedEntities& p_entities, EntityCullingData* p_data, s32 p_frame)
+{
+	const real distance = ((p_frame / g_movingEntityRatio) % 2 == 0) ? g_moveDistance : -g_moveDistance;
+	for (s32 i = p_frame % g_movingEntityRatio; i < p_entities.getCount(); i += g_movingEntityRatio)
+	{
+		p_entities[i].worldRect.translate(tt::math::Vector2(distance, 0.0f));
+		if (p_data != 0)
+		{
+			updateCullingData(*p_data, i, p_entities[i]);
+		}
+	}
+}
+
+
+/*! \brief The previous EntityMgr passes: every pass visits every entity. */
+static void updateReferenceFrame(StridedEntities& p_entities, s32 p_frame, s32 p_frameCount, s32& p_changes)
+{
+	const tt::math::VectorRect cullingRect  (getCameraRect(p_frame, p_frameCount, g_cullingWidth,   g_cullingHeight));
+	const tt::math::VectorRect uncullingRect(getCameraRect(p_frame, p_frameCount, g_uncullingWidth, g_uncullingHeight));
+	const s32 count = p_entities.getCount();
+	
+	for (s32 i = 0; i < count; ++i)
+	{
+		BenchmarkEntity& entity(p_entities[i]);
+		if (entity.initialized && entity.cullingParent < 0)
+		{
+			updateCulling(entity, 0, cullingRect, uncullingRect, p_changes);
+		}
+	}
+	
+	for (s32 i = 0; i < count; ++i)
+	{
+		BenchmarkEntity& entity(p_entities[i]);
+		if (entity.initialized && entity.cullingParent >= 0)
+		{
+			updateCulling(entity, &p_entities[entity.cullingParent], cullingRect, uncullingRect, p_changes);
+		}
+	}
+	
+	for (s32 i = 0; i < count; ++i)
+	{
+		BenchmarkEntity& entity(p_entities[i]);
+		if (entity.initialized)
+		{
+			updateOnScreen(entity, uncullingRect, p_changes);
+		}
+	}
+}
+
+
+/*! \brief The EntityMgr passes on EntityCullingData: only the entities it finds are visited. */
+static void updateCullingDataFrame(StridedEntities& p_entities, EntityCullingData& p_data,
+                                   std::vector<u8>& p_updates, s32 p_frame, s32 p_frameCount, s32& p_changes)
+{
+	const tt::math::VectorRect cullingRect  (getCameraRect(p_frame, p_frameCount, g_cullingWidth,   g_cullingHeight));
+	const tt::math::VectorRect uncullingRect(getCameraRect(p_frame, p_frameCount, g_uncullingWidth, g_uncullingHeight));
+	const s32 count = p_entities.getCount();
+	
+	p_data.findCullingUpdates(count, cullingRect, uncullingRect, p_updates.data());
+	for (s32 i = 0; i < count; ++i)
+	{
+		if (p_updates[i] != 0)
+		{
+			updateCulling(p_entities[i], 0, cullingRect, uncullingRect, p_changes);
+			updateCullingData(p_data, i, p_entities[i]);
+		}
+	}
+	
+	p_data.findChildCullingUpdates(count, p_updates.data());
+	for (s32 i = 0; i < count; ++i)
+	{
+		if (p_updates[i] != 0)
+		{
+			BenchmarkEntity& entity(p_entities[i]);
+			updateCulling(entity, &p_entities[entity.cullingParent], cullingRect, uncullingRect, p_changes);
+			updateCullingData(p_data, i, entity);
+		}
+	}
+	
+	p_data.findOnScreenChanges(count, uncullingRect, p_updates.data());
+	for (s32 i = 0; i < count; ++i)
+	{
+		if (p_updates[i] != 0)
+		{
+			updateOnScreen(p_entities[i], uncullingRect, p_changes);
+			updateCullingData(p_data, i, p_entities[i]);
+		}
+	}
+}
+
+
+static s32 countDifferences(StridedEntities& p_reference, StridedEntities& p_entities)
+{
+	s32 differences = 0;
+	for (s32 i = 0; i < p_reference.getCount(); ++i)
+	{
+		if (p_reference[i].culled   != p_entities[i].culled ||
+		    p_reference[i].onScreen != p_entities[i].onScreen)
+		{
+			++differences;
+		}
+	}
+	return differences;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+bool EntityCullingBenchmark::run(const tt::args::CmdLine& p_cmdLine)
+{
+	using tt::profiler::Benchmark;
+	
+	const s32 entityCount = Benchmark::getCount(p_cmdLine, "benchmark_entities",   10000);
+	const s32 frameCount  = Benchmark::getCount(p_cmdLine, "benchmark_frames",       600);
+	const s32 iterations  = Benchmark::getCount(p_cmdLine, "benchmark_iterations",     5);
+	
+	const std::string outputPath(Benchmark::getOutputPath(p_cmdLine, "benchmark_entity_culling.json"));
+	const bool evictCaches = p_cmdLine.exists("benchmark_warm") == false;
+	
+	const BenchmarkEntities entities(createEntities(entityCount));
+	StridedEntities   referenceEntities(entities);
+	StridedEntities   cullingDataEntities(entities);
+	EntityCullingData cullingData(0, entityCount);
+	std::vector<u8>   updates(static_cast<std::vector<u8>::size_type>(entityCount), 0);
+	std::vector<u8>   evictionBuffer(evictCaches ? g_evictionBufferSize : 0, 0);
+	
+	RunStats reference;
+	RunStats withCullingData;
+	s32      differences = 0;
+	
+	for (s32 iteration = 0; iteration < iterations; ++iteration)
+	{
+		referenceEntities.assign(entities);
+		reference.changes = 0;
+		
+		u64 referenceTime = 0;
+		for (s32 frame = 0; frame < frameCount; ++frame)
+		{
+			evict(evictionBuffer);
+			const u64 moveTime = Benchmark::getMicroSeconds();
+			moveEntities(referenceEntities, 0, frame);
+			const u64 startTime = Benchmark::getMicroSeconds();
+			updateReferenceFrame(referenceEntities, frame, frameCount, reference.changes);
+			referenceTime   += Benchmark::getMicroSeconds() - startTime;
+			reference.moves += startTime - moveTime;
+		}
+		reference.times.add(referenceTime);
+		
+		// Entities fill their culling data on creation, which isn't part of the frame
+		cullingDataEntities.assign(entities);
+		for (s32 i = 0; i < entityCount; ++i)
+		{
+			updateCullingData(cullingData, i, cullingDataEntities[i]);
+		}
+		withCullingData.changes = 0;
+		
+		u64 cullingDataTime = 0;
+		for (s32 frame = 0; frame < frameCount; ++frame)
+		{
+			evict(evictionBuffer);
+			const u64 moveTime = Benchmark::getMicroSeconds();
+			moveEntities(cullingDataEntities, &cullingData, frame);
+			const u64 startTime = Benchmark::getMicroSeconds();
+			updateCullingDataFrame(cullingDataEntities, cullingData, updates, frame, frameCount,
+			                       withCullingData.changes);
+			cullingDataTime       += Benchmark::getMicroSeconds() - startTime;
+			withCullingData.moves += startTime - moveTime;
+		}
+		withCullingData.times.add(cullingDataTime);
+		
+		differences = std::max(differences, countDifferences(referenceEntities, cullingDataEntities));
+	}
+	
+	const bool match = differences == 0 && reference.changes == withCullingData.changes;
+	TT_ASSERTMSG(match, "EntityCullingData passes differ from the reference: %d entities differ, "
+	             "%d changes instead of %d.", differences, withCullingData.changes, reference.changes);
+	
+	Json::Value rootNode(Json::objectValue);
+	rootNode["entities"   ] = entityCount;
+	rootNode["entityBytes"] = static_cast<Json::UInt>(sizeof(Entity));
+	rootNode["frames"     ] = frameCount;
+	rootNode["iterations" ] = iterations;
+	rootNode["evictCaches"] = evictCaches;
+	rootNode["reference"  ] = getStatsNode(reference,       iterations, frameCount);
+	rootNode["cullingData"] = getStatsNode(withCullingData, iterations, frameCount);
+	rootNode["differences"] = differences;
+	rootNode["match"      ] = match;
+	
+	TT_Printf("EntityCullingBenchmark::run: %d entities (%u bytes each), %d frames: %.4f ms per frame, "
+	          "reference %.4f ms per frame%s\n",
+	          entityCount, static_cast<u32>(sizeof(Entity)), frameCount,
+	          Benchmark::toMilliSeconds(withCullingData.times.total) / (iterations * frameCount),
+	          Benchmark::toMilliSeconds(reference      .times.total) / (iterations * frameCount),
+	          match ? "" : " (RESULTS DIFFER)");
+	
+	return Benchmark::writeReport("EntityCullingBenchmark", rootNode, outputPath) && match;
+}
+
+// Namespace end
+}
+}
+}
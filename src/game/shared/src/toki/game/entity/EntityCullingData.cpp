@@ -0,0 +1,216 @@
+#include <tt/platform/tt_error.h>
+
+#include <toki/game/entity/Entity.h>
+#include <toki/game/entity/EntityCullingData.h>
+
+
+namespace toki {
+namespace game {
+namespace entity {
+
+// The loops below combine conditions with & instead of && so the compiler can turn them into
+// branchless (vectorized) code; a comparison is 0 or 1.
+static inline u32 hasFlag(u32 p_flags, EntityCullingData::Flag p_flag)
+{
+	return static_cast<u32>((p_flags & p_flag) != 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+EntityCullingData::EntityCullingData(const Entity* p_first, s32 p_capacity)
+:
+m_first(p_first),
+m_left  (static_cast<std::vector<real>::size_type>(p_capacity), 0.0f),
+m_top   (static_cast<std::vector<real>::size_type>(p_capacity), 0.0f),
+m_right (static_cast<std::vector<real>::size_type>(p_capacity), 0.0f),
+m_bottom(static_cast<std::vector<real>::size_type>(p_capacity), 0.0f),
+m_flags (static_cast<std::vector<u8  >::size_type>(p_capacity), 0),
+m_parent(static_cast<std::vector<s32 >::size_type>(p_capacity), -1)
+{
+}
+
+
+void EntityCullingData::update(const Entity& p_entity)
+{
+	TT_NULL_ASSERT(m_first);
+	
+	const u8 flags = static_cast<u8>(
+		(p_entity.isInitialized()                ? Flag_Initialized        : 0) |
+		(p_entity.isScreenSpaceEntity()          ? Flag_InScreenspace      : 0) |
+		(p_entity.isPositionCullingEnabled()     ? Flag_CullingEnabled     : 0) |
+		(p_entity.isPositionCullingInitialized() ? Flag_CullingInitialized : 0) |
+		(p_entity.hasPositionCullingParent()     ? Flag_HasCullingParent   : 0) |
+		(p_entity.isPositionCulled()             ? Flag_Culled             : 0) |
+		(p_entity.isOnScreen()                   ? Flag_OnScreen           : 0));
+		
+	const Entity* parent = p_entity.getPositionCullingParent().getPtr();
+	
+	set(static_cast<s32>(&p_entity - m_first), p_entity.getWorldRect(), flags,
+	    (parent != 0) ? static_cast<s32>(parent - m_first) : -1);
+}
+
+
+void EntityCullingData::set(s32 p_index, const tt::math::VectorRect& p_worldRect, u8 p_flags, s32 p_parent)
+{
+	TT_ASSERT(p_index >= 0 && p_index < getCapacity());
+	
+	m_left  [p_index] = p_worldRect.getLeft();
+	m_top   [p_index] = p_worldRect.getTop();
+	m_right [p_index] = p_worldRect.getRight();
+	m_bottom[p_index] = p_worldRect.getBottom();
+	m_flags [p_index] = p_flags;
+	m_parent[p_index] = p_parent;
+}
+
+
+void EntityCullingData::move(s32 p_from, s32 p_to)
+{
+	TT_ASSERT(p_from >= 0 && p_from < getCapacity());
+	TT_ASSERT(p_to   >= 0 && p_to   < getCapacity());
+	
+	m_left  [p_to] = m_left  [p_from];
+	m_top   [p_to] = m_top   [p_from];
+	m_right [p_to] = m_right [p_from];
+	m_bottom[p_to] = m_bottom[p_from];
+	m_flags [p_to] = m_flags [p_from];
+	m_parent[p_to] = m_parent[p_from];
+}
+
+
+void EntityCullingData::findCullingUpdates(s32 p_count, const tt::math::VectorRect& p_cullingRect,
+                                           const tt::math::VectorRect& p_uncullingRect, u8* p_updates_OUT) const
+{
+	TT_ASSERT(p_count >= 0 && p_count <= getCapacity());
+	TT_NULL_ASSERT(p_updates_OUT);
+	if (p_count == 0)
+	{
+		return;
+	}
+	
+	const real cullLeft     = p_cullingRect.getLeft();
+	const real cullTop      = p_cullingRect.getTop();
+	const real cullRight    = p_cullingRect.getRight();
+	const real cullBottom   = p_cullingRect.getBottom();
+	const real uncullLeft   = p_uncullingRect.getLeft();
+	const real uncullTop    = p_uncullingRect.getTop();
+	const real uncullRight  = p_uncullingRect.getRight();
+	const real uncullBottom = p_uncullingRect.getBottom();
+	
+	const real* left   = &m_left  [0];
+	const real* top    = &m_top   [0];
+	const real* right  = &m_right [0];
+	const real* bottom = &m_bottom[0];
+	const u8*   flags  = &m_flags [0];
+	
+	// Test the rects first: loops that don't mix floats and bytes vectorize better
+	for (s32 i = 0; i < p_count; ++i)
+	{
+		// Same tests as VectorRect::intersects
+		const u32 inCulling = static_cast<u32>(right[i] >= cullLeft) & static_cast<u32>(left[i]   <= cullRight) &
+		                      static_cast<u32>(bottom[i] >= cullTop) & static_cast<u32>(top[i]    <= cullBottom);
+		const u32 inUnculling = static_cast<u32>(right[i] >= uncullLeft) & static_cast<u32>(left[i] <= uncullRight) &
+		                        static_cast<u32>(bottom[i] >= uncullTop) & static_cast<u32>(top[i]  <= uncullBottom);
+		
+		p_updates_OUT[i] = static_cast<u8>(inCulling * Rect_InCulling + inUnculling * Rect_InUnculling);
+	}
+	
+	// Same decisions as Entity::updatePositionCulling
+	const u8 stateMask = Flag_Initialized | Flag_InScreenspace | Flag_CullingEnabled | Flag_CullingInitialized |
+	                     Flag_HasCullingParent | Flag_Culled;
+	const u8 visible   = Flag_Initialized | Flag_CullingEnabled | Flag_CullingInitialized;
+	const u8 culled    = visible | Flag_Culled;
+	
+	for (s32 i = 0; i < p_count; ++i)
+	{
+		const u8 state = static_cast<u8>(flags[i] & stateMask);
+		const u8 rects = p_updates_OUT[i];
+		
+		const bool initCulling = (state & (Flag_Initialized | Flag_CullingInitialized | Flag_HasCullingParent)) ==
+		                         Flag_Initialized;
+		const bool cull        = (state == visible) & ((rects & Rect_InCulling)   == 0);
+		const bool uncull      = (state == culled ) & ((rects & Rect_InUnculling) != 0);
+		
+		p_updates_OUT[i] = static_cast<u8>(initCulling | cull | uncull);
+	}
+}
+
+
+void EntityCullingData::findChildCullingUpdates(s32 p_count, u8* p_updates_OUT) const
+{
+	TT_ASSERT(p_count >= 0 && p_count <= getCapacity());
+	TT_NULL_ASSERT(p_updates_OUT);
+	if (p_count == 0)
+	{
+		return;
+	}
+	
+	const u8*  flags  = &m_flags [0];
+	const s32* parent = &m_parent[0];
+	
+	for (s32 i = 0; i < p_count; ++i)
+	{
+		const u32 entityFlags        = flags[i];
+		const u32 initialized        = hasFlag(entityFlags, Flag_Initialized);
+		const u32 inScreenspace      = hasFlag(entityFlags, Flag_InScreenspace);
+		const u32 cullingInitialized = hasFlag(entityFlags, Flag_CullingInitialized);
+		const u32 isChild            = hasFlag(entityFlags, Flag_HasCullingParent);
+		const u32 culled             = hasFlag(entityFlags, Flag_Culled);
+		
+		// A child whose parent doesn't exist (anymore) culls like any other entity;
+		// Entity::updatePositionCulling handles that rare case
+		const u32 hasParent   = static_cast<u32>(parent[i] >= 0);
+		const u32 parentFlags = flags[hasParent != 0 ? parent[i] : i];
+		
+		// Children copy the culled state of their parent
+		const u32 changes = (hasParent ^ 1) |
+		                    (hasFlag(parentFlags, Flag_CullingEnabled) & (hasFlag(parentFlags, Flag_Culled) ^ culled));
+		
+		p_updates_OUT[i] = static_cast<u8>(isChild & initialized &
+		                                   ((cullingInitialized ^ 1) | ((inScreenspace ^ 1) & changes)));
+	}
+}
+
+
+void EntityCullingData::findOnScreenChanges(s32 p_count, const tt::math::VectorRect& p_screenRect,
+                                            u8* p_changed_OUT) const
+{
+	TT_ASSERT(p_count >= 0 && p_count <= getCapacity());
+	TT_NULL_ASSERT(p_changed_OUT);
+	if (p_count == 0)
+	{
+		return;
+	}
+	
+	const real screenLeft   = p_screenRect.getLeft();
+	const real screenTop    = p_screenRect.getTop();
+	const real screenRight  = p_screenRect.getRight();
+	const real screenBottom = p_screenRect.getBottom();
+	
+	const real* left   = &m_left  [0];
+	const real* top    = &m_top   [0];
+	const real* right  = &m_right [0];
+	const real* bottom = &m_bottom[0];
+	const u8*   flags  = &m_flags [0];
+	
+	for (s32 i = 0; i < p_count; ++i)
+	{
+		const u32 onScreen = static_cast<u32>(right[i] >= screenLeft) & static_cast<u32>(left[i] <= screenRight) &
+		                     static_cast<u32>(bottom[i] >= screenTop) & static_cast<u32>(top[i]  <= screenBottom);
+		
+		p_changed_OUT[i] = static_cast<u8>(onScreen * Flag_OnScreen);
+	}
+	
+	// Initialized entities whose on screen flag differs from the test
+	const u8 stateMask = Flag_Initialized | Flag_OnScreen;
+	for (s32 i = 0; i < p_count; ++i)
+	{
+		p_changed_OUT[i] = static_cast<u8>(((flags[i] & stateMask) ^ p_changed_OUT[i]) == stateMask);
+	}
+}
+
+// Namespace end
+}
+}
+}
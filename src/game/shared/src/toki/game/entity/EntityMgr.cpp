@@ -38,7 +38,12 @@ m_idToHandleMapping(),
 m_isCreatingEntities(false),
 m_postCreateSpawn(),
 m_entityCullingEnabled(true),
-m_sectionProfiler("EntityMgr - update")
+m_cullingData(getFirst(), p_reserveCount),
+m_cullingUpdates(static_cast<std::vector<u8>::size_type>(p_reserveCount), 0),
+m_cullingParentsChanged(false),
+m_sectionProfiler("EntityMgr - update"),
+m_sensorCandidatesCounter(m_sectionProfiler.registerCounter("Sensor candidates")),
+m_sensorTestsCounter(m_sectionProfiler.registerCounter("Sensor tests"))
 {
 }
 
@@ -276,10 +281,11 @@ EntityHandle EntityMgr::createEntity(const std::string& p_type, s32 p_id)
 	}
 	Entity* newEntity = get(handle);
 	TT_NULL_ASSERT(newEntity);
+	newEntity->setCullingData(&m_cullingData);
 	
 	if (newEntity->load(p_type, p_id) == false)
 	{
-		destroy(handle);
+		destroyAndUpdateCullingData(handle);
 		return EntityHandle();
 	}
 	
@@ -407,6 +413,8 @@ void EntityMgr::updateEntities(real p_deltaTime, const Camera& p_camera)
 	
 	m_sectionProfiler.startFrameUpdateSection(EntityMgrSection_Sensors);
 	m_sensorMgr.update(AppGlobal::getGame()->getGameTimeInSeconds());
+	m_sectionProfiler.setCounter(m_sensorCandidatesCounter, m_sensorMgr.getBroadphaseStats().candidateCount);
+	m_sectionProfiler.setCounter(m_sensorTestsCounter,      m_sensorMgr.getBroadphaseStats().testCount);
 	m_sectionProfiler.startFrameUpdateSection(EntityMgrSection_TileSensors);
 	m_tileSensorMgr.update();
 	m_sectionProfiler.startFrameUpdateSection(EntityMgrSection_PowerBeamGraphicMgr);
@@ -717,6 +725,14 @@ void EntityMgr::unserialize(const toki::serialization::SerializationMgr& p_seria
 	// Load
 	tt::code::unserializeHandleArrayMgr(this, &context);
 	
+	{
+		Entity* entity = getFirst();
+		for (s32 i = 0; i < getActiveCount(); ++i, ++entity)
+		{
+			entity->setCullingData(&m_cullingData);
+		}
+	}
+	
 	const u32 idToHandleMappingCount = bu::get<u32>(&context);
 	for (u32 i = 0; i < idToHandleMappingCount; ++i)
 	{
@@ -864,7 +880,7 @@ void EntityMgr::callUpdateOnAllEntities(real p_deltaTime) const
 #if !defined(TT_BUILD_FINAL)
 			const u64 startTime = tt::system::Time::getInstance()->getMicroSeconds();
 #endif
-			localPtr->callSqFun("update", p_deltaTime);
+			localPtr->callSqFun(script::EntityCallback_Update, p_deltaTime);
 #if !defined(TT_BUILD_FINAL)
 			const u64 duration = tt::system::Time::getInstance()->getMicroSeconds() - startTime;
 			const std::string& type(localPtr->getType());
@@ -1095,12 +1111,37 @@ void EntityMgr::destroyEntity(EntityHandle p_handle)
 	// (deinit() should have been called in a separate step)
 	TT_ASSERT(getEntity(p_handle) == 0 || getEntity(p_handle)->isInitialized() == false);
 	
-	destroy(p_handle);
+	destroyAndUpdateCullingData(p_handle);
 	
 	TT_ASSERT(getEntity(p_handle) == 0);
 }
 
 
+void EntityMgr::destroyAndUpdateCullingData(const EntityHandle& p_handle)
+{
+	const Entity* entity = get(p_handle);
+	if (entity == 0)
+	{
+		destroy(p_handle);
+		return;
+	}
+	
+	// destroy() moves the last entity into the slot of the destroyed one
+	const s32 index = static_cast<s32>(entity - getFirst());
+	const s32 last  = getActiveCount() - 1;
+	
+	destroy(p_handle);
+	
+	if (index != last)
+	{
+		m_cullingData.move(last, index);
+	}
+	
+	// Children may point at the destroyed or the moved entity
+	m_cullingParentsChanged = true;
+}
+
+
 void EntityMgr::updateCullingForAllEntities(const Camera& p_camera)
 {
 #if !defined(TT_BUILD_FINAL)
@@ -1121,23 +1162,39 @@ void EntityMgr::updateCullingForAllEntities(const Camera& p_camera)
 		const tt::math::VectorRect& cullingRect(p_camera.getCurrentCullingRect());
 		const tt::math::VectorRect& uncullingRect(p_camera.getCurrentUncullingRect());
 		
+		const s32 count = getActiveCount();
+		Entity*   entity = getFirst();
+		
+		if (m_cullingParentsChanged)
+		{
+			for (s32 i = 0; i < count; ++i)
+			{
+				if (m_cullingData.hasCullingParent(i))
+				{
+					entity[i].updateCullingData();
+				}
+			}
+			m_cullingParentsChanged = false;
+		}
+		
+		// Only the few entities whose culling changes are touched
 		// First update parents
-		Entity* entity = getFirst();
-		for (s32 i = 0; i < getActiveCount(); ++i, ++entity)
+		m_cullingData.findCullingUpdates(count, cullingRect, uncullingRect, m_cullingUpdates.data());
+		for (s32 i = 0; i < count; ++i)
 		{
-			if (entity->isInitialized() && entity->hasPositionCullingParent() == false)
+			if (m_cullingUpdates[i] != 0)
 			{
-				entity->updatePositionCulling(cullingRect, uncullingRect);
+				entity[i].updatePositionCulling(cullingRect, uncullingRect);
 			}
 		}
 		
 		// Then update childs
-		entity = getFirst();
-		for (s32 i = 0; i < getActiveCount(); ++i, ++entity)
+		m_cullingData.findChildCullingUpdates(count, m_cullingUpdates.data());
+		for (s32 i = 0; i < count; ++i)
 		{
-			if (entity->isInitialized() && entity->hasPositionCullingParent())
+			if (m_cullingUpdates[i] != 0)
 			{
-				entity->updatePositionCulling(cullingRect, uncullingRect);
+				entity[i].updatePositionCulling(cullingRect, uncullingRect);
 			}
 		}
 	}
@@ -1150,12 +1207,15 @@ void EntityMgr::updateIsOnScreenAllEntities(const Camera& p_camera)
 	// counted as being on screen.
 	const tt::math::VectorRect& screenRect(p_camera.getCurrentUncullingRect());
 	
+	const s32 count = getActiveCount();
+	m_cullingData.findOnScreenChanges(count, screenRect, m_cullingUpdates.data());
+	
 	Entity* entity = getFirst();
-	for (s32 i = 0; i < getActiveCount(); ++i, ++entity)
+	for (s32 i = 0; i < count; ++i)
 	{
-		if (entity->isInitialized())
+		if (m_cullingUpdates[i] != 0)
 		{
-			entity->updateIsOnScreen(screenRect);
+			entity[i].updateIsOnScreen(screenRect);
 		}
 	}
 }
@@ -276,7 +276,7 @@ void DirectionalMovementController::restartPresentationObject(toki::pres::Presen
 			const script::EntityBasePtr& script = entity->getEntityScript();
 			if (m_transition->isTurn())
 			{
-				script->queueSqFun("onTurnEnded");
+				script->queueSqFun(script::EntityCallback_OnTurnEnded);
 			}
 			if (m_transition->hasEndCallback())
 			{
@@ -840,7 +840,7 @@ bool DirectionalMovementController::canBeMovedInDirection(movement::Direction p_
 	}
 	
 	
-	EntityHandleSet entities;
+	EntityHandles entities;
 	AppGlobal::getGame()->getTileRegistrationMgr().findRegisteredEntityHandles(tilesToCheck, entities);
 	
 	if (entities.empty())
@@ -849,7 +849,7 @@ bool DirectionalMovementController::canBeMovedInDirection(movement::Direction p_
 		return false;
 	}
 	
-	for (EntityHandleSet::iterator it = entities.begin(); it != entities.end(); ++it)
+	for (EntityHandles::iterator it = entities.begin(); it != entities.end(); ++it)
 	{
 		if (*it == m_entityHandle)
 		{
@@ -2229,7 +2229,7 @@ void DirectionalMovementController::pushOtherEntities(const Entity& p_entity)
 		return;
 	}
 	
-	game::entity::EntityHandleSet entities;
+	game::entity::EntityHandles entities;
 	AppGlobal::getGame()->getTileRegistrationMgr().findRegisteredEntityHandles(
 			p_entity.getRegisteredTileRect(), entities);
 	
@@ -2245,7 +2245,7 @@ void DirectionalMovementController::pushOtherEntities(const Entity& p_entity)
 	EntityMgr&             entityMgr(AppGlobal::getGame()->getEntityMgr());
 	MovementControllerMgr& ctrlMgr  (entityMgr.getMovementControllerMgr());
 	
-	for (game::entity::EntityHandleSet::iterator it = entities.begin(); it != entities.end(); ++it)
+	for (game::entity::EntityHandles::iterator it = entities.begin(); it != entities.end(); ++it)
 	{
 		if (*it == getEntityHandle())
 		{
@@ -2326,10 +2326,10 @@ void DirectionalMovementController::establishCollisionParentHierarchy(const Enti
 	const tt::math::PointRect tilesToCheck(ownTilesRect.getMin()       - tt::math::Point2(1, 1),
 	                                       ownTilesRect.getMaxInside() + tt::math::Point2(1, 1));
 	
-	EntityHandleSet entities;
+	EntityHandles entities;
 	AppGlobal::getGame()->getTileRegistrationMgr().findRegisteredEntityHandles(tilesToCheck, entities);
 	
-	for (EntityHandleSet::iterator it = entities.begin(); it != entities.end(); ++it)
+	for (EntityHandles::iterator it = entities.begin(); it != entities.end(); ++it)
 	{
 		if (*it == p_entity.getHandle())
 		{
@@ -3153,7 +3153,7 @@ void DirectionalMovementController::doMoveStartLogic(Entity& p_entity)
 					const script::EntityBasePtr& script(p_entity.getEntityScript());
 					if (m_transition->isTurn())
 					{
-						script->queueSqFun("onTurnStarted");
+						script->queueSqFun(script::EntityCallback_OnTurnStarted);
 					}
 					if (m_transition->hasStartCallback())
 					{
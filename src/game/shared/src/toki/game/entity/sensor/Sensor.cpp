@@ -88,7 +88,7 @@ Sensor::~Sensor()
 }
 
 
-void Sensor::update()
+void Sensor::update(const SensorBroadphase* p_broadphase, SensorBroadphaseStats* p_stats_OUT)
 {
 	Entity* sourceEntity = getSourceEntityForUpdate();
 	if (sourceEntity == nullptr)
@@ -130,7 +130,7 @@ void Sensor::update()
 		else if (m_shape != 0)
 		{
 			// no specific target, return all entities
-			getSensedEntities(sourceEntity, &m_currentySensedEntitiesCache);
+			getSensedEntities(sourceEntity, p_broadphase, p_stats_OUT, &m_currentySensedEntitiesCache);
 		}
 	}
 }
@@ -805,7 +805,8 @@ void Sensor::distanceSort(EntityHandles& p_handles) const
 }
 
 
-void Sensor::getSensedEntities(Entity* p_source, EntityHandles* p_result_OUT)
+void Sensor::getSensedEntities(Entity* p_source, const SensorBroadphase* p_broadphase,
+                               SensorBroadphaseStats* p_stats_OUT, EntityHandles* p_result_OUT)
 {
 	TT_NULL_ASSERT(p_source);
 	TT_NULL_ASSERT(p_result_OUT);
@@ -820,11 +821,11 @@ void Sensor::getSensedEntities(Entity* p_source, EntityHandles* p_result_OUT)
 	switch (m_type)
 	{
 	case SensorType_Sight:
-		m_shape->getEntitiesWithCenterInRange(*this, *p_result_OUT);
+		m_shape->getEntitiesWithCenterInRange(*this, *p_result_OUT, p_broadphase, p_stats_OUT);
 		break;
 		
 	case SensorType_Touch:
-		m_shape->getEntitiesWithWorldRectInRange(*this, *p_result_OUT);
+		m_shape->getEntitiesWithWorldRectInRange(*this, *p_result_OUT, p_broadphase, p_stats_OUT);
 		break;
 		
 	default:
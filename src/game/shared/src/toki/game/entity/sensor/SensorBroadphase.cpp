@@ -0,0 +1,138 @@
+#include <algorithm>
+
+#include <tt/math/math.h>
+
+#include <toki/game/entity/sensor/SensorBroadphase.h>
+#include <toki/game/entity/Entity.h>
+#include <toki/game/entity/EntityMgr.h>
+#include <toki/level/TileRegistrationMgr.h>
+
+
+namespace toki {
+namespace game {
+namespace entity {
+namespace sensor {
+
+//--------------------------------------------------------------------------------------------------
+// Helper functions
+
+struct CandidateHandleLess
+{
+	inline bool operator()(const SensorBroadphase::Candidate& p_lhs,
+	                       const SensorBroadphase::Candidate& p_rhs) const
+	{
+		return p_lhs.handle < p_rhs.handle;
+	}
+};
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+SensorBroadphase::SensorBroadphase()
+:
+m_cellBounds(0, 0),
+m_candidates(),
+m_cellStarts(),
+m_cellEntries(),
+m_cellFill()
+{
+}
+
+
+void SensorBroadphase::build(const EntityMgr& p_entityMgr, const tt::math::Point2& p_levelBounds)
+{
+	const s32 cellSize = level::TileRegistrationMgr::cellSize;
+	
+	// Same cells as TileRegistrationMgr::handleLevelResized()
+	m_cellBounds.x = static_cast<s32>(tt::math::ceil(p_levelBounds.x / static_cast<real>(cellSize))) + 1;
+	m_cellBounds.y = static_cast<s32>(tt::math::ceil(p_levelBounds.y / static_cast<real>(cellSize))) + 1;
+	const s32 cellCount = m_cellBounds.x * m_cellBounds.y;
+	
+	m_candidates.clear();
+	const Entity* entity = p_entityMgr.getFirstEntity();
+	for (s32 i = 0; i < p_entityMgr.getActiveEntitiesCount(); ++i, ++entity)
+	{
+		// Sensors skip these entities
+		if (entity->isTileRegistrationEnabled() == false ||
+		    entity->isSuspended()                       ||
+		    entity->isPositionCulled())
+		{
+			continue;
+		}
+		
+		// Same cells as TileRegistrationMgr::registerEntityHandle()
+		const tt::math::PointRect& tiles(entity->getRegisteredTileRect());
+		const tt::math::Point2 minPos = tt::math::pointMax(tiles.getMin(),     tt::math::Point2::zero);
+		const tt::math::Point2 maxPos = tt::math::pointMin(tiles.getMaxEdge(), p_levelBounds);
+		
+		const s32 endCellX = static_cast<s32>(tt::math::ceil(maxPos.x / static_cast<real>(cellSize)));
+		const s32 endCellY = static_cast<s32>(tt::math::ceil(maxPos.y / static_cast<real>(cellSize)));
+		
+		Candidate candidate;
+		candidate.minCell = tt::math::Point2(minPos.x / cellSize, minPos.y / cellSize);
+		candidate.maxCell = tt::math::Point2(endCellX - 1,        endCellY - 1);
+		if (candidate.maxCell.x < candidate.minCell.x || candidate.maxCell.y < candidate.minCell.y)
+		{
+			continue; // Outside the level
+		}
+		
+		candidate.handle         = entity->getHandle();
+		candidate.entity         = entity;
+		candidate.centerPosition = entity->getCenterPosition();
+		candidate.flags          = 0;
+		if (entity->isDetectableBySight())
+		{
+			candidate.flags |= Flag_DetectableBySight;
+		}
+		if (entity->isDetectableByTouch())
+		{
+			candidate.flags |= Flag_DetectableByTouch;
+		}
+		if (entity->isDetectableByLight() == false || entity->isInLight())
+		{
+			candidate.flags |= Flag_Lit;
+		}
+		m_candidates.push_back(candidate);
+	}
+	
+	// Cells list their entities in handle order, like the TileRegistrationMgr.
+	std::sort(m_candidates.begin(), m_candidates.end(), CandidateHandleLess());
+	
+	// Count the entries per cell, turn the counts into start indices and fill the cells.
+	m_cellStarts.assign(cellCount + 1, 0);
+	for (Candidates::const_iterator it = m_candidates.begin(); it != m_candidates.end(); ++it)
+	{
+		for (s32 y = (*it).minCell.y; y <= (*it).maxCell.y; ++y)
+		{
+			for (s32 x = (*it).minCell.x; x <= (*it).maxCell.x; ++x)
+			{
+				++m_cellStarts[getCellIndex(x, y) + 1];
+			}
+		}
+	}
+	for (s32 i = 0; i < cellCount; ++i)
+	{
+		m_cellStarts[i + 1] += m_cellStarts[i];
+	}
+	
+	m_cellEntries.resize(m_cellStarts[cellCount]);
+	m_cellFill.assign(m_cellStarts.begin(), m_cellStarts.end() - 1);
+	for (s32 i = 0; i < getCandidateCount(); ++i)
+	{
+		const Candidate& candidate(m_candidates[i]);
+		for (s32 y = candidate.minCell.y; y <= candidate.maxCell.y; ++y)
+		{
+			for (s32 x = candidate.minCell.x; x <= candidate.maxCell.x; ++x)
+			{
+				m_cellEntries[m_cellFill[getCellIndex(x, y)]++] = i;
+			}
+		}
+	}
+}
+
+// Namespace end
+}
+}
+}
+}
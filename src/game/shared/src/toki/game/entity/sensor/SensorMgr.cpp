@@ -3,7 +3,10 @@
 
 #include <toki/game/entity/sensor/SensorMgr.h>
 #include <toki/game/entity/Entity.h>
+#include <toki/game/Game.h>
+#include <toki/level/AttributeLayer.h>
 #include <toki/serialization/SerializationMgr.h>
+#include <toki/AppGlobal.h>
 #include <tt/thread/ThreadedWorkload.h>
 
 
@@ -20,7 +23,10 @@ namespace sensor {
 SensorMgr::SensorMgr(s32 p_reserveCount)
 :
 m_sensors(p_reserveCount),
-m_updateIndex(0)
+m_updateIndex(0),
+m_broadphase(),
+m_sensorStats(),
+m_broadphaseStats()
 {
 }
 
@@ -42,6 +48,20 @@ void SensorMgr::destroySensor(SensorHandle& p_handle)
 
 void SensorMgr::update(real64 p_gameTime)
 {
+	m_broadphaseStats = SensorBroadphaseStats();
+	if (m_sensors.getActiveCount() <= 0)
+	{
+		return;
+	}
+	
+	// All sensors gather their entities from the same broadphase, built once for this update.
+	{
+		Game* game = AppGlobal::getGame();
+		const level::AttributeLayerPtr& layer(game->getAttributeLayer());
+		m_broadphase.build(game->getEntityMgr(), tt::math::Point2(layer->getWidth(), layer->getHeight()));
+	}
+	m_sensorStats.assign(m_sensors.getActiveCount(), SensorBroadphaseStats());
+	
 #if USE_THREADING
 	tt::thread::ThreadedWorkload work(m_sensors.getActiveCount(),
 		std::bind(&SensorMgr::updateSensor, this, std::placeholders::_1));
@@ -52,11 +72,16 @@ void SensorMgr::update(real64 p_gameTime)
 		// Note JL: this loop construction assumes no sensors are added or destroyed during sensor->update
 		for (s32 i = 0; i < m_sensors.getActiveCount(); ++i, ++sensor)
 		{
-			sensor->update();
+			sensor->update(&m_broadphase, &m_sensorStats[i]);
 		}
 	}
 #endif
 	
+	for (SensorStats::const_iterator it = m_sensorStats.begin(); it != m_sensorStats.end(); ++it)
+	{
+		m_broadphaseStats.add(*it);
+	}
+	
 	// Fire all the callbacks (cannot be threaded easily)
 	Sensor* sensor = m_sensors.getFirst();
 	// Note JL: this loop construction assumes no sensors are added or destroyed during sensor->update
@@ -128,7 +153,7 @@ void SensorMgr::unserialize(const toki::serialization::SerializationMgr& p_seria
 void SensorMgr::updateSensor(size_t p_index)
 {
 	Sensor* sensors = m_sensors.getFirst();
-	sensors[p_index].update();
+	sensors[p_index].update(&m_broadphase, &m_sensorStats[p_index]);
 }
 
 // Namespace end
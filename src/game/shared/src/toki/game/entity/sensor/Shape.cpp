@@ -51,15 +51,19 @@ void Shape::updateTransform(const Entity& p_parent, const tt::math::Vector2& p_p
 }
 
 
-void Shape::getEntitiesWithCenterInRange(const Sensor& p_sensor, EntityHandles& p_entities) const
+void Shape::getEntitiesWithCenterInRange(const Sensor& p_sensor, EntityHandles& p_entities,
+                                         const SensorBroadphase* p_broadphase,
+                                         SensorBroadphaseStats*  p_stats_OUT) const
 {
-	return getEntitiesInRange(p_sensor, true, p_entities);
+	return getEntitiesInRange(p_sensor, true, p_broadphase, p_stats_OUT, p_entities);
 }
 
 
-void Shape::getEntitiesWithWorldRectInRange(const Sensor& p_sensor, EntityHandles& p_entities) const
+void Shape::getEntitiesWithWorldRectInRange(const Sensor& p_sensor, EntityHandles& p_entities,
+                                            const SensorBroadphase* p_broadphase,
+                                            SensorBroadphaseStats*  p_stats_OUT) const
 {
-	return getEntitiesInRange(p_sensor, false, p_entities);
+	return getEntitiesInRange(p_sensor, false, p_broadphase, p_stats_OUT, p_entities);
 }
 
 
@@ -136,20 +140,44 @@ bool Shape::isInRange(const Entity& p_target, bool p_center) const
 	}
 }
 
+
+bool Shape::isInRange(const Sensor& p_sensor, const SensorBroadphase::Candidate& p_target, bool p_center) const
+{
+	// Same checks as getEntitiesInRangeOnTilePosition(), with the entity state gathered by the broadphase
+	const u32 detectableFlag = (p_sensor.getType() == SensorType_Sight) ?
+		SensorBroadphase::Flag_DetectableBySight : SensorBroadphase::Flag_DetectableByTouch;
+	if ((p_target.flags & detectableFlag) == 0 ||
+	    (p_sensor.isEnabledInDarkness() == false && (p_target.flags & SensorBroadphase::Flag_Lit) == 0))
+	{
+		return false;
+	}
+	
+	if (p_center)
+	{
+		return intersects(p_target.centerPosition);
+	}
+	else
+	{
+		return isShapeInRange(p_target.entity->getTouchShape());
+	}
+}
+
+
 void Shape::getEntitiesInRangeOnTilePosition(const Sensor&           p_sensor,
                                              bool                    p_center,
                                              const tt::math::Point2& p_tilePosition,
                                              const level::TileRegistrationMgr& p_tileMgr,
                                              EntityHandles&          p_entities) const
 {
-	const entity::EntityHandleSet& unfilteredHandles = p_tileMgr.getRegisteredEntityHandles(p_tilePosition);
+	const level::TileRegistrationMgr::EntityHandleRange unfilteredHandles(
+			p_tileMgr.getRegisteredEntityHandles(p_tilePosition));
 	
 	p_entities.reserve(p_entities.size() + unfilteredHandles.size());
 	
 	const entity::Entity* source = p_sensor.getSource().getPtr();
 	TT_NULL_ASSERT(source);
 	
-	for (entity::EntityHandleSet::const_iterator it = unfilteredHandles.begin();
+	for (level::TileRegistrationMgr::EntityHandleRange::const_iterator it = unfilteredHandles.begin();
 		it != unfilteredHandles.end(); ++it)
 	{
 		const entity::EntityHandle& targetHandle(*it);
@@ -172,13 +200,86 @@ void Shape::getEntitiesInRangeOnTilePosition(const Sensor&           p_sensor,
 }
 
 
+void Shape::getEntitiesInRangeInCells(const Sensor&           p_sensor,
+                                      bool                    p_center,
+                                      const tt::math::Point2& p_minCell,
+                                      const tt::math::Point2& p_maxCell,
+                                      const SensorBroadphase& p_broadphase,
+                                      SensorBroadphaseStats&  p_stats_OUT,
+                                      EntityHandles&          p_entities) const
+{
+	const bool                  skipSource = p_sensor.isInLocalSpace(); // Only self check for local space sensors
+	const entity::EntityHandle& source(p_sensor.getSource());
+	
+	for (s32 y = p_minCell.y; y <= p_maxCell.y; ++y)
+	{
+		for (s32 x = p_minCell.x; x <= p_maxCell.x; ++x)
+		{
+			const s32* end = p_broadphase.getCellEnd(x, y);
+			for (const s32* it = p_broadphase.getCellBegin(x, y); it != end; ++it)
+			{
+				const SensorBroadphase::Candidate& target(p_broadphase.getCandidate(*it));
+				
+				// No duplicates: an entity in several cells is only handled in the first cell (in the
+				// order of these loops) it shares with the range. That is where the TileRegistrationMgr
+				// version finds it first as well, so the result keeps the same order.
+				if (std::max(target.minCell.x, p_minCell.x) != x ||
+				    std::max(target.minCell.y, p_minCell.y) != y)
+				{
+					continue;
+				}
+				++p_stats_OUT.candidateCount;
+				
+				if (skipSource && target.handle == source)
+				{
+					continue;
+				}
+				
+				++p_stats_OUT.testCount;
+				if (isInRange(p_sensor, target, p_center))
+				{
+					p_entities.push_back(target.handle);
+				}
+			}
+		}
+	}
+}
+
+
+void Shape::getEntitiesInRangeInCell(const Sensor&           p_sensor,
+                                     bool                    p_center,
+                                     const tt::math::Point2& p_cell,
+                                     const SensorBroadphase& p_broadphase,
+                                     SensorBroadphaseStats&  p_stats_OUT,
+                                     EntityHandles&          p_entities) const
+{
+	const s32* end = p_broadphase.getCellEnd(p_cell.x, p_cell.y);
+	for (const s32* it = p_broadphase.getCellBegin(p_cell.x, p_cell.y); it != end; ++it)
+	{
+		const SensorBroadphase::Candidate& target(p_broadphase.getCandidate(*it));
+		++p_stats_OUT.candidateCount;
+		
+		if((p_sensor.isInLocalSpace() == false || target.handle != p_sensor.getSource()) &&   // Only self check for local space sensors
+		   std::find(p_entities.begin(), p_entities.end(), target.handle) == p_entities.end()) // No duplicates.
+		{
+			++p_stats_OUT.testCount;
+			if (isInRange(p_sensor, target, p_center))
+			{
+				p_entities.push_back(target.handle);
+			}
+		}
+	}
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // BoundingRectShape
 
-void BoundingRectShape::getEntitiesInRange(const Sensor& p_sensor, bool p_center, EntityHandles& p_entities) const
+void BoundingRectShape::getEntitiesInRange(const Sensor& p_sensor, bool p_center,
+                                           const SensorBroadphase* p_broadphase,
+                                           SensorBroadphaseStats*  p_stats_OUT,
+                                           EntityHandles&          p_entities) const
 {
-	const level::TileRegistrationMgr& tileMgr = AppGlobal::getGame()->getTileRegistrationMgr();
-	
 	tt::math::PointRect tileRect(getBoundingTileRect());
 	const tt::math::Point2 minPos = tt::math::pointMax(tileRect.getMin(), tt::math::Point2::zero);
 	tt::math::Point2 maxPos = tileRect.getMaxInside();
@@ -193,6 +294,21 @@ void BoundingRectShape::getEntitiesInRange(const Sensor& p_sensor, bool p_center
 	const s32 maxx = static_cast<s32>(tt::math::ceil(maxPos.x / static_cast<real>(cellSize))) * cellSize;
 	const s32 maxy = static_cast<s32>(tt::math::ceil(maxPos.y / static_cast<real>(cellSize))) * cellSize;
 	
+	if (p_broadphase != 0)
+	{
+		TT_NULL_ASSERT(p_stats_OUT);
+		if (minx <= maxx && miny <= maxy)
+		{
+			getEntitiesInRangeInCells(p_sensor, p_center,
+			                          tt::math::Point2(minx / cellSize, miny / cellSize),
+			                          tt::math::Point2(maxx / cellSize, maxy / cellSize),
+			                          *p_broadphase, *p_stats_OUT, p_entities);
+		}
+		return;
+	}
+	
+	const level::TileRegistrationMgr& tileMgr = AppGlobal::getGame()->getTileRegistrationMgr();
+	
 	for (s32 y = miny; y <= maxy; y += cellSize)
 	{
 		for (s32 x = minx; x <= maxx; x += cellSize)
@@ -783,7 +899,10 @@ void RayShape::updateTransform(const Entity& p_parent, const tt::math::Vector2&
 }
 
 
-void RayShape::getEntitiesInRange(const Sensor& p_sensor, bool p_center, EntityHandles& p_entities) const
+void RayShape::getEntitiesInRange(const Sensor& p_sensor, bool p_center,
+                                  const SensorBroadphase* p_broadphase,
+                                  SensorBroadphaseStats*  p_stats_OUT,
+                                  EntityHandles&          p_entities) const
 {
 	const level::TileRegistrationMgr& tileMgr = AppGlobal::getGame()->getTileRegistrationMgr();
 
@@ -793,6 +912,28 @@ void RayShape::getEntitiesInRange(const Sensor& p_sensor, bool p_center, EntityH
 	RayHitTester hitTester(positions);
 	tt::code::tileRayTrace(m_startPosition, m_hitPosition, hitTester);
 	
+	if (p_broadphase != 0)
+	{
+		TT_NULL_ASSERT(p_stats_OUT);
+		
+		// Consecutive tiles are mostly in the same cell; a cell only needs to be checked once.
+		const s32 cellSize(level::TileRegistrationMgr::cellSize);
+		VisitedPositions cells;
+		for (VisitedPositions::const_iterator it = positions.begin(); it != positions.end(); ++it)
+		{
+			if(AppGlobal::getGame()->getAttributeLayer()->contains(*it))
+			{
+				const tt::math::Point2 cell((*it).x / cellSize, (*it).y / cellSize);
+				if (std::find(cells.begin(), cells.end(), cell) == cells.end())
+				{
+					cells.push_back(cell);
+					getEntitiesInRangeInCell(p_sensor, p_center, cell, *p_broadphase, *p_stats_OUT, p_entities);
+				}
+			}
+		}
+		return;
+	}
+	
 	for (VisitedPositions::const_iterator it = positions.begin(); it != positions.end(); ++it)
 	{
 		if(AppGlobal::getGame()->getAttributeLayer()->contains(*it))
@@ -0,0 +1,290 @@
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#include <json/json.h>
+
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+#include <tt/profiler/Benchmark.h>
+
+#include <toki/game/fluid/FluidBenchmark.h>
+#include <toki/game/fluid/FluidMgr.h>
+#include <toki/game/Game.h>
+#include <toki/game/StartInfo.h>
+#include <toki/level/AttributeLayer.h>
+#include <toki/AppGlobal.h>
+
+
+namespace toki {
+namespace game {
+namespace fluid {
+
+//--------------------------------------------------------------------------------------------------
+// Helper functions
+
+static const real g_frameTime = 1.0f / 60.0f;
+
+// Size of the test layer of the flood benchmark
+static const s32 g_floodWidth  = 1024;
+static const s32 g_floodHeight = 512;
+
+typedef std::set<tt::math::Point2, tt::math::Point2Less> StdPoint2Set;
+
+
+// FNV-1a over the tiles of the fluid layer
+static u32 getLayerHash(const level::AttributeLayer& p_layer)
+{
+	u32 hash = 2166136261u;
+	const u8* attributes = p_layer.getRawData();
+	for (s32 i = 0; i < p_layer.getLength(); ++i)
+	{
+		hash = (hash ^ attributes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+
+// Test layer of the flood benchmark: floating platforms every 8th row, with gaps
+static std::vector<bool> createFloodLayer()
+{
+	std::vector<bool> solid(static_cast<std::vector<bool>::size_type>(g_floodWidth * g_floodHeight), false);
+	for (s32 y = 8; y < g_floodHeight; y += 8)
+	{
+		for (s32 x = 0; x < g_floodWidth; ++x)
+		{
+			solid[y * g_floodWidth + x] = ((x + y) % 97) > 3;
+		}
+	}
+	return solid;
+}
+
+
+// Floods the test layer from row 0, one frontier (growth tick) at a time, the way fluids grow.
+// Filled tiles are tracked in p_filled (like the fluid layer), the frontier sets are the work lists.
+// Returns the number of filled tiles.
+template <typename SetType>
+static s32 floodLayer(const std::vector<bool>& p_solid, SetType& p_frontier, SetType& p_nextFrontier,
+                      std::vector<bool>& p_filled)
+{
+	p_frontier.clear();
+	p_nextFrontier.clear();
+	p_filled.assign(p_solid.size(), false);
+	s32 filledCount = 0;
+	
+	for (s32 x = 0; x < g_floodWidth; x += 64)
+	{
+		p_frontier.insert(tt::math::Point2(x, 0));
+		p_filled[x] = true;
+		++filledCount;
+	}
+	
+	static const tt::math::Point2 directions[] =
+	{
+		tt::math::Point2(-1, 0), tt::math::Point2(1, 0), tt::math::Point2(0, 1)
+	};
+	
+	while (p_frontier.empty() == false)
+	{
+		for (typename SetType::const_iterator it = p_frontier.begin(); it != p_frontier.end(); ++it)
+		{
+			for (s32 i = 0; i < 3; ++i)
+			{
+				const tt::math::Point2 next(*it + directions[i]);
+				if (next.x < 0 || next.x >= g_floodWidth || next.y >= g_floodHeight)
+				{
+					continue;
+				}
+				const s32 index = next.y * g_floodWidth + next.x;
+				if (p_solid[index] || p_filled[index])
+				{
+					continue;
+				}
+				p_filled[index] = true;
+				++filledCount;
+				p_nextFrontier.insert(next);
+			}
+		}
+		p_frontier.swap(p_nextFrontier);
+		p_nextFrontier.clear();
+	}
+	return filledCount;
+}
+
+
+// Times the flood of the test layer with p_frontier and p_nextFrontier as work lists.
+template <typename SetType>
+static s32 timeFlood(const std::vector<bool>& p_solid, s32 p_iterations, SetType& p_frontier,
+                     SetType& p_nextFrontier, std::vector<bool>& p_filled, tt::profiler::Benchmark::Stats& p_stats)
+{
+	using tt::profiler::Benchmark;
+	
+	s32 filledCount = 0;
+	for (s32 iteration = 0; iteration < p_iterations; ++iteration)
+	{
+		const u64 start = Benchmark::getMicroSeconds();
+		filledCount = floodLayer(p_solid, p_frontier, p_nextFrontier, p_filled);
+		p_stats.add(Benchmark::getMicroSeconds() - start);
+	}
+	return filledCount;
+}
+
+
+// Floods the test layer with std::set and with FlatSet (Point2Set) work lists and compares both.
+static bool runFlood(s32 p_iterations, Json::Value* p_node_OUT)
+{
+	using tt::profiler::Benchmark;
+	
+	const std::vector<bool> solid(createFloodLayer());
+	
+	StdPoint2Set      stdFrontier;
+	StdPoint2Set      stdNextFrontier;
+	std::vector<bool> stdFilled;
+	Benchmark::Stats  stdTimes;
+	const s32 stdCount = timeFlood(solid, p_iterations, stdFrontier, stdNextFrontier, stdFilled, stdTimes);
+	
+	// The first flood grows the storage of the flat sets; the timed floods must reuse it.
+	Point2Set         flatFrontier;
+	Point2Set         flatNextFrontier;
+	std::vector<bool> flatFilled;
+	floodLayer(solid, flatFrontier, flatNextFrontier, flatFilled);
+	const Point2Set::size_type capacity = flatFrontier.capacity() + flatNextFrontier.capacity();
+	
+	Benchmark::Stats flatTimes;
+	const s32 flatCount = timeFlood(solid, p_iterations, flatFrontier, flatNextFrontier, flatFilled, flatTimes);
+	
+	const bool sameFill      = stdCount == flatCount && stdFilled == flatFilled;
+	const bool reusesStorage = capacity == flatFrontier.capacity() + flatNextFrontier.capacity();
+	TT_ASSERTMSG(sameFill, "FluidBenchmark: std::set and FlatSet floods filled different tiles.");
+	TT_ASSERTMSG(reusesStorage, "FluidBenchmark: FlatSet floods grew their storage after the first flood.");
+	
+	TT_Printf("FluidBenchmark::run: Flood of %d x %d layer, %d tiles. std::set avg %.3f ms, FlatSet avg %.3f ms\n",
+	          g_floodWidth, g_floodHeight, flatCount, stdTimes.getAverageMs(), flatTimes.getAverageMs());
+	
+	TT_NULL_ASSERT(p_node_OUT);
+	Json::Value& node(*p_node_OUT);
+	node = Json::Value(Json::objectValue);
+	node["width"        ] = g_floodWidth;
+	node["height"       ] = g_floodHeight;
+	node["tiles"        ] = flatCount;
+	node["stdSet"       ] = stdTimes.toJson();
+	node["flatSet"      ] = flatTimes.toJson();
+	node["sameFill"     ] = sameFill;
+	node["reusesStorage"] = reusesStorage;
+	
+	return sameFill && reusesStorage;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+FluidBenchmarkPtr FluidBenchmark::create(const tt::args::CmdLine& p_cmdLine)
+{
+	return FluidBenchmarkPtr(new FluidBenchmark(
+		tt::profiler::Benchmark::getOutputPath(p_cmdLine, "benchmark_fluids.json"),
+		tt::profiler::Benchmark::getCount(p_cmdLine, "benchmark_iterations", 5),
+		tt::profiler::Benchmark::getCount(p_cmdLine, "benchmark_frames", 600)));
+}
+
+
+bool FluidBenchmark::update()
+{
+	if (AppGlobal::hasGame() == false ||
+	    AppGlobal::getGame()->getUpdateSectionProfiler().getFrameCount() == 0)
+	{
+		// Level still loading
+		return true;
+	}
+	
+	run(*AppGlobal::getGame());
+	return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+FluidBenchmark::FluidBenchmark(const std::string& p_outputPath, s32 p_iterations, s32 p_frames)
+:
+m_outputPath(p_outputPath),
+m_iterations(p_iterations),
+m_frames(p_frames)
+{
+}
+
+
+bool FluidBenchmark::run(Game& p_game) const
+{
+	using tt::profiler::Benchmark;
+	
+	Json::Value floodNode;
+	const bool  floodOk = runFlood(m_iterations, &floodNode);
+	
+	FluidMgr& fluidMgr(p_game.getFluidMgr());
+	const level::AttributeLayer& layer(*fluidMgr.getLayer());
+	
+	TT_Printf("FluidBenchmark::run: Level '%s' (%d x %d), %d iterations of %d frames\n",
+	          p_game.getStartInfo().getLevelName().c_str(), layer.getWidth(), layer.getHeight(),
+	          m_iterations, m_frames);
+	
+	Benchmark::Stats growth;       // One frame of FluidMgr::update
+	Benchmark::Stats pregenerate;  // FluidMgr::resetSimulation with pregeneration
+	Json::Value hashesNode(Json::arrayValue);
+	bool        deterministic = true;
+	u32         firstHash     = 0;
+	
+	for (s32 iteration = 0; iteration < m_iterations; ++iteration)
+	{
+		// Restart from the sources and let the fluids grow the way they do while playing.
+		fluidMgr.resetSimulation(false);
+		for (s32 frame = 0; frame < m_frames; ++frame)
+		{
+			const u64 start = Benchmark::getMicroSeconds();
+			fluidMgr.update(g_frameTime);
+			growth.add(Benchmark::getMicroSeconds() - start);
+		}
+		
+		const u32 hash = getLayerHash(layer);
+		char hashStr[16];
+		std::sprintf(hashStr, "%08X", hash);
+		hashesNode.append(hashStr);
+		if (iteration == 0)
+		{
+			firstHash = hash;
+		}
+		else if (hash != firstHash)
+		{
+			deterministic = false;
+		}
+		
+		const u64 start = Benchmark::getMicroSeconds();
+		fluidMgr.resetSimulation(true);
+		pregenerate.add(Benchmark::getMicroSeconds() - start);
+	}
+	
+	TT_ASSERTMSG(deterministic, "FluidBenchmark: Iterations ended with different fluids.");
+	TT_Printf("FluidBenchmark::run: Update avg %.3f ms, max %.3f ms. Pregeneration avg %.3f ms\n",
+	          growth.getAverageMs(), Benchmark::toMilliSeconds(growth.max), pregenerate.getAverageMs());
+	
+	Json::Value rootNode(Json::objectValue);
+	rootNode["level"        ] = p_game.getStartInfo().getLevelName();
+	rootNode["width"        ] = layer.getWidth();
+	rootNode["height"       ] = layer.getHeight();
+	rootNode["iterations"   ] = m_iterations;
+	rootNode["frames"       ] = m_frames;
+	rootNode["update"       ] = growth.toJson();
+	rootNode["pregenerate"  ] = pregenerate.toJson();
+	rootNode["layerHashes"  ] = hashesNode;
+	rootNode["deterministic"] = deterministic;
+	
+	rootNode["flood"        ] = floodNode;
+	
+	return Benchmark::writeReport("FluidBenchmark", rootNode, m_outputPath) && deterministic && floodOk;
+}
+
+
+// Namespace end
+}
+}
+}
@@ -56,8 +56,11 @@ void FluidMgr::update(real p_deltaTime)
 	
 	m_sectionProfiler.startFrameUpdateSection(FluidMgrSection_NotifyTileChange);
 	
-	// Notify entities where fluids changed
-	for (entity::EntityHandleSet::iterator it = m_notifiedEntities.begin();
+	// Notify entities where fluids changed (in handle order, once per entity)
+	std::sort(m_notifiedEntities.begin(), m_notifiedEntities.end());
+	m_notifiedEntities.erase(std::unique(m_notifiedEntities.begin(), m_notifiedEntities.end()),
+	                         m_notifiedEntities.end());
+	for (entity::EntityHandles::iterator it = m_notifiedEntities.begin();
 	     it != m_notifiedEntities.end(); ++it)
 	{
 		entity::Entity* entity = (*it).getPtr();
@@ -70,6 +73,11 @@ void FluidMgr::update(real p_deltaTime)
 	
 	m_graphicsMgr.update(p_deltaTime, m_sectionProfiler);
 	
+	m_sectionProfiler.setCounter(m_changedTilesHandledCounter, m_changedTilesHandledCount);
+	m_sectionProfiler.setCounter(m_fluidTilesUpdatedCounter,   m_fluidTilesUpdatedCount);
+	m_changedTilesHandledCount = 0;
+	m_fluidTilesUpdatedCount   = 0;
+	
 	m_sectionProfiler.stopFrameUpdate();
 }
 
@@ -483,6 +491,8 @@ void FluidMgr::handleLevelResized()
 	m_simulationLayer->clear();
 	
 	// re collect the source tiles in the level
+	// (A resize or level replace changes the whole layer without per tile notifications,
+	//  so m_sourceTiles can't be patched from onTileChange here.)
 	collectSourceTiles();
 	
 	m_changedTiles.clear();
@@ -1227,16 +1237,19 @@ bool FluidMgr::isSameWarp(const tt::math::Point2& p_pos1, const tt::math::Point2
 
 void FluidMgr::notifyTileChange(const tt::math::Point2& p_position)
 {
-	const entity::EntityHandleSet& entities = m_tileRegMgr.getRegisteredEntityHandles(p_position);
+	++m_fluidTilesUpdatedCount;
+	
+	const level::TileRegistrationMgr::EntityHandleRange entities(m_tileRegMgr.getRegisteredEntityHandles(p_position));
 	
-	m_notifiedEntities.insert(entities.begin(), entities.end());
+	m_notifiedEntities.insert(m_notifiedEntities.end(), entities.begin(), entities.end());
 		
 	tt::math::Point2 tileAbove(p_position.x, p_position.y + 1);
 	// Notify entites floating on the surface
 	if (m_tileRegMgr.contains(tileAbove))
 	{
-		const entity::EntityHandleSet& surfaceEntities = m_tileRegMgr.getRegisteredEntityHandles(tileAbove);
-		m_notifiedEntities.insert(surfaceEntities.begin(), surfaceEntities.end());
+		const level::TileRegistrationMgr::EntityHandleRange surfaceEntities(
+				m_tileRegMgr.getRegisteredEntityHandles(tileAbove));
+		m_notifiedEntities.insert(m_notifiedEntities.end(), surfaceEntities.begin(), surfaceEntities.end());
 	}
 }
 
@@ -1272,12 +1285,19 @@ m_toFlowScratch(),
 m_toFlowActiveLayerScratch(),
 m_soundCues(),
 m_soundCuesForFalls(),
+m_prevSoundCuesForFallsScratch(),
+m_fallAudioPointsScratch(),
+m_fallAudioPointsSortedScratch(),
 m_warpPairs(),
 m_notifiedEntities(),
 m_graphicsMgr(),
 m_particlesMgr(),
 m_tileRegMgr(AppGlobal::getGame()->getTileRegistrationMgr()),
-m_sectionProfiler("FluidMgr - update")
+m_sectionProfiler("FluidMgr - update"),
+m_changedTilesHandledCount(0),
+m_fluidTilesUpdatedCount(0),
+m_changedTilesHandledCounter(m_sectionProfiler.registerCounter("Changed tiles handled")),
+m_fluidTilesUpdatedCounter(m_sectionProfiler.registerCounter("Fluid tiles updated"))
 {
 	m_activeLayer->clear();
 	m_simulationLayer->clear();
@@ -3654,6 +3674,8 @@ void FluidMgr::addFallFromWarp(const tt::math::Point2& p_sourcePosition, FluidTy
 
 void FluidMgr::handleTileChanged(const tt::math::Point2& p_position)
 {
+	++m_changedTilesHandledCount;
+	
 	if(m_tileRegMgr.isSolid(p_position))
 	{
 		handleSolidPlaced(p_position);
@@ -5446,21 +5468,19 @@ void FluidMgr::resetFluidSimulation(bool p_forcePregeneration)
 	
 	m_tileRegMgr.clearEntityTilesForFluids();
 	
-	// Generate falls at all source locations
-	tt::math::Point2 pos(0, 0);
-	for (pos.y = 0; pos.y < newHeight; ++pos.y)
+	// Generate falls at all source locations.
+	// m_sourceTiles is kept up to date by onTileChange (and rebuilt by handleLevelResized),
+	// so there is no need to scan the whole level again for a reset from Game.
+	// Falls are added in row order (bottom to top, left to right), same as a full level scan would.
+	Point2s sourceTiles(m_sourceTiles.begin(), m_sourceTiles.end());
+	std::sort(sourceTiles.begin(), sourceTiles.end(), tt::math::Point2LessYThenLessX());
+	for (Point2s::const_iterator it = sourceTiles.begin(); it != sourceTiles.end(); ++it)
 	{
-		for (pos.x = 0; pos.x < newWidth; ++pos.x)
+		const FluidType fluidType = getFluidType(m_levelLayer->getCollisionType(*it));
+		if (hasFluidSource(*it, fluidType))
 		{
-			for(u32 i = 0; i < FluidType_Count; ++i)
-			{
-				FluidType fluidType(static_cast<FluidType>(i));
-				if (hasFluidSource(pos, fluidType))
-				{
-					// Create fall
-					addFall(pos, fluidType, FallType_FromSource);
-				}
-			}
+			// Create fall
+			addFall(*it, fluidType, FallType_FromSource);
 		}
 	}
 	
@@ -5553,7 +5573,8 @@ void FluidMgr::updateAudio(const tt::math::VectorRect& p_visibilityRect)
 		return;
 	}
 	
-	Point2s fallAudioPoints;
+	Point2s& fallAudioPoints = m_fallAudioPointsScratch;
+	fallAudioPoints.clear();
 	
 #if 0 // Use feed points. (Note: these didn't find falls falling into still fluids.)
 	for (s32 yPos = minTilePos.y; yPos < maxTilePos.y; ++yPos)
@@ -5638,8 +5659,9 @@ void FluidMgr::updateAudio(const tt::math::VectorRect& p_visibilityRect)
 	{
 		tt::math::Point2 startPoint(fallAudioPoints.front());
 		tt::math::Point2 endPoint(startPoint.x - 1, startPoint.y); // -1 so we don't trigger gap dectection.
-		Point2s copy;
-		std::swap(copy, fallAudioPoints);
+		Point2s& copy = m_fallAudioPointsSortedScratch;
+		copy.swap(fallAudioPoints);
+		fallAudioPoints.clear();
 		for (Point2s::iterator it = copy.begin(); it != copy.end(); ++it)
 		{
 			const tt::math::Point2& tilePos = (*it);
@@ -5662,8 +5684,9 @@ void FluidMgr::updateAudio(const tt::math::VectorRect& p_visibilityRect)
 	}
 #endif
 	
-	SoundCues prevSoundCuesForFalls;
-	std::swap(prevSoundCuesForFalls, m_soundCuesForFalls);
+	SoundCues& prevSoundCuesForFalls = m_prevSoundCuesForFallsScratch;
+	prevSoundCuesForFalls.swap(m_soundCuesForFalls);
+	m_soundCuesForFalls.clear();
 	for (Point2s::iterator it = fallAudioPoints.begin(); it != fallAudioPoints.end(); ++it)
 	{
 		const tt::math::Point2 tilePos = (*it);
@@ -5697,6 +5720,7 @@ void FluidMgr::updateAudio(const tt::math::VectorRect& p_visibilityRect)
 	{
 		(*it).second->stop();
 	}
+	prevSoundCuesForFalls.clear();
 }
 
 
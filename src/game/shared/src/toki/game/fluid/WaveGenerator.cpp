@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <tt/math/math.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/str/toStr.h>
@@ -12,12 +14,19 @@ namespace fluid {
 
 const tt::math::Point2 WaveGenerator::ms_invalidPos(-1,-1);
 
+// A surface of which all heights stay below this after a simulation step goes to sleep
+static const real sleepHeight = 0.001f;
+
 //--------------------------------------------------------------------------------------------------
 // Public member functions
 
 WaveGenerator::WaveGenerator()
 :
 m_surfaceHeights(),
+m_prevHeights(),
+m_currHeights(),
+m_fadeFactors(),
+m_unusedHeights(0),
 m_startPos(),
 m_prevPos(),
 m_accumulator(0),
@@ -75,6 +84,12 @@ void WaveGenerator::update(real p_delta)
 {
 	const real fixedUpdateTime = 1/60.0f;
 	
+	// Move the surfaces together again when most of the arenas is no longer used
+	if (m_unusedHeights > m_prevHeights.size() / 2)
+	{
+		compactHeights();
+	}
+	
 	m_accumulator += p_delta;
 	while (m_accumulator > fixedUpdateTime)
 	{
@@ -83,100 +98,23 @@ void WaveGenerator::update(real p_delta)
 		m_angle += fixedUpdateTime;
 		m_angle = tt::math::fmod(m_angle, 2 * tt::math::pi);
 		
+		updateWaveOffsets();
+		
+		m_prevHeights.swap(m_currHeights);
+		
 		for (SurfaceHeights::iterator it = m_surfaceHeights.begin(); it != m_surfaceHeights.end();)
 		{
 			if (it->second.isDead)
 			{
+				releaseHeights(it->second);
 				it = m_surfaceHeights.erase(it);
 				continue;
 			}
 			
-			
-			it->second.prevDensity.resize(it->second.simulationSize);
-			it->second.currDensity.resize(it->second.simulationSize);
-			
-			it->second.prevDensity.swap(it->second.currDensity);
-			
-			for (Reals::size_type i = 1; i < it->second.prevDensity.size() - 1; ++i)
+			updateLayout(it->second);
+			if (it->second.isSleeping == false)
 			{
-				// SIMULATION LOGIC (Shallow water equation)
-				//----------------------
-				const real velocity = it->second.prevDensity[i] - it->second.currDensity[i];
-				const real smooth =  (it->second.prevDensity[i - 1] + it->second.prevDensity[i + 1]) / 2.0f;
-				
-				
-				it->second.currDensity[i] = smooth + velocity * m_velocitydiffusion[it->second.fluidType];
-				it->second.currDensity[i] *= m_diffusion[it->second.fluidType];
-				
-				//----------------------
-				
-				PoolSurfaceType surfaceType = PoolSurfaceType_Invalid;
-				
-				if (i < it->second.leftToStillIndex)
-				{
-					surfaceType = PoolSurfaceType_Left;
-				}
-				else if (i > it->second.stillToRightIndex)
-				{
-					surfaceType = PoolSurfaceType_Right;
-				}
-				else surfaceType = PoolSurfaceType_Still;
-				
-				// Generate waves from the wave settings
-				for (PersistentWaves::const_iterator settsIt = m_waveSettings[it->second.fluidType][surfaceType].begin();
-					settsIt != m_waveSettings[it->second.fluidType][surfaceType].end(); ++settsIt)
-				{
-					const real phase = tt::math::pi * static_cast<real>(i) * settsIt->waveWidth;
-					const real phaseOffset = m_angle * settsIt->moveSpeed;
-					const real heightFactor = settsIt->waveHeight;
-					const real change       = tt::math::sin(phase + phaseOffset) * heightFactor;
-					it->second.currDensity[i] += change;
-				}
-				
-				// clamp the heights
-				tt::math::clamp(it->second.currDensity[i], m_minHeight, m_maxHeight);
-				tt::math::clamp(it->second.prevDensity[i], m_minHeight, m_maxHeight);
-				
-				const s32 stepsPerTile = m_simulationPointsPerTile;
-				
-				// fade the sides that need fading
-				if (it->second.leftEdge == EdgeOption_LeftFadeout)
-				{
-					real fadeFactor;
-					if (i < ExtraSimulationHeights)
-					{
-						fadeFactor = 0.0f;
-					}
-					else if (i > static_cast<Reals::size_type>(stepsPerTile + ExtraSimulationHeights))
-					{
-						fadeFactor = 1.0f;
-					}
-					else
-					{
-						fadeFactor = (i - ExtraSimulationHeights) / static_cast<real>(stepsPerTile);
-					}
-					it->second.currDensity[i] *= fadeFactor;
-					it->second.prevDensity[i] *= fadeFactor;
-				}
-				if (it->second.rightEdge == EdgeOption_RightFadeout)
-				{
-					real fadeFactor;
-					Reals::size_type startSlope = it->second.prevDensity.size() - static_cast<Reals::size_type>(stepsPerTile + ExtraSimulationHeights);
-					if (i > startSlope + stepsPerTile)
-					{
-						fadeFactor = 0.0f;
-					}
-					else if (i < startSlope)
-					{
-						fadeFactor = 1.0f;
-					}
-					else
-					{
-						fadeFactor = 1 - ((i - startSlope) / static_cast<real>(stepsPerTile));
-					}
-					it->second.currDensity[i] *= fadeFactor;
-					it->second.prevDensity[i] *= fadeFactor;
-				}
+				simulate(it->second);
 			}
 			
 			++it;
@@ -199,14 +137,16 @@ void WaveGenerator::update(real p_delta)
 			
 			if (simulationIt != m_surfaceHeights.end())
 			{
+				SimulationData& data = simulationIt->second;
 				for (u32 index = it->startIndex; index <= it->endIndex; ++index)
 				{
-					if (index >= simulationIt->second.prevDensity.size() - 1 - ExtraSimulationHeights * 2 ||
+					if (index >= data.size - 1 - ExtraSimulationHeights * 2 ||
 					    index <= 1 + ExtraSimulationHeights) continue;
 					
-					simulationIt->second.prevDensity[index] = it->strength * height;
-					simulationIt->second.currDensity[index] = it->strength * height;
+					m_prevHeights[data.offset + index] = it->strength * height;
+					m_currHeights[data.offset + index] = it->strength * height;
 				}
+				data.isSleeping = false;
 				++it;
 			}
 			else
@@ -257,10 +197,11 @@ void WaveGenerator::setHeight(real p_height, const tt::math::Point2& p_position,
 	
 	u32 simulationIndex = getSimulationIndex(p_position, p_waveQuadIndex, startPos);
 	
-	if (simulationIndex >= it->second.prevDensity.size() - 1 - ExtraSimulationHeights * 2 ||
+	if (simulationIndex >= it->second.size - 1 - ExtraSimulationHeights * 2 ||
 	    simulationIndex <= 1 + ExtraSimulationHeights) return;
 	
-	it->second.prevDensity[simulationIndex] = p_height;
+	m_prevHeights[it->second.offset + simulationIndex] = p_height;
+	it->second.isSleeping = false;
 }
 
 
@@ -276,22 +217,23 @@ real WaveGenerator::getHeight(const tt::math::Point2& p_position, s32 p_waveQuad
 	
 	const u32 simulationIndex = getSimulationIndex(p_position, p_waveQuadIndex, startPos);
 	
-	if (it->second.prevDensity.size() <= simulationIndex)
+	if (it->second.size <= simulationIndex)
 	{
 		return -1.0f;
 	}
 	
 	// get the Average of this position and the 2 adjacent
-	real out = it->second.currDensity[simulationIndex];
+	const real* heights = &m_currHeights[it->second.offset];
+	real out = heights[simulationIndex];
 	
-	if (simulationIndex + 1 > it->second.prevDensity.size())
+	if (simulationIndex + 1 > it->second.size)
 	{
-		out += it->second.currDensity[simulationIndex + 1];
+		out += heights[simulationIndex + 1];
 	}
 	
 	if (simulationIndex > 0)
 	{
-		out += it->second.currDensity[simulationIndex - 1];
+		out += heights[simulationIndex - 1];
 	}
 	
 	return out / 3.0f;
@@ -302,7 +244,6 @@ void WaveGenerator::addSimulationPosition(const tt::math::Point2& p_position,
                                           EdgeOption p_edgeOption, PoolSurfaceType p_poolType,
                                           FluidType p_fluidType)
 {
-	const real defaultHeight = 0.0f;
 	tt::math::Point2 startPos = getStartPos(p_position);
 	
 	SurfaceHeights::iterator it = m_surfaceHeights.find(startPos);
@@ -317,21 +258,24 @@ void WaveGenerator::addSimulationPosition(const tt::math::Point2& p_position,
 		    (rightIt->second.leftEdge == EdgeOption_LeftEdge ||
 		     rightIt->second.leftEdge == EdgeOption_LeftFadeout))
 		{
-			// swap the old data with the new data, and add space for the new tile in the front
-			newWaveData.prevDensity.swap(rightIt->second.prevDensity);
-			newWaveData.prevDensity.insert(newWaveData.prevDensity.begin(), 
-			                               convertQuadIndexToSimulationIndex(getWaveQuadsPerTile() * 2), 
-			                               defaultHeight);
-			newWaveData.currDensity.swap(rightIt->second.currDensity);
-			newWaveData.currDensity.insert(newWaveData.currDensity.begin(), 
-			                               convertQuadIndexToSimulationIndex(getWaveQuadsPerTile() * 2), 
-			                               defaultHeight);
+			// move the old data to the new data, and add space for the new tile in the front
+			const Reals::size_type frontSize = convertQuadIndexToSimulationIndex(getWaveQuadsPerTile() * 2);
+			newWaveData.size   = frontSize + rightIt->second.size;
+			newWaveData.offset = allocateHeights(newWaveData.size);
+			copyHeights(rightIt->second.offset, newWaveData.offset + frontSize, rightIt->second.size);
 			
+			releaseHeights(rightIt->second);
 			m_surfaceHeights.erase(rightIt);
 		}
 		
 		// if this startpos does not exist create a new WaveData with the position (not with the startPos)
-		it = m_surfaceHeights.insert(std::make_pair(p_position, newWaveData)).first;
+		std::pair<SurfaceHeights::iterator, bool> result =
+			m_surfaceHeights.insert(std::make_pair(p_position, newWaveData));
+		if (result.second == false)
+		{
+			releaseHeights(newWaveData);
+		}
+		it = result.first;
 		it->second.leftEdge = p_edgeOption;
 	}
 	// position is start position but not a left edge, Remove this simulation and append to simulation on the left.
@@ -342,8 +286,7 @@ void WaveGenerator::addSimulationPosition(const tt::math::Point2& p_position,
 		
 		if (leftIt == m_surfaceHeights.end()) return;
 		
-		leftIt->second.currDensity.insert(leftIt->second.currDensity.end(), it->second.currDensity.begin(),  it->second.currDensity.end());
-		leftIt->second.prevDensity.insert(leftIt->second.prevDensity.end(), it->second.prevDensity.begin(),  it->second.prevDensity.end());
+		appendHeights(leftIt->second, it->second);
 		
 		leftIt->second.rightEdge = it->second.rightEdge;
 		m_surfaceHeights.erase(it);
@@ -353,8 +296,6 @@ void WaveGenerator::addSimulationPosition(const tt::math::Point2& p_position,
 	
 	it->second.rightEdge = p_edgeOption;
 	
-	TT_ASSERT(it->second.prevDensity.size() == it->second.currDensity.size());
-	
 	const u32 maxsimulationIndex = getSimulationIndex(p_position, getWaveQuadsPerTile() * 2 + ExtraSimulationHeights, startPos);
 	
 	switch (p_poolType)
@@ -367,11 +308,10 @@ void WaveGenerator::addSimulationPosition(const tt::math::Point2& p_position,
 	
 	it->second.fluidType = p_fluidType;
 	
-	// make sure the vector is big enough for the max index and the ExtraSimulationHeights margins
-	if (it->second.prevDensity.size() < maxsimulationIndex + 1)
+	// make sure the span is big enough for the max index and the ExtraSimulationHeights margins
+	if (it->second.size < maxsimulationIndex + 1)
 	{
-		it->second.prevDensity.resize(maxsimulationIndex + 1, defaultHeight);
-		it->second.currDensity.resize(maxsimulationIndex + 1, defaultHeight);
+		resizeHeights(it->second, maxsimulationIndex + 1);
 	}
 	
 	it->second.isDead = false;
@@ -382,6 +322,10 @@ void WaveGenerator::addSimulationPosition(const tt::math::Point2& p_position,
 void WaveGenerator::handleLevelResized()
 {
 	m_surfaceHeights.clear();
+	m_prevHeights.clear();
+	m_currHeights.clear();
+	m_fadeFactors.clear();
+	m_unusedHeights = 0;
 }
 
 
@@ -391,27 +335,14 @@ void WaveGenerator::handleLevelResized()
 
 const tt::math::Point2& WaveGenerator::getStartPos(const tt::math::Point2& p_pos) const
 {
-	for (SurfaceHeights::const_iterator it = m_surfaceHeights.begin(); 
-	     it != m_surfaceHeights.end(); ++it)
+	// The surface on the same row that starts at or to the left of p_pos
+	SurfaceHeights::const_iterator it = m_surfaceHeights.upper_bound(p_pos);
+	if (it == m_surfaceHeights.begin())
 	{
-		if (it->first.y < p_pos.y) continue;
-		if (it->first.y > p_pos.y || it->first.x > p_pos.x)
-		{
-			return ms_invalidPos;
-		}
-		
-		if (it->first.x == p_pos.x) return it->first;
-		
-		SurfaceHeights::const_iterator nextIt = it; ++nextIt;
-		if (nextIt == m_surfaceHeights.end() || nextIt->first.x > p_pos.x || 
-		    nextIt->first.y > p_pos.y)
-		{
-			return it->first;
-		}
-		
-		if (nextIt->first.x == p_pos.x) return nextIt->first;
+		return ms_invalidPos;
 	}
-	return ms_invalidPos;
+	--it;
+	return (it->first.y == p_pos.y) ? it->first : ms_invalidPos;
 }
 
 
@@ -434,6 +365,297 @@ u32 WaveGenerator::convertQuadIndexToSimulationIndex(u32 p_waveQuadIndex) const
 }
 
 
+void WaveGenerator::updateWaveOffsets()
+{
+	for (s32 fluidType = 0; fluidType < FluidType_Count; ++fluidType)
+	{
+		for (s32 surfaceType = 0; surfaceType < PoolSurfaceType_Count; ++surfaceType)
+		{
+			PersistentWaves& waves(m_waveSettings[fluidType][surfaceType]);
+			for (PersistentWaves::iterator settsIt = waves.begin(); settsIt != waves.end(); ++settsIt)
+			{
+				const real phaseOffset = m_angle * settsIt->moveSpeed;
+				settsIt->offsetSin = tt::math::sin(phaseOffset);
+				settsIt->offsetCos = tt::math::cos(phaseOffset);
+			}
+		}
+	}
+}
+
+
+void WaveGenerator::updateWaveTables(Reals::size_type p_size)
+{
+	for (s32 fluidType = 0; fluidType < FluidType_Count; ++fluidType)
+	{
+		for (s32 surfaceType = 0; surfaceType < PoolSurfaceType_Count; ++surfaceType)
+		{
+			PersistentWaves& waves(m_waveSettings[fluidType][surfaceType]);
+			for (PersistentWaves::iterator settsIt = waves.begin(); settsIt != waves.end(); ++settsIt)
+			{
+				const Reals::size_type oldSize = settsIt->heightSin.size();
+				if (oldSize >= p_size)
+				{
+					continue;
+				}
+				
+				settsIt->heightSin.resize(p_size);
+				settsIt->heightCos.resize(p_size);
+				for (Reals::size_type i = oldSize; i < p_size; ++i)
+				{
+					const real phase = tt::math::pi * static_cast<real>(i) * settsIt->waveWidth;
+					settsIt->heightSin[i] = tt::math::sin(phase) * settsIt->waveHeight;
+					settsIt->heightCos[i] = tt::math::cos(phase) * settsIt->waveHeight;
+				}
+			}
+		}
+	}
+}
+
+
+void WaveGenerator::updateLayout(SimulationData& p_data)
+{
+	if (p_data.size != p_data.simulationSize)
+	{
+		resizeHeights(p_data, p_data.simulationSize);
+	}
+	
+	SimulationLayout layout;
+	layout.size              = p_data.size;
+	layout.rightEdge         = p_data.rightEdge;
+	layout.leftEdge          = p_data.leftEdge;
+	layout.leftToStillIndex  = p_data.leftToStillIndex;
+	layout.stillToRightIndex = p_data.stillToRightIndex;
+	layout.fluidType         = p_data.fluidType;
+	
+	if (layout == p_data.simulatedLayout)
+	{
+		return;
+	}
+	
+	// A changed surface is simulated again, even if it had settled
+	p_data.simulatedLayout = layout;
+	p_data.isSleeping      = false;
+	
+	updateWaveTables(p_data.size);
+	
+	// fade the sides that need fading
+	const Reals::iterator fadeFactors = m_fadeFactors.begin() + p_data.offset;
+	std::fill(fadeFactors, fadeFactors + p_data.size, 1.0f);
+	
+	const s32 stepsPerTile = m_simulationPointsPerTile;
+	for (Reals::size_type i = 1; i + 1 < p_data.size; ++i)
+	{
+		if (p_data.leftEdge == EdgeOption_LeftFadeout)
+		{
+			real fadeFactor;
+			if (i < ExtraSimulationHeights)
+			{
+				fadeFactor = 0.0f;
+			}
+			else if (i > static_cast<Reals::size_type>(stepsPerTile + ExtraSimulationHeights))
+			{
+				fadeFactor = 1.0f;
+			}
+			else
+			{
+				fadeFactor = (i - ExtraSimulationHeights) / static_cast<real>(stepsPerTile);
+			}
+			fadeFactors[i] *= fadeFactor;
+		}
+		if (p_data.rightEdge == EdgeOption_RightFadeout)
+		{
+			real fadeFactor;
+			Reals::size_type startSlope = p_data.size - static_cast<Reals::size_type>(stepsPerTile + ExtraSimulationHeights);
+			if (i > startSlope + stepsPerTile)
+			{
+				fadeFactor = 0.0f;
+			}
+			else if (i < startSlope)
+			{
+				fadeFactor = 1.0f;
+			}
+			else
+			{
+				fadeFactor = 1 - ((i - startSlope) / static_cast<real>(stepsPerTile));
+			}
+			fadeFactors[i] *= fadeFactor;
+		}
+	}
+}
+
+
+void WaveGenerator::simulate(SimulationData& p_data)
+{
+	if (p_data.size < 3)
+	{
+		return;
+	}
+	
+	// None of the loops below branch per height, so the compiler can vectorize them.
+	real*       prev = &m_prevHeights[p_data.offset];
+	real*       curr = &m_currHeights[p_data.offset];
+	const real* fade = &m_fadeFactors[p_data.offset];
+	
+	const Reals::size_type last              = p_data.size - 1;
+	const real             diffusion         = m_diffusion        [p_data.fluidType];
+	const real             velocityDiffusion = m_velocitydiffusion[p_data.fluidType];
+	const real             minHeight         = m_minHeight;
+	const real             maxHeight         = m_maxHeight;
+	
+	// SIMULATION LOGIC (Shallow water equation)
+	//----------------------
+	// The left neighbour is used clamped and faded, as if the heights were updated in place from left to right.
+	for (Reals::size_type i = 1; i < last; ++i)
+	{
+		const real left     = std::min(std::max(prev[i - 1], minHeight), maxHeight) * fade[i - 1];
+		const real velocity = prev[i] - curr[i];
+		const real smooth   = (left + prev[i + 1]) / 2.0f;
+		
+		curr[i] = (smooth + velocity * velocityDiffusion) * diffusion;
+	}
+	//----------------------
+	
+	// Generate waves from the wave settings; each part of the pool is a range of indices
+	Reals::size_type partBegin[PoolSurfaceType_Count + 1];
+	partBegin[PoolSurfaceType_Left ] = 1;
+	partBegin[PoolSurfaceType_Still] = std::min(std::max(p_data.leftToStillIndex, Reals::size_type(1)), last);
+	partBegin[PoolSurfaceType_Right] = std::min(std::max(std::max(p_data.leftToStillIndex,
+		p_data.stillToRightIndex + 1), Reals::size_type(1)), last);
+	partBegin[PoolSurfaceType_Count] = last;
+	
+	for (s32 surfaceType = 0; surfaceType < PoolSurfaceType_Count; ++surfaceType)
+	{
+		const PersistentWaves& waves(m_waveSettings[p_data.fluidType][surfaceType]);
+		for (PersistentWaves::const_iterator settsIt = waves.begin(); settsIt != waves.end(); ++settsIt)
+		{
+			const real* heightSin = &settsIt->heightSin[0];
+			const real* heightCos = &settsIt->heightCos[0];
+			const real  offsetSin = settsIt->offsetSin;
+			const real  offsetCos = settsIt->offsetCos;
+			
+			for (Reals::size_type i = partBegin[surfaceType]; i < partBegin[surfaceType + 1]; ++i)
+			{
+				curr[i] += heightSin[i] * offsetCos + heightCos[i] * offsetSin;
+			}
+		}
+	}
+	
+	// clamp the heights and fade the sides that need fading
+	real largestHeight = std::max(std::max(tt::math::fabs(prev[0]),    tt::math::fabs(curr[0])),
+	                              std::max(tt::math::fabs(prev[last]), tt::math::fabs(curr[last])));
+	for (Reals::size_type i = 1; i < last; ++i)
+	{
+		curr[i] = std::min(std::max(curr[i], minHeight), maxHeight) * fade[i];
+		prev[i] = std::min(std::max(prev[i], minHeight), maxHeight) * fade[i];
+		
+		largestHeight = std::max(largestHeight, std::max(tt::math::fabs(curr[i]), tt::math::fabs(prev[i])));
+	}
+	
+	// Stop simulating a surface that settled, until a wave or a layout change wakes it up
+	if (largestHeight < sleepHeight)
+	{
+		std::fill(prev, prev + p_data.size, 0.0f);
+		std::fill(curr, curr + p_data.size, 0.0f);
+		p_data.isSleeping = true;
+	}
+}
+
+
+WaveGenerator::Reals::size_type WaveGenerator::allocateHeights(Reals::size_type p_count)
+{
+	const Reals::size_type offset = m_prevHeights.size();
+	m_prevHeights.resize(offset + p_count, 0.0f);
+	m_currHeights.resize(offset + p_count, 0.0f);
+	m_fadeFactors.resize(offset + p_count, 1.0f);
+	return offset;
+}
+
+
+void WaveGenerator::copyHeights(Reals::size_type p_from, Reals::size_type p_to, Reals::size_type p_count)
+{
+	std::copy(m_prevHeights.begin() + p_from, m_prevHeights.begin() + p_from + p_count, m_prevHeights.begin() + p_to);
+	std::copy(m_currHeights.begin() + p_from, m_currHeights.begin() + p_from + p_count, m_currHeights.begin() + p_to);
+}
+
+
+void WaveGenerator::resizeHeights(SimulationData& p_data, Reals::size_type p_size)
+{
+	if (p_size <= p_data.size)
+	{
+		// The heights at the end are no longer used
+		m_unusedHeights += p_data.size - p_size;
+		p_data.size = p_size;
+		return;
+	}
+	
+	if (p_data.offset + p_data.size == m_prevHeights.size())
+	{
+		// The span is at the end of the arenas, so it can grow in place
+		allocateHeights(p_size - p_data.size);
+		p_data.size = p_size;
+		return;
+	}
+	
+	const Reals::size_type offset = allocateHeights(p_size);
+	copyHeights(p_data.offset, offset, p_data.size);
+	releaseHeights(p_data);
+	p_data.offset = offset;
+	p_data.size   = p_size;
+}
+
+
+void WaveGenerator::appendHeights(SimulationData& p_data, SimulationData& p_appendData)
+{
+	const Reals::size_type size   = p_data.size + p_appendData.size;
+	const Reals::size_type offset = allocateHeights(size);
+	copyHeights(p_data.offset,       offset,               p_data.size);
+	copyHeights(p_appendData.offset, offset + p_data.size, p_appendData.size);
+	
+	releaseHeights(p_data);
+	releaseHeights(p_appendData);
+	p_data.offset = offset;
+	p_data.size   = size;
+}
+
+
+void WaveGenerator::releaseHeights(SimulationData& p_data)
+{
+	m_unusedHeights += p_data.size;
+	p_data.offset = 0;
+	p_data.size   = 0;
+}
+
+
+void WaveGenerator::compactHeights()
+{
+	const Reals::size_type usedHeights = m_prevHeights.size() - m_unusedHeights;
+	
+	Reals prevHeights;
+	Reals currHeights;
+	Reals fadeFactors;
+	prevHeights.reserve(usedHeights);
+	currHeights.reserve(usedHeights);
+	fadeFactors.reserve(usedHeights);
+	
+	// Store the surfaces in the order they are simulated
+	for (SurfaceHeights::iterator it = m_surfaceHeights.begin(); it != m_surfaceHeights.end(); ++it)
+	{
+		const Reals::size_type begin = it->second.offset;
+		const Reals::size_type end   = it->second.offset + it->second.size;
+		
+		it->second.offset = prevHeights.size();
+		prevHeights.insert(prevHeights.end(), m_prevHeights.begin() + begin, m_prevHeights.begin() + end);
+		currHeights.insert(currHeights.end(), m_currHeights.begin() + begin, m_currHeights.begin() + end);
+		fadeFactors.insert(fadeFactors.end(), m_fadeFactors.begin() + begin, m_fadeFactors.begin() + end);
+	}
+	
+	m_prevHeights.swap(prevHeights);
+	m_currHeights.swap(currHeights);
+	m_fadeFactors.swap(fadeFactors);
+	m_unusedHeights = 0;
+}
+
+
 // Namespace end
 }
 }
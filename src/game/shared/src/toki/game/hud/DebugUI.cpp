@@ -16,6 +16,7 @@
 #include <tt/platform/tt_error.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/profiler/PerformanceProfiler.h>
+#include <tt/profiler/TraceRecorder.h>
 
 #include <toki/game/entity/graphics/TextLabelMgr.h>
 #include <toki/game/entity/EntityMgr.h>
@@ -31,6 +32,7 @@ namespace game {
 namespace hud {
 
 static const char* const g_debugUiSettingsFile = "debug_ui_settings.json";
+static const char* const g_traceDumpFile        = "trace.json";
 
 static const int g_itemSpacing = 2;
 
@@ -229,6 +231,7 @@ void DebugUI::setupHotKeys()
 	addGenericHotKey    (tt::input::Key_O, M(Modifier_Control), &DebugUI::hotKeyShowLoadLevelDialog);
 	addGenericHotKey    (tt::input::Key_W, M(Modifier_Control), &DebugUI::hotKeyToggleFluidGraphics);
 	addGenericHotKey    (tt::input::Key_F, M(Modifier_Control), &DebugUI::hotKeyCycleSectionProfiler);
+	addGenericHotKey    (tt::input::Key_F, M(Modifier_Control) | M(Modifier_Shift), &DebugUI::hotKeyDumpTrace);
 	
 	// Alt+key hotkeys
 	addDebugRenderHotKey(tt::input::Key_1, M(Modifier_Alt), DebugRender_PathMgrAgents);
@@ -595,6 +598,21 @@ void DebugUI::hotKeyCycleSectionProfiler()
 }
 
 
+void DebugUI::hotKeyDumpTrace()
+{
+	// Writes the last few seconds of trace events of all threads (open it with chrome://tracing)
+	tt::fs::FilePtr file = savedata::createSaveFile(g_traceDumpFile);
+	if (tt::profiler::TraceRecorder::dumpChromeTrace(file) == false)
+	{
+		TT_PANIC("Writing trace events to '%s' failed.", g_traceDumpFile);
+		return;
+	}
+	file.reset();
+	savedata::commitSaveData();
+	TT_Printf("DebugUI::hotKeyDumpTrace: Trace events written to '%s'.\n", g_traceDumpFile);
+}
+
+
 void DebugUI::hotKeyToggleCameraFollowEntity()
 {
 	if (AppGlobal::hasGame())
@@ -12,6 +12,7 @@
 #include <toki/game/light/JitterEffect.h>
 #include <toki/game/light/Light.h>
 #include <toki/game/light/LightMgr.h>
+#include <toki/game/light/LightRayBatch.h>
 #include <toki/game/script/EntityBase.h>
 #include <toki/game/Game.h>
 #include <toki/level/LevelData.h>
@@ -92,17 +93,17 @@ void Light::update(real p_deltaTime)
 }
 
 
-void Light::updateLightShape(const Polygons& p_occluders)
+bool Light::updateLightShape(const Polygons& p_occluders)
 {
 	if (isActive() == false)
 	{
-		return;
+		return false;
 	}
 	TT_ASSERT(m_strength.getValue() >= 0.0f && m_strength.getValue() <= 1.0f);
 	
 	//TT_MINMAX_ASSERT(m_strength.getValue(), 0.0f, 1.0f);
 	
-	m_lightShape.update(0.0f, p_occluders, m_colorAlpha);
+	return m_lightShape.update(0.0f, p_occluders, m_colorAlpha);
 }
 
 
@@ -151,8 +152,7 @@ void Light::debugRender()
 }
 
 
-void Light::getAffectedEntities(entity::EntityHandleSet&        p_entities,
-                                const level::AttributeLayerPtr& /*p_attribs*/)
+void Light::addAffectedEntityRays(LightRayBatch& p_batch)
 {
 	const entity::EntityMgr& entityMgr = AppGlobal::getGame()->getEntityMgr();
 	const level::TileRegistrationMgr& tileMgr = AppGlobal::getGame()->getTileRegistrationMgr();
@@ -217,20 +217,39 @@ void Light::getAffectedEntities(entity::EntityHandleSet&        p_entities,
 			if(tileMgr.hasEntityAtPosition(pos.x, pos.y))
 			{
 				// Handle entities at this position
-				const entity::EntityHandleSet& entities = tileMgr.getRegisteredEntityHandles(pos);
+				const level::TileRegistrationMgr::EntityHandleRange entities(tileMgr.getRegisteredEntityHandles(pos));
 				
-				for (entity::EntityHandleSet::const_iterator it = entities.begin();
+				for (level::TileRegistrationMgr::EntityHandleRange::const_iterator it = entities.begin();
 					 it != entities.end(); ++it)
 				{
 					const entity::Entity* targetEntity = entityMgr.getEntity(*it);
 					
-					if (targetEntity != 0                        && // Check if target is alive
-						targetEntity->isSuspended() == false     && // Target should not be suspended
-						targetEntity->isDetectableByLight()      && // Target should be affected by light
-						p_entities.find(*it) == p_entities.end() && // Not already part of the set of affected entities
-						isInLight(*targetEntity))                   // In light.
+					if (targetEntity == 0                           || // Check if target is alive
+						targetEntity->isSuspended()                 || // Target should not be suspended
+						targetEntity->isDetectableByLight() == false)  // Target should be affected by light
+					{
+						continue;
+					}
+					
+					const s32 group = p_batch.startEntity(*it, this);
+					if (group < 0)
+					{
+						// Already added for this light.
+						continue;
+					}
+					
+					// The rays are traced later, together with those of all other lights.
+					const entity::Entity::DetectionPoints& points(targetEntity->getLightDetectionPoints());
+					const tt::math::Vector2 position(targetEntity->getCenterPosition());
+					for (entity::Entity::DetectionPoints::const_iterator pointIt = points.begin();
+					     pointIt != points.end(); ++pointIt)
 					{
-						p_entities.insert(*it);
+						const tt::math::Vector2 pointPos(position + (*pointIt));
+						if (distanceSquared(sourcePos, pointPos) <= m_radiusSquared &&
+						    m_lightShape.inSpread(sourcePos, pointPos))
+						{
+							p_batch.addRay(sourcePos, pointPos, group);
+						}
 					}
 				}
 			}
@@ -246,7 +265,8 @@ bool Light::isInLight(const tt::math::Vector2& p_position) const
 	       affectsEntities() &&
 	       distanceSquared(       getWorldPosition(), p_position) <= m_radiusSquared &&
 	       m_lightShape.inSpread( getWorldPosition(), p_position) &&
-	       tt::code::tileRayTrace(getWorldPosition(), p_position, lightHitTest, 0);
+	       AppGlobal::getGame()->getTileRegistrationMgr().getLightBlockingTiles().traceRay(
+	               getWorldPosition(), p_position);
 }
 
 
@@ -1,5 +1,7 @@
 #include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <map>
 
 #include <tt/code/bufferutils.h>
 #include <tt/code/helpers.h>
@@ -49,6 +51,16 @@ s32                                   LightMgr::ms_blurPassCount = 2;
 
 static const real quadSizeCorrection = 1.0f / (2.0f * tt::engine::renderer::Quad2D::quadSize);
 
+// Static occluders are tile aligned quads, identified by their min and max corner.
+typedef std::pair<u64, u64>              QuadKey;
+typedef std::multimap<QuadKey, Polygon*> QuadPolygons;
+
+static inline u64 getCornerKey(const tt::math::Vector2& p_corner)
+{
+	return (static_cast<u64>(static_cast<u32>(static_cast<s32>(p_corner.x))) << 32) |
+	        static_cast<u64>(static_cast<u32>(static_cast<s32>(p_corner.y)));
+}
+
 //--------------------------------------------------------------------------------------------------
 // Public member functions
 
@@ -63,8 +75,11 @@ m_wholeLevelFullAlpha(),
 m_fullScreenMtx(),
 m_lightAmbient(0),
 m_staticOccluders(),
+m_staticOccluderGrid(),
 m_dynamicOccluders(),
-m_allOccluders(),
+m_dynamicOccludersList(),
+m_visibleLightOccluders(),
+m_lightRayBatch(),
 m_levelLayer(p_levelLayer),
 m_currentTime(0.0f),
 m_dirty(true),
@@ -74,7 +89,10 @@ m_defaultLightAmbient(128),
 #if DO_LIGHT_BLOB_QUAD_DEBUG_RENDER
 m_debugQuads(),
 #endif
-m_sectionProfiler("LightMgr - update")
+m_sectionProfiler("LightMgr - update"),
+m_rebuiltLightShapesCounter(m_sectionProfiler.registerCounter("Light shapes rebuilt")),
+m_reusedLightShapesCounter(m_sectionProfiler.registerCounter("Light shapes reused")),
+m_lightRaysCounter(m_sectionProfiler.registerCounter("Light rays traced"))
 {
 	using tt::engine::renderer::ColorRGB;
 	using tt::engine::renderer::ColorRGBA;
@@ -306,16 +324,44 @@ void LightMgr::updateForRender(const tt::math::VectorRect& p_visibilityRect, s32
 		}
 	}
 	
+	if (m_visibleLightOccluders.size() < m_visibleLights.size())
+	{
+		m_visibleLightOccluders.resize(m_visibleLights.size());
+	}
+	
+	std::atomic<s32> rebuiltCount(0);
 #if USE_THREADING
 	tt::thread::ThreadedWorkload work(m_visibleLights.size(),
-		std::bind(&LightMgr::updateLightShape, this, std::placeholders::_1, m_allOccluders));
+		[this, &rebuiltCount](size_t p_index)
+		{
+			if (updateLightShape(p_index))
+			{
+				++rebuiltCount;
+			}
+		});
 	work.startAndWaitForCompletion();
 #else
-	for (LightPtrs::iterator it = m_visibleLights.begin(); it != m_visibleLights.end(); ++it)
+	for (size_t i = 0; i < m_visibleLights.size(); ++i)
 	{
-		(*it)->updateLightShape(m_allOccluders);
+		if (updateLightShape(i))
+		{
+			++rebuiltCount;
+		}
 	}
 #endif
+	
+	// Inactive lights don't have a light shape, so they're neither rebuilt nor reused.
+	s32 activeCount = 0;
+	for (LightPtrs::const_iterator it = m_visibleLights.begin(); it != m_visibleLights.end(); ++it)
+	{
+		if ((*it)->isActive())
+		{
+			++activeCount;
+		}
+	}
+	const s32 rebuilt = rebuiltCount.load();
+	m_sectionProfiler.setCounter(m_rebuiltLightShapesCounter, rebuilt);
+	m_sectionProfiler.setCounter(m_reusedLightShapesCounter,  activeCount - rebuilt);
 }
 
 
@@ -525,7 +571,7 @@ void LightMgr::endLightRender(const tt::engine::scene2d::shoebox::ShoeboxPtr& p_
 		
 #if !defined(TT_BUILD_FINAL)
 		/* // Outline rendering of polygons.
-		for (Polygons::const_iterator it = m_allOccluders.begin(); it != m_allOccluders.end(); ++it)
+		for (Polygons::const_iterator it = m_staticOccluders.begin(); it != m_staticOccluders.end(); ++it)
 		{
 			(*it)->render();
 		}
@@ -610,13 +656,14 @@ void LightMgr::debugRender()
 #if !defined(TT_BUILD_FINAL)
 	if (AppGlobal::getDebugRenderMask().checkFlag(DebugRender_Light) && shouldDoLight())
 	{
+		LightOccluders occluders;
 		Light* light = m_lights.getFirst();
 		for (s32 i = 0; i <  m_lights.getActiveCount(); ++i, ++light)
 		{
 			light->debugRender();
 			
 			// /*
-			light->updateLightShape(m_allOccluders);
+			light->updateLightShape(getOccluders(*light, occluders));
 			light->render();
 			// */
 		}
@@ -817,9 +864,16 @@ void LightMgr::updateStaticOccluders()
 #if DO_LIGHT_BLOB_QUAD_DEBUG_RENDER
 	m_debugQuads.clear();
 #endif
-	const size_t oldSize = m_staticOccluders.size();
-	tt::code::helpers::freePointerContainer(m_staticOccluders);
-	m_staticOccluders.reserve(oldSize);
+	// Keep the polygons of quads that didn't change, so lights near them can keep their light shape.
+	QuadPolygons oldOccluders;
+	for (Polygons::const_iterator it = m_staticOccluders.begin(); it != m_staticOccluders.end(); ++it)
+	{
+		const tt::math::VectorRect rect((*it)->getWorldRect());
+		oldOccluders.insert(std::make_pair(QuadKey(getCornerKey(rect.getMin()), getCornerKey(rect.getMaxEdge())), *it));
+	}
+	
+	Polygons newOccluders;
+	newOccluders.reserve(m_staticOccluders.size());
 	
 	for (BlobData::Blobs::const_iterator blobIt = blobData.allBlobs.begin();
 	     blobIt != blobData.allBlobs.end(); ++blobIt)
@@ -849,17 +903,30 @@ void LightMgr::updateStaticOccluders()
 			const tt::math::Vector2 min(subQuad.min);
 			const tt::math::Vector2 max(subQuad.max + tt::math::Point2::allOne);
 			
+			QuadPolygons::iterator oldIt = oldOccluders.find(QuadKey(getCornerKey(min), getCornerKey(max)));
+			if (oldIt != oldOccluders.end())
+			{
+				newOccluders.push_back(oldIt->second);
+				oldOccluders.erase(oldIt);
+				continue;
+			}
+			
 			Vertices vertices;
 			vertices.push_back(min);
 			vertices.push_back(Vector2(max.x, min.y));
 			vertices.push_back(max);
 			vertices.push_back(Vector2(min.x, max.y));
 			
-			m_staticOccluders.push_back(new Polygon(Vector2(0.0f, 0.0f), 
-			                                        tt::engine::renderer::ColorRGB::green,
-			                                        vertices, true));
+			newOccluders.push_back(new Polygon(Vector2(0.0f, 0.0f), 
+			                                   tt::engine::renderer::ColorRGB::green,
+			                                   vertices, true));
 		}
 	}
+	
+	tt::code::helpers::freePairSecondContainer(oldOccluders);
+	std::swap(m_staticOccluders, newOccluders);
+	
+	m_staticOccluderGrid.rebuild(m_staticOccluders, width, height);
 }
 
 
@@ -921,21 +988,42 @@ bool LightMgr::updateDynamicOccluders()
 
 void LightMgr::mergeStaticWithDynamicOccluders()
 {
-	m_allOccluders.clear();
-	m_allOccluders.reserve(m_staticOccluders.size() + m_dynamicOccluders.size());
-	m_allOccluders.insert(m_allOccluders.end(), m_staticOccluders.begin(), m_staticOccluders.end());
+	// The static occluders are looked up in m_staticOccluderGrid; the few dynamic ones are
+	// checked one by one for every light.
+	m_dynamicOccludersList.clear();
+	m_dynamicOccludersList.reserve(m_dynamicOccluders.size());
 	for (EntityPolygons::const_iterator it = m_dynamicOccluders.begin(); it != m_dynamicOccluders.end(); ++it)
 	{
-		m_allOccluders.push_back(it->second);
+		m_dynamicOccludersList.push_back(it->second);
+	}
+}
+
+
+const Polygons& LightMgr::getOccluders(const Light& p_light, LightOccluders& p_buffers) const
+{
+	const tt::math::VectorRect rect(p_light.getLightShapeRect());
+	
+	p_buffers.occluders.clear();
+	m_staticOccluderGrid.getOccluders(rect, p_buffers.occluders, p_buffers.indices);
+	for (Polygons::const_iterator it = m_dynamicOccludersList.begin(); it != m_dynamicOccludersList.end(); ++it)
+	{
+		if (OccluderGrid::overlaps((*it)->getWorldRect(), rect))
+		{
+			p_buffers.occluders.push_back(*it);
+		}
 	}
+	
+	return p_buffers.occluders;
 }
 
 
-void LightMgr::updateLightShape(size_t p_index, const Polygons& p_occluders)
+bool LightMgr::updateLightShape(size_t p_index)
 {
 	TT_ASSERT(p_index < m_visibleLights.size());
+	TT_ASSERT(p_index < m_visibleLightOccluders.size());
 	
-	m_visibleLights[p_index]->updateLightShape(p_occluders);
+	Light* light = m_visibleLights[p_index];
+	return light->updateLightShape(getOccluders(*light, m_visibleLightOccluders[p_index]));
 }
 
 
@@ -1047,14 +1135,20 @@ void LightMgr::updateSensors()
 	// No darkness rect logic for rewind
 	//if (m_isDarkLevel)
 	{
+		// Collect the rays of all lights first, then trace them all against the light-blocking tiles.
+		m_lightRayBatch.clear();
 		Light* light = m_lights.getFirst();
 		for (s32 i = 0; i < m_lights.getActiveCount(); ++i, ++light)
 		{
 			if (light->isEnabled())
 			{
-				light->getAffectedEntities(currentLitEntities, m_levelLayer);
+				light->addAffectedEntityRays(m_lightRayBatch);
 			}
 		}
+		
+		m_lightRayBatch.trace(AppGlobal::getGame()->getTileRegistrationMgr().getLightBlockingTiles());
+		m_lightRayBatch.getLitEntities(currentLitEntities);
+		m_sectionProfiler.setCounter(m_lightRaysCounter, m_lightRayBatch.getRayCount());
 	}
 #if 0 // No darkness rect logic for rewind
 	else
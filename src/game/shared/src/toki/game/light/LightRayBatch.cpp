@@ -0,0 +1,79 @@
+#include <tt/platform/tt_error.h>
+
+#include <toki/game/light/LightRayBatch.h>
+
+
+namespace toki {
+namespace game {
+namespace light {
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+LightRayBatch::LightRayBatch()
+:
+m_rays(),
+m_groups(),
+m_groupEntities(),
+m_groupLights(),
+m_groupResults()
+{
+}
+
+
+void LightRayBatch::clear()
+{
+	// Keep the capacity of the vectors; they are filled again every update.
+	m_rays.clear();
+	m_groups.clear();
+	m_groupEntities.clear();
+	m_groupLights.clear();
+	m_groupResults.clear();
+}
+
+
+s32 LightRayBatch::startEntity(const entity::EntityHandle& p_entity, const Light* p_light)
+{
+	const s32 newGroup = static_cast<s32>(m_groupEntities.size());
+	std::pair<Groups::iterator, bool> result(m_groups.insert(std::make_pair(p_entity, newGroup)));
+	const s32 group = result.first->second;
+	if (result.second)
+	{
+		m_groupEntities.push_back(p_entity);
+		m_groupLights.push_back(p_light);
+		return group;
+	}
+	
+	// An entity is found once for every cell it is registered in; only add its rays once per light.
+	if (m_groupLights[group] == p_light)
+	{
+		return -1;
+	}
+	m_groupLights[group] = p_light;
+	return group;
+}
+
+
+void LightRayBatch::trace(const level::TileBitmap& p_lightBlockingTiles)
+{
+	m_groupResults.assign(m_groupEntities.size(), 0);
+	p_lightBlockingTiles.traceRays(m_rays, m_groupResults);
+}
+
+
+void LightRayBatch::getLitEntities(entity::EntityHandleSet& p_entities_OUT) const
+{
+	TT_ASSERT(m_groupResults.size() == m_groupEntities.size());
+	for (level::TileBitmap::GroupResults::size_type i = 0; i < m_groupResults.size(); ++i)
+	{
+		if (m_groupResults[i] != 0)
+		{
+			p_entities_OUT.insert(m_groupEntities[i]);
+		}
+	}
+}
+
+// Namespace end
+}
+}
+}
@@ -38,7 +38,15 @@ m_distanceSort(),
 m_toRender(),
 m_toAddToRenderOutSideLoop(),
 m_shadowsScratch(),
-m_backFacingScratch()
+m_backFacingScratch(),
+m_tracedShapeValid(false),
+m_tracedCenterPos(tt::math::Vector2::zero),
+m_tracedRadius(0.0f),
+m_tracedDirection(0.0f),
+m_tracedHalfSpread(0.0f),
+m_tracedColor(),
+m_tracedCenterAlpha(0),
+m_tracedOccluders()
 #ifdef USE_DEBUG_SHAPE
 ,
 m_debug(p_centerPos, p_radius, tt::engine::renderer::ColorRGB::blue)
@@ -76,8 +84,13 @@ void LightShape::setTexture(const std::string& p_textureName)
 }
 
 
-void LightShape::update(real /*p_elapsedTime*/, const Polygons& p_occluders, u8 p_centerAlpha)
+bool LightShape::update(real /*p_elapsedTime*/, const Polygons& p_occluders, u8 p_centerAlpha)
 {
+	if (updateTracedInputs(p_occluders, p_centerAlpha) == false)
+	{
+		return false;
+	}
+	
 	/*
 	BufferVtxUV<1> graphicsVtx;
 	typedef std::vector<BufferVtxUV<1> > Graphics;
@@ -358,6 +371,7 @@ void LightShape::update(real /*p_elapsedTime*/, const Polygons& p_occluders, u8
 	}
 	
 	calculateCircle(shadows, p_centerAlpha);
+	return true;
 }
 
 
@@ -420,6 +434,8 @@ void LightShape::unserialize(tt::code::BufferReadContext* p_context)
 	m_halfSpread      = bu::get<real                          >(p_context);
 	m_color           = bu::get<tt::engine::renderer::ColorRGB>(p_context);
 	m_textureOverride = bu::get<std::string                   >(p_context);
+	
+	invalidateShape();
 }
 
 
@@ -427,6 +443,52 @@ void LightShape::unserialize(tt::code::BufferReadContext* p_context)
 // Private functions
 
 
+bool LightShape::updateTracedInputs(const Polygons& p_occluders, u8 p_centerAlpha)
+{
+	bool changed = m_tracedShapeValid == false       ||
+	               m_tracedCenterPos   != m_centerPos  ||
+	               m_tracedRadius      != m_radius     ||
+	               m_tracedDirection   != m_direction  ||
+	               m_tracedHalfSpread  != m_halfSpread ||
+	               m_tracedColor       != m_color      ||
+	               m_tracedCenterAlpha != p_centerAlpha ||
+	               m_tracedOccluders.size() != p_occluders.size();
+	
+	if (changed == false)
+	{
+		Polygons::const_iterator occluderIt = p_occluders.begin();
+		for (Revisions::const_iterator it = m_tracedOccluders.begin(); it != m_tracedOccluders.end();
+		     ++it, ++occluderIt)
+		{
+			if ((*it) != (*occluderIt)->getRevision())
+			{
+				changed = true;
+				break;
+			}
+		}
+	}
+	
+	if (changed == false)
+	{
+		return false;
+	}
+	
+	m_tracedShapeValid  = true;
+	m_tracedCenterPos   = m_centerPos;
+	m_tracedRadius      = m_radius;
+	m_tracedDirection   = m_direction;
+	m_tracedHalfSpread  = m_halfSpread;
+	m_tracedColor       = m_color;
+	m_tracedCenterAlpha = p_centerAlpha;
+	m_tracedOccluders.clear();
+	for (Polygons::const_iterator it = p_occluders.begin(); it != p_occluders.end(); ++it)
+	{
+		m_tracedOccluders.push_back((*it)->getRevision());
+	}
+	return true;
+}
+
+
 void LightShape::calculateCircle(const Shadows& p_shadows, u8 p_centerAlpha)
 {
 	using namespace tt::engine::renderer;
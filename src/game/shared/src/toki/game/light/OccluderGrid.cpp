@@ -0,0 +1,156 @@
+#include <algorithm>
+
+#include <tt/math/math.h>
+#include <tt/platform/tt_error.h>
+
+#include <toki/game/light/OccluderGrid.h>
+#include <toki/game/light/Polygon.h>
+
+
+namespace toki {
+namespace game {
+namespace light {
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+OccluderGrid::OccluderGrid(s32 p_cellSize)
+:
+m_cellSize(p_cellSize),
+m_width(0),
+m_height(0),
+m_occluders(),
+m_bounds(),
+m_cellRanges(),
+m_cellStart(),
+m_cellOccluders()
+{
+	TT_ASSERT(m_cellSize > 0);
+}
+
+
+void OccluderGrid::rebuild(const Polygons& p_occluders, s32 p_levelWidth, s32 p_levelHeight)
+{
+	m_width  = std::max((p_levelWidth  + m_cellSize - 1) / m_cellSize, s32(1));
+	m_height = std::max((p_levelHeight + m_cellSize - 1) / m_cellSize, s32(1));
+	
+	m_occluders = p_occluders;
+	const s32 occluderCount = getOccluderCount();
+	
+	m_bounds.resize(m_occluders.size());
+	m_cellRanges.resize(m_occluders.size());
+	m_cellStart.assign(static_cast<OccluderIndices::size_type>(m_width * m_height + 1), 0);
+	
+	// Count the occluders per cell first, so all cells can share one array.
+	for (s32 i = 0; i < occluderCount; ++i)
+	{
+		m_bounds[i]     = m_occluders[i]->getWorldRect();
+		m_cellRanges[i] = getCellRange(m_bounds[i]);
+		
+		const CellRange& range(m_cellRanges[i]);
+		for (s32 y = range.minY; y <= range.maxY; ++y)
+		{
+			for (s32 x = range.minX; x <= range.maxX; ++x)
+			{
+				++m_cellStart[y * m_width + x + 1];
+			}
+		}
+	}
+	
+	for (OccluderIndices::size_type i = 1; i < m_cellStart.size(); ++i)
+	{
+		m_cellStart[i] += m_cellStart[i - 1];
+	}
+	
+	// Fill the cells; occluders are added in order, so every cell is sorted by occluder index.
+	m_cellOccluders.resize(static_cast<OccluderIndices::size_type>(m_cellStart.back()));
+	OccluderIndices fillIndex(m_cellStart.begin(), m_cellStart.end() - 1);
+	for (s32 i = 0; i < occluderCount; ++i)
+	{
+		const CellRange& range(m_cellRanges[i]);
+		for (s32 y = range.minY; y <= range.maxY; ++y)
+		{
+			for (s32 x = range.minX; x <= range.maxX; ++x)
+			{
+				m_cellOccluders[fillIndex[y * m_width + x]++] = i;
+			}
+		}
+	}
+}
+
+
+void OccluderGrid::getOccluders(const tt::math::VectorRect& p_rect, Polygons& p_occluders_OUT,
+                                OccluderIndices& p_scratch) const
+{
+	if (m_occluders.empty())
+	{
+		return;
+	}
+	
+	p_scratch.clear();
+	const CellRange query(getCellRange(p_rect));
+	for (s32 y = query.minY; y <= query.maxY; ++y)
+	{
+		for (s32 x = query.minX; x <= query.maxX; ++x)
+		{
+			const s32 cell = y * m_width + x;
+			for (s32 i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i)
+			{
+				const s32        index = m_cellOccluders[i];
+				const CellRange& range(m_cellRanges[index]);
+				
+				// An occluder can be in more than one cell of the query; only report it
+				// from the first one (the cell with the lowest coordinates in both the query and the occluder).
+				if (std::max(query.minX, range.minX) == x &&
+				    std::max(query.minY, range.minY) == y &&
+				    overlaps(m_bounds[index], p_rect))
+				{
+					p_scratch.push_back(index);
+				}
+			}
+		}
+	}
+	
+	std::sort(p_scratch.begin(), p_scratch.end());
+	for (OccluderIndices::const_iterator it = p_scratch.begin(); it != p_scratch.end(); ++it)
+	{
+		p_occluders_OUT.push_back(m_occluders[*it]);
+	}
+}
+
+
+bool OccluderGrid::overlaps(const tt::math::VectorRect& p_a, const tt::math::VectorRect& p_b)
+{
+	// Touching counts as overlapping
+	return p_a.getMin().x     <= p_b.getMaxEdge().x &&
+	       p_a.getMaxEdge().x >= p_b.getMin().x     &&
+	       p_a.getMin().y     <= p_b.getMaxEdge().y &&
+	       p_a.getMaxEdge().y >= p_b.getMin().y;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+OccluderGrid::CellRange OccluderGrid::getCellRange(const tt::math::VectorRect& p_rect) const
+{
+	CellRange range;
+	range.minX = getCell(p_rect.getMin().x,     m_width);
+	range.minY = getCell(p_rect.getMin().y,     m_height);
+	range.maxX = getCell(p_rect.getMaxEdge().x, m_width);
+	range.maxY = getCell(p_rect.getMaxEdge().y, m_height);
+	return range;
+}
+
+
+s32 OccluderGrid::getCell(real p_position, s32 p_cellCount) const
+{
+	s32 cell = static_cast<s32>(tt::math::floor(p_position / static_cast<real>(m_cellSize)));
+	tt::math::clamp(cell, s32(0), p_cellCount - 1);
+	return cell;
+}
+
+// Namespace end
+}
+}
+}
@@ -17,6 +17,8 @@ namespace toki {
 namespace game {
 namespace light {
 
+std::atomic<u32> Polygon::ms_lastRevision(0);
+
 
 //--------------------------------------------------------------------------------------------------
 // Public member functions
@@ -30,7 +32,12 @@ Polygon::Polygon(const tt::math::Vector2& p_pos,
 m_pos(p_pos),
 m_color(p_color),
 m_vertices(p_vertices),
-m_geometryReady(false)
+m_geometryReady(false),
+m_boundingSphereMidPoint(tt::math::Vector2::zero),
+m_boundingSphereRadius(0.0f),
+m_min(tt::math::Vector2::zero),
+m_max(tt::math::Vector2::zero),
+m_revision(0)
 #ifndef TT_BUILD_FINAL
 ,
 m_debug(p_pos, 5.0f, tt::engine::renderer::ColorRGB(p_color.r, p_color.g, p_color.b))
@@ -79,6 +86,7 @@ void Polygon::calculateVertices()
 {
 	m_normals.resize(m_vertices.size());
 	m_verticesWorldSpace = m_vertices;
+	m_revision = ms_lastRevision.fetch_add(1) + 1;
 	
 	if (m_vertices.size() < 3)
 	{
@@ -127,6 +135,8 @@ void Polygon::calculateVertices()
 		// */
 	}
 	
+	m_min = min;
+	m_max = max;
 	m_boundingSphereMidPoint = (max + min) / 2.0f;
 	m_boundingSphereRadius   = 0.0f;
 	
@@ -1,5 +1,7 @@
 #include <set>
+#include <vector>
 
+#include <tt/code/AutoGrowBuffer.h>
 #include <tt/code/BufferReadContext.h>
 #include <tt/code/bufferutils.h>
 #include <tt/code/BufferWriteContext.h>
@@ -7,6 +9,7 @@
 #include <tt/platform/tt_error.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/system/Time.h>
+#include <tt/thread/JobSystem.h>
 
 #include <toki/game/pathfinding/PathMgr.h>
 #include <toki/game/pathfinding/TileCache.h>
@@ -28,6 +31,26 @@ namespace pathfinding {
 const ObstacleIndex g_invalidObstacleIndex = -1;
 
 
+//--------------------------------------------------------------------------------------------------
+// Helper functions
+
+typedef std::vector<TileCache*> TileCachePtrs;
+
+// Every TileCache has its own allocator, compressor and navmesh, so different agent radii can be
+// built at the same time. (The tiles within each cache are also preprocessed in parallel.)
+static void buildTileCachesParallel(const TileCachePtrs& p_tileCaches, const level::AttributeLayerPtr& p_layer)
+{
+	tt::thread::JobSystem::parallelFor(p_tileCaches.size(), 1,
+		[&](size_t p_begin, size_t p_end)
+		{
+			for (size_t i = p_begin; i < p_end; ++i)
+			{
+				p_tileCaches[i]->build(p_layer);
+			}
+		});
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // Public member functions
 
@@ -62,10 +85,13 @@ void PathMgr::buildTileCaches(const level::AttributeLayerPtr& p_layer)
 	const u64 startTime = tt::system::Time::getInstance()->getMilliSeconds();
 #endif
 	
+	TileCachePtrs tileCaches;
+	tileCaches.reserve(m_tileCaches.size());
 	for (TileCaches::iterator it = m_tileCaches.begin(); it != m_tileCaches.end(); ++it)
 	{
-		(*it).second->build(p_layer);
+		tileCaches.push_back((*it).second);
 	}
+	buildTileCachesParallel(tileCaches, p_layer);
 	
 #if defined(DEBUG_PATHMGR)
 	const u64 duration = tt::system::Time::getInstance()->getMilliSeconds() - startTime;
@@ -128,21 +154,22 @@ void PathMgr::addAndBuildMissingTileCaches(const level::LevelDataPtr& p_levelDat
 	// Add new caches based on leveldata
 	// Don't bother to remove the non-used anymore
 	const AgentRadii radii = getUniqueAgentRadiiForLevel(p_levelData);
+	TileCachePtrs newTileCaches;
 	for (AgentRadii::const_iterator it = radii.begin(); it != radii.end(); ++it)
 	{
 		if (m_tileCaches.find(*it) == m_tileCaches.end())
 		{
 			m_tileCaches[*it] = new TileCache(*it);
-			m_tileCaches[*it]->build(p_levelData->getAttributeLayer());
+			newTileCaches.push_back(m_tileCaches[*it]);
 		}
 	}
+	buildTileCachesParallel(newTileCaches, p_levelData->getAttributeLayer());
 }
 
 
 void PathMgr::loadTileCachesFromLevelData(const level::LevelDataPtr& p_levelData)
 {
-	tt::code::AutoGrowBufferPtr buffer = p_levelData->getPathfindingData();
-	tt::code::BufferReadContext context = buffer->getReadContext();
+	tt::code::BufferReadContext context = p_levelData->getPathfindingReadContext();
 	loadTileCaches(&context);
 }
 
@@ -310,13 +337,42 @@ void PathMgr::saveTileCaches(const level::AttributeLayerPtr& p_layer,
 	u32 numberOfCaches = static_cast<u32>(m_tileCaches.size());
 	bu::put(numberOfCaches, p_context);
 	
-	// Store tilecaches
+	// Preprocessing dominates saving, so every tilecache is saved to its own buffer in parallel.
+	// The buffers are appended in map order afterwards, which keeps the output deterministic.
+	TileCachePtrs tileCaches;
+	tileCaches.reserve(m_tileCaches.size());
 	for (TileCaches::const_iterator it = m_tileCaches.begin(); it != m_tileCaches.end(); ++it)
+	{
+		tileCaches.push_back((*it).second);
+	}
+	
+	std::vector<tt::code::AutoGrowBufferPtr> buffers(tileCaches.size());
+	tt::thread::JobSystem::parallelFor(tileCaches.size(), 1,
+		[&](size_t p_begin, size_t p_end)
+		{
+			for (size_t i = p_begin; i < p_end; ++i)
+			{
+				buffers[i] = tt::code::AutoGrowBuffer::create(4096, 4096);
+				tt::code::BufferWriteContext context = buffers[i]->getAppendContext();
+				tileCaches[i]->save(p_layer, &context);
+				context.flush();
+			}
+		});
+	
+	// Store tilecaches
+	size_t index = 0;
+	for (TileCaches::const_iterator it = m_tileCaches.begin(); it != m_tileCaches.end(); ++it, ++index)
 	{
 		// Store radius
 		bu::put((*it).first, p_context);
 		
-		(*it).second->save(p_layer, p_context);
+		const tt::code::AutoGrowBufferPtr& buffer(buffers[index]);
+		const s32 blockCount = buffer->getBlockCount();
+		for (s32 i = 0; i < blockCount; ++i)
+		{
+			bu::put(reinterpret_cast<const u8*>(buffer->getBlock(i)),
+			        static_cast<size_t>(buffer->getBlockSize(i)), p_context);
+		}
 	}
 }
 
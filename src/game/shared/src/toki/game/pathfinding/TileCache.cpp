@@ -1,5 +1,6 @@
 #include <cstring>
 #include <cfloat>
+#include <vector>
 
 #include <recastnavigation/Detour/DetourCommon.h>
 #include <recastnavigation/Detour/DetourNavMeshBuilder.h>
@@ -21,6 +22,7 @@
 #include <tt/platform/tt_error.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/system/Time.h>
+#include <tt/thread/JobSystem.h>
 
 #include <toki/game/pathfinding/fwd.h>
 #include <toki/game/pathfinding/TileCache.h>
@@ -1241,27 +1243,36 @@ s32 TileCache::preprocess(const level::AttributeLayerPtr& p_layer,
 	TT_ASSERT(p_tileCache_OUT == 0);
 	
 	// Make sure output buffer is large enough
-	TileCacheData* tileCache = new TileCacheData[p_tileWidth * p_tileHeight * MAX_LAYERS];
+	const s32 tileCount = p_tileWidth * p_tileHeight;
+	TileCacheData* tileCache = new TileCacheData[tileCount * MAX_LAYERS];
+	std::vector<s32> layerCounts(static_cast<std::vector<s32>::size_type>(tileCount), 0);
+	
+	// Preprocess tiles. Every tile only writes to its own MAX_LAYERS slots of the output buffer,
+	// so the tiles can be rasterized in parallel.
+	tt::thread::JobSystem::parallelFor(static_cast<size_t>(tileCount), 1,
+		[&](size_t p_begin, size_t p_end)
+		{
+			rcContext tmpContext(false);
+			for (size_t i = p_begin; i < p_end; ++i)
+			{
+				const s32 x = static_cast<s32>(i) % p_tileWidth;
+				const s32 y = static_cast<s32>(i) / p_tileWidth;
+				
+				TileCacheData* tiles = &tileCache[i * MAX_LAYERS];
+				memset(tiles, 0, sizeof(TileCacheData) * MAX_LAYERS);
+				TileRasterizationContext trcontext;
+				layerCounts[i] = trcontext.rasterizeTileLayers(&tmpContext, p_layer, x, y, p_cfg, tiles, MAX_LAYERS);
+			}
+		});
 	
+	// Compact the output buffer in tile order, so the result is identical to a serial build.
 	s32 totalTiles = 0;
-	
-	// Preprocess tiles.
-	rcContext tmpContext(false);
-	for (s32 y = 0; y < p_tileHeight; ++y)
+	for (s32 i = 0; i < tileCount; ++i)
 	{
-		for (s32 x = 0; x < p_tileWidth; ++x)
+		for (s32 layer = 0; layer < layerCounts[i]; ++layer, ++totalTiles)
 		{
-			TileCacheData tiles[MAX_LAYERS];
-			memset(tiles, 0, sizeof(tiles));
-			TileRasterizationContext trcontext;
-			const s32 ntiles = trcontext.rasterizeTileLayers(&tmpContext, p_layer, x, y, p_cfg, tiles, MAX_LAYERS);
-			
-			// Copy tiles to output buffer
-			for (s32 i = 0; i < ntiles; ++i, ++totalTiles)
-			{
-				TT_NULL_ASSERT(tiles[i].data);
-				tileCache[totalTiles] = tiles[i];
-			}
+			TT_NULL_ASSERT(tileCache[i * MAX_LAYERS + layer].data);
+			tileCache[totalTiles] = tileCache[i * MAX_LAYERS + layer];
 		}
 	}
 	
@@ -21,8 +21,24 @@ Callback::Callback(HSQUIRRELVM p_vm, const HSQOBJECT& p_state, const std::string
 :
 m_vm(p_vm),
 m_state(p_state),
-m_name(p_name)
+m_name(p_name),
+m_callback(EntityCallback_Invalid),
+m_closure()
 {
+	sq_resetobject(&m_closure);
+}
+
+
+Callback::Callback(HSQUIRRELVM p_vm, const HSQOBJECT& p_state, EntityCallback p_callback,
+                   const HSQOBJECT& p_closure)
+:
+m_vm(p_vm),
+m_state(p_state),
+m_name(),
+m_callback(p_callback),
+m_closure(p_closure)
+{
+	TT_ASSERT(isValidEntityCallback(m_callback));
 }
 
 
@@ -39,14 +55,25 @@ bool Callback::execute(const HSQOBJECT& p_instance) const
 {
 	tt::script::SqTopRestorerHelper helper(m_vm);
 	
-	sq_pushobject(m_vm, m_state); // Push state class here.
-	sq_pushstring(m_vm, m_name.c_str(), -1);
-	sq_get(m_vm, -2); //get the function from the class
-	
-	const SQObjectType type(sq_gettype(m_vm, sq_gettop(m_vm)));
-	if (type != OT_CLOSURE && type != OT_NATIVECLOSURE)
+	if (isValidEntityCallback(m_callback))
 	{
-		return false;
+		if (sq_isnull(m_closure))
+		{
+			return false;
+		}
+		sq_pushobject(m_vm, m_closure);
+	}
+	else
+	{
+		sq_pushobject(m_vm, m_state); // Push state class here.
+		sq_pushstring(m_vm, m_name.c_str(), -1);
+		sq_get(m_vm, -2); //get the function from the class
+		
+		const SQObjectType type(sq_gettype(m_vm, sq_gettop(m_vm)));
+		if (type != OT_CLOSURE && type != OT_NATIVECLOSURE)
+		{
+			return false;
+		}
 	}
 	
 	// Push the calling instance (first parameter)
@@ -60,7 +87,7 @@ bool Callback::execute(const HSQOBJECT& p_instance) const
 	
 	if (SQ_FAILED(sq_call(m_vm, static_cast<SQInteger>(m_parameters.size() + 1), SQFalse, TT_SCRIPT_RAISE_ERROR)))
 	{
-		TT_WARN("Calling squirrel function '%s' failed", m_name.c_str());
+		TT_WARN("Calling squirrel function '%s' failed", getFunctionName());
 		return false;
 	}
 	return true;
@@ -87,7 +114,7 @@ void Callback::serialize(const toki::script::serialization::SQSerializer& p_seri
 	namespace bu = tt::code::bufferutils;
 	
 	// Store function name
-	bu::put(m_name, p_context);
+	bu::put(std::string(getFunctionName()), p_context);
 	
 	// Store state
 	typedef toki::script::serialization::ProcessedObject ProcessedObject;
@@ -485,26 +485,21 @@ void EntityBase::deinit()
 
 bool EntityBase::onCreate(s32 p_id)
 {
-	// FIXME: Add support for calls that return a value in VirtualMachineMethods
-	HSQUIRRELVM v = ms_mgr->getVM()->getVM();
-	tt::script::SqTopRestorerHelper helper(v);
-	sq_pushobject(v, m_class->getBaseClass()); // Push class here.
-	sq_pushstring(v, "onCreate", -1);
-	
-	if (SQ_FAILED(sq_get(v, -2))) //get the function from the class
+	// onCreate is called right after creation, so the current state is still the base class.
+	TT_ASSERT(m_currentState.getName().empty());
+	const HSQOBJECT& closure(m_currentState.getCallback(EntityCallback_OnCreate));
+	if (sq_isnull(closure))
 	{
 		// If method doesn't exist in class, always return true
 		return true;
 	}
 	
-	const SQObjectType objType = sq_gettype(v, sq_gettop(v));
-	if (objType != OT_CLOSURE &&
-	    objType != OT_NATIVECLOSURE)
-	{
-		TT_PANIC("onCreate is not a (Native)Closure!");
-		return true;
-	}
+	ScopedCallbackTiming timing(*ms_mgr, EntityCallback_OnCreate);
 	
+	// FIXME: Add support for calls that return a value in VirtualMachineMethods
+	HSQUIRRELVM v = ms_mgr->getVM()->getVM();
+	tt::script::SqTopRestorerHelper helper(v);
+	sq_pushobject(v, closure);
 	sq_pushobject(v, m_instance); // Push this instance
 	sq_pushinteger(v, p_id);      // Push ID of this entity
 	if (SQ_FAILED(sq_call(v, 2, SQTrue, TT_SCRIPT_RAISE_ERROR)))
@@ -526,7 +521,7 @@ bool EntityBase::onCreate(s32 p_id)
 
 void EntityBase::onDie()
 {
-	queueSqFun("onDie");
+	queueSqFun(EntityCallback_OnDie);
 	
 	// Process all pending callbacks (max update depth is 3) before calling onDie in script
 	const s32 maxCallbackUpdates = 3;
@@ -536,20 +531,20 @@ void EntityBase::onDie()
 
 void EntityBase::onSound(const toki::game::event::Event& p_event) const
 {
-	queueSqFun("onSound", wrappers::EventWrapper(p_event));
+	queueSqFun(EntityCallback_OnSound, wrappers::EventWrapper(p_event));
 }
 
 
 void EntityBase::onVibration(const toki::game::event::Event& p_event) const
 {
-	queueSqFun("onVibration", wrappers::EventWrapper(p_event));
+	queueSqFun(EntityCallback_OnVibration, wrappers::EventWrapper(p_event));
 }
 
 
 void EntityBase::onEventSpawned(const toki::game::event::Event& p_event, const std::string& p_userParam,
                                 const EntityBaseCollection& p_entitiesFound)
 {
-	queueSqFun("onEventSpawned", wrappers::EventWrapper(p_event), p_userParam, p_entitiesFound);
+	queueSqFun(EntityCallback_OnEventSpawned, wrappers::EventWrapper(p_event), p_userParam, p_entitiesFound);
 }
 
 
@@ -558,14 +553,14 @@ void EntityBase::onCarryBegin(const entity::EntityHandle& p_carryingEntity)
 	const EntityBase* carryingEntity = getEntityBase(p_carryingEntity);
 	if (carryingEntity != 0)
 	{
-		queueSqFun("onCarryBegin", carryingEntity);
+		queueSqFun(EntityCallback_OnCarryBegin, carryingEntity);
 	}
 }
 
 
 void EntityBase::onCarryEnd()
 {
-	queueSqFun("onCarryEnd");
+	queueSqFun(EntityCallback_OnCarryEnd);
 }
 
 
@@ -886,7 +881,17 @@ void EntityBase::updateCallbacks(s32 p_maxUpdates)
 				if(entityPreExecute != 0 &&
 				   entityPreExecute->isInitialized())
 				{
-					(*it)->execute(m_instance);
+					const Callback& callback(*(*it));
+					if (isValidEntityCallback(callback.getCallback()))
+					{
+						ScopedCallbackTiming timing(*ms_mgr, callback.getCallback());
+						callback.execute(m_instance);
+					}
+					else
+					{
+						ScopedCallbackTiming timing(*ms_mgr, callback.getName());
+						callback.execute(m_instance);
+					}
 				}
 			}
 			
@@ -251,7 +251,9 @@ EntityScriptClassPtr EntityScriptClass::create(const std::string& p_path, const
 		sq_resetobject(&newSqState);
 		sq_getstackobj(v, -1, &newSqState);
 		
-		states[stateName] = EntityState(stateName, newSqState);
+		EntityState& state = states[stateName];
+		state = EntityState(stateName, newSqState);
+		state.resolveCallbacks(v);
 		
 		/*
 		TT_Printf("EntityScriptClass::create - Adding state '%s'::'%s' %p\n", 
@@ -265,6 +267,7 @@ EntityScriptClassPtr EntityScriptClass::create(const std::string& p_path, const
 	
 	// insert baseclass 'state'
 	states[""] = EntityState("", baseClass); // FIXME: Store in explicitly named m_baseState varible instead of hiding it in the data with some magic string.
+	states[""].resolveCallbacks(v);
 	
 	return EntityScriptClassPtr(new EntityScriptClass(p_name, baseClass, rawStates, states));
 }
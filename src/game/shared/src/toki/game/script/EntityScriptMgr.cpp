@@ -47,6 +47,12 @@ EntityScriptMgr::EntityScriptMgr()
 :
 m_collectGarbage(false)
 {
+#if !defined(TT_BUILD_FINAL)
+	for (s32 i = 0; i < EntityCallback_Count; ++i)
+	{
+		resetCallbackTiming(m_callbackTimings[i]);
+	}
+#endif
 }
 
 
@@ -169,6 +175,24 @@ void EntityScriptMgr::deinit()
 
 void EntityScriptMgr::update(real p_elapsedTime)
 {
+#if !defined(TT_BUILD_FINAL)
+	++m_currentTimingFrame;
+	if (m_currentTimingFrame >= maxTimingFrames)
+	{
+		m_currentTimingFrame = 0;
+	}
+	for (s32 i = 0; i < EntityCallback_Count; ++i)
+	{
+		m_callbackTimings[i].calls[m_currentTimingFrame] = 0;
+		m_callbackTimings[i].time [m_currentTimingFrame] = 0;
+	}
+	for (auto& it : m_namedCallbackTimings)
+	{
+		it.second.calls[m_currentTimingFrame] = 0;
+		it.second.time [m_currentTimingFrame] = 0;
+	}
+#endif
+
 	updateEntityCallbacks();
 	TimerMgr::update(p_elapsedTime);
 	if (m_collectGarbage)
@@ -397,6 +421,55 @@ void EntityScriptMgr::unserialize(tt::code::BufferReadContext*  p_context)
 }
 
 
+#if !defined(TT_BUILD_FINAL)
+void EntityScriptMgr::addCallbackTiming(EntityCallback p_callback, u64 p_duration)
+{
+	TT_ASSERT(isValidEntityCallback(p_callback));
+	addCallbackTiming(m_callbackTimings[p_callback], m_currentTimingFrame, p_duration);
+}
+
+
+void EntityScriptMgr::addCallbackTiming(const std::string& p_name, u64 p_duration)
+{
+	CallbackTimings::iterator it = m_namedCallbackTimings.find(p_name);
+	if (it == m_namedCallbackTimings.end())
+	{
+		it = m_namedCallbackTimings.insert(std::make_pair(p_name, CallbackTiming())).first;
+		resetCallbackTiming(it->second);
+	}
+	addCallbackTiming(it->second, m_currentTimingFrame, p_duration);
+}
+
+
+std::string EntityScriptMgr::getDebugCallbackTimings() const
+{
+	ReverseTimings reverseTimings;
+	u64 totalTime  = 0;
+	u64 totalCalls = 0;
+	
+	for (s32 i = 0; i < EntityCallback_Count; ++i)
+	{
+		addDebugCallbackTiming(m_callbackTimings[i], getEntityCallbackName(static_cast<EntityCallback>(i)),
+		                       reverseTimings, totalTime, totalCalls);
+	}
+	for (auto& it : m_namedCallbackTimings)
+	{
+		addDebugCallbackTiming(it.second, it.first + " (by name)", reverseTimings, totalTime, totalCalls);
+	}
+	
+	char buf[256];
+	sprintf(buf, "Callback Timings (%5lld us, %5lld calls):\n", totalTime, totalCalls);
+	std::string result(buf);
+	for (auto it(reverseTimings.rbegin()); it != reverseTimings.rend(); ++it)
+	{
+		sprintf(buf, "%5lld %s\n", it->first, it->second.c_str());
+		result += std::string(buf);
+	}
+	return result;
+}
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 // Private member functions
 
@@ -512,6 +585,50 @@ void EntityScriptMgr::processNutFilesInDirectory(const std::string& p_path)
 	}
 }
 
+
+#if !defined(TT_BUILD_FINAL)
+void EntityScriptMgr::addCallbackTiming(CallbackTiming& p_timing, s32 p_frame, u64 p_duration)
+{
+	++p_timing.calls[p_frame];
+	p_timing.time[p_frame] += p_duration;
+}
+
+
+void EntityScriptMgr::addDebugCallbackTiming(const CallbackTiming& p_timing, const std::string& p_name,
+                                             ReverseTimings& p_timings_OUT, u64& p_totalTime_OUT,
+                                             u64& p_totalCalls_OUT)
+{
+	u64 time  = 0;
+	u64 calls = 0;
+	for (s32 i = 0; i < maxTimingFrames; ++i)
+	{
+		time  += p_timing.time[i];
+		calls += p_timing.calls[i];
+	}
+	if (calls == 0)
+	{
+		return;
+	}
+	
+	// Per update
+	const u64 avgTime  = time  / maxTimingFrames;
+	const u64 avgCalls = (calls + maxTimingFrames - 1) / maxTimingFrames;
+	
+	char buf[256];
+	sprintf(buf, "%5lld %s", avgCalls, p_name.c_str());
+	p_timings_OUT.insert(std::make_pair(avgTime, std::string(buf)));
+	p_totalTime_OUT  += avgTime;
+	p_totalCalls_OUT += avgCalls;
+}
+
+
+void EntityScriptMgr::resetCallbackTiming(CallbackTiming& p_timing)
+{
+	memset(p_timing.calls, 0, sizeof(p_timing.calls));
+	memset(p_timing.time,  0, sizeof(p_timing.time));
+}
+#endif
+
 // Namespace end
 }
 }
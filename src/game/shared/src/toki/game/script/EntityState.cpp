@@ -1,4 +1,5 @@
 #include <tt/str/str.h>
+#include <tt/script/SqTopRestorerHelper.h>
 
 #include <toki/game/script/EntityState.h>
 
@@ -20,13 +21,64 @@ EntityState::EntityState()
 EntityState::EntityState(const std::string& p_name, const HSQOBJECT& p_sqState)
 :
 m_name(p_name),
-m_sqState(p_sqState)
+m_sqState(p_sqState),
+m_callbacks(getEmptyCallbacks())
 {
 }
 
+
+void EntityState::reset()
+{
+	m_name.clear();
+	sq_resetobject(&m_sqState);
+	m_callbacks = getEmptyCallbacks();
+}
+
+
+void EntityState::resolveCallbacks(HSQUIRRELVM p_vm)
+{
+	TT_ASSERT(isValid());
+	
+	tt::script::SqTopRestorerHelper helper(p_vm, true);
+	
+	tt_ptr<Closures>::shared callbacks(new Closures(*getEmptyCallbacks()));
+	
+	sq_pushobject(p_vm, m_sqState);
+	for (s32 i = 0; i < EntityCallback_Count; ++i)
+	{
+		sq_pushstring(p_vm, getEntityCallbackName(static_cast<EntityCallback>(i)), -1);
+		if (SQ_FAILED(sq_get(p_vm, -2)))
+		{
+			continue; // This state doesn't have this callback.
+		}
+		
+		const SQObjectType type = sq_gettype(p_vm, -1);
+		if (type == OT_CLOSURE || type == OT_NATIVECLOSURE)
+		{
+			sq_getstackobj(p_vm, -1, &(*callbacks)[i]);
+		}
+		sq_poptop(p_vm);
+	}
+	
+	m_callbacks = callbacks;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 // Private member functions
 
+const EntityState::ClosuresPtr& EntityState::getEmptyCallbacks()
+{
+	static ClosuresPtr emptyCallbacks;
+	if (emptyCallbacks == 0)
+	{
+		HSQOBJECT nullObject;
+		sq_resetobject(&nullObject);
+		emptyCallbacks.reset(new Closures(EntityCallback_Count, nullObject));
+	}
+	return emptyCallbacks;
+}
+
 
 // Namespace end
 }
@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 #include <tt/code/bufferutils.h>
 #include <tt/code/helpers.h>
+#include <tt/math/math.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/platform/tt_error.h>
 
@@ -17,8 +22,18 @@ namespace toki {
 namespace game {
 namespace script {
 
-bool             TimerMgr::ms_initialized = false;
-TimerMgr::Timers TimerMgr::ms_timers;
+bool                    TimerMgr::ms_initialized = false;
+TimerMgr::TimerNodes    TimerMgr::ms_nodes;
+s32                     TimerMgr::ms_freeNodes = -1;
+u32                     TimerMgr::ms_nextID = 0;
+TimerMgr::EntityTimers  TimerMgr::ms_entityTimers;
+s32                     TimerMgr::ms_activeTimers = -1;
+s32                     TimerMgr::ms_wheel[TimerMgr::WheelSlotCount]; // Emptied by reset()
+u32                     TimerMgr::ms_currentTick = 0;
+u32                     TimerMgr::ms_historyStartTick = 0;
+TimerMgr::ElapsedTimes  TimerMgr::ms_elapsedHistory;
+real                    TimerMgr::ms_maxElapsedTime = 0.0f;
+TimerMgr::ExpiredTimers TimerMgr::ms_expiredTimers;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -32,121 +47,61 @@ bool TimerMgr::isInitialized()
 
 void TimerMgr::startTimer(const std::string& p_name, real p_timeout, const entity::EntityHandle& p_target)
 {
-	TT_ASSERT(ms_initialized);
-	
-	{
-		const TimerPtr& timer = getTimer(p_name, p_target);
-		if (timer != 0)
-		{
-			// timer already exist, overwrite with new timeout
-			timer->setTimeout(p_timeout);
-			return;
-		}
-	}
-	
-#if ENABLE_RECORDER_LOGGING
-	std::ostream& log = AppGlobal::getInputRecorder()->log();
-	log << "Started timer '" << p_name << "' (" << p_timeout << ") - " << p_target.getValue() << std::endl;
-	log.flush();
-#endif
-	
-	TimerPtr timer = TimerPtr(new Timer(p_name, p_timeout, p_target));
-	
-	if (tt::math::realLessEqual(p_timeout, 0.0f))
-	{
-		// Instantly fire
-		timer->doCallback();
-		return;
-	}
-	
-	ms_timers[p_target].insert(std::make_pair(TimerHash(p_name), timer));
+	startTimer(p_name, p_timeout, p_target, false);
 }
 
 
 void TimerMgr::startCallbackTimer(const std::string& p_callback, real p_timeout,
                                   const entity::EntityHandle& p_target)
 {
-	TT_ASSERT(ms_initialized);
-	
-	{
-		const TimerPtr& timer = getTimer(p_callback, p_target);
-		if (timer != 0)
-		{
-			// timer already exist, overwrite with new timeout
-			timer->setTimeout(p_timeout);
-			return;
-		}
-	}
-	
-#if ENABLE_RECORDER_LOGGING
-	std::ostream& log = AppGlobal::getInputRecorder()->log();
-	log << "Started callback timer '" << p_callback << "' (" << p_timeout << ") - " << p_target.getValue() << std::endl;
-	log.flush();
-#endif
-	
-	TimerPtr timer = TimerPtr(new Timer(p_callback, p_timeout, p_target));
-	timer->setIsSeparateCallback(true);
-	
-	if (tt::math::realLessEqual(p_timeout, 0.0f))
-	{
-		// Instantly fire
-		timer->doCallback();
-		return;
-	}
-	
-	ms_timers[p_target].insert(std::make_pair(TimerHash(p_callback), timer));
+	startTimer(p_callback, p_timeout, p_target, true);
 }
 
 
 void TimerMgr::stopTimer(const std::string& p_name, const entity::EntityHandle& p_target)
 {
-	Timers::iterator it = ms_timers.find(p_target);
-	if (it != ms_timers.end())
+	const s32 index = findTimer(TimerHash(p_name), p_target);
+	if (index >= 0)
 	{
-		EntityTimers& entityTimers = (*it).second;
-		EntityTimers::iterator timersIt = entityTimers.find(TimerHash(p_name));
-		if (timersIt != entityTimers.end())
-		{
-			entityTimers.erase(timersIt);
-		}
-		
-		if (entityTimers.empty())
-		{
-			ms_timers.erase(it);
-		}
+		destroyTimer(index);
 	}
 }
 
 
 void TimerMgr::stopAllTimers(const entity::EntityHandle& p_target)
 {
-	Timers::iterator it = ms_timers.find(p_target);
-	if (it != ms_timers.end())
+	EntityTimers::iterator it = ms_entityTimers.find(p_target.getValue());
+	while (it != ms_entityTimers.end())
 	{
-		ms_timers.erase(it);
+		// Destroying the last timer of the entity erases it from ms_entityTimers.
+		destroyTimer((*it).second);
+		it = ms_entityTimers.find(p_target.getValue());
 	}
 }
 
 
 void TimerMgr::suspendTimer(const std::string& p_name, const entity::EntityHandle& p_target)
 {
-	const TimerPtr& timer = getTimer(p_name, p_target);
-	if (timer != 0)
+	const s32 index = findTimer(TimerHash(p_name), p_target);
+	if (index >= 0)
 	{
-		timer->setSuspended(true);
+		syncTimer(index);
+		ms_nodes[index].timer.setSuspended(true);
+		scheduleTimer(index);
 	}
 }
 
 
 void TimerMgr::suspendAllTimers(const entity::EntityHandle& p_target)
 {
-	Timers::iterator it = ms_timers.find(p_target);
-	if (it != ms_timers.end())
+	EntityTimers::iterator it = ms_entityTimers.find(p_target.getValue());
+	if (it != ms_entityTimers.end())
 	{
-		for (EntityTimers::iterator timerIt = (*it).second.begin();
-			timerIt != (*it).second.end(); ++timerIt)
+		for (s32 index = (*it).second; index >= 0; index = ms_nodes[index].entityNext)
 		{
-			(*timerIt).second->setSuspended(true);
+			syncTimer(index);
+			ms_nodes[index].timer.setSuspended(true);
+			scheduleTimer(index);
 		}
 	}
 }
@@ -154,43 +109,41 @@ void TimerMgr::suspendAllTimers(const entity::EntityHandle& p_target)
 
 void TimerMgr::resumeTimer(const std::string& p_name, const entity::EntityHandle& p_target)
 {
-	const TimerPtr& timer = getTimer(p_name, p_target);
-	if (timer != 0)
+	const s32 index = findTimer(TimerHash(p_name), p_target);
+	if (index >= 0)
 	{
-		timer->setSuspended(false);
+		syncTimer(index);
+		ms_nodes[index].timer.setSuspended(false);
+		scheduleTimer(index);
 	}
 }
 
 
 void TimerMgr::resumeAllTimers(const entity::EntityHandle& p_target)
 {
-	Timers::iterator it = ms_timers.find(p_target);
-	if (it != ms_timers.end())
+	EntityTimers::iterator it = ms_entityTimers.find(p_target.getValue());
+	if (it != ms_entityTimers.end())
 	{
-		for (EntityTimers::iterator timerIt = (*it).second.begin();
-			timerIt != (*it).second.end(); ++timerIt)
+		for (s32 index = (*it).second; index >= 0; index = ms_nodes[index].entityNext)
 		{
-			(*timerIt).second->setSuspended(false);
+			syncTimer(index);
+			ms_nodes[index].timer.setSuspended(false);
+			scheduleTimer(index);
 		}
 	}
 }
 
 
-const TimerPtr& TimerMgr::getTimer(const std::string& p_name, const entity::EntityHandle& p_target)
+const Timer* TimerMgr::getTimer(const std::string& p_name, const entity::EntityHandle& p_target)
 {
-	Timers::iterator it = ms_timers.find(p_target);
-	if (it != ms_timers.end())
+	const s32 index = findTimer(TimerHash(p_name), p_target);
+	if (index < 0)
 	{
-		EntityTimers& entityTimers = (*it).second;
-		EntityTimers::iterator timersIt = entityTimers.find(TimerHash(p_name));
-		if (timersIt != entityTimers.end())
-		{
-			return (*timersIt).second;
-		}
+		return 0;
 	}
 	
-	static TimerPtr empty;
-	return empty;
+	syncTimer(index);
+	return &ms_nodes[index].timer;
 }
 
 
@@ -207,27 +160,25 @@ void TimerMgr::serialize(toki::serialization::SerializationMgr& p_serializationM
 	
 	namespace bu = tt::code::bufferutils;
 	
-	u32 timerCount = 0;
-	for (Timers::iterator it = ms_timers.begin(); it != ms_timers.end(); ++it)
-	{
-		timerCount += static_cast<u32>((*it).second.size());
-	}
+	syncAllTimers();
+	
+	// Same order as before the timers were pooled: sorted on target, then on hash.
+	TimerIndices indices;
+	getSortedTimers(indices);
+	
+	const u32 timerCount = static_cast<u32>(indices.size());
 	//TT_Printf("TimerMgr::serialize: Serializing %u timers.\n", timerCount);
 	bu::put(timerCount, &context);
 	
-	for (Timers::iterator entityIt = ms_timers.begin(); entityIt != ms_timers.end(); ++entityIt)
+	for (TimerIndices::const_iterator it = indices.begin(); it != indices.end(); ++it)
 	{
-		const EntityTimers& timers = (*entityIt).second;
-		for (EntityTimers::const_iterator timerIt = timers.begin(); timerIt != timers.end(); ++timerIt)
-		{
-			const TimerPtr& timer((*timerIt).second);
-			
-			bu::put(timer->getTimeout(),         &context);
-			bu::put(timer->isSuspended(),        &context);
-			bu::put(timer->getName(),            &context);
-			bu::put(timer->isSeparateCallback(), &context);
-			bu::putHandle(timer->getTarget(),    &context);
-		}
+		const Timer& timer(ms_nodes[*it].timer);
+		
+		bu::put(timer.getTimeout(),         &context);
+		bu::put(timer.isSuspended(),        &context);
+		bu::put(timer.getName(),            &context);
+		bu::put(timer.isSeparateCallback(), &context);
+		bu::putHandle(timer.getTarget(),    &context);
 	}
 	
 	context.flush();
@@ -250,7 +201,7 @@ void TimerMgr::unserialize(const toki::serialization::SerializationMgr& p_serial
 	const u32 timerCount = bu::get<u32>(&context);
 	//TT_Printf("TimerMgr::unserialize: Loading %u timers.\n", timerCount);
 	
-	ms_timers.clear();
+	reset();
 	
 	for (u32 i = 0; i < timerCount; ++i)
 	{
@@ -263,10 +214,20 @@ void TimerMgr::unserialize(const toki::serialization::SerializationMgr& p_serial
 		//TT_Printf("TimerMgr::unserialize: Timer %u: timeout %f | suspended: %s | name '%s' | target handle 0x%08X\n",
 		//          i, timeout, suspended ? "true " : "false", name.c_str(), targetHandleValue);
 		
-		TimerPtr timer(new Timer(name, timeout, targetHandle));
-		timer->setSuspended(suspended);
-		timer->setIsSeparateCallback(isSeparateCallback);
-		ms_timers[targetHandle][timer->getHash()] = timer;
+		Timer timer(name, timeout, targetHandle);
+		timer.setSuspended(suspended);
+		timer.setIsSeparateCallback(isSeparateCallback);
+		
+		const s32 existing = findTimer(timer.getHash(), targetHandle);
+		if (existing >= 0)
+		{
+			destroyTimer(existing);
+		}
+		
+		// The targets might not be unserialized yet, so leave the scheduling to the next update.
+		const s32 index = createTimer(timer);
+		ms_nodes[index].state = NodeState_Active;
+		linkTimer(ms_activeTimers, index);
 	}
 }
 
@@ -278,19 +239,23 @@ void TimerMgr::logTimers()
 	using namespace game::entity;
 	EntityMgr& entityMgr = AppGlobal::getGame()->getEntityMgr();
 	
-	for (Timers::iterator it = ms_timers.begin(); it != ms_timers.end(); ++it)
+	syncAllTimers();
+	
+	TimerIndices indices;
+	getSortedTimers(indices);
+	
+	for (TimerIndices::const_iterator it = indices.begin(); it != indices.end();)
 	{
-		log << "Entity = " << it->first.getValue();
-		Entity* target = entityMgr.getEntity((*it).first);
-		if (target != 0)
+		const EntityHandle handle(ms_nodes[*it].timer.getTarget());
+		log << "Entity = " << handle.getValue();
+		Entity* target = entityMgr.getEntity(handle);
+		for (; it != indices.end() && ms_nodes[*it].timer.getTarget() == handle; ++it)
 		{
-			EntityTimers& entityTimers = (*it).second;
-			for (EntityTimers::iterator timersIt = entityTimers.begin();
-			     timersIt != entityTimers.end(); ++timersIt)
+			if (target != 0)
 			{
-				const TimerPtr& timer = (*timersIt).second;
-
-				log << " [" << timer->getName() << " - " << timer->getTimeout() << "]";
+				const Timer& timer(ms_nodes[*it].timer);
+				
+				log << " [" << timer.getName() << " - " << timer.getTimeout() << "]";
 			}
 		}
 		log << std::endl;
@@ -302,10 +267,43 @@ void TimerMgr::logTimers()
 //--------------------------------------------------------------------------------------------------
 // Private member functions
 
+TimerMgr::TimerNode::TimerNode(const Timer& p_timer)
+:
+timer(p_timer),
+id(0),
+state(NodeState_Free),
+syncTick(0),
+wakeTick(0),
+slot(-1),
+prev(-1),
+next(-1),
+entityPrev(-1),
+entityNext(-1)
+{
+}
+
+
 void TimerMgr::init()
 {
 	TT_ASSERT(ms_initialized == false);
 	ms_initialized = true;
+	
+	reset();
+}
+
+
+void TimerMgr::reset()
+{
+	ms_nodes.clear();
+	ms_freeNodes = -1;
+	ms_entityTimers.clear();
+	
+	ms_activeTimers = -1;
+	std::fill(ms_wheel, ms_wheel + WheelSlotCount, -1);
+	ms_currentTick      = 0;
+	ms_historyStartTick = 0;
+	ms_elapsedHistory.clear();
+	ms_maxElapsedTime   = 0.0f;
 }
 
 
@@ -314,7 +312,11 @@ void TimerMgr::deinit()
 	TT_ASSERT(ms_initialized);
 	
 	// Do deinit stuff here.
-	tt::code::helpers::freeContainer(ms_timers);
+	reset();
+	tt::code::helpers::freeContainer(ms_nodes);
+	tt::code::helpers::freeContainer(ms_entityTimers);
+	tt::code::helpers::freeContainer(ms_elapsedHistory);
+	tt::code::helpers::freeContainer(ms_expiredTimers);
 	
 	ms_initialized = false;
 }
@@ -326,86 +328,431 @@ void TimerMgr::update(real p_elapsedTime)
 	using namespace game::entity;
 	EntityMgr& entityMgr = AppGlobal::getGame()->getEntityMgr();
 	
-	typedef std::vector<TimerPtr> TimerList;
-	TimerList needsCallback;
-	needsCallback.reserve(30);
+	if (ms_elapsedHistory.size() >= MaxHistorySize)
+	{
+		syncAllTimers();
+		ms_elapsedHistory.clear();
+		ms_historyStartTick = ms_currentTick;
+	}
 	
-	// First make a copy to make sure we don't get any updates of erased timers
-	for (Timers::iterator it = ms_timers.begin(); it != ms_timers.end(); ++it)
+	const u32 tick = ms_currentTick;
+	ms_elapsedHistory.push_back(p_elapsedTime);
+	
+	if (p_elapsedTime > ms_maxElapsedTime)
+	{
+		// The scheduled timers assumed shorter updates, so check all of them in this update.
+		ms_maxElapsedTime = p_elapsedTime;
+		for (s32 slot = 0; slot < WheelSlotCount; ++slot)
+		{
+			while (ms_wheel[slot] >= 0)
+			{
+				const s32 index = ms_wheel[slot];
+				unlinkTimer(index);
+				ms_nodes[index].state = NodeState_Active;
+				linkTimer(ms_activeTimers, index);
+			}
+		}
+	}
+	else
 	{
-		Entity* target = entityMgr.getEntity((*it).first);
-		if (target != 0)
+		const s32 rootSlot = static_cast<s32>(tick & (WheelRootSize - 1));
+		if (rootSlot == 0)
 		{
-			EntityTimers& entityTimers = (*it).second;
-			for (EntityTimers::iterator timersIt = entityTimers.begin();
-			     timersIt != entityTimers.end(); ++timersIt)
+			// The root wheel went round; move the timers of the next slot of each level a level down.
+			for (s32 level = 0; level < WheelLevelCount; ++level)
 			{
-				const TimerPtr& timer = (*timersIt).second;
-				if (timer->isAlive())
+				const s32 index = static_cast<s32>((tick >> (WheelRootBits + level * WheelLevelBits)) &
+				                                   (WheelLevelSize - 1));
+				cascadeWheel(WheelRootSize + level * WheelLevelSize + index);
+				if (index != 0)
 				{
-					if (timer->updateTime(p_elapsedTime))
-					{
-						needsCallback.push_back(timer);
-					}
+					break;
 				}
 			}
 		}
+		
+		while (ms_wheel[rootSlot] >= 0)
+		{
+			const s32 index = ms_wheel[rootSlot];
+			unlinkTimer(index);
+			ms_nodes[index].state = NodeState_Active;
+			linkTimer(ms_activeTimers, index);
+		}
 	}
+	ms_currentTick = tick + 1;
 	
-	// Do the actual update
-	for (TimerList::const_iterator it = needsCallback.begin(); it != needsCallback.end(); ++it)
+	// First collect the expired timers to make sure we don't get any updates of erased timers
+	ms_expiredTimers.clear();
+	for (s32 index = ms_activeTimers; index >= 0; index = ms_nodes[index].next)
 	{
-		const TimerPtr& ptr = (*it);
+		TimerNode& node(ms_nodes[index]);
 		
-		// Check to make sure the timer ptr still exists.
-		Timers::iterator findIt = ms_timers.find(ptr->getTarget());
-		if (findIt != ms_timers.end())
+		// The updates the timer spent in the wheel; it was counting down then as well.
+		for (u32 t = node.syncTick; t != tick; ++t)
 		{
-			EntityTimers& entityTimers = (*findIt).second;
-			EntityTimers::iterator timersIt = entityTimers.find(ptr->getHash());
-			if (timersIt != entityTimers.end() &&
-			    (*timersIt).second == ptr)
-			{
-				// Found
-				// Erease before doing the callback.
-				entityTimers.erase(timersIt);
-				ptr->doCallback();
-			}
+			node.timer.subtractTime(ms_elapsedHistory[t - ms_historyStartTick]);
+		}
+		node.syncTick = ms_currentTick;
+		
+		if (entityMgr.getEntity(node.timer.getTarget()) != 0 &&
+		    node.timer.isAlive()                           &&
+		    node.timer.updateTime(p_elapsedTime))
+		{
+			const ExpiredTimer expired = { index, node.id };
+			ms_expiredTimers.push_back(expired);
 		}
 	}
 	
-	// Now clean up the timers
-	for (Timers::iterator it = ms_timers.begin(); it != ms_timers.end();)
+	// Same callback order as before the timers were pooled: sorted on target, then on hash.
+	std::sort(ms_expiredTimers.begin(), ms_expiredTimers.end(), isExpiredTimerLess);
+	
+	// Do the actual callbacks
+	for (ExpiredTimers::const_iterator it = ms_expiredTimers.begin(); it != ms_expiredTimers.end(); ++it)
 	{
-		Entity* target = entityMgr.getEntity((*it).first);
-		if (target != 0)
+		// Check to make sure the timer wasn't stopped or restarted by an earlier callback.
+		const TimerNode& node(ms_nodes[(*it).index]);
+		if (node.state != NodeState_Free && node.id == (*it).id)
 		{
-			EntityTimers& entityTimers = (*it).second;
-			for (EntityTimers::iterator timersIt = entityTimers.begin(); timersIt != entityTimers.end();)
-			{
-				if ((*timersIt).second->isAlive())
-				{
-					++timersIt;
-				}
-				else
-				{
-					timersIt = entityTimers.erase(timersIt);
-				}
-			}
-			if (entityTimers.empty())
-			{
-				it = ms_timers.erase(it);
-			}
-			else
+			// Erase before doing the callback. (Callbacks can start timers, which might grow the pool.)
+			Timer timer(node.timer);
+			destroyTimer((*it).index);
+			timer.doCallback();
+		}
+	}
+	
+	// Now clean up the timers and schedule the ones that keep running
+	for (s32 index = ms_activeTimers; index >= 0;)
+	{
+		const s32 next = ms_nodes[index].next;
+		const Timer& timer(ms_nodes[index].timer);
+		if (entityMgr.getEntity(timer.getTarget()) == 0 || timer.isAlive() == false)
+		{
+			destroyTimer(index);
+		}
+		else
+		{
+			scheduleTimer(index);
+		}
+		index = next;
+	}
+}
+
+
+void TimerMgr::startTimer(const std::string& p_name, real p_timeout, const entity::EntityHandle& p_target,
+                          bool p_isSeparateCallback)
+{
+	TT_ASSERT(ms_initialized);
+	
+	{
+		const s32 index = findTimer(TimerHash(p_name), p_target);
+		if (index >= 0)
+		{
+			// timer already exist, overwrite with new timeout
+			ms_nodes[index].timer.setTimeout(p_timeout);
+			ms_nodes[index].syncTick = ms_currentTick;
+			scheduleTimer(index);
+			return;
+		}
+	}
+
+#if ENABLE_RECORDER_LOGGING
+	std::ostream& log = AppGlobal::getInputRecorder()->log();
+	log << (p_isSeparateCallback ? "Started callback timer '" : "Started timer '")
+	    << p_name << "' (" << p_timeout << ") - " << p_target.getValue() << std::endl;
+	log.flush();
+#endif
+
+	Timer timer(p_name, p_timeout, p_target);
+	timer.setIsSeparateCallback(p_isSeparateCallback);
+	
+	if (tt::math::realLessEqual(p_timeout, 0.0f))
+	{
+		// Instantly fire
+		timer.doCallback();
+		return;
+	}
+	
+	scheduleTimer(createTimer(timer));
+}
+
+
+s32 TimerMgr::findTimer(const TimerHash& p_hash, const entity::EntityHandle& p_target)
+{
+	EntityTimers::const_iterator it = ms_entityTimers.find(p_target.getValue());
+	if (it != ms_entityTimers.end())
+	{
+		for (s32 index = (*it).second; index >= 0; index = ms_nodes[index].entityNext)
+		{
+			if (ms_nodes[index].timer.getHash() == p_hash)
 			{
-				++it;
+				return index;
 			}
 		}
+	}
+	return -1;
+}
+
+
+s32 TimerMgr::createTimer(const Timer& p_timer)
+{
+	s32 index = ms_freeNodes;
+	if (index >= 0)
+	{
+		ms_freeNodes     = ms_nodes[index].next;
+		ms_nodes[index]  = TimerNode(p_timer);
+	}
+	else
+	{
+		index = static_cast<s32>(ms_nodes.size());
+		ms_nodes.push_back(TimerNode(p_timer));
+	}
+	
+	TimerNode& node(ms_nodes[index]);
+	node.id       = ms_nextID++;
+	node.state    = NodeState_Idle;
+	node.syncTick = ms_currentTick;
+	
+	s32& first = (*ms_entityTimers.insert(std::make_pair(p_timer.getTarget().getValue(), -1)).first).second;
+	node.entityNext = first;
+	if (first >= 0)
+	{
+		ms_nodes[first].entityPrev = index;
+	}
+	first = index;
+	
+	return index;
+}
+
+
+void TimerMgr::destroyTimer(s32 p_index)
+{
+	unlinkTimer(p_index);
+	
+	TimerNode& node(ms_nodes[p_index]);
+	TT_ASSERT(node.state == NodeState_Idle);
+	
+	if (node.entityPrev >= 0)
+	{
+		ms_nodes[node.entityPrev].entityNext = node.entityNext;
+	}
+	else
+	{
+		EntityTimers::iterator it = ms_entityTimers.find(node.timer.getTarget().getValue());
+		TT_ASSERT(it != ms_entityTimers.end() && (*it).second == p_index);
+		if (node.entityNext >= 0)
+		{
+			(*it).second = node.entityNext;
+		}
 		else
 		{
-			it = ms_timers.erase(it);
+			ms_entityTimers.erase(it);
+		}
+	}
+	if (node.entityNext >= 0)
+	{
+		ms_nodes[node.entityNext].entityPrev = node.entityPrev;
+	}
+	
+	node.state      = NodeState_Free;
+	node.entityPrev = -1;
+	node.entityNext = -1;
+	node.next       = ms_freeNodes;
+	ms_freeNodes    = p_index;
+}
+
+
+void TimerMgr::linkTimer(s32& p_head, s32 p_index)
+{
+	TimerNode& node(ms_nodes[p_index]);
+	node.prev = -1;
+	node.next = p_head;
+	if (p_head >= 0)
+	{
+		ms_nodes[p_head].prev = p_index;
+	}
+	p_head = p_index;
+}
+
+
+void TimerMgr::unlinkTimer(s32 p_index)
+{
+	TimerNode& node(ms_nodes[p_index]);
+	if (node.state != NodeState_Active && node.state != NodeState_Scheduled)
+	{
+		return;
+	}
+	
+	s32& head = (node.state == NodeState_Active) ? ms_activeTimers : ms_wheel[node.slot];
+	if (node.prev >= 0)
+	{
+		ms_nodes[node.prev].next = node.next;
+	}
+	else
+	{
+		head = node.next;
+	}
+	if (node.next >= 0)
+	{
+		ms_nodes[node.next].prev = node.prev;
+	}
+	
+	node.prev  = -1;
+	node.next  = -1;
+	node.slot  = -1;
+	node.state = NodeState_Idle;
+}
+
+
+void TimerMgr::insertIntoWheel(s32 p_index)
+{
+	TimerNode& node(ms_nodes[p_index]);
+	
+	static const u32 horizon = 1u << (WheelRootBits + WheelLevelCount * WheelLevelBits);
+	u32 delta = node.wakeTick - ms_currentTick;
+	if (delta >= horizon)
+	{
+		// Checked (and scheduled again) earlier than needed.
+		delta         = horizon - 1;
+		node.wakeTick = ms_currentTick + delta;
+	}
+	
+	if (delta < WheelRootSize)
+	{
+		node.slot = static_cast<s32>(node.wakeTick & (WheelRootSize - 1));
+	}
+	else
+	{
+		s32 level = 0;
+		s32 shift = WheelRootBits + WheelLevelBits;
+		while (level < WheelLevelCount - 1 && delta >= (1u << shift))
+		{
+			++level;
+			shift += WheelLevelBits;
+		}
+		node.slot = WheelRootSize + level * WheelLevelSize +
+		            static_cast<s32>((node.wakeTick >> (shift - WheelLevelBits)) & (WheelLevelSize - 1));
+	}
+	
+	node.state = NodeState_Scheduled;
+	linkTimer(ms_wheel[node.slot], p_index);
+}
+
+
+void TimerMgr::cascadeWheel(s32 p_slot)
+{
+	s32 index = ms_wheel[p_slot];
+	ms_wheel[p_slot] = -1;
+	while (index >= 0)
+	{
+		const s32 next = ms_nodes[index].next;
+		insertIntoWheel(index);
+		index = next;
+	}
+}
+
+
+void TimerMgr::syncTimer(s32 p_index)
+{
+	TimerNode& node(ms_nodes[p_index]);
+	if (node.state == NodeState_Scheduled)
+	{
+		for (u32 t = node.syncTick; t != ms_currentTick; ++t)
+		{
+			node.timer.subtractTime(ms_elapsedHistory[t - ms_historyStartTick]);
+		}
+	}
+	node.syncTick = ms_currentTick;
+}
+
+
+void TimerMgr::syncAllTimers()
+{
+	const s32 nodeCount = static_cast<s32>(ms_nodes.size());
+	for (s32 i = 0; i < nodeCount; ++i)
+	{
+		if (ms_nodes[i].state == NodeState_Scheduled)
+		{
+			syncTimer(i);
+		}
+	}
+}
+
+
+void TimerMgr::scheduleTimer(s32 p_index)
+{
+	TimerNode& node(ms_nodes[p_index]);
+	TT_ASSERT(node.syncTick == ms_currentTick);
+	const Timer& timer(node.timer);
+	
+	s64 safeUpdates = 0;
+	if (timer.isAlive() == false)
+	{
+		// Expired, stopped by setting a timeout of 0 or the target is gone; the next update removes it.
+	}
+	else if (timer.isSuspended() || timer.getTarget().getPtr()->isSuspended())
+	{
+		unlinkTimer(p_index);
+		return;
+	}
+	else if (ms_maxElapsedTime > 0.0f)
+	{
+		// The number of updates that can't make the timer expire, even when each of them takes
+		// ms_maxElapsedTime and every subtraction rounds the wrong way (by at most half an ulp).
+		const double margin = static_cast<double>(timer.getTimeout()) - tt::math::floatTolerance;
+		const double step   = static_cast<double>(ms_maxElapsedTime) +
+		                      static_cast<double>(timer.getTimeout()) * FLT_EPSILON;
+		safeUpdates = static_cast<s64>(std::floor(margin / step)) - 1;
+	}
+	
+	if (safeUpdates <= 0)
+	{
+		if (node.state != NodeState_Active)
+		{
+			unlinkTimer(p_index);
+			node.state = NodeState_Active;
+			linkTimer(ms_activeTimers, p_index);
 		}
+		return;
 	}
+	
+	unlinkTimer(p_index);
+	const s64 horizon = 1 << (WheelRootBits + WheelLevelCount * WheelLevelBits);
+	node.wakeTick = ms_currentTick + static_cast<u32>(std::min(safeUpdates, horizon - 1));
+	insertIntoWheel(p_index);
+}
+
+
+void TimerMgr::getSortedTimers(TimerIndices& p_indices_OUT)
+{
+	p_indices_OUT.clear();
+	const s32 nodeCount = static_cast<s32>(ms_nodes.size());
+	for (s32 i = 0; i < nodeCount; ++i)
+	{
+		if (ms_nodes[i].state != NodeState_Free)
+		{
+			p_indices_OUT.push_back(i);
+		}
+	}
+	
+	std::sort(p_indices_OUT.begin(), p_indices_OUT.end(), isTimerLess);
+}
+
+
+bool TimerMgr::isTimerLess(s32 p_lhs, s32 p_rhs)
+{
+	const Timer& lhs(ms_nodes[p_lhs].timer);
+	const Timer& rhs(ms_nodes[p_rhs].timer);
+	if (lhs.getTarget() == rhs.getTarget())
+	{
+		return lhs.getHash() < rhs.getHash();
+	}
+	return lhs.getTarget() < rhs.getTarget();
+}
+
+
+bool TimerMgr::isExpiredTimerLess(const ExpiredTimer& p_lhs, const ExpiredTimer& p_rhs)
+{
+	return isTimerLess(p_lhs.index, p_rhs.index);
 }
 
 
@@ -40,6 +40,18 @@ void CheckPointMgrWrapper::restoreAndClearEx(const std::string& p_id, ProgressTy
 }
 
 
+void CheckPointMgrWrapper::rewind(s32 p_checkPointsBack)
+{
+	AppGlobal::getGame()->rewindGameState(p_checkPointsBack);
+}
+
+
+s32 CheckPointMgrWrapper::getRewindCount()
+{
+	return AppGlobal::getGame()->getRewindCheckPointCount();
+}
+
+
 tt::str::Strings CheckPointMgrWrapper::getAllIDs()
 {
 	return AppGlobal::getCheckPointMgr().getAllCheckPointIDs();
@@ -110,6 +122,8 @@ void CheckPointMgrWrapper::bind(const tt::script::VirtualMachinePtr& p_vm)
 	TT_SQBIND_STATIC_METHOD(CheckPointMgrWrapper, restoreEx);
 	TT_SQBIND_STATIC_METHOD(CheckPointMgrWrapper, restoreAndClear);
 	TT_SQBIND_STATIC_METHOD(CheckPointMgrWrapper, restoreAndClearEx);
+	TT_SQBIND_STATIC_METHOD(CheckPointMgrWrapper, rewind);
+	TT_SQBIND_STATIC_METHOD(CheckPointMgrWrapper, getRewindCount);
 	TT_SQBIND_STATIC_METHOD(CheckPointMgrWrapper, getAllIDs);
 	TT_SQBIND_STATIC_METHOD(CheckPointMgrWrapper, getAllIDsEx);
 	TT_SQBIND_STATIC_METHOD(CheckPointMgrWrapper, hasID);
@@ -1529,7 +1529,7 @@ bool EntityWrapper::hasTimer(const std::string& p_name) const
 
 real EntityWrapper::getTimerTimeout(const std::string& p_name) const
 {
-	TimerPtr timer = TimerMgr::getTimer(p_name, m_handle);
+	const Timer* timer = TimerMgr::getTimer(p_name, m_handle);
 	return (timer != 0) ? timer->getTimeout() : -1.0f;
 }
 
@@ -190,9 +190,12 @@ void Recorder::stop()
 		stopRecording();
 	}
 	
-	m_gui->updateControls();
-	// FIXME: Move this to GUI?
-	m_gui->setInfoText("");
+	if (m_gui != 0)
+	{
+		m_gui->updateControls();
+		// FIXME: Move this to GUI?
+		m_gui->setInfoText("");
+	}
 }
 
 
@@ -256,11 +259,19 @@ bool Recorder::loadRecordedFile(const std::string& p_filename)
 	const RecordingHeader& header(m_currentRecording->getHeader());
 	updateTimeInfo(header.startTime, header.startTime, header.stopTime);
 	
-	if(m_gui->isVisible() == false)
+	if (m_gui != 0)
 	{
-		m_gui->toggleVisibility();
+		if(m_gui->isVisible() == false)
+		{
+			m_gui->toggleVisibility();
+		}
+		m_gui->handlePlayPressed();
+	}
+	else
+	{
+		// No GUI to press play with; start playing right away.
+		play();
 	}
-	m_gui->handlePlayPressed();
 	
 	return true;
 }
@@ -475,8 +486,10 @@ void Recorder::createGui()
 
 void Recorder::toggleGui()
 {
-	TT_NULL_ASSERT(m_gui);
-	m_gui->toggleVisibility();
+	if (m_gui != 0)
+	{
+		m_gui->toggleVisibility();
+	}
 }
 
 
@@ -519,7 +532,7 @@ void Recorder::onGameInit(game::StartInfo* p_startInfo)
 		restoreData(p_startInfo);
 	}
 	
-	m_gui->updateControls();
+	if (m_gui != 0) m_gui->updateControls();
 	
 	// Reset flags
 	m_isWaitingForInit        = false;
@@ -540,7 +553,7 @@ void Recorder::onLevelExit()
 void Recorder::onEditorOpened()
 {
 	m_editorOpen = true;
-	if(m_gui->isVisible()) m_gui->toggleVisibility();
+	if(m_gui != 0 && m_gui->isVisible()) m_gui->toggleVisibility();
 }
 
 
@@ -728,7 +741,7 @@ void Recorder::handleFirstRecordFrame()
 	TT_Printf("******** Starting new recording ********\n");
 	
 	m_currentRecording->addSection(newSection);
-	m_gui->updateControls();
+	if (m_gui != 0) m_gui->updateControls();
 	
 #if ENABLE_RECORDER_LOGGING
 	m_logRecord.open("record.log", std::ios::out|std::ios::trunc);
@@ -827,6 +840,11 @@ void Recorder::restoreData(game::StartInfo* p_startInfo) const
 
 void Recorder::updateTimeInfo(u64 p_current, u64 p_start, u64 p_stop)
 {
+	if (m_gui == 0)
+	{
+		return;
+	}
+	
 	m_gui->setInfoText(
 		getTimeAsString(p_current - p_start) + " / " +
 		getTimeAsString(p_stop    - p_start));
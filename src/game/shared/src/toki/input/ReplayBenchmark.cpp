@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cstdio>
+
+#include <json/json.h>
+
+#include <tt/fs/fs.h>
+#include <tt/math/Random.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+
+#include <toki/game/entity/EntityMgr.h>
+#include <toki/game/Game.h>
+#include <toki/input/Recorder.h>
+#include <toki/input/ReplayBenchmark.h>
+#include <toki/AppGlobal.h>
+
+
+namespace toki {
+namespace input {
+
+//--------------------------------------------------------------------------------------------------
+// Helper functions
+
+// FNV-1a
+static inline void hashBytes(u32& p_hash, const void* p_data, size_t p_size)
+{
+	const u8* bytes = reinterpret_cast<const u8*>(p_data);
+	for (size_t i = 0; i < p_size; ++i)
+	{
+		p_hash = (p_hash ^ bytes[i]) * 16777619u;
+	}
+}
+
+
+static Json::Value getStatsNode(const tt::profiler::Benchmark::Stats& p_stats)
+{
+	Json::Value node(p_stats.toJson());
+	node["totalMs"] = tt::profiler::Benchmark::toMilliSeconds(p_stats.total);
+	return node;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+ReplayBenchmarkPtr ReplayBenchmark::create(const tt::args::CmdLine& p_cmdLine)
+{
+	const std::string recordingPath(p_cmdLine.getString("benchmark"));
+	if (recordingPath.empty() || tt::fs::fileExists(recordingPath) == false)
+	{
+		TT_PANIC("Benchmark recording '%s' does not exist.", recordingPath.c_str());
+		return ReplayBenchmarkPtr();
+	}
+	
+	return ReplayBenchmarkPtr(new ReplayBenchmark(recordingPath,
+		tt::profiler::Benchmark::getOutputPath(p_cmdLine, "benchmark.json"),
+		tt::profiler::Benchmark::getCount(p_cmdLine, "benchmark_hash_interval", 60)));
+}
+
+
+bool ReplayBenchmark::update()
+{
+	const Recorder::State recorderState = AppGlobal::getInputRecorder()->getState();
+	game::Game* game = AppGlobal::hasGame() ? AppGlobal::getGame() : 0;
+	
+	switch (m_state)
+	{
+	case State_WaitingForPlayback:
+		if (recorderState == Recorder::State_Play)
+		{
+			TT_Printf("ReplayBenchmark::update: Playing '%s'\n", m_recordingPath.c_str());
+			m_state     = State_Playing;
+			m_startTime = tt::profiler::Benchmark::getMicroSeconds();
+			if (game != 0)
+			{
+				// Only frames updated from now on are part of the benchmark.
+				m_lastGame      = game;
+				m_lastGameFrame = game->getUpdateSectionProfiler().getFrameCount();
+			}
+		}
+		else if (game != 0 && game->getUpdateSectionProfiler().getFrameCount() > 0)
+		{
+			// The game loads the recording (and starts playing it) during init.
+			TT_PANIC("Could not play benchmark recording '%s'.", m_recordingPath.c_str());
+			m_state = State_Failed;
+		}
+		break;
+	
+	case State_Playing:
+		if (recorderState != Recorder::State_Play)
+		{
+			// End of recording
+			m_playTime = tt::profiler::Benchmark::getMicroSeconds() - m_startTime;
+			m_state    = writeReport() ? State_Done : State_Failed;
+			break;
+		}
+		
+		// Level changes between recording sections create a new game.
+		if (game != 0 &&
+		    (game != m_lastGame || game->getUpdateSectionProfiler().getFrameCount() != m_lastGameFrame))
+		{
+			m_lastGame      = game;
+			m_lastGameFrame = game->getUpdateSectionProfiler().getFrameCount();
+			addFrame(*game);
+		}
+		break;
+	
+	default:
+		break;
+	}
+	
+	return m_state == State_WaitingForPlayback || m_state == State_Playing;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+ReplayBenchmark::ReplayBenchmark(const std::string& p_recordingPath, const std::string& p_outputPath,
+                                 s32 p_hashInterval)
+:
+m_recordingPath(p_recordingPath),
+m_outputPath(p_outputPath),
+m_hashInterval(p_hashInterval),
+m_state(State_WaitingForPlayback),
+m_startTime(0),
+m_playTime(0),
+m_frameCount(0),
+m_lastGame(0),
+m_lastGameFrame(0),
+m_frameTotal(),
+m_stateHashes()
+{
+}
+
+
+void ReplayBenchmark::addFrame(game::Game& p_game)
+{
+	const utils::FrameUpdateSectionProfiler& profiler(p_game.getUpdateSectionProfiler());
+	for (s32 i = 0; i < utils::FrameUpdateSection_Count; ++i)
+	{
+		m_sections[i].add(profiler.getSectionTime(static_cast<utils::FrameUpdateSection>(i)));
+	}
+	m_frameTotal.add(profiler.getTotalTime());
+	
+	++m_frameCount;
+	if ((m_frameCount % m_hashInterval) == 0)
+	{
+		StateHash stateHash = { m_frameCount, getGameStateHash(p_game) };
+		m_stateHashes.push_back(stateHash);
+	}
+}
+
+
+u32 ReplayBenchmark::getGameStateHash(game::Game& p_game)
+{
+	u32 hash = 2166136261u;
+	
+	const u64 seed = tt::math::Random::getStatic().getContextSeedValue();
+	hashBytes(hash, &seed, sizeof(seed));
+	
+	const game::entity::EntityMgr& entityMgr(p_game.getEntityMgr());
+	const s32 entityCount = entityMgr.getActiveEntitiesCount();
+	hashBytes(hash, &entityCount, sizeof(entityCount));
+	
+	const game::entity::Entity* entity = entityMgr.getFirstEntity();
+	for (s32 i = 0; i < entityCount; ++i, ++entity)
+	{
+		const u32                handle   = entity->getHandle().getValue();
+		const tt::math::Vector2& position = entity->getPosition();
+		hashBytes(hash, &handle,     sizeof(handle));
+		hashBytes(hash, &position.x, sizeof(position.x));
+		hashBytes(hash, &position.y, sizeof(position.y));
+	}
+	
+	return hash;
+}
+
+
+bool ReplayBenchmark::writeReport() const
+{
+	Json::Value rootNode(Json::objectValue);
+	rootNode["recording"   ] = m_recordingPath;
+	rootNode["frames"      ] = m_frameCount;
+	rootNode["playTimeMs"  ] = tt::profiler::Benchmark::toMilliSeconds(m_playTime);
+	rootNode["hashInterval"] = m_hashInterval;
+	rootNode["update"      ] = getStatsNode(m_frameTotal);
+	
+	Json::Value& sectionsNode(rootNode["sections"]);
+	for (s32 i = 0; i < utils::FrameUpdateSection_Count; ++i)
+	{
+		const utils::FrameUpdateSection section = static_cast<utils::FrameUpdateSection>(i);
+		sectionsNode[utils::getName(section)] = getStatsNode(m_sections[i]);
+	}
+	
+	Json::Value& hashesNode(rootNode["stateHashes"]);
+	hashesNode = Json::Value(Json::arrayValue);
+	for (StateHashes::const_iterator it = m_stateHashes.begin(); it != m_stateHashes.end(); ++it)
+	{
+		char hashStr[16];
+		sprintf(hashStr, "%08x", (*it).hash);
+		
+		Json::Value hashNode(Json::objectValue);
+		hashNode["frame"] = (*it).frame;
+		hashNode["hash" ] = hashStr;
+		hashesNode.append(hashNode);
+	}
+	
+	TT_Printf("ReplayBenchmark::writeReport: %u frames in %.1f ms, update avg %.3f ms\n",
+	          m_frameCount, tt::profiler::Benchmark::toMilliSeconds(m_playTime), m_frameTotal.getAverageMs());
+	
+	return tt::profiler::Benchmark::writeReport("ReplayBenchmark", rootNode, m_outputPath);
+}
+
+// Namespace end
+}
+}
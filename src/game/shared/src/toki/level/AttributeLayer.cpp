@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <tt/code/helpers.h>
 #include <tt/mem/util.h>
 #include <tt/platform/tt_printf.h>
@@ -187,6 +189,46 @@ bool AttributeLayer::equals(const AttributeLayerPtr& p_other) const
 }
 
 
+bool AttributeLayer::getChangedRect(const AttributeLayerPtr& p_other,
+                                    tt::math::PointRect*     p_changedRect_OUT) const
+{
+	TT_NULL_ASSERT(p_changedRect_OUT);
+	
+	if (p_other == 0 || m_height != p_other->m_height || m_width != p_other->m_width)
+	{
+		p_changedRect_OUT->setValues(tt::math::Point2(0, 0), m_width, m_height);
+		return true;
+	}
+	
+	tt::math::Point2 min(m_width, m_height);
+	tt::math::Point2 max(-1, -1);
+	
+	const u8* ptr      = m_attributes;
+	const u8* otherPtr = p_other->m_attributes;
+	for (tt::math::Point2 pos(0, 0); pos.y < m_height; ++pos.y)
+	{
+		for (pos.x = 0; pos.x < m_width; ++pos.x, ++ptr, ++otherPtr)
+		{
+			if (*ptr != *otherPtr)
+			{
+				min.x = std::min(min.x, pos.x);
+				min.y = std::min(min.y, pos.y);
+				max.x = std::max(max.x, pos.x);
+				max.y = std::max(max.y, pos.y);
+			}
+		}
+	}
+	
+	if (max.x < 0)
+	{
+		return false;
+	}
+	
+	*p_changedRect_OUT = tt::math::PointRect(min, max);
+	return true;
+}
+
+
 AttributeLayerPtr AttributeLayer::clone() const
 {
 	AttributeLayerPtr clonedLayer(new AttributeLayer(m_width, m_height));
@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <cstring>
+#include <set>
 
 #include <json/json.h>
 
@@ -968,10 +970,30 @@ const tt::engine::renderer::ColorRGBA& LevelData::getThemeColor(
 tt::code::AutoGrowBufferPtr LevelData::createPathfindingData()
 {
 	m_pathfindingData = tt::code::AutoGrowBuffer::create(4096, 4096);
+	m_loadedPathfindingData.reset();
 	return m_pathfindingData;
 }
 
 
+void LevelData::invalidatePathfindingData()
+{
+	m_pathfindingData.reset();
+	m_loadedPathfindingData.reset();
+}
+
+
+tt::code::BufferReadContext LevelData::getPathfindingReadContext() const
+{
+	if (m_pathfindingData != 0)
+	{
+		return m_pathfindingData->getReadContext();
+	}
+	
+	TT_ASSERTMSG(m_loadedPathfindingData != 0, "Level '%s' has no pathfinding data.", m_filename.c_str());
+	return m_loadedPathfindingData->getReadContext();
+}
+
+
 bool LevelData::isValidLevelTheme(ThemeType p_theme)
 {
 	// The level theme can not be "use level default" (that would be recursive)
@@ -996,6 +1018,7 @@ m_entities(),
 m_notes(),
 m_agentRadii(),
 m_pathfindingData(),
+m_loadedPathfindingData(),
 m_steamPublishedFileId(0),
 m_steamOwnerId(0),
 m_selectedEntities(),
@@ -1018,6 +1041,7 @@ m_startPos(p_rhs.m_startPos),
 m_entities(),
 m_notes(),
 m_pathfindingData((p_rhs.m_pathfindingData != 0) ? p_rhs.m_pathfindingData->clone() : tt::code::AutoGrowBufferPtr()),
+m_loadedPathfindingData(p_rhs.m_loadedPathfindingData),  // NOTE: The loaded chunk is never modified, so it can be shared
 m_steamPublishedFileId(p_rhs.m_steamPublishedFileId),
 m_steamOwnerId        (p_rhs.m_steamOwnerId),
 m_selectedEntities(),
@@ -1567,10 +1591,14 @@ bool LevelData::parseChunkGlobalInfo(u32 p_version, size_t p_chunkSize, const u8
 		const std::string defaultMission = bu::get<std::string>(p_chunkData, p_chunkSize);
 		setDefaultMission(defaultMission);
 		
-		const std::string& missionID(AppGlobal::getGame()->getMissionID());
-		if (missionID.empty() || missionID == "*")
+		// NOTE: Levels can also be loaded without a game (e.g. by the level load benchmark)
+		if (AppGlobal::hasGame())
 		{
-			AppGlobal::getGame()->setMissionID(defaultMission);
+			const std::string& missionID(AppGlobal::getGame()->getMissionID());
+			if (missionID.empty() || missionID == "*")
+			{
+				AppGlobal::getGame()->setMissionID(defaultMission);
+			}
 		}
 	}
 	
@@ -1681,6 +1709,12 @@ bool LevelData::parseChunkEntities(u32 p_version, size_t p_chunkSize, const u8*
 		return false;
 	}
 	
+	std::set<s32> entityIDs;
+	for (entity::EntityInstances::const_iterator it = m_entities.begin(); it != m_entities.end(); ++it)
+	{
+		entityIDs.insert((*it)->getID());
+	}
+	
 	for (s32 entityIdx = 0; entityIdx < entityCount; ++entityIdx)
 	{
 		// Early out if no more bytes remain
@@ -1721,7 +1755,7 @@ bool LevelData::parseChunkEntities(u32 p_version, size_t p_chunkSize, const u8*
 		}
 		
 		// Verify that this entity ID is unique
-		if (getEntityByID(entityID) != 0)
+		if (entityIDs.insert(entityID).second == false)
 		{
 			TT_PANIC("Entity chunk contains more than one entity with ID %d. This is not allowed.",
 			         entityID);
@@ -1730,6 +1764,7 @@ bool LevelData::parseChunkEntities(u32 p_version, size_t p_chunkSize, const u8*
 		
 		entity::EntityInstancePtr entity(entity::EntityInstance::create(entityType, entityID, pos));
 		
+		entity::EntityInstance::Properties properties;
 		for (s32 propIdx = 0; propIdx < propCount; ++propIdx)
 		{
 			// NOTE: Using be_get instead of get, because the legacy getNarrowString used big-endian internally
@@ -1742,10 +1777,10 @@ bool LevelData::parseChunkEntities(u32 p_version, size_t p_chunkSize, const u8*
 				return false;
 			}
 			
-			// NOTE: Using be_get instead of get, because the legacy getNarrowString used big-endian internally
-			const std::string propVal(bu::be_get<std::string>(p_chunkData, p_chunkSize));
-			entity->setPropertyValue(propName, propVal);
+			// A property that is stored more than once keeps its last value
+			properties[propName] = bu::be_get<std::string>(p_chunkData, p_chunkSize);
 		}
+		entity->setProperties(properties);
 		
 		m_entities.push_back(entity);
 	}
@@ -1806,15 +1841,14 @@ bool LevelData::parseChunkPathfinding(u32 p_version, size_t p_chunkSize, const u
 	             "This code supports pathfinding chunks up to and including version %u.",
 	             p_version, g_chunkVersionPathfinding);
 	
-	namespace bu = tt::code::bufferutils;
-	
+	// Keep only this chunk, so the rest of the file content is released when loading is done
+	m_pathfindingData.reset();
+	m_loadedPathfindingData.reset();
 	if (p_chunkSize > 0)
 	{
-		m_pathfindingData = tt::code::AutoGrowBuffer::createPrePopulated(p_chunkData, static_cast<tt::code::Buffer::size_type>(p_chunkSize), 1024);
-	}
-	else
-	{
-		m_pathfindingData.reset();
+		tt::code::BufferPtrForCreator chunk(new tt::code::Buffer(static_cast<tt::code::Buffer::size_type>(p_chunkSize)));
+		std::memcpy(chunk->getData(), p_chunkData, p_chunkSize);
+		m_loadedPathfindingData = chunk;
 	}
 	
 	return true;
@@ -2089,6 +2123,11 @@ tt::code::AutoGrowBufferPtr LevelData::saveChunkPathfinding() const
 			bu::put(reinterpret_cast<const u8*>(m_pathfindingData->getBlock(i)), blockSize, &context);
 		}
 	}
+	else if (m_loadedPathfindingData != 0)
+	{
+		bu::put(reinterpret_cast<const u8*>(m_loadedPathfindingData->getData()),
+		        static_cast<size_t>(m_loadedPathfindingData->getSize()), &context);
+	}
 	
 	context.flush();
 	
@@ -0,0 +1,142 @@
+#include <json/json.h>
+
+#include <tt/fs/File.h>
+#include <tt/fs/fs.h>
+#include <tt/fs/utils/utils.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+#include <tt/profiler/Benchmark.h>
+
+#include <toki/game/pathfinding/PathMgr.h>
+#include <toki/level/entity/EntityInstance.h>
+#include <toki/level/LevelData.h>
+#include <toki/level/LevelLoadBenchmark.h>
+
+
+namespace toki {
+namespace level {
+
+//--------------------------------------------------------------------------------------------------
+// Helper functions
+
+// Bytes held by the names and values of all entity properties
+static size_t getPropertyBytes(const entity::EntityInstances& p_entities)
+{
+	size_t bytes = 0;
+	for (entity::EntityInstances::const_iterator it = p_entities.begin(); it != p_entities.end(); ++it)
+	{
+		const entity::EntityInstance::Properties& properties((*it)->getProperties());
+		for (entity::EntityInstance::Properties::const_iterator propIt = properties.begin();
+		     propIt != properties.end(); ++propIt)
+		{
+			bytes += (*propIt).first.size() + (*propIt).second.size();
+		}
+	}
+	return bytes;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+bool LevelLoadBenchmark::run(const tt::args::CmdLine& p_cmdLine)
+{
+	using tt::profiler::Benchmark;
+	
+	const std::string levelsPath(Benchmark::getFolder(p_cmdLine, "benchmark_levels", "levels/"));
+	const s32         iterations(Benchmark::getCount(p_cmdLine, "benchmark_iterations", 5));
+	
+	const tt::str::StringSet levelNames(tt::fs::utils::getFilesInDir(levelsPath, "*.ttlvl"));
+	if (levelNames.empty())
+	{
+		TT_PANIC("No levels found in '%s'.", levelsPath.c_str());
+		return false;
+	}
+	
+	Json::Value rootNode(Json::objectValue);
+	rootNode["folder"    ] = levelsPath;
+	rootNode["iterations"] = iterations;
+	Json::Value& levelsNode(rootNode["levels"]);
+	levelsNode = Json::Value(Json::arrayValue);
+	
+	u64 allLevelsTotal = 0;
+	for (tt::str::StringSet::const_iterator it = levelNames.begin(); it != levelNames.end(); ++it)
+	{
+		const std::string filename(levelsPath + *it + ".ttlvl");
+		
+		Benchmark::Stats load;
+		Benchmark::Stats pathfinding;
+		Benchmark::Stats total;
+		s32    entityCount   = 0;
+		size_t retainedBytes = 0;
+		size_t propertyBytes = 0;
+		bool   success       = true;
+		
+		for (s32 i = 0; i < iterations && success; ++i)
+		{
+			const u64 startTime = Benchmark::getMicroSeconds();
+			
+			// Also decodes all entity properties
+			LevelDataPtr levelData(LevelData::loadLevel(filename));
+			const u64 loadedTime = Benchmark::getMicroSeconds();
+			if (levelData == 0)
+			{
+				success = false;
+				break;
+			}
+			
+			if (levelData->hasPathfindingData())
+			{
+				game::pathfinding::PathMgr pathMgr;
+				pathMgr.loadTileCachesFromLevelData(levelData);
+			}
+			const u64 endTime = Benchmark::getMicroSeconds();
+			
+			load       .add(loadedTime - startTime);
+			pathfinding.add(endTime    - loadedTime);
+			total      .add(endTime    - startTime);
+			entityCount   = levelData->getEntityCount();
+			retainedBytes = levelData->getLoadedPathfindingSize();
+			propertyBytes = getPropertyBytes(levelData->getAllEntities());
+		}
+		
+		Json::Value levelNode(Json::objectValue);
+		levelNode["level"] = *it;
+		if (success == false)
+		{
+			TT_PANIC("Loading level '%s' failed.", filename.c_str());
+			levelNode["failed"] = true;
+			levelsNode.append(levelNode);
+			continue;
+		}
+		
+		// The whole file is read while loading; afterwards the level only keeps the pathfinding chunk.
+		tt::fs::FilePtr levelFile(tt::fs::open(filename, tt::fs::OpenMode_Read));
+		levelNode["bytes"        ] = (levelFile != 0) ? static_cast<Json::UInt>(levelFile->getLength()) : 0u;
+		levelNode["retainedBytes"] = static_cast<Json::UInt>(retainedBytes);
+		levelNode["propertyBytes"] = static_cast<Json::UInt>(propertyBytes);
+		levelNode["entities"     ] = entityCount;
+		levelNode["load"         ] = load.toJson();
+		levelNode["pathfinding"  ] = pathfinding.toJson();
+		levelNode["total"        ] = total.toJson();
+		levelsNode.append(levelNode);
+		
+		allLevelsTotal += total.total / iterations;
+		
+		TT_Printf("LevelLoadBenchmark::run: '%s': %.3f ms (load %.3f ms, pathfinding %.3f ms), "
+		          "%u bytes kept from the file\n",
+		          it->c_str(), total.getAverageMs(), load.getAverageMs(), pathfinding.getAverageMs(),
+		          static_cast<u32>(retainedBytes));
+	}
+	rootNode["totalAvgMs"] = Benchmark::toMilliSeconds(allLevelsTotal);
+	
+	TT_Printf("LevelLoadBenchmark::run: %d levels in %.1f ms.\n",
+	          static_cast<s32>(levelNames.size()), Benchmark::toMilliSeconds(allLevelsTotal));
+	
+	return Benchmark::writeReport("LevelLoadBenchmark", rootNode,
+	                              Benchmark::getOutputPath(p_cmdLine, "benchmark_levels.json"));
+}
+
+// Namespace end
+}
+}
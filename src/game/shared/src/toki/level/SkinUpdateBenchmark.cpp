@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <vector>
+
+#include <json/json.h>
+
+#include <tt/engine/scene2d/shoebox/shoebox_types.h>
+#include <tt/math/Random.h>
+#include <tt/platform/tt_error.h>
+#include <tt/platform/tt_printf.h>
+#include <tt/profiler/Benchmark.h>
+
+#include <toki/level/skin/functions.h>
+#include <toki/level/skin/SkinContext.h>
+#include <toki/level/AttributeLayer.h>
+#include <toki/level/LevelData.h>
+#include <toki/level/SkinUpdateBenchmark.h>
+#include <toki/AppGlobal.h>
+
+
+namespace toki {
+namespace level {
+
+//--------------------------------------------------------------------------------------------------
+// Helper functions
+
+struct BenchmarkLevel
+{
+	const char* name;
+	s32         width;
+	s32         height;
+};
+
+static const BenchmarkLevel g_levels[] =
+{
+	{ "cave_small", 128,  64 },
+	{ "cave_wide",  512, 128 },
+	{ "cave_tall",   96, 512 }
+};
+
+static const s32 g_maxBrushSize = 6;
+
+
+/*! \brief The fields of a plane that end up on screen.
+    Planes are compared in the order they're emitted: BinaryPlanePartition breaks priority ties by
+    plane index, so an update that reorders planes changes what's drawn on top. */
+struct PlaneKey
+{
+	enum { ValueCount = 14 };
+	
+	std::string texture;
+	real        values[ValueCount];
+	u32         colors[4];
+	s32         priority;
+	
+	explicit PlaneKey(const tt::engine::scene2d::shoebox::PlaneData& p_plane)
+	:
+	texture(p_plane.textureFilename),
+	priority(p_plane.priority.get())
+	{
+		const real values[ValueCount] =
+		{
+			p_plane.position.x, p_plane.position.y, p_plane.position.z, p_plane.rotation.get(),
+			p_plane.width.get(), p_plane.height.get(),
+			p_plane.texTopLeftU.get(),    p_plane.texTopLeftV.get(),
+			p_plane.texTopRightU.get(),   p_plane.texTopRightV.get(),
+			p_plane.texBottomLeftU.get(), p_plane.texBottomLeftV.get(),
+			p_plane.texBottomRightU.get(), p_plane.texBottomRightV.get()
+		};
+		std::copy(values, values + ValueCount, this->values);
+		
+		colors[0] = getColorValue(p_plane.colorTopLeft.get());
+		colors[1] = getColorValue(p_plane.colorTopRight.get());
+		colors[2] = getColorValue(p_plane.colorBottomLeft.get());
+		colors[3] = getColorValue(p_plane.colorBottomRight.get());
+	}
+	
+	inline bool operator==(const PlaneKey& p_rhs) const
+	{
+		return texture  == p_rhs.texture                             &&
+		       priority == p_rhs.priority                            &&
+		       std::equal(values, values + ValueCount, p_rhs.values) &&
+		       std::equal(colors, colors + 4,          p_rhs.colors);
+	}
+	
+private:
+	static inline u32 getColorValue(const tt::engine::renderer::ColorRGBA& p_color)
+	{
+		return (static_cast<u32>(p_color.r) << 24) | (static_cast<u32>(p_color.g) << 16) |
+		       (static_cast<u32>(p_color.b) <<  8) |  static_cast<u32>(p_color.a);
+	}
+};
+typedef std::vector<PlaneKey> PlaneKeys;
+
+
+static void getKeys(const tt::engine::scene2d::shoebox::ShoeboxData& p_data, PlaneKeys* p_keys_OUT)
+{
+	p_keys_OUT->clear();
+	p_keys_OUT->reserve(p_data.planes.size());
+	for (tt::engine::scene2d::shoebox::ShoeboxData::Planes::const_iterator it = p_data.planes.begin();
+	     it != p_data.planes.end(); ++it)
+	{
+		p_keys_OUT->push_back(PlaneKey(*it));
+	}
+}
+
+
+/*! \brief Fills the level with caves: a smoothed noise pattern of solid, crystal, water and air tiles
+           split in regions with different themes, plus a grid of overridden theme tiles. */
+static void createCaves(const LevelDataPtr& p_level, tt::math::Random& p_random, ThemeTiles* p_overrides_OUT)
+{
+	const AttributeLayerPtr& layer(p_level->getAttributeLayer());
+	const s32 width  = layer->getWidth();
+	const s32 height = layer->getHeight();
+	
+	std::vector<u8> solid(static_cast<std::vector<u8>::size_type>(width * height), 0);
+	for (std::vector<u8>::size_type i = 0; i < solid.size(); ++i)
+	{
+		solid[i] = (p_random.getNext(100) < 48) ? 1 : 0;
+	}
+	
+	// A few cellular automaton steps turn the noise into caves.
+	for (s32 step = 0; step < 4; ++step)
+	{
+		std::vector<u8> next(solid);
+		for (s32 y = 0; y < height; ++y)
+		{
+			for (s32 x = 0; x < width; ++x)
+			{
+				s32 solidNeighbors = 0;
+				for (s32 dy = -1; dy <= 1; ++dy)
+				{
+					for (s32 dx = -1; dx <= 1; ++dx)
+					{
+						const s32 nx = x + dx;
+						const s32 ny = y + dy;
+						const bool outside = nx < 0 || ny < 0 || nx >= width || ny >= height;
+						solidNeighbors += outside ? 1 : solid[ny * width + nx];
+					}
+				}
+				next[y * width + x] = (solidNeighbors >= 5) ? 1 : 0;
+			}
+		}
+		solid.swap(next);
+	}
+	
+	for (tt::math::Point2 pos(0, 0); pos.y < height; ++pos.y)
+	{
+		for (pos.x = 0; pos.x < width; ++pos.x)
+		{
+			const u32 roll = p_random.getNext(100);
+			if (solid[pos.y * width + pos.x] != 0)
+			{
+				layer->setCollisionType(pos, (roll < 8) ? CollisionType_Crystal_Solid : CollisionType_Solid);
+			}
+			else
+			{
+				layer->setCollisionType(pos, (roll < 5) ? CollisionType_Water_Still : CollisionType_Air);
+			}
+			
+			const s32 region = ((pos.x / 23) + (pos.y / 17)) % 7;
+			layer->setThemeType(pos, (region < 3) ? ThemeType_UseLevelDefault :
+			                                        static_cast<ThemeType>(ThemeType_Sand + region - 3));
+		}
+	}
+	
+	p_overrides_OUT->clear();
+	for (tt::math::Point2 pos(0, 0); pos.y < height; pos.y += 7)
+	{
+		for (pos.x = 0; pos.x < width; pos.x += 11)
+		{
+			(*p_overrides_OUT)[pos] = static_cast<ThemeType>(ThemeType_DoNotTheme + ((pos.x + pos.y) % 5));
+		}
+	}
+}
+
+
+/*! \brief Paints a random brush stroke of up to g_maxBrushSize tiles wide and high. */
+static void paintBrush(const AttributeLayerPtr& p_layer, tt::math::Random& p_random)
+{
+	const s32 brushWidth  = 1 + static_cast<s32>(p_random.getNext(g_maxBrushSize));
+	const s32 brushHeight = 1 + static_cast<s32>(p_random.getNext(g_maxBrushSize));
+	const s32 left        = static_cast<s32>(p_random.getNext(static_cast<u32>(p_layer->getWidth())));
+	const s32 top         = static_cast<s32>(p_random.getNext(static_cast<u32>(p_layer->getHeight())));
+	const u32 brush       = p_random.getNext(4);
+	
+	const s32 right  = std::min(left + brushWidth,  p_layer->getWidth());
+	const s32 bottom = std::min(top  + brushHeight, p_layer->getHeight());
+	for (tt::math::Point2 pos(left, top); pos.y < bottom; ++pos.y)
+	{
+		for (pos.x = left; pos.x < right; ++pos.x)
+		{
+			switch (brush)
+			{
+			case 0: p_layer->setCollisionType(pos, CollisionType_Air);           break;
+			case 1: p_layer->setCollisionType(pos, CollisionType_Solid);         break;
+			case 2: p_layer->setCollisionType(pos, CollisionType_Crystal_Solid); break;
+			default: p_layer->setThemeType(pos, static_cast<ThemeType>(ThemeType_Sand + (pos.x % 4))); break;
+			}
+		}
+	}
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+bool SkinUpdateBenchmark::run(const tt::args::CmdLine& p_cmdLine)
+{
+	using tt::profiler::Benchmark;
+	
+	const std::string outputPath(Benchmark::getOutputPath(p_cmdLine, "benchmark_skin_update.json"));
+	const s32         iterations(Benchmark::getCount(p_cmdLine, "benchmark_iterations", 50));
+	
+	// The skin configs are normally loaded by a load state, which hasn't run yet.
+	if (AppGlobal::getSkinConfig(skin::SkinConfigType_Solid) == 0)
+	{
+		AppGlobal::createSkinConfigs();
+	}
+	
+	tt::math::Random random(1337u);
+	
+	Json::Value rootNode(Json::objectValue);
+	rootNode["iterations"] = iterations;
+	Json::Value& levelsNode(rootNode["levels"]);
+	levelsNode = Json::Value(Json::arrayValue);
+	
+	bool allMatch = true;
+	const s32 levelCount = static_cast<s32>(sizeof(g_levels) / sizeof(g_levels[0]));
+	for (s32 levelIndex = 0; levelIndex < levelCount; ++levelIndex)
+	{
+		const BenchmarkLevel& benchmarkLevel(g_levels[levelIndex]);
+		
+		LevelDataPtr levelData(LevelData::create(benchmarkLevel.width, benchmarkLevel.height));
+		if (levelData == 0)
+		{
+			TT_PANIC("Creating benchmark level '%s' failed.", benchmarkLevel.name);
+			return false;
+		}
+		const AttributeLayerPtr& layer(levelData->getAttributeLayer());
+		ThemeTiles overrides;
+		createCaves(levelData, random, &overrides);
+		
+		skin::SkinContextPtr updateContext(skin::SkinContext::create(layer->getWidth(), layer->getHeight()));
+		skin::SkinContextPtr fullContext(  skin::SkinContext::create(layer->getWidth(), layer->getHeight()));
+		tt::engine::scene2d::shoebox::ShoeboxData updatedSkin;
+		skin::generateSkinShoebox(updateContext, levelData, levelData->getLevelTheme(), overrides, &updatedSkin);
+		
+		Benchmark::Stats update;
+		Benchmark::Stats full;
+		s32              mismatches = 0;
+		PlaneKeys        updatedKeys;
+		PlaneKeys        fullKeys;
+		
+		for (s32 i = 0; i < iterations; ++i)
+		{
+			paintBrush(layer, random);
+			
+			const u64 startTime = Benchmark::getMicroSeconds();
+			skin::updateSkinShoebox(updateContext, levelData, levelData->getLevelTheme(), overrides, &updatedSkin);
+			const u64 updatedTime = Benchmark::getMicroSeconds();
+			
+			tt::engine::scene2d::shoebox::ShoeboxData fullSkin;
+			skin::generateSkinShoebox(fullContext, levelData, levelData->getLevelTheme(), overrides, &fullSkin);
+			const u64 endTime = Benchmark::getMicroSeconds();
+			
+			update.add(updatedTime - startTime);
+			full  .add(endTime     - updatedTime);
+			
+			getKeys(updatedSkin, &updatedKeys);
+			getKeys(fullSkin,    &fullKeys);
+			if (updatedKeys != fullKeys)
+			{
+				++mismatches;
+			}
+		}
+		
+		allMatch = allMatch && mismatches == 0;
+		
+		Json::Value levelNode(Json::objectValue);
+		levelNode["level"     ] = benchmarkLevel.name;
+		levelNode["width"     ] = benchmarkLevel.width;
+		levelNode["height"    ] = benchmarkLevel.height;
+		levelNode["planes"    ] = static_cast<Json::UInt>(updatedSkin.planes.size());
+		levelNode["update"    ] = update.toJson();
+		levelNode["full"      ] = full.toJson();
+		levelNode["speedup"   ] = (update.total > 0) ?
+			static_cast<double>(full.total) / static_cast<double>(update.total) : 0.0;
+		levelNode["mismatches"] = mismatches;
+		levelsNode.append(levelNode);
+		
+		TT_Printf("SkinUpdateBenchmark::run: '%s' (%d x %d): update %.3f ms, full %.3f ms, %d mismatches\n",
+		          benchmarkLevel.name, benchmarkLevel.width, benchmarkLevel.height,
+		          update.getAverageMs(), full.getAverageMs(),
+		          mismatches);
+	}
+	rootNode["match"] = allMatch;
+	
+	TT_Printf("SkinUpdateBenchmark::run: Updated skins %s the regenerated ones\n",
+	          allMatch ? "match" : "DON'T match");
+	
+	return Benchmark::writeReport("SkinUpdateBenchmark", rootNode, outputPath) && allMatch;
+}
+
+// Namespace end
+}
+}
@@ -0,0 +1,58 @@
+#include <algorithm>
+
+#include <tt/code/TileRayTracer.h>
+#include <tt/platform/tt_error.h>
+
+#include <toki/level/TileBitmap.h>
+
+
+namespace toki {
+namespace level {
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+TileBitmap::TileBitmap()
+:
+m_width(0),
+m_height(0),
+m_wordsPerRow(0),
+m_words()
+{
+}
+
+
+void TileBitmap::resize(s32 p_width, s32 p_height)
+{
+	TT_ASSERT(p_width >= 0 && p_height >= 0);
+	m_width       = std::max(p_width,  s32(0));
+	m_height      = std::max(p_height, s32(0));
+	m_wordsPerRow = (m_width + 31) / 32;
+	m_words.assign(static_cast<Words::size_type>(m_wordsPerRow * m_height), 0);
+}
+
+
+bool TileBitmap::traceRay(const tt::math::Vector2& p_start, const tt::math::Vector2& p_end) const
+{
+	HitTester hitTester(*this);
+	return tt::code::tileRayTrace(p_start, p_end, hitTester);
+}
+
+
+void TileBitmap::traceRays(const Rays& p_rays, GroupResults& p_groupResults_IN_OUT) const
+{
+	HitTester hitTester(*this);
+	for (Rays::const_iterator it = p_rays.begin(); it != p_rays.end(); ++it)
+	{
+		TT_ASSERT(it->group >= 0 && it->group < static_cast<s32>(p_groupResults_IN_OUT.size()));
+		u8& groupResult(p_groupResults_IN_OUT[it->group]);
+		if (groupResult == 0 && tt::code::tileRayTrace(it->start, it->end, hitTester))
+		{
+			groupResult = 1;
+		}
+	}
+}
+
+// Namespace end
+}
+}
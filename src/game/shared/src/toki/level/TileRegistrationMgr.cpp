@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <tt/engine/debug/DebugRenderer.h>
 #include <tt/engine/renderer/Renderer.h>
 
@@ -18,10 +20,12 @@ namespace level {
 
 TileRegistrationMgr::TileRegistrationMgr()
 :
-m_registeredEntityHandles(0),
 m_registeredEntityTiles(0),
 m_collisionTypes(0),
-m_hasEntities(0),
+m_entityCells(),
+m_overflowHandles(),
+m_freeOverflowIndices(),
+m_lightBlockingTiles(),
 m_changedTiles(),
 m_levelLayer(),
 m_levelBounds(0,0),
@@ -31,10 +35,8 @@ m_cellCount(0)
 {
 #if defined(USE_STD_VECTOR)
 	const u32 reserveSize = 200 * 200;
-	m_registeredEntityHandles.reserve(reserveSize);
 	m_registeredEntityTiles	 .reserve(reserveSize);
 	m_collisionTypes		 .reserve(reserveSize);
-	m_hasEntities			 .reserve(reserveSize);
 #endif
 }
 
@@ -42,10 +44,8 @@ m_cellCount(0)
 TileRegistrationMgr::~TileRegistrationMgr()
 {
 #if !defined(USE_STD_VECTOR)
-	delete[] m_registeredEntityHandles;
 	delete[] m_registeredEntityTiles;
 	delete[] m_collisionTypes;
-	delete[] m_hasEntities;
 #endif
 }
 
@@ -61,11 +61,14 @@ void TileRegistrationMgr::reset()
 			m_registeredEntityTiles[i].clear();
 		}
 		
-		for (s32 i = 0; i < m_cellCount; ++i)
-		{
-			m_registeredEntityHandles[i].clear();
-			m_hasEntities[i] = false;
-		}
+	}
+	
+	m_entityCells.assign(m_cellCount, EntityCell());
+	m_freeOverflowIndices.clear();
+	for (s32 i = static_cast<s32>(m_overflowHandles.size()) - 1; i >= 0; --i)
+	{
+		m_overflowHandles[i].clear();
+		m_freeOverflowIndices.push_back(i);
 	}
 	m_changedTiles.clear();
 	getCollisionTypesFromLevel();
@@ -95,9 +98,7 @@ void TileRegistrationMgr::registerEntityHandle(const tt::math::PointRect&
 	{
 		for (s32 y = miny; y < maxy; y += cellSize)
 		{
-			const s32 cellIndex = getCellIndex(x, y);
-			m_registeredEntityHandles[cellIndex].insert(p_entityHandle);
-			m_hasEntities[cellIndex] = true;
+			addEntityToCell(getCellIndex(x, y), p_entityHandle);
 		}
 	}
 }
@@ -125,24 +126,10 @@ void TileRegistrationMgr::unregisterEntityHandle(const tt::math::PointRect&
 	{
 		for (s32 y = miny; y < maxy; y += cellSize)
 		{
-			const s32 cellIndex = getCellIndex(x, y);
-			
-			EntityHandleSet::iterator it = m_registeredEntityHandles[cellIndex].find(p_entityHandle);
-			
-			if (it != m_registeredEntityHandles[cellIndex].end())
-			{
-				// Remove this entry from the set
-				m_registeredEntityHandles[cellIndex].erase(it);
-			}
-			else
+			if (removeEntityFromCell(getCellIndex(x, y), p_entityHandle) == false)
 			{
 				TT_PANIC("Trying to unregister EntityHandle '%d' on cell location (%d, %d) without that entity", p_entityHandle.getValue(), x, y);
 			}
-
-			if(m_registeredEntityHandles[cellIndex].empty())
-			{
-				m_hasEntities[cellIndex] = false;
-			}
 		}
 	}
 }
@@ -187,23 +174,10 @@ void TileRegistrationMgr::moveRegisterEntityHandle(const tt::math::PointRect&
 				continue; // Inside new rect, ignore.
 			}
 			
-			const s32 cellIndex = getCellIndex(x, y);
-			EntityHandleSet::iterator it = m_registeredEntityHandles[cellIndex].find(p_entityHandle);
-			
-			if (it != m_registeredEntityHandles[cellIndex].end())
-			{
-				// Remove this entry from the set
-				m_registeredEntityHandles[cellIndex].erase(it);
-			}
-			else
+			if (removeEntityFromCell(getCellIndex(x, y), p_entityHandle) == false)
 			{
 				TT_PANIC("Trying to unregister EntityHandle '%d' on location (%d, %d) without that entity", p_entityHandle.getValue(), x, y);
 			}
-			
-			if(m_registeredEntityHandles[cellIndex].empty())
-			{
-				m_hasEntities[cellIndex] = false;
-			}
 		}
 	}
 	
@@ -217,9 +191,7 @@ void TileRegistrationMgr::moveRegisterEntityHandle(const tt::math::PointRect&
 			{
 				continue; // Inside prev rect, ignore.
 			}
-			const s32 cellIndex = getCellIndex(x, y);
-			m_registeredEntityHandles[cellIndex].insert(p_entityHandle);
-			m_hasEntities[cellIndex] = true;
+			addEntityToCell(getCellIndex(x, y), p_entityHandle);
 		}
 	}
 }
@@ -228,32 +200,62 @@ void TileRegistrationMgr::moveRegisterEntityHandle(const tt::math::PointRect&
 bool TileRegistrationMgr::isEntityAtPosition(const tt::math::Point2&           p_position,
                                              const game::entity::EntityHandle& p_entityHandle) const
 {
-	const EntityHandleSet* entities = getEntitiesAtPosition(p_position);
-	if (entities != 0)
-	{
-		return entities->find(p_entityHandle) != entities->end();
-	}
-	
-	return false;
+	const EntityHandleRange entities(getEntitiesAtPosition(p_position));
+	return std::binary_search(entities.begin(), entities.end(), p_entityHandle);
 }
 
 
 void TileRegistrationMgr::findRegisteredEntityHandles(const tt::math::Point2&        p_position,
                                                       game::entity::EntityHandleSet& p_result) const
 {
-	if(hasEntityAtPosition(p_position.x, p_position.y))
+	const EntityHandleRange entities(getEntitiesAtPosition(p_position));
+	p_result.insert(entities.begin(), entities.end());
+}
+
+
+void TileRegistrationMgr::findRegisteredEntityHandles(const tt::math::PointRect&     p_tiles,
+                                                      game::entity::EntityHandleSet& p_result) const
+{
+	const tt::math::Point2 minPos = tt::math::pointMax(p_tiles.getMin(), tt::math::Point2::zero);
+	const tt::math::Point2 maxPos = tt::math::pointMin(p_tiles.getMaxEdge(), m_levelBounds);
+	
+	const s32 minx = (minPos.x / cellSize) * cellSize;
+	const s32 miny = (minPos.y / cellSize) * cellSize;
+	const s32 maxx = static_cast<s32>(tt::math::ceil(maxPos.x / static_cast<real>(cellSize))) * cellSize;
+	const s32 maxy = static_cast<s32>(tt::math::ceil(maxPos.y / static_cast<real>(cellSize))) * cellSize;
+	
+	for (s32 x = minx; x < maxx; x += cellSize)
 	{
-		const EntityHandleSet* entities = getEntitiesAtPosition(p_position);
-		if (entities != 0)
+		for (s32 y = miny; y < maxy; y += cellSize)
 		{
-			return p_result.insert(entities->begin(), entities->end()); 
+			const EntityHandleRange entities(getCellEntities(getCellIndex(x, y)));
+			p_result.insert(entities.begin(), entities.end());
 		}
 	}
 }
 
 
-void TileRegistrationMgr::findRegisteredEntityHandles(const tt::math::PointRect&     p_tiles,
-                                                      game::entity::EntityHandleSet& p_result) const
+void TileRegistrationMgr::findRegisteredEntityHandles(const tt::math::Point2&      p_position,
+                                                      game::entity::EntityHandles& p_result) const
+{
+	const EntityHandleRange entities(getEntitiesAtPosition(p_position));
+	if (entities.empty())
+	{
+		return;
+	}
+	
+	const bool needsMerge = p_result.empty() == false;
+	p_result.insert(p_result.end(), entities.begin(), entities.end());
+	if (needsMerge)
+	{
+		std::sort(p_result.begin(), p_result.end());
+		p_result.erase(std::unique(p_result.begin(), p_result.end()), p_result.end());
+	}
+}
+
+
+void TileRegistrationMgr::findRegisteredEntityHandles(const tt::math::PointRect&   p_tiles,
+                                                      game::entity::EntityHandles& p_result) const
 {
 	const tt::math::Point2 minPos = tt::math::pointMax(p_tiles.getMin(), tt::math::Point2::zero);
 	const tt::math::Point2 maxPos = tt::math::pointMin(p_tiles.getMaxEdge(), m_levelBounds);
@@ -263,28 +265,33 @@ void TileRegistrationMgr::findRegisteredEntityHandles(const tt::math::PointRect&
 	const s32 maxx = static_cast<s32>(tt::math::ceil(maxPos.x / static_cast<real>(cellSize))) * cellSize;
 	const s32 maxy = static_cast<s32>(tt::math::ceil(maxPos.y / static_cast<real>(cellSize))) * cellSize;
 	
+	// Every cell is sorted, so only merge when handles from more than one source were added.
+	s32 sourceCount = p_result.empty() ? 0 : 1;
 	for (s32 x = minx; x < maxx; x += cellSize)
 	{
 		for (s32 y = miny; y < maxy; y += cellSize)
 		{
-			if (hasEntityAtPosition(x,y))
+			const EntityHandleRange entities(getCellEntities(getCellIndex(x, y)));
+			if (entities.empty() == false)
 			{
-				const EntityHandleSet& setAtPosition = m_registeredEntityHandles[getCellIndex(x, y)];
-				p_result.insert(setAtPosition.begin(), setAtPosition.end());
+				p_result.insert(p_result.end(), entities.begin(), entities.end());
+				++sourceCount;
 			}
 		}
 	}
+	
+	if (sourceCount > 1)
+	{
+		std::sort(p_result.begin(), p_result.end());
+		p_result.erase(std::unique(p_result.begin(), p_result.end()), p_result.end());
+	}
 }
 
 
-const game::entity::EntityHandleSet& TileRegistrationMgr::getRegisteredEntityHandles(const tt::math::Point2& p_position) const
+TileRegistrationMgr::EntityHandleRange TileRegistrationMgr::getRegisteredEntityHandles(
+		const tt::math::Point2& p_position) const
 {
-	const s32 cellIndex = getCellIndex(p_position.x, p_position.y);
-	
-	TT_ASSERT(cellIndex >= 0);
-	TT_ASSERT(cellIndex < m_cellCount);
-	
-	return m_registeredEntityHandles[cellIndex];
+	return getCellEntities(getCellIndex(p_position.x, p_position.y));
 }
 
 
@@ -637,7 +644,7 @@ bool TileRegistrationMgr::isLightBlocking(const tt::math::Point2& p_tilePos) con
 	if (m_levelLayer->contains(p_tilePos))
 	{
 		TT_ASSERT(tileIndex >=0 && tileIndex < m_tilesCount);
-		return toki::level::isLightBlocking(m_collisionTypes[tileIndex]);
+		return m_lightBlockingTiles.isSet(p_tilePos);
 	}
 	return true;
 }
@@ -714,20 +721,32 @@ void TileRegistrationMgr::handleLevelResized()
 #if defined(USE_STD_VECTOR)
 	m_registeredEntityTiles  .resize(m_tilesCount);
 	m_collisionTypes         .resize(m_tilesCount);
-	m_registeredEntityHandles.resize(m_cellCount);
-	m_hasEntities            .resize(m_cellCount);
 #else
-	delete[] m_registeredEntityHandles;
 	delete[] m_registeredEntityTiles;
 	delete[] m_collisionTypes;
-	delete[] m_hasEntities;
 	
 	m_registeredEntityTiles   = new game::entity::EntityTilesWeakPtrs[m_tilesCount];
 	m_collisionTypes          = new CollisionType[m_tilesCount];
-	m_registeredEntityHandles = new EntityHandleSet[m_cellCount];
-	m_hasEntities             = new bool[m_cellCount];
 #endif
+	// The cell grid changed, so the cells the entities were registered in don't match anymore.
+	m_entityCells.assign(m_cellCount, EntityCell());
+	m_overflowHandles.clear();
+	m_freeOverflowIndices.clear();
+	m_lightBlockingTiles.resize(m_levelBounds.x, m_levelBounds.y);
 	getCollisionTypesFromLevel();
+	
+	if (AppGlobal::hasGameAndEntityMgr())
+	{
+		game::entity::EntityMgr& entityMgr = AppGlobal::getGame()->getEntityMgr();
+		game::entity::Entity* entity = entityMgr.getFirstEntity();
+		for (s32 i = 0; i < entityMgr.getActiveEntitiesCount(); ++i, ++entity)
+		{
+			if (entity->isInitialized())
+			{
+				registerEntityHandle(entity->getRegisteredTileRect(), entity->getHandle());
+			}
+		}
+	}
 }
 
 
@@ -749,8 +768,7 @@ void TileRegistrationMgr::update(real /*p_elapsedTime*/)
 	
 	if (m_changedTiles.empty() == false)
 	{
-		// FIXME: Get rid of stl sets and replace with a set that uses a fixed pool allocator or something similar
-		static EntityHandleSet affectedEntities;
+		static game::entity::EntityHandles affectedEntities;
 		static TilePositions copy;
 		std::swap(copy, m_changedTiles);
 		
@@ -761,15 +779,20 @@ void TileRegistrationMgr::update(real /*p_elapsedTime*/)
 			copy.resize(std::distance(copy.begin(), it));
 		}
 		
+		// Gather all handles first and sort them once; gives the same (handle) order as a set.
 		for (TilePositions::const_iterator it = copy.begin(); it != copy.end(); ++it)
 		{
-			findRegisteredEntityHandles((*it), affectedEntities);
+			const EntityHandleRange entities(getEntitiesAtPosition(*it));
+			affectedEntities.insert(affectedEntities.end(), entities.begin(), entities.end());
 		}
 		copy.clear();
+		std::sort(affectedEntities.begin(), affectedEntities.end());
+		affectedEntities.erase(std::unique(affectedEntities.begin(), affectedEntities.end()),
+		                       affectedEntities.end());
 		
 		using namespace game::entity;
 		EntityMgr& mgr = AppGlobal::getGame()->getEntityMgr();
-		for (EntityHandleSet::const_iterator it = affectedEntities.begin(); it != affectedEntities.end(); ++it)
+		for (EntityHandles::const_iterator it = affectedEntities.begin(); it != affectedEntities.end(); ++it)
 		{
 			Entity* entity = mgr.getEntity(*it);
 			TT_NULL_ASSERT(entity);	// should not happen
@@ -807,7 +830,7 @@ void TileRegistrationMgr::render()
 				entityRect.alignLeft    (x + 0.10f);
 				entityTileRect.alignLeft(x + 0.15f);
 				
-				if (m_registeredEntityHandles[x + y * m_levelBounds.x].empty() == false)
+				if (hasEntityAtPosition(x, y))
 				{
 					debug->renderRect(colorEntityHandles, entityRect);
 				}
@@ -870,20 +893,117 @@ void TileRegistrationMgr::addChangedTiles(const tt::math::PointRect& p_tileRect)
 }
 
 
-const TileRegistrationMgr::EntityHandleSet* TileRegistrationMgr::getEntitiesAtPosition(
-		const tt::math::Point2& p_position) const
+void TileRegistrationMgr::addEntityToCell(s32 p_cellIndex, const game::entity::EntityHandle& p_entityHandle)
 {
-#if !defined(USE_STD_VECTOR)
-	TT_NULL_ASSERT(m_registeredEntityHandles);
-#endif
+	TT_ASSERT(p_cellIndex >= 0 && p_cellIndex < m_cellCount);
+	EntityCell& cell(m_entityCells[p_cellIndex]);
+	
+	if (cell.overflowIndex >= 0)
+	{
+		game::entity::EntityHandles& handles(m_overflowHandles[cell.overflowIndex]);
+		game::entity::EntityHandles::iterator it = std::lower_bound(handles.begin(), handles.end(), p_entityHandle);
+		if (it == handles.end() || *it != p_entityHandle)
+		{
+			handles.insert(it, p_entityHandle);
+			++cell.count;
+		}
+		return;
+	}
+	
+	game::entity::EntityHandle* end = cell.handles + cell.count;
+	game::entity::EntityHandle* it  = std::lower_bound(cell.handles, end, p_entityHandle);
+	if (it != end && *it == p_entityHandle)
+	{
+		return; // Already registered
+	}
+	
+	if (cell.count < EntityCell::InlineCapacity)
+	{
+		std::copy_backward(it, end, end + 1);
+		*it = p_entityHandle;
+		++cell.count;
+		return;
+	}
+	
+	// Cell is full; move its handles to an overflow list
+	if (m_freeOverflowIndices.empty())
+	{
+		m_overflowHandles.push_back(game::entity::EntityHandles());
+		m_freeOverflowIndices.push_back(static_cast<s32>(m_overflowHandles.size()) - 1);
+	}
+	cell.overflowIndex = m_freeOverflowIndices.back();
+	m_freeOverflowIndices.pop_back();
+	
+	game::entity::EntityHandles& handles(m_overflowHandles[cell.overflowIndex]);
+	TT_ASSERT(handles.empty());
+	handles.reserve(EntityCell::InlineCapacity * 2);
+	handles.insert(handles.end(), cell.handles, it);
+	handles.push_back(p_entityHandle);
+	handles.insert(handles.end(), it, end);
+	++cell.count;
+}
+
+
+bool TileRegistrationMgr::removeEntityFromCell(s32 p_cellIndex, const game::entity::EntityHandle& p_entityHandle)
+{
+	TT_ASSERT(p_cellIndex >= 0 && p_cellIndex < m_cellCount);
+	EntityCell& cell(m_entityCells[p_cellIndex]);
 	
+	if (cell.overflowIndex >= 0)
+	{
+		game::entity::EntityHandles& handles(m_overflowHandles[cell.overflowIndex]);
+		game::entity::EntityHandles::iterator it = std::lower_bound(handles.begin(), handles.end(), p_entityHandle);
+		if (it == handles.end() || *it != p_entityHandle)
+		{
+			return false;
+		}
+		handles.erase(it);
+		--cell.count;
+		
+		if (cell.count <= EntityCell::InlineCapacity)
+		{
+			// Fits inline again; release the overflow list
+			std::copy(handles.begin(), handles.end(), cell.handles);
+			handles.clear();
+			m_freeOverflowIndices.push_back(cell.overflowIndex);
+			cell.overflowIndex = -1;
+		}
+		return true;
+	}
+	
+	game::entity::EntityHandle* end = cell.handles + cell.count;
+	game::entity::EntityHandle* it  = std::lower_bound(cell.handles, end, p_entityHandle);
+	if (it == end || *it != p_entityHandle)
+	{
+		return false;
+	}
+	std::copy(it + 1, end, it);
+	--cell.count;
+	return true;
+}
+
+
+TileRegistrationMgr::EntityHandleRange TileRegistrationMgr::getCellEntities(s32 p_cellIndex) const
+{
+	TT_ASSERT(p_cellIndex >= 0 && p_cellIndex < m_cellCount);
+	const EntityCell& cell(m_entityCells[p_cellIndex]);
+	if (cell.overflowIndex >= 0)
+	{
+		const game::entity::EntityHandles& handles(m_overflowHandles[cell.overflowIndex]);
+		return EntityHandleRange(&handles[0], &handles[0] + handles.size());
+	}
+	return EntityHandleRange(cell.handles, cell.handles + cell.count);
+}
+
+
+TileRegistrationMgr::EntityHandleRange TileRegistrationMgr::getEntitiesAtPosition(
+		const tt::math::Point2& p_position) const
+{
 	if (m_levelLayer->contains(p_position))
 	{
-		const s32 cellIndex = getCellIndex(p_position.x, p_position.y);
-		TT_ASSERT(cellIndex >= 0 && cellIndex < m_cellCount);
-		return &m_registeredEntityHandles[cellIndex];
+		return getCellEntities(getCellIndex(p_position.x, p_position.y));
 	}
-	return 0;
+	return EntityHandleRange(0, 0);
 }
 
 
@@ -914,7 +1034,9 @@ void TileRegistrationMgr::getCollisionTypesFromLevel()
 	{
 		for (pos.x = 0; pos.x < m_levelBounds.x; ++pos.x)
 		{
-			m_collisionTypes[pos.x + pos.y * m_levelBounds.x] = m_levelLayer->getCollisionType(pos);
+			const CollisionType type = m_levelLayer->getCollisionType(pos);
+			m_collisionTypes[pos.x + pos.y * m_levelBounds.x] = type;
+			m_lightBlockingTiles.set(pos, toki::level::isLightBlocking(type));
 		}
 	}
 }
@@ -929,6 +1051,7 @@ bool TileRegistrationMgr::updateCollisionType(const tt::math::Point2& p_position
 	const bool wasSolid = toki::level::isSolid(m_collisionTypes[tileIndex]);
 	
 	m_collisionTypes[tileIndex] = getCollisionTypeFromRegisteredTiles(p_position, m_levelLayer);
+	m_lightBlockingTiles.set(p_position, toki::level::isLightBlocking(m_collisionTypes[tileIndex]));
 
 	return wasSolid != toki::level::isSolid(m_collisionTypes[tileIndex]);
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <tt/code/helpers.h>
 
 #include <toki/level/skin/EdgeCache.h>
@@ -99,6 +101,45 @@ void EdgeCache::update(const MaterialCache& p_tiles)
 }
 
 
+void EdgeCache::update(const MaterialCache& p_tiles, const tt::math::PointRect& p_changedTiles)
+{
+	TT_ASSERT(m_verticalSize.x   == p_tiles.getSize().x);
+	TT_ASSERT(m_horizontalSize.y == p_tiles.getSize().y);
+	
+	// An edge only depends on the two tiles next to it.
+	{
+		const s32 minX = std::max(p_changedTiles.getLeft() - 1, 0);
+		const s32 maxX = std::min(p_changedTiles.getRight(),     m_horizontalSize.x - 1);
+		const s32 minY = std::max(p_changedTiles.getTop(),       0);
+		const s32 maxY = std::min(p_changedTiles.getBottom(),    m_horizontalSize.y - 1);
+		for (tt::math::Point2 pos(minX, minY); pos.y <= maxY; ++pos.y)
+		{
+			for (pos.x = minX; pos.x <= maxX; ++pos.x)
+			{
+				m_horizontalEdges[pos.x + (pos.y * m_horizontalSize.x)] =
+					getEdgeForTiles(p_tiles.getTileMaterial(pos),
+					                p_tiles.getTileMaterial(tt::math::Point2(pos.x + 1, pos.y)));
+			}
+		}
+	}
+	{
+		const s32 minX = std::max(p_changedTiles.getLeft(),       0);
+		const s32 maxX = std::min(p_changedTiles.getRight(),      m_verticalSize.x - 1);
+		const s32 minY = std::max(p_changedTiles.getTop() - 1,    0);
+		const s32 maxY = std::min(p_changedTiles.getBottom(),     m_verticalSize.y - 1);
+		for (tt::math::Point2 pos(minX, minY); pos.y <= maxY; ++pos.y)
+		{
+			for (pos.x = minX; pos.x <= maxX; ++pos.x)
+			{
+				m_verticalEdges[pos.x + (pos.y * m_verticalSize.x)] =
+					getEdgeForTiles(p_tiles.getTileMaterial(pos),
+					                p_tiles.getTileMaterial(tt::math::Point2(pos.x, pos.y + 1)));
+			}
+		}
+	}
+}
+
+
 void EdgeCache::handleLevelResized(s32 p_newLevelWidth, s32 p_newLevelHeight)
 {
 	// FIXME: Check if level size actually changed from what we have now
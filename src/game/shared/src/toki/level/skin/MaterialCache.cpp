@@ -27,17 +27,29 @@ MaterialCache::~MaterialCache()
 
 
 void MaterialCache::update(const AttributeLayerPtr& p_layer, ThemeType p_defaultLevelTheme)
+{
+	update(p_layer, p_defaultLevelTheme, getRect());
+}
+
+
+void MaterialCache::update(const AttributeLayerPtr&   p_layer,
+                           ThemeType                  p_defaultLevelTheme,
+                           const tt::math::PointRect& p_rect)
 {
 	TT_NULL_ASSERT(p_layer);
 	TT_ASSERT(m_levelSize.x == p_layer->getWidth() );
 	TT_ASSERT(m_levelSize.y == p_layer->getHeight());
+	TT_ASSERT(p_rect.getLeft() >= 0 && p_rect.getRight()  < m_levelSize.x);
+	TT_ASSERT(p_rect.getTop()  >= 0 && p_rect.getBottom() < m_levelSize.y);
 	
-	const u8* layerDataPtr        = p_layer->getRawData();
-	TileMaterial* materialTilePtr = m_materialTiles;
-	
-	for (tt::math::Point2 pos(0, 0); pos.y < m_levelSize.y; ++pos.y)
+	for (tt::math::Point2 pos(p_rect.getLeft(), p_rect.getTop()); pos.y <= p_rect.getBottom(); ++pos.y)
 	{
-		for (pos.x = 0; pos.x < m_levelSize.x; ++pos.x, ++layerDataPtr, ++materialTilePtr)
+		pos.x = p_rect.getLeft();
+		const s32 rowStart            = pos.x + (pos.y * m_levelSize.x);
+		const u8* layerDataPtr        = p_layer->getRawData() + rowStart;
+		TileMaterial* materialTilePtr = m_materialTiles       + rowStart;
+		
+		for (; pos.x <= p_rect.getRight(); ++pos.x, ++layerDataPtr, ++materialTilePtr)
 		{
 			const u8 value = *layerDataPtr;
 			
@@ -57,6 +69,51 @@ void MaterialCache::update(const AttributeLayerPtr& p_layer, ThemeType p_default
 }
 
 
+void MaterialCache::applyOverriddenThemeTiles(const AttributeLayerPtr&   p_layer,
+                                              ThemeType                  p_defaultLevelTheme,
+                                              const ThemeTiles&          p_overriddenThemeTiles,
+                                              const tt::math::PointRect& p_rect)
+{
+	TT_NULL_ASSERT(p_layer);
+	
+	const ThemeType levelTheme = p_defaultLevelTheme;
+	
+	for (ThemeTiles::const_iterator it = p_overriddenThemeTiles.begin();
+	     it != p_overriddenThemeTiles.end(); ++it)
+	{
+		const tt::math::Point2& pos((*it).first);
+		if (p_layer->contains(pos) == false)
+		{
+			// An empty tile has no theme.
+			p_defaultLevelTheme = ThemeType_DoNotTheme;
+			continue;
+		}
+		
+		// The theme of the tile without its override. (The cache might hold the override already.)
+		TileMaterial original;
+		original.set(p_layer->getCollisionType(pos), p_layer->getThemeType(pos), levelTheme);
+		
+		// FIXME: Perhaps move this to a separate method
+		switch (original.getMaterialTheme())
+		{
+		case MaterialTheme_Rocks:     p_defaultLevelTheme = ThemeType_Rocks;      break;
+		case MaterialTheme_Sand :     p_defaultLevelTheme = ThemeType_Sand;       break;
+		case MaterialTheme_Beach:     p_defaultLevelTheme = ThemeType_Beach;      break;
+		case MaterialTheme_DarkRocks: p_defaultLevelTheme = ThemeType_DarkRocks;  break;
+		case MaterialTheme_None :     p_defaultLevelTheme = ThemeType_DoNotTheme; break;
+		default:
+			break;
+		}
+		
+		if (pos.x >= p_rect.getLeft() && pos.x <= p_rect.getRight() &&
+		    pos.y >= p_rect.getTop()  && pos.y <= p_rect.getBottom())
+		{
+			getTileMaterial(pos).set(CollisionType_Solid, (*it).second, p_defaultLevelTheme);
+		}
+	}
+}
+
+
 void MaterialCache::handleLevelResized(s32 p_newLevelWidth, s32 p_newLevelHeight)
 {
 	if (p_newLevelWidth == m_levelSize.x && p_newLevelHeight == m_levelSize.y)
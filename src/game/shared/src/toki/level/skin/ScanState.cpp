@@ -0,0 +1,119 @@
+#include <toki/level/skin/functions.h>
+#include <toki/level/skin/ScanState.h>
+
+
+namespace toki {
+namespace level {
+namespace skin {
+namespace impl {
+
+
+void OutsideLevel::grow(const tt::math::Point2& p_pos, const TileMaterial& p_material,
+                        const SkinConfig& p_config, tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT)
+{
+	if (material.isSolid()) // Was already growing
+	{
+		if (material == p_material)
+		{
+			// No change, continue.
+			return;
+		}
+		
+		// We detected the change a tile later. So start by moving back 1 tile.
+		// In the case of a non-solid material we moved outside of the solid tiles,
+		// we want to ignore the edges of solid tiles so move an extra tile in that case.
+		s32 endPoint = (p_material.isSolid() == false) ? -2 : -1;
+		
+		switch (side)
+		{
+		case Side_Up:   // Fall-through, no break.
+		case Side_Down:  endPoint += p_pos.x;   break;
+		case Side_Left: // Fall-through, no break.
+		case Side_Right: endPoint += p_pos.y;   break;
+		default: TT_PANIC("Unknown side: %d", side); break;
+		}
+		
+		if (startPoint <= endPoint)
+		{
+			tt::math::Point2 min(0, 0);
+			tt::math::Point2 max(0, 0);
+			
+			switch (side)
+			{
+			case Side_Up:
+				min.setValues(startPoint, p_pos.y + 1);
+				max.setValues(endPoint,   p_pos.y + Constants_LevelExtensionSize);
+				break;
+			case Side_Down:
+				min.setValues(startPoint, p_pos.y - Constants_LevelExtensionSize);
+				max.setValues(endPoint,   p_pos.y - 1);
+				break;
+			case Side_Left:
+				min.setValues(p_pos.x - Constants_LevelExtensionSize, startPoint);
+				max.setValues(p_pos.x - 1,                            endPoint);
+				break;
+			case Side_Right:
+				min.setValues(p_pos.x + 1,                            startPoint);
+				max.setValues(p_pos.x + Constants_LevelExtensionSize, endPoint);
+				break;
+			default:
+				TT_PANIC("Unknown side: %d", side);
+				break;
+			}
+			addShoeboxPlaneQuad(min, max, material, p_config, p_shoebox_OUT);
+		}
+		
+		startPoint = endPoint + 1;
+		// End solid material or continue with new material.
+		material = p_material;
+	}
+	else if (p_material.isSolid())
+	{
+		// Start 1 tile later because we ignore tiles with an edge.
+		switch (side)
+		{
+		case Side_Up:   // Fall-through, no break.
+		case Side_Down:  startPoint = p_pos.x + 1;   break;
+		case Side_Left: // Fall-through, no break.
+		case Side_Right: startPoint = p_pos.y + 1;   break;
+		default: TT_PANIC("Unknown side: %d", side); break;
+		}
+		material = p_material;
+	}
+}
+
+
+void ScanState::reset(s32 p_levelWidth)
+{
+	verticalEdges.assign(p_levelWidth, GrowEdge());
+	blobData.reset(p_levelWidth);
+	left  = OutsideLevel(OutsideLevel::Side_Left);
+	right = OutsideLevel(OutsideLevel::Side_Right);
+}
+
+
+bool ScanState::hasSameState(const ScanState& p_other) const
+{
+	if (verticalEdges.size() != p_other.verticalEdges.size() ||
+	    left .hasSameState(p_other.left ) == false ||
+	    right.hasSameState(p_other.right) == false ||
+	    blobData.hasSameState(p_other.blobData) == false)
+	{
+		return false;
+	}
+	
+	for (GrowEdges::size_type i = 0; i < verticalEdges.size(); ++i)
+	{
+		if (verticalEdges[i].hasSameState(p_other.verticalEdges[i]) == false)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Namespace end
+}
+}
+}
+}
@@ -25,10 +25,7 @@ static const SkinConfig::PlaneSet g_emptyPlaneSet;
 // Public member functions
 
 SkinConfig::SkinConfig()
-:
-m_skinRandom()
 {
-	resetRandomSeed();
 }
 
 
@@ -197,12 +194,6 @@ void SkinConfig::clear()
 }
 
 
-void SkinConfig::resetRandomSeed()
-{
-	m_skinRandom.setSeed(1337u);
-}
-
-
 void SkinConfig::setPlaneColorsFromLevelData(const LevelDataPtr& p_levelData, SkinConfigType p_type)
 {
 	TT_NULL_ASSERT(p_levelData);
@@ -266,18 +257,20 @@ tt::engine::renderer::TextureContainer SkinConfig::getAllUsedTextures() const
 }
 
 
-const SkinConfig::PlaneSet& SkinConfig::getPlanes(const TileMaterial& p_material, Shape p_shape) const
+const SkinConfig::PlaneSet& SkinConfig::getPlanes(const TileMaterial& p_material, Shape p_shape,
+                                                const tt::math::Point2& p_tile) const
 {
 	const MaterialType  type  = p_material.getMaterialType();
 	const MaterialTheme theme = p_material.getMaterialTheme();
 	TT_ASSERT(isValidMaterialType (type));
 	TT_ASSERT(isValidMaterialTheme(theme));
 	TT_ASSERT(isValidShape(p_shape));
-	return getRandomPlaneSet(m_materialConfig[type][theme].shapes[p_shape].planeSets);
+	return getRandomPlaneSet(m_materialConfig[type][theme].shapes[p_shape].planeSets, p_tile);
 }
 
 
-const SkinConfig::PlaneSet& SkinConfig::getEdgePlanes(const TileMaterial& p_material, Shape p_shape) const
+const SkinConfig::PlaneSet& SkinConfig::getEdgePlanes(const TileMaterial& p_material, Shape p_shape,
+                                                    const tt::math::Point2& p_tile) const
 {
 	const MaterialType  type  = p_material.getMaterialType();
 	const MaterialTheme theme = p_material.getMaterialTheme();
@@ -285,17 +278,18 @@ const SkinConfig::PlaneSet& SkinConfig::getEdgePlanes(const TileMaterial& p_mate
 	TT_ASSERT(isValidMaterialTheme(theme));
 	TT_ASSERT(isValidShape(p_shape));
 	TT_ASSERT(isEdgeShape(p_shape));
-	return getRandomPlaneSet(m_materialConfig[type][theme].edges[p_shape].planeSets);
+	return getRandomPlaneSet(m_materialConfig[type][theme].edges[p_shape].planeSets, p_tile);
 }
 
 
-const SkinConfig::PlaneSet& SkinConfig::getCenterPlanes(const TileMaterial& p_material) const
+const SkinConfig::PlaneSet& SkinConfig::getCenterPlanes(const TileMaterial& p_material,
+                                                      const tt::math::Point2& p_tile) const
 {
 	const MaterialType  type  = p_material.getMaterialType();
 	const MaterialTheme theme = p_material.getMaterialTheme();
 	TT_ASSERT(isValidMaterialType (type));
 	TT_ASSERT(isValidMaterialTheme(theme));
-	return getRandomPlaneSet(m_materialConfig[type][theme].centerPlanes);
+	return getRandomPlaneSet(m_materialConfig[type][theme].centerPlanes, p_tile);
 }
 
 
@@ -447,7 +441,8 @@ bool SkinConfig::parseTexCoordMode(const tt::xml::XmlNode* p_node,
 }
 
 
-const SkinConfig::PlaneSet& SkinConfig::getRandomPlaneSet(const PlaneSets& p_planeSets) const
+const SkinConfig::PlaneSet& SkinConfig::getRandomPlaneSet(const PlaneSets&       p_planeSets,
+                                                          const tt::math::Point2& p_tile)
 {
 	const PlaneSets::size_type setsSize = p_planeSets.size();
 	if (setsSize == 0)
@@ -456,12 +451,19 @@ const SkinConfig::PlaneSet& SkinConfig::getRandomPlaneSet(const PlaneSets& p_pla
 	}
 	else if (setsSize == 1)
 	{
-		// Avoid the random number generator overhead if there is just one entry to return
+		// Avoid the hashing if there is just one entry to return
 		return p_planeSets.front();
 	}
 	
-	const PlaneSets::size_type setIndex = static_cast<PlaneSets::size_type>(
-			m_skinRandom.getNext(static_cast<u32>(setsSize)));
+	// Hash the tile position instead of drawing from a random sequence: the variant of a tile must not
+	// depend on how many planes were picked before it, otherwise a partial regeneration of the skin
+	// would change the variants of all the tiles after it.
+	u32 hash = (static_cast<u32>(p_tile.x) * 73856093u) ^ (static_cast<u32>(p_tile.y) * 19349663u);
+	hash ^= hash >> 13;
+	hash *= 0x5bd1e995u;
+	hash ^= hash >> 15;
+	
+	const PlaneSets::size_type setIndex = static_cast<PlaneSets::size_type>(hash % static_cast<u32>(setsSize));
 	return p_planeSets[setIndex];
 }
 
@@ -1,7 +1,5 @@
-#include <tt/code/helpers.h>
 #include <tt/platform/tt_error.h>
 
-#include <toki/level/skin/GrowEdge.h>
 #include <toki/level/skin/SkinContext.h>
 
 
@@ -27,7 +25,6 @@ SkinContextPtr SkinContext::create(s32 p_levelWidth, s32 p_levelHeight)
 
 SkinContext::~SkinContext()
 {
-	tt::code::helpers::safeDeleteArray(scratchGrowEdge);
 }
 
 
@@ -39,18 +36,19 @@ void SkinContext::handleLevelResized(s32 p_newLevelWidth, s32 p_newLevelHeight)
 	tileMaterial.handleLevelResized(p_newLevelWidth, p_newLevelHeight);
 	edgeCache   .handleLevelResized(p_newLevelWidth, p_newLevelHeight);
 	
-	// Did the width change?
-	if (p_newLevelWidth != scratchGrowEdgeSize)
-	{
-		// Grow edge scratch
-		tt::code::helpers::safeDeleteArray(scratchGrowEdge);
-		
-		scratchGrowEdgeSize   = p_newLevelWidth;
-		scratchGrowEdge       = new impl::GrowEdge  [scratchGrowEdgeSize];
-		
-		// Blob
-		blobData.reset(p_newLevelWidth);
-	}
+	scanState.reset(p_newLevelWidth);
+	clearRecordedGeneration();
+}
+
+
+void SkinContext::clearRecordedGeneration()
+{
+	rowStates    .clear();
+	segmentStarts.clear();
+	generatedLayer.reset();
+	overriddenThemeTiles.clear();
+	themeColors  .clear();
+	levelTheme = ThemeType_Invalid;
 }
 
 
@@ -61,11 +59,15 @@ SkinContext::SkinContext(s32 p_levelWidth, s32 p_levelHeight)
 :
 tileMaterial         (p_levelWidth, p_levelHeight),
 edgeCache            (tt::math::Point2(p_levelWidth, p_levelHeight)),
-scratchGrowEdge      (new impl::GrowEdge[p_levelWidth]),
-scratchGrowEdgeSize  (p_levelWidth),
-blobData()
+scanState            (),
+rowStates            (),
+segmentStarts        (),
+generatedLayer       (),
+overriddenThemeTiles (),
+levelTheme           (ThemeType_Invalid),
+themeColors          ()
 {
-	blobData.reset(p_levelWidth);
+	scanState.reset(p_levelWidth);
 }
 
 // Namespace end
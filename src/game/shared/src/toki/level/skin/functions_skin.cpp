@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <tt/engine/scene2d/shoebox/shoebox.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/system/Time.h>
@@ -5,6 +7,7 @@
 #include <toki/level/skin/BlobData.h>
 #include <toki/level/skin/functions.h>
 #include <toki/level/skin/GrowEdge.h>
+#include <toki/level/skin/ScanState.h>
 #include <toki/level/skin/SkinConfig.h>
 #include <toki/level/skin/SkinContext.h>
 #include <toki/level/AttributeLayer.h>
@@ -52,6 +55,41 @@ static void registerQuadToDebugView(const tt::math::Vector2& p_min,
 #endif
 
 
+static void getThemeColors(const LevelDataPtr& p_level, SkinContext::Colors* p_colors_OUT)
+{
+	p_colors_OUT->clear();
+	for (s32 i = 0; i < ThemeType_Count; ++i)
+	{
+		p_colors_OUT->push_back(p_level->getThemeColor(SkinConfigType_Solid, static_cast<ThemeType>(i)));
+	}
+}
+
+
+static void generateBand(const SkinConfig&                          p_config,
+                         const MaterialCache&                       p_tiles,
+                         const EdgeCache&                           p_edges,
+                         s32                                        p_band,
+                         impl::ScanState&                           p_state,
+                         tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT)
+{
+	const s32 endRow = std::min((p_band + 1) * Constants_SkinBandHeight, p_tiles.getSize().y);
+	for (s32 row = p_band * Constants_SkinBandHeight; row < endRow; ++row)
+	{
+		impl::generateRow(p_config, p_tiles, p_edges, row, p_state, p_shoebox_OUT);
+	}
+}
+
+
+static void replacePlanes(tt::engine::scene2d::shoebox::ShoeboxData::Planes&       p_planes,
+                          s32                                                      p_begin,
+                          s32                                                      p_end,
+                          const tt::engine::scene2d::shoebox::ShoeboxData::Planes& p_newPlanes)
+{
+	p_planes.erase( p_planes.begin() + p_begin, p_planes.begin() + p_end);
+	p_planes.insert(p_planes.begin() + p_begin, p_newPlanes.begin(), p_newPlanes.end());
+}
+
+
 void generateSkinShoebox(const SkinContextPtr&                      p_context,
                          const LevelDataPtr&                        p_level,
                          ThemeType                                  p_defaultLevelTheme,
@@ -80,43 +118,20 @@ void generateSkinShoebox(const SkinContextPtr&                      p_context,
 	
 	const SkinConfigPtr& config      (AppGlobal::getSkinConfig(SkinConfigType_Solid));
 	
-	config      ->resetRandomSeed();
 	p_context->tileMaterial.update(layer, p_defaultLevelTheme);
-	
-	// Apply overridden theme tiles
-	for (ThemeTiles::const_iterator it = p_overriddenThemeTiles.begin();
-	     it != p_overriddenThemeTiles.end(); ++it)
-	{
-		TileMaterial& material = p_context->tileMaterial.getTileMaterial((*it).first);
-		MaterialTheme originalTheme = material.getMaterialTheme();
-		
-		// FIXME: Perhaps move this to a separate method
-		switch (originalTheme)
-		{
-		case MaterialTheme_Rocks:     p_defaultLevelTheme = ThemeType_Rocks;      break;
-		case MaterialTheme_Sand :     p_defaultLevelTheme = ThemeType_Sand;       break;
-		case MaterialTheme_Beach:     p_defaultLevelTheme = ThemeType_Beach;      break;
-		case MaterialTheme_DarkRocks: p_defaultLevelTheme = ThemeType_DarkRocks;  break;
-		case MaterialTheme_None :     p_defaultLevelTheme = ThemeType_DoNotTheme; break;
-		default:
-			break;
-		}
-		
-		material.set(CollisionType_Solid, (*it).second, p_defaultLevelTheme);
-	}
+	p_context->tileMaterial.applyOverriddenThemeTiles(layer, p_defaultLevelTheme, p_overriddenThemeTiles,
+	                                                  p_context->tileMaterial.getRect());
 	
 	config      ->setPlaneColorsFromLevelData(p_level, SkinConfigType_Solid);
 	
 	p_context->edgeCache.update(p_context->tileMaterial);
 	
-	impl::generateShoebox(
-			*config,
-			p_context->tileMaterial,
-			p_context->edgeCache,
-			p_context->scratchGrowEdge,
-			p_context->scratchGrowEdgeSize,
-			p_context->blobData,
-			p_shoebox_OUT);
+	impl::generateShoebox(*config, *p_context, p_shoebox_OUT);
+	
+	p_context->generatedLayer       = layer->clone();
+	p_context->overriddenThemeTiles = p_overriddenThemeTiles;
+	p_context->levelTheme           = p_defaultLevelTheme;
+	getThemeColors(p_level, &p_context->themeColors);
 	
 #if !defined(TT_BUILD_FINAL)
 	const u64 duration = tt::system::Time::getInstance()->getMilliSeconds() - startTime;
@@ -163,140 +178,199 @@ void generateSkinShoebox(const SkinContextPtr&                      p_context,
 #endif
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////////////
-// impl namespace ("private")
-
-namespace impl
-{
-
 
-struct OutsideLevel
+void updateSkinShoebox(const SkinContextPtr&                      p_context,
+                       const LevelDataPtr&                        p_level,
+                       ThemeType                                  p_defaultLevelTheme,
+                       const ThemeTiles&                          p_overriddenThemeTiles,
+                       tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT)
 {
-public:
-	enum Side
+#if !defined(TT_BUILD_FINAL)
+	const u64 startTime = tt::system::Time::getInstance()->getMilliSeconds();
+#endif
+	
+	TT_NULL_ASSERT(p_context);
+	TT_NULL_ASSERT(p_shoebox_OUT);
+	
+	const AttributeLayerPtr& layer(p_level->getAttributeLayer());
+	
+	if (layer == 0 || layer->getWidth() <= 0 || layer->getHeight() <= 0)
 	{
-		Side_Up,
-		Side_Down,
-		Side_Left,
-		Side_Right
-	};
-	
-	inline OutsideLevel(Side p_side)
-	:
-	side(p_side),
-	startPoint(-1),
-	material()
-	{}
-	
-	inline void grow(const tt::math::Point2& p_pos, const TileMaterial& p_material, 
-	                 const SkinConfig& p_config, tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT)
+		TT_PANIC("Can't update skin shoebox! AttributeLayer null or has a dimension of 0.");
+		return;
+	}
+	
+	SkinContext::Colors themeColors;
+	getThemeColors(p_level, &themeColors);
+	
+	if (p_context->tileMaterial.getSize() != tt::math::Point2(layer->getWidth(), layer->getHeight()))
 	{
-		if (material.isSolid()) // Was already growing
-		{
-			if (material == p_material)
-			{
-				// No change, continue.
-				return;
-			}
-			
-			// We detected the change a tile later. So start by moving back 1 tile.
-			// In the case of a non-solid material we moved outside of the solid tiles,
-			// we want to ignore the edges of solid tiles so move an extra tile in that case.
-			s32 endPoint = (p_material.isSolid() == false) ? -2 : -1;
-			
-			switch (side)
-			{
-			case Side_Up:   // Fall-through, no break.
-			case Side_Down:  endPoint += p_pos.x;   break;
-			case Side_Left: // Fall-through, no break.
-			case Side_Right: endPoint += p_pos.y;   break;
-			default: TT_PANIC("Unknown side: %d", side); break;
-			}
-			
-			if (startPoint <= endPoint)
-			{
-				tt::math::Point2 min(0, 0);
-				tt::math::Point2 max(0, 0);
-				
-				switch (side)
-				{
-				case Side_Up:
-					min.setValues(startPoint, p_pos.y + 1);
-					max.setValues(endPoint,   p_pos.y + Constants_LevelExtensionSize);
-					break;
-				case Side_Down:
-					min.setValues(startPoint, p_pos.y - Constants_LevelExtensionSize);
-					max.setValues(endPoint,   p_pos.y - 1);
-					break;
-				case Side_Left:
-					min.setValues(p_pos.x - Constants_LevelExtensionSize, startPoint);
-					max.setValues(p_pos.x - 1,                            endPoint);
-					break;
-				case Side_Right:
-					min.setValues(p_pos.x + 1,                            startPoint);
-					max.setValues(p_pos.x + Constants_LevelExtensionSize, endPoint);
-					break;
-				default:
-					TT_PANIC("Unknown side: %d", side);
-					break;
-				}
-				addShoeboxPlaneQuad(min, max, material, p_config, p_shoebox_OUT);
-			}
-			
-			startPoint = endPoint + 1;
-			// End solid material or continue with new material.
-			material = p_material;
-		}
-		else if (p_material.isSolid())
+		p_context->handleLevelResized(layer->getWidth(), layer->getHeight());
+	}
+	
+	const tt::math::Point2& levelSize(p_context->tileMaterial.getSize());
+	SkinContext::PlaneIndices& segmentStarts(p_context->segmentStarts);
+	
+	if (p_context->hasRecordedGeneration() == false                                   ||
+	    segmentStarts.back()            != static_cast<s32>(p_shoebox_OUT->planes.size()) ||
+	    p_context->levelTheme           != p_defaultLevelTheme                            ||
+	    p_context->themeColors          != themeColors                                    ||
+	    p_context->overriddenThemeTiles != p_overriddenThemeTiles)
+	{
+		// Nothing of the previous generation can be reused.
+		p_shoebox_OUT->planes.clear();
+		generateSkinShoebox(p_context, p_level, p_defaultLevelTheme, p_overriddenThemeTiles, p_shoebox_OUT);
+		return;
+	}
+	
+	tt::math::PointRect changedTiles;
+	if (layer->getChangedRect(p_context->generatedLayer, &changedTiles) == false)
+	{
+		// No tiles changed.
+		return;
+	}
+	const s32 minY = changedTiles.getTop();
+	const s32 maxY = changedTiles.getBottom();
+	
+	const SkinConfigPtr& config(AppGlobal::getSkinConfig(SkinConfigType_Solid));
+	
+	MaterialCache& tiles(p_context->tileMaterial);
+	tiles.update(layer, p_defaultLevelTheme, changedTiles);
+	tiles.applyOverriddenThemeTiles(layer, p_defaultLevelTheme, p_overriddenThemeTiles, changedTiles);
+	
+	config->setPlaneColorsFromLevelData(p_level, SkinConfigType_Solid);
+	
+	p_context->edgeCache.update(tiles, changedTiles);
+	
+	// The planes of a row depend on the tiles in that row and in the rows next to it.
+	const s32 bandCount = static_cast<s32>(p_context->rowStates.size()) - 1;
+	const s32 firstBand = std::max(minY - 1, 0)               / Constants_SkinBandHeight;
+	const s32 lastBand  = std::min(maxY + 1, levelSize.y - 1) / Constants_SkinBandHeight;
+	TT_ASSERT(static_cast<s32>(segmentStarts.size()) == bandCount + 3);
+	
+	namespace sb = tt::engine::scene2d::shoebox;
+	sb::ShoeboxData border;
+	sb::ShoeboxData bands;
+	sb::ShoeboxData flush;
+	
+	// The border and the flush also depend on tiles in the first and last rows; they're cheap, so always redo them.
+	impl::ScanState& state(p_context->scanState);
+	state.reset(levelSize.x);
+	impl::generateBorder(*config, tiles, state, &border);
+	if (firstBand > 0)
+	{
+		TT_ASSERT(state.hasSameState(p_context->rowStates[0]));
+		state = p_context->rowStates[firstBand];
+	}
+	
+	// Regenerate bands until one starts with the same state as before; from there on the skin stays the same.
+	std::vector<s32> bandSizes;
+	s32 band = firstBand;
+	for (; band < bandCount; ++band)
+	{
+		if (band > lastBand && state.hasSameState(p_context->rowStates[band]))
 		{
-			// Start 1 tile later because we ignore tiles with an edge.
-			switch (side)
-			{
-			case Side_Up:   // Fall-through, no break.
-			case Side_Down:  startPoint = p_pos.x + 1;   break;
-			case Side_Left: // Fall-through, no break.
-			case Side_Right: startPoint = p_pos.y + 1;   break;
-			default: TT_PANIC("Unknown side: %d", side); break;
-			}
-			material = p_material;
+			break;
 		}
+		
+		p_context->rowStates[band] = state;
+		const s32 bandStart = static_cast<s32>(bands.planes.size());
+		generateBand(*config, tiles, p_context->edgeCache, band, state, &bands);
+		bandSizes.push_back(static_cast<s32>(bands.planes.size()) - bandStart);
+	}
+	const s32 endBand = band;
+	
+	if (endBand == bandCount)
+	{
+		p_context->rowStates[bandCount] = state;
+	}
+	else
+	{
+		state = p_context->rowStates[bandCount];
+	}
+	impl::generateFlush(*config, tiles, state, &flush);
+	
+	// Splice the new planes in, back to front so the segment starts in front stay valid.
+	SkinContext::PlaneIndices segmentSizes(segmentStarts.size() - 1, 0);
+	for (SkinContext::PlaneIndices::size_type i = 0; i < segmentSizes.size(); ++i)
+	{
+		segmentSizes[i] = segmentStarts[i + 1] - segmentStarts[i];
+	}
+	
+	replacePlanes(p_shoebox_OUT->planes, segmentStarts[bandCount + 1], segmentStarts[bandCount + 2], flush.planes);
+	replacePlanes(p_shoebox_OUT->planes, segmentStarts[firstBand + 1], segmentStarts[endBand + 1],   bands.planes);
+	replacePlanes(p_shoebox_OUT->planes, segmentStarts[0],             segmentStarts[1],             border.planes);
+	
+	segmentSizes[0]             = static_cast<s32>(border.planes.size());
+	segmentSizes[bandCount + 1] = static_cast<s32>(flush.planes.size());
+	for (s32 i = firstBand; i < endBand; ++i)
+	{
+		segmentSizes[i + 1] = bandSizes[i - firstBand];
+	}
+	for (SkinContext::PlaneIndices::size_type i = 0; i < segmentSizes.size(); ++i)
+	{
+		segmentStarts[i + 1] = segmentStarts[i] + segmentSizes[i];
 	}
+	TT_ASSERT(segmentStarts.back() == static_cast<s32>(p_shoebox_OUT->planes.size()));
+	
+	p_context->generatedLayer = layer->clone();
 	
-private:
-	Side         side;
-	s32          startPoint;
-	TileMaterial material;
-};
+#if !defined(TT_BUILD_FINAL)
+	const u64 duration = tt::system::Time::getInstance()->getMilliSeconds() - startTime;
+	TT_Printf("updateSkinShoebox duration: %u ms (regenerated %d of %d bands)\n",
+	          static_cast<u32>(duration), endBand - firstBand, bandCount);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// impl namespace ("private")
+
+namespace impl
+{
 
 
 void generateShoebox(const SkinConfig&                          p_config,
-                     const MaterialCache&                       p_tiles,
-                     const EdgeCache&                           p_edges,
-                     impl::GrowEdge*                            p_edgeScratch,
-                     s32                                        p_edgeScratchSize,
-                     BlobData&                                  p_blobData,
+                     SkinContext&                               p_context,
                      tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT)
 {
-	const tt::math::Point2& levelSize = p_tiles.getSize();
-	const TileMaterial* tilePtr       = p_tiles.getRawTiles();
+	const tt::math::Point2& levelSize = p_context.tileMaterial.getSize();
+	const s32 bandCount = (levelSize.y + Constants_SkinBandHeight - 1) / Constants_SkinBandHeight;
+	
+	ScanState& state(p_context.scanState);
+	state.reset(levelSize.x);
+	
+	p_context.rowStates.clear();
+	p_context.rowStates.reserve(bandCount + 1);
+	p_context.segmentStarts.clear();
+	p_context.segmentStarts.reserve(bandCount + 3);
 	
-	// Make sure our scratch data is cleared.
-	for (s32 i = 0; i < p_edgeScratchSize; ++i)
+	p_context.segmentStarts.push_back(static_cast<s32>(p_shoebox_OUT->planes.size()));
+	generateBorder(p_config, p_context.tileMaterial, state, p_shoebox_OUT);
+	
+	for (s32 band = 0; band < bandCount; ++band)
 	{
-		p_edgeScratch[i].invalidate();
+		p_context.segmentStarts.push_back(static_cast<s32>(p_shoebox_OUT->planes.size()));
+		p_context.rowStates.push_back(state);
+		generateBand(p_config, p_context.tileMaterial, p_context.edgeCache, band, state, p_shoebox_OUT);
 	}
+	p_context.rowStates.push_back(state);
 	
-	// FIXME: Have a different resize and reset function for BlobData. (This is reset, in the context it should use resize.)
-	p_blobData.reset(p_edgeScratchSize);
-	
-	impl::GrowEdge   horizontalEdge;
+	p_context.segmentStarts.push_back(static_cast<s32>(p_shoebox_OUT->planes.size()));
+	generateFlush(p_config, p_context.tileMaterial, state, p_shoebox_OUT);
+	p_context.segmentStarts.push_back(static_cast<s32>(p_shoebox_OUT->planes.size()));
+}
+
+
+void generateBorder(const SkinConfig&                          p_config,
+                    const MaterialCache&                       p_tiles,
+                    ScanState&                                 p_state,
+                    tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT)
+{
+	const tt::math::Point2& levelSize = p_tiles.getSize();
 	
 	const tt::math::Point2 rightStep(1, 0);
 	const tt::math::Point2 upStep(   0, 1);
 	
-	OutsideLevel left( OutsideLevel::Side_Left );
-	OutsideLevel right(OutsideLevel::Side_Right);
-	
 	// Check outside border level border
 	// TODO: Stairs need another copy of this code to be added (With solid stairs -> stairs material change.)
 	{
@@ -305,7 +379,7 @@ void generateShoebox(const SkinConfig&                          p_config,
 			const TileMaterial& material = p_tiles.getTileMaterial(pos);
 			if (material.isSolid())
 			{
-				left.grow(pos - upStep, material, p_config, p_shoebox_OUT);
+				p_state.left.grow(pos - upStep, material, p_config, p_shoebox_OUT);
 				
 				addShoeboxPlaneQuad(tt::math::Point2(-Constants_LevelExtensionSize, -Constants_LevelExtensionSize),
 				                    tt::math::Point2(-1, -1),
@@ -317,7 +391,7 @@ void generateShoebox(const SkinConfig&                          p_config,
 			const TileMaterial& material = p_tiles.getTileMaterial(pos);
 			if (material.isSolid())
 			{
-				right.grow(pos - upStep, material, p_config, p_shoebox_OUT);
+				p_state.right.grow(pos - upStep, material, p_config, p_shoebox_OUT);
 				
 				addShoeboxPlaneQuad(tt::math::Point2(levelSize.x, -Constants_LevelExtensionSize),
 				                    tt::math::Point2(levelSize.x + Constants_LevelExtensionSize, -1),
@@ -359,94 +433,124 @@ void generateShoebox(const SkinConfig&                          p_config,
 		}
 		down.grow(pos + rightStep, TileMaterial(), p_config, p_shoebox_OUT); // flush final tile.
 	}
+}
+
+
+void generateRow(const SkinConfig&                          p_config,
+                 const MaterialCache&                       p_tiles,
+                 const EdgeCache&                           p_edges,
+                 s32                                        p_row,
+                 ScanState&                                 p_state,
+                 tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT)
+{
+	const tt::math::Point2& levelSize = p_tiles.getSize();
+	TT_ASSERT(p_row >= 0 && p_row < levelSize.y);
+	TT_ASSERT(static_cast<s32>(p_state.verticalEdges.size()) == levelSize.x);
+	
+	const tt::math::Point2 rightStep(1, 0);
+	const tt::math::Point2 upStep(   0, 1);
+	
+	impl::GrowEdge horizontalEdge;
+	
+	tt::math::Point2 pos(0, p_row);
+	const TileMaterial* tilePtr = p_tiles.getRawTiles(pos);
 	
-	for (tt::math::Point2 pos(0, 0); pos.y < levelSize.y; ++pos.y)
+	p_state.left.grow(pos, *tilePtr, p_config, p_shoebox_OUT);
+	
+	for (; pos.x < levelSize.x; ++pos.x, ++tilePtr)
 	{
-		horizontalEdge.invalidate();
-		pos.x = 0;
-		
-		left.grow(pos, *tilePtr, p_config, p_shoebox_OUT);
-		
-		for (; pos.x < levelSize.x; ++pos.x, ++tilePtr)
-		{
 #if defined(TT_BUILD_DEV) // Asserts to make sure this usage for the raw data is correct.
-			TT_ASSERT(tilePtr           == &p_tiles.getTileMaterial(pos));
+		TT_ASSERT(tilePtr           == &p_tiles.getTileMaterial(pos));
 #endif
-			impl::GrowEdge& verticalEdge = p_edgeScratch[pos.x];
-			
-			if (tilePtr->isSolid())
+		impl::GrowEdge& verticalEdge = p_state.verticalEdges[pos.x];
+		
+		if (tilePtr->isSolid())
+		{
+			u8 shapeBits = TileSideBit_None;
+			if ((p_edges.getLeftEdge(pos)  & EdgeType_SolidBit) != 0)
 			{
-				u8 shapeBits = TileSideBit_None;
-				if ((p_edges.getLeftEdge(pos)  & EdgeType_SolidBit) != 0)
-				{
-					shapeBits |= TileSideBit_Left;
-					
-					const tt::math::Point2 tileToLeft(pos.x - 1, pos.y);
-					TT_ASSERT(p_tiles.getTileMaterial(tileToLeft).isSolid() == false);
-					checkForInsideCornersRight(tt::math::Point2(tileToLeft), p_tiles,
-					                           p_edges, p_config, p_shoebox_OUT);
-				}
-				if ((p_edges.getRightEdge(pos)  & EdgeType_SolidBit) != 0)
-				{
-					shapeBits |= TileSideBit_Right;
-				}
-				if ((p_edges.getBottomEdge(pos) & EdgeType_SolidBit) != 0)
-				{
-					shapeBits |= TileSideBit_Bottom;
-				}
-				if ((p_edges.getTopEdge(pos)    & EdgeType_SolidBit) != 0)
-				{
-					shapeBits |= TileSideBit_Top;
-				}
-				
-				const Shape shape = static_cast<Shape>(shapeBits);
-				
-				addShoeboxPlane(p_config, shape, pos, *tilePtr, p_shoebox_OUT);
-				
-				// Only add center edge to tile without sides. (and split on theme.)
-				doGrowBlobData(p_blobData, pos,
-						(shapeBits != 0 && (tilePtr->getMaterialTheme() != MaterialTheme_Crystal)) ?
-						0 : tilePtr->getRawValue());
-				
-				// Check the growing edges.
-				
-				// Horizontal grow edge
-				doGrowEdge(shape, *tilePtr, TileSideBit_HorizontalMask,
-				           horizontalEdge, pos, rightStep, p_config, p_shoebox_OUT);
+				shapeBits |= TileSideBit_Left;
 				
-				// Vertical grow edge
-				doGrowEdge(shape, *tilePtr, TileSideBit_VerticalMask,
-				           verticalEdge,   pos, upStep, p_config, p_shoebox_OUT);
+				const tt::math::Point2 tileToLeft(pos.x - 1, pos.y);
+				TT_ASSERT(p_tiles.getTileMaterial(tileToLeft).isSolid() == false);
+				checkForInsideCornersRight(tt::math::Point2(tileToLeft), p_tiles,
+				                           p_edges, p_config, p_shoebox_OUT);
 			}
-			// Outside collision
-			else
+			if ((p_edges.getRightEdge(pos)  & EdgeType_SolidBit) != 0)
 			{
-				// Only add quad when it's death.
-				doGrowBlobData(p_blobData, pos, 0 );
-				
-				if ((p_edges.getLeftEdge(pos) & EdgeType_SolidBit) != 0)
-				{
-					TT_ASSERT(p_tiles.getTileMaterial(pos).isSolid() == false);
-					checkForInsideCornersLeft(tt::math::Point2(pos), p_tiles,
-					                          p_edges, p_config, p_shoebox_OUT);
-				}
-				
-				horizontalEdge.stop(true, pos, rightStep, p_config, p_shoebox_OUT);
-				verticalEdge.stop(  true, pos, upStep, p_config, p_shoebox_OUT);
+				shapeBits |= TileSideBit_Right;
+			}
+			if ((p_edges.getBottomEdge(pos) & EdgeType_SolidBit) != 0)
+			{
+				shapeBits |= TileSideBit_Bottom;
+			}
+			if ((p_edges.getTopEdge(pos)    & EdgeType_SolidBit) != 0)
+			{
+				shapeBits |= TileSideBit_Top;
 			}
 			
+			const Shape shape = static_cast<Shape>(shapeBits);
+			
+			addShoeboxPlane(p_config, shape, pos, *tilePtr, p_shoebox_OUT);
+			
+			// Only add center edge to tile without sides. (and split on theme.)
+			doGrowBlobData(p_state.blobData, pos,
+					(shapeBits != 0 && (tilePtr->getMaterialTheme() != MaterialTheme_Crystal)) ?
+					0 : tilePtr->getRawValue());
+					
+			// Check the growing edges.
+			
+			// Horizontal grow edge
+			doGrowEdge(shape, *tilePtr, TileSideBit_HorizontalMask,
+			           horizontalEdge, pos, rightStep, p_config, p_shoebox_OUT);
+			
+			// Vertical grow edge
+			doGrowEdge(shape, *tilePtr, TileSideBit_VerticalMask,
+			           verticalEdge,   pos, upStep, p_config, p_shoebox_OUT);
+		}
+		// Outside collision
+		else
+		{
+			// Only add quad when it's death.
+			doGrowBlobData(p_state.blobData, pos, 0 );
+			
+			if ((p_edges.getLeftEdge(pos) & EdgeType_SolidBit) != 0)
+			{
+				TT_ASSERT(p_tiles.getTileMaterial(pos).isSolid() == false);
+				checkForInsideCornersLeft(tt::math::Point2(pos), p_tiles,
+				                          p_edges, p_config, p_shoebox_OUT);
+			}
+			
+			horizontalEdge.stop(true, pos, rightStep, p_config, p_shoebox_OUT);
+			verticalEdge.stop(  true, pos, upStep, p_config, p_shoebox_OUT);
 		}
 		
-		// Flush remaining grow edges at the (Right) edge of level.
-		horizontalEdge.stopAtLevelBorder(      pos, rightStep, p_config, p_shoebox_OUT);
-		
-		const tt::math::Point2 rightInside(pos.x - 1, pos.y);
-		right.grow(rightInside, p_tiles.getTileMaterial(rightInside), p_config, p_shoebox_OUT);
 	}
 	
+	// Flush remaining grow edges at the (Right) edge of level.
+	horizontalEdge.stopAtLevelBorder(      pos, rightStep, p_config, p_shoebox_OUT);
+	
+	const tt::math::Point2 rightInside(pos.x - 1, pos.y);
+	p_state.right.grow(rightInside, p_tiles.getTileMaterial(rightInside), p_config, p_shoebox_OUT);
+	
+	// Add center planes for the quads that can't grow anymore.
+	addShoeboxPlanesFromBlobData(p_state.blobData, p_config, p_shoebox_OUT);
+}
+
+
+void generateFlush(const SkinConfig&                          p_config,
+                   const MaterialCache&                       p_tiles,
+                   ScanState&                                 p_state,
+                   tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT)
+{
+	const tt::math::Point2& levelSize = p_tiles.getSize();
+	
+	const tt::math::Point2 rightStep(1, 0);
+	const tt::math::Point2 upStep(   0, 1);
+	
 	// Flush final tiles.
-	left.grow( tt::math::Point2(0,               levelSize.y + 1), TileMaterial(), p_config, p_shoebox_OUT);
-	right.grow(tt::math::Point2(levelSize.x - 1, levelSize.y + 1), TileMaterial(), p_config, p_shoebox_OUT);
+	p_state.left.grow( tt::math::Point2(0,               levelSize.y + 1), TileMaterial(), p_config, p_shoebox_OUT);
+	p_state.right.grow(tt::math::Point2(levelSize.x - 1, levelSize.y + 1), TileMaterial(), p_config, p_shoebox_OUT);
 	
 	{
 		OutsideLevel up(OutsideLevel::Side_Up);
@@ -467,45 +571,41 @@ void generateShoebox(const SkinConfig&                          p_config,
 	// Flush remaining grow edges at the (Top) edge of level.
 	for (s32 i = 0; i < levelSize.x; ++i)
 	{
-		p_edgeScratch[i].stopAtLevelBorder(      tt::math::Point2(i, levelSize.y), upStep,
-		                                         p_config, p_shoebox_OUT);
+		p_state.verticalEdges[i].stopAtLevelBorder(tt::math::Point2(i, levelSize.y), upStep,
+		                                           p_config, p_shoebox_OUT);
 		
-		doGrowBlobDataFlush(p_blobData,       i, levelSize.y);
+		doGrowBlobDataFlush(p_state.blobData, i, levelSize.y);
 	}
 	
 	// Check for Right Top tile.
-	p_blobData.checkForQuadMerge(      levelSize.x - 1, levelSize.x - 1, -1);
+	p_state.blobData.checkForQuadMerge(levelSize.x - 1, levelSize.x - 1, -1);
 	
 	// --------------------------------------------------------------------------------------------
 	// Add center planes based on quads.
-	addShoeboxPlanesFromBlobData(p_blobData      , p_config,       p_shoebox_OUT);
+	addShoeboxPlanesFromBlobData(p_state.blobData, p_config, p_shoebox_OUT);
 }
 
 
-void addShoeboxPlanesFromBlobData(const BlobData&                            p_blobData,
+void addShoeboxPlanesFromBlobData(BlobData&                                  p_blobData,
                                   const SkinConfig&                          p_config,
                                   tt::engine::scene2d::shoebox::ShoeboxData* p_shoebox_OUT)
 {
-	const BlobData& blobData = p_blobData;
-	for (BlobData::Blobs::const_iterator blobIt = blobData.allBlobs.begin();
-	     blobIt != blobData.allBlobs.end(); ++blobIt)
+	const SubQuads& quads = p_blobData.finishedQuads;
+	for (SubQuads::const_iterator it = quads.begin(); it != quads.end(); ++it)
 	{
 		/*
-		registerQuadToDebugView(tt::math::Vector2(blobIt->getMin().x + 0.1f,
-		                                          blobIt->getMin().y + 0.1f), 
-		                        tt::math::Vector2(blobIt->getMax().x + 0.9f,
-		                                          blobIt->getMax().y + 0.9f),
+		registerQuadToDebugView(tt::math::Vector2(it->min.x + 0.1f,
+		                                          it->min.y + 0.1f),
+		                        tt::math::Vector2(it->max.x + 0.9f,
+		                                          it->max.y + 0.9f),
 		                        tt::engine::renderer::ColorRGB::blue);
 		// */
 		
-		const SubQuads& quads = blobIt->getSubQuads();
-		for (SubQuads::const_iterator it = quads.begin(); it != quads.end(); ++it)
-		{
-			const SubQuad& subQuad = (*it);
-			const TileMaterial tileMaterial = TileMaterial::createFromRaw(subQuad.type);
-			addShoeboxPlaneQuad(subQuad.min, subQuad.max, tileMaterial, p_config, p_shoebox_OUT);
-		}
+		const SubQuad& subQuad = (*it);
+		const TileMaterial tileMaterial = TileMaterial::createFromRaw(subQuad.type);
+		addShoeboxPlaneQuad(subQuad.min, subQuad.max, tileMaterial, p_config, p_shoebox_OUT);
 	}
+	p_blobData.finishedQuads.clear();
 }
 
 
@@ -710,7 +810,7 @@ void addShoeboxPlane(const SkinConfig&                          p_config,
 	
 	static const tt::math::Vector2 halfTile(tileToWorld(tt::math::Point2::allOne) * 0.5f);
 	
-	const SkinConfig::PlaneSet& planeSet(p_config.getPlanes(p_material, p_shape));
+	const SkinConfig::PlaneSet& planeSet(p_config.getPlanes(p_material, p_shape, p_tile));
 	
 	namespace sb = tt::engine::scene2d::shoebox;
 	
@@ -832,7 +932,7 @@ void addShoeboxPlane(const SkinConfig&                          p_config,
 	}
 #endif
 	
-	const SkinConfig::PlaneSet& planeSet(p_config.getEdgePlanes(p_edge.material, p_edge.shape));
+	const SkinConfig::PlaneSet& planeSet(p_config.getEdgePlanes(p_edge.material, p_edge.shape, p_edge.startTile));
 	
 	if (horizontal)
 	{
@@ -1128,7 +1228,7 @@ void addShoeboxPlaneQuad(const tt::math::Point2& p_min, const tt::math::Point2&
 	const tt::math::Vector2 planeTargetSize(maxPos - minPos);
 	const tt::math::Vector2 planeCenterPos(minPos + (planeTargetSize * 0.5f));
 	
-	const SkinConfig::PlaneSet& planeSet(p_config.getCenterPlanes(p_material));
+	const SkinConfig::PlaneSet& planeSet(p_config.getCenterPlanes(p_material, p_min));
 	
 	for (SkinConfig::Planes::const_iterator it = planeSet.planes.begin(); it != planeSet.planes.end(); ++it)
 	{
@@ -29,7 +29,7 @@ void StateExitApp::enter()
 	TT_Printf("StateExitApp::enter: Exiting application.\n");
 	
 #if !defined(TT_BUILD_FINAL)
-	if (AppGlobal::shouldCompileSquirrel())
+	if (AppGlobal::shouldCompileSquirrel() || AppGlobal::shouldPrecompileSquirrel())
 	{
 		tt::app::getApplication()->terminate(true);
 	}
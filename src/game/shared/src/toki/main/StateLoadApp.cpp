@@ -10,8 +10,9 @@
 #include <tt/fs/fs.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/pres/PresentationMgr.h>
+#include <tt/profiler/TraceRecorder.h>
 #include <tt/system/Time.h>
-#include <tt/thread/CriticalSection.h>
+#include <tt/thread/thread.h>
 
 #include <toki/audio/AudioPlayer.h>
 #include <toki/game/types.h>
@@ -41,6 +42,91 @@
 namespace toki {
 namespace main {
 
+// The chain of tasks that leads to the first game frame goes first; precaching fills up the load threads
+enum LoadPriority
+{
+	LoadPriority_Precache,
+	LoadPriority_Normal,
+	LoadPriority_Critical
+};
+
+// Time per frame the main thread spends on uploading precached textures
+static const u32 g_mainThreadLoadBudgetMs = 4;
+
+
+struct LoadStateStep
+{
+	explicit LoadStateStep(const loadstate::LoadStatePtr& p_state) : state(p_state) { }
+	
+	inline bool operator()() const
+	{
+		state->doLoadStep();
+		return state->isDone();
+	}
+	
+	loadstate::LoadStatePtr state;
+};
+
+
+#if defined(TT_PLATFORM_SDL)
+// Uploads the precached textures to the GPU: only the render thread can do that
+struct UploadPrecachedTextures
+{
+	UploadPrecachedTextures() : textures(), started(false) { }
+	
+	inline bool operator()()
+	{
+		if (started == false)
+		{
+			textures = AppGlobal::getPrecachedTextures();
+			started  = true;
+		}
+		
+		if (textures.empty() == false)
+		{
+			if (textures.back() != 0)
+			{
+				textures.back()->preload();
+			}
+			textures.pop_back();
+		}
+		return textures.empty();
+	}
+	
+	tt::engine::renderer::TextureContainer textures;
+	bool                                   started;
+};
+#endif
+
+
+struct LoadThreadStart
+{
+	inline void operator()() const
+	{
+#if defined(TT_PLATFORM_WIN)
+		// COM needs to be initialized on each thread it is used
+		// We need it for Xact initialization
+		HRESULT hr = CoInitializeEx(0, COINIT_MULTITHREADED);
+		TT_ASSERT(SUCCEEDED(hr));
+#endif
+		
+		// Make sure the game has had time to render at least one frame before starting load
+		// (for LOT, we should initialize the save library after rendering at least one frame,
+		//  so that any possible errors can be displayed properly)
+		tt::thread::sleep(50);
+	}
+};
+
+
+struct LoadThreadExit
+{
+	inline void operator()() const
+	{
+#if defined(TT_PLATFORM_WIN)
+		CoUninitialize();
+#endif
+	}
+};
 
 
 //--------------------------------------------------------------------------------------------------
@@ -49,19 +135,13 @@ namespace main {
 StateLoadApp::StateLoadApp(tt::code::StateMachine* p_stateMachine)
 :
 tt::code::State(p_stateMachine),
+m_loadGraph(0),
 m_loadStartTimestamp(0),
 m_postLoadState(statelist::StateID_Game),
 m_presentationMgr(),
 m_presentations(),
 m_isFadingIn(true),
 m_graphicState(GraphicState_Loading)
-#if USE_THREADED_LOADING
-,
-m_loadSuspended(false),
-m_stopLoading(false),
-m_loadThread(),
-m_mutex(0)
-#endif
 {
 }
 
@@ -108,7 +188,7 @@ void StateLoadApp::enter()
 		}
 	}
 	
-	if (AppGlobal::shouldCompileSquirrel())
+	if (AppGlobal::shouldCompileSquirrel() || AppGlobal::shouldPrecompileSquirrel())
 	{
 		m_postLoadState = statelist::StateID_ExitApp;
 	}
@@ -137,41 +217,26 @@ void StateLoadApp::enter()
 	m_isFadingIn = true;
 	gfx.getFadeQuad()->fadeOut(0.25f);
 	
-#if USE_THREADED_LOADING
-	m_loadSuspended = false;
-	m_stopLoading   = false;
-	TT_ASSERT(m_mutex == 0);
-	m_mutex = new tt::thread::Mutex;
-	
-	TT_ASSERT(m_loadThread == 0);
-	m_loadThread = tt::thread::create(staticLoadThread, this, false, 0, tt::thread::priority_below_normal, 
-			tt::thread::Affinity_None, "Application Load Thread");
+	s32 threadCount = USE_THREADED_LOADING ? -1 : 0;
+#if !defined(TT_BUILD_FINAL)
+	if (cmdLine.exists("load_threads"))
+	{
+		threadCount = cmdLine.getInteger("load_threads");
+	}
 #endif
+	m_loadGraph->start(threadCount, LoadThreadStart(), LoadThreadExit());
 }
 
 
 void StateLoadApp::exit()
 {
-#if USE_THREADED_LOADING
-	TT_NULL_ASSERT(m_mutex);
-	m_mutex->lock();
-	m_loadSuspended = false;
-	m_stopLoading   = true;
-#endif
+	TT_NULL_ASSERT(m_loadGraph);
+	m_loadGraph->cancel();
+	delete m_loadGraph;
+	m_loadGraph = 0;
 	
-	m_loadStates.clear();
 	destroyLoadingGraphics();
 	
-#if USE_THREADED_LOADING
-	m_mutex->unlock();
-	
-	tt::thread::wait(m_loadThread);
-	m_loadThread.reset();
-	
-	delete m_mutex;
-	m_mutex = 0;
-#endif
-	
 	if (AppGlobal::isInLevelEditorMode() == false)
 	{
 		// In case our internal builds didn't get the chance to fade the logo in yet,
@@ -191,10 +256,6 @@ void StateLoadApp::exit()
 
 void StateLoadApp::update(real p_deltaTime)
 {
-#if USE_THREADED_LOADING
-	tt::thread::CriticalSection critSec(m_mutex);
-#endif
-	
 	if (m_presentationMgr != 0)
 	{
 		m_presentationMgr->update(p_deltaTime);
@@ -242,22 +303,9 @@ void StateLoadApp::update(real p_deltaTime)
 		}
 	}
 	
-	// Perform another load step
-#if USE_THREADED_LOADING == 0
-	if (m_loadStates.empty() == false)
-	{
-		const loadstate::LoadStatePtr& state(m_loadStates.front());
-		state->doLoadStep();
-		// FIXME: Wrong... should update this step counter some other way (doLoadStep could perform more than one step per call)
-		++m_currentStep;
-		
-		if (state->isDone())
-		{
-			m_loadStates.pop_front();
-		}
-	}
-	else
-#endif  // USE_THREADED_LOADING == 0
+	// Perform the load steps that need the main thread (all of them without load threads)
+	m_loadGraph->processMainThreadTasks(g_mainThreadLoadBudgetMs);
+	
 	if (m_graphicState == GraphicState_Fade &&
 	    gfx.getFadeQuad()->checkFlag(QuadSprite::Flag_FadingIn) == false)
 	{
@@ -277,7 +325,7 @@ void StateLoadApp::update(real p_deltaTime)
 	// Only move on from the loading state if loading is complete
 	// (however, do not wait for the loading graphics to complete in "no precache" mode: we want fast startup in that case)
 	if (m_graphicState == GraphicState_Loading &&
-	    m_loadStates.empty())
+	    m_loadGraph->isDone())
 	{
 		startFadeOut();
 	}
@@ -286,10 +334,6 @@ void StateLoadApp::update(real p_deltaTime)
 
 void StateLoadApp::updateForRender(real p_deltaTime)
 {
-#if USE_THREADED_LOADING
-	tt::thread::CriticalSection critSec(m_mutex);
-#endif
-	
 	alignLoadingGraphics();
 	
 	if (m_presentationMgr != 0)
@@ -301,10 +345,6 @@ void StateLoadApp::updateForRender(real p_deltaTime)
 
 void StateLoadApp::render()
 {
-#if USE_THREADED_LOADING
-	tt::thread::CriticalSection critSec(m_mutex);
-#endif
-	
 	tt::engine::renderer::Renderer* renderer = tt::engine::renderer::Renderer::getInstance();
 	
 	const Screen screen = utils::getScreenFromViewPortID(renderer->getActiveViewPort());
@@ -347,7 +387,8 @@ void StateLoadApp::render()
 #if !defined(TT_BUILD_FINAL)
 	if (screen == Screen_TV)
 	{
-		const std::string loadText(m_loadStates.empty() ? "Starting game..." : m_loadStates.front()->getName());
+		const std::string runningTask(m_loadGraph->getRunningTaskName());
+		const std::string loadText(runningTask.empty() ? "Starting game..." : runningTask);
 		s32 textOffset = static_cast<s32>(loadText.length() * 3);
 		tt::math::Point2 loadTextPos((renderer->getScreenWidth() / 2) - textOffset, 20);
 		
@@ -391,21 +432,21 @@ void StateLoadApp::onResetDevice()
 
 void StateLoadApp::onAppPaused()
 {
-#if USE_THREADED_LOADING
-	//TT_Printf("StateLoadApp::onAppPaused: Suspending load thread.\n");
-	//tt::thread::CriticalSection critSec(m_mutex);
-	m_loadSuspended = true;
-#endif
+	//TT_Printf("StateLoadApp::onAppPaused: Suspending load threads.\n");
+	if (m_loadGraph != 0)
+	{
+		m_loadGraph->setSuspended(true);
+	}
 }
 
 
 void StateLoadApp::onAppResumed()
 {
-#if USE_THREADED_LOADING
-	//TT_Printf("StateLoadApp::onAppResumed: Resuming load thread.\n");
-	//tt::thread::CriticalSection critSec(m_mutex);
-	m_loadSuspended = false;
-#endif
+	//TT_Printf("StateLoadApp::onAppResumed: Resuming load threads.\n");
+	if (m_loadGraph != 0)
+	{
+		m_loadGraph->setSuspended(false);
+	}
 }
 
 
@@ -414,66 +455,131 @@ void StateLoadApp::onAppResumed()
 
 void StateLoadApp::setupLoadStates()
 {
+	using namespace loadstate;
+	typedef tt::thread::LoadGraph::TaskID  TaskID;
+	typedef tt::thread::LoadGraph::TaskIDs TaskIDs;
+	
+	TT_ASSERT(m_loadGraph == 0);
+	m_loadGraph = new tt::thread::LoadGraph;
+	
 	// Special case: if entering a state that does not require the complete game to be loaded
 	// (such as the presentation viewer), add just a minimal set of load states, to keep load time down
 	const bool performFullLoad = (m_postLoadState != statelist::StateID_PresentationViewer);
 	
 #if !defined(TT_BUILD_FINAL)
-	if (AppGlobal::shouldCompileSquirrel())
+	if (AppGlobal::shouldCompileSquirrel() || AppGlobal::shouldPrecompileSquirrel())
 	{
-		m_loadStates.push_back(loadstate::LoadStateScriptLists::create());
-		m_loadStates.push_back(loadstate::LoadStateAudioPlayer::create());
-		m_loadStates.push_back(loadstate::LoadStateScriptMgr::create());
-		
-		calculateLoadSteps();
+		const TaskID scriptLists = addLoadState(LoadStateScriptLists::create(), LoadPriority_Critical);
+		const TaskID audioPlayer = addLoadState(LoadStateAudioPlayer::create(), LoadPriority_Critical);
+		const TaskID scriptMgr   = addLoadState(LoadStateScriptMgr::create(),   LoadPriority_Critical);
+		m_loadGraph->addDependency(audioPlayer, scriptLists);
+		m_loadGraph->addDependency(scriptMgr,   audioPlayer);
 		return;
 	}
 #endif
 	
+	// Load states only run at the same time when that is known to be safe. The overlaps that remain:
+	// - Precaching with InitSaveSystem, ScriptLists, Game, SkinConfigs and AudioPlayer: the precache
+	//   states only list their own folders, load into their own caches and add to the precache lists
+	//   of AppGlobal (guarded by its precache mutex). Audio triggers in presentations only use the
+	//   AudioPlayer when they're triggered, not when they're loaded.
+	// - Texture precaching with ScriptMgr and EntityLibrary: ResourceCache<Texture> guards its map. Where
+	//   it decodes outside its lock (SDL builds), Texture::load only decodes into the new texture.
+	// - SkinConfigs with InitSaveSystem, ScriptLists, Game and AudioPlayer: it only creates the skin
+	//   configs of AppGlobal, which only the states that depend on it read.
+	// - ScriptLists with InitSaveSystem: listing files and reading the config don't touch the save volume.
+	// Everything else keeps the order it had when the load states ran one after the other.
+	
 	// Prepare all load steps here
-	m_loadStates.clear();
-	m_loadStates.push_back(loadstate::LoadStateInitSaveSystem::create());  // We want to get save ready asap.
+	const TaskID initSaveSystem = addLoadState(LoadStateInitSaveSystem::create(), LoadPriority_Critical); // We want to get save ready asap.
+	TaskID  game        = -1;
+	TaskID  skinConfigs = -1;
+	TaskIDs beforeScripts; // Precache states the scripts wait for
 	if (performFullLoad)
 	{
-		m_loadStates.push_back(loadstate::LoadStateScriptLists::create()); // Level list needed to validated shutdown level (next state)
-		m_loadStates.push_back(loadstate::LoadStateGame::create());        // Decide which level we should start in. (Done early so we can show a level specific load screen.) FIXME: Should be renamed to LoadStateStartInfo.
-		m_loadStates.push_back(loadstate::LoadStateSkinConfigs::create());
+		const TaskID scriptLists = addLoadState(LoadStateScriptLists::create(), LoadPriority_Critical); // Level list needed to validated shutdown level (next state)
+		
+		// Decide which level we should start in. (Done early so we can show a level specific load screen.) FIXME: Should be renamed to LoadStateStartInfo.
+		// Also waits for the save system, as both mount the save volume
+		game = addLoadState(LoadStateGame::create(), LoadPriority_Critical);
+		m_loadGraph->addDependency(game, initSaveSystem);
+		m_loadGraph->addDependency(game, scriptLists);
+		
+		skinConfigs = addLoadState(LoadStateSkinConfigs::create(), LoadPriority_Normal);
+		
 		if (AppGlobal::shouldDoPrecache())
 		{
-			m_loadStates.push_back(loadstate::LoadStateShoeboxPrecache::create());
-			m_loadStates.push_back(loadstate::LoadStatePrecache::create());
+			TaskIDs precache;
+			
+			// Shoeboxes, particles and presentations all create particle triggers and presentations,
+			// which aren't thread safe: chain these. The other parts load in parallel.
+			precache.push_back(addLoadState(LoadStateShoeboxPrecache::create(), LoadPriority_Precache));
+			precache.push_back(addLoadState(LoadStatePrecache::create(LoadStatePrecache::Content_Particles),
+			                                LoadPriority_Precache));
+			m_loadGraph->addDependency(precache.back(), precache[precache.size() - 2]);
+			precache.push_back(addLoadState(LoadStatePrecache::create(LoadStatePrecache::Content_Presentations),
+			                                LoadPriority_Precache));
+			m_loadGraph->addDependency(precache.back(), precache[precache.size() - 2]);
+			beforeScripts.push_back(precache.back());
+			
+			// MovementSetCache has no lock, so nothing that runs scripts may overlap this
+			precache.push_back(addLoadState(LoadStatePrecache::create(LoadStatePrecache::Content_MovementSets),
+			                                LoadPriority_Precache));
+			beforeScripts.push_back(precache.back());
+			precache.push_back(addLoadState(LoadStatePrecache::create(LoadStatePrecache::Content_SkinConfigs),
+			                                LoadPriority_Precache));
+			m_loadGraph->addDependency(precache.back(), skinConfigs);
+			beforeScripts.push_back(precache.back());
+			precache.push_back(addLoadState(LoadStatePrecache::create(LoadStatePrecache::Content_Textures),
+			                                LoadPriority_Precache));
+			
+#if defined(TT_PLATFORM_SDL)
+			// Upload during the load screen instead of on first use in the game
+			const TaskID upload = m_loadGraph->addTask("Precache - Texture Upload", UploadPrecachedTextures(),
+			                                           LoadPriority_Precache, tt::thread::LoadGraph::ThreadType_Main);
+			for (TaskIDs::const_iterator it = precache.begin(); it != precache.end(); ++it)
+			{
+				m_loadGraph->addDependency(upload, *it);
+			}
+#endif
 		}
 	}
-	m_loadStates.push_back(loadstate::LoadStateAudioPlayer::create());
+	
+	const TaskID audioPlayer = addLoadState(LoadStateAudioPlayer::create(), LoadPriority_Critical);
+	m_loadGraph->addDependency(audioPlayer, initSaveSystem);
+	
 	if (performFullLoad)
 	{
-		m_loadStates.push_back(loadstate::LoadStateScriptMgr::create());
-		m_loadStates.push_back(loadstate::LoadStateEntityLibrary::create());
+		m_loadGraph->addDependency(audioPlayer, game);
+		
+		// Scripts run while they're loaded and can create particle triggers, presentations and movement
+		// sets through their bindings, none of which are thread safe
+		const TaskID scriptMgr = addLoadState(LoadStateScriptMgr::create(), LoadPriority_Critical);
+		m_loadGraph->addDependency(scriptMgr, game);
+		m_loadGraph->addDependency(scriptMgr, skinConfigs);
+		m_loadGraph->addDependency(scriptMgr, audioPlayer);
+		for (TaskIDs::const_iterator it = beforeScripts.begin(); it != beforeScripts.end(); ++it)
+		{
+			m_loadGraph->addDependency(scriptMgr, *it);
+		}
+		
+		const TaskID entityLibrary = addLoadState(LoadStateEntityLibrary::create(), LoadPriority_Critical);
+		m_loadGraph->addDependency(entityLibrary, scriptMgr);
 		
 #if !defined(TT_BUILD_FINAL)
 		if (tt::app::getCmdLine().exists("generate_meta_data"))
 		{
-			m_loadStates.push_back(loadstate::LoadStateGenerateMetaData::create());
+			const TaskID metaData = addLoadState(LoadStateGenerateMetaData::create(), LoadPriority_Critical);
+			m_loadGraph->addDependency(metaData, entityLibrary);
 		}
 #endif
 	}
-	
-	calculateLoadSteps();
 }
 
 
-void StateLoadApp::calculateLoadSteps()
+tt::thread::LoadGraph::TaskID StateLoadApp::addLoadState(const loadstate::LoadStatePtr& p_state, s32 p_priority)
 {
-	// Calculate how many load steps to expect in total
-	m_currentStep    = 0;
-	m_totalLoadSteps = 0;
-	for (LoadStates::iterator it = m_loadStates.begin(); it != m_loadStates.end(); ++it)
-	{
-		const s32 stepCount = (*it)->getEstimatedStepCount();
-		//TT_Printf("StateLoadApp::setupLoadStates: State '%s' has %d steps.\n",
-		//          (*it)->getName().c_str(), stepCount);
-		m_totalLoadSteps += stepCount;
-	}
+	return m_loadGraph->addTask(p_state->getName(), LoadStateStep(p_state), p_priority);
 }
 
 
@@ -544,6 +650,8 @@ void StateLoadApp::startFadeOut()
 	          totalTime, totalMinutes, totalSeconds);
 	
 	AppGlobal::setLoadTimeApp(totalTime);
+	
+	m_loadGraph->printTimeline("StateLoadApp");
 #endif
 	
 	AppGlobal::getSharedGraphics().getFadeQuad()->setColor(tt::engine::renderer::ColorRGB::black);
@@ -575,86 +683,6 @@ void StateLoadApp::alignLoadingGraphics()
 	AppGlobal::getSharedGraphics().updateAll();
 }
 
-
-#if USE_THREADED_LOADING
-
-int StateLoadApp::staticLoadThread(void* p_arg)
-{
-	return reinterpret_cast<StateLoadApp*>(p_arg)->loadThread();
-}
-
-
-int StateLoadApp::loadThread()
-{
-#if defined(TT_PLATFORM_WIN)
-	// COM needs to be initialized on each thread it is used
-	// We need it for Xact initialization
-	HRESULT hr = CoInitializeEx(0, COINIT_MULTITHREADED);
-	TT_ASSERT(SUCCEEDED(hr));
-#endif
-	
-	// Make sure the game has had time to render at least one frame before starting load
-	// (for LOT, we should initialize the save library after rendering at least one frame,
-	//  so that any possible errors can be displayed properly)
-	tt::thread::sleep(50);
-	
-	for ( ;; )
-	{
-		// Get a new state to load
-		m_mutex->lock();
-		
-		if (m_loadSuspended)
-		{
-			// We're not allowed to do anything at this time: wait for a bit and try again
-			m_mutex->unlock();
-			tt::thread::sleep(50);
-			continue;
-		}
-		
-		if (m_stopLoading)
-		{
-			m_mutex->unlock();
-			return 0;
-		}
-		
-		if (m_loadStates.empty())
-		{
-			m_mutex->unlock();
-			break;
-		}
-		
-		loadstate::LoadStatePtr state(m_loadStates.front());
-		//TT_Printf("StateLoadApp::loadThread: Step %d of %d (state '%s')...\n",
-		//          m_currentStep, m_totalLoadSteps, state->getName().c_str());
-		
-		m_mutex->unlock();
-		
-		// Load
-		state->doLoadStep();
-		
-		// Move on to the next step
-		m_mutex->lock();
-		
-		++m_currentStep;
-		if (state->isDone() && m_loadStates.empty() == false)
-		{
-			m_loadStates.pop_front();
-		}
-		
-		m_mutex->unlock();
-	}
-	
-	// Done loading: simply exit the loading thread. The main thread will take care of the rest.
-	
-#if defined(TT_PLATFORM_WIN)
-	CoUninitialize();
-#endif
-	
-	return 0;
-}
-
-#endif  // USE_THREADED_LOADING
-
 // Namespace end
 }
 }
@@ -70,6 +70,11 @@ void LoadStateGame::doLoadStep()
 		// Play a user recording with full path from the command line
 		startInfo.setUserRecording(unfilteredCmdLine.getString("userrecording"));
 	}
+	else if (AppGlobal::getBenchmarkMode() == AppGlobal::BenchmarkMode_Replay)
+	{
+		// Play the recording that is being benchmarked (see input::ReplayBenchmark)
+		startInfo.setUserRecording(unfilteredCmdLine.getString("benchmark"));
+	}
 #endif
 	else if (AppGlobal::isInLevelEditorMode())
 	{
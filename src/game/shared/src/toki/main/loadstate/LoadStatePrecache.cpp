@@ -67,7 +67,7 @@ s32 LoadStatePrecache::getEstimatedStepCount() const
 	return static_cast<s32>(m_filenamesParticles.size()    +
 	                        m_filenamesPresentation.size() +
 	                        m_filenamesMovementSet.size()  +
-	                        level::skin::SkinConfigType_Count +
+	                        (level::skin::SkinConfigType_Count - m_skinConfigs) +
 	                        m_miscTextures.size()          +
 	                        m_namespaceTextures.size());
 }
@@ -227,12 +227,12 @@ bool LoadStatePrecache::isDone() const
 //--------------------------------------------------------------------------------------------------
 // Private member functions
 
-LoadStatePrecache::LoadStatePrecache()
+LoadStatePrecache::LoadStatePrecache(u32 p_content)
 :
 m_filenamesParticles(),
 m_filenamesPresentation(),
 m_filenamesMovementSet(),
-m_skinConfigs(static_cast<level::skin::SkinConfigType>(0)),
+m_skinConfigs(level::skin::SkinConfigType_Count),
 m_miscTextures(),
 m_namespaceTextures()
 {
@@ -240,24 +240,39 @@ m_namespaceTextures()
 	const u64 loadStart = tt::system::Time::getInstance()->getMilliSeconds();
 #endif
 	
-	gatherFilenames("particles/",    "trigger", false, m_filenamesParticles);
-	gatherFilenames("movement/",     "ttms",    false, m_filenamesMovementSet);
+	if ((p_content & Content_Particles) != 0)
+	{
+		gatherFilenames("particles/", "trigger", false, m_filenamesParticles);
+	}
+	if ((p_content & Content_MovementSets) != 0)
+	{
+		gatherFilenames("movement/", "ttms", false, m_filenamesMovementSet);
+	}
 	
-	// Precache all presentations
-	gatherFilenames("presentation/", "pres", true, m_filenamesPresentation);
+	if ((p_content & Content_Presentations) != 0)
+	{
+		// Precache all presentations
+		gatherFilenames("presentation/", "pres", true, m_filenamesPresentation);
+	}
 	// Don't precache all textures
 	//gatherEngineIDs("textures" , m_namespaceTextures);
 	
-	m_skinConfigs = static_cast<level::skin::SkinConfigType>(0);
+	if ((p_content & Content_SkinConfigs) != 0)
+	{
+		m_skinConfigs = static_cast<level::skin::SkinConfigType>(0);
+	}
 	
+	if ((p_content & Content_Textures) != 0)
+	{
 #if defined(TT_PLATFORM_WIN)
-	m_miscTextures.push_back(utils::StringPair("attributeview", "textures"));
-	m_miscTextures.push_back(utils::StringPair("debugview"    , "textures"));
+		m_miscTextures.push_back(utils::StringPair("attributeview", "textures"));
+		m_miscTextures.push_back(utils::StringPair("debugview"    , "textures"));
 #endif
-	
-	game::entity::graphics::PowerBeamGraphic::getNeededTextureIDs(&m_miscTextures);
-	
-	gatherEngineIDs("color_grading" , m_namespaceTextures);
+		
+		game::entity::graphics::PowerBeamGraphic::getNeededTextureIDs(&m_miscTextures);
+		
+		gatherEngineIDs("color_grading" , m_namespaceTextures);
+	}
 	
 #if TT_ENABLE_PRECACHE_TIMING
 	const u64 loadEnd = tt::system::Time::getInstance()->getMilliSeconds();
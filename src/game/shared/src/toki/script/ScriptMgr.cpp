@@ -13,11 +13,13 @@
 
 #include <tt/code/bufferutils.h>
 #include <tt/fs/utils/utils.h>
+#include <tt/fs/fs.h>
 #include <tt/fs/Dir.h>
 #include <tt/fs/DirEntry.h>
 #include <tt/platform/tt_error.h>
 #include <tt/platform/tt_printf.h>
 #include <tt/script/bindings/bindings.h>
+#include <tt/script/BytecodeCache.h>
 #include <tt/str/common.h>
 #include <tt/system/Time.h>
 
@@ -132,6 +134,15 @@ void ScriptMgr::init()
 	
 	ms_vm = tt::script::ScriptEngine::createVM("scripts/", debugPort, compileMode);
 	
+#if !defined(TT_BUILD_FINAL)
+	// Keep compiled scripts between runs, so only scripts that changed are compiled at startup
+	if (compileMode == tt::script::VMCompileMode_NutOnly)
+	{
+		ms_vm->setBytecodeCache(tt::script::BytecodeCache::create(
+			tt::fs::getSaveRootDir() + "scriptcache" + tt::fs::getDirSeparator()));
+	}
+#endif
+	
 	ms_initialized = true;
 	sq_resetobject(&ms_initRootTable);
 	sq_resetobject(&ms_metaData);
@@ -257,6 +268,13 @@ void ScriptMgr::init()
 	ms_serializationCachePtr.reset(new serialization::SQCache(ms_vm->getVM()));
 	
 #if !defined(TT_BUILD_FINAL)
+	const tt::script::BytecodeCachePtr& bytecodeCache(ms_vm->getBytecodeCache());
+	if (bytecodeCache != 0)
+	{
+		TT_Printf("ScriptMgr::init: %d scripts loaded from the bytecode cache, %d compiled.\n",
+		          bytecodeCache->getHitCount(), bytecodeCache->getMissCount());
+	}
+	
 	u64 scriptInitEnd = tt::system::Time::getInstance()->getMilliSeconds();
 	TT_Printf("ScriptMgr::init took %u milliseconds.\n", u32(scriptInitEnd - scriptInitStart));
 #endif // #if !defined(TT_BUILD_FINAL)
@@ -0,0 +1,155 @@
+#include <tt/platform/tt_error.h>
+
+#include <toki/serialization/RewindBuffer.h>
+#include <toki/serialization/SerializationMgr.h>
+
+
+namespace toki {
+namespace serialization {
+
+//--------------------------------------------------------------------------------------------------
+// Public member functions
+
+RewindBuffer::RewindBuffer(u32 p_sizeLimit, s32 p_keyFrameInterval)
+:
+m_entries(),
+m_lastCheckPoint(),
+m_totalSize(0),
+m_deltasSinceKeyFrame(0),
+m_sizeLimit(p_sizeLimit),
+m_keyFrameInterval(p_keyFrameInterval)
+{
+	TT_ASSERT(m_keyFrameInterval > 0);
+}
+
+
+SerializationMgrPtr RewindBuffer::push(const SerializationMgrPtr& p_checkPoint,
+                                       const tt::code::BufferPtr& p_compressed, const std::string& p_id)
+{
+	TT_NULL_ASSERT(p_checkPoint);
+	
+	Entry entry;
+	entry.id         = p_id;
+	entry.isKeyFrame = m_lastCheckPoint == 0 || m_deltasSinceKeyFrame >= m_keyFrameInterval - 1;
+	if (entry.isKeyFrame)
+	{
+		entry.data = (p_compressed != 0) ? p_compressed : p_checkPoint->compress();
+	}
+	else
+	{
+		entry.data = p_checkPoint->compressDelta(*m_lastCheckPoint);
+	}
+	
+	if (entry.data == 0)
+	{
+		// Without this checkpoint the next delta would have no reference; start over
+		clear();
+		return SerializationMgrPtr();
+	}
+	
+	m_deltasSinceKeyFrame = entry.isKeyFrame ? 0 : m_deltasSinceKeyFrame + 1;
+	m_totalSize += static_cast<u32>(entry.data->getSize());
+	m_entries.push_back(entry);
+	
+	SerializationMgrPtr previous(m_lastCheckPoint);
+	m_lastCheckPoint = p_checkPoint;
+	
+	while (m_totalSize > m_sizeLimit && removeOldestKeyFrame())
+	{
+	}
+	
+	return previous;
+}
+
+
+SerializationMgrPtr RewindBuffer::rewind(s32 p_stepsBack, std::string* p_id_OUT)
+{
+	TT_NULL_ASSERT(p_id_OUT);
+	
+	const s32 index = getCount() - 1 - p_stepsBack;
+	if (p_stepsBack < 0 || index < 0)
+	{
+		return SerializationMgrPtr();
+	}
+	
+	SerializationMgrPtr checkPoint;
+	if (p_stepsBack == 0)
+	{
+		// The most recent checkpoint is still around uncompressed
+		checkPoint = m_lastCheckPoint->clone();
+	}
+	else
+	{
+		s32 keyFrame = index;
+		while (m_entries[keyFrame].isKeyFrame == false)
+		{
+			--keyFrame;
+			TT_ASSERT(keyFrame >= 0);
+		}
+		
+		checkPoint = SerializationMgr::createFromCompressedBuffer(m_entries[keyFrame].data);
+		for (s32 i = keyFrame + 1; i <= index && checkPoint != 0; ++i)
+		{
+			checkPoint = SerializationMgr::createFromDeltaBuffer(m_entries[i].data, *checkPoint);
+		}
+		
+		if (checkPoint == 0)
+		{
+			TT_PANIC("Restoring checkpoint %d of the rewind buffer failed.", index);
+			clear();
+			return SerializationMgrPtr();
+		}
+		
+		for (s32 i = getCount() - 1; i > index; --i)
+		{
+			m_totalSize -= static_cast<u32>(m_entries.back().data->getSize());
+			m_entries.pop_back();
+		}
+		m_lastCheckPoint      = checkPoint->clone();
+		m_deltasSinceKeyFrame = index - keyFrame;
+	}
+	
+	*p_id_OUT = m_entries.back().id;
+	return checkPoint;
+}
+
+
+void RewindBuffer::clear()
+{
+	m_entries.clear();
+	m_lastCheckPoint.reset();
+	m_totalSize           = 0;
+	m_deltasSinceKeyFrame = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Private member functions
+
+bool RewindBuffer::removeOldestKeyFrame()
+{
+	// Find the next key frame; everything before it depends on the oldest key frame
+	Entries::size_type nextKeyFrame = 1;
+	while (nextKeyFrame < m_entries.size() && m_entries[nextKeyFrame].isKeyFrame == false)
+	{
+		++nextKeyFrame;
+	}
+	
+	if (nextKeyFrame >= m_entries.size())
+	{
+		// Only one key frame left; keep it
+		return false;
+	}
+	
+	for (Entries::size_type i = 0; i < nextKeyFrame; ++i)
+	{
+		m_totalSize -= static_cast<u32>(m_entries.front().data->getSize());
+		m_entries.pop_front();
+	}
+	
+	return true;
+}
+
+// Namespace end
+}
+}
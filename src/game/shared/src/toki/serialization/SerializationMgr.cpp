@@ -1,9 +1,10 @@
+#include <algorithm>
 #include <cstring>
 
 #include <tt/app/Application.h>
 #include <tt/code/bufferutils.h>
 #include <tt/code/FourCC.h>
-#include <tt/compression/fastlz.h>
+#include <tt/compression/lz4/lz4.h>
 #include <tt/mem/util.h>
 #include <tt/fs/File.h>
 #include <tt/fs/fs.h>
@@ -17,7 +18,24 @@
 namespace toki {
 namespace serialization {
 
-#define UNCOMPRESSED_CHECKPOINTS 1
+// Signatures of the compressed buffer formats. Buffers without a signature contain the uncompressed
+// layout, which starts with the (small) number of sections.
+static const u32 g_compressedSignature = tt::code::FourCC<'c', 'k', 'p', 't'>::value;
+static const u32 g_deltaSignature      = tt::code::FourCC<'c', 'k', 'p', 'd'>::value;
+
+
+static u32 getSignature(const tt::code::BufferPtr& p_buffer)
+{
+	if (p_buffer == 0 || p_buffer->getSize() < static_cast<tt::code::Buffer::size_type>(sizeof(u32)))
+	{
+		return 0;
+	}
+	
+	tt::code::BufferReadContext context(tt::code::BufferReadContext::createForRawBuffer(
+		static_cast<const u8*>(p_buffer->getData()), sizeof(u32)));
+	return tt::code::bufferutils::get<u32>(&context);
+}
+
 
 // Section identifier FourCCs
 
@@ -71,6 +89,7 @@ Section getSectionFromSaveID(u32 p_saveID)
 //--------------------------------------------------------------------------------------------------
 // Static variables
 
+const u32 SerializationMgr::ms_deltaBlockSize;
 u8 SerializationMgr::ms_compressionInputBuffer [ms_compressionBufferSize];
 u8 SerializationMgr::ms_compressionOutputBuffer[ms_compressionBufferSize];
 
@@ -107,6 +126,19 @@ SerializationMgrPtr SerializationMgr::createFromCompressedBuffer(const tt::code:
 }
 
 
+SerializationMgrPtr SerializationMgr::createFromDeltaBuffer(const tt::code::BufferPtr& p_buffer,
+                                                            const SerializationMgr&    p_reference)
+{
+	SerializationMgrPtr mgr(new SerializationMgr);
+	if (mgr->loadFromDeltaBuffer(p_buffer, p_reference) == false)
+	{
+		return SerializationMgrPtr();
+	}
+	
+	return mgr;
+}
+
+
 SerializationMgr::SerializationMgr()
 {
 	for (s32 i = 0; i < Section_Count; ++i)
@@ -199,57 +231,100 @@ SerializationMgrPtr SerializationMgr::clone() const
 
 tt::code::BufferPtr SerializationMgr::compress() const
 {
-	tt::code::BufferWriteContext input(
+	const u32 totalSize = writeSections();
+	if (totalSize == 0)
+	{
+		return tt::code::BufferPtr();
+	}
+	
+	return compressInput(g_compressedSignature, totalSize);
+}
+
+
+tt::code::BufferPtr SerializationMgr::compressDelta(const SerializationMgr& p_reference) const
+{
+	tt::code::BufferWriteContext output(
 		tt::code::BufferWriteContext::createForRawBuffer(ms_compressionInputBuffer, ms_compressionBufferSize));
 	
 	namespace bu = tt::code::bufferutils;
 	
-	// Store the number of sections
 	u32 sectionCount = 0;
 	for (s32 i = 0; i < Section_Count; ++i)
 	{
 		if (m_sections[i] != 0 && m_sections[i]->getSize() != 0) ++sectionCount;
 	}
-	bu::put(sectionCount, &input);
+	bu::put(sectionCount, &output);
+	
+	u8 currentBlock  [ms_deltaBlockSize];
+	u8 referenceBlock[ms_deltaBlockSize];
 	
-	// Load all sections into compression input buffer
 	for (s32 i = 0; i < Section_Count; ++i)
 	{
 		const Section section = static_cast<Section>(i);
 		if (m_sections[section] == 0 || m_sections[section]->getSize() == 0)
 		{
-			// No section data available: do not store
 			continue;
 		}
-		// Write sectionID in buffer
-		bu::put(getSectionSaveID(section), &input);
 		
-		// Write section to buffer
-		if (m_sections[section]->saveToBuffer(&input) == false)
+		const SerializerPtr& referenceSection(p_reference.m_sections[section]);
+		const u32 size          = m_sections[section]->getSize();
+		const u32 referenceSize = (referenceSection != 0) ? referenceSection->getSize() : 0;
+		const u32 blockCount    = (size + ms_deltaBlockSize - 1) / ms_deltaBlockSize;
+		const u32 maskSize      = (blockCount + 7) / 8;
+		
+		bu::put(getSectionSaveID(section), &output);
+		bu::put(size, &output);
+		
+		// Reserve room for the mask of changed blocks; it is filled in while comparing
+		if (static_cast<u32>(output.end - output.cursor) < maskSize)
 		{
+			TT_PANIC("Delta checkpoint does not fit in the %u bytes compression buffer.", ms_compressionBufferSize);
 			return tt::code::BufferPtr();
 		}
+		u8* changedMask = output.cursor;
+		tt::mem::zero8(changedMask, static_cast<tt::mem::size_type>(maskSize));
+		output.cursor += maskSize;
+		
+		tt::code::BufferReadContext current(m_sections[section]->getReadContext());
+		tt::code::BufferReadContext reference;
+		if (referenceSize > 0)
+		{
+			reference = referenceSection->getReadContext();
+		}
+		
+		for (u32 block = 0; block < blockCount; ++block)
+		{
+			const u32 offset    = block * ms_deltaBlockSize;
+			const u32 blockSize = std::min(ms_deltaBlockSize, size - offset);
+			bu::get(currentBlock, blockSize, &current);
+			
+			bool changed = true;
+			if (offset + blockSize <= referenceSize)
+			{
+				bu::get(referenceBlock, blockSize, &reference);
+				changed = std::memcmp(currentBlock, referenceBlock, blockSize) != 0;
+			}
+			
+			if (changed)
+			{
+				changedMask[block / 8] |= static_cast<u8>(1 << (block % 8));
+				bu::put(currentBlock, blockSize, &output);
+			}
+		}
 	}
 	
-	const u32 totalSize = static_cast<u32>(input.cursor - input.start);
-#if UNCOMPRESSED_CHECKPOINTS
-	tt::code::BufferPtrForCreator buffer(new tt::code::Buffer(totalSize));
-	tt::mem::copy8(buffer->getData(), &ms_compressionInputBuffer, totalSize);
-	return buffer;
-#else
-	// Compress the buffer
-	// FIXME: Use LZ4 fast with acceleration 50 here; performs better than FastLZ. Only you need to store the
-	// size of the uncompressed buffer as well!
-	const s32 compressedSize = 
-		fastlz_compress(&ms_compressionInputBuffer, totalSize, &ms_compressionOutputBuffer);
-	
-	tt::code::BufferPtrForCreator buffer(new tt::code::Buffer(compressedSize));
-	
-	// Copy compressed data to return buffer
-	tt::mem::copy8(buffer->getData(), &ms_compressionOutputBuffer, compressedSize);
+	if (output.statusCode != 0)
+	{
+		return tt::code::BufferPtr();
+	}
 	
-	return buffer;
-#endif
+	return compressInput(g_deltaSignature, static_cast<u32>(output.cursor - output.start));
+}
+
+
+bool SerializationMgr::isDeltaBuffer(const tt::code::BufferPtr& p_buffer)
+{
+	return getSignature(p_buffer) == g_deltaSignature;
 }
 
 
@@ -271,21 +346,180 @@ SerializationMgr::SerializationMgr(const SerializationMgr& p_rhs)
 
 bool SerializationMgr::loadFromCompressedBuffer(const tt::code::BufferPtr& p_buffer)
 {
-#if UNCOMPRESSED_CHECKPOINTS
-	tt::code::BufferReadContext input(
-		tt::code::BufferReadContext::createForRawBuffer(static_cast<const u8*>(p_buffer->getData()), p_buffer->getSize()));
-#else
-	const u32 decompressedSize = fastlz_decompress(p_buffer->getData(), p_buffer->getSize(),
-	                                               &ms_compressionInputBuffer, ms_compressionBufferSize);
+	TT_NULL_ASSERT(p_buffer);
 	
+	const u32 signature = getSignature(p_buffer);
+	if (signature == g_deltaSignature)
+	{
+		TT_PANIC("loadFromCompressedBuffer cannot load a delta buffer without its reference data.");
+		return false;
+	}
+	
+	if (signature != g_compressedSignature)
+	{
+		// Uncompressed data (checkpoints saved before compression was added)
+		return readSections(static_cast<const u8*>(p_buffer->getData()), static_cast<u32>(p_buffer->getSize()));
+	}
+	
+	const u32 decompressedSize = decompressToInput(p_buffer);
 	if (decompressedSize == 0)
 	{
 		TT_PANIC("loadFromCompressedBuffer failed to decompress the buffer");
 		return false;
 	}
+	
+	return readSections(ms_compressionInputBuffer, decompressedSize);
+}
+
+
+bool SerializationMgr::loadFromDeltaBuffer(const tt::code::BufferPtr& p_buffer,
+                                           const SerializationMgr&    p_reference)
+{
+	TT_NULL_ASSERT(p_buffer);
+	
+	if (isDeltaBuffer(p_buffer) == false)
+	{
+		TT_PANIC("loadFromDeltaBuffer: buffer was not created by compressDelta.");
+		return false;
+	}
+	
+	const u32 decompressedSize = decompressToInput(p_buffer);
+	if (decompressedSize == 0)
+	{
+		TT_PANIC("loadFromDeltaBuffer failed to decompress the buffer");
+		return false;
+	}
+	
 	tt::code::BufferReadContext input(
 		tt::code::BufferReadContext::createForRawBuffer(ms_compressionInputBuffer, decompressedSize));
-#endif
+	
+	namespace bu = tt::code::bufferutils;
+	
+	u8 skippedBlock[ms_deltaBlockSize];
+	
+	const u32 sectionCount = bu::get<u32>(&input);
+	for (u32 i = 0; i < sectionCount; ++i)
+	{
+		const u32 sectionID = bu::get<u32>(&input);
+		const Section section = getSectionFromSaveID(sectionID);
+		if (isValid(section) == false)
+		{
+			TT_PANIC("Loaded unsupported section (ID 0x%08X) from delta serialization data", sectionID);
+			return false;
+		}
+		
+		const SerializerPtr& referenceSection(p_reference.m_sections[section]);
+		const u32 size          = bu::get<u32>(&input);
+		const u32 referenceSize = (referenceSection != 0) ? referenceSection->getSize() : 0;
+		const u32 blockCount    = (size + ms_deltaBlockSize - 1) / ms_deltaBlockSize;
+		const u32 maskSize      = (blockCount + 7) / 8;
+		
+		if (static_cast<u32>(input.end - input.cursor) < maskSize)
+		{
+			TT_PANIC("Delta serialization data is truncated (section ID 0x%08X).", sectionID);
+			return false;
+		}
+		const u8* changedMask = input.cursor;
+		input.cursor += maskSize;
+		
+		// Rebuild the section in the layout Serializer::createFromBuffer expects
+		tt::code::BufferWriteContext sectionData(
+			tt::code::BufferWriteContext::createForRawBuffer(ms_compressionOutputBuffer, ms_compressionBufferSize));
+		bu::put(size, &sectionData);
+		
+		tt::code::BufferReadContext reference;
+		if (referenceSize > 0)
+		{
+			reference = referenceSection->getReadContext();
+		}
+		
+		for (u32 block = 0; block < blockCount; ++block)
+		{
+			const u32  offset      = block * ms_deltaBlockSize;
+			const u32  blockSize   = std::min(ms_deltaBlockSize, size - offset);
+			const bool changed     = (changedMask[block / 8] & (1 << (block % 8))) != 0;
+			const bool inReference = offset + blockSize <= referenceSize;
+			
+			if (changed)
+			{
+				bu::copyRaw(&input, blockSize, &sectionData);
+				if (inReference)
+				{
+					bu::get(skippedBlock, blockSize, &reference);
+				}
+			}
+			else if (inReference)
+			{
+				bu::copyRaw(&reference, blockSize, &sectionData);
+			}
+			else
+			{
+				TT_PANIC("Delta serialization data does not match its reference data (section ID 0x%08X).",
+				         sectionID);
+				return false;
+			}
+		}
+		
+		if (input.statusCode != 0 || sectionData.statusCode != 0)
+		{
+			return false;
+		}
+		
+		tt::code::BufferReadContext sectionInput(tt::code::BufferReadContext::createForRawBuffer(
+			ms_compressionOutputBuffer, static_cast<size_t>(sectionData.cursor - sectionData.start)));
+		m_sections[section] = Serializer::createFromBuffer(&sectionInput);
+		if (m_sections[section] == 0)
+		{
+			TT_PANIC("Empty section '%d'", section);
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+
+u32 SerializationMgr::writeSections() const
+{
+	tt::code::BufferWriteContext input(
+		tt::code::BufferWriteContext::createForRawBuffer(ms_compressionInputBuffer, ms_compressionBufferSize));
+	
+	namespace bu = tt::code::bufferutils;
+	
+	// Store the number of sections
+	u32 sectionCount = 0;
+	for (s32 i = 0; i < Section_Count; ++i)
+	{
+		if (m_sections[i] != 0 && m_sections[i]->getSize() != 0) ++sectionCount;
+	}
+	bu::put(sectionCount, &input);
+	
+	// Load all sections into compression input buffer
+	for (s32 i = 0; i < Section_Count; ++i)
+	{
+		const Section section = static_cast<Section>(i);
+		if (m_sections[section] == 0 || m_sections[section]->getSize() == 0)
+		{
+			// No section data available: do not store
+			continue;
+		}
+		// Write sectionID in buffer
+		bu::put(getSectionSaveID(section), &input);
+		
+		// Write section to buffer
+		if (m_sections[section]->saveToBuffer(&input) == false)
+		{
+			return 0;
+		}
+	}
+	
+	return static_cast<u32>(input.cursor - input.start);
+}
+
+
+bool SerializationMgr::readSections(const u8* p_data, u32 p_size)
+{
+	tt::code::BufferReadContext input(tt::code::BufferReadContext::createForRawBuffer(p_data, p_size));
 	
 	namespace bu = tt::code::bufferutils;
 	
@@ -317,6 +551,61 @@ bool SerializationMgr::loadFromCompressedBuffer(const tt::code::BufferPtr& p_buf
 	return true;
 }
 
+
+tt::code::BufferPtr SerializationMgr::compressInput(u32 p_signature, u32 p_size)
+{
+	const int compressedSize = LZ4_compress_default(reinterpret_cast<const char*>(ms_compressionInputBuffer),
+	                                                reinterpret_cast<char*>(ms_compressionOutputBuffer),
+	                                                static_cast<int>(p_size),
+	                                                static_cast<int>(ms_compressionBufferSize));
+	if (compressedSize <= 0)
+	{
+		TT_PANIC("Compressing %u bytes of serialization data failed.", p_size);
+		return tt::code::BufferPtr();
+	}
+	
+	// Header: signature and decompressed size
+	const u32 headerSize = 2 * sizeof(u32);
+	tt::code::BufferPtrForCreator buffer(new tt::code::Buffer(headerSize + compressedSize));
+	
+	namespace bu = tt::code::bufferutils;
+	tt::code::BufferWriteContext output(tt::code::BufferWriteContext::createForRawBuffer(
+		static_cast<u8*>(buffer->getData()), static_cast<size_t>(buffer->getSize())));
+	bu::put(p_signature, &output);
+	bu::put(p_size,      &output);
+	bu::put(ms_compressionOutputBuffer, static_cast<size_t>(compressedSize), &output);
+	
+	return buffer;
+}
+
+
+u32 SerializationMgr::decompressToInput(const tt::code::BufferPtr& p_buffer)
+{
+	const u32 headerSize = 2 * sizeof(u32);
+	if (p_buffer->getSize() <= static_cast<tt::code::Buffer::size_type>(headerSize))
+	{
+		return 0;
+	}
+	
+	namespace bu = tt::code::bufferutils;
+	const u8* data = static_cast<const u8*>(p_buffer->getData());
+	tt::code::BufferReadContext header(tt::code::BufferReadContext::createForRawBuffer(data, headerSize));
+	bu::get<u32>(&header); // signature
+	const u32 size = bu::get<u32>(&header);
+	if (size > ms_compressionBufferSize)
+	{
+		TT_PANIC("Serialization data of %u bytes does not fit in the %u bytes compression buffer.",
+		         size, ms_compressionBufferSize);
+		return 0;
+	}
+	
+	const int decompressedSize = LZ4_decompress_safe(reinterpret_cast<const char*>(data + headerSize),
+	                                                 reinterpret_cast<char*>(ms_compressionInputBuffer),
+	                                                 static_cast<int>(p_buffer->getSize() - headerSize),
+	                                                 static_cast<int>(size));
+	return (decompressedSize == static_cast<int>(size)) ? size : 0;
+}
+
 // Namespace end
 }
 }